@@ -2,15 +2,28 @@
 
 from __future__ import annotations
 
+from pathlib import Path
 from typing import Any, Dict, Mapping, Tuple
 
-from flask import Flask, jsonify, render_template, request
+from flask import Flask, jsonify, render_template, request, send_from_directory
 
 from src.doyle_spiral import DoyleSpiral
 
 
 app = Flask(__name__, static_folder="static", template_folder="templates")
 
+# Scripts loaded by the templates, including the engine copies generated from
+# javascript/js/ by javascript/build_engine.mjs.
+TEMPLATE_SCRIPTS_DIR = Path(__file__).resolve().parent / "templates" / "js"
+
+# Cross-origin isolation lets the render worker share its geometry store with
+# the other workers as SharedArrayBuffers; the CDN scripts are loaded with CORS
+# as require-corp needs.
+CROSS_ORIGIN_ISOLATION_HEADERS = {
+    "Cross-Origin-Opener-Policy": "same-origin",
+    "Cross-Origin-Embedder-Policy": "require-corp",
+}
+
 
 DEFAULT_PARAMS: Dict[str, Any] = {
     "p": 16,
@@ -118,6 +131,13 @@ def _render_spiral(spiral: DoyleSpiral, params: Mapping[str, Any], *, mode: str
     return svg, geometry
 
 
+@app.after_request
+def add_isolation_headers(response):
+    for header, value in CROSS_ORIGIN_ISOLATION_HEADERS.items():
+        response.headers.setdefault(header, value)
+    return response
+
+
 @app.route("/")
 def index() -> str:
     return render_template("index.html")
@@ -128,6 +148,11 @@ def viewer() -> str:
     return render_template("doyle_3d.html")
 
 
+@app.route("/js/<path:filename>")
+def template_scripts(filename: str):
+    return send_from_directory(TEMPLATE_SCRIPTS_DIR, filename)
+
+
 @app.post("/api/spiral")
 def generate_spiral():
     payload = request.get_json(silent=True) or {}
@@ -0,0 +1,80 @@
+/**
+ * Publishes the engine to the Flask UI.
+ *
+ * javascript/js/doyle_spiral_engine.js, its render worker and the geometry
+ * store the worker imports are the single source of the engine. This script
+ * writes build-stamped copies of them into templates/js/ so the Flask-served UI runs exactly the same code as the
+ * static UI.
+ *
+ *   node build_engine.mjs           write templates/js/ copies
+ *   node build_engine.mjs --check   exit 1 if the copies are missing or stale
+ */
+
+import { createHash } from 'node:crypto';
+import { readFileSync, writeFileSync, existsSync } from 'node:fs';
+import { fileURLToPath } from 'node:url';
+
+const SOURCE_DIR = new URL('./js/', import.meta.url);
+const TARGET_DIR = new URL('../templates/js/', import.meta.url);
+export const ENGINE_FILES = ['doyle_spiral_engine.js', 'geometry_store.js', 'render_worker.js'];
+
+/**
+ * Returns the generated file contents keyed by file name, plus the build id
+ * (a content hash over all engine sources).
+ */
+export function buildEngineBundle() {
+  const sources = ENGINE_FILES.map(name => [name, readFileSync(new URL(name, SOURCE_DIR), 'utf8')]);
+  const hash = createHash('sha256');
+  for (const [name, text] of sources) {
+    hash.update(name).update('\0').update(text).update('\0');
+  }
+  const build = hash.digest('hex').slice(0, 12);
+  const files = new Map();
+  for (const [name, text] of sources) {
+    const header =
+      `// Generated from javascript/js/${name} by javascript/build_engine.mjs (engine build ${build}).\n` +
+      '// Do not edit; change the source and run `npm run build:engine`.\n';
+    files.set(name, header + text);
+  }
+  return { build, files };
+}
+
+/**
+ * Lists the templates/js/ copies that differ from a fresh build.
+ *
+ * @returns {{build: string, stale: string[]}}
+ */
+export function checkEngineBundle() {
+  const { build, files } = buildEngineBundle();
+  const stale = [];
+  for (const [name, text] of files) {
+    const target = new URL(name, TARGET_DIR);
+    if (!existsSync(target) || readFileSync(target, 'utf8') !== text) {
+      stale.push(`templates/js/${name}`);
+    }
+  }
+  return { build, stale };
+}
+
+export function writeEngineBundle() {
+  const { build, files } = buildEngineBundle();
+  for (const [name, text] of files) {
+    writeFileSync(new URL(name, TARGET_DIR), text);
+  }
+  return { build, files: [...files.keys()].map(name => `templates/js/${name}`) };
+}
+
+if (process.argv[1] && fileURLToPath(import.meta.url) === process.argv[1]) {
+  if (process.argv.includes('--check')) {
+    const { build, stale } = checkEngineBundle();
+    if (stale.length) {
+      console.error(`Engine copies out of date (expected build ${build}): ${stale.join(', ')}`);
+      console.error('Run `npm run build:engine` in javascript/ and commit the result.');
+      process.exit(1);
+    }
+    console.log(`Engine copies match build ${build}`);
+  } else {
+    const { build, files } = writeEngineBundle();
+    console.log(`Wrote engine build ${build}: ${files.join(', ')}`);
+  }
+}
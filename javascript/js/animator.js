@@ -0,0 +1,482 @@
+/**
+ * Animator pipeline — pure functions with no DOM dependencies.
+ * Used by animator_worker.js (or on the main thread when workers are not
+ * available) and directly testable by vitest.
+ *
+ * Everything runs against the geometry payload a render already produced
+ * (toJSON() arcgroups, plain or packed outlines). Cells are addressed by their
+ * index in geometry.arcgroups, which is also how render() accepts per-group
+ * angle overrides, so results stay valid for any render of the same
+ * parameters. Results go back as compact typed arrays: per-cell state,
+ * angles and centroids.
+ */
+
+import {
+  renderSpiral,
+  buildPatternAnimationContextFromGeometry,
+  generatePresetAnimationFrames,
+  decodeOutline,
+} from './doyle_spiral_engine.js';
+import { readGeometry } from './geometry_store.js';
+
+export const MAX_ANIMATION_FRAMES = 1000;
+
+export function createAnimatorState() {
+  return { geometry: null, context: null, cellOf: new Map(), metaOf: [] };
+}
+
+/**
+ * Builds the pattern animation context for `geometry` and keeps it for the
+ * requests that follow.
+ */
+export function loadAnimatorGeometry(state, geometry) {
+  state.geometry = geometry;
+  state.context = buildPatternAnimationContextFromGeometry(geometry);
+  state.cellOf = new Map();
+  geometry.arcgroups.forEach((entry, idx) => state.cellOf.set(entry.id, idx));
+  state.metaOf = new Array(geometry.arcgroups.length).fill(null);
+  for (const meta of state.context.metaList) {
+    state.metaOf[state.cellOf.get(meta.id)] = meta;
+  }
+  return state;
+}
+
+function formatCoord(value) {
+  return String(Math.round(value * 1000) / 1000);
+}
+
+/**
+ * Everything the UI needs to draw and pick cells: centroids, ring indices and
+ * rough extents of the animated cells, plus one SVG path per arcgroups entry,
+ * all in drawing units (world × scaleFactor).
+ */
+export function animatorLayout(state, scaleFactor = 1) {
+  const { geometry, context } = state;
+  const count = context.metaList.length;
+  const cell = new Int32Array(count);
+  const ring = new Int32Array(count);
+  const x = new Float64Array(count);
+  const y = new Float64Array(count);
+  const extent = new Float64Array(count);
+  const paths = new Array(geometry.arcgroups.length).fill('');
+  geometry.arcgroups.forEach((entry, idx) => {
+    const points = decodeOutline(entry);
+    if (points.length < 2) {
+      return;
+    }
+    const parts = points.map(([px, py], i) => `${i ? 'L' : 'M'}${formatCoord(px * scaleFactor)} ${formatCoord(py * scaleFactor)}`);
+    paths[idx] = `${parts.join('')}Z`;
+  });
+  context.metaList.forEach((meta, i) => {
+    const idx = state.cellOf.get(meta.id);
+    cell[i] = idx;
+    ring[i] = meta.ringIndex;
+    x[i] = meta.centroid.x * scaleFactor;
+    y[i] = meta.centroid.y * scaleFactor;
+    let far = 0;
+    for (const [px, py] of decodeOutline(geometry.arcgroups[idx])) {
+      far = Math.max(far, Math.hypot(px - meta.centroid.x, py - meta.centroid.y));
+    }
+    extent[i] = far * scaleFactor;
+  });
+  return {
+    cellCount: geometry.arcgroups.length,
+    cells: { cell, ring, x, y, extent },
+    paths,
+    minRing: context.minRing,
+    maxRing: context.maxRing,
+  };
+}
+
+function matchesRule(currentState, ruleInput) {
+  // Only cells marked "must be ON" in the input are checked
+  if (ruleInput.center && !currentState.center) return false;
+  for (let i = 0; i < 6; i++) {
+    if (ruleInput.neighbors[i] && !currentState.neighbors[i]) return false;
+  }
+  return true;
+}
+
+function seedState(state, seedCells) {
+  const { context } = state;
+  const current = new Map();
+  context.metaList.forEach(meta => current.set(meta.id, false));
+  let seedsApplied = 0;
+  for (const idx of seedCells || []) {
+    const meta = state.metaOf[idx];
+    if (meta) {
+      current.set(meta.id, true);
+      seedsApplied++;
+    }
+  }
+  // Fall back to the centre ring if no seed is an animated cell
+  if (seedsApplied === 0) {
+    context.metaList
+      .filter(m => m.ringIndex === context.minRing)
+      .forEach(m => current.set(m.id, true));
+  }
+  return current;
+}
+
+function explicitFrameAngles(frame) {
+  const angles = [frame.angle1];
+  if (frame.angle2 != null) angles.push(frame.angle2);
+  return angles;
+}
+
+function pushAngles(target, newAngles) {
+  for (const na of newAngles) {
+    if (target.length < 4 && !target.some(a => Math.abs(a - na) < 10)) {
+      target.push(na);
+    }
+  }
+}
+
+/**
+ * Runs the cellular automaton until it settles and accumulates hatch angles
+ * for every cell that lit up. Returns Map<meta id, angles[]> (empty = OFF).
+ */
+export function runCellularAnimation(state, frames, seedCells, loopMode = false) {
+  const { context } = state;
+  let currentState = seedState(state, seedCells);
+  let nextState = new Map(currentState);
+
+  // Track activation angles for rendering (accumulate over iterations)
+  const activationAngles = new Map();
+  context.metaList.forEach(meta => activationAngles.set(meta.id, []));
+  for (const [id, isOn] of currentState) {
+    if (isOn) activationAngles.get(id).push(0);
+  }
+
+  let changed = true;
+  let iteration = 0;
+  while (changed && iteration < MAX_ANIMATION_FRAMES) {
+    changed = false;
+    const frame = frames[iteration % frames.length];
+
+    // Cells turn OFF unless a rule lights them up
+    context.metaList.forEach(meta => nextState.set(meta.id, false));
+
+    for (const meta of context.metaList) {
+      const neighbors = Array.from(meta.neighbors).slice(0, 6);
+      const cellState = {
+        center: currentState.get(meta.id),
+        neighbors: neighbors.map(n => n ? currentState.get(n.id) : false),
+      };
+
+      for (const rule of frame.rules) {
+        if (!matchesRule(cellState, rule.input)) {
+          continue;
+        }
+        if (rule.output.center) {
+          nextState.set(meta.id, true);
+          const angles = activationAngles.get(meta.id);
+          if (angles.length < 4) {
+            let newAngles;
+            if (frame.angle1 != null) {
+              newAngles = explicitFrameAngles(frame);
+            } else {
+              // Auto-compute: angle-split for loop mode using fwd=norm/2, bwd=(180-norm)/2+90
+              const a = (iteration * 22.5 + angles.length * 45) % 180;
+              newAngles = loopMode ? [a / 2, (180 - a) / 2 + 90] : [a];
+            }
+            pushAngles(angles, newAngles);
+          }
+        }
+        rule.output.neighbors.forEach((shouldLight, nIdx) => {
+          if (!shouldLight || !neighbors[nIdx]) {
+            return;
+          }
+          const neighborId = neighbors[nIdx].id;
+          nextState.set(neighborId, true);
+          const nAngles = activationAngles.get(neighborId);
+          if (nAngles.length < 4) {
+            let newAngles;
+            if (frame.angle1 != null) {
+              newAngles = explicitFrameAngles(frame);
+            } else {
+              const a = (iteration * 15 + nIdx * 30) % 180;
+              newAngles = loopMode ? [a / 2, (180 - a) / 2 + 90] : [a];
+            }
+            pushAngles(nAngles, newAngles);
+          }
+        });
+      }
+    }
+
+    for (const meta of context.metaList) {
+      if (currentState.get(meta.id) !== nextState.get(meta.id)) {
+        changed = true;
+        break;
+      }
+    }
+    [currentState, nextState] = [nextState, currentState];
+    iteration++;
+  }
+
+  const activations = new Map();
+  context.metaList.forEach(meta => {
+    const angles = activationAngles.get(meta.id);
+    activations.set(meta.id, currentState.get(meta.id) && angles.length > 0 ? angles : []);
+  });
+  return activations;
+}
+
+/**
+ * Simulates the automaton and returns one Uint8Array of cell states
+ * (indexed like geometry.arcgroups) per iteration, starting with the seeds.
+ */
+export function simulateCAIterations(state, frames, seedCells, maxIterations = 50) {
+  const { context } = state;
+  const cellCount = state.metaOf.length;
+  maxIterations = Math.min(maxIterations, MAX_ANIMATION_FRAMES);
+  let currentState = seedState(state, seedCells);
+  let nextState = new Map(currentState);
+
+  const snapshot = () => {
+    const states = new Uint8Array(cellCount);
+    for (const meta of context.metaList) {
+      if (currentState.get(meta.id)) states[state.cellOf.get(meta.id)] = 1;
+    }
+    return states;
+  };
+  const snapshots = [snapshot()];
+  if (!frames.length) return snapshots;
+
+  let changed = true;
+  let iteration = 0;
+  while (changed && iteration < maxIterations) {
+    changed = false;
+    const frame = frames[iteration % frames.length];
+    context.metaList.forEach(meta => nextState.set(meta.id, false));
+
+    for (const meta of context.metaList) {
+      const neighbors = Array.from(meta.neighbors).slice(0, 6);
+      const cellState = {
+        center: currentState.get(meta.id),
+        neighbors: neighbors.map(n => n ? currentState.get(n.id) : false),
+      };
+      for (const rule of frame.rules) {
+        if (matchesRule(cellState, rule.input)) {
+          if (rule.output.center) {
+            nextState.set(meta.id, true);
+          }
+          rule.output.neighbors.forEach((shouldLight, nIdx) => {
+            if (shouldLight && neighbors[nIdx]) {
+              nextState.set(neighbors[nIdx].id, true);
+            }
+          });
+        }
+      }
+    }
+
+    for (const meta of context.metaList) {
+      if (currentState.get(meta.id) !== nextState.get(meta.id)) {
+        changed = true;
+        break;
+      }
+    }
+    [currentState, nextState] = [nextState, currentState];
+    snapshots.push(snapshot());
+    iteration++;
+  }
+  return snapshots;
+}
+
+/**
+ * Hatch angle overrides for a CA animation, indexed like geometry.arcgroups
+ * (holes leave a group's preset angles alone). In loop mode the peak
+ * snapshot of the forward pass is used, split into forward/reverse angles.
+ */
+export function caAngleOverrides(state, frames, seedCells, loopMode = false) {
+  const overrides = new Array(state.metaOf.length);
+  if (!loopMode) {
+    for (const [id, angles] of runCellularAnimation(state, frames, seedCells, false)) {
+      overrides[state.cellOf.get(id)] = angles;
+    }
+    return overrides;
+  }
+  const snapshots = simulateCAIterations(state, frames, seedCells, 100);
+  // The peak of the forward pass is the frame with the most activated cells
+  let peakIdx = 0;
+  let peakCount = 0;
+  snapshots.forEach((states, idx) => {
+    const count = states.reduce((sum, on) => sum + on, 0);
+    if (count > peakCount) { peakCount = count; peakIdx = idx; }
+  });
+  const peakState = snapshots[peakIdx];
+  const frame = frames[(peakIdx > 0 ? peakIdx - 1 : 0) % frames.length];
+  let fwdAngle;
+  let revAngle;
+  if (frame.angle1 != null) {
+    fwdAngle = frame.angle1;
+    revAngle = frame.angle2 != null ? frame.angle2 : frame.angle1;
+  } else {
+    const norm = (peakIdx * 22.5) % 180;
+    fwdAngle = norm / 2;
+    revAngle = (180 - norm) / 2 + 90;
+  }
+  const angles = Math.abs(fwdAngle - revAngle) < 5 ? [fwdAngle] : [fwdAngle, revAngle];
+  for (const meta of state.context.metaList) {
+    const idx = state.cellOf.get(meta.id);
+    overrides[idx] = peakState[idx] ? angles.slice() : [];
+  }
+  return overrides;
+}
+
+/**
+ * Angle overrides for a manual frame: the chosen cells get `angle`, every
+ * other animated cell is switched off.
+ */
+export function manualAngleOverrides(layout, activeCells, angle) {
+  const overrides = new Array(layout.cellCount);
+  for (const idx of layout.cells.cell) {
+    overrides[idx] = activeCells.has(idx) ? [angle] : [];
+  }
+  return overrides;
+}
+
+/**
+ * The preset animation's ping-pong loop as one Float64Array of hatch angles
+ * per frame, indexed like geometry.arcgroups; NaN marks a cell that is off.
+ */
+export function presetFrameAngles(state, { animationId, baseAngle }, numFrames = 60) {
+  const frames = generatePresetAnimationFrames(state.context, { animationId, baseAngle }, numFrames);
+  const cellCount = state.metaOf.length;
+  // generatePresetAnimationFrames repeats frame objects on the way back; reuse their arrays too.
+  const converted = new Map();
+  return frames.map(frameMap => {
+    if (!converted.has(frameMap)) {
+      const angles = new Float64Array(cellCount).fill(Number.NaN);
+      for (const [id, assignment] of frameMap) {
+        if (assignment.angles.length) angles[state.cellOf.get(id)] = assignment.angles[0];
+      }
+      converted.set(frameMap, angles);
+    }
+    return converted.get(frameMap);
+  });
+}
+
+/**
+ * Answers one animator request. Shared by animator_worker.js and the
+ * main-thread fallback.
+ *
+ * @returns {{message: Object, transfer: ArrayBuffer[]}}
+ */
+export function handleAnimatorMessage(state, data) {
+  const { type, requestId } = data;
+  try {
+    if (type === 'load') {
+      let { geometry, scaleFactor } = data;
+      if (data.geometryStore) {
+        geometry = readGeometry(data.geometryStore);
+      }
+      if (!geometry) {
+        // No usable render yet: build the geometry here rather than on the main thread.
+        const result = renderSpiral({ ...data.params, mode: 'arram_boyle', geometry_precision: 'float32' }, 'arram_boyle');
+        geometry = result.geometry;
+        scaleFactor = result.scaleFactor;
+      }
+      loadAnimatorGeometry(state, geometry);
+      const layout = animatorLayout(state, scaleFactor ?? 1);
+      const transfer = Object.values(layout.cells).map(array => array.buffer);
+      return { message: { type: 'layout', requestId, layout }, transfer };
+    }
+    if (!state.context) {
+      throw new Error('Animator geometry not loaded');
+    }
+    if (type === 'ca') {
+      const overrides = caAngleOverrides(state, data.frames, data.seeds, data.loopMode);
+      return { message: { type: 'overrides', requestId, overrides }, transfer: [] };
+    }
+    if (type === 'snapshots') {
+      const snapshots = simulateCAIterations(state, data.frames, data.seeds, data.maxIterations ?? 100);
+      return { message: { type: 'snapshots', requestId, snapshots }, transfer: snapshots.map(s => s.buffer) };
+    }
+    if (type === 'preset') {
+      const frames = presetFrameAngles(state, data, data.numFrames);
+      const unique = Array.from(new Set(frames));
+      return {
+        message: { type: 'preset', requestId, frames: unique, order: frames.map(f => unique.indexOf(f)) },
+        transfer: unique.map(f => f.buffer),
+      };
+    }
+    throw new Error(`Unknown animator request "${type}"`);
+  } catch (error) {
+    return { message: { type: 'error', requestId, message: error?.message || 'Animator failed' }, transfer: [] };
+  }
+}
+
+/**
+ * Sends animator requests to one long-lived worker, which keeps the loaded
+ * geometry between requests. Without a worker factory the same handler runs
+ * on the main thread.
+ */
+export class AnimatorClient {
+  constructor({ createWorker = null } = {}) {
+    this.createWorker = createWorker;
+    this.worker = null;
+    this.localState = createAnimatorState();
+    this.nextRequestId = 0;
+    this.pending = new Map();
+  }
+
+  _ensureWorker() {
+    if (this.worker || !this.createWorker) {
+      return this.worker;
+    }
+    const worker = this.createWorker();
+    worker.onmessage = event => {
+      const data = event.data || {};
+      const entry = this.pending.get(data.requestId);
+      if (!entry) {
+        return;
+      }
+      this.pending.delete(data.requestId);
+      if (data.type === 'error') {
+        entry.reject(new Error(data.message));
+      } else {
+        entry.resolve(data);
+      }
+    };
+    worker.onerror = event => {
+      const error = new Error(event?.message || 'Animator worker failed');
+      for (const entry of this.pending.values()) {
+        entry.reject(error);
+      }
+      this.pending.clear();
+      worker.terminate();
+      if (this.worker === worker) {
+        this.worker = null;
+      }
+    };
+    this.worker = worker;
+    return worker;
+  }
+
+  /**
+   * Resolves with the handler's reply message; rejects on 'error' replies.
+   * `transfer` lists buffers in `payload` to hand over to the worker.
+   */
+  request(type, payload = {}, transfer = []) {
+    const requestId = ++this.nextRequestId;
+    const data = { ...payload, type, requestId };
+    const worker = this._ensureWorker();
+    if (!worker) {
+      return new Promise((resolve, reject) => {
+        setTimeout(() => {
+          const { message } = handleAnimatorMessage(this.localState, data);
+          if (message.type === 'error') {
+            reject(new Error(message.message));
+          } else {
+            resolve(message);
+          }
+        }, 0);
+      });
+    }
+    return new Promise((resolve, reject) => {
+      this.pending.set(requestId, { resolve, reject });
+      worker.postMessage(data, transfer);
+    });
+  }
+}
@@ -0,0 +1,10 @@
+import { createAnimatorState, handleAnimatorMessage } from './animator.js';
+
+// The loaded geometry and its animation context persist across requests.
+const state = createAnimatorState();
+
+self.addEventListener('message', event => {
+  const data = event.data || {};
+  const { message, transfer } = handleAnimatorMessage(state, data);
+  self.postMessage(message, transfer);
+});
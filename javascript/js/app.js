@@ -1,9 +1,25 @@
-import { renderSpiral, normaliseParams, buildPatternAnimationContext, buildContinuousPathsFromArcs, generatePresetAnimationFrames } from './doyle_spiral_engine.js';
+import { renderSpiral, normaliseParams, buildContinuousPathsFromArcs } from './doyle_spiral_engine.js';
+import { AnimatorClient, manualAngleOverrides } from './animator.js';
+import { HatchLinesClient } from './hatch_lines.js';
+import { GeometryStore, geometryForWorker } from './geometry_store.js';
 import { createThreeViewer } from './three_viewer.js';
 import { generateDXF, generateSingleGroupDXF } from './dxf_export.js';
 import { generateSTEP, generateSingleGroupSTEP } from './step_export.js';
+import { ExportPrecompute, PRECOMPUTE_FORMATS, EXPORT_MIME_TYPES, buildExportFile, renderExportGeometry } from './export_precompute.js';
+import { collectGCodeLayers, gcodeLayerOptions, planGCode, streamGCode, estimateJobTime, formatDuration } from './gcode_export.js';
+import { validateExportGeometry, validationSummary, previewPoint } from './export_validation.js';
 import { zipSync, strToU8 } from 'https://cdn.jsdelivr.net/npm/fflate@0.8.2/esm/browser.js';
-import { getBreakdownRings, generateBreakdownSVG, countWorkpieces, getOuterBoundsRequired, centreOutline, stitchPaths } from './breakdown.js';
+import {
+  getBreakdownRings,
+  generateBreakdownSVG,
+  countWorkpieces,
+  getOuterBoundsRequired,
+  centreOutline,
+  stitchPaths,
+  groupCongruentPieces,
+  buildBreakdownManifest,
+} from './breakdown.js';
+import { groupsInViewport, tilesForViewport, tileBounds, TileCache, MAX_TILE_ZOOM } from './tile_renderer.js';
 
 const form = document.getElementById('controlsForm');
 const statusEl = document.getElementById('statusMessage');
@@ -61,7 +77,11 @@ const fileInput = document.getElementById('threeFileInput');
 const exportButton = document.getElementById('exportSvgButton');
 const exportDxfButton = document.getElementById('exportDxfButton');
 const exportStepButton = document.getElementById('exportStepButton');
+const exportGcodeButton = document.getElementById('exportGcodeButton');
+const rasterExportButton = document.getElementById('rasterExportButton');
+const zoetropeExportButton = document.getElementById('zoetropeExportButton');
 const stepThicknessInput = document.getElementById('stepThickness');
+const beamWidthInput = document.getElementById('beamWidth');
 const exportFilenameInput = document.getElementById('exportFilename');
 const breakdownModeCheckbox = document.getElementById('breakdownMode');
 const breakdownSettings = document.getElementById('breakdownSettings');
@@ -69,6 +89,7 @@ const workpieceWidthInput = document.getElementById('workpieceWidth');
 const workpieceHeightInput = document.getElementById('workpieceHeight');
 const breakdownRingCountEl = document.getElementById('breakdownRingCount');
 const svgLayersCheckbox = document.getElementById('svgLayersToggle');
+const deepZoomCheckbox = document.getElementById('deepZoomToggle');
 
 const DEFAULTS = {
   p: 16,
@@ -85,6 +106,7 @@ const DEFAULTS = {
   red_outline: false,
   fill_pattern_spacing: 8,
   fill_pattern_angle: 0,
+  fill_pattern_angle_step: 0,
   fill_pattern_offset: 0,
   fill_pattern_type: 'lines',
   fill_pattern_rect_width: 2,
@@ -100,19 +122,41 @@ const DEFAULTS = {
 let activeView = '2d';
 let lastRender = null;
 let animationFrames = []; // Array of frame definitions for cellular automaton
-let selectedSeeds = new Set(); // Set of group IDs selected as initial seeds
-let animatorContext = null; // Cached pattern animation context for animator
-let animatorEngine = null;  // Engine used to build the animator preview (reused for manual renders)
+let selectedSeeds = new Set(); // Cell indices (into geometry.arcgroups) selected as initial seeds
+let animatorLayout = null; // Cell layout of the geometry loaded into the animator worker
+let animatorLayoutRequest = null; // { source, promise } of the latest layout load
 let animatorMode = 'ca'; // 'ca' | 'manual'
-let manualFrames = [{ activeIds: new Set(), angle: null }]; // Manual animator frames
+let manualFrames = [{ activeIds: new Set(), angle: null }]; // Manual animator frames (cell indices)
 let activeManualFrameIndex = 0; // Currently edited manual frame
 let threeApp = null;
 const workerSupported = typeof Worker !== 'undefined';
 const renderWorkerURL = workerSupported ? new URL('./render_worker.js', import.meta.url) : null;
 let renderWorkerHandle = null;
+// Context building, CA simulation and frame angles run here against the
+// geometry of the last render; only compact per-cell results come back.
+const animatorClient = new AnimatorClient({
+  createWorker: workerSupported
+    ? () => new Worker(new URL('./animator_worker.js', import.meta.url), { type: 'module' })
+    : null,
+});
+// Render workers write each result's outlines into a geometry store, shared
+// with the animator worker when the page is cross-origin isolated.
+const geometryStore = new GeometryStore();
+const exportPrecompute = workerSupported
+  ? new ExportPrecompute({
+    createWorker: () => new Worker(new URL('./export_worker.js', import.meta.url), { type: 'module' }),
+    onValidation: report => showValidationMarkers(report),
+  })
+  : null;
 let currentRenderToken = 0;
 let activeRenderJob = null;
 const svgParser = typeof DOMParser !== 'undefined' ? new DOMParser() : null;
+// Geometry payloads for the preview and 3D viewer only feed the screen, so they
+// use the compact float32 outline encoding (exports read the engine directly).
+const PREVIEW_GEOMETRY_PRECISION = 'float32';
+// The on-screen SVG fills hatches with shared <pattern>s instead of tens of
+// thousands of <line>s; the SVG download re-renders with explicit segments.
+const PREVIEW_PATTERN_FILL = true;
 const DEFAULT_RENDER_TIMEOUT_MS = 30000;
 const MIN_RENDER_TIMEOUT_MS = 5000;
 const MAX_RENDER_TIMEOUT_MS = 300000;
@@ -168,6 +212,7 @@ function getOverflowGroups(arcGroups, fittingRings) {
 }
 
 async function downloadBreakdownZip(format) {
+  perfMark('export-click');
   if (!lastRender) {
     setStatus('Render the spiral before exporting.', 'error');
     return;
@@ -178,7 +223,7 @@ async function downloadBreakdownZip(format) {
   let scaleFactor = lastRender.scaleFactor;
 
   if (!engine || !engine.arcGroups || !engine.arcGroups.size) {
-    const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
+    const result = renderEngineFor(params);
     if (!result || !result.engine || !result.engine.arcGroups) {
       setStatus('Breakdown export failed: could not generate geometry.', 'error');
       return;
@@ -212,37 +257,54 @@ async function downloadBreakdownZip(format) {
   const withPattern = Boolean(params.add_fill_pattern);
   const withHighlight = true; // always show cut boundary in breakdown exports
 
-  // --- Beyond-box rings: one file per ring layer (all groups combined), centred in workpiece box ---
+  // --- Beyond-box rings: one file per distinct piece, centred in workpiece box ---
+  // Groups of a ring share one template and mostly differ only by rotation;
+  // congruent pieces with the same hatch relative to the piece are written
+  // once and placed through the manifest.
   const overflowGroups = getOverflowGroups(engine.arcGroups, rings);
-  const overflowRingIds = new Set(overflowGroups.map(g => g.ringIndex));
-
-  // Group overflow entries by ring index
-  const overflowByRing = new Map();
-  for (const g of overflowGroups) {
-    if (!overflowByRing.has(g.ringIndex)) overflowByRing.set(g.ringIndex, []);
-    overflowByRing.get(g.ringIndex).push(g);
+  const spacing = (params.fill_pattern_spacing ?? 8) / (scaleFactor ?? 1);
+  const offset = (params.fill_pattern_offset ?? 0) / (scaleFactor ?? 1);
+  // Only the SVG files carry hatch lines; DXF/STEP pieces match on outline alone.
+  const hatched = withPattern && format === 'svg';
+  const pieces = groupCongruentPieces(overflowGroups, {
+    patternAnglesOf: group => (hatched && typeof group.getPatternSegments === 'function'
+      ? group.patternAngles.slice(0, 4)
+      : []),
+  });
+  const piecesPerRing = new Map();
+  for (const piece of pieces) {
+    piecesPerRing.set(piece.ringIndex, (piecesPerRing.get(piece.ringIndex) || 0) + 1);
   }
+  const manifestEntries = [];
+  const ringPieceNumber = new Map();
 
-  for (const [ringIdx, ringGroups] of overflowByRing.entries()) {
-    // Use first group as representative example for this ring layer
-    const g = ringGroups[0];
+  for (const piece of pieces) {
+    const g = piece.representative;
+    const ringIdx = piece.ringIndex;
     const gOutline = g.getClosedOutline();
-    if (!gOutline || gOutline.length < 2) continue;
     const cx = gOutline.reduce((s, p) => s + p.re, 0) / gOutline.length;
     const cy = gOutline.reduce((s, p) => s + p.im, 0) / gOutline.length;
     const gOutlineCentred = centreOutline(gOutline);
-    const patLines = withPattern && typeof g._getPatternSegments === 'function'
-      ? (g._getPatternSegments((params.fill_pattern_spacing ?? 8) / (scaleFactor ?? 1), g.primaryPatternAngle ?? params.fill_pattern_angle, (params.fill_pattern_offset ?? 0) / (scaleFactor ?? 1)) ?? [])
-          .map(([p1, p2]) => ({ p1: { re: p1.re - cx, im: p1.im - cy }, p2: { re: p2.re - cx, im: p2.im - cy } }))
-      : [];
-    const fname = `${base}_ring_${ringIdx}_x${ringGroups.length}.${format}`;
+    const patLines = [];
+    if (hatched && typeof g.getPatternSegments === 'function') {
+      for (const angle of g.patternAngles.slice(0, 4)) {
+        for (const [p1, p2] of g.getPatternSegments(spacing, angle, offset) ?? []) {
+          patLines.push({ p1: { re: p1.re - cx, im: p1.im - cy }, p2: { re: p2.re - cx, im: p2.im - cy } });
+        }
+      }
+    }
+    const number = (ringPieceNumber.get(ringIdx) || 0) + 1;
+    ringPieceNumber.set(ringIdx, number);
+    const stem = piecesPerRing.get(ringIdx) > 1 ? `${base}_ring_${ringIdx}-${number}` : `${base}_ring_${ringIdx}`;
+    const fname = `${stem}_x${piece.members.length}.${format}`;
     zipFiles[fname] = strToU8(
       format === 'svg'
         ? generateBreakdownSVG([gOutlineCentred], [gOutlineCentred], scaleFactor ?? 1, wpW, wpH, patLines)
         : format === 'step'
-          ? generateSingleGroupSTEP([gOutlineCentred], [], scaleFactor ?? 1, wpW, wpH, `${base}_ring_${ringIdx}`, stepThickness)
+          ? generateSingleGroupSTEP([gOutlineCentred], [], scaleFactor ?? 1, wpW, wpH, stem, stepThickness)
           : generateSingleGroupDXF([], [gOutlineCentred], scaleFactor ?? 1, wpW, wpH)
     );
+    manifestEntries.push({ file: fname, ringIndex: ringIdx, members: piece.members });
   }
 
   // --- Workpiece file: all groups whose ring fits in the workpiece box ---
@@ -269,8 +331,8 @@ async function downloadBreakdownZip(format) {
     const gOutline = g.getClosedOutline();
     if (!gOutline || gOutline.length < 2) continue;
     fittingOutlines.push(gOutline);
-    if (withPattern && typeof g._getPatternSegments === 'function') {
-      const segs = g._getPatternSegments((params.fill_pattern_spacing ?? 8) / (scaleFactor ?? 1), g.primaryPatternAngle ?? params.fill_pattern_angle, (params.fill_pattern_offset ?? 0) / (scaleFactor ?? 1)) ?? [];
+    if (withPattern && typeof g.getPatternSegments === 'function') {
+      const segs = g.getPatternSegments((params.fill_pattern_spacing ?? 8) / (scaleFactor ?? 1), g.primaryPatternAngle ?? params.fill_pattern_angle, (params.fill_pattern_offset ?? 0) / (scaleFactor ?? 1)) ?? [];
       fittingPatternLines.push(...segs.map(([p1, p2]) => ({ p1, p2 })));
     }
   }
@@ -285,10 +347,12 @@ async function downloadBreakdownZip(format) {
           ? generateSingleGroupSTEP(fittingOutlines, [], scaleFactor ?? 1, wpW, wpH, `${base}_workpiece`, stepThickness)
           : generateSingleGroupDXF([], stitchedHighlight, scaleFactor ?? 1, wpW, wpH)
     );
+    manifestEntries.unshift({ file: fname, ringIndex: null, members: null });
   }
 
   const totalPieceCount = countWorkpieces(engine.arcGroups, rings, withPattern);
   const fileCount = Object.keys(zipFiles).length;
+  zipFiles[`${base}_manifest.csv`] = strToU8(buildBreakdownManifest(manifestEntries, scaleFactor ?? 1));
   const zipped = zipSync(zipFiles);
   const blob = new Blob([zipped], { type: 'application/zip' });
   const url = URL.createObjectURL(blob);
@@ -296,10 +360,11 @@ async function downloadBreakdownZip(format) {
   link.href = url;
   link.download = `${base}_breakdown.zip`;
   document.body.appendChild(link);
+  perfMeasure('export-to-download', 'export-click');
   link.click();
   document.body.removeChild(link);
   URL.revokeObjectURL(url);
-  setStatus(`Exported ${fileCount} workpiece file${fileCount === 1 ? '' : 's'} in ${base}_breakdown.zip.`);
+  setStatus(`Exported ${fileCount} workpiece file${fileCount === 1 ? '' : 's'} for ${totalPieceCount} piece${totalPieceCount === 1 ? '' : 's'} in ${base}_breakdown.zip (see ${base}_manifest.csv).`);
 }
 
 function getExportFileName() {
@@ -315,6 +380,9 @@ function updateExportAvailability(available) {
   if (exportButton)     exportButton.disabled     = !available;
   if (exportDxfButton)  exportDxfButton.disabled  = !available;
   if (exportStepButton) exportStepButton.disabled = !available;
+  if (exportGcodeButton) exportGcodeButton.disabled = !available;
+  if (rasterExportButton) rasterExportButton.disabled = !available;
+  if (zoetropeExportButton) zoetropeExportButton.disabled = !available;
 }
 
 function getRenderTimeoutMs() {
@@ -327,6 +395,7 @@ function getRenderTimeoutMs() {
 }
 
 function downloadCurrentSvg() {
+  perfMark('export-click');
   if (breakdownModeCheckbox?.checked) {
     downloadBreakdownZip('svg');
     return;
@@ -338,6 +407,17 @@ function downloadCurrentSvg() {
   }
 
   let svgContent = lastRender.svgString || '';
+  if (lastRender.params?.svg_pattern_preview && lastRender.params.add_fill_pattern) {
+    // Pattern fills are preview-only; cut files need the real hatch segments.
+    try {
+      svgContent = renderSpiral({ ...lastRender.params, svg_pattern_preview: false }, null, {
+        arcGroupAngleOverrides: lastRender.angleOverrides ?? null,
+      }).svgString;
+    } catch (error) {
+      setStatus(`SVG export failed: ${error.message}`, 'error');
+      return;
+    }
+  }
   if (!svgContent) {
     const svgElement = svgPreview.querySelector('svg');
     if (svgElement) {
@@ -357,6 +437,7 @@ function downloadCurrentSvg() {
   link.href = url;
   link.download = filename;
   document.body.appendChild(link);
+  perfMeasure('export-to-download', 'export-click');
   link.click();
   document.body.removeChild(link);
   URL.revokeObjectURL(url);
@@ -368,6 +449,7 @@ function hasGeometry(geometry) {
 }
 
 function downloadCurrentDxf() {
+  perfMark('export-click');
   if (breakdownModeCheckbox?.checked) {
     downloadBreakdownZip('dxf');
     return;
@@ -379,93 +461,540 @@ function downloadCurrentDxf() {
   }
 
   const params = lastRender.params || collectParams();
+  const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
+  const safe = sanitiseFileName(raw) || 'doyle-spiral';
+  const filename = safe.toLowerCase().endsWith('.dxf') ? safe : `${safe}.dxf`;
 
-  // The engine object isn't available when rendered via worker — re-run in main thread.
-  let engine = lastRender.engine;
-  let scaleFactor = lastRender.scaleFactor;
-
-  if (!engine || !engine.arcGroups || !engine.arcGroups.size) {
-    const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
-    if (!result || !result.engine || !result.engine.arcGroups) {
-      setStatus('DXF export failed: could not generate geometry.', 'error');
+  let blob = exportPrecompute?.get(params, 'dxf') ?? null;
+  let geometry = null;
+  if (!blob) {
+    // The engine object isn't available when rendered via worker — re-run in main thread.
+    geometry = currentExportGeometry(params, 'DXF');
+    if (!geometry) {
       return;
     }
-    engine = result.engine;
-    scaleFactor = result.scaleFactor;
+    blob = new Blob([buildExportFile(geometry, params, 'dxf')], { type: EXPORT_MIME_TYPES.dxf });
   }
+  const check = exportCheckMessage(params, geometry);
 
-  const bbW = params.bounding_box_width_mm || DEFAULTS.bounding_box_width_mm;
-  const bbH = params.bounding_box_height_mm || DEFAULTS.bounding_box_height_mm;
-
-  const dxfContent = generateDXF(engine.arcGroups, scaleFactor ?? 1, bbW, bbH, {
-    drawGroupOutline: false,
-    redOutline: true,
-  });
-
-  const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
-  const safe = sanitiseFileName(raw) || 'doyle-spiral';
-  const filename = safe.toLowerCase().endsWith('.dxf') ? safe : `${safe}.dxf`;
-
-  const blob = new Blob([dxfContent], { type: 'application/dxf' });
   const url = URL.createObjectURL(blob);
   const link = document.createElement('a');
   link.href = url;
   link.download = filename;
   document.body.appendChild(link);
+  perfMeasure('export-to-download', 'export-click');
   link.click();
   document.body.removeChild(link);
   URL.revokeObjectURL(url);
-  setStatus(`DXF downloaded as ${filename}.`);
+  setStatus(`DXF downloaded as ${filename}${check}.`);
 }
 
-function downloadCurrentStep() {
-  if (breakdownModeCheckbox?.checked) {
-    downloadBreakdownZip('step');
-    return;
-  }
+function readGcodeSettings() {
+  const num = (id, fallback) => {
+    const value = Number(document.getElementById(id)?.value);
+    return Number.isFinite(value) ? value : fallback;
+  };
+  return {
+    layers: {
+      HATCH: { power: num('gcodeHatchPower', 40), speed: num('gcodeHatchSpeed', 3000) },
+      OUTLINE: { power: num('gcodeOutlinePower', 80), speed: num('gcodeOutlineSpeed', 1200) },
+      HIGHLIGHT: { power: num('gcodeHighlightPower', 100), speed: num('gcodeHighlightSpeed', 800) },
+    },
+    travelSpeed: num('gcodeTravelSpeed', 6000),
+    maxPower: num('gcodeMaxPower', 1000),
+  };
+}
 
+let gcodeWorker = null;
+
+async function downloadCurrentGcode() {
+  perfMark('export-click');
   if (!lastRender) {
     setStatus('Render the spiral before downloading.', 'error');
     return;
   }
 
   const params = lastRender.params || collectParams();
-  let engine = lastRender.engine;
-  let scaleFactor = lastRender.scaleFactor;
+  const settings = readGcodeSettings();
+  const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
+  const safe = sanitiseFileName(raw) || 'doyle-spiral';
+  const filename = safe.toLowerCase().endsWith('.gcode') ? safe : `${safe}.gcode`;
 
-  if (!engine || !engine.arcGroups || !engine.arcGroups.size) {
-    const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
-    if (!result || !result.engine || !result.engine.arcGroups) {
-      setStatus('STEP export failed: could not generate geometry.', 'error');
+  // Stream straight to disk where the File System Access API is available;
+  // otherwise the chunks are collected into a Blob.
+  let writable = null;
+  let savedName = filename;
+  if (typeof window.showSaveFilePicker === 'function') {
+    try {
+      const handle = await window.showSaveFilePicker({
+        suggestedName: filename,
+        types: [{ description: 'G-code', accept: { 'text/x-gcode': ['.gcode', '.nc'] } }],
+      });
+      writable = await handle.createWritable();
+      savedName = handle.name;
+    } catch (error) {
+      if (error?.name === 'AbortError') {
+        setStatus('G-code export cancelled.');
+        return;
+      }
+    }
+  }
+  const chunks = [];
+  let writing = Promise.resolve();
+  const write = chunk => {
+    if (writable) {
+      writing = writing.then(() => writable.write(chunk));
+    } else {
+      chunks.push(chunk);
+    }
+  };
+  const deliver = async (estimate, check) => {
+    const summary = `estimated job time ${formatDuration(estimate.seconds)}, ${estimate.pathCount} paths`
+      + check.replace(/^ — /, '; ');
+    if (writable) {
+      try {
+        await writing;
+        await writable.close();
+        setStatus(`G-code saved as ${savedName} (${summary}).`);
+      } catch (error) {
+        setStatus(`G-code export failed: ${error?.message || 'could not write the file'}`, 'error');
+      }
       return;
     }
-    engine = result.engine;
-    scaleFactor = result.scaleFactor;
+    const blob = new Blob(chunks, { type: 'text/x-gcode' });
+    chunks.length = 0;
+    const url = URL.createObjectURL(blob);
+    const link = document.createElement('a');
+    link.href = url;
+    link.download = filename;
+    document.body.appendChild(link);
+    perfMeasure('export-to-download', 'export-click');
+    link.click();
+    document.body.removeChild(link);
+    URL.revokeObjectURL(url);
+    setStatus(`G-code downloaded as ${filename} (${summary}).`);
+  };
+  const fail = message => {
+    if (writable) writing.then(() => writable.abort()).catch(() => {});
+    setStatus(message, 'error');
+  };
+
+  // A main-thread render still has its engine; otherwise the export worker
+  // renders the geometry and builds the program.
+  const engine = lastRender.engine;
+  if (engine?.arcGroups?.size) {
+    const scaleFactor = lastRender.scaleFactor ?? 1;
+    const bbW = params.bounding_box_width_mm || DEFAULTS.bounding_box_width_mm;
+    const bbH = params.bounding_box_height_mm || DEFAULTS.bounding_box_height_mm;
+    const plan = planGCode(collectGCodeLayers(engine.arcGroups, scaleFactor, bbW, bbH, gcodeLayerOptions(params)));
+    for (const chunk of streamGCode(plan, settings)) {
+      write(chunk);
+    }
+    await deliver(estimateJobTime(plan, settings), exportCheckMessage(params, { engine, scaleFactor }));
+    return;
+  }
+  if (!workerSupported) {
+    fail('G-code export failed: could not generate geometry.');
+    return;
+  }
+
+  if (gcodeWorker) {
+    gcodeWorker.terminate();
   }
+  const worker = new Worker(new URL('./export_worker.js', import.meta.url), { type: 'module' });
+  gcodeWorker = worker;
+  const requestId = Date.now();
+  const finish = () => {
+    worker.terminate();
+    if (gcodeWorker === worker) gcodeWorker = null;
+  };
+  const validationOptions = readValidationOptions();
+  let report = null;
+  setStatus('Building G-code…', 'loading');
+
+  worker.addEventListener('message', async event => {
+    const data = event.data || {};
+    if (data.requestId !== requestId) return;
+    if (data.type === 'validation') {
+      report = data.report;
+      return;
+    }
+    if (data.type === 'chunk') {
+      write(data.bytes);
+      return;
+    }
+    finish();
+    if (data.type === 'error') {
+      fail(`G-code export failed: ${data.message}`);
+      return;
+    }
+    await deliver(data.estimate, exportCheckMessage(params, null, report));
+  });
+  worker.addEventListener('error', event => {
+    finish();
+    fail(`G-code export failed: ${event.message || 'worker error'}`);
+  });
+  worker.postMessage({
+    type: 'gcode',
+    requestId,
+    params,
+    settings,
+    options: validationOptions,
+    angleOverrides: lastRender.angleOverrides ?? null,
+    validate: !exportPrecompute?.getValidation(params, validationOptions),
+  });
+}
 
-  const bbW = params.bounding_box_width_mm || DEFAULTS.bounding_box_width_mm;
-  const bbH = params.bounding_box_height_mm || DEFAULTS.bounding_box_height_mm;
+let rasterWorker = null;
+
+async function downloadRasterHatch() {
+  perfMark('export-click');
+  if (!lastRender) {
+    setStatus('Render the spiral before downloading.', 'error');
+    return;
+  }
+  if (!workerSupported) {
+    setStatus('Raster export needs Web Worker support.', 'error');
+    return;
+  }
+  const params = lastRender.params || collectParams();
+  const angleOverrides = lastRender.angleOverrides ?? null;
+  const dpi = Number(document.getElementById('rasterDpi')?.value) || 1000;
+  const format = document.getElementById('rasterFormat')?.value === 'bmp' ? 'bmp' : 'png';
+  const vectorOutlines = document.getElementById('rasterVectorOutlines')?.checked ?? true;
+  // One hatch layer without outlines is a single image; anything more is zipped
+  // in the worker.
+  const zip = vectorOutlines || Boolean(params.svg_layers);
   const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
-  const safe = sanitiseFileName(raw) || 'doyle-spiral';
-  const name = safe.toLowerCase().endsWith('.step') || safe.toLowerCase().endsWith('.stp') ? safe.replace(/\.(step|stp)$/i, '') : safe;
-  const filename = `${name}.step`;
+  const base = sanitiseFileName(raw) || 'doyle-spiral';
+  const filename = zip ? `${base}-raster.zip` : `${base}-hatch.${format}`;
+  const mimeType = zip ? 'application/zip' : format === 'bmp' ? 'image/bmp' : 'image/png';
+
+  // Stream straight to disk where the File System Access API is available;
+  // otherwise the chunks are collected into a Blob.
+  let writable = null;
+  if (typeof window.showSaveFilePicker === 'function') {
+    try {
+      const extension = filename.slice(filename.lastIndexOf('.'));
+      const handle = await window.showSaveFilePicker({
+        suggestedName: filename,
+        types: [{ description: zip ? 'ZIP archive' : 'Raster image', accept: { [mimeType]: [extension] } }],
+      });
+      writable = await handle.createWritable();
+    } catch (error) {
+      if (error?.name === 'AbortError') {
+        setStatus('Raster export cancelled.');
+        return;
+      }
+    }
+  }
+  const chunks = [];
+  let writing = Promise.resolve();
+
+  if (rasterWorker) {
+    rasterWorker.terminate();
+  }
+  const worker = new Worker(new URL('./raster_worker.js', import.meta.url), { type: 'module' });
+  rasterWorker = worker;
+  const requestId = Date.now();
+  const finish = () => {
+    worker.terminate();
+    if (rasterWorker === worker) rasterWorker = null;
+    if (rasterExportButton) rasterExportButton.disabled = !lastRender;
+  };
+  const fail = message => {
+    finish();
+    if (writable) writing.then(() => writable.abort()).catch(() => {});
+    setStatus(message, 'error');
+  };
+  if (rasterExportButton) rasterExportButton.disabled = true;
+  setStatus(`Rasterising hatch at ${dpi} DPI…`, 'loading');
+
+  worker.addEventListener('message', async event => {
+    const data = event.data || {};
+    if (data.requestId !== requestId) return;
+    if (data.type === 'progress') {
+      const pct = Math.round(data.fraction * 100);
+      setStatus(`Rasterising ${data.layer} (${data.layerIndex + 1}/${data.layerCount}) — ${pct}%`, 'loading');
+      return;
+    }
+    if (data.type === 'chunk') {
+      if (writable) {
+        writing = writing.then(() => writable.write(data.bytes));
+      } else {
+        chunks.push(data.bytes);
+      }
+      return;
+    }
+    if (data.type === 'error') {
+      fail(`Raster export failed: ${data.message}`);
+      return;
+    }
+    if (!data.fileCount) {
+      fail('Raster export produced no hatch layers. Enable the pattern fill first.');
+      return;
+    }
+    finish();
+    const summary = `Raster hatch (${data.width} × ${data.height} px at ${data.dpi} DPI)`;
+    if (writable) {
+      try {
+        await writing;
+        await writable.close();
+        setStatus(`${summary} saved as ${filename}.`);
+      } catch (error) {
+        setStatus(`Raster export failed: ${error?.message || 'could not write the file'}`, 'error');
+      }
+      return;
+    }
+    const blob = new Blob(chunks, { type: mimeType });
+    chunks.length = 0;
+    const url = URL.createObjectURL(blob);
+    const link = document.createElement('a');
+    link.href = url;
+    link.download = filename;
+    document.body.appendChild(link);
+    perfMeasure('export-to-download', 'export-click');
+    link.click();
+    document.body.removeChild(link);
+    URL.revokeObjectURL(url);
+    setStatus(`${summary} downloaded as ${filename}.`);
+  });
+  worker.addEventListener('error', event => {
+    fail(`Raster export failed: ${event.message || 'worker error'}`);
+  });
+  worker.postMessage({
+    type: 'raster',
+    requestId,
+    params,
+    options: { dpi, format, vectorOutlines, zip },
+    angleOverrides,
+  });
+}
 
-  const stepContent = generateSTEP(engine.arcGroups, scaleFactor ?? 1, bbW, bbH, {
-    drawGroupOutline: params.draw_group_outline !== false,
-    thickness: Math.max(0.01, Number(stepThicknessInput?.value) || 1),
-    name,
+let zoetropeWorker = null;
+
+function downloadZoetropePreview() {
+  perfMark('export-click');
+  if (!lastRender) {
+    setStatus('Render the spiral before downloading.', 'error');
+    return;
+  }
+  if (!workerSupported) {
+    setStatus('Zoetrope export needs Web Worker support.', 'error');
+    return;
+  }
+  const params = lastRender.params || collectParams();
+  // Reuse the rendered geometry so animator overrides show up as previewed.
+  const geometry = lastRender.mode === 'arram_boyle' && hasGeometry(lastRender.geometry) ? lastRender.geometry : null;
+  const size = Number(document.getElementById('zoetropeSize')?.value) || 512;
+  const frames = Number(document.getElementById('zoetropeFrames')?.value) || 180;
+  const format = document.getElementById('zoetropeFormat')?.value === 'webp' ? 'webp' : 'apng';
+  const rotate = document.getElementById('zoetropeRotate')?.checked ?? true;
+
+  if (zoetropeWorker) {
+    zoetropeWorker.terminate();
+  }
+  const worker = new Worker(new URL('./zoetrope_worker.js', import.meta.url), { type: 'module' });
+  zoetropeWorker = worker;
+  const requestId = Date.now();
+  const finish = () => {
+    worker.terminate();
+    if (zoetropeWorker === worker) zoetropeWorker = null;
+    if (zoetropeExportButton) zoetropeExportButton.disabled = !lastRender;
+  };
+  if (zoetropeExportButton) zoetropeExportButton.disabled = true;
+  setStatus(`Rendering ${frames} zoetrope frames…`, 'loading');
+
+  worker.addEventListener('message', event => {
+    const data = event.data || {};
+    if (data.requestId !== requestId) return;
+    if (data.type === 'progress') {
+      setStatus(`Rendering zoetrope frame ${data.frame + 1}/${data.frameCount}…`, 'loading');
+      return;
+    }
+    finish();
+    if (data.type === 'error') {
+      setStatus(`Zoetrope export failed: ${data.message}`, 'error');
+      return;
+    }
+    const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
+    const base = sanitiseFileName(raw) || 'doyle-spiral';
+    let blob;
+    let filename;
+    if (data.format === 'apng') {
+      blob = new Blob(data.files[0].parts, { type: 'image/apng' });
+      filename = `${base}-zoetrope.png`;
+    } else {
+      const zipFiles = {};
+      for (const file of data.files) {
+        // WebP frames are already compressed.
+        zipFiles[file.name] = [file.parts[0], { level: 0 }];
+      }
+      blob = new Blob([zipSync(zipFiles)], { type: 'application/zip' });
+      filename = `${base}-zoetrope.zip`;
+    }
+    const url = URL.createObjectURL(blob);
+    const link = document.createElement('a');
+    link.href = url;
+    link.download = filename;
+    document.body.appendChild(link);
+    perfMeasure('export-to-download', 'export-click');
+    link.click();
+    document.body.removeChild(link);
+    URL.revokeObjectURL(url);
+    setStatus(`Zoetrope preview (${data.frameCount} frames, ${data.size} px) downloaded as ${filename}.`);
   });
+  worker.addEventListener('error', event => {
+    finish();
+    setStatus(`Zoetrope export failed: ${event.message || 'worker error'}`, 'error');
+  });
+  const options = { size, frames, format, rotate };
+  if (geometry && geometryStore.current) {
+    const stored = geometryForWorker(geometryStore.current, geometryStore.control);
+    worker.postMessage({ type: 'zoetrope', requestId, params, geometryStore: stored.store, options }, stored.transfer);
+  } else {
+    worker.postMessage({ type: 'zoetrope', requestId, params, geometry, options });
+  }
+}
+
+function downloadCurrentStep() {
+  perfMark('export-click');
+  if (breakdownModeCheckbox?.checked) {
+    downloadBreakdownZip('step');
+    return;
+  }
+
+  if (!lastRender) {
+    setStatus('Render the spiral before downloading.', 'error');
+    return;
+  }
+
+  const params = lastRender.params || collectParams();
+  const options = readStepOptions();
+  const filename = `${options.name}.step`;
+
+  let blob = exportPrecompute?.get(params, 'step', options) ?? null;
+  let geometry = null;
+  if (!blob) {
+    geometry = currentExportGeometry(params, 'STEP');
+    if (!geometry) {
+      return;
+    }
+    blob = new Blob([buildExportFile(geometry, params, 'step', options)], { type: EXPORT_MIME_TYPES.step });
+  }
+  const check = exportCheckMessage(params, geometry);
 
-  const blob = new Blob([stepContent], { type: 'application/step' });
   const url = URL.createObjectURL(blob);
   const link = document.createElement('a');
   link.href = url;
   link.download = filename;
   document.body.appendChild(link);
+  perfMeasure('export-to-download', 'export-click');
   link.click();
   document.body.removeChild(link);
   URL.revokeObjectURL(url);
-  setStatus(`STEP downloaded as ${filename}.`);
+  setStatus(`STEP downloaded as ${filename}${check}.`);
+}
+
+/**
+ * Returns the engine geometry for a synchronous export, reusing the engine
+ * from the last render when there is one.
+ */
+function currentExportGeometry(params, label) {
+  if (lastRender?.engine?.arcGroups?.size) {
+    return { engine: lastRender.engine, scaleFactor: lastRender.scaleFactor };
+  }
+  try {
+    return renderExportGeometry(params);
+  } catch (error) {
+    setStatus(`${label} export failed: ${error.message}.`, 'error');
+    return null;
+  }
+}
+
+function readStepOptions() {
+  const raw = exportFilenameInput ? exportFilenameInput.value.trim() || 'doyle-spiral' : 'doyle-spiral';
+  const safe = sanitiseFileName(raw) || 'doyle-spiral';
+  const name = safe.toLowerCase().endsWith('.step') || safe.toLowerCase().endsWith('.stp') ? safe.replace(/\.(step|stp)$/i, '') : safe;
+  return { stepThickness: Math.max(0.01, Number(stepThicknessInput?.value) || 1), name };
+}
+
+function readValidationOptions() {
+  const beamWidth = Number(beamWidthInput?.value);
+  return { beamWidth: Number.isFinite(beamWidth) && beamWidth >= 0 ? beamWidth : 0.1 };
+}
+
+/**
+ * Validation report for an export: the one precomputed with the files when it
+ * matches, else `workerReport` from the worker that built the file, else
+ * validated now on `geometry` (when the caller has it). The issues are
+ * highlighted in the preview.
+ */
+function exportValidation(params, geometry, workerReport = null) {
+  const options = readValidationOptions();
+  let report = exportPrecompute?.getValidation(params, options) ?? workerReport;
+  if (!report && geometry) {
+    report = validateExportGeometry(geometry, params, options);
+  }
+  showValidationMarkers(report);
+  return report;
+}
+
+/**
+ * Suffix for the download status, e.g. " — check: 2 open outlines", or ''.
+ */
+function exportCheckMessage(params, geometry, workerReport = null) {
+  const summary = validationSummary(exportValidation(params, geometry, workerReport));
+  return summary ? ` — check: ${summary} (marked in the preview)` : '';
+}
+
+/**
+ * Rings each validation issue in the preview SVG; null clears the markers.
+ */
+function showValidationMarkers(report) {
+  const svgEl = svgPreview.querySelector('svg');
+  if (!svgEl) {
+    return;
+  }
+  svgEl.querySelector('g.validation-markers')?.remove();
+  if (!report || !report.issues.length) {
+    return;
+  }
+  const SVG_NS = 'http://www.w3.org/2000/svg';
+  const [, , vbWidth, vbHeight] = (svgEl.getAttribute('viewBox') || '0 0 100 100').split(/\s+/).map(Number);
+  const radius = Math.min(vbWidth, vbHeight) * 0.008;
+  const layer = document.createElementNS(SVG_NS, 'g');
+  layer.classList.add('validation-markers');
+  for (const issue of report.issues) {
+    const { x, y } = previewPoint(report, issue);
+    const circle = document.createElementNS(SVG_NS, 'circle');
+    circle.setAttribute('cx', x);
+    circle.setAttribute('cy', y);
+    circle.setAttribute('r', radius);
+    circle.setAttribute('stroke-width', radius * 0.3);
+    circle.dataset.check = issue.check;
+    const title = document.createElementNS(SVG_NS, 'title');
+    title.textContent = issue.group ? `${issue.group}: ${issue.message}` : issue.message;
+    circle.appendChild(title);
+    layer.appendChild(circle);
+  }
+  svgEl.appendChild(layer);
+}
+
+/**
+ * Queues the DXF and STEP files for the settled render in the export worker,
+ * so the download buttons can hand them out without generating on click.
+ * Breakdown exports are zipped per workpiece on click and are not precomputed.
+ */
+function scheduleExportPrecompute() {
+  if (!exportPrecompute) {
+    return;
+  }
+  if (!lastRender?.fromParams || breakdownModeCheckbox?.checked) {
+    exportPrecompute.invalidate();
+    return;
+  }
+  exportPrecompute.schedule(lastRender.params, PRECOMPUTE_FORMATS, { ...readStepOptions(), ...readValidationOptions() });
 }
 
 function updateTValue() {
@@ -571,6 +1100,27 @@ function debounce(fn, delay) {
   };
 }
 
+// Latency spans for tests/e2e/latency.bench.js. Each span starts at a user
+// action mark and is measured once the result is visible.
+const PERF_PREFIX = 'doyle:';
+
+function perfMark(name) {
+  performance.mark(`${PERF_PREFIX}${name}`);
+}
+
+function perfMeasure(name, startName) {
+  const start = `${PERF_PREFIX}${startName}`;
+  if (!performance.getEntriesByName(start, 'mark').length) {
+    return;
+  }
+  performance.measure(`${PERF_PREFIX}${name}`, start);
+  performance.clearMarks(start);
+}
+
+function afterNextPaint(callback) {
+  requestAnimationFrame(() => setTimeout(callback, 0));
+}
+
 function updatePatternTypeVisibility() {
   if (!fillPatternTypeSelect || !fillRectWidthGroup) {
     return;
@@ -637,7 +1187,10 @@ function ensureThreeApp() {
       fileInput,
     },
     geometryFetcher: async params => {
-      const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
+      const result = renderSpiral(
+        { ...params, mode: 'arram_boyle', geometry_precision: PREVIEW_GEOMETRY_PRECISION },
+        'arram_boyle',
+      );
       if (!result.geometry || !Array.isArray(result.geometry.arcgroups)) {
         throw new Error('Geometry generation failed');
       }
@@ -647,6 +1200,12 @@ function ensureThreeApp() {
       };
     },
     getParams: collectParams,
+    onGeometryFrame: () => perfMeasure('3d-open-to-frame', '3d-open'),
+    hatchLines: new HatchLinesClient({
+      createWorker: workerSupported
+        ? () => new Worker(new URL('./hatch_worker.js', import.meta.url), { type: 'module' })
+        : null,
+    }),
   });
   return threeApp;
 }
@@ -680,33 +1239,63 @@ function showSVG(svgElement) {
   svgPreview.classList.remove('empty-state');
 }
 
-function handleRenderSuccess(result) {
+/**
+ * Re-runs the arram_boyle engine on the main thread for exports that need the
+ * live ArcGroups, keeping any animator hatch angles of the last render.
+ */
+function renderEngineFor(params) {
+  return renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle', {
+    arcGroupAngleOverrides: lastRender?.angleOverrides ?? null,
+  });
+}
+
+function handleRenderSuccess(result, job = {}) {
   const svgElement = materializeSvg(result);
   if (!svgElement) {
     throw new Error('Renderer produced no SVG content');
   }
 
   showSVG(svgElement);
+  afterNextPaint(() => {
+    perfMeasure('input-to-paint', 'input');
+    perfMeasure('render-to-paint', 'render-start');
+  });
 
   const params = result.params || collectParams();
-  const geometry = hasGeometry(result.geometry) ? result.geometry : null;
+  let geometry = hasGeometry(result.geometry) ? result.geometry : null;
+  if (result.geometryStore) {
+    geometry = geometryStore.adopt(result.geometryStore);
+  } else {
+    geometryStore.clear();
+  }
   const mode = result.mode || params?.mode || DEFAULTS.mode;
   const svgString = typeof result.svgString === 'string' && result.svgString.trim().length
     ? result.svgString
     : new XMLSerializer().serializeToString(svgElement);
 
-  lastRender = { params, geometry, mode, svgString };
+  // Plain renders are reproducible from params alone, so exports can be
+  // precomputed; animator results carry per-cell overrides and are not.
+  const angleOverrides = job.angleOverrides ?? null;
+  lastRender = {
+    params,
+    geometry,
+    mode,
+    svgString,
+    scaleFactor: result.scaleFactor ?? null,
+    angleOverrides,
+    fromParams: !angleOverrides,
+  };
 
   updateStats(geometry);
-  statMode.textContent = mode === 'arram_boyle' ? 'Arram-Boyle' : 'Classic Doyle';
-  setStatus('Spiral updated. Switch views to explore it in 3D.');
+  statMode.textContent = job.modeLabel || (mode === 'arram_boyle' ? 'Arram-Boyle' : 'Classic Doyle');
+  setStatus(job.statusText || 'Spiral updated. Switch views to explore it in 3D.');
   updateExportAvailability(true);
 
   // Update breakdown workpiece count when breakdown mode is active
   if (breakdownModeCheckbox?.checked) {
     // Engine is not available from worker results; compute synchronously for count
     try {
-      const res = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
+      const res = renderEngineFor(params);
       if (res?.engine?.arcGroups) {
         const wpW = Number(workpieceWidthInput?.value) || 100;
         const wpH = Number(workpieceHeightInput?.value) || 100;
@@ -730,6 +1319,12 @@ function handleRenderSuccess(result) {
     updateBreakdownRingCount(null);
   }
 
+  scheduleExportPrecompute();
+
+  if (deepZoomCheckbox?.checked) {
+    showDeepZoom();
+  }
+
   if (threeApp) {
     if (geometry) {
       threeApp.useGeometryFromPayload(params, geometry);
@@ -737,22 +1332,34 @@ function handleRenderSuccess(result) {
       threeApp.queueGeometryUpdate(params, true);
     }
   }
+
+  job.onRendered?.(svgElement);
 }
 
 function handleRenderFailure(message) {
+  closeDeepZoom();
   svgPreview.innerHTML = '<div class="empty-state">Unable to render spiral.</div>';
   svgPreview.classList.add('empty-state');
   setStatus(message || 'Unexpected error', 'error');
   lastRender = null;
+  geometryStore.clear();
+  exportPrecompute?.invalidate();
   updateExportAvailability(false);
 }
 
-function startRenderJob(params, showLoading) {
+/**
+ * Renders `params` in the render worker (or on the main thread without
+ * worker support). `job` carries optional animator hatch angles and hooks:
+ * { angleOverrides, modeLabel, statusText, onRendered(svgElement) }.
+ */
+function startRenderJob(params, showLoading, job = {}) {
   const token = ++currentRenderToken;
+  perfMark('render-start');
   const statusMessage = showLoading ? 'Rendering spiral…' : 'Updating spiral…';
   setStatus(statusMessage, 'loading');
 
   cancelActiveRenderJob();
+  exportPrecompute?.invalidate();
 
   const renderTimeoutMs = getRenderTimeoutMs();
 
@@ -796,7 +1403,7 @@ function startRenderJob(params, showLoading) {
       }
       if (data.type === 'result') {
         try {
-          handleRenderSuccess(data);
+          handleRenderSuccess(data, job);
         } catch (error) {
           console.error(error);
           handleRenderFailure(error.message || 'Unexpected error');
@@ -824,7 +1431,13 @@ function startRenderJob(params, showLoading) {
       handleRenderFailure(message);
     };
 
-    worker.postMessage({ type: 'render', requestId: token, params });
+    worker.postMessage({
+      type: 'render',
+      requestId: token,
+      params,
+      angleOverrides: job.angleOverrides ?? null,
+      geometryStore: { generation: token, shared: geometryStore.shared },
+    });
     return;
   }
 
@@ -834,8 +1447,8 @@ function startRenderJob(params, showLoading) {
     }
     activeRenderJob = null;
     try {
-      const result = renderSpiral(params);
-      handleRenderSuccess(result);
+      const result = renderSpiral(params, null, { arcGroupAngleOverrides: job.angleOverrides ?? null });
+      handleRenderSuccess(result, job);
     } catch (error) {
       console.error(error);
       handleRenderFailure(error.message || 'Unexpected error');
@@ -846,7 +1459,11 @@ function startRenderJob(params, showLoading) {
 
 function renderCurrentSpiral(showLoading = true) {
   const params = collectParams();
-  startRenderJob(params, showLoading);
+  startRenderJob({
+    ...params,
+    geometry_precision: PREVIEW_GEOMETRY_PRECISION,
+    svg_pattern_preview: PREVIEW_PATTERN_FILL,
+  }, showLoading);
 }
 
 const debouncedRender = debounce(() => renderCurrentSpiral(false), 200);
@@ -881,6 +1498,7 @@ if (symmetricToggle && inputP && inputQ) {
 }
 
 form.addEventListener('input', event => {
+  perfMark('input');
   if (event.target.name === 't') {
     updateTValue();
   }
@@ -933,6 +1551,25 @@ if (breakdownModeCheckbox) {
 // Init breakdown mode UI state
 updateBreakdownMode();
 
+// The STEP file embeds the thickness and product name; rebuild it when they change.
+[stepThicknessInput, exportFilenameInput, beamWidthInput].forEach(el => {
+  el?.addEventListener('change', scheduleExportPrecompute);
+});
+
+if (deepZoomCheckbox) {
+  deepZoomCheckbox.addEventListener('change', () => {
+    if (deepZoomCheckbox.checked) {
+      showDeepZoom();
+      return;
+    }
+    closeDeepZoom();
+    const svgElement = lastRender ? materializeSvg({ svgString: lastRender.svgString }) : null;
+    if (svgElement) {
+      showSVG(svgElement);
+    }
+  });
+}
+
 function switchToView(view) {
   if (view === activeView) {
     return;
@@ -956,6 +1593,7 @@ function switchToView(view) {
   }
 
   if (view === '3d') {
+    perfMark('3d-open');
     pulseSettingsButton();
     const app = ensureThreeApp();
     if (app) {
@@ -995,6 +1633,18 @@ if (exportStepButton) {
   exportStepButton.addEventListener('click', downloadCurrentStep);
 }
 
+if (exportGcodeButton) {
+  exportGcodeButton.addEventListener('click', downloadCurrentGcode);
+}
+
+if (rasterExportButton) {
+  rasterExportButton.addEventListener('click', downloadRasterHatch);
+}
+
+if (zoetropeExportButton) {
+  zoetropeExportButton.addEventListener('click', downloadZoetropePreview);
+}
+
 if (fillPatternTypeSelect) {
   fillPatternTypeSelect.addEventListener('change', updatePatternTypeVisibility);
 }
@@ -1005,6 +1655,252 @@ updateTValue();
 updateSymmetricHint();
 renderCurrentSpiral(true);
 
+// ============================================================
+// Deep Zoom Preview
+// ============================================================
+
+const MAX_PENDING_TILES = 8;
+const MAX_DEEP_ZOOM_SCALE = 2 ** (MAX_TILE_ZOOM - 2);
+
+let deepZoom = null; // Active tile viewer state while the deep-zoom preview is shown
+let tileWorker = null; // Builds the deep-zoom index and renders its tiles
+let tileIndexRequest = null; // { requestId, render } while the tile worker builds an index
+let tileRequestCounter = 0;
+
+function getTileWorker() {
+  if (tileWorker) {
+    return tileWorker;
+  }
+  tileWorker = new Worker(new URL('./tile_worker.js', import.meta.url), { type: 'module' });
+  tileWorker.addEventListener('message', event => {
+    const data = event.data || {};
+    if (data.type === 'index') {
+      const pending = tileIndexRequest;
+      if (!pending || pending.requestId !== data.requestId) {
+        return;
+      }
+      tileIndexRequest = null;
+      pending.render.tileIndex = { requestId: data.requestId, layout: data.layout };
+      if (lastRender === pending.render && deepZoomCheckbox?.checked) {
+        openDeepZoom(pending.render.tileIndex);
+      }
+      return;
+    }
+    if (data.type === 'tile') {
+      if (!deepZoom || deepZoom.requestId !== data.requestId) {
+        return;
+      }
+      deepZoom.pending.delete(data.key);
+      const url = URL.createObjectURL(new Blob([data.svg], { type: 'image/svg+xml;charset=utf-8' }));
+      deepZoom.cache.set(data.key, { url });
+      const img = deepZoom.images.get(data.key);
+      if (img) {
+        img.src = url;
+      }
+      requestTiles();
+      return;
+    }
+    if (data.type === 'error') {
+      if (tileIndexRequest?.requestId === data.requestId) {
+        tileIndexRequest = null;
+      }
+      setStatus(`Deep zoom failed: ${data.message}`, 'error');
+    }
+  });
+  return tileWorker;
+}
+
+function closeDeepZoom() {
+  if (!deepZoom) {
+    return;
+  }
+  deepZoom.cache.clear();
+  deepZoom = null;
+}
+
+/**
+ * Shows the deep-zoom preview of the last render. The tile worker rebuilds the
+ * render and indexes it once per render; until it answers, the regular
+ * preview stays up.
+ */
+function showDeepZoom() {
+  if (!lastRender || lastRender.mode !== 'arram_boyle' || !lastRender.params) {
+    setStatus('Deep zoom is only available for Arram-Boyle renders.', 'error');
+    return;
+  }
+  if (!workerSupported) {
+    setStatus('Deep zoom needs Web Worker support.', 'error');
+    return;
+  }
+  if (lastRender.tileIndex) {
+    openDeepZoom(lastRender.tileIndex);
+    return;
+  }
+  if (tileIndexRequest?.render === lastRender) {
+    return;
+  }
+  tileIndexRequest = { requestId: ++tileRequestCounter, render: lastRender };
+  getTileWorker().postMessage({
+    type: 'index',
+    requestId: tileIndexRequest.requestId,
+    params: lastRender.params,
+    angleOverrides: lastRender.angleOverrides ?? null,
+  });
+  setStatus('Building the deep zoom index…', 'loading');
+}
+
+function openDeepZoom({ requestId, layout: index }) {
+  const previous = deepZoom;
+  closeDeepZoom();
+
+  const viewport = document.createElement('div');
+  viewport.className = 'tile-viewport';
+  const layer = document.createElement('div');
+  layer.className = 'tile-layer';
+  viewport.appendChild(layer);
+  svgPreview.replaceChildren(viewport);
+  svgPreview.classList.remove('empty-state');
+
+  deepZoom = {
+    index,
+    requestId,
+    cache: new TileCache(256, entry => URL.revokeObjectURL(entry.url)),
+    images: new Map(),
+    queue: [],
+    pending: new Set(),
+    scale: previous ? previous.scale : 1,
+    centerX: previous ? previous.centerX : 0,
+    centerY: previous ? previous.centerY : 0,
+    viewport,
+    layer,
+  };
+
+  const pixelsPerUnit = () => Math.min(viewport.clientWidth, viewport.clientHeight) / index.size * deepZoom.scale;
+
+  viewport.addEventListener('wheel', event => {
+    event.preventDefault();
+    const bounds = viewport.getBoundingClientRect();
+    const ppu = pixelsPerUnit();
+    const px = event.clientX - bounds.left - bounds.width / 2;
+    const py = event.clientY - bounds.top - bounds.height / 2;
+    const worldX = deepZoom.centerX + px / ppu;
+    const worldY = deepZoom.centerY + py / ppu;
+    const factor = Math.exp(-event.deltaY * 0.0015);
+    deepZoom.scale = Math.min(MAX_DEEP_ZOOM_SCALE, Math.max(1, deepZoom.scale * factor));
+    const nextPpu = pixelsPerUnit();
+    deepZoom.centerX = worldX - px / nextPpu;
+    deepZoom.centerY = worldY - py / nextPpu;
+    layoutDeepZoom();
+  }, { passive: false });
+
+  let drag = null;
+  viewport.addEventListener('pointerdown', event => {
+    drag = { x: event.clientX, y: event.clientY };
+    viewport.setPointerCapture(event.pointerId);
+  });
+  viewport.addEventListener('pointermove', event => {
+    if (!drag) {
+      return;
+    }
+    const ppu = pixelsPerUnit();
+    deepZoom.centerX -= (event.clientX - drag.x) / ppu;
+    deepZoom.centerY -= (event.clientY - drag.y) / ppu;
+    drag = { x: event.clientX, y: event.clientY };
+    layoutDeepZoom();
+  });
+  const endDrag = () => { drag = null; };
+  viewport.addEventListener('pointerup', endDrag);
+  viewport.addEventListener('pointercancel', endDrag);
+  viewport.addEventListener('dblclick', () => {
+    deepZoom.scale = 1;
+    deepZoom.centerX = 0;
+    deepZoom.centerY = 0;
+    layoutDeepZoom();
+  });
+
+  layoutDeepZoom();
+}
+
+function layoutDeepZoom() {
+  if (!deepZoom) {
+    return;
+  }
+  const { viewport, layer, index, cache, images } = deepZoom;
+  const width = viewport.clientWidth;
+  const height = viewport.clientHeight;
+  if (!width || !height) {
+    return;
+  }
+  const ppu = Math.min(width, height) / index.size * deepZoom.scale;
+  const half = index.size / 2;
+  deepZoom.centerX = Math.min(half, Math.max(-half, deepZoom.centerX));
+  deepZoom.centerY = Math.min(half, Math.max(-half, deepZoom.centerY));
+  const rect = [
+    deepZoom.centerX - width / 2 / ppu,
+    deepZoom.centerY - height / 2 / ppu,
+    deepZoom.centerX + width / 2 / ppu,
+    deepZoom.centerY + height / 2 / ppu,
+  ];
+  const { tiles } = tilesForViewport(index, rect, ppu * (window.devicePixelRatio || 1));
+
+  const wanted = new Set();
+  deepZoom.queue = [];
+  for (const tile of tiles) {
+    const key = TileCache.key(tile.z, tile.x, tile.y);
+    wanted.add(key);
+    const [x0, y0, x1] = tileBounds(index, tile.z, tile.x, tile.y);
+    const sizePx = (x1 - x0) * ppu;
+    let img = images.get(key);
+    if (!img) {
+      img = document.createElement('img');
+      img.className = 'tile';
+      img.alt = '';
+      img.draggable = false;
+      layer.appendChild(img);
+      images.set(key, img);
+    }
+    img.style.left = `${(x0 - rect[0]) * ppu}px`;
+    img.style.top = `${(y0 - rect[1]) * ppu}px`;
+    img.style.width = `${sizePx}px`;
+    img.style.height = `${sizePx}px`;
+    const cached = cache.get(key);
+    if (cached) {
+      if (img.src !== cached.url) img.src = cached.url;
+    } else {
+      deepZoom.queue.push(tile);
+    }
+  }
+  for (const [key, img] of images) {
+    if (!wanted.has(key)) {
+      img.remove();
+      images.delete(key);
+    }
+  }
+
+  const visibleGroups = groupsInViewport(index, rect).length;
+  setStatus(`Deep zoom ×${deepZoom.scale.toFixed(1)} · ${visibleGroups} groups in view. Scroll to zoom, drag to pan, double-click to reset.`);
+  requestTiles();
+}
+
+/**
+ * Asks the tile worker for queued tiles, a few at a time, so tiles that scroll
+ * out of view before they are requested are never rendered.
+ */
+function requestTiles() {
+  if (!deepZoom) {
+    return;
+  }
+  while (deepZoom.queue.length && deepZoom.pending.size < MAX_PENDING_TILES) {
+    const tile = deepZoom.queue.shift();
+    const key = TileCache.key(tile.z, tile.x, tile.y);
+    if (deepZoom.pending.has(key) || deepZoom.cache.get(key)) {
+      continue;
+    }
+    deepZoom.pending.add(key);
+    tileWorker.postMessage({ type: 'tile', requestId: deepZoom.requestId, key, ...tile });
+  }
+}
+
 // ============================================================
 // Cellular Automaton Animator
 // ============================================================
@@ -1190,262 +2086,72 @@ function collectFramesAndRules() {
   return frames;
 }
 
-function matchesRule(currentState, ruleInput) {
-  // Check if current state matches the rule's input pattern
-  // Only check cells that are marked as "must be ON" in the input
-  if (ruleInput.center && !currentState.center) return false;
-  for (let i = 0; i < 6; i++) {
-    if (ruleInput.neighbors[i] && !currentState.neighbors[i]) return false;
-  }
-  return true;
-}
-
-function runCellularAnimation(context, frames, seedIds, loopMode = false) {
-  // Map: groupId -> boolean (is cell ON)
-  let currentState = new Map();
-  let nextState = new Map();
-
-  // Initialize all cells to OFF
-  context.metaList.forEach(meta => {
-    currentState.set(meta.id, false);
-    nextState.set(meta.id, false);
-  });
-
-  // Track activation angles for rendering (accumulate over iterations)
-  const activationAngles = new Map();
-  context.metaList.forEach(meta => activationAngles.set(meta.id, []));
-
-  // Seed: turn on selected cells (only if they exist in context)
-  let seedsApplied = 0;
-  if (seedIds && seedIds.size > 0) {
-    seedIds.forEach(id => {
-      if (currentState.has(id)) {
-        currentState.set(id, true);
-        seedsApplied++;
-      }
-    });
-  }
-
-  // Fall back to center ring if no valid seeds
-  if (seedsApplied === 0) {
-    context.metaList
-      .filter(m => m.ringIndex === context.minRing)
-      .forEach(m => {
-        currentState.set(m.id, true);
-        seedsApplied++;
-      });
-  }
-
-  // Add initial angle to seeds
-  for (const [id, isOn] of currentState) {
-    if (isOn && activationAngles.has(id)) {
-      activationAngles.get(id).push(0);
-    }
+/**
+ * Renders the spiral with animator hatch angles (indexed like
+ * geometry.arcgroups) through the normal render job, and mirrors the result
+ * into the animator preview.
+ */
+function renderWithAnimatorOverrides(angleOverrides, { modeLabel, statusText, resultOverlay = false }) {
+  const params = collectParams();
+  params.add_fill_pattern = true; // Force pattern fill
+  if (!fillToggle.checked) {
+    fillToggle.checked = true;
+    toggleFillSettings();
   }
-
-  let changed = true;
-  let iteration = 0;
-  const maxIterations = MAX_ANIMATION_FRAMES; // Limit iterations
-
-  while (changed && iteration < maxIterations) {
-    changed = false;
-
-    // Get current frame (cycle through frames)
-    const frame = frames[iteration % frames.length];
-    const rules = frame.rules;
-
-    // Reset next state - cells turn OFF unless a rule lights them up
-    context.metaList.forEach(meta => nextState.set(meta.id, false));
-
-    for (const meta of context.metaList) {
-      // Get current state of this cell and its neighbors
-      const neighbors = Array.from(meta.neighbors).slice(0, 6);
-      const cellState = {
-        center: currentState.get(meta.id),
-        neighbors: neighbors.map(n => n ? currentState.get(n.id) : false)
-      };
-
-      // Check each rule in this frame
-      for (const rule of rules) {
-        if (matchesRule(cellState, rule.input)) {
-          // Apply output pattern
-          if (rule.output.center) {
-            nextState.set(meta.id, true);
-            const angles = activationAngles.get(meta.id);
-            if (angles.length < 4) {
-              let newAngles;
-              if (frame.angle1 != null) {
-                // Use explicit angles from frame definition
-                newAngles = [frame.angle1];
-                if (frame.angle2 != null) newAngles.push(frame.angle2);
-              } else {
-                // Auto-compute: angle-split for loop mode using fwd=norm/2, bwd=(180-norm)/2+90
-                const a = (iteration * 22.5 + angles.length * 45) % 180;
-                if (loopMode) {
-                  const norm = ((a % 180) + 180) % 180;
-                  newAngles = [norm / 2, (180 - norm) / 2 + 90];
-                } else {
-                  newAngles = [a];
-                }
-              }
-              for (const na of newAngles) {
-                if (angles.length < 4 && !angles.some(a => Math.abs(a - na) < 10)) {
-                  angles.push(na);
-                }
-              }
-            }
-          }
-
-          // Light up neighbors according to output pattern
-          rule.output.neighbors.forEach((shouldLight, nIdx) => {
-            if (shouldLight && neighbors[nIdx]) {
-              const neighborId = neighbors[nIdx].id;
-              nextState.set(neighborId, true);
-              // Add angle to neighbor
-              const nAngles = activationAngles.get(neighborId);
-              if (nAngles.length < 4) {
-                let newAngles;
-                if (frame.angle1 != null) {
-                  newAngles = [frame.angle1];
-                  if (frame.angle2 != null) newAngles.push(frame.angle2);
-                } else {
-                  const a = (iteration * 15 + nIdx * 30) % 180;
-                  if (loopMode) {
-                    const norm = ((a % 180) + 180) % 180;
-                    newAngles = [norm / 2, (180 - norm) / 2 + 90];
-                  } else {
-                    newAngles = [a];
-                  }
-                }
-                for (const na of newAngles) {
-                  if (nAngles.length < 4 && !nAngles.some(a => Math.abs(a - na) < 10)) {
-                    nAngles.push(na);
-                  }
-                }
-              }
-            }
-          });
+  startRenderJob({
+    ...params,
+    geometry_precision: PREVIEW_GEOMETRY_PRECISION,
+    svg_pattern_preview: PREVIEW_PATTERN_FILL,
+  }, true, {
+    angleOverrides,
+    modeLabel,
+    statusText,
+    onRendered: svgElement => {
+      if (!animatorSvgPreview) return;
+      const svgClone = svgElement.cloneNode(true);
+      animatorSvgPreview.replaceChildren(svgClone);
+      animatorSvgPreview.classList.remove('empty-state');
+      if (resultOverlay && animatorLayout) {
+        // Selected cells shown as a transparent tint over the fill lines
+        const overlay = createCellOverlay(animatorLayout, svgClone);
+        if (overlay) {
+          const overlayContainer = document.createElement('div');
+          overlayContainer.className = 'cell-overlay result-mode';
+          overlayContainer.appendChild(overlay);
+          animatorSvgPreview.appendChild(overlayContainer);
+          updateManualSvgHighlights();
         }
       }
-    }
-
-    // Check if state changed
-    for (const meta of context.metaList) {
-      if (currentState.get(meta.id) !== nextState.get(meta.id)) {
-        changed = true;
-        break;
-      }
-    }
-
-    // Swap states
-    [currentState, nextState] = [nextState, currentState];
-    iteration++;
-  }
-
-  // Convert final state to activations map (empty array = OFF, array with angles = ON)
-  const activations = new Map();
-  context.metaList.forEach(meta => {
-    const isOn = currentState.get(meta.id);
-    const angles = activationAngles.get(meta.id);
-    activations.set(meta.id, isOn && angles.length > 0 ? angles : []);
+    },
   });
-
-  return activations;
 }
 
-function loadManualAnimation() {
+async function loadManualAnimation() {
   const frame = manualFrames[activeManualFrameIndex];
   if (!frame) {
     setStatus('No manual frame selected', 'error');
     return;
   }
 
-  // Ensure the interactive preview has been built (provides animatorContext + animatorEngine)
-  if (!animatorContext || !animatorEngine) {
-    makeAnimatorSvgInteractive();
-  }
-  if (!animatorContext || !animatorEngine) {
-    setStatus('Preview not loaded — click Refresh Preview first', 'error');
+  let layout;
+  try {
+    layout = await ensureAnimatorLayout();
+  } catch (error) {
+    setStatus(`Preview not loaded — ${error.message}`, 'error');
     return;
   }
 
-  const params = collectParams();
-
-  // Build overrides directly from animatorContext group names — no re-render needed,
-  // we reuse the same engine so group names are exactly consistent with what the user clicked.
+  // Overrides are indexed by cell, so they apply to any render of these parameters.
   const angle = frame.angle != null ? frame.angle : 45;
-  const arcGroupAngleOverrides = new Map();
-  for (const meta of animatorContext.metaList) {
-    const name = meta.group.name;
-    arcGroupAngleOverrides.set(name, frame.activeIds.has(name) ? [angle] : []);
-  }
-
-  if (!fillToggle.checked) {
-    fillToggle.checked = true;
-    toggleFillSettings();
-  }
-
-  const svgResult = animatorEngine.render('arram_boyle', {
-    size: params.size,
-    debugGroups: false,
-    addFillPattern: true,
-    fillPatternSpacing: params.fill_pattern_spacing,
-    fillPatternAngle: params.fill_pattern_angle,
-    fillPatternAnimation: params.fill_pattern_animation,
-    arcGroupAngleOverrides,
-    redOutline: params.red_outline,
-    drawGroupOutline: params.draw_group_outline,
-    fillPatternOffset: params.fill_pattern_offset,
-    fillPatternType: params.fill_pattern_type,
-    fillPatternRectWidth: params.fill_pattern_rect_width,
-    highlightRimWidth: params.highlight_rim_width,
-    groupOutlineWidth: params.group_outline_width,
-    patternStrokeWidth: params.pattern_stroke_width,
-    boundingBoxWidth: params.bounding_box_width_mm,
-    boundingBoxHeight: params.bounding_box_height_mm,
-    lengthUnits: 'mm',
-    useSymmetric: params.use_symmetric,
+  renderWithAnimatorOverrides(manualAngleOverrides(layout, frame.activeIds, angle), {
+    modeLabel: 'Manual',
+    statusText: `Manual frame ${activeManualFrameIndex + 1} loaded — ${frame.activeIds.size} cells active.`,
+    resultOverlay: true,
   });
-
-  if (svgResult && svgResult.svg) {
-    const svgClone = svgResult.svg.cloneNode(true);
-    svgClone.setAttribute('width', '100%');
-    svgClone.setAttribute('height', '100%');
-    svgClone.setAttribute('preserveAspectRatio', 'xMidYMid meet');
-    if (animatorSvgPreview) {
-      animatorSvgPreview.replaceChildren(svgClone);
-      animatorSvgPreview.classList.remove('empty-state');
-      // Re-add overlay in result-mode: selected cells shown as transparent tint over fill lines
-      const scaleFactor = svgResult.scaleFactor || 1;
-      const overlay = createCellOverlay(animatorContext, svgClone, scaleFactor);
-      if (overlay) {
-        const overlayContainer = document.createElement('div');
-        overlayContainer.className = 'cell-overlay result-mode';
-        overlayContainer.appendChild(overlay);
-        animatorSvgPreview.appendChild(overlayContainer);
-        updateManualSvgHighlights();
-      }
-    }
-    showSVG(svgResult.svg);
-    lastRender = {
-      params,
-      geometry: svgResult.geometry,
-      mode: 'arram_boyle',
-      svgString: svgResult.svgString,
-      engine: animatorEngine,
-    };
-    updateStats(svgResult.geometry);
-    statMode.textContent = 'Manual';
-    setStatus(`Manual frame ${activeManualFrameIndex + 1} loaded — ${frame.activeIds.size} cells active.`);
-    updateExportAvailability(true);
-    if (threeApp && svgResult.geometry) {
-      threeApp.useGeometryFromPayload(params, svgResult.geometry);
-    }
-  }
 }
 
 
-function loadAnimation() {
+async function loadAnimation() {
   if (animatorMode === 'manual') {
     loadManualAnimation();
     return;
@@ -1467,133 +2173,24 @@ function loadAnimation() {
     return;
   }
 
-  // Ensure we have a render first
-  if (!lastRender || !lastRender.geometry) {
-    setStatus('Rendering spiral first...', 'loading');
-    renderCurrentSpiral(true);
-  }
-
-  // Need the engine to have arcGroups populated - do a fresh render
-  const params = collectParams();
-  params.add_fill_pattern = true; // Force pattern fill
-  const result = renderSpiral(params);
-
-  if (!result || !result.engine || !result.engine.arcGroups) {
-    setStatus('Failed to generate geometry for animation', 'error');
-    return;
-  }
-
-  // Build context and run CA with user-selected seeds
-  const loopMode = animatorLoopCheckbox?.checked ?? false;
-  const context = buildPatternAnimationContext(result.engine.arcGroups);
-
-  let activations;
-  if (loopMode) {
-    // For loop mode, find the midpoint snapshot (peak activation) and use its angles
-    const snapshots = simulateCAIterations(context, frames, selectedSeeds, 100);
-    // Midpoint is the frame with the most activated cells (peak of forward pass)
-    let peakIdx = 0;
-    let peakCount = 0;
-    snapshots.forEach((stateMap, idx) => {
-      let count = 0;
-      for (const isOn of stateMap.values()) { if (isOn) count++; }
-      if (count > peakCount) { peakCount = count; peakIdx = idx; }
-    });
-    const peakState = snapshots[peakIdx] || snapshots[snapshots.length - 1];
-    // Build activations from peak state, applying angle-split (fwd = auto/2, rev = auto)
-    activations = new Map();
-    context.metaList.forEach(meta => {
-      const isOn = peakState.get(meta.id);
-      if (isOn) {
-        const frame = frames[(peakIdx > 0 ? peakIdx - 1 : 0) % frames.length];
-        let fwdAngle, revAngle;
-        if (frame.angle1 != null) {
-          fwdAngle = frame.angle1;
-          revAngle = frame.angle2 != null ? frame.angle2 : frame.angle1;
-        } else {
-          const a = (peakIdx * 22.5) % 180;
-          const norm = ((a % 180) + 180) % 180;
-          fwdAngle = norm / 2;
-          revAngle = (180 - norm) / 2 + 90;
-        }
-        const angles = Math.abs(fwdAngle - revAngle) < 5 ? [fwdAngle] : [fwdAngle, revAngle];
-        activations.set(meta.id, angles);
-      } else {
-        activations.set(meta.id, []);
-      }
+  setStatus('Running animation…', 'loading');
+  let reply;
+  try {
+    await ensureAnimatorLayout();
+    reply = await animatorClient.request('ca', {
+      frames,
+      seeds: Array.from(selectedSeeds),
+      loopMode: animatorLoopCheckbox?.checked ?? false,
     });
-  } else {
-    activations = runCellularAnimation(context, frames, selectedSeeds, false);
-  }
-
-  // Build an angle-overrides map keyed by group.name (stable across renders, e.g. "circle_2")
-  // Map from context numeric id → stable group name for lookup
-  const idToName = new Map(context.metaList.map(m => [m.id, m.group.name]));
-  const arcGroupAngleOverrides = new Map();
-  for (const [groupId, angles] of activations) {
-    const name = idToName.get(groupId);
-    if (name) arcGroupAngleOverrides.set(name, angles);
-  }
-
-  // Ensure pattern fill is enabled
-  if (!fillToggle.checked) {
-    fillToggle.checked = true;
-    toggleFillSettings();
+  } catch (error) {
+    setStatus(`Failed to generate geometry for animation: ${error.message}`, 'error');
+    return;
   }
 
-  // Re-render with CA angle overrides passed directly into the render pipeline
-  const svgResult = result.engine.render('arram_boyle', {
-    size: params.size,
-    debugGroups: false,
-    addFillPattern: true,
-    fillPatternSpacing: params.fill_pattern_spacing,
-    fillPatternAngle: params.fill_pattern_angle,
-    fillPatternAnimation: params.fill_pattern_animation,
-    arcGroupAngleOverrides,
-    redOutline: params.red_outline,
-    drawGroupOutline: params.draw_group_outline,
-    fillPatternOffset: params.fill_pattern_offset,
-    fillPatternType: params.fill_pattern_type,
-    fillPatternRectWidth: params.fill_pattern_rect_width,
-    highlightRimWidth: params.highlight_rim_width,
-    groupOutlineWidth: params.group_outline_width,
-    patternStrokeWidth: params.pattern_stroke_width,
-    boundingBoxWidth: params.bounding_box_width_mm,
-    boundingBoxHeight: params.bounding_box_height_mm,
-    lengthUnits: 'mm',
-    useSymmetric: params.use_symmetric,
+  renderWithAnimatorOverrides(reply.overrides, {
+    modeLabel: 'Arram-Boyle',
+    statusText: 'Animation loaded successfully.',
   });
-
-  if (svgResult && svgResult.svg) {
-    // Show in animator preview
-    const svgClone = svgResult.svg.cloneNode(true);
-    svgClone.setAttribute('width', '100%');
-    svgClone.setAttribute('height', '100%');
-    svgClone.setAttribute('preserveAspectRatio', 'xMidYMid meet');
-    if (animatorSvgPreview) {
-      animatorSvgPreview.replaceChildren(svgClone);
-      animatorSvgPreview.classList.remove('empty-state');
-    }
-
-    // Also update main 2D preview
-    showSVG(svgResult.svg);
-    lastRender = {
-      params,
-      geometry: svgResult.geometry,
-      mode: 'arram_boyle',
-      svgString: svgResult.svgString,
-      engine: result.engine,
-    };
-    updateStats(svgResult.geometry);
-    statMode.textContent = 'Arram-Boyle';
-    setStatus('Animation loaded successfully.');
-    updateExportAvailability(true);
-
-    // Update 3D viewer if it exists
-    if (threeApp && svgResult.geometry) {
-      threeApp.useGeometryFromPayload(params, svgResult.geometry);
-    }
-  }
 }
 
 // Drag and drop state
@@ -1738,11 +2335,11 @@ function updateSeedCount() {
   }
 }
 
-function toggleSeedSelection(groupId) {
-  if (selectedSeeds.has(groupId)) {
-    selectedSeeds.delete(groupId);
+function toggleSeedSelection(cell) {
+  if (selectedSeeds.has(cell)) {
+    selectedSeeds.delete(cell);
   } else {
-    selectedSeeds.add(groupId);
+    selectedSeeds.add(cell);
   }
   updateSeedCount();
   updateSvgSeedHighlights();
@@ -1752,21 +2349,83 @@ function updateSvgSeedHighlights() {
   if (!animatorSvgPreview) return;
   const markers = animatorSvgPreview.querySelectorAll('.cell-marker');
   markers.forEach(marker => {
-    const groupId = marker.dataset.groupId;
-    if (groupId && selectedSeeds.has(groupId)) {
-      marker.classList.add('selected');
-    } else {
-      marker.classList.remove('selected');
-    }
+    marker.classList.toggle('selected', selectedSeeds.has(Number(marker.dataset.cell)));
+  });
+}
+
+/**
+ * Loads the last render's geometry into the animator worker (once per
+ * render) and resolves with its cell layout. Without an arram_boyle render
+ * to reuse, the worker renders the geometry itself.
+ */
+function ensureAnimatorLayout() {
+  const geometry = lastRender?.mode === 'arram_boyle' && hasGeometry(lastRender.geometry) ? lastRender.geometry : null;
+  const params = geometry ? lastRender.params : collectParams();
+  const source = geometry || JSON.stringify(params);
+  if (animatorLayoutRequest && animatorLayoutRequest.source === source) {
+    return animatorLayoutRequest.promise;
+  }
+  const scaleFactor = geometry ? lastRender.scaleFactor : null;
+  // A stored render reaches the worker as its store: shared, or a transferred copy.
+  // The control word travels with it, so a worker refuses it once a newer render is current.
+  const stored = geometry && geometryStore.current ? geometryForWorker(geometryStore.current, geometryStore.control) : null;
+  const promise = (stored
+    ? animatorClient.request('load', { geometryStore: stored.store, scaleFactor, params }, stored.transfer)
+    : animatorClient.request('load', { geometry, scaleFactor, params }))
+    .then(reply => {
+      const layout = { ...reply.layout, params };
+      if (animatorLayoutRequest?.promise === promise) {
+        animatorLayout = layout;
+      }
+      return layout;
+    });
+  animatorLayoutRequest = { source, promise };
+  promise.catch(() => {
+    if (animatorLayoutRequest?.promise === promise) animatorLayoutRequest = null;
   });
+  return promise;
 }
 
-function createCellOverlay(context, svgEl, scaleFactor) {
+function animatorViewBox(layout) {
+  const width = layout.params.bounding_box_width_mm;
+  const height = layout.params.bounding_box_height_mm;
+  return { width, height, viewBox: `${-width / 2} ${-height / 2} ${width} ${height}` };
+}
+
+/**
+ * Draws the cell outlines of an animator layout. `styleFor(cell)` returns
+ * {fill, fillOpacity, stroke, strokeWidth} per cell; `decorate(svg)` may add
+ * extra marks on top.
+ */
+function buildAnimatorSvg(layout, styleFor, decorate = null) {
+  const svgNS = 'http://www.w3.org/2000/svg';
+  const { width, height, viewBox } = animatorViewBox(layout);
+  const svg = document.createElementNS(svgNS, 'svg');
+  svg.setAttribute('xmlns', svgNS);
+  svg.setAttribute('viewBox', viewBox);
+  svg.setAttribute('width', `${width}mm`);
+  svg.setAttribute('height', `${height}mm`);
+  layout.paths.forEach((d, cell) => {
+    if (!d) return;
+    const style = styleFor(cell);
+    const path = document.createElementNS(svgNS, 'path');
+    path.setAttribute('d', d);
+    path.setAttribute('fill', style.fill);
+    path.setAttribute('fill-opacity', String(style.fillOpacity ?? 1));
+    path.setAttribute('stroke', style.stroke);
+    path.setAttribute('stroke-width', String(style.strokeWidth));
+    svg.appendChild(path);
+  });
+  if (decorate) decorate(svg);
+  return svg;
+}
+
+function createCellOverlay(layout, svgEl) {
   // Get the viewBox of the main SVG to match coordinates
   const viewBox = svgEl.getAttribute('viewBox');
   if (!viewBox) return null;
 
-  const [vbX, vbY, vbWidth, vbHeight] = viewBox.split(/\s+/).map(Number);
+  const [, , vbWidth, vbHeight] = viewBox.split(/\s+/).map(Number);
 
   // Create overlay SVG
   const overlay = document.createElementNS('http://www.w3.org/2000/svg', 'svg');
@@ -1777,91 +2436,60 @@ function createCellOverlay(context, svgEl, scaleFactor) {
   // Calculate marker size based on viewBox
   const markerRadius = Math.min(vbWidth, vbHeight) * 0.025;
 
-  // Create a marker for each cell at its centroid
-  // Apply the same scale factor used by the SVG rendering
-  context.metaList.forEach(meta => {
-    // Scale centroid coordinates to match SVG coordinate space
-    const cx = meta.centroid.x * scaleFactor;
-    const cy = meta.centroid.y * scaleFactor;
-
+  // One marker per animated cell at its centroid (already in drawing units)
+  const { cell, ring, x, y } = layout.cells;
+  for (let i = 0; i < cell.length; i++) {
     const g = document.createElementNS('http://www.w3.org/2000/svg', 'g');
     g.classList.add('cell-marker');
-    g.dataset.groupId = meta.id;
-    g.dataset.groupName = meta.group.name;
+    g.dataset.cell = cell[i];
 
     const circle = document.createElementNS('http://www.w3.org/2000/svg', 'circle');
-    circle.setAttribute('cx', cx);
-    circle.setAttribute('cy', cy);
+    circle.setAttribute('cx', x[i]);
+    circle.setAttribute('cy', y[i]);
     circle.setAttribute('r', markerRadius);
 
     const text = document.createElementNS('http://www.w3.org/2000/svg', 'text');
-    text.setAttribute('x', cx);
-    text.setAttribute('y', cy);
+    text.setAttribute('x', x[i]);
+    text.setAttribute('y', y[i]);
     text.setAttribute('text-anchor', 'middle');
     text.setAttribute('dominant-baseline', 'central');
     text.setAttribute('font-size', markerRadius * 0.9);
-    text.textContent = meta.ringIndex;
+    text.textContent = ring[i];
 
     g.appendChild(circle);
     g.appendChild(text);
     overlay.appendChild(g);
-  });
+  }
 
   return overlay;
 }
 
-function makeAnimatorSvgInteractive() {
-  if (!animatorSvgPreview) return;
-
-  // Render a fresh SVG for the animator
-  const params = collectParams();
-  const result = renderSpiral(params);
-
-  if (!result || !result.engine || !result.engine.arcGroups) {
-    return;
-  }
-
-  // Cache the context and engine for later use
-  animatorContext = buildPatternAnimationContext(result.engine.arcGroups);
-  animatorEngine = result.engine;
-
-  // Clear existing content
-  animatorSvgPreview.innerHTML = '';
-
-  // Render SVG without fill pattern to show just outlines
-  const svgResult = result.engine.render('arram_boyle', {
-    size: params.size,
-    debugGroups: false,
-    addFillPattern: false,
-    drawGroupOutline: true,
-    boundingBoxWidth: params.bounding_box_width_mm,
-    boundingBoxHeight: params.bounding_box_height_mm,
-    lengthUnits: 'mm',
-  });
+async function makeAnimatorSvgInteractive() {
+  if (!animatorSvgPreview) return null;
 
-  if (!svgResult || !svgResult.svg) {
-    return;
+  let layout;
+  try {
+    layout = await ensureAnimatorLayout();
+  } catch (error) {
+    console.error(error);
+    return null;
   }
 
-  const svgClone = svgResult.svg.cloneNode(true);
-  svgClone.setAttribute('width', '100%');
-  svgClone.setAttribute('height', '100%');
-  svgClone.setAttribute('preserveAspectRatio', 'xMidYMid meet');
-  animatorSvgPreview.appendChild(svgClone);
+  // Outline-only view built from the render's own geometry
+  const strokeWidth = Number(layout.params.group_outline_width) || DEFAULTS.group_outline_width;
+  const svg = buildAnimatorSvg(layout, () => ({ fill: 'none', stroke: 'black', strokeWidth }));
+  svg.setAttribute('width', '100%');
+  svg.setAttribute('height', '100%');
+  svg.setAttribute('preserveAspectRatio', 'xMidYMid meet');
+  animatorSvgPreview.replaceChildren(svg);
   animatorSvgPreview.classList.remove('empty-state');
 
-  // Get the scale factor from the render result
-  const scaleFactor = svgResult.scaleFactor || 1;
-
-  // Create and add the cell overlay with the correct scale factor
-  if (animatorContext) {
-    const overlay = createCellOverlay(animatorContext, svgClone, scaleFactor);
-    if (overlay) {
-      const overlayContainer = document.createElement('div');
-      overlayContainer.className = 'cell-overlay';
-      overlayContainer.appendChild(overlay);
-      animatorSvgPreview.appendChild(overlayContainer);
-    }
+  const overlay = createCellOverlay(layout, svg);
+  if (overlay) {
+    const overlayContainer = document.createElement('div');
+    overlayContainer.className = 'cell-overlay';
+    overlayContainer.appendChild(overlay);
+    animatorSvgPreview.appendChild(overlayContainer);
   }
 
   if (animatorMode === 'manual') {
@@ -1869,27 +2497,26 @@ function makeAnimatorSvgInteractive() {
   } else {
     updateSvgSeedHighlights();
   }
+  return layout;
 }
 
-function selectSeedsByPreset(preset) {
-  if (!animatorContext) {
-    makeAnimatorSvgInteractive();
+async function selectSeedsByPreset(preset) {
+  let layout;
+  try {
+    layout = await ensureAnimatorLayout();
+  } catch (_) {
+    return;
   }
 
-  if (!animatorContext) return;
-
   selectedSeeds.clear();
 
-  if (preset === 'center') {
-    animatorContext.metaList
-      .filter(m => m.ringIndex === animatorContext.minRing)
-      .forEach(m => selectedSeeds.add(m.id));
-  } else if (preset === 'outer') {
-    animatorContext.metaList
-      .filter(m => m.ringIndex === animatorContext.maxRing)
-      .forEach(m => selectedSeeds.add(m.id));
-  } else if (preset === 'all') {
-    animatorContext.metaList.forEach(m => selectedSeeds.add(m.id));
+  const { cell, ring } = layout.cells;
+  for (let i = 0; i < cell.length; i++) {
+    if (preset === 'all'
+      || (preset === 'center' && ring[i] === layout.minRing)
+      || (preset === 'outer' && ring[i] === layout.maxRing)) {
+      selectedSeeds.add(cell[i]);
+    }
   }
   // 'clear' just clears, which we already did
 
@@ -1905,8 +2532,8 @@ function refreshAnimatorPreview() {
     const existingSvg = animatorSvgPreview.querySelector('svg');
     if (existingSvg) existingSvg.remove();
   }
-  animatorContext = null;
-  animatorEngine = null;
+  animatorLayout = null;
+  animatorLayoutRequest = null;
   makeAnimatorSvgInteractive();
 }
 
@@ -1915,12 +2542,13 @@ if (animatorSvgPreview) {
   animatorSvgPreview.addEventListener('click', event => {
     const marker = event.target.closest('.cell-marker');
     if (marker) {
+      perfMark('animator-click');
+      afterNextPaint(() => perfMeasure('animator-toggle-to-highlight', 'animator-click'));
+      const cell = Number(marker.dataset.cell);
       if (animatorMode === 'manual') {
-        const name = marker.dataset.groupName;
-        if (name) toggleManualCell(name);
+        toggleManualCell(cell);
       } else {
-        const groupId = marker.dataset.groupId;
-        if (groupId) toggleSeedSelection(groupId);
+        toggleSeedSelection(cell);
       }
     }
   });
@@ -1999,20 +2627,17 @@ function updateManualSvgHighlights() {
   if (!frame) return;
   const markers = animatorSvgPreview.querySelectorAll('.cell-marker');
   markers.forEach(marker => {
-    const name = marker.dataset.groupName;
-    if (name) {
-      marker.classList.toggle('selected', frame.activeIds.has(name));
-    }
+    marker.classList.toggle('selected', frame.activeIds.has(Number(marker.dataset.cell)));
   });
 }
 
-function toggleManualCell(groupId) {
+function toggleManualCell(cell) {
   const frame = manualFrames[activeManualFrameIndex];
   if (!frame) return;
-  if (frame.activeIds.has(groupId)) {
-    frame.activeIds.delete(groupId);
+  if (frame.activeIds.has(cell)) {
+    frame.activeIds.delete(cell);
   } else {
-    frame.activeIds.add(groupId);
+    frame.activeIds.add(cell);
   }
   renderManualFrameList();
   updateManualSvgHighlights();
@@ -2081,7 +2706,7 @@ switchToView = function(view) {
       if (!animatorInitialized) {
         animatorInitialized = true;
         loadExampleAnimation();
-        // Select center ring as initial seeds
+        // Select center ring as initial seeds (shares the layout load above)
         selectSeedsByPreset('center');
       }
     }, 100);
@@ -2126,196 +2751,48 @@ animatorTabs.forEach(tab => {
 // Frame Preview Rendering
 // ============================================================
 
-const MAX_ANIMATION_FRAMES = 1000;
-
-function simulateCAIterations(context, frames, seedIds, maxIterations = 50) {
-  // Cap maxIterations at the global limit
-  maxIterations = Math.min(maxIterations, MAX_ANIMATION_FRAMES);
-  // Simulate CA and return snapshots at each iteration
-  // Returns array of Maps, one for each iteration's state
-  const snapshots = [];
-  let currentState = new Map();
-  let nextState = new Map();
-
-  // Initialize all cells to OFF
-  context.metaList.forEach(meta => {
-    currentState.set(meta.id, false);
-    nextState.set(meta.id, false);
-  });
-
-  // Seed: turn on selected cells
-  let seedsApplied = 0;
-  if (seedIds && seedIds.size > 0) {
-    seedIds.forEach(id => {
-      if (currentState.has(id)) {
-        currentState.set(id, true);
-        seedsApplied++;
-      }
-    });
-  }
-
-  // Fall back to center ring if no seeds were applied
-  if (seedsApplied === 0) {
-    context.metaList
-      .filter(m => m.ringIndex === context.minRing)
-      .forEach(m => {
-        currentState.set(m.id, true);
-        seedsApplied++;
-      });
-  }
-
-  // Save initial state as first snapshot
-  snapshots.push(new Map(currentState));
-
-  // Count initial active
-  let initialActive = 0;
-  for (const [id, isOn] of currentState) {
-    if (isOn) initialActive++;
-  }
-  console.log(`[CA Sim] Initial state: ${initialActive} seed cells active`);
-
-  if (frames.length === 0) return snapshots;
+const FRAME_ON_STYLE = { fill: '#D4AF37', fillOpacity: 0.85, stroke: '#8B6914', strokeWidth: 1.2 };
+const FRAME_OFF_STYLE = { fill: '#E2E8F0', fillOpacity: 0.3, stroke: '#94A3B8', strokeWidth: 0.4 };
 
-  let changed = true;
-  let iteration = 0;
-
-  // Run CA and capture state at each iteration
-  while (changed && iteration < maxIterations) {
-    changed = false;
-
-    // Cycle through the frames
-    const frame = frames[iteration % frames.length];
-    const rules = frame.rules;
-
-    // Reset next state - cells turn OFF unless a rule lights them up
-    context.metaList.forEach(meta => nextState.set(meta.id, false));
-
-    for (const meta of context.metaList) {
-      const neighbors = Array.from(meta.neighbors).slice(0, 6);
-      const cellState = {
-        center: currentState.get(meta.id),
-        neighbors: neighbors.map(n => n ? currentState.get(n.id) : false)
-      };
-
-      for (const rule of rules) {
-        if (matchesRule(cellState, rule.input)) {
-          if (rule.output.center) {
-            nextState.set(meta.id, true);
-          }
-          rule.output.neighbors.forEach((shouldLight, nIdx) => {
-            if (shouldLight && neighbors[nIdx]) {
-              nextState.set(neighbors[nIdx].id, true);
-            }
-          });
-        }
-      }
-    }
-
-    // Check if state changed
-    for (const meta of context.metaList) {
-      if (currentState.get(meta.id) !== nextState.get(meta.id)) {
-        changed = true;
-        break;
-      }
-    }
-
-    // Swap states
-    [currentState, nextState] = [nextState, currentState];
-
-    // Count active cells
-    let activeCount = 0;
-    for (const [id, isOn] of currentState) {
-      if (isOn) activeCount++;
+/**
+ * Draws one hatch-direction stroke through each lit cell of a preset frame.
+ */
+function drawHatchTicks(layout, angles) {
+  return svg => {
+    const { cell, x, y, extent } = layout.cells;
+    const strokeWidth = Number(layout.params.pattern_stroke_width) || DEFAULTS.pattern_stroke_width;
+    for (let i = 0; i < cell.length; i++) {
+      const angle = angles[cell[i]];
+      if (!Number.isFinite(angle)) continue;
+      const rad = angle * Math.PI / 180;
+      const dx = Math.cos(rad) * extent[i] * 0.6;
+      const dy = Math.sin(rad) * extent[i] * 0.6;
+      const line = document.createElementNS('http://www.w3.org/2000/svg', 'line');
+      line.setAttribute('x1', x[i] - dx);
+      line.setAttribute('y1', y[i] - dy);
+      line.setAttribute('x2', x[i] + dx);
+      line.setAttribute('y2', y[i] + dy);
+      line.setAttribute('stroke', '#8B6914');
+      line.setAttribute('stroke-width', String(strokeWidth * 2));
+      svg.appendChild(line);
     }
-
-    // Save snapshot of this iteration
-    snapshots.push(new Map(currentState));
-    iteration++;
-
-    console.log(`[CA Sim] Iteration ${iteration}: ${activeCount} active cells, changed=${changed}`);
-  }
-
-  console.log(`[CA Sim] Stopped after ${iteration} iterations. Changed=${changed}`);
-  return snapshots;
-}
-
-function renderFramePreviewSvg(activatedIds, params) {
-  // Ensure we have valid spiral parameters
-  const safeParams = {
-    ...params,
-    p: params.p || 16,
-    q: params.q || 16,
-    debug_groups: false,
-    add_fill_pattern: false,
-    draw_group_outline: true,
-    size: params.size || 200, // Smaller size for previews
   };
+}
 
-  // Render a minimal spiral without debug colors - we'll add our own colors
-  const result = renderSpiral(safeParams);
-
-  if (!result || !result.svg || !result.engine) return null;
-
-  // Create a fresh SVG with custom coloring based on activation
-  const svgEl = result.svg;
-  const width = svgEl.getAttribute('width');
-  const height = svgEl.getAttribute('height');
-  const viewBox = svgEl.getAttribute('viewBox');
-
-  // Create new SVG element
-  const newSvg = document.createElementNS('http://www.w3.org/2000/svg', 'svg');
-  newSvg.setAttribute('width', width);
-  newSvg.setAttribute('height', height);
-  if (viewBox) newSvg.setAttribute('viewBox', viewBox);
-  newSvg.setAttribute('xmlns', 'http://www.w3.org/2000/svg');
-
-  // Render each group with the appropriate color
-  for (const [key, group] of result.engine.arcGroups.entries()) {
-    if (key.startsWith('outer_')) continue;
-
-    const isActivated = activatedIds.has(key);
-    const fillColor = isActivated ? '#D4AF37' : '#E2E8F0'; // Golden or light gray
-    const fillOpacity = isActivated ? 0.85 : 0.3;
-    const strokeColor = isActivated ? '#8B6914' : '#94A3B8';
-    const strokeWidth = isActivated ? 1.2 : 0.4;
-
-    // Get the group outline path
-    const outline = group.getOutline();
-    if (!outline || outline.length === 0) continue;
-
-    // Build path data from outline
-    let pathData = '';
-    for (const segment of outline) {
-      if (segment.type === 'arc') {
-        const { start, end, radius, largeArc, sweep } = segment;
-        if (pathData === '') {
-          pathData = `M ${start.x} ${start.y}`;
-        }
-        pathData += ` A ${radius} ${radius} 0 ${largeArc ? 1 : 0} ${sweep ? 1 : 0} ${end.x} ${end.y}`;
-      } else if (segment.type === 'line') {
-        const { start, end } = segment;
-        if (pathData === '') {
-          pathData = `M ${start.x} ${start.y}`;
-        }
-        pathData += ` L ${end.x} ${end.y}`;
-      }
-    }
-    if (pathData) {
-      pathData += ' Z';
-      const path = document.createElementNS('http://www.w3.org/2000/svg', 'path');
-      path.setAttribute('d', pathData);
-      path.setAttribute('fill', fillColor);
-      path.setAttribute('fill-opacity', fillOpacity.toString());
-      path.setAttribute('stroke', strokeColor);
-      path.setAttribute('stroke-width', strokeWidth.toString());
-      newSvg.appendChild(path);
-    }
-  }
-
-  return { svg: newSvg };
+function appendFramePreview(scrollContainer, header, info, svg) {
+  const item = document.createElement('div');
+  item.className = 'frame-preview-item';
+  item.innerHTML = `
+    <div class="frame-preview-header">${header}</div>
+    <div class="frame-preview-svg"></div>
+    <div class="frame-preview-info">${info}</div>
+  `;
+  svg.setAttribute('preserveAspectRatio', 'xMidYMid meet');
+  item.querySelector('.frame-preview-svg').appendChild(svg);
+  scrollContainer.appendChild(item);
 }
 
-function renderFramePreviews() {
+async function renderFramePreviews() {
   if (!animatorFramePreview) return;
 
   const scrollContainer = animatorFramePreview.querySelector('.frame-preview-scroll');
@@ -2327,119 +2804,61 @@ function renderFramePreviews() {
   const frames = collectFramesAndRules();
   const loopMode = animatorLoopCheckbox?.checked ?? false;
   const params = collectParams();
+  const showMessage = text => {
+    scrollContainer.innerHTML = `<div class="empty-state" style="padding: 2rem; color: var(--text-muted);">${text}</div>`;
+  };
 
-  // Render a reference spiral to get the context
-  const result = renderSpiral(params);
-  if (!result || !result.engine || !result.engine.arcGroups) {
-    scrollContainer.innerHTML = '<div class="empty-state" style="padding: 2rem; color: var(--text-muted);">Failed to generate geometry</div>';
+  let layout;
+  try {
+    layout = await ensureAnimatorLayout();
+  } catch (_) {
+    showMessage('Failed to generate geometry');
     return;
   }
 
   // --- Preset loop preview mode: no CA frames, show phase-sweep animation ---
   if (!frames.length && params.add_fill_pattern) {
     // Pass a generous fixed hint; animations with a natural stepCount ignore it.
-    const presetFrames = generatePresetAnimationFrames(
-      result.engine.arcGroups,
-      { animationId: params.fill_pattern_animation, baseAngle: params.fill_pattern_angle },
-      60
-    );
-    if (!presetFrames.length) {
-      scrollContainer.innerHTML = '<div class="empty-state" style="padding: 2rem; color: var(--text-muted);">Add frames or enable fill pattern to see preview</div>';
+    const reply = await animatorClient.request('preset', {
+      animationId: params.fill_pattern_animation,
+      baseAngle: params.fill_pattern_angle,
+      numFrames: 60,
+    });
+    if (!reply.order.length) {
+      showMessage('Add frames or enable fill pattern to see preview');
       return;
     }
-    // Snapshot the id→name mapping from the original arcGroups before any re-render mutates them.
-    // Also collect all group names so we can force-OFF any group not covered by the frame map.
-    const idToName = new Map();
-    const allGroupNames = new Set();
-    for (const group of result.engine.arcGroups.values()) {
-      idToName.set(group.id, group.name);
-      allGroupNames.add(group.name);
-    }
+    scrollContainer.innerHTML = '';
     // Actual forward frame count: ping-pong has 2*fwd-2 total, so fwd = (total+2)/2
-    const totalFrames = presetFrames.length;
+    const totalFrames = reply.order.length;
     const totalFwd = Math.round((totalFrames + 2) / 2);
-    presetFrames.forEach((frameMap, idx) => {
+    reply.order.forEach((frameIdx, idx) => {
       const isReverse = idx >= totalFwd;
       const label = isReverse ? `Rev ${idx - totalFwd + 2}` : `Fwd ${idx + 1}`;
-      const item = document.createElement('div');
-      item.className = 'frame-preview-item';
-      item.innerHTML = `
-        <div class="frame-preview-header">${label}</div>
-        <div class="frame-preview-svg"></div>
-        <div class="frame-preview-info">Preset: ${params.fill_pattern_animation}</div>
-      `;
-      // Build name-keyed overrides. Start with all groups OFF, then apply the frame assignments.
-      // This ensures groups not in the frame map (e.g. outer ring) are suppressed too.
-      const frameOverrides = new Map();
-      for (const name of allGroupNames) {
-        frameOverrides.set(name, []);
-      }
-      for (const [id, name] of idToName) {
-        const assignment = frameMap.get(id);
-        if (assignment) frameOverrides.set(name, assignment.angles.slice(0, 2));
-      }
-      const fSvg = result.engine.render('arram_boyle', {
-        size: params.size,
-        addFillPattern: true,
-        fillPatternSpacing: params.fill_pattern_spacing,
-        fillPatternAngle: params.fill_pattern_angle,
-        fillPatternOffset: params.fill_pattern_offset,
-        fillPatternType: params.fill_pattern_type,
-        fillPatternRectWidth: params.fill_pattern_rect_width,
-        patternStrokeWidth: params.pattern_stroke_width,
-        drawGroupOutline: params.draw_group_outline,
-        highlightRimWidth: params.highlight_rim_width,
-        groupOutlineWidth: params.group_outline_width,
-        boundingBoxWidth: params.bounding_box_width_mm,
-        boundingBoxHeight: params.bounding_box_height_mm,
-        lengthUnits: 'mm',
-        useSymmetric: params.use_symmetric,
-        arcGroupAngleOverrides: frameOverrides,
-      });
-      if (fSvg?.svg) {
-        const clone = fSvg.svg.cloneNode(true);
-        clone.setAttribute('preserveAspectRatio', 'xMidYMid meet');
-        item.querySelector('.frame-preview-svg').appendChild(clone);
-      }
-      scrollContainer.appendChild(item);
+      const angles = reply.frames[frameIdx];
+      const svg = buildAnimatorSvg(
+        layout,
+        cell => (Number.isFinite(angles[cell]) ? FRAME_ON_STYLE : FRAME_OFF_STYLE),
+        drawHatchTicks(layout, angles),
+      );
+      appendFramePreview(scrollContainer, label, `Preset: ${params.fill_pattern_animation}`, svg);
     });
     return;
   }
 
   if (!frames.length) {
-    scrollContainer.innerHTML = '<div class="empty-state" style="padding: 2rem; color: var(--text-muted);">Add frames to see preview</div>';
+    showMessage('Add frames to see preview');
     return;
   }
 
-  const context = buildPatternAnimationContext(result.engine.arcGroups);
-
-  // Map context numeric IDs → stable group.name for renderFramePreviewSvg lookup
-  const idToGroupName = new Map(context.metaList.map(m => [m.id, m.group.name]));
-
-  // Build a set of valid IDs from this context
-  const validIds = new Set(context.metaList.map(m => m.id));
-
-  // Determine initial seeds - use selectedSeeds if they match this context, otherwise use center ring
-  const seedsForSimulation = new Set();
-  let usedSelectedSeeds = false;
-
-  if (selectedSeeds.size > 0) {
-    for (const id of selectedSeeds) {
-      if (validIds.has(id)) {
-        seedsForSimulation.add(id);
-        usedSelectedSeeds = true;
-      }
-    }
-  }
-
-  // Fall back to center ring if no valid seeds found
-  if (!usedSelectedSeeds || seedsForSimulation.size === 0) {
-    context.metaList
-      .filter(m => m.ringIndex === context.minRing)
-      .forEach(m => seedsForSimulation.add(m.id));
-  }
-
-  const forwardSnapshots = simulateCAIterations(context, frames, seedsForSimulation, 100);
+  // Unknown or stale seeds fall back to the centre ring in the worker
+  const reply = await animatorClient.request('snapshots', {
+    frames,
+    seeds: Array.from(selectedSeeds),
+    maxIterations: 100,
+  });
+  const forwardSnapshots = reply.snapshots;
+  scrollContainer.innerHTML = '';
 
   // Build full sequence: forward + reversed (for loop mode)
   let allSnapshots;
@@ -2453,41 +2872,16 @@ function renderFramePreviews() {
   const fwdLen = forwardSnapshots.length;
 
   // Render each iteration as a frame preview
-  allSnapshots.forEach((stateMap, iterationIndex) => {
-    const frameItem = document.createElement('div');
-    frameItem.className = 'frame-preview-item';
-
-    // Convert Map to Set of activated group names (for renderFramePreviewSvg key lookup)
-    const activatedIds = new Set();
-    for (const [id, isOn] of stateMap) {
-      if (isOn) {
-        const name = idToGroupName.get(id);
-        if (name) activatedIds.add(name);
-      }
-    }
-
-    const frameSvg = renderFramePreviewSvg(activatedIds, params);
-
+  allSnapshots.forEach((states, iterationIndex) => {
+    const activeCount = states.reduce((sum, on) => sum + on, 0);
     const isReverse = loopMode && iterationIndex >= fwdLen;
     const displayIdx = isReverse ? (allSnapshots.length - iterationIndex) : iterationIndex;
     const direction = isReverse ? '↩' : '';
     const ruleFrameIndex = iterationIndex > 0 ? ((iterationIndex - 1) % frames.length) + 1 : 0;
     const label = iterationIndex === 0 ? 'Initial' : `${direction}Iter ${displayIdx}`;
     const ruleInfo = iterationIndex === 0 ? 'Seeds' : `Rule ${ruleFrameIndex}`;
-
-    frameItem.innerHTML = `
-      <div class="frame-preview-header">${label}</div>
-      <div class="frame-preview-svg"></div>
-      <div class="frame-preview-info">${activatedIds.size} cells | ${ruleInfo}</div>
-    `;
-
-    if (frameSvg && frameSvg.svg) {
-      const svgClone = frameSvg.svg.cloneNode(true);
-      svgClone.setAttribute('preserveAspectRatio', 'xMidYMid meet');
-      frameItem.querySelector('.frame-preview-svg').appendChild(svgClone);
-    }
-
-    scrollContainer.appendChild(frameItem);
+    const svg = buildAnimatorSvg(layout, cell => (states[cell] ? FRAME_ON_STYLE : FRAME_OFF_STYLE));
+    appendFramePreview(scrollContainer, label, `${activeCount} cells | ${ruleInfo}`, svg);
   });
 }
 
@@ -274,3 +274,158 @@ export function generateBreakdownSVG(outlines, highlightPaths, scaleFactor, work
 
   return `<?xml version="1.0" encoding="UTF-8"?>\n<svg xmlns="http://www.w3.org/2000/svg" viewBox="0 0 ${workpieceWmm} ${workpieceHmm}" width="${workpieceWmm}mm" height="${workpieceHmm}mm">\n  ${svgContent}\n</svg>`;
 }
+
+/**
+ * Rotation of a group's piece relative to its ring template, in radians, with
+ * the template it was placed from. Symmetric clones report their master's
+ * template with the clone rotation added. Returns null when the group has no
+ * template (it can then only be congruent with itself).
+ *
+ * @param {object} group
+ * @returns {{template: object, radius: number, rotation: number}|null}
+ */
+export function pieceFrame(group) {
+  // A clone's outline is its master's, rotated; its own transform is not used.
+  if (group.cloneOf && group._rotationCache) {
+    const master = pieceFrame(group.cloneOf);
+    return master ? { ...master, rotation: master.rotation + group._rotationCache.angle } : null;
+  }
+  const transform = group.templateTransform;
+  if (group.template && transform) {
+    return {
+      template: group.template,
+      radius: transform.radius,
+      rotation: Math.atan2(transform.sin ?? 0, transform.cos ?? 1),
+    };
+  }
+  return null;
+}
+
+function normaliseDegrees(deg, period) {
+  return ((deg % period) + period) % period;
+}
+
+// True when `outline`, centred, is `reference` (centred) rotated by `delta`.
+// Compares up to 32 evenly spaced points; templates give identical counts.
+function outlinesCongruent(reference, outline, delta, tol) {
+  if (reference.length !== outline.length || !reference.length) return false;
+  const a = centreOutline(reference);
+  const b = centreOutline(outline);
+  const cos = Math.cos(delta);
+  const sin = Math.sin(delta);
+  const step = Math.max(1, Math.floor(a.length / 32));
+  for (let i = 0; i < a.length; i += step) {
+    const x = a[i].re * cos - a[i].im * sin;
+    const y = a[i].re * sin + a[i].im * cos;
+    if (Math.hypot(x - b[i].re, y - b[i].im) > tol) return false;
+  }
+  return true;
+}
+
+/**
+ * Sorts breakdown groups into congruent pieces: groups cut from the same
+ * ring template at the same size, with the same hatch angles relative to the
+ * piece, differ only by a rotation and can share one exported file. Each
+ * candidate match is confirmed against the representative's outline before
+ * it is merged.
+ *
+ * @param {Array<object>} groups - circle_* arc groups, in export order
+ * @param {Object} [options]
+ * @param {(group: object) => number[]} [options.patternAnglesOf] - world hatch angles (deg) a group is cut with
+ * @param {number} [options.tolerance=1e-6] - relative outline match tolerance
+ * @returns {Array<{representative: object, ringIndex: number, relativeAngles: number[],
+ *   members: Array<{group: object, rotationDeg: number}>}>} pieces in first-seen order;
+ *   rotationDeg turns the representative (counter-clockwise, about its centre) onto the member
+ */
+export function groupCongruentPieces(groups, { patternAnglesOf = () => [], tolerance = 1e-6 } = {}) {
+  const templateIds = new Map();
+  const buckets = new Map();
+  const pieces = [];
+  let unique = 0;
+
+  for (const group of groups) {
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 2) continue;
+    const frame = pieceFrame(group);
+    const rotationDeg = frame ? frame.rotation * (180 / Math.PI) : 0;
+    const step = group.patternAngleStep > 0 ? group.patternAngleStep : 0;
+    const relativeAngles = patternAnglesOf(group).map(angle => {
+      const rel = normaliseDegrees(angle - rotationDeg, 180);
+      return step ? normaliseDegrees(Math.round(rel / step) * step, 180) : rel;
+    });
+
+    let key;
+    if (frame) {
+      if (!templateIds.has(frame.template)) templateIds.set(frame.template, templateIds.size);
+      const angleKey = relativeAngles.map(a => a.toFixed(4)).sort().join(',');
+      key = `${templateIds.get(frame.template)}|${frame.radius.toFixed(6)}|${angleKey}`;
+    } else {
+      unique += 1;
+      key = `unique|${unique}`;
+    }
+
+    if (!buckets.has(key)) buckets.set(key, []);
+    const candidates = buckets.get(key);
+    const tol = tolerance * Math.max(Math.abs(frame?.radius ?? 1), 1e-9);
+    let piece = null;
+    for (const candidate of candidates) {
+      const delta = (rotationDeg - candidate.rotationDeg) * (Math.PI / 180);
+      if (outlinesCongruent(candidate.outline, outline, delta, tol)) {
+        piece = candidate;
+        break;
+      }
+    }
+    if (!piece) {
+      piece = {
+        representative: group,
+        ringIndex: group.ringIndex,
+        relativeAngles,
+        members: [],
+        outline,
+        rotationDeg,
+      };
+      candidates.push(piece);
+      pieces.push(piece);
+    }
+    piece.members.push({ group, rotationDeg: normaliseDegrees(rotationDeg - piece.rotationDeg, 360) });
+  }
+
+  return pieces.map(({ outline: _outline, rotationDeg: _rotationDeg, ...piece }) => piece);
+}
+
+/**
+ * CSV manifest for a breakdown zip: one row per physical piece with the file
+ * it is cut from, how often that file is used, and where the piece goes in
+ * the assembled spiral (rotation of the file's piece about its centre, then
+ * the centre position, in mm from the spiral centre).
+ *
+ * @param {Array<{file: string, ringIndex: number|null, members: Array<{group: object, rotationDeg: number}>|null}>} entries
+ * @param {number} scaleFactor
+ * @returns {string}
+ */
+export function buildBreakdownManifest(entries, scaleFactor) {
+  const rows = ['file,ring,quantity,group,rotation_deg,centre_x_mm,centre_y_mm'];
+  for (const { file, ringIndex, members } of entries) {
+    if (!members) {
+      // A combined plate is cut as drawn, already in place.
+      rows.push(`${file},${ringIndex ?? ''},1,,0.0000,0.0000,0.0000`);
+      continue;
+    }
+    for (const { group, rotationDeg } of members) {
+      const outline = group.getClosedOutline() || [];
+      const n = outline.length || 1;
+      const cx = outline.reduce((s, p) => s + p.re, 0) / n;
+      const cy = outline.reduce((s, p) => s + p.im, 0) / n;
+      rows.push([
+        file,
+        ringIndex ?? '',
+        members.length,
+        group.name ?? '',
+        rotationDeg.toFixed(4),
+        (cx * scaleFactor).toFixed(4),
+        (cy * scaleFactor).toFixed(4),
+      ].join(','));
+    }
+  }
+  return `${rows.join('\n')}\n`;
+}
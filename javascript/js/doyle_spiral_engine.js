@@ -14,7 +14,9 @@ const RING_TEMPLATE_CACHE = new Map();
 const MAX_ITERATIONS_PER_FAMILY = 10000; // Maximum iterations per spiral family to prevent infinite loops
 const EPSILON = 1e-9; // Small value to prevent division by zero
 const TOLERANCE = 1e-6; // General tolerance for floating point comparisons
-const INTERSECTION_TOLERANCE = 1e-3; // Tolerance for circle intersection detection
+const RELATIVE_TANGENCY_TOLERANCE = 1e-7; // Tangency tolerance as a fraction of the smaller radius
+const RELATIVE_MATCH_TOLERANCE = 1e-6; // Point matching/dedupe tolerance as a fraction of the local radius
+const ROUNDOFF_TOLERANCE = 64 * Number.EPSILON; // Rounding error allowance relative to coordinate magnitude
 
 // Arc rendering constants
 const ARC_SEGMENT_RATIO = 0.12; // Ratio of circle radius to desired segment length
@@ -23,9 +25,22 @@ const MAX_ARC_SEGMENT_LENGTH = 30; // Maximum segment length in pixels
 const MIN_ARC_STEPS = 10; // Minimum number of steps for arc rendering
 const MAX_ARC_STEPS = 44; // Maximum number of steps for arc rendering
 
+// Geometry payload precision. Intersections are always computed in float64;
+// these modes only affect how finished outlines are stored in toJSON().
+const GEOMETRY_PRECISIONS = ['float64', 'float32', 'fixed'];
+const FIXED_POINT_RANGE = 2 ** 30; // Fixed-point steps per group extent (fits Int32 with headroom)
+
 // Circle intersection constants
 const STANDARD_INTERSECTION_COUNT = 6; // Expected intersection count for hexagonal packing
 
+// Which end of a neighbour's arc to share, keyed by neighbour offset (see _extendGroupWithNeighbours)
+const NEIGHBOUR_ARC_PREFERENCE = new Map([
+  [-1, 'start'],
+  [-2, 'end'],
+  [-5, 'end'],
+  [-6, 'start'],
+]);
+
 // Default colors
 const DEFAULT_OUTLINE_COLOR = '#000000'; // Black outline for group boundaries
 
@@ -34,6 +49,8 @@ const MIN_P = 2; // Minimum value for p parameter
 const MAX_P = 256; // Maximum value for p parameter (practical limit)
 const MIN_Q = 2; // Minimum value for q parameter
 const MAX_Q = 256; // Maximum value for q parameter (practical limit)
+const MAX_STREAM_P = 1024; // Maximum p for ring-streamed rendering (renderStream)
+const MAX_STREAM_Q = 1024; // Maximum q for ring-streamed rendering (renderStream)
 const MIN_MAX_DISTANCE = 10; // Minimum max_d value
 const MAX_MAX_DISTANCE = 50000; // Maximum max_d value (practical limit)
 
@@ -311,37 +328,84 @@ function dedupeAngles(values, maxCount = 3) {
   return result;
 }
 
+/**
+ * Animation metadata for one group (outline centroid in polar form), or null
+ * for outer closure groups and degenerate outlines.
+ */
+function patternAnimationMeta(group) {
+  if (!group || (group.name && group.name.startsWith('outer_'))) {
+    return null;
+  }
+  const outline = group.getClosedOutline();
+  if (!outline || outline.length < 3) {
+    return null;
+  }
+  const polygon = outline.map(pt => ({ x: pt.re, y: pt.im }));
+  const centroid = polygonCentroid(polygon);
+  if (!Number.isFinite(centroid.x) || !Number.isFinite(centroid.y)) {
+    return null;
+  }
+  const ringIndex = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
+  return {
+    id: group.id,
+    group,
+    ringIndex,
+    centroid,
+    radius: Math.hypot(centroid.x, centroid.y),
+    theta: Math.atan2(centroid.y, centroid.x),
+    neighbors: new Set(),
+  };
+}
+
+/**
+ * Animation metadata for one arcgroups entry of a toJSON() payload (plain or
+ * packed outlines). The entry stands in for the group, so contexts built from
+ * a worker's geometry drive the same generators as the engine's own groups.
+ */
+function patternAnimationMetaFromEntry(entry) {
+  const points = decodeOutline(entry);
+  if (points.length < 3) {
+    return null;
+  }
+  const centroid = polygonCentroid(points.map(([x, y]) => ({ x, y })));
+  if (!Number.isFinite(centroid.x) || !Number.isFinite(centroid.y)) {
+    return null;
+  }
+  const ringIndex = Number.isFinite(entry.ring_index) ? entry.ring_index : 0;
+  return {
+    id: entry.id,
+    group: { id: entry.id, name: entry.name, ringIndex },
+    ringIndex,
+    centroid,
+    radius: Math.hypot(centroid.x, centroid.y),
+    theta: Math.atan2(centroid.y, centroid.x),
+    neighbors: new Set(),
+  };
+}
+
 function buildPatternAnimationContext(arcGroups) {
+  return linkPatternAnimationContext(Array.from(arcGroups.values(), patternAnimationMeta));
+}
+
+/**
+ * Builds the pattern animation context from a toJSON() geometry payload, with
+ * metaList in the order of geometry.arcgroups.
+ */
+function buildPatternAnimationContextFromGeometry(geometry) {
+  return linkPatternAnimationContext((geometry?.arcgroups || []).map(patternAnimationMetaFromEntry));
+}
+
+function linkPatternAnimationContext(metas) {
   const metaList = [];
   const ringMap = new Map();
   let minRing = Infinity;
   let maxRing = -Infinity;
 
-  for (const group of arcGroups.values()) {
-    if (!group || (group.name && group.name.startsWith('outer_'))) {
-      continue;
-    }
-    const outline = group.getClosedOutline();
-    if (!outline || outline.length < 3) {
-      continue;
-    }
-    const polygon = outline.map(pt => ({ x: pt.re, y: pt.im }));
-    const centroid = polygonCentroid(polygon);
-    if (!Number.isFinite(centroid.x) || !Number.isFinite(centroid.y)) {
+  for (const meta of metas) {
+    if (!meta) {
       continue;
     }
-    const ringIndex = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
-    const radius = Math.hypot(centroid.x, centroid.y);
-    const theta = Math.atan2(centroid.y, centroid.x);
-    const meta = {
-      id: group.id,
-      group,
-      ringIndex,
-      centroid,
-      radius,
-      theta,
-      neighbors: new Set(),
-    };
+    const { ringIndex } = meta;
     metaList.push(meta);
     if (!ringMap.has(ringIndex)) {
       ringMap.set(ringIndex, []);
@@ -394,14 +458,22 @@ function buildPatternAnimationContext(arcGroups) {
   return { metaList, ringMap, sortedRings, minRing, maxRing };
 }
 
+// Angular distances closer than this count as a tie and keep ring order, so
+// centroids decoded from float32 outlines link neighbours in the same order.
+const NEIGHBOUR_TIE_TOLERANCE_RAD = 1e-6;
+
 function linkRingNeighbors(source, target, maxConnections = 2) {
   if (!source || !target || !source.length || !target.length) {
     return;
   }
   for (const meta of source) {
+    const distance = new Map(target.map(other => [other, angularDistanceRad(meta.theta, other.theta)]));
     const sorted = target
       .slice()
-      .sort((a, b) => angularDistanceRad(meta.theta, a.theta) - angularDistanceRad(meta.theta, b.theta));
+      .sort((a, b) => {
+        const diff = distance.get(a) - distance.get(b);
+        return Math.abs(diff) <= NEIGHBOUR_TIE_TOLERANCE_RAD ? 0 : diff;
+      });
     const limit = Math.min(maxConnections, sorted.length);
     for (let idx = 0; idx < limit; idx += 1) {
       const neighbor = sorted[idx];
@@ -491,7 +563,9 @@ function patternAnimationRadialBloom(context, opts = {}) {
   const assignments = new Map();
   const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
   const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
-  const maxRadius = context.metaList.reduce((acc, meta) => Math.max(acc, meta.radius), 0) || 1;
+  // A ring-streamed render passes the spiral-wide maximum in with a single-ring context.
+  const maxRadius = context.maxRadius
+    ?? (context.metaList.reduce((acc, meta) => Math.max(acc, meta.radius), 0) || 1);
   context.metaList.forEach(meta => {
     const radiusRatio = meta.radius / maxRadius;
     const wobble = Math.sin(normaliseAngleRad(meta.theta) * 3) * 5;
@@ -693,15 +767,17 @@ function zigzagSnakeStepCount(context) {
   return bands.length > 0 ? bands.length : 1;
 }
 
+// `ringLocal` presets only look at one ring at a time (plus context.maxRadius),
+// so a ring-streamed render can evaluate them without the whole spiral.
 const PATTERN_ANIMATION_DEFINITIONS = {
-  radial_bloom: { label: 'Radial bloom', generator: patternAnimationRadialBloom },
-  ring_cycle: { label: 'Ring cycle chase', generator: patternAnimationRingCycle },
-  ring_pingpong: { label: 'Alternating ring sweep', generator: patternAnimationRingPingPong },
+  radial_bloom: { label: 'Radial bloom', generator: patternAnimationRadialBloom, ringLocal: true },
+  ring_cycle: { label: 'Ring cycle chase', generator: patternAnimationRingCycle, ringLocal: true },
+  ring_pingpong: { label: 'Alternating ring sweep', generator: patternAnimationRingPingPong, ringLocal: true },
   ca_wavefront: { label: 'Cellular wavefront', generator: patternAnimationCAWavefront },
-  spiral_vortex: { label: 'Spiral vortex', generator: patternAnimationSpiralVortex },
-  diamond_pulse: { label: 'Diamond pulse', generator: patternAnimationDiamondPulse },
+  spiral_vortex: { label: 'Spiral vortex', generator: patternAnimationSpiralVortex, ringLocal: true },
+  diamond_pulse: { label: 'Diamond pulse', generator: patternAnimationDiamondPulse, ringLocal: true },
   fibonacci_spiral: { label: 'Fibonacci spiral', generator: patternAnimationFibonacciSpiral },
-  spiral_arm_sweep: { label: 'Spiral arm sweep', generator: patternAnimationSpiralArmSweep },
+  spiral_arm_sweep: { label: 'Spiral arm sweep', generator: patternAnimationSpiralArmSweep, ringLocal: true },
   zigzag_snake: { label: 'Zigzag snake', generator: patternAnimationZigzagSnake, stepCount: zigzagSnakeStepCount },
 };
 
@@ -719,8 +795,12 @@ function applyPatternAnimationToGroups(arcGroups, { animationId, baseAngle, loop
   if (!arcGroups || typeof arcGroups.values !== 'function') {
     return new Map();
   }
-  const resolvedId = normalisePatternAnimationId(animationId);
   const context = buildPatternAnimationContext(arcGroups);
+  return resolvePatternAssignments(context, { animationId, baseAngle, loopMode, phaseOffset });
+}
+
+function resolvePatternAssignments(context, { animationId, baseAngle, loopMode = false, phaseOffset = 0 } = {}) {
+  const resolvedId = normalisePatternAnimationId(animationId);
   const baseAngleValue = Number.isFinite(baseAngle) ? baseAngle : 0;
   const generator = PATTERN_ANIMATION_DEFINITIONS[resolvedId]?.generator
     || PATTERN_ANIMATION_DEFINITIONS[DEFAULT_PATTERN_ANIMATION].generator;
@@ -754,13 +834,20 @@ function applyPatternAnimationToGroups(arcGroups, { animationId, baseAngle, loop
 
 /**
  * Generates a sequence of per-group angle assignment maps for animating a preset
- * through a full forward + reverse (ping-pong) loop.
+ * through a full forward + reverse (ping-pong) loop. `source` is an arcGroups
+ * map or an already built pattern animation context.
  * Returns Array<Map<id, {primaryAngle, angles}>> with 2*numFrames-2 entries.
  */
-function generatePresetAnimationFrames(arcGroups, { animationId, baseAngle } = {}, numFrames = 20) {
-  if (!arcGroups || typeof arcGroups.values !== 'function') return [];
+function generatePresetAnimationFrames(source, { animationId, baseAngle } = {}, numFrames = 20) {
+  let context;
+  if (Array.isArray(source?.metaList)) {
+    context = source;
+  } else if (source && typeof source.values === 'function') {
+    context = buildPatternAnimationContext(source);
+  } else {
+    return [];
+  }
   const resolvedId = normalisePatternAnimationId(animationId);
-  const context = buildPatternAnimationContext(arcGroups);
   const baseAngleValue = Number.isFinite(baseAngle) ? baseAngle : 0;
   const def = PATTERN_ANIMATION_DEFINITIONS[resolvedId]
     || PATTERN_ANIMATION_DEFINITIONS[DEFAULT_PATTERN_ANIMATION];
@@ -1133,83 +1220,375 @@ function linesInPolygon(polygonPoints, spacing, angleDeg, offset = 0) {
   return segments;
 }
 
+// ------------------------------------------------------------
+// Fill kernels
+// ------------------------------------------------------------
+
+// Distance from `centre` to the nearest polygon edge.
+function polygonInradius(polygon, centre) {
+  let best = Infinity;
+  for (let i = 0; i < polygon.length; i += 1) {
+    const a = polygon[i];
+    const b = polygon[(i + 1) % polygon.length];
+    const dx = b.x - a.x;
+    const dy = b.y - a.y;
+    const lenSq = dx * dx + dy * dy;
+    const t = lenSq > 0 ? clamp(((centre.x - a.x) * dx + (centre.y - a.y) * dy) / lenSq, 0, 1) : 0;
+    best = Math.min(best, Math.hypot(a.x + dx * t - centre.x, a.y + dy * t - centre.y));
+  }
+  return best;
+}
+
+// Splits a sampled curve into the runs that lie inside `polygon`.
+function clipPolylineToPolygon(points, polygon) {
+  const runs = [];
+  let run = [];
+  for (const point of points) {
+    if (polygonContains(point, polygon)) {
+      run.push(point);
+    } else if (run.length) {
+      if (run.length > 1) runs.push(run);
+      run = [];
+    }
+  }
+  if (run.length > 1) runs.push(run);
+  return runs;
+}
+
+function concentricRings(polygon, spacing, _angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  const inradius = polygonInradius(working, centre);
+  if (!(inradius > 1e-9)) {
+    return [];
+  }
+  // Rings are scaled copies about the centroid, `spacing` apart where the
+  // outline is closest to it; the outline itself is left to the stroke.
+  const rings = [];
+  for (let k = 1; k * spacing < inradius; k += 1) {
+    const scale = 1 - (k * spacing) / inradius;
+    const ring = working.map(point => ({
+      x: centre.x + (point.x - centre.x) * scale,
+      y: centre.y + (point.y - centre.y) * scale,
+    }));
+    ring.push(ring[0]);
+    rings.push(ring);
+  }
+  return rings;
+}
+
+function spiralFill(polygon, spacing, angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  let reach = 0;
+  for (const point of working) {
+    reach = Math.max(reach, Math.hypot(point.x - centre.x, point.y - centre.y));
+  }
+  // Archimedean spiral, `spacing` between turns, started at the hatch angle
+  // and sampled at chords of about a quarter spacing.
+  const phase = degToRad(angleDeg);
+  const points = [{ x: centre.x, y: centre.y }];
+  const growth = spacing / (2 * Math.PI);
+  for (let theta = 0; growth * theta <= reach;) {
+    const radius = growth * theta;
+    theta += Math.min(0.5, (spacing / 4) / Math.max(radius, spacing));
+    const r = growth * theta;
+    points.push({ x: centre.x + r * Math.cos(theta + phase), y: centre.y + r * Math.sin(theta + phase) });
+  }
+  return clipPolylineToPolygon(points, working);
+}
+
+function stippleDashes(polygon, spacing, angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  const cos = Math.cos(degToRad(angleDeg));
+  const sin = Math.sin(degToRad(angleDeg));
+  let reach = 0;
+  for (const point of working) {
+    reach = Math.max(reach, Math.hypot(point.x - centre.x, point.y - centre.y));
+  }
+  // Hexagonal grid of short dashes along the hatch angle; a dash cuts as a
+  // dot with any real tool, and keeps the exporters on plain segments.
+  const rowStep = spacing * Math.sqrt(3) / 2;
+  const half = spacing * 0.1;
+  const rows = Math.ceil(reach / rowStep);
+  const cols = Math.ceil(reach / spacing) + 1;
+  const dashes = [];
+  for (let j = -rows; j <= rows; j += 1) {
+    const v = j * rowStep;
+    const shift = (j & 1) ? spacing / 2 : 0;
+    for (let i = -cols; i <= cols; i += 1) {
+      const u = i * spacing + shift;
+      const x = centre.x + u * cos - v * sin;
+      const y = centre.y + u * sin + v * cos;
+      const start = { x: x - half * cos, y: y - half * sin };
+      const end = { x: x + half * cos, y: y + half * sin };
+      if (polygonContains(start, working) && polygonContains(end, working)) {
+        dashes.push([start, end]);
+      }
+    }
+  }
+  return dashes;
+}
+
+/**
+ * Fill kernels by pattern type. `build(polygon, spacing, angleDeg, offset)`
+ * returns polylines (arrays of {x, y}; plain hatch lines are two-point
+ * polylines) in the polygon's own space, so ArcGroup builds each kernel once
+ * per ring template and maps the result to every group of the ring.
+ *
+ * - `usesAngle`: false when the fill looks the same at every angle, so one
+ *   template entry serves all of them.
+ * - `svg`: how drawGroupOutline() writes it: 'lines' (one <line> each),
+ *   'rectangles' (an outlined bar around each line) or 'path' (one batched
+ *   <path> per group and angle).
+ * - `previewAngles(angle)`: angles of the <pattern> fills that stand in for
+ *   the kernel in preview renders, or null to draw it explicitly.
+ */
+const FILL_KERNELS = {
+  lines: {
+    usesAngle: true,
+    svg: 'lines',
+    build: linesInPolygon,
+    previewAngles: angle => [angle],
+  },
+  rectangles: {
+    usesAngle: true,
+    svg: 'rectangles',
+    build: linesInPolygon,
+    previewAngles: null,
+  },
+  crosshatch: {
+    usesAngle: true,
+    svg: 'path',
+    build: (polygon, spacing, angleDeg, offset) => [
+      ...linesInPolygon(polygon, spacing, angleDeg, offset),
+      ...linesInPolygon(polygon, spacing, angleDeg + 90, offset),
+    ],
+    previewAngles: angle => [angle, angle + 90],
+  },
+  concentric: {
+    usesAngle: false,
+    svg: 'path',
+    build: concentricRings,
+    previewAngles: null,
+  },
+  spiral: {
+    usesAngle: true,
+    svg: 'path',
+    build: spiralFill,
+    previewAngles: null,
+  },
+  stipple: {
+    usesAngle: true,
+    svg: 'path',
+    build: stippleDashes,
+    previewAngles: null,
+  },
+};
+
+const FILL_PATTERN_TYPES = Object.keys(FILL_KERNELS);
+
+function fillKernel(patternType) {
+  return FILL_KERNELS[patternType] || FILL_KERNELS.lines;
+}
+
+/**
+ * Fill polylines for a polygon given directly in drawing space (groups
+ * without a ring template, tile renders).
+ */
+function fillPatternPolylines(patternType, polygon, spacing, angleDeg, offset = 0) {
+  return fillKernel(patternType).build(polygon, spacing, angleDeg, offset);
+}
+
 // ------------------------------------------------------------
 // Geometry primitives
 // ------------------------------------------------------------
 
+// Counters for geometric fallback paths. Reset by renderSpiral for every render
+// and exposed through getGeometryStats() so slow-path regressions are visible.
+// The outline counters describe the emitted groups, counted once each by
+// renderSpiral, not every outline pass (masters and rebuilds are not counted).
+const GEOMETRY_STATS = {
+  tangencySnaps: 0, // pairs within tolerance of tangency, emitted as a single contact point
+  duplicateIntersections: 0, // intersections dropped because an equal point was already recorded
+  proximityAttachments: 0, // arcs of emitted groups joined by getClosedOutline's nearest-endpoint fallback
+  openOutlines: 0, // emitted groups whose outline end did not meet its start
+  hatchComputed: 0, // hatch sets generated with linesInPolygon for a ring template
+  hatchReused: 0, // hatch sets served from a ring template's cache
+  hatchAngleError: 0, // largest hatch angle change from quantisation, in degrees
+  hatchRimDeviation: 0, // largest hatch line end displacement from quantisation, in geometry units
+  hatchRimDeviationMm: 0, // hatchRimDeviation in drawing units (mm), filled in by renderSpiral
+  arcsMaterialized: 0, // arcs whose point arrays were built (the rest stayed descriptors)
+};
+
+function resetGeometryStats() {
+  for (const key of Object.keys(GEOMETRY_STATS)) {
+    GEOMETRY_STATS[key] = 0;
+  }
+}
+
+function getGeometryStats() {
+  return { ...GEOMETRY_STATS };
+}
+
+function countOutlineJoins(arcGroups) {
+  for (const [key, group] of arcGroups.entries()) {
+    if (key.startsWith('outer_')) {
+      continue;
+    }
+    group.getClosedOutline();
+    const joins = group.outlineJoins;
+    if (!joins) {
+      continue;
+    }
+    GEOMETRY_STATS.proximityAttachments += joins.proximityAttachments;
+    if (joins.open) {
+      GEOMETRY_STATS.openOutlines += 1;
+    }
+  }
+}
+
+/**
+ * Tolerance used to classify the relative position of two circles. It scales
+ * with the smaller radius so tiny centre circles are not swallowed by an
+ * absolute epsilon, and never drops below the rounding error of the inputs.
+ *
+ * The intersection code relies on such tolerances, not on exact or adaptive
+ * predicates. Packed circles touch only up to rounding, so an exact sign of
+ * the gap would call every contact either a crossing or a miss.
+ */
+function tangencyTolerance(x1, y1, r1, x2, y2, r2) {
+  const magnitude = Math.abs(x1) + Math.abs(y1) + Math.abs(x2) + Math.abs(y2) + r1 + r2;
+  return Math.max(RELATIVE_TANGENCY_TOLERANCE * Math.min(r1, r2), ROUNDOFF_TOLERANCE * magnitude);
+}
+
+/**
+ * Intersection points of two circles.
+ *
+ * Tangency is decided on the signed gap between the circles rather than on the
+ * chord half-length, and for crossing pairs a and h are evaluated in factored
+ * form to avoid the cancellation in r1² - r2² and r1² - a² when the radii
+ * differ by orders of magnitude. Tangent pairs yield exactly one point.
+ */
+function circleIntersection(x1, y1, r1, x2, y2, r2) {
+  const dx = x2 - x1;
+  const dy = y2 - y1;
+  const d = Math.sqrt(dx * dx + dy * dy);
+  const eps = tangencyTolerance(x1, y1, r1, x2, y2, r2);
+  if (d <= eps) {
+    return [];
+  }
+  const outerGap = d - (r1 + r2);
+  const innerGap = Math.abs(r1 - r2) - d;
+  if (outerGap > eps || innerGap > eps) {
+    return [];
+  }
+  if (outerGap >= -eps || innerGap >= -eps) {
+    GEOMETRY_STATS.tangencySnaps += 1;
+    return [tangentContact(x1, y1, r1, r2, dx, dy)];
+  }
+  const ux = dx / d;
+  const uy = dy / d;
+  const a = ((r1 - r2) * (r1 + r2) + d * d) / (2 * d);
+  const h = Math.sqrt(Math.max((r1 - a) * (r1 + a), 0));
+  const midX = x1 + ux * a;
+  const midY = y1 + uy * a;
+  return [
+    { re: midX - uy * h, im: midY + ux * h },
+    { re: midX + uy * h, im: midY - ux * h },
+  ];
+}
+
+/**
+ * Contact point of a tangent pair, evaluated exactly as the original
+ * intersection formula did: the foot of the chord plus the roundoff-sized
+ * half-chord to the left of the centre line (at most sqrt(2·r·gap) off it).
+ *
+ * That offset is noise, but it is what picks the start contact of a circle:
+ * its two contacts nearest the spiral centre are often at the same distance,
+ * and finalizeIntersections() takes the nearer one. Putting the contact on
+ * the centre line turns that into a roundoff tie and rotates the arc selection
+ * of a third of the circles in every non-closest arc mode, so the classic
+ * placement is kept and the designs stay the same as before.
+ */
+function tangentContact(x1, y1, r1, r2, dx, dy) {
+  const dSq = dx * dx + dy * dy;
+  const d = Math.sqrt(dSq);
+  const a = (r1 * r1 - r2 * r2 + dSq) / (2 * d);
+  const h = Math.sqrt(Math.max(r1 * r1 - a * a, 0));
+  const ratio = a / d;
+  const ux = dx / d;
+  const uy = dy / d;
+  return { re: x1 + dx * ratio - uy * h, im: y1 + dy * ratio + ux * h };
+}
+
 let CIRCLE_ID = 0;
 
 class CircleElement {
-  constructor(center, radius, visible = true) {
+  // `id` is unique across engines; `seed` is the circle's place in its own
+  // spiral and drives everything that should look the same on every render
+  // (random arc selection, debug colours).
+  constructor(center, radius, visible = true, id = null, seed = null) {
     this.center = complexFrom(center);
     this.radius = radius;
     this.visible = visible;
-    this.id = ++CIRCLE_ID;
+    this.id = id ?? ++CIRCLE_ID;
+    this.seed = seed ?? this.id;
     this.intersections = [];
     this.neighbours = new Set();
-    this._intersectionKeys = null;
+    this._collectingIntersections = false;
     this._orderedNeighbours = null;
   }
 
-  _getIntersectionPoints(other, tol = 1e-6) {
-    const x1 = this.center.re;
-    const y1 = this.center.im;
-    const x2 = other.center.re;
-    const y2 = other.center.im;
-    const dx = x2 - x1;
-    const dy = y2 - y1;
-    const dSq = dx * dx + dy * dy;
-    const d = Math.sqrt(dSq);
-    const r1 = this.radius;
-    const r2 = other.radius;
-    if (d > r1 + r2 + tol || d < Math.abs(r1 - r2) - tol || d < tol) {
-      return [];
-    }
-    const a = (r1 * r1 - r2 * r2 + dSq) / (2 * d);
-    const hSq = r1 * r1 - a * a;
-    if (hSq < -tol) {
-      return [];
-    }
-    const h = Math.sqrt(Math.max(hSq, 0));
-    const ratio = a / d;
-    const midX = x1 + dx * ratio;
-    const midY = y1 + dy * ratio;
-    const invD = d === 0 ? 0 : 1 / d;
-    const ux = dx * invD;
-    const uy = dy * invD;
-    const perpX = -uy;
-    const perpY = ux;
-    const p1 = { re: midX + perpX * h, im: midY + perpY * h };
-    if (h < tol) {
-      return [p1];
-    }
-    const p2 = { re: midX - perpX * h, im: midY - perpY * h };
-    return [p1, p2];
+  _getIntersectionPoints(other) {
+    return circleIntersection(
+      this.center.re,
+      this.center.im,
+      this.radius,
+      other.center.re,
+      other.center.im,
+      other.radius,
+    );
   }
 
   resetIntersections() {
     this.intersections = [];
     this.neighbours.clear();
-    this._intersectionKeys = new Set();
+    this._collectingIntersections = true;
     this._orderedNeighbours = null;
   }
 
   addIntersection(point, other) {
-    if (!point || !other || !this._intersectionKeys) {
+    if (!point || !other || !this._collectingIntersections) {
       return;
     }
-    const key = `${point.re.toFixed(6)}_${point.im.toFixed(6)}`;
-    if (this._intersectionKeys.has(key)) {
-      return;
+    // Intersections per circle are few, so compare distances directly instead of
+    // rounding to a fixed decimal grid (which both splits near-equal points
+    // straddling a grid line and merges distinct points on tiny circles).
+    const tol = RELATIVE_MATCH_TOLERANCE * this.radius;
+    for (const [existing] of this.intersections) {
+      if (Math.abs(existing.re - point.re) <= tol && Math.abs(existing.im - point.im) <= tol) {
+        GEOMETRY_STATS.duplicateIntersections += 1;
+        return;
+      }
     }
-    this._intersectionKeys.add(key);
     this.intersections.push([point, other]);
     this.neighbours.add(other);
   }
 
   finalizeIntersections(startReference = Complex.ZERO) {
     if (!this.intersections.length) {
-      this._intersectionKeys = null;
+      this._collectingIntersections = false;
       return;
     }
 
@@ -1238,17 +1617,17 @@ class CircleElement {
       return clockwiseOffset(angA) - clockwiseOffset(angB);
     });
 
-    this._intersectionKeys = null;
+    this._collectingIntersections = false;
   }
 
-  computeIntersections(circles, startReference = Complex.ZERO, tol = 1e-3) {
+  computeIntersections(circles, startReference = Complex.ZERO) {
     this.resetIntersections();
 
     for (const other of circles) {
       if (other === this) {
         continue;
       }
-      const pts = this._getIntersectionPoints(other, tol);
+      const pts = this._getIntersectionPoints(other);
       for (const pt of pts) {
         this.addIntersection(pt, other);
       }
@@ -1313,13 +1692,11 @@ class CircleElement {
 class ArcElement {
   static _shapeCache = new Map();
 
-  static _shapeKey(steps, delta) {
-    const quantised = Math.round(delta * 1e9) / 1e9;
-    return `${steps}|${quantised}`;
-  }
-
+  // Keyed on the exact sweep: a rounded key would hand an arc whichever
+  // nearby sweep was sampled first, so its points would depend on the order
+  // arcs (and earlier renders) were built in.
   static _getShape(steps, delta) {
-    const key = ArcElement._shapeKey(steps, delta);
+    const key = `${steps}|${delta}`;
     if (ArcElement._shapeCache.has(key)) {
       return ArcElement._shapeCache.get(key);
     }
@@ -1340,18 +1717,31 @@ class ArcElement {
     return coords;
   }
 
-  constructor(circle, start, end, steps = 40, visible = true) {
+  // Arcs are descriptors: the step count and the sampled points are computed
+  // on first use. Most groups take their outline and hatch from the ring
+  // template, so the points of their arcs are never read.
+  constructor(circle, start, end, steps = null, visible = true) {
     this.circle = circle;
     this.start = complexFrom(start);
     this.end = complexFrom(end);
-    this.steps = Math.max(1, steps | 0);
+    this._steps = steps === null ? null : Math.max(1, steps | 0);
     this.visible = visible;
     this._pointsCache = null;
-    this._template = null;
+    this._pointsSource = null; // template transform the cached points were built from
+    this.owner = null; // ArcGroup that lists this arc; set by ArcGroup.addArc
+    this.ownerIndex = -1;
+  }
+
+  get steps() {
+    if (this._steps === null) {
+      this._steps = estimateArcSteps(this.circle, this.start, this.end);
+    }
+    return this._steps;
   }
 
   _invalidate() {
     this._pointsCache = null;
+    this._pointsSource = null;
   }
 
   setStart(value) {
@@ -1372,52 +1762,41 @@ class ArcElement {
 
   setSteps(value) {
     const newValue = Math.max(1, value | 0);
-    if (this.steps !== newValue) {
-      this.steps = newValue;
-      this._invalidate();
-    }
-  }
-
-  applyTemplate(template, transform, arcIndex, { preserveCache = false } = {}) {
-    if (!template || !transform || typeof arcIndex !== 'number') {
-      this._template = null;
-      if (!preserveCache) {
-        this._invalidate();
-      }
-      return;
-    }
-    this._template = { template, transform, arcIndex };
-    if (!preserveCache) {
+    if (this._steps !== newValue) {
+      this._steps = newValue;
       this._invalidate();
     }
   }
 
   getPoints() {
-    if (this._pointsCache) {
+    // Points follow the owner's ring template when it has one, so assigning a
+    // template to a group needs no per-arc work; the cache is rebuilt when the
+    // transform it came from changes.
+    const owner = this.owner;
+    const transform = owner?.template ? owner.templateTransform : null;
+    const bases = transform ? owner.template.normalizedArcs?.[this.ownerIndex] : null;
+    const source = bases ? transform : null;
+    if (this._pointsCache && this._pointsSource === source) {
       return this._pointsCache;
     }
-    if (this._template) {
-      const { template, transform, arcIndex } = this._template;
-      const bases = template?.normalizedArcs?.[arcIndex];
-      if (!bases || !transform) {
-        this._template = null;
-      } else {
-        const { cos, sin, radius, center } = transform;
-        const total = bases.length / 2;
-        const points = new Array(total);
-        for (let idx = 0; idx < bases.length; idx += 2) {
-          const x = bases[idx];
-          const y = bases[idx + 1];
-          const rx = x * cos - y * sin;
-          const ry = x * sin + y * cos;
-          points[idx / 2] = {
-            re: center.re + rx * radius,
-            im: center.im + ry * radius,
-          };
-        }
-        this._pointsCache = points;
-        return points;
+    GEOMETRY_STATS.arcsMaterialized += 1;
+    this._pointsSource = source;
+    if (bases) {
+      const { cos, sin, radius, center } = transform;
+      const total = bases.length / 2;
+      const points = new Array(total);
+      for (let idx = 0; idx < bases.length; idx += 2) {
+        const x = bases[idx];
+        const y = bases[idx + 1];
+        const rx = x * cos - y * sin;
+        const ry = x * sin + y * cos;
+        points[idx / 2] = {
+          re: center.re + rx * radius,
+          im: center.im + ry * radius,
+        };
       }
+      this._pointsCache = points;
+      return points;
     }
     const c = this.circle.center;
     const r = this.circle.radius;
@@ -1446,6 +1825,64 @@ class ArcElement {
   }
 }
 
+/**
+ * Largest distance from a ring template's outline to the point hatch lines are
+ * anchored at, in template units. Rotating a hatch set by a small angle moves
+ * line ends by at most this times the sine of the angle.
+ */
+function templateRimRadius(template) {
+  if (template.rimRadius === undefined) {
+    const outline = template.normalizedOutline || [];
+    const points = [];
+    for (let idx = 0; idx + 1 < outline.length; idx += 2) {
+      points.push({ x: outline[idx], y: outline[idx + 1] });
+    }
+    const centre = polygonCentroid(points);
+    let radius = 0;
+    for (const point of points) {
+      radius = Math.max(radius, Math.hypot(point.x - centre.x, point.y - centre.y));
+    }
+    template.rimRadius = radius;
+  }
+  return template.rimRadius;
+}
+
+/**
+ * Map a pattern source (normalised template polylines plus a group
+ * transform) to world space one segment at a time, calling
+ * `visit(x1, y1, x2, y2)`. Consecutive segments of a polyline share their
+ * end points exactly. Degenerate and non-finite segments are skipped.
+ * Returns the number visited.
+ */
+function forEachSourceSegment(source, visit) {
+  const { segments } = source;
+  const { cos, sin, radius, center } = source.transform;
+  let count = 0;
+  for (let idx = 0; idx < segments.length; idx += 1) {
+    const polyline = segments[idx];
+    let x1 = 0;
+    let y1 = 0;
+    for (let k = 0; k < polyline.length; k += 1) {
+      const px = polyline[k].x * radius;
+      const py = polyline[k].y * radius;
+      const x2 = center.re + px * cos - py * sin;
+      const y2 = center.im + px * sin + py * cos;
+      if (k > 0) {
+        const dx = x2 - x1;
+        const dy = y2 - y1;
+        if (!Number.isFinite(dx) || !Number.isFinite(dy) || dx * dx + dy * dy <= 1e-12) {
+          continue;
+        }
+        visit(x1, y1, x2, y2);
+        count += 1;
+      }
+      x1 = x2;
+      y1 = y2;
+    }
+  }
+  return count;
+}
+
 class ArcGroup {
   static _idCounter = 0;
 
@@ -1459,7 +1896,7 @@ class ArcGroup {
     this.ringIndex = null;
     this.baseCircle = null;
     this._outlineCache = null;
-    this._patternSegmentsCache = new Map();
+    this.outlineJoins = null; // How the cached outline was joined: { proximityAttachments, open }
     this.template = null;
     this.templateTransform = null;
     this.patternAngles = [];
@@ -1467,14 +1904,15 @@ class ArcGroup {
     this.cloneOf = null; // Reference to master group for symmetric optimization
     this._rotationCache = null; // Cache for rotation parameters (cos, sin, angle)
     this.outerArc = null; // Arc from the invisible outer circle that closes the outer edge
+    this.patternAngleStep = 0; // Quantisation step for hatch angles relative to the template (0 = exact)
+    this.fillKernel = 'lines'; // Fill pattern type (a FILL_KERNELS key) exporters read hatches with
   }
 
   addArc(arc) {
+    arc.owner = this;
+    arc.ownerIndex = this.arcs.length;
     this.arcs.push(arc);
     this._outlineCache = null;
-    if (this._patternSegmentsCache) {
-      this._patternSegmentsCache.clear();
-    }
   }
 
   extend(arcs) {
@@ -1492,9 +1930,6 @@ class ArcGroup {
     this.templateTransform = transform || null;
     if (!preserveCache) {
       this._outlineCache = null;
-      if (this._patternSegmentsCache) {
-        this._patternSegmentsCache.clear();
-      }
     }
   }
 
@@ -1561,7 +1996,13 @@ class ArcGroup {
     return ordered.concat(reversed.slice(1));
   }
 
-  getClosedOutline(tol = INTERSECTION_TOLERANCE) {
+  /**
+   * Returns the group outline as a closed list of points. Arc endpoints are
+   * joined when they agree to within `tol`, which defaults to a small fraction
+   * of the group's circle radius so matching behaves the same for the tiny
+   * centre circles and the large rim circles.
+   */
+  getClosedOutline(tol = null) {
     if (this._outlineCache) {
       return this._outlineCache.slice();
     }
@@ -1596,6 +2037,7 @@ class ArcGroup {
         }
 
         this._outlineCache = rotatedOutline.slice();
+        this.outlineJoins = this.cloneOf.outlineJoins;
         return rotatedOutline.slice();
       }
     }
@@ -1622,11 +2064,16 @@ class ArcGroup {
         points.push({ re: center.re + rx * radius, im: center.im + ry * radius });
       }
       this._outlineCache = points.slice();
+      this.outlineJoins = this.template.outlineJoins || null;
       return points.slice();
     }
     if (!this.arcs.length) {
       return [];
     }
+    if (tol === null) {
+      const radius = this.baseCircle?.radius || this.arcs[0].circle?.radius || 1;
+      tol = RELATIVE_MATCH_TOLERANCE * radius;
+    }
     const entries = this.arcs.map(arc => ({ arc, points: arc.getPoints().slice() }));
     entries.sort((a, b) => b.points.length - a.points.length);
 
@@ -1652,41 +2099,54 @@ class ArcGroup {
       }
     }
 
+    let proximityAttachments = 0;
     for (let idx = 0; idx < entries.length; idx += 1) {
       if (used.has(idx)) {
         continue;
       }
+      proximityAttachments += 1;
       ordered = this._attachByProximity(ordered, entries[idx].points);
     }
 
-    if (ordered.length && this._matchPoints(ordered[0], ordered[ordered.length - 1], tol)) {
+    const closed = ordered.length > 0 && this._matchPoints(ordered[0], ordered[ordered.length - 1], tol);
+    if (closed) {
       ordered[ordered.length - 1] = ordered[0];
     }
 
+    this.outlineJoins = { proximityAttachments, open: ordered.length > 0 && !closed };
     this._outlineCache = ordered.slice();
     return ordered.slice();
   }
 
-  _getPatternSegments(spacing, angleDeg, offset) {
-    // Symmetric optimization: if this is a clone, rotate master's pattern segments.
-    // We want the clone's lines to be at absolute angle `angleDeg` in world space.
-    // The clone rotation will add `_rotationCache.angle` (radians) to the master's
-    // world-space result, so ask the master for `angleDeg - deltaDeg` so the
-    // rotation brings it back to `angleDeg`.
+  /**
+   * Fill polylines of one kernel and angle as normalised template polylines
+   * plus the transform that places them in world space. Only the template
+   * keeps the polylines; callers map them through the transform as they emit
+   * them. Returns null when the group has no usable template.
+   */
+  _getPatternSource(spacing, angleDeg, offset, patternType = this.fillKernel) {
+    // Symmetric optimization: a clone reuses its master's hatch, rotated about
+    // the spiral centre. The clone rotation adds `_rotationCache.angle` to the
+    // master's lines, so ask the master for `angleDeg - deltaDeg` and fold the
+    // rotation into the transform.
     if (this.cloneOf && this._rotationCache) {
       const deltaDeg = this._rotationCache.angle * (180 / Math.PI);
-      const masterSegments = this.cloneOf._getPatternSegments(spacing, angleDeg - deltaDeg, offset);
-      if (masterSegments && masterSegments.length > 0) {
+      const master = this.cloneOf._getPatternSource(spacing, angleDeg - deltaDeg, offset, patternType);
+      if (master && master.segments.length > 0) {
         const { cos, sin } = this._rotationCache;
-        const rotated = [];
-        for (let i = 0; i < masterSegments.length; i++) {
-          const [start, end] = masterSegments[i];
-          rotated.push([
-            { re: start.re * cos - start.im * sin, im: start.re * sin + start.im * cos },
-            { re: end.re * cos - end.im * sin, im: end.re * sin + end.im * cos },
-          ]);
-        }
-        return rotated;
+        const { transform } = master;
+        return {
+          segments: master.segments,
+          transform: {
+            cos: transform.cos * cos - transform.sin * sin,
+            sin: transform.sin * cos + transform.cos * sin,
+            radius: transform.radius,
+            center: {
+              re: transform.center.re * cos - transform.center.im * sin,
+              im: transform.center.re * sin + transform.center.im * cos,
+            },
+          },
+        };
       }
     }
 
@@ -1711,22 +2171,36 @@ class ArcGroup {
     if (!template.patternCache) {
       template.patternCache = new Map();
     }
-    if (!this._patternSegmentsCache) {
-      this._patternSegmentsCache = new Map();
-    }
     const rotationDeg =
       Math.atan2(transform.sin ?? 0, transform.cos ?? 1) * (180 / Math.PI);
 
+    const kernel = fillKernel(patternType);
     const a = angleDeg - rotationDeg;
-    const normalizedAngleDeg = ((a % 180) + 180) % 180;
-
-    const key = `${spacing.toFixed(6)}|${normalizedAngleDeg.toFixed(6)}|${offset.toFixed(6)}`;
-    const cached = this._patternSegmentsCache.get(key);
-    if (cached) {
-      return cached;
+    let normalizedAngleDeg = kernel.usesAngle ? ((a % 180) + 180) % 180 : 0;
+    const angleStep = this.patternAngleStep;
+    if (angleStep > 0 && kernel.usesAngle) {
+      // Snap the angle relative to the template so congruent groups with
+      // nearly equal hatch angles share one hatch set.
+      const snapped = (Math.round(normalizedAngleDeg / angleStep) * angleStep) % 180;
+      const errorDeg = Math.abs(snapped - normalizedAngleDeg) % 180;
+      const error = Math.min(errorDeg, 180 - errorDeg);
+      if (error > GEOMETRY_STATS.hatchAngleError) {
+        GEOMETRY_STATS.hatchAngleError = error;
+      }
+      const rim = templateRimRadius(template) * (transform.radius || baseRadius);
+      const deviation = rim * Math.sin(degToRad(error));
+      if (deviation > GEOMETRY_STATS.hatchRimDeviation) {
+        GEOMETRY_STATS.hatchRimDeviation = deviation;
+      }
+      normalizedAngleDeg = snapped;
     }
+
+    const key = `${patternType}|${spacing.toFixed(6)}|${normalizedAngleDeg.toFixed(6)}|${offset.toFixed(6)}`;
     let normalizedSegments = template.patternCache.get(key) || null;
-    if (!normalizedSegments) {
+    if (normalizedSegments) {
+      GEOMETRY_STATS.hatchReused += 1;
+    } else {
+      GEOMETRY_STATS.hatchComputed += 1;
       const transformRadius = transform.radius || baseRadius;
       const spacingNorm = spacing / baseRadius;
       const offsetClamped = Math.max(0, offset);
@@ -1748,17 +2222,18 @@ class ArcGroup {
           for (let idx = 0; idx < normalized.length; idx += 2) {
             polygon.push({ x: normalized[idx] * scale, y: normalized[idx + 1] * scale });
           }
-          normalizedSegments = linesInPolygon(polygon, spacingNorm, normalizedAngleDeg, 0);
+          normalizedSegments = kernel.build(polygon, spacingNorm, normalizedAngleDeg, 0);
         }
       }
 
       if (normalizedSegments && normalizedSegments.length) {
         const filtered = [];
         for (const segment of normalizedSegments) {
-          if (!segment || segment.length !== 2) {
+          if (!segment || segment.length < 2) {
             continue;
           }
-          const [start, end] = segment;
+          const start = segment[0];
+          const end = segment[segment.length - 1];
           if (!start || !end) {
             continue;
           }
@@ -1767,7 +2242,8 @@ class ArcGroup {
           if (!Number.isFinite(dx) || !Number.isFinite(dy)) {
             continue;
           }
-          if (dx * dx + dy * dy <= 1e-12) {
+          // Closed polylines (rings) end where they start
+          if (segment.length === 2 && dx * dx + dy * dy <= 1e-12) {
             continue;
           }
           filtered.push(segment);
@@ -1776,53 +2252,46 @@ class ArcGroup {
       }
       template.patternCache.set(key, normalizedSegments);
     }
-    if (!normalizedSegments || !normalizedSegments.length) {
-      const empty = [];
-      this._patternSegmentsCache.set(key, empty);
-      return empty;
+    return { segments: normalizedSegments || [], transform };
+  }
+
+  /**
+   * The outline shrunk towards the group's circle centre the way template
+   * hatches are inset by `offset` (world units). Used by preview fills.
+   */
+  _insetOutline(outline, offset) {
+    const circle = this.baseCircle || this.arcs[0]?.circle || null;
+    if (!(offset > 0) || !circle || !(circle.radius > 1e-9)) {
+      return outline;
     }
-    const { cos, sin, radius, center } = transform;
-    const segments = [];
-    for (let idx = 0; idx < normalizedSegments.length; idx += 1) {
-      const [start, end] = normalizedSegments[idx];
-      const dxNorm = end.x - start.x;
-      const dyNorm = end.y - start.y;
-      if (dxNorm * dxNorm + dyNorm * dyNorm <= 1e-12) {
-        continue;
-      }
-      const sx = start.x * radius;
-      const sy = start.y * radius;
-      const ex = end.x * radius;
-      const ey = end.y * radius;
-      const p1 = {
-        re: center.re + sx * cos - sy * sin,
-        im: center.im + sx * sin + sy * cos,
-      };
-      const p2 = {
-        re: center.re + ex * cos - ey * sin,
-        im: center.im + ex * sin + ey * cos,
-      };
-      const dx = p2.re - p1.re;
-      const dy = p2.im - p1.im;
-      if (!Number.isFinite(dx) || !Number.isFinite(dy)) {
-        continue;
-      }
-      if (dx * dx + dy * dy <= 1e-12) {
-        continue;
-      }
-      segments.push([
-        {
-          re: p1.re,
-          im: p1.im,
-        },
-        {
-          re: p2.re,
-          im: p2.im,
-        },
-      ]);
+    const scale = (circle.radius - offset) / circle.radius;
+    if (scale <= 1e-9) {
+      return [];
     }
-    this._patternSegmentsCache.set(key, segments);
-    return segments;
+    const { re: cx, im: cy } = circle.center;
+    return outline.map(point => ({ re: cx + (point.re - cx) * scale, im: cy + (point.im - cy) * scale }));
+  }
+
+  /**
+   * Stream world-space hatch lines to `visit(x1, y1, x2, y2)` without
+   * building per-group arrays. Returns the number of lines visited, or -1
+   * when the group has no template.
+   */
+  forEachPatternSegment(spacing, angleDeg, offset, visit) {
+    const source = this._getPatternSource(spacing, angleDeg, offset);
+    return source ? forEachSourceSegment(source, visit) : -1;
+  }
+
+  /**
+   * World-space hatch lines as `[{re, im}, {re, im}]` pairs, built on demand
+   * for exporters that need whole arrays. Nothing is cached on the group.
+   */
+  getPatternSegments(spacing, angleDeg, offset) {
+    const segments = [];
+    const count = this.forEachPatternSegment(spacing, angleDeg, offset, (x1, y1, x2, y2) => {
+      segments.push([{ re: x1, im: y1 }, { re: x2, im: y2 }]);
+    });
+    return count < 0 ? null : segments;
   }
 
   toSVGFill(context, {
@@ -1895,9 +2364,27 @@ class ArcGroup {
         });
       }
 
+      // Preview renders leave line clipping to the browser: one <pattern>
+      // per spacing/angle fills the (inset) outline, no segments are computed.
+      const previewAngles = fillKernel(patternType).previewAngles;
+      if (context.patternPreview && previewAngles) {
+        const fillOutline = this._insetOutline(outline, offsetForSegments);
+        for (const angleValue of anglesToRender) {
+          for (const previewAngle of previewAngles(angleValue)) {
+            context.drawPreviewPatternFill(fillOutline, {
+              spacing: spacingForSegments,
+              angle: previewAngle,
+              color: stroke,
+              strokeWidth: patternStrokeWidth,
+            });
+          }
+        }
+        return;
+      }
+
       // Draw pattern lines for each angle (skip if cell is OFF)
       for (const angleValue of anglesToRender) {
-        const segments = this._getPatternSegments(spacingForSegments, angleValue, offsetForSegments);
+        const source = this._getPatternSource(spacingForSegments, angleValue, offsetForSegments, patternType);
         context.drawGroupOutline(outline, {
           fill: 'pattern',
           stroke: null,
@@ -1905,7 +2392,7 @@ class ArcGroup {
           linePatternSettings: [lineSpacingRaw, angleValue],
           drawOutline: false, // Already drawn above
           lineOffset,
-          patternSegments: segments,
+          patternSource: source,
           patternType,
           rectWidth,
           patternStrokeWidth,
@@ -2029,6 +2516,8 @@ class DrawingContext {
     this.height = resolvedHeight;
     this.units = typeof units === 'string' ? units : '';
     this.scaleFactor = 1;
+    this.patternPreview = false; // Fill hatches with <pattern> defs instead of line segments
+    this._previewPatternIds = new Set();
     this.hasDOM = typeof document !== 'undefined' && !!document.createElementNS;
     this._layers = null;        // Array of <g> elements when layering is enabled (DOM mode)
     this._virtualLayers = null; // Array of string arrays when layering is enabled (virtual mode)
@@ -2318,6 +2807,67 @@ class DrawingContext {
     this._appendTarget.appendChild(path);
   }
 
+  /**
+   * Fills an outline with parallel lines through a shared <pattern> in
+   * <defs>, so the browser clips the hatch instead of the engine. Spacing is
+   * in world units, angle in degrees as for linesInPolygon(). The line phase
+   * follows the document origin rather than each group's template, so this
+   * is for previews only.
+   */
+  drawPreviewPatternFill(points, { spacing, angle, color = DEFAULT_OUTLINE_COLOR, strokeWidth = 0.5 }) {
+    const tile = spacing * this.scaleFactor;
+    const width = Number.isFinite(strokeWidth) ? Math.max(0, strokeWidth) : 0;
+    if (!points || points.length < 3 || !(tile > 1e-6) || width <= 0) {
+      return;
+    }
+    const colour = color || DEFAULT_OUTLINE_COLOR;
+    const angleText = (((angle % 180) + 180) % 180).toFixed(2);
+    const tileText = tile.toFixed(4);
+    // Ids are derived from the pattern itself, so SVGs inlined side by side
+    // can only collide on identical patterns.
+    const id = `hatch_${tileText}_${angleText}_${width}_${String(colour).replace(/[^0-9A-Za-z]/g, '')}`;
+    if (!this._previewPatternIds.has(id)) {
+      this._previewPatternIds.add(id);
+      const half = (tile / 2).toFixed(4);
+      const patternAttrs = {
+        id,
+        patternUnits: 'userSpaceOnUse',
+        width: tileText,
+        height: tileText,
+        patternTransform: `rotate(${angleText})`,
+      };
+      const lineAttrs = {
+        x1: '0', y1: half, x2: tileText, y2: half,
+        stroke: colour, 'stroke-width': String(width), 'stroke-linecap': 'butt',
+      };
+      if (!this.hasDOM) {
+        const attrText = attrs => Object.entries(attrs).map(([key, value]) => `${key}="${value}"`).join(' ');
+        this._virtualDefs.push(`<pattern ${attrText(patternAttrs)}><line ${attrText(lineAttrs)} /></pattern>`);
+      } else {
+        const pattern = document.createElementNS(SVG_NS, 'pattern');
+        for (const [key, value] of Object.entries(patternAttrs)) pattern.setAttribute(key, value);
+        const line = document.createElementNS(SVG_NS, 'line');
+        for (const [key, value] of Object.entries(lineAttrs)) line.setAttribute(key, value);
+        pattern.appendChild(line);
+        this.defs.appendChild(pattern);
+      }
+    }
+    const sf = this.scaleFactor;
+    let d = `M${(points[0].re * sf).toFixed(4)},${(points[0].im * sf).toFixed(4)}`;
+    for (let i = 1; i < points.length; i++) {
+      d += ` L${(points[i].re * sf).toFixed(4)},${(points[i].im * sf).toFixed(4)}`;
+    }
+    d += ' Z';
+    const attributes = { d, fill: `url(#${id})`, stroke: 'none' };
+    if (!this.hasDOM) {
+      this._pushVirtual('path', attributes);
+      return;
+    }
+    const path = document.createElementNS(SVG_NS, 'path');
+    for (const [key, value] of Object.entries(attributes)) path.setAttribute(key, value);
+    this._appendTarget.appendChild(path);
+  }
+
   drawGroupOutline(points, {
     fill = null,
     stroke = DEFAULT_OUTLINE_COLOR,
@@ -2326,7 +2876,7 @@ class DrawingContext {
     linePatternSettings = [3, 0],
     drawOutline = true,
     lineOffset = 0,
-    patternSegments = null,
+    patternSource = null,
     patternType = 'lines',
     rectWidth = 2,
     patternStrokeWidth = 0.5,
@@ -2399,6 +2949,11 @@ class DrawingContext {
         return;
       }
       const strokeColor = color || 'none';
+      if (this.patternPreview) {
+        // One path per outline keeps the preview DOM small.
+        this.drawPolyline(points, { color: strokeColor, width: outlineStrokeWidth, close: true });
+        return;
+      }
       if (!this.hasDOM) {
         for (const [start, end] of segments) {
           this._pushVirtual('line', {
@@ -2433,102 +2988,142 @@ class DrawingContext {
       : null;
 
     if (fill === 'pattern') {
-      let segmentsToDraw = null;
-      if (patternSegments !== null && patternSegments !== undefined) {
-        segmentsToDraw = patternSegments.map(([start, end]) => [
-          this._scaled(start),
-          this._scaled(end),
-        ]);
+      // Visit each hatch line in drawing coordinates. Template hatches are
+      // mapped from their normalised segments as they are emitted, so no
+      // world-space copy is kept for the group.
+      let forEachLine;
+      if (patternSource !== null && patternSource !== undefined) {
+        forEachLine = visit => forEachSourceSegment(patternSource, (x1, y1, x2, y2) => {
+          visit(x1 * sf, y1 * sf, x2 * sf, y2 * sf);
+        });
       } else {
-        segmentsToDraw = linesInPolygon(
+        const polylines = fillPatternPolylines(
+          patternType,
           scaled,
           linePatternSettings[0],
           linePatternSettings[1],
           lineOffset,
         );
+        forEachLine = visit => {
+          for (const polyline of polylines) {
+            for (let k = 1; k < polyline.length; k += 1) {
+              visit(polyline[k - 1].x, polyline[k - 1].y, polyline[k].x, polyline[k].y);
+            }
+          }
+        };
       }
       if (outlineSegments) {
         emitOutlineSegments(outlineSegments, stroke);
       }
-      if (segmentsToDraw && segmentsToDraw.length) {
-        const lineColor = stroke || DEFAULT_OUTLINE_COLOR;
-        const patternStyle = patternType === 'rectangles' ? 'rectangles' : 'lines';
-        if (patternStyle === 'rectangles') {
-          const widthValue = Number.isFinite(rectWidth) ? Math.abs(rectWidth) : 0;
-          const scale = this.scaleFactor > 0 ? this.scaleFactor : 1;
-          const scaledWidth = widthValue * scale;
-          if (scaledWidth > 1e-6 && patternStroke > 0) {
-            const halfWidth = scaledWidth / 2;
-            for (const [p1, p2] of segmentsToDraw) {
-              if (!p1 || !p2) {
-                continue;
-              }
-              const dx = p2.x - p1.x;
-              const dy = p2.y - p1.y;
-              const length = Math.hypot(dx, dy);
-              if (!Number.isFinite(length) || length <= 1e-6) {
-                continue;
-              }
-              if (length <= 2 * halfWidth) {
-                continue;
-              }
-              const invLength = 1 / length;
-              const offsetX = -dy * invLength * halfWidth;
-              const offsetY = dx * invLength * halfWidth;
-              const rectPoints = [
-                { x: p1.x + offsetX, y: p1.y + offsetY },
-                { x: p2.x + offsetX, y: p2.y + offsetY },
-                { x: p2.x - offsetX, y: p2.y - offsetY },
-                { x: p1.x - offsetX, y: p1.y - offsetY },
-              ];
-              const rectPathData = buildPathData(rectPoints);
-              const rectAttributes = {
-                d: rectPathData,
-                fill: 'none',
-                stroke: '#ff0000',
-                'stroke-width': patternStrokeStr,
-              };
-              if (!this.hasDOM) {
-                this._pushVirtual('path', rectAttributes);
-              } else {
-                const path = document.createElementNS(SVG_NS, 'path');
-                for (const [key, value] of Object.entries(rectAttributes)) {
-                  path.setAttribute(key, value);
-                }
-                this._appendTarget.appendChild(path);
-              }
+      const lineColor = stroke || DEFAULT_OUTLINE_COLOR;
+      const patternStyle = fillKernel(patternType).svg;
+      if (patternStyle === 'path') {
+        // One batched path per group and angle; segments that continue a
+        // polyline extend the current subpath instead of starting a new one.
+        if (patternStroke > 0) {
+          const parts = [];
+          let lastX = NaN;
+          let lastY = NaN;
+          forEachLine((x1, y1, x2, y2) => {
+            const sx = x1.toFixed(4);
+            const sy = y1.toFixed(4);
+            if (sx !== lastX || sy !== lastY) {
+              parts.push(`M${sx},${sy}`);
             }
-          }
-        } else {
-          if (patternStroke > 0) {
-            for (const [p1, p2] of segmentsToDraw) {
-              if (!this.hasDOM) {
-                this._pushVirtual('line', {
-                  x1: p1.x.toFixed(4),
-                  y1: p1.y.toFixed(4),
-                  x2: p2.x.toFixed(4),
-                  y2: p2.y.toFixed(4),
-                  stroke: lineColor,
-                  'stroke-width': patternStrokeStr,
-                  'stroke-linecap': 'round',
-                });
-              } else {
-                const line = document.createElementNS(SVG_NS, 'line');
-                line.setAttribute('x1', p1.x.toFixed(4));
-                line.setAttribute('y1', p1.y.toFixed(4));
-                line.setAttribute('x2', p2.x.toFixed(4));
-                line.setAttribute('y2', p2.y.toFixed(4));
-                line.setAttribute('stroke', lineColor);
-                line.setAttribute('stroke-width', patternStrokeStr);
-                line.setAttribute('stroke-linecap', 'round');
-                this._appendTarget.appendChild(line);
+            lastX = x2.toFixed(4);
+            lastY = y2.toFixed(4);
+            parts.push(`L${lastX},${lastY}`);
+          });
+          if (parts.length) {
+            const hatchAttributes = {
+              d: parts.join(' '),
+              fill: 'none',
+              stroke: lineColor,
+              'stroke-width': patternStrokeStr,
+              'stroke-linecap': 'round',
+              'stroke-linejoin': 'round',
+            };
+            if (!this.hasDOM) {
+              this._pushVirtual('path', hatchAttributes);
+            } else {
+              const path = document.createElementNS(SVG_NS, 'path');
+              for (const [key, value] of Object.entries(hatchAttributes)) {
+                path.setAttribute(key, value);
               }
+              this._appendTarget.appendChild(path);
             }
           }
         }
-      }
-      return;
-    }
+      } else if (patternStyle === 'rectangles') {
+        const widthValue = Number.isFinite(rectWidth) ? Math.abs(rectWidth) : 0;
+        const scale = this.scaleFactor > 0 ? this.scaleFactor : 1;
+        const scaledWidth = widthValue * scale;
+        if (scaledWidth > 1e-6 && patternStroke > 0) {
+          const halfWidth = scaledWidth / 2;
+          forEachLine((x1, y1, x2, y2) => {
+            const dx = x2 - x1;
+            const dy = y2 - y1;
+            const length = Math.hypot(dx, dy);
+            if (!Number.isFinite(length) || length <= 1e-6) {
+              return;
+            }
+            if (length <= 2 * halfWidth) {
+              return;
+            }
+            const invLength = 1 / length;
+            const offsetX = -dy * invLength * halfWidth;
+            const offsetY = dx * invLength * halfWidth;
+            const rectPoints = [
+              { x: x1 + offsetX, y: y1 + offsetY },
+              { x: x2 + offsetX, y: y2 + offsetY },
+              { x: x2 - offsetX, y: y2 - offsetY },
+              { x: x1 - offsetX, y: y1 - offsetY },
+            ];
+            const rectPathData = buildPathData(rectPoints);
+            const rectAttributes = {
+              d: rectPathData,
+              fill: 'none',
+              stroke: '#ff0000',
+              'stroke-width': patternStrokeStr,
+            };
+            if (!this.hasDOM) {
+              this._pushVirtual('path', rectAttributes);
+            } else {
+              const path = document.createElementNS(SVG_NS, 'path');
+              for (const [key, value] of Object.entries(rectAttributes)) {
+                path.setAttribute(key, value);
+              }
+              this._appendTarget.appendChild(path);
+            }
+          });
+        }
+      } else if (patternStroke > 0) {
+        forEachLine((x1, y1, x2, y2) => {
+          if (!this.hasDOM) {
+            this._pushVirtual('line', {
+              x1: x1.toFixed(4),
+              y1: y1.toFixed(4),
+              x2: x2.toFixed(4),
+              y2: y2.toFixed(4),
+              stroke: lineColor,
+              'stroke-width': patternStrokeStr,
+              'stroke-linecap': 'round',
+            });
+          } else {
+            const line = document.createElementNS(SVG_NS, 'line');
+            line.setAttribute('x1', x1.toFixed(4));
+            line.setAttribute('y1', y1.toFixed(4));
+            line.setAttribute('x2', x2.toFixed(4));
+            line.setAttribute('y2', y2.toFixed(4));
+            line.setAttribute('stroke', lineColor);
+            line.setAttribute('stroke-width', patternStrokeStr);
+            line.setAttribute('stroke-linecap', 'round');
+            this._appendTarget.appendChild(line);
+          }
+        });
+      }
+      return;
+    }
 
     if (fill) {
       const pathData = buildPathData(scaled);
@@ -2559,7 +3154,6 @@ class DrawingContext {
     if (this.hasDOM && this.svg) {
       return new XMLSerializer().serializeToString(this.svg);
     }
-    const viewBox = this._viewBox();
     const defsContent = this._virtualDefs && this._virtualDefs.length
       ? `<defs>${this._virtualDefs.join('')}</defs>`
       : '';
@@ -2574,10 +3168,14 @@ class DrawingContext {
     } else {
       mainContent = '<g></g>';
     }
+    return `${this._svgOpenTag(Boolean(this._virtualLayers))}${defsContent}${mainContent}</svg>`;
+  }
+
+  _svgOpenTag(layered) {
     const widthAttr = this._formatLength(this.width);
     const heightAttr = this._formatLength(this.height);
-    const inkscapeNs = this._virtualLayers ? ' xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape"' : '';
-    return `<svg xmlns="${SVG_NS}"${inkscapeNs} viewBox="${viewBox}" width="${widthAttr}" height="${heightAttr}">${defsContent}${mainContent}</svg>`;
+    const inkscapeNs = layered ? ' xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape"' : '';
+    return `<svg xmlns="${SVG_NS}"${inkscapeNs} viewBox="${this._viewBox()}" width="${widthAttr}" height="${heightAttr}">`;
   }
 
   toElement() {
@@ -2588,6 +3186,67 @@ class DrawingContext {
   }
 }
 
+/**
+ * SVG layer of a ring when layering is on: rings are split evenly between
+ * minIndex and maxIndex. Returns -1 (the main group) when layering is off or
+ * there is no ring span.
+ */
+function ringLayerIndex(ringIdx, { enabled, count, minIndex, maxIndex }) {
+  if (!enabled || maxIndex === null || maxIndex <= minIndex) return -1;
+  const span = maxIndex - minIndex;
+  return Math.min(count - 1, Math.floor((ringIdx - minIndex) / span * count));
+}
+
+/**
+ * DrawingContext that hands finished markup to a `write(text)` callback
+ * instead of keeping the document in memory. Drawing calls collect into the
+ * main group as usual; flush() writes and forgets them. Layer groups are
+ * opened and closed by the caller, so setActiveLayer() has no effect here.
+ * The bytes written between open() and close() match the virtual-mode
+ * toString() of a DrawingContext that received the same calls.
+ */
+class StreamingDrawingContext extends DrawingContext {
+  constructor(write, width = 800, height = null, units = '') {
+    super(width, height, units);
+    // Always serialise to strings, even where a DOM is available
+    this.hasDOM = false;
+    this.svg = null;
+    this.defs = null;
+    this.mainGroup = null;
+    this._virtualDefs = [];
+    this._virtualMain = [];
+    this._write = write;
+  }
+
+  open(layered = false) {
+    this._write(`${this._svgOpenTag(layered)}<g>`);
+  }
+
+  openLayer(idx) {
+    this.write(`<g id="layer_${idx + 1}" inkscape:label="Layer ${idx + 1}" inkscape:groupmode="layer">`);
+  }
+
+  closeLayer() {
+    this.write('</g>');
+  }
+
+  write(text) {
+    this.flush();
+    this._write(text);
+  }
+
+  flush() {
+    if (this._virtualMain.length) {
+      this._write(this._virtualMain.join(''));
+      this._virtualMain = [];
+    }
+  }
+
+  close() {
+    this.write('</g></svg>');
+  }
+}
+
 // ------------------------------------------------------------
 // Doyle mathematics and arc selection
 // ------------------------------------------------------------
@@ -2727,7 +3386,7 @@ class ArcSelector {
 
     if (mode === 'random') {
       const indices = Array.from({ length: n }, (_, i) => i);
-      const rng = seededRandom(circle.id * 97 + 13);
+      const rng = seededRandom(circle.seed * 97 + 13);
       for (let i = indices.length - 1; i > 0; i -= 1) {
         const j = Math.floor(rng() * (i + 1));
         [indices[i], indices[j]] = [indices[j], indices[i]];
@@ -2817,18 +3476,288 @@ class ArcSelector {
  * @param {string} options.arcMode - Arc selection mode: 'closest', 'furthest', or 'average'
  * @param {number} options.numGaps - Number of gaps in the spiral pattern
  */
+// ------------------------------------------------------------
+// Ring streaming
+// ------------------------------------------------------------
+
+/**
+ * Sliding window over the rings of a spiral for renderStream().
+ *
+ * Circle positions live in flat typed arrays; CircleElements exist only for
+ * the rings near the one being processed. Touching circles differ in radius
+ * by at most `reach` (the largest of |a|, |b|, |a/b| and their inverses), so
+ * ring k needs complete intersections for radii within [min/reach, max*reach]
+ * of the ring, and those need circles within reach² to exist. Circles below
+ * that window are released as the sweep moves outward.
+ *
+ * Every circle collects its intersections in the same partner order as
+ * computeAllIntersections() (centre x, then generation order), so groups,
+ * outlines and hatching come out bit-identical to an in-memory render.
+ */
+class RingStreamWindow {
+  constructor(engine, { x, y, r, idBase }) {
+    this.engine = engine;
+    this.count = r.length;
+    this.idBase = idBase;
+    this.outer = engine.outerCircles;
+    const total = this.count + this.outer.length;
+    this.total = total;
+
+    // Positions of every circle followed by the outer circles, in the order
+    // computeAllIntersections() sees them.
+    this.cx = new Float64Array(total);
+    this.cy = new Float64Array(total);
+    this.radius = new Float64Array(total);
+    this.cx.set(x);
+    this.cy.set(y);
+    this.radius.set(r);
+    this.outer.forEach((circle, idx) => {
+      this.cx[this.count + idx] = circle.center.re;
+      this.cy[this.count + idx] = circle.center.im;
+      this.radius[this.count + idx] = circle.radius;
+    });
+
+    // Rings in ascending radius; circles of a ring in generation order.
+    const radiusToRing = engine._computeRingIndices(r);
+    const ringCount = radiusToRing.size;
+    const ringOf = new Int32Array(this.count);
+    const ringStart = new Int32Array(ringCount + 1);
+    const ringMin = new Float64Array(ringCount).fill(Infinity);
+    const ringMax = new Float64Array(ringCount);
+    for (let idx = 0; idx < this.count; idx += 1) {
+      const ring = radiusToRing.get(Number(r[idx].toFixed(6)));
+      ringOf[idx] = ring;
+      ringStart[ring + 1] += 1;
+      ringMin[ring] = Math.min(ringMin[ring], r[idx]);
+      ringMax[ring] = Math.max(ringMax[ring], r[idx]);
+    }
+    for (let ring = 0; ring < ringCount; ring += 1) {
+      ringStart[ring + 1] += ringStart[ring];
+    }
+    const fill = ringStart.slice(0, ringCount);
+    const ringOrder = new Int32Array(this.count);
+    for (let idx = 0; idx < this.count; idx += 1) {
+      ringOrder[fill[ringOf[idx]]++] = idx;
+    }
+    this.ringCount = ringCount;
+    this.ringStart = ringStart;
+    this.ringOrder = ringOrder;
+    this.ringMin = ringMin;
+    this.ringMax = ringMax;
+
+    const byRadius = new Int32Array(total);
+    for (let idx = 0; idx < total; idx += 1) {
+      byRadius[idx] = idx;
+    }
+    byRadius.sort((i, j) => this.radius[i] - this.radius[j]);
+    this.byRadius = byRadius;
+
+    const { a, b, r: radiusRatio } = engine.root;
+    const modA = Complex.abs(a);
+    const modB = Complex.abs(b);
+    const reach = Math.max(modA, 1 / modA, modB, 1 / modB, modA / modB, modB / modA);
+    this.reach = reach * (1 + 1e-6);
+
+    // |centre| = radius / radiusRatio for every circle, so touching circles lie
+    // within a fixed angle of each other: bucket by polar angle.
+    const spread = radiusRatio * (1 + this.reach) * (1 + 1e-6) + 1e-6;
+    let buckets = spread >= 1 ? 1 : Math.floor((2 * Math.PI) / Math.asin(spread));
+    if (buckets < 3) {
+      buckets = 1;
+    }
+    this.bucketCount = buckets;
+    this.bucketOf = new Int32Array(total);
+    for (let idx = 0; idx < total; idx += 1) {
+      const angle = Math.atan2(this.cy[idx], this.cx[idx]);
+      this.bucketOf[idx] = Math.min(buckets - 1, Math.floor(((angle + Math.PI) / (2 * Math.PI)) * buckets));
+    }
+    this.peakLiveCircles = 0;
+  }
+
+  /**
+   * Visits rings fromRing..toRing in order. Each ring's groups are created,
+   * closed by their outer arcs, extended and given templates (skipped when
+   * `light`), passed to visit(groups, ringIndex) and then dropped.
+   */
+  sweep(fromRing, toRing, visit, {
+    symmetric = false,
+    light = false,
+    debugGroups = false,
+    inlineOutline = false,
+    context = null,
+    outlineStrokeWidth = 0,
+  } = {}) {
+    const engine = this.engine;
+    const spiralCenter = Complex.ZERO;
+    this.live = new Array(this.total).fill(null);
+    this.indexOf = new Map();
+    this.buckets = Array.from({ length: this.bucketCount }, () => new Set());
+    this.ownerArcs = new Map();
+    this.closures = new Array(this.outer.length).fill(null);
+    this.liveCount = 0;
+    let low = 0;
+    let materialized = 0;
+    let finalized = 0;
+
+    for (let ring = Math.max(0, fromRing); ring <= Math.min(toRing, this.ringCount - 1); ring += 1) {
+      const innerNeed = this.ringMin[ring] / this.reach;
+      const outerNeed = this.ringMax[ring] * this.reach;
+      while (low < this.total && this.radius[this.byRadius[low]] < innerNeed / this.reach) {
+        this._release(this.byRadius[low]);
+        low += 1;
+      }
+      while (materialized < this.total && this.radius[this.byRadius[materialized]] <= outerNeed * this.reach) {
+        const idx = this.byRadius[materialized];
+        if (this.radius[idx] >= innerNeed / this.reach) {
+          this._materialize(idx);
+        }
+        materialized += 1;
+      }
+      while (finalized < this.total && this.radius[this.byRadius[finalized]] <= outerNeed) {
+        const idx = this.byRadius[finalized];
+        if (this.radius[idx] >= innerNeed) {
+          this._finalize(idx);
+        }
+        finalized += 1;
+      }
+
+      const circles = [];
+      for (let pos = this.ringStart[ring]; pos < this.ringStart[ring + 1]; pos += 1) {
+        const circle = this.live[this.ringOrder[pos]];
+        if (circle && circle.intersections.length === STANDARD_INTERSECTION_COUNT) {
+          circles.push(circle);
+        }
+      }
+      if (symmetric) {
+        engine._sortCirclesByAngle(circles);
+      }
+      engine.arcGroups = new Map();
+      const groups = engine._createRingGroups(ring, circles, {
+        spiralCenter,
+        debugGroups,
+        addFillPattern: false,
+        drawGroupOutline: inlineOutline,
+        context,
+        outlineStrokeWidth,
+        symmetric,
+      });
+      for (const group of groups) {
+        const owner = this.ownerArcs.get(this.indexOf.get(group.baseCircle));
+        if (owner) {
+          group.outerArc = owner.arc;
+        }
+      }
+      if (!light) {
+        for (const group of groups) {
+          engine._extendGroupWithNeighbours(group, group.baseCircle, spiralCenter);
+        }
+        engine._finalizeRingTemplates(groups, { cacheTemplates: false });
+      }
+      visit(groups, ring);
+    }
+    engine.arcGroups = new Map();
+    engine._ringTemplates = new Map();
+    this.live = null;
+    this.indexOf = null;
+    this.buckets = null;
+  }
+
+  _materialize(idx) {
+    const circle = idx < this.count
+      ? new CircleElement({ re: this.cx[idx], im: this.cy[idx] }, this.radius[idx], true, this.idBase + idx + 1, idx + 1)
+      : this.outer[idx - this.count];
+    this.live[idx] = circle;
+    this.indexOf.set(circle, idx);
+    this.buckets[this.bucketOf[idx]].add(idx);
+    this.liveCount += 1;
+    this.peakLiveCircles = Math.max(this.peakLiveCircles, this.liveCount);
+  }
+
+  _release(idx) {
+    const circle = this.live[idx];
+    if (!circle) {
+      return;
+    }
+    this.live[idx] = null;
+    this.indexOf.delete(circle);
+    this.buckets[this.bucketOf[idx]].delete(idx);
+    this.liveCount -= 1;
+    // Live circles may still point at this one; drop its own partner links so
+    // the released rings are not kept reachable through it.
+    circle.intersections = [];
+    circle.neighbours.clear();
+    circle._orderedNeighbours = null;
+  }
+
+  // Same tie-break as the stable x sort in computeAllIntersections().
+  _compare(i, j) {
+    return (this.cx[i] - this.cx[j]) || (i - j);
+  }
+
+  _finalize(idx) {
+    const circle = this.live[idx];
+    if (!circle) {
+      return;
+    }
+    const { cx, cy, radius } = this;
+    const home = this.bucketOf[idx];
+    const bucketIds = this.bucketCount === 1
+      ? [0]
+      : [(home + this.bucketCount - 1) % this.bucketCount, home, (home + 1) % this.bucketCount];
+    const partners = [];
+    for (const bucket of bucketIds) {
+      for (const other of this.buckets[bucket]) {
+        if (other === idx) {
+          continue;
+        }
+        const points = this._compare(idx, other) < 0
+          ? circleIntersection(cx[idx], cy[idx], radius[idx], cx[other], cy[other], radius[other])
+          : circleIntersection(cx[other], cy[other], radius[other], cx[idx], cy[idx], radius[idx]);
+        if (points.length) {
+          partners.push({ other, points });
+        }
+      }
+    }
+    partners.sort((u, v) => this._compare(u.other, v.other));
+    circle.resetIntersections();
+    for (const { other, points } of partners) {
+      for (const point of points) {
+        circle.addIntersection(point, this.live[other]);
+      }
+    }
+    circle.finalizeIntersections(Complex.ZERO);
+
+    if (idx >= this.count) {
+      const outerIdx = idx - this.count;
+      const closure = this.engine._outerClosure(circle, Complex.ZERO);
+      this.closures[outerIdx] = closure;
+      if (closure && closure.ownerCircle) {
+        const ownerIdx = this.indexOf.get(closure.ownerCircle);
+        const current = this.ownerArcs.get(ownerIdx);
+        // Later outer circles win, as in _drawOuterClosureArcs.
+        if (!current || current.outerIdx < outerIdx) {
+          this.ownerArcs.set(ownerIdx, { outerIdx, arc: closure.ownerArc });
+        }
+      }
+    }
+  }
+}
+
 class DoyleSpiralEngine {
   constructor(p = 7, q = 32, t = 0, {
     maxDistance = 2000,
     arcMode = 'closest',
     numGaps = 2,
+    streaming = false, // Allow the larger p/q range that only renderStream() can handle
   } = {}) {
     // Validate parameters
-    if (!Number.isFinite(p) || p < MIN_P || p > MAX_P) {
-      throw new Error(`Parameter p must be between ${MIN_P} and ${MAX_P}, got ${p}`);
+    const maxP = streaming ? MAX_STREAM_P : MAX_P;
+    const maxQ = streaming ? MAX_STREAM_Q : MAX_Q;
+    if (!Number.isFinite(p) || p < MIN_P || p > maxP) {
+      throw new Error(`Parameter p must be between ${MIN_P} and ${maxP}, got ${p}`);
     }
-    if (!Number.isFinite(q) || q < MIN_Q || q > MAX_Q) {
-      throw new Error(`Parameter q must be between ${MIN_Q} and ${MAX_Q}, got ${q}`);
+    if (!Number.isFinite(q) || q < MIN_Q || q > maxQ) {
+      throw new Error(`Parameter q must be between ${MIN_Q} and ${maxQ}, got ${q}`);
     }
     if (!Number.isFinite(t)) {
       throw new Error(`Parameter t must be a finite number, got ${t}`);
@@ -2862,13 +3791,28 @@ class DoyleSpiralEngine {
    * @throws {Error} If iteration limit is exceeded (prevents infinite loops)
    */
   generateCircles() {
+    const circles = [];
+    this._forEachCirclePosition((center, radius) => {
+      circles.push(new CircleElement(center, radius, true, null, circles.length + 1));
+    });
+    this.circles = circles;
+    this._generated = true;
+  }
+
+  /**
+   * Walks every circle position of the spiral in generation order (family by
+   * family, forward then backward) without allocating circle elements.
+   *
+   * @param {Function} visit - Called as visit(center, radius)
+   * @throws {Error} If iteration limit is exceeded (prevents infinite loops)
+   */
+  _forEachCirclePosition(visit) {
     const { r, a, b, mod_a: modA, arg_a: argA } = this.root;
     const scale = Math.pow(modA, this.t);
     const alpha = argA * this.t;
     const minD = 1 / Math.max(scale, EPSILON);
     const unit = Complex.expi(alpha);
 
-    const circles = [];
     let start = Complex.clone(a);
     const absA = Complex.abs(a);
 
@@ -2880,7 +3824,7 @@ class DoyleSpiralEngine {
       // Forward spiral
       while (modQ * scale < this.maxDistance && iterations < MAX_ITERATIONS_PER_FAMILY) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        circles.push(new CircleElement(scaled, r * scale * modQ));
+        visit(scaled, r * scale * modQ);
         qv = Complex.mul(qv, a);
         modQ *= absA;
         iterations++;
@@ -2900,7 +3844,7 @@ class DoyleSpiralEngine {
 
       while (modQ > minD && iterations < MAX_ITERATIONS_PER_FAMILY) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        circles.push(new CircleElement(scaled, r * scale * modQ));
+        visit(scaled, r * scale * modQ);
         qv = Complex.div(qv, a);
         modQ /= absA;
         iterations++;
@@ -2915,18 +3859,16 @@ class DoyleSpiralEngine {
 
       start = Complex.mul(start, b);
     }
-
-    this.circles = circles;
-    this._generated = true;
   }
 
   /**
    * Generates outer boundary circles for the spiral.
    * These circles help define the outer edge of the pattern.
    *
+   * @param {number} [seedBase] - Seeds continue after this many spiral circles
    * @throws {Error} If iteration limit is exceeded
    */
-  generateOuterCircles() {
+  generateOuterCircles(seedBase = this.circles.length) {
     const { r, a, b, mod_a: modA, arg_a: argA } = this.root;
     const scale = Math.pow(modA, this.t);
     const unit = Complex.expi(argA * this.t);
@@ -2954,7 +3896,7 @@ class DoyleSpiralEngine {
       const modQ = Complex.abs(qv);
       if (modQ * scale < this.maxDistance * absA * 2) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        outer.push(new CircleElement(scaled, r * scale * modQ, false));
+        outer.push(new CircleElement(scaled, r * scale * modQ, false, null, seedBase + outer.length + 1));
       }
       start = Complex.mul(start, b);
     }
@@ -2971,7 +3913,6 @@ class DoyleSpiralEngine {
     if (!all.length) {
       return;
     }
-    const tol = INTERSECTION_TOLERANCE;
 
     for (const circle of all) {
       circle.resetIntersections();
@@ -2980,20 +3921,19 @@ class DoyleSpiralEngine {
     const sorted = all
       .slice()
       .sort((a, b) => a.center.re - b.center.re);
-    const tolSq = tol * tol;
     const total = sorted.length;
     const xs = new Float64Array(total);
     const ys = new Float64Array(total);
     const radii = new Float64Array(total);
-    const radiiSq = new Float64Array(total);
     const suffixMaxRadius = new Float64Array(total);
 
+    let maxMagnitude = 0;
     for (let idx = 0; idx < total; idx += 1) {
       const entry = sorted[idx];
       xs[idx] = entry.center.re;
       ys[idx] = entry.center.im;
       radii[idx] = entry.radius;
-      radiiSq[idx] = entry.radius * entry.radius;
+      maxMagnitude = Math.max(maxMagnitude, Math.abs(xs[idx]) + Math.abs(ys[idx]) + radii[idx]);
     }
     let runningMax = 0;
     for (let idx = total - 1; idx >= 0; idx -= 1) {
@@ -3008,62 +3948,29 @@ class DoyleSpiralEngine {
       const x1 = xs[i];
       const y1 = ys[i];
       const r1 = radii[i];
-      const r1Sq = radiiSq[i];
-      const maxReachBase = r1 + tol;
+      // Conservative pruning slack: at least as large as any pairwise tangency
+      // tolerance involving this circle (see tangencyTolerance).
+      const slack = RELATIVE_TANGENCY_TOLERANCE * r1 + ROUNDOFF_TOLERANCE * 2 * maxMagnitude;
+      const maxReachBase = r1 + slack;
 
       for (let j = i + 1; j < total; j += 1) {
-        const other = sorted[j];
         const dx = xs[j] - x1;
-        const r2 = radii[j];
-        const r2Sq = radiiSq[j];
-        const breakReach = maxReachBase + suffixMaxRadius[j];
-        if (dx > breakReach) {
+        if (dx > maxReachBase + suffixMaxRadius[j]) {
           break;
         }
-        const reach = r1 + r2 + tol;
+        const r2 = radii[j];
         const dy = ys[j] - y1;
         // Quick rejection: use reach squared to avoid sqrt
-        const reachSq = reach * reach;
-        const distSq = dx * dx + dy * dy;
-
-        if (distSq <= tolSq || distSq > reachSq) {
+        const reach = r1 + r2 + slack;
+        if (dx * dx + dy * dy > reach * reach) {
           continue;
         }
 
-        const dist = Math.sqrt(distSq);
-
-        const diffR = Math.abs(r1 - r2);
-        if (dist < diffR - tol) {
-          continue;
-        }
-
-        const a = (r1Sq - r2Sq + distSq) / (2 * dist);
-        let hSq = r1Sq - a * a;
-        if (hSq < 0) {
-          if (hSq < -tol) {
-            continue;
-          }
-          hSq = 0;
-        }
-        const h = hSq === 0 ? 0 : Math.sqrt(hSq);
-
-        const ratio = a / dist;
-        const midX = x1 + dx * ratio;
-        const midY = y1 + dy * ratio;
-        const invD = 1 / dist;
-        const ux = dx * invD;
-        const uy = dy * invD;
-        const perpX = -uy;
-        const perpY = ux;
-
-        const p1 = { re: midX + perpX * h, im: midY + perpY * h };
-        circle.addIntersection(p1, other);
-        other.addIntersection(p1, circle);
-
-        if (h > tol) {
-          const p2 = { re: midX - perpX * h, im: midY - perpY * h };
-          circle.addIntersection(p2, other);
-          other.addIntersection(p2, circle);
+        const other = sorted[j];
+        const points = circleIntersection(x1, y1, r1, xs[j], ys[j], r2);
+        for (const point of points) {
+          circle.addIntersection(point, other);
+          other.addIntersection(point, circle);
         }
       }
     }
@@ -3087,8 +3994,8 @@ class DoyleSpiralEngine {
     this.arcGroups.get(key).addArc(arc);
   }
 
-  _computeRingIndices() {
-    const radii = this.circles.map(c => Number(c.radius.toFixed(6)));
+  _computeRingIndices(circleRadii = this.circles.map(c => c.radius)) {
+    const radii = Array.from(circleRadii, radius => Number(radius.toFixed(6)));
     const unique = Array.from(new Set(radii)).sort((a, b) => a - b);
     const mapping = new Map();
     unique.forEach((radius, idx) => mapping.set(radius, idx));
@@ -3132,6 +4039,7 @@ class DoyleSpiralEngine {
     }
     const outlinePoints = group.getClosedOutline();
     const normalizedOutline = this._normalisePointsForTemplate(outlinePoints, center, radius);
+    const outlineJoins = group.outlineJoins;
     let referenceVector = { re: 1, im: 0 };
     if (normalizedArcs.length && normalizedArcs[0] && normalizedArcs[0].length >= 2) {
       const x = normalizedArcs[0][0];
@@ -3144,6 +4052,7 @@ class DoyleSpiralEngine {
     return {
       normalizedArcs,
       normalizedOutline,
+      outlineJoins,
       referenceVector,
       referenceArcIndex: 0,
       arcPointCounts,
@@ -3185,40 +4094,77 @@ class DoyleSpiralEngine {
     };
   }
 
+  /**
+   * Creates arc groups for every circle, one ring at a time from the innermost
+   * ring outwards and in generation order within a ring. Ring order is what a
+   * ring-streamed render (renderStream) can reproduce without the full spiral.
+   */
   _createArcGroupsForCircles(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0) {
-    for (const circle of this.circles) {
-      if (circle.intersections.length !== 6) {
-        continue;
-      }
+    const ringCircles = this._groupCirclesByRing(radiusToRing);
+    const rings = Array.from(ringCircles.keys()).sort((a, b) => a - b);
+    for (const ringIndex of rings) {
+      this._createRingGroups(ringIndex, ringCircles.get(ringIndex), {
+        spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth,
+      });
+    }
+  }
+
+  /**
+   * Creates the arc groups of one ring.
+   * @private
+   * @param {number} ringIndex - Ring index shared by the circles
+   * @param {Array} circles - Circles of the ring with six intersections, in processing order
+   * @param {Object} options - Drawing options; `symmetric` links clones to the ring's first group
+   * @returns {Array} The created groups, in creation order
+   */
+  _createRingGroups(ringIndex, circles, {
+    spiralCenter,
+    debugGroups,
+    addFillPattern,
+    drawGroupOutline,
+    context,
+    outlineStrokeWidth = 0,
+    symmetric = false,
+  }) {
+    const groups = [];
+    // Track the master group for this ring (used for outline sharing)
+    let masterGroup = null;
+    for (let i = 0; i < circles.length; i++) {
+      const circle = circles[i];
+
+      // Each circle selects its own arcs based on position
+      // (Critical: arc selection depends on angle relative to spiral center)
       const arcsToDraw = ArcSelector.selectArcsForGaps(circle, spiralCenter, this.numGaps, this.arcMode);
-      if (!arcsToDraw.length) {
-        continue;
-      }
+      if (!arcsToDraw.length) continue;
+
       const key = `circle_${circle.id}`;
       const group = this.createGroupForCircle(circle, key);
-      const ring = radiusToRing.get(Number(circle.radius.toFixed(6)));
-      group.ringIndex = ring !== undefined ? ring : null;
+      group.ringIndex = ringIndex;
       group.baseCircle = circle;
       if (debugGroups) {
-        group.debugFill = colorFromSeed(circle.id);
+        group.debugFill = colorFromSeed(circle.seed);
         group.debugStroke = DEFAULT_OUTLINE_COLOR;
       }
-      const arcs = [];
-      for (const [i, j] of arcsToDraw) {
-        const start = circle.intersections[i][0];
-        const end = circle.intersections[j][0];
-        const steps = estimateArcSteps(circle, start, end);
-        const arc = new ArcElement(circle, start, end, steps, true);
-        if (!addFillPattern && drawGroupOutline) {
-          context.drawScaledArc(arc, { color: DEFAULT_OUTLINE_COLOR, width: outlineStrokeWidth });
-        }
-        group.addArc(arc);
-        arcs.push(arc);
-      }
+      this._createArcsForGroup(circle, group, arcsToDraw, addFillPattern, drawGroupOutline, context, outlineStrokeWidth);
 
-      group.templateKey = this._ringTemplateKey(group.ringIndex ?? -1, arcsToDraw);
+      group.templateKey = this._ringTemplateKey(ringIndex, arcsToDraw);
       group.originalArcsToDraw = arcsToDraw;
+      groups.push(group);
+
+      if (!symmetric) continue;
+      // Set up master/clone relationship for outline computation optimization
+      if (i === 0) {
+        // First circle in ring is the master
+        masterGroup = group;
+        // Pre-warm cache: compute outline immediately to avoid cascading misses
+        masterGroup.getClosedOutline();
+      } else if (masterGroup && arcsToDraw.length === masterGroup.originalArcsToDraw.length) {
+        // Subsequent circles with matching arc count are clones
+        // They will rotate the master's outline instead of computing from scratch
+        group.cloneOf = masterGroup;
+      }
     }
+    return groups;
   }
 
   /**
@@ -3273,8 +4219,7 @@ class DoyleSpiralEngine {
     for (const [idx, jdx] of arcsToDraw) {
       const start = circle.intersections[idx][0];
       const end = circle.intersections[jdx][0];
-      const steps = estimateArcSteps(circle, start, end);
-      const arc = new ArcElement(circle, start, end, steps, true);
+      const arc = new ArcElement(circle, start, end);
 
       // Draw outline if needed (but not in pattern fill mode)
       if (!addFillPattern && drawGroupOutline) {
@@ -3301,58 +4246,19 @@ class DoyleSpiralEngine {
    */
   _createArcGroupsSymmetric(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0) {
     const ringCircles = this._groupCirclesByRing(radiusToRing);
+    const rings = Array.from(ringCircles.keys()).sort((a, b) => a - b);
 
-    // Process each ring independently
-    for (const [ringIndex, circles] of ringCircles.entries()) {
+    // Process each ring independently, innermost first
+    for (const ringIndex of rings) {
+      const circles = ringCircles.get(ringIndex);
       if (!circles.length) continue;
 
       // Sort by angle for consistent processing
       this._sortCirclesByAngle(circles);
-
-      // Track the master group for this ring (used for outline sharing)
-      let masterGroup = null;
-
-      // Create arc groups for all circles in this ring
-      for (let i = 0; i < circles.length; i++) {
-        const circle = circles[i];
-
-        // Each circle selects its own arcs based on position
-        // (Critical: arc selection depends on angle relative to spiral center)
-        const arcsToDraw = ArcSelector.selectArcsForGaps(circle, spiralCenter, this.numGaps, this.arcMode);
-        if (!arcsToDraw.length) continue;
-
-        // Create the arc group
-        const key = `circle_${circle.id}`;
-        const group = this.createGroupForCircle(circle, key);
-        group.ringIndex = ringIndex;
-        group.baseCircle = circle;
-
-        // Configure debug rendering if enabled
-        if (debugGroups) {
-          group.debugFill = colorFromSeed(circle.id);
-          group.debugStroke = DEFAULT_OUTLINE_COLOR;
-        }
-
-        // Create all arcs for this circle
-        this._createArcsForGroup(circle, group, arcsToDraw, addFillPattern, drawGroupOutline, context, outlineStrokeWidth);
-
-        // Set template metadata
-        const templateKey = this._ringTemplateKey(ringIndex, arcsToDraw);
-        group.templateKey = templateKey;
-        group.originalArcsToDraw = arcsToDraw;
-
-        // Set up master/clone relationship for outline computation optimization
-        if (i === 0) {
-          // First circle in ring is the master
-          masterGroup = group;
-          // Pre-warm cache: compute outline immediately to avoid cascading misses
-          masterGroup.getClosedOutline();
-        } else if (masterGroup && arcsToDraw.length === masterGroup.originalArcsToDraw.length) {
-          // Subsequent circles with matching arc count are clones
-          // They will rotate the master's outline instead of computing from scratch
-          group.cloneOf = masterGroup;
-        }
-      }
+      this._createRingGroups(ringIndex, circles, {
+        spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth,
+        symmetric: true,
+      });
     }
   }
 
@@ -3367,68 +4273,91 @@ class DoyleSpiralEngine {
     highlightStrokeWidth = 0,
   ) {
     for (const circle of this.outerCircles) {
-      if (circle.intersections.length < 2) {
+      const closure = this._outerClosure(circle, spiralCenter);
+      if (!closure) {
         continue;
       }
-      const pts = circle.intersections.map(entry => entry[0]);
-      const distances = [];
-      for (let i = 0; i < pts.length; i += 1) {
-        const j = (i + 1) % pts.length;
-        const midpoint = Complex.mulScalar(Complex.add(pts[i], pts[j]), 0.5);
-        const dist = Complex.abs(Complex.sub(midpoint, spiralCenter));
-        distances.push({ dist, i, j });
-      }
-      distances.sort((a, b) => a.dist - b.dist);
-
-      // The innermost arc (distances[0]) is the outer boundary of the adjacent visible
-      // circle group. Store it on that group so the outline can include it.
-      if (distances.length > 0) {
-        const { i: innerI, j: innerJ } = distances[0];
-        // Find the visible circle that shares both intersection endpoints of this arc.
-        const neighborAtI = circle.intersections[innerI][1];
-        const neighborAtJ = circle.intersections[innerJ][1];
-        const ownerCircle = neighborAtI === neighborAtJ ? neighborAtI : null;
-        if (ownerCircle && ownerCircle.visible) {
-          const ownerKey = `circle_${ownerCircle.id}`;
-          const ownerGroup = this.arcGroups.get(ownerKey);
-          if (ownerGroup) {
-            const steps = estimateArcSteps(circle, pts[innerI], pts[innerJ]);
-            ownerGroup.outerArc = new ArcElement(circle, pts[innerI], pts[innerJ], steps, true);
-          }
+      // The innermost arc is the outer boundary of the adjacent visible circle
+      // group. Store it on that group so the outline can include it.
+      if (closure.ownerCircle) {
+        const ownerGroup = this.arcGroups.get(`circle_${closure.ownerCircle.id}`);
+        if (ownerGroup) {
+          ownerGroup.outerArc = closure.ownerArc;
         }
       }
-
-      const arcsForCircle = [];
-      for (let idx = 1; idx < Math.min(3, distances.length); idx += 1) {
-        const { i, j } = distances[idx];
-        const steps = estimateArcSteps(circle, pts[i], pts[j]);
-        const arc = new ArcElement(circle, pts[i], pts[j], steps, true);
-        arcsForCircle.push(arc);
+      for (const arc of closure.arcs) {
         const key = `outer_${circle.id}`;
         if (!this.arcGroups.has(key)) {
           const group = new ArcGroup(key);
           group.ringIndex = -1;
           if (debugGroups) {
-            group.debugFill = colorFromSeed(circle.id + 1000);
+            group.debugFill = colorFromSeed(circle.seed + 1000);
             group.debugStroke = DEFAULT_OUTLINE_COLOR;
           }
           this.arcGroups.set(key, group);
         }
         this.arcGroups.get(key).addArc(arc);
       }
-      if (arcsForCircle.length && (redOutline || (!addFillPattern && drawGroupOutline))) {
-        const paths = buildContinuousPathsFromArcs(arcsForCircle);
-        const shouldDrawBaseOutline = !addFillPattern && drawGroupOutline && outlineStrokeWidth > 0;
-        if (shouldDrawBaseOutline) {
-          for (const path of paths) {
-            context.drawPolyline(path, { color: DEFAULT_OUTLINE_COLOR, width: outlineStrokeWidth });
-          }
-        }
-        if (redOutline && highlightStrokeWidth > 0) {
-          for (const path of paths) {
-            context.drawPolyline(path, { color: '#ff0000', width: highlightStrokeWidth });
-          }
-        }
+      this._drawOuterClosure(closure.arcs, {
+        redOutline, addFillPattern, drawGroupOutline, context, outlineStrokeWidth, highlightStrokeWidth,
+      });
+    }
+  }
+
+  /**
+   * Closure arcs of one outer (invisible) circle, ordered by distance of the
+   * arc midpoints to the spiral centre. The innermost arc closes the visible
+   * group it borders (`ownerCircle`, null when the endpoints disagree); the
+   * next two arcs form the outer rim.
+   * @private
+   */
+  _outerClosure(circle, spiralCenter) {
+    if (circle.intersections.length < 2) {
+      return null;
+    }
+    const pts = circle.intersections.map(entry => entry[0]);
+    const distances = [];
+    for (let i = 0; i < pts.length; i += 1) {
+      const j = (i + 1) % pts.length;
+      const midpoint = Complex.mulScalar(Complex.add(pts[i], pts[j]), 0.5);
+      const dist = Complex.abs(Complex.sub(midpoint, spiralCenter));
+      distances.push({ dist, i, j });
+    }
+    distances.sort((a, b) => a.dist - b.dist);
+
+    const { i: innerI, j: innerJ } = distances[0];
+    // Find the visible circle that shares both intersection endpoints of this arc.
+    const neighborAtI = circle.intersections[innerI][1];
+    const neighborAtJ = circle.intersections[innerJ][1];
+    const ownerCircle = neighborAtI === neighborAtJ && neighborAtI.visible ? neighborAtI : null;
+    const arcs = [];
+    for (let idx = 1; idx < Math.min(3, distances.length); idx += 1) {
+      const { i, j } = distances[idx];
+      arcs.push(new ArcElement(circle, pts[i], pts[j]));
+    }
+    return {
+      ownerCircle,
+      ownerArc: ownerCircle ? new ArcElement(circle, pts[innerI], pts[innerJ]) : null,
+      arcs,
+    };
+  }
+
+  _drawOuterClosure(arcs, {
+    redOutline, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0, highlightStrokeWidth = 0,
+  }) {
+    if (!arcs.length || !(redOutline || (!addFillPattern && drawGroupOutline))) {
+      return;
+    }
+    const paths = buildContinuousPathsFromArcs(arcs);
+    const shouldDrawBaseOutline = !addFillPattern && drawGroupOutline && outlineStrokeWidth > 0;
+    if (shouldDrawBaseOutline) {
+      for (const path of paths) {
+        context.drawPolyline(path, { color: DEFAULT_OUTLINE_COLOR, width: outlineStrokeWidth });
+      }
+    }
+    if (redOutline && highlightStrokeWidth > 0) {
+      for (const path of paths) {
+        context.drawPolyline(path, { color: '#ff0000', width: highlightStrokeWidth });
       }
     }
   }
@@ -3438,70 +4367,76 @@ class DoyleSpiralEngine {
     if (!groups.length) {
       return;
     }
-    const preferenceMap = new Map([
-      ['-1', 'start'],
-      ['-2', 'end'],
-      ['-5', 'end'],
-      ['-6', 'start'],
-    ]);
     for (const circle of this.circles) {
-      const key = `circle_${circle.id}`;
-      const group = this.arcGroups.get(key);
-      if (!group) {
-        continue;
+      const group = this.arcGroups.get(`circle_${circle.id}`);
+      if (group) {
+        this._extendGroupWithNeighbours(group, circle, spiralCenter);
       }
-      const neighbours = circle.getNeighbourCircles();
-      if (neighbours.length !== 6) {
+    }
+  }
+
+  /**
+   * Adds one arc from each of four neighbouring circles to a group so its
+   * outline closes around the gaps. Reads only the intersections of the
+   * circle and its direct neighbours.
+   * @private
+   */
+  _extendGroupWithNeighbours(group, circle, spiralCenter) {
+    const neighbours = circle.getNeighbourCircles();
+    if (neighbours.length !== 6) {
+      return;
+    }
+    for (const k of [-1, -2, -5, -6]) {
+      const idx = ((k % neighbours.length) + neighbours.length) % neighbours.length;
+      const neighbour = neighbours[idx];
+      const arcs = ArcSelector.selectArcsForGaps(neighbour, spiralCenter, 0, 'all');
+      if (!arcs.length) {
         continue;
       }
-      for (const k of [-1, -2, -5, -6]) {
-        const idx = ((k % neighbours.length) + neighbours.length) % neighbours.length;
-        const neighbour = neighbours[idx];
-        const arcs = ArcSelector.selectArcsForGaps(neighbour, spiralCenter, 0, 'all');
-        if (!arcs.length) {
-          continue;
-        }
-        const preference = preferenceMap.get(k.toString()) || 'start';
-        let sharedIndex = -1;
-        for (let intersectionIdx = 0; intersectionIdx < neighbour.intersections.length; intersectionIdx += 1) {
-          if (neighbour.intersections[intersectionIdx][1] === circle) {
-            sharedIndex = intersectionIdx;
-            break;
-          }
-        }
-        if (sharedIndex === -1) {
-          continue;
-        }
-        let arcIndex = -1;
-        if (preference === 'end') {
-          arcIndex = arcs.findIndex(([, endIdx]) => endIdx === sharedIndex);
-        }
-        if (arcIndex === -1) {
-          arcIndex = arcs.findIndex(([startIdx]) => startIdx === sharedIndex);
-        }
-        if (arcIndex === -1) {
-          arcIndex = 0;
+      const preference = NEIGHBOUR_ARC_PREFERENCE.get(k) || 'start';
+      let sharedIndex = -1;
+      for (let intersectionIdx = 0; intersectionIdx < neighbour.intersections.length; intersectionIdx += 1) {
+        if (neighbour.intersections[intersectionIdx][1] === circle) {
+          sharedIndex = intersectionIdx;
+          break;
         }
-        const [i, j] = arcs[arcIndex];
-        const start = neighbour.intersections[i][0];
-        const end = neighbour.intersections[j][0];
-        const steps = estimateArcSteps(neighbour, start, end);
-        const arc = new ArcElement(neighbour, start, end, steps, true);
-        group.addArc(arc);
       }
+      if (sharedIndex === -1) {
+        continue;
+      }
+      let arcIndex = -1;
+      if (preference === 'end') {
+        arcIndex = arcs.findIndex(([, endIdx]) => endIdx === sharedIndex);
+      }
+      if (arcIndex === -1) {
+        arcIndex = arcs.findIndex(([startIdx]) => startIdx === sharedIndex);
+      }
+      if (arcIndex === -1) {
+        arcIndex = 0;
+      }
+      const [i, j] = arcs[arcIndex];
+      const start = neighbour.intersections[i][0];
+      const end = neighbour.intersections[j][0];
+      const arc = new ArcElement(neighbour, start, end);
+      group.addArc(arc);
     }
   }
 
-  _finalizeRingTemplates() {
-    if (!this.arcGroups.size) {
+  /**
+   * Builds (or fetches) the shared template of each ring shape and points the
+   * groups at it. Defaults to every circle group of the engine; a ring-streamed
+   * render passes one ring's groups and `cacheTemplates: false` so templates are
+   * released with the ring instead of accumulating in RING_TEMPLATE_CACHE.
+   */
+  _finalizeRingTemplates(ringGroups = null, { cacheTemplates = true } = {}) {
+    const candidates = ringGroups
+      || Array.from(this.arcGroups.values()).filter(group => group.name.startsWith('circle_'));
+    if (!candidates.length) {
       return;
     }
     this._ringTemplates = new Map();
     const grouped = new Map();
-    for (const [key, group] of this.arcGroups.entries()) {
-      if (!key.startsWith('circle_')) {
-        continue;
-      }
+    for (const group of candidates) {
       const templateKey = group.templateKey;
       if (!templateKey) {
         continue;
@@ -3537,7 +4472,9 @@ class DoyleSpiralEngine {
         if (!template) {
           continue;
         }
-        RING_TEMPLATE_CACHE.set(cacheKey, template);
+        if (cacheTemplates) {
+          RING_TEMPLATE_CACHE.set(cacheKey, template);
+        }
       }
       this._ringTemplates.set(templateKey, template);
       for (const group of groups) {
@@ -3550,13 +4487,7 @@ class DoyleSpiralEngine {
         if (!transform) {
           continue;
         }
-        if (group._patternSegmentsCache) {
-          group._patternSegmentsCache.clear();
-        }
         group.setTemplate(template, transform, false);
-        for (let idx = 0; idx < group.arcs.length; idx += 1) {
-          group.arcs[idx].applyTemplate(template, transform, idx, { preserveCache: false });
-        }
       }
     }
   }
@@ -3566,9 +4497,10 @@ class DoyleSpiralEngine {
     addFillPattern = false,
     fillPatternSpacing = 5.0,
     fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0, // Opt-in hatch angle quantisation in degrees (0 = exact angles)
     fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
     fillPatternLoop = false,
-    arcGroupAngleOverrides = null, // Map<groupId, angles[]> — overrides preset animation per group
+    arcGroupAngleOverrides = null, // Map<group name, angles[]> or angles[] by toJSON() order — overrides preset animation per group
     redOutline = false,
     redOutlineMinRing = null,
     drawGroupOutline = true,
@@ -3593,15 +4525,18 @@ class DoyleSpiralEngine {
     this.arcGroups.clear();
     this._ringTemplates = new Map();
 
-    const highlightStrokeWidth = Number.isFinite(highlightRimWidth)
-      ? Math.max(0, highlightRimWidth)
-      : 0;
-    const outlineStrokeWidth = Number.isFinite(groupOutlineWidth)
-      ? Math.max(0, groupOutlineWidth)
-      : 0;
-    const patternStroke = Number.isFinite(patternStrokeWidth)
-      ? Math.max(0, patternStrokeWidth)
-      : 0;
+    const style = this._arramBoyleStyle(context, {
+      fillPatternSpacing,
+      fillPatternAngle,
+      fillPatternOffset,
+      fillPatternType,
+      fillPatternRectWidth,
+      drawGroupOutline,
+      highlightRimWidth,
+      groupOutlineWidth,
+      patternStrokeWidth,
+    });
+    const { outlineStrokeWidth, highlightStrokeWidth } = style;
 
     const spiralCenter = Complex.ZERO;
     const radiusToRing = this._computeRingIndices();
@@ -3651,22 +4586,12 @@ class DoyleSpiralEngine {
       baseAngle: fillPatternAngle,
       loopMode: fillPatternLoop,
     });
+    this._assignPatternAngles(this.arcGroups.values(), patternAssignments, fillPatternAngle, fillPatternAngleStep, fillPatternType);
 
-    for (const group of this.arcGroups.values()) {
-      const ringIdx = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
-      const defaultAngle = ringIdx * fillPatternAngle;
-      const assignment = patternAssignments.get(group.id) || null;
-      if (assignment) {
-        group.primaryPatternAngle = assignment.primaryAngle;
-        group.patternAngles = assignment.angles.slice();
-      } else {
-        group.primaryPatternAngle = defaultAngle;
-        group.patternAngles = [defaultAngle];
-      }
-    }
-
-    // Apply CA / external angle overrides after preset animation (overrides win)
-    // arcGroupAngleOverrides is keyed by group.name (stable across renders, e.g. "circle_2")
+    // Apply CA / external angle overrides after preset animation (overrides win).
+    // A Map is keyed by group.name, which only matches groups of this engine.
+    // An array is indexed like toJSON().arcgroups (outer closures skipped),
+    // which also matches any other render of the same parameters.
     if (arcGroupAngleOverrides instanceof Map) {
       for (const group of this.arcGroups.values()) {
         const key = group.name;
@@ -3676,79 +4601,60 @@ class DoyleSpiralEngine {
           group.primaryPatternAngle = overrideAngles.length > 0 ? overrideAngles[0] : null;
         }
       }
+    } else if (Array.isArray(arcGroupAngleOverrides)) {
+      let ordinal = 0;
+      for (const [key, group] of this.arcGroups.entries()) {
+        if (key.startsWith('outer_')) {
+          continue;
+        }
+        const overrideAngles = arcGroupAngleOverrides[ordinal];
+        ordinal += 1;
+        if (Array.isArray(overrideAngles)) {
+          group.patternAngles = overrideAngles;
+          group.primaryPatternAngle = overrideAngles.length > 0 ? overrideAngles[0] : null;
+        }
+      }
     }
 
-    const scaleFactor = context.scaleFactor;
-    const invScale = scaleFactor > 1e-9 ? 1 / scaleFactor : 0;
-    const spacingInternal = Math.max(0, fillPatternSpacing);
-    const offsetInternal = Math.max(0, fillPatternOffset);
-    const rectWidthInternal = Math.max(0, fillPatternRectWidth);
-    const spacingForGroups = invScale > 0 ? spacingInternal * invScale : 0;
-    const offsetForGroups = invScale > 0 ? offsetInternal * invScale : 0;
-    const rectWidthForGroups = invScale > 0 ? rectWidthInternal * invScale : 0;
-
     const ringIndices = Array.from(this.arcGroups.values())
       .filter(group => group.ringIndex !== null && group.ringIndex !== undefined)
       .map(group => group.ringIndex);
     const maxIndex = ringIndices.length ? Math.max(...ringIndices) : null;
     const minIndex = ringIndices.length ? Math.min(...ringIndices) : 0;
 
-    const numLayers = Math.max(1, Math.floor(svgLayerCount));
+    const layout = { enabled: svgLayers, count: Math.max(1, Math.floor(svgLayerCount)), minIndex, maxIndex };
     if (svgLayers) {
-      context.enableLayers(numLayers);
+      context.enableLayers(layout.count);
     }
 
-    const getRingLayerIndex = (ringIdx) => {
-      if (!svgLayers || maxIndex === null || maxIndex <= minIndex) return -1;
-      const span = maxIndex - minIndex;
-      return Math.min(numLayers - 1, Math.floor((ringIdx - minIndex) / span * numLayers));
-    };
-
     if (debugGroups) {
       for (const [key, group] of this.arcGroups.entries()) {
         if (key.startsWith('outer_')) {
           continue;
         }
-        context.setActiveLayer(getRingLayerIndex(group.ringIndex ?? 0));
-        group.toSVGFill(context, {
-          debug: true,
-          fillOpacity: 0.25,
-          outlineStrokeWidth: outlineStrokeWidth,
-        });
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawDebugFill(group, context, style);
       }
     }
 
     if (addFillPattern) {
       for (const [key, group] of this.arcGroups.entries()) {
         if (key.startsWith('outer_')) continue;
-        const ringIdx = group.ringIndex ?? 0;
-        const angle = Number.isFinite(group.primaryPatternAngle)
-          ? group.primaryPatternAngle : ringIdx * fillPatternAngle;
-        context.setActiveLayer(getRingLayerIndex(ringIdx));
-        group.toSVGFill(context, {
-          debug: false, patternFill: true, lineSettings: [spacingInternal, angle],
-          drawOutline: drawGroupOutline, lineOffset: offsetInternal,
-          patternType: fillPatternType, rectWidth: rectWidthForGroups,
-          patternSpacingOverride: spacingForGroups, patternOffsetOverride: offsetForGroups,
-          outlineStrokeWidth, patternStrokeWidth: patternStroke,
-        });
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawPatternFill(group, context, style);
       }
     }
 
     if (svgLayers && !addFillPattern && !debugGroups && drawGroupOutline) {
       for (const [key, group] of this.arcGroups.entries()) {
         if (key.startsWith('outer_')) continue;
-        const ringIdx = group.ringIndex ?? 0;
-        context.setActiveLayer(getRingLayerIndex(ringIdx));
-        group.toSVGFill(context, {
-          debug: false, patternFill: false, drawOutline: true,
-          outlineStrokeWidth,
-        });
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawLayerOutline(group, context, style);
       }
     }
 
     if (redOutline && maxIndex !== null) {
-      context.setActiveLayer(getRingLayerIndex(maxIndex));
+      context.setActiveLayer(ringLayerIndex(maxIndex, layout));
       for (const [key, group] of this.arcGroups.entries()) {
         if (!key.startsWith('circle_')) {
           continue;
@@ -3756,16 +4662,7 @@ class DoyleSpiralEngine {
         if (group.ringIndex !== maxIndex) {
           continue;
         }
-        const highlightArcs = [];
-        for (let i = 0; i < group.arcs.length; i += 1) {
-          if (i === 3 || i === 2) {
-            highlightArcs.push(group.arcs[i]);
-          }
-        }
-        const paths = buildContinuousPathsFromArcs(highlightArcs);
-        for (const path of paths) {
-          context.drawPolyline(path, { color: '#ff0000', width: highlightStrokeWidth });
-        }
+        this._drawRimHighlight(group, context, style);
       }
     }
 
@@ -3774,14 +4671,118 @@ class DoyleSpiralEngine {
       for (const [key, group] of this.arcGroups.entries()) {
         if (!key.startsWith('circle_')) continue;
         if (!Number.isFinite(group.ringIndex) || group.ringIndex < redOutlineMinRing) continue;
-        context.setActiveLayer(getRingLayerIndex(group.ringIndex));
-        const outline = group.getClosedOutline();
-        if (!outline || outline.length < 2) continue;
-        context.drawPolyline(outline, { color: '#ff0000', width: highlightStrokeWidth });
+        context.setActiveLayer(ringLayerIndex(group.ringIndex, layout));
+        this._drawBeyondBoxOutline(group, context, style);
+      }
+    }
+  }
+
+  /**
+   * Resolves stroke widths and converts hatch spacing, offset and rectangle
+   * width from output units into geometry units for the current scale.
+   * @private
+   */
+  _arramBoyleStyle(context, {
+    fillPatternSpacing,
+    fillPatternAngle,
+    fillPatternOffset,
+    fillPatternType,
+    fillPatternRectWidth,
+    drawGroupOutline,
+    highlightRimWidth,
+    groupOutlineWidth,
+    patternStrokeWidth,
+  }) {
+    const scaleFactor = context.scaleFactor;
+    const invScale = scaleFactor > 1e-9 ? 1 / scaleFactor : 0;
+    const spacingInternal = Math.max(0, fillPatternSpacing);
+    const offsetInternal = Math.max(0, fillPatternOffset);
+    const rectWidthInternal = Math.max(0, fillPatternRectWidth);
+    return {
+      highlightStrokeWidth: Number.isFinite(highlightRimWidth) ? Math.max(0, highlightRimWidth) : 0,
+      outlineStrokeWidth: Number.isFinite(groupOutlineWidth) ? Math.max(0, groupOutlineWidth) : 0,
+      patternStroke: Number.isFinite(patternStrokeWidth) ? Math.max(0, patternStrokeWidth) : 0,
+      fillPatternAngle,
+      fillPatternType,
+      drawGroupOutline,
+      spacingInternal,
+      offsetInternal,
+      spacingForGroups: invScale > 0 ? spacingInternal * invScale : 0,
+      offsetForGroups: invScale > 0 ? offsetInternal * invScale : 0,
+      rectWidthForGroups: invScale > 0 ? rectWidthInternal * invScale : 0,
+    };
+  }
+
+  /**
+   * Stores each group's hatch angles: the preset assignment when there is one,
+   * otherwise ringIndex * fillPatternAngle.
+   * @private
+   */
+  _assignPatternAngles(groups, patternAssignments, fillPatternAngle, fillPatternAngleStep, fillPatternType = 'lines') {
+    const angleStep = Number.isFinite(fillPatternAngleStep) ? Math.max(0, fillPatternAngleStep) : 0;
+    for (const group of groups) {
+      const ringIdx = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
+      const defaultAngle = ringIdx * fillPatternAngle;
+      group.patternAngleStep = angleStep;
+      group.fillKernel = FILL_KERNELS[fillPatternType] ? fillPatternType : 'lines';
+      const assignment = patternAssignments.get(group.id) || null;
+      if (assignment) {
+        group.primaryPatternAngle = assignment.primaryAngle;
+        group.patternAngles = assignment.angles.slice();
+      } else {
+        group.primaryPatternAngle = defaultAngle;
+        group.patternAngles = [defaultAngle];
       }
     }
   }
 
+  _drawDebugFill(group, context, style) {
+    group.toSVGFill(context, {
+      debug: true,
+      fillOpacity: 0.25,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    });
+  }
+
+  _drawPatternFill(group, context, style) {
+    const ringIdx = group.ringIndex ?? 0;
+    const angle = Number.isFinite(group.primaryPatternAngle)
+      ? group.primaryPatternAngle : ringIdx * style.fillPatternAngle;
+    group.toSVGFill(context, {
+      debug: false, patternFill: true, lineSettings: [style.spacingInternal, angle],
+      drawOutline: style.drawGroupOutline, lineOffset: style.offsetInternal,
+      patternType: style.fillPatternType, rectWidth: style.rectWidthForGroups,
+      patternSpacingOverride: style.spacingForGroups, patternOffsetOverride: style.offsetForGroups,
+      outlineStrokeWidth: style.outlineStrokeWidth, patternStrokeWidth: style.patternStroke,
+    });
+  }
+
+  _drawLayerOutline(group, context, style) {
+    group.toSVGFill(context, {
+      debug: false, patternFill: false, drawOutline: true,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    });
+  }
+
+  _drawRimHighlight(group, context, style) {
+    const highlightArcs = [];
+    for (let i = 0; i < group.arcs.length; i += 1) {
+      if (i === 3 || i === 2) {
+        highlightArcs.push(group.arcs[i]);
+      }
+    }
+    const paths = buildContinuousPathsFromArcs(highlightArcs);
+    for (const path of paths) {
+      context.drawPolyline(path, { color: '#ff0000', width: style.highlightStrokeWidth });
+    }
+  }
+
+  _drawBeyondBoxOutline(group, context, style) {
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 2) return;
+    context.drawPolyline(outline, { color: '#ff0000', width: style.highlightStrokeWidth });
+  }
+
   _renderDoyle(context) {
     context.setNormalizationScale(this.circles);
     for (const circle of this.circles) {
@@ -3795,6 +4796,7 @@ class DoyleSpiralEngine {
     addFillPattern = false,
     fillPatternSpacing = 5.0,
     fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0,
     fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
     fillPatternLoop = false,
     arcGroupAngleOverrides = null,
@@ -3813,7 +4815,13 @@ class DoyleSpiralEngine {
     useSymmetric = true,
     svgLayers = false,
     svgLayerCount = 30,
+    geometryPrecision = 'float64',
+    svgPatternPreview = false,
   } = {}) {
+    if (this.p > MAX_P || this.q > MAX_Q) {
+      throw new Error(`p and q above ${MAX_P} can only be rendered with renderStream()`);
+    }
+    this.geometryPrecision = geometryPrecision;
     if (!this._generated) {
       this.generateCircles();
     }
@@ -3825,6 +4833,7 @@ class DoyleSpiralEngine {
       ? boundingBoxHeight
       : fallbackSize;
     const context = new DrawingContext(resolvedWidth, resolvedHeight, lengthUnits);
+    context.patternPreview = Boolean(svgPatternPreview);
     this.arcGroups.clear();
 
     if (mode === 'doyle') {
@@ -3837,6 +4846,7 @@ class DoyleSpiralEngine {
         addFillPattern,
         fillPatternSpacing,
         fillPatternAngle,
+        fillPatternAngleStep,
         fillPatternAnimation,
         fillPatternLoop,
         arcGroupAngleOverrides,
@@ -3863,7 +4873,261 @@ class DoyleSpiralEngine {
     throw new Error(`Unknown render mode "${mode}"`);
   }
 
-  toJSON() {
+  /**
+   * Renders the arram_boyle SVG ring by ring and hands it to `write(text)` in
+   * pieces, keeping only a few rings of circles and groups alive at a time.
+   * The concatenated output equals render('arram_boyle', options).svgString.
+   *
+   * Each SVG pass (outlines, fill, highlights, every layer) is a separate sweep
+   * over the rings, rebuilding the geometry it needs, so time grows with the
+   * number of passes while memory stays bounded. Pattern animations that need
+   * the whole spiral at once (see `ringLocal` in PATTERN_ANIMATION_DEFINITIONS)
+   * are rejected when pattern fill is on. No geometry payload is produced.
+   *
+   * @param {Function} write - Receives consecutive chunks of SVG text
+   * @param {Object} options - Same options as render()
+   * @returns {Object} { scaleFactor, circles, rings, peakLiveCircles }
+   */
+  renderStream(write, {
+    size = 800,
+    debugGroups = false,
+    addFillPattern = false,
+    fillPatternSpacing = 5.0,
+    fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0,
+    fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
+    fillPatternLoop = false,
+    redOutline = false,
+    redOutlineMinRing = null,
+    drawGroupOutline = true,
+    fillPatternOffset = 0.0,
+    fillPatternType = 'lines',
+    fillPatternRectWidth = 2.0,
+    highlightRimWidth = 1.2,
+    groupOutlineWidth = 0.6,
+    patternStrokeWidth = 0.5,
+    boundingBoxWidth = null,
+    boundingBoxHeight = null,
+    lengthUnits = '',
+    useSymmetric = true,
+    svgLayers = false,
+    svgLayerCount = 30,
+  } = {}) {
+    const animationId = normalisePatternAnimationId(fillPatternAnimation);
+    if (addFillPattern && !PATTERN_ANIMATION_DEFINITIONS[animationId].ringLocal) {
+      throw new Error(`Pattern animation "${animationId}" needs the whole spiral and cannot be ring-streamed`);
+    }
+    const fallbackSize = Number.isFinite(size) && size > 0 ? size : 800;
+    const resolvedWidth = Number.isFinite(boundingBoxWidth) && boundingBoxWidth > 0
+      ? boundingBoxWidth
+      : fallbackSize;
+    const resolvedHeight = Number.isFinite(boundingBoxHeight) && boundingBoxHeight > 0
+      ? boundingBoxHeight
+      : fallbackSize;
+    const context = new StreamingDrawingContext(write, resolvedWidth, resolvedHeight, lengthUnits);
+
+    // Circle positions only; ids are reserved so they match generateCircles().
+    const x = [];
+    const y = [];
+    const r = [];
+    this._forEachCirclePosition((center, radius) => {
+      x.push(center.re);
+      y.push(center.im);
+      r.push(radius);
+    });
+    const idBase = CIRCLE_ID;
+    CIRCLE_ID += r.length;
+    this.generateOuterCircles(r.length);
+    context.setNormalizationScaleFromOuterCircles(this.outerCircles);
+    this.fillPatternAngle = fillPatternAngle;
+    this.fillPatternAnimationId = animationId;
+    this.fillPatternSpacing = fillPatternSpacing;
+
+    const ringWindow = new RingStreamWindow(this, {
+      x: Float64Array.from(x),
+      y: Float64Array.from(y),
+      r: Float64Array.from(r),
+      idBase,
+    });
+    x.length = 0;
+    y.length = 0;
+    r.length = 0;
+    const lastRing = ringWindow.ringCount - 1;
+    const style = this._arramBoyleStyle(context, {
+      fillPatternSpacing,
+      fillPatternAngle,
+      fillPatternOffset,
+      fillPatternType,
+      fillPatternRectWidth,
+      drawGroupOutline,
+      highlightRimWidth,
+      groupOutlineWidth,
+      patternStrokeWidth,
+    });
+    const sweepOptions = {
+      symmetric: useSymmetric && this.p === this.q,
+      debugGroups,
+      context,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    };
+
+    // Survey pass: ring span of the groups (layers, rim highlight) and the
+    // largest centroid radius (radial bloom), which the in-memory render reads
+    // off the complete group list.
+    let minIndex = Infinity;
+    let maxIndex = -Infinity;
+    let maxRadius = 0;
+    let surveyed = false;
+    if (svgLayers || redOutline || addFillPattern) {
+      ringWindow.sweep(0, lastRing, groups => {
+        for (const group of groups) {
+          minIndex = Math.min(minIndex, group.ringIndex);
+          maxIndex = Math.max(maxIndex, group.ringIndex);
+          const meta = addFillPattern ? patternAnimationMeta(group) : null;
+          if (meta) {
+            maxRadius = Math.max(maxRadius, meta.radius);
+          }
+        }
+      }, { ...sweepOptions, light: !addFillPattern });
+      surveyed = true;
+      if (ringWindow.closures.some(closure => closure && closure.arcs.length)) {
+        minIndex = Math.min(minIndex, -1);
+        maxIndex = Math.max(maxIndex, -1);
+      }
+    }
+    const hasGroups = maxIndex > -Infinity;
+    const layout = {
+      enabled: svgLayers,
+      count: Math.max(1, Math.floor(svgLayerCount)),
+      minIndex: hasGroups ? minIndex : 0,
+      maxIndex: hasGroups ? maxIndex : null,
+    };
+
+    const flush = () => context.flush();
+    const ringsOf = pass => (groups, ring) => {
+      for (const group of groups) {
+        pass(group, ring);
+      }
+      context.flush();
+    };
+    const debugPass = ringsOf(group => this._drawDebugFill(group, context, style));
+    const fillPass = (groups, ring) => {
+      const metas = groups.map(patternAnimationMeta).filter(Boolean);
+      const sorted = metas.slice().sort((a, b) => a.theta - b.theta);
+      const ringContext = {
+        metaList: metas,
+        ringMap: new Map(metas.length ? [[ring, sorted]] : []),
+        sortedRings: metas.length ? [ring] : [],
+        minRing: ring,
+        maxRing: ring,
+        maxRadius: maxRadius || 1,
+      };
+      const assignments = resolvePatternAssignments(ringContext, {
+        animationId,
+        baseAngle: fillPatternAngle,
+        loopMode: fillPatternLoop,
+      });
+      this._assignPatternAngles(groups, assignments, fillPatternAngle, fillPatternAngleStep, fillPatternType);
+      ringsOf(group => this._drawPatternFill(group, context, style))(groups, ring);
+    };
+    const outlinePass = ringsOf(group => this._drawLayerOutline(group, context, style));
+    const rimPass = ringsOf(group => {
+      if (group.ringIndex === layout.maxIndex) {
+        this._drawRimHighlight(group, context, style);
+      }
+    });
+    const beyondPass = ringsOf(group => this._drawBeyondBoxOutline(group, context, style));
+    const beyondFrom = redOutline && Number.isFinite(redOutlineMinRing) && redOutlineMinRing >= 0
+      ? Math.ceil(redOutlineMinRing)
+      : null;
+
+    // The passes of _renderArramBoyle for the rings fromRing..toRing.
+    const emitRings = (fromRing, toRing) => {
+      if (fromRing > toRing) {
+        return;
+      }
+      if (debugGroups) {
+        ringWindow.sweep(fromRing, toRing, debugPass, sweepOptions);
+      }
+      if (addFillPattern) {
+        ringWindow.sweep(fromRing, toRing, fillPass, sweepOptions);
+      }
+      if (svgLayers && !addFillPattern && !debugGroups && drawGroupOutline) {
+        ringWindow.sweep(fromRing, toRing, outlinePass, sweepOptions);
+      }
+      if (redOutline && layout.maxIndex !== null && layout.maxIndex >= fromRing && layout.maxIndex <= toRing) {
+        ringWindow.sweep(layout.maxIndex, layout.maxIndex, rimPass, sweepOptions);
+      }
+      if (beyondFrom !== null) {
+        ringWindow.sweep(Math.max(fromRing, beyondFrom), toRing, beyondPass, sweepOptions);
+      }
+    };
+
+    context.open(svgLayers);
+    if (svgLayers) {
+      // Outlines and closure arcs drawn outside a layer are dropped by the
+      // in-memory render; each layer holds a contiguous run of rings.
+      for (let layer = 0; layer < layout.count; layer += 1) {
+        context.openLayer(layer);
+        let fromRing = Infinity;
+        let toRing = -Infinity;
+        for (let ring = 0; ring <= lastRing; ring += 1) {
+          if (ringLayerIndex(ring, layout) === layer) {
+            fromRing = Math.min(fromRing, ring);
+            toRing = Math.max(toRing, ring);
+          }
+        }
+        emitRings(fromRing, toRing);
+        context.closeLayer();
+      }
+    } else {
+      const inlineOutline = !addFillPattern && drawGroupOutline;
+      if (inlineOutline) {
+        ringWindow.sweep(0, lastRing, flush, { ...sweepOptions, light: true, inlineOutline: true });
+        surveyed = true;
+      }
+      if (redOutline || inlineOutline) {
+        if (!surveyed) {
+          ringWindow.sweep(lastRing, lastRing, () => {}, { ...sweepOptions, light: true });
+        }
+        for (const closure of ringWindow.closures) {
+          if (closure) {
+            this._drawOuterClosure(closure.arcs, {
+              redOutline,
+              addFillPattern,
+              drawGroupOutline,
+              context,
+              outlineStrokeWidth: style.outlineStrokeWidth,
+              highlightStrokeWidth: style.highlightStrokeWidth,
+            });
+          }
+        }
+        context.flush();
+      }
+      emitRings(0, lastRing);
+    }
+    context.close();
+    return {
+      scaleFactor: context.scaleFactor,
+      circles: ringWindow.count,
+      rings: ringWindow.ringCount,
+      peakLiveCircles: ringWindow.peakLiveCircles,
+    };
+  }
+
+  /**
+   * Serialisable geometry for the 3D viewer and API consumers.
+   *
+   * With precision 'float64' each outline is an array of [x, y] pairs. The
+   * compact modes pack every outline into one shared typed array (so a worker
+   * can transfer it as a single buffer) and store each point relative to its
+   * group's circle centre, given as `outline_origin`:
+   *   'float32' - Float32Array of interleaved offsets
+   *   'fixed'   - Int32Array of interleaved offsets in units of `outline_scale`
+   * `outline_max_error` reports the largest coordinate error introduced by the
+   * encoding, in geometry units. Use decodeOutline() to read either form.
+   */
+  toJSON(precision = this.geometryPrecision || 'float64') {
     if (!this.arcGroups.size) {
       return null;
     }
@@ -3880,12 +5144,16 @@ class DoyleSpiralEngine {
       pattern_animation: this.fillPatternAnimationId || DEFAULT_PATTERN_ANIMATION,
       fill_pattern_spacing: this.fillPatternSpacing ?? 9,
     };
+    const compact = precision === 'float32' || precision === 'fixed';
+    const outlines = [];
+    let totalCoords = 0;
     for (const [key, group] of this.arcGroups.entries()) {
       if (key.startsWith('outer_')) {
         continue;
       }
       const outline = group.getClosedOutline();
-      const outlinePoints = outline.map(pt => [pt.re, pt.im]);
+      outlines.push(outline);
+      totalCoords += outline.length * 2;
       const ringIdx = group.ringIndex ?? 0;
       const fallbackAngle = ringIdx * this.fillPatternAngle;
       const patternAngles = Array.isArray(group.patternAngles) && group.patternAngles.length
@@ -3894,20 +5162,93 @@ class DoyleSpiralEngine {
       const primaryAngle = Number.isFinite(group.primaryPatternAngle)
         ? group.primaryPatternAngle
         : patternAngles[0];
-      exportData.arcgroups.push({
+      const entry = {
         id: group.id,
         name: group.name,
         ring_index: group.ringIndex,
         line_angle: normaliseAngle360(primaryAngle),
         line_patterns: patternAngles.map(angle => normaliseAngle360(angle)),
-        outline: outlinePoints,
+        outline: compact ? null : outline.map(pt => [pt.re, pt.im]),
         arc_count: group.arcs.length,
-      });
+      };
+      if (compact) {
+        const origin = group.baseCircle?.center || group.arcs[0]?.circle?.center || Complex.ZERO;
+        entry.outline_origin = [origin.re, origin.im];
+      }
+      exportData.arcgroups.push(entry);
+    }
+    if (compact) {
+      exportData.outline_precision = precision;
+      exportData.outline_max_error = packOutlines(exportData.arcgroups, outlines, totalCoords, precision);
     }
     return exportData;
   }
 }
 
+/**
+ * Fills the `outline` (and for fixed-point, `outline_scale`) of each group
+ * entry with views into one shared typed array. Returns the largest absolute
+ * coordinate error of the encoding.
+ */
+function packOutlines(entries, outlines, totalCoords, precision) {
+  const packed = precision === 'fixed' ? new Int32Array(totalCoords) : new Float32Array(totalCoords);
+  let maxError = 0;
+  let offset = 0;
+  for (let idx = 0; idx < entries.length; idx += 1) {
+    const entry = entries[idx];
+    const outline = outlines[idx];
+    const [ox, oy] = entry.outline_origin;
+    const view = packed.subarray(offset, offset + outline.length * 2);
+    let scale = 1;
+    if (precision === 'fixed') {
+      let extent = 0;
+      for (const pt of outline) {
+        extent = Math.max(extent, Math.abs(pt.re - ox), Math.abs(pt.im - oy));
+      }
+      scale = extent > 0 ? extent / FIXED_POINT_RANGE : 1;
+      entry.outline_scale = scale;
+    }
+    for (let i = 0; i < outline.length; i += 1) {
+      const dx = outline[i].re - ox;
+      const dy = outline[i].im - oy;
+      view[i * 2] = precision === 'fixed' ? Math.round(dx / scale) : dx;
+      view[i * 2 + 1] = precision === 'fixed' ? Math.round(dy / scale) : dy;
+      maxError = Math.max(
+        maxError,
+        Math.abs(ox + view[i * 2] * scale - outline[i].re),
+        Math.abs(oy + view[i * 2 + 1] * scale - outline[i].im),
+      );
+    }
+    entry.outline = view;
+    offset += outline.length * 2;
+  }
+  return maxError;
+}
+
+/**
+ * Returns a geometry group's outline as [x, y] pairs regardless of the
+ * precision it was encoded with.
+ *
+ * @param {Object} group - entry of geometry.arcgroups
+ * @returns {Array<[number, number]>}
+ */
+function decodeOutline(group) {
+  const outline = group?.outline;
+  if (!outline) {
+    return [];
+  }
+  if (!ArrayBuffer.isView(outline)) {
+    return outline;
+  }
+  const [ox, oy] = group.outline_origin || [0, 0];
+  const scale = group.outline_scale ?? 1;
+  const points = new Array(outline.length >> 1);
+  for (let i = 0; i < points.length; i += 1) {
+    points[i] = [ox + outline[i * 2] * scale, oy + outline[i * 2 + 1] * scale];
+  }
+  return points;
+}
+
 // ------------------------------------------------------------
 // High level helpers
 // ------------------------------------------------------------
@@ -3927,13 +5268,16 @@ class DoyleSpiralEngine {
  * @param {boolean} [params.add_fill_pattern] - Whether to add pattern fills
  * @param {boolean} [params.draw_group_outline] - Whether to draw group outlines
  * @param {boolean} [params.use_symmetric] - Enable symmetric optimization for p==q
+ * @param {number} [params.fill_pattern_angle_step] - Snap hatch angles relative to each ring template to this step in degrees (0 = off)
+ * @param {string} [params.geometry_precision] - Outline encoding in the geometry payload ('float64', 'float32' or 'fixed')
+ * @param {boolean} [params.svg_pattern_preview] - Fill hatches with SVG <pattern>s instead of line segments (preview only)
  * @returns {Object} Normalized parameters with all defaults applied
  */
 function normaliseParams(params = {}) {
   const patternTypeRaw = typeof params.fill_pattern_type === 'string'
     ? params.fill_pattern_type.toLowerCase()
     : 'lines';
-  const fillPatternType = patternTypeRaw === 'rectangles' ? 'rectangles' : 'lines';
+  const fillPatternType = FILL_PATTERN_TYPES.includes(patternTypeRaw) ? patternTypeRaw : 'lines';
   const spacingRaw = Number(params.fill_pattern_spacing ?? 8);
   const offsetRaw = Number(params.fill_pattern_offset ?? 0);
   const rectWidthValue = Number(params.fill_pattern_rect_width ?? 2);
@@ -3966,6 +5310,7 @@ function normaliseParams(params = {}) {
     add_fill_pattern: Boolean(params.add_fill_pattern ?? false),
     fill_pattern_spacing: fillPatternSpacing,
     fill_pattern_angle: Number(params.fill_pattern_angle ?? 0),
+    fill_pattern_angle_step: Number.isFinite(Number(params.fill_pattern_angle_step)) ? Math.max(0, Number(params.fill_pattern_angle_step)) : 0,
     fill_pattern_offset: fillPatternOffset,
     fill_pattern_type: fillPatternType,
     fill_pattern_rect_width: rectWidthMm,
@@ -3983,40 +5328,22 @@ function normaliseParams(params = {}) {
     use_symmetric: params.use_symmetric !== undefined ? Boolean(params.use_symmetric) : true,
     svg_layers: Boolean(params.svg_layers ?? false),
     svg_layer_count: Number.isFinite(Number(params.svg_layer_count)) ? Math.max(1, Math.floor(Number(params.svg_layer_count))) : 30,
+    geometry_precision: GEOMETRY_PRECISIONS.includes(params.geometry_precision) ? params.geometry_precision : 'float64',
+    svg_pattern_preview: Boolean(params.svg_pattern_preview ?? false),
   };
 }
 
 /**
- * High-level function to render a Doyle spiral with the specified parameters.
- * This is the main entry point for generating spiral SVGs.
- *
- * @param {Object} params - Rendering parameters (will be normalized)
- * @param {number} params.p - First spiral parameter (default: 16)
- * @param {number} params.q - Second spiral parameter (default: 16)
- * @param {number} params.t - Time/evolution parameter (default: 0)
- * @param {number} params.max_d - Maximum distance for circle generation (default: 2000)
- * @param {string} params.mode - Rendering mode: 'arram_boyle' or 'classic'
- * @param {number} params.size - Canvas size in pixels (default: 800)
- * @param {number} params.bounding_box_width_mm - Bounding box width in mm (default: 200)
- * @param {number} params.bounding_box_height_mm - Bounding box height in mm (default: 200)
- * @param {string|null} overrideMode - Optional mode override
- * @returns {Object} Result object containing engine, svg, geometry, and metadata
- * @throws {Error} If parameters are invalid or generation exceeds limits
+ * Maps normalised (snake_case) parameters onto render() options.
  */
-function renderSpiral(params = {}, overrideMode = null) {
-  const opts = normaliseParams(params);
-  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
-    maxDistance: opts.max_d,
-    arcMode: opts.arc_mode,
-    numGaps: opts.num_gaps,
-  });
-  const mode = overrideMode || opts.mode;
-  const result = engine.render(mode, {
+function renderOptionsFromParams(opts) {
+  return {
     size: opts.size,
     debugGroups: opts.debug_groups,
     addFillPattern: opts.add_fill_pattern,
     fillPatternSpacing: opts.fill_pattern_spacing,
     fillPatternAngle: opts.fill_pattern_angle,
+    fillPatternAngleStep: opts.fill_pattern_angle_step,
     redOutline: opts.red_outline,
     redOutlineMinRing: opts.red_outline_min_ring,
     drawGroupOutline: opts.draw_group_outline,
@@ -4034,7 +5361,43 @@ function renderSpiral(params = {}, overrideMode = null) {
     useSymmetric: opts.use_symmetric,
     svgLayers: opts.svg_layers ?? false,
     svgLayerCount: opts.svg_layer_count ?? 30,
+    geometryPrecision: opts.geometry_precision,
+    svgPatternPreview: opts.svg_pattern_preview,
+  };
+}
+
+/**
+ * High-level function to render a Doyle spiral with the specified parameters.
+ * This is the main entry point for generating spiral SVGs.
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @param {number} params.p - First spiral parameter (default: 16)
+ * @param {number} params.q - Second spiral parameter (default: 16)
+ * @param {number} params.t - Time/evolution parameter (default: 0)
+ * @param {number} params.max_d - Maximum distance for circle generation (default: 2000)
+ * @param {string} params.mode - Rendering mode: 'arram_boyle' or 'classic'
+ * @param {number} params.size - Canvas size in pixels (default: 800)
+ * @param {number} params.bounding_box_width_mm - Bounding box width in mm (default: 200)
+ * @param {number} params.bounding_box_height_mm - Bounding box height in mm (default: 200)
+ * @param {string|null} overrideMode - Optional mode override
+ * @param {Object} [options]
+ * @param {Map|Array|null} [options.arcGroupAngleOverrides] - Per-group hatch angles (see render())
+ * @returns {Object} Result object containing engine, svg, geometry, and metadata
+ * @throws {Error} If parameters are invalid or generation exceeds limits
+ */
+function renderSpiral(params = {}, overrideMode = null, { arcGroupAngleOverrides = null } = {}) {
+  const opts = normaliseParams(params);
+  resetGeometryStats();
+  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
+    maxDistance: opts.max_d,
+    arcMode: opts.arc_mode,
+    numGaps: opts.num_gaps,
   });
+  const mode = overrideMode || opts.mode;
+  const result = engine.render(mode, { ...renderOptionsFromParams(opts), arcGroupAngleOverrides });
+  countOutlineJoins(engine.arcGroups);
+  GEOMETRY_STATS.hatchRimDeviationMm = GEOMETRY_STATS.hatchRimDeviation * (result.scaleFactor || 1);
+  const geometryStats = getGeometryStats();
   return {
     engine,
     mode,
@@ -4043,9 +5406,49 @@ function renderSpiral(params = {}, overrideMode = null) {
     geometry: result.geometry,
     params: opts,
     scaleFactor: result.scaleFactor || 1,
+    geometryStats,
   };
 }
 
+/**
+ * Ring-streamed counterpart of renderSpiral() for large posters: writes the
+ * arram_boyle SVG to `write` in chunks while holding only a few rings in
+ * memory, and accepts p and q up to MAX_STREAM_P / MAX_STREAM_Q. The chunks
+ * concatenate to renderSpiral(params).svgString. See renderStream() for what
+ * cannot be streamed.
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @param {Function} write - Receives consecutive chunks of SVG text
+ * @returns {Object} { scaleFactor, circles, rings, peakLiveCircles, params }
+ */
+function renderSpiralStream(params = {}, write) {
+  const opts = normaliseParams(params);
+  resetGeometryStats();
+  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
+    maxDistance: opts.max_d,
+    arcMode: opts.arc_mode,
+    numGaps: opts.num_gaps,
+    streaming: true,
+  });
+  const result = engine.renderStream(write, renderOptionsFromParams(opts));
+  return { ...result, params: opts };
+}
+
+/**
+ * Whether renderSpiralStream() accepts `params`: fill patterns stream only
+ * with ring-local animations (see renderStream()).
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @returns {boolean}
+ */
+function canRenderSpiralStream(params = {}) {
+  const opts = normaliseParams(params);
+  if (!opts.add_fill_pattern) {
+    return true;
+  }
+  return Boolean(PATTERN_ANIMATION_DEFINITIONS[opts.fill_pattern_animation].ringLocal);
+}
+
 function computeGeometry(params = {}) {
   return renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
 }
@@ -4057,9 +5460,19 @@ export {
   CircleElement,
   DoyleSpiralEngine,
   renderSpiral,
+  renderSpiralStream,
+  canRenderSpiralStream,
   computeGeometry,
   normaliseParams,
   buildPatternAnimationContext,
+  buildPatternAnimationContextFromGeometry,
   buildContinuousPathsFromArcs,
   generatePresetAnimationFrames,
+  linesInPolygon,
+  insetPolygon,
+  fillPatternPolylines,
+  FILL_PATTERN_TYPES,
+  getGeometryStats,
+  resetGeometryStats,
+  decodeOutline,
 };
@@ -39,16 +39,18 @@ function lwPolyline(pts, layer, closed) {
 }
 
 /**
+ * Writes the DXF for a whole render to `write` one entity at a time, so a
+ * server can stream it without holding the file. The chunks concatenate to
+ * generateDXF() with the same arguments.
+ *
  * @param {Map<string, ArcGroup>} arcGroups    - from engine.arcGroups
  * @param {number} scaleFactor                 - mm per internal unit (from render result)
  * @param {number} boundingWidthMm             - output width in mm
  * @param {number} boundingHeightMm            - output height in mm
- * @param {Object} [opts]
- * @param {boolean} [opts.drawGroupOutline=true]  - export spiral outlines
- * @param {boolean} [opts.redOutline=false]       - export highlight rim arcs
- * @returns {string} DXF file contents
+ * @param {Object} opts                        - as for generateDXF()
+ * @param {(text: string) => void} write       - receives consecutive chunks
  */
-export function generateDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts = {}) {
+export function writeDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts, write) {
   const drawGroupOutline = opts.drawGroupOutline !== false;
   const redOutline = Boolean(opts.redOutline);
 
@@ -101,13 +103,15 @@ export function generateDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHei
 
   // ── ENTITIES ────────────────────────────────────────────────────────────
   lines.push('  0', 'SECTION', '  2', 'ENTITIES');
+  write(lines.join('\n'));
 
+  // Every later chunk starts with the newline that joins it to the previous one.
   if (needSpirals) {
     for (const [key, group] of arcGroups.entries()) {
       if (key.startsWith('outer_')) continue;
       const outline = group.getClosedOutline();
       if (!outline || outline.length < 2) continue;
-      lines.push(...lwPolyline(outline.map(pt => ptToMm(pt.re, pt.im)), 'SPIRALS', true));
+      write(`\n${lwPolyline(outline.map(pt => ptToMm(pt.re, pt.im)), 'SPIRALS', true).join('\n')}`);
     }
   }
 
@@ -117,12 +121,27 @@ export function generateDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHei
       const pts = path.map(pt => ptToMm(pt.re, pt.im));
       const closed = Math.abs(pts[0].x - pts[pts.length - 1].x) < 1e-4
                   && Math.abs(pts[0].y - pts[pts.length - 1].y) < 1e-4;
-      lines.push(...lwPolyline(pts, 'HIGHLIGHT', closed));
+      write(`\n${lwPolyline(pts, 'HIGHLIGHT', closed).join('\n')}`);
     }
   }
 
-  lines.push('  0', 'ENDSEC', '  0', 'EOF');
-  return lines.join('\n');
+  write('\n  0\nENDSEC\n  0\nEOF');
+}
+
+/**
+ * @param {Map<string, ArcGroup>} arcGroups    - from engine.arcGroups
+ * @param {number} scaleFactor                 - mm per internal unit (from render result)
+ * @param {number} boundingWidthMm             - output width in mm
+ * @param {number} boundingHeightMm            - output height in mm
+ * @param {Object} [opts]
+ * @param {boolean} [opts.drawGroupOutline=true]  - export spiral outlines
+ * @param {boolean} [opts.redOutline=false]       - export highlight rim arcs
+ * @returns {string} DXF file contents
+ */
+export function generateDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts = {}) {
+  const chunks = [];
+  writeDXF(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts, text => chunks.push(text));
+  return chunks.join('');
 }
 
 /**
@@ -0,0 +1,250 @@
+/**
+ * Idle-time export precomputation.
+ *
+ * Once a render settles, the DXF and STEP files for it are built in a worker
+ * (export_worker.js) while the browser is idle and kept as Blobs, so the
+ * download buttons only have to hand out a finished file. A new render
+ * invalidates the cache and cancels any precompute still in flight.
+ *
+ * writeExportFile() is the single place the single-file DXF/STEP exports are
+ * generated; app.js uses it (through buildExportFile()) for the fallback path
+ * when no precomputed Blob matches, the worker uses it to fill the cache and
+ * the render service streams it from /api/spiral/export, so all three give
+ * identical files.
+ *
+ * The worker also runs the pre-export validation (export_validation.js) on the
+ * same geometry and reports it before the first file.
+ */
+
+import { renderSpiral } from './doyle_spiral_engine.js';
+import { writeDXF } from './dxf_export.js';
+import { writeSTEP } from './step_export.js';
+
+export const PRECOMPUTE_FORMATS = ['dxf', 'step'];
+
+export const EXPORT_MIME_TYPES = {
+  dxf: 'application/dxf',
+  step: 'application/step',
+};
+
+// Longest the scheduler waits for an idle period before starting anyway.
+const IDLE_TIMEOUT_MS = 2000;
+
+/**
+ * Renders the arram_boyle geometry an export needs.
+ *
+ * @param {Object} params
+ * @param {{arcGroupAngleOverrides?: Object}} [options] - as for renderSpiral()
+ * @returns {{engine: Object, scaleFactor: number}}
+ */
+export function renderExportGeometry(params, { arcGroupAngleOverrides = null } = {}) {
+  const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle', { arcGroupAngleOverrides });
+  if (!result || !result.engine || !result.engine.arcGroups) {
+    throw new Error('could not generate geometry');
+  }
+  return { engine: result.engine, scaleFactor: result.scaleFactor };
+}
+
+/**
+ * Writes one single-file export to `write` in chunks; the render service
+ * streams these straight into the HTTP response.
+ *
+ * @param {{engine: Object, scaleFactor: number}} geometry
+ * @param {Object} params - normalised spiral parameters
+ * @param {'dxf'|'step'} format
+ * @param {Object} options - as for buildExportFile()
+ * @param {(text: string) => void} write
+ * @returns {boolean} false when there was nothing to export (STEP without outlines)
+ */
+export function writeExportFile({ engine, scaleFactor }, params, format, { stepThickness = 1, name = 'doyle-spiral' } = {}, write) {
+  const bbW = params.bounding_box_width_mm || 250;
+  const bbH = params.bounding_box_height_mm || 250;
+  if (format === 'dxf') {
+    writeDXF(engine.arcGroups, scaleFactor ?? 1, bbW, bbH, {
+      drawGroupOutline: false,
+      redOutline: true,
+    }, write);
+    return true;
+  }
+  if (format === 'step') {
+    return writeSTEP(engine.arcGroups, scaleFactor ?? 1, bbW, bbH, {
+      drawGroupOutline: params.draw_group_outline !== false,
+      thickness: Math.max(0.01, Number(stepThickness) || 1),
+      name,
+    }, write);
+  }
+  throw new Error(`Unknown export format "${format}"`);
+}
+
+/**
+ * Generates one single-file export as text.
+ *
+ * @param {{engine: Object, scaleFactor: number}} geometry
+ * @param {Object} params - normalised spiral parameters
+ * @param {'dxf'|'step'} format
+ * @param {Object} [options]
+ * @param {number} [options.stepThickness=1] - STEP extrusion thickness in mm
+ * @param {string} [options.name='doyle-spiral'] - STEP product name
+ * @returns {string|null} null when a STEP export has no outlines
+ */
+export function buildExportFile(geometry, params, format, options = {}) {
+  const chunks = [];
+  return writeExportFile(geometry, params, format, options, text => chunks.push(text)) ? chunks.join('') : null;
+}
+
+/**
+ * Identifies what a precomputed file was built from. Any change to the spiral
+ * parameters or the export options gives a different key.
+ */
+export function exportRequestKey(params, format, options = {}) {
+  const sorted = Object.keys(params).sort().map(key => [key, params[key]]);
+  let extra = [];
+  if (format === 'step') {
+    extra = [Math.max(0.01, Number(options.stepThickness) || 1), options.name ?? 'doyle-spiral'];
+  } else if (format === 'validation') {
+    extra = [options.beamWidth ?? null];
+  }
+  return JSON.stringify([format, sorted, extra]);
+}
+
+/**
+ * Schedules precomputation in a worker and holds the finished Blobs.
+ *
+ * @param {Object} hooks
+ * @param {() => Worker} hooks.createWorker
+ * @param {(cb: Function, opts: Object) => any} [hooks.requestIdle]
+ * @param {(handle: any) => void} [hooks.cancelIdle]
+ * @param {(report: Object) => void} [hooks.onValidation] - called with each validation report
+ */
+export class ExportPrecompute {
+  constructor({ createWorker, requestIdle = null, cancelIdle = null, onValidation = null }) {
+    this.createWorker = createWorker;
+    this.onValidation = onValidation;
+    this.requestIdle = requestIdle
+      || (typeof requestIdleCallback === 'function'
+        ? (cb, opts) => requestIdleCallback(cb, opts)
+        : cb => setTimeout(cb, 200));
+    this.cancelIdle = cancelIdle
+      || (typeof cancelIdleCallback === 'function' ? handle => cancelIdleCallback(handle) : handle => clearTimeout(handle));
+    this.blobs = new Map();
+    this.validation = null;
+    this.worker = null;
+    this.idleHandle = null;
+    this.requestId = 0;
+    this.pending = new Map();
+  }
+
+  /**
+   * Drops every cached file and cancels scheduled or running work.
+   */
+  invalidate() {
+    this.requestId += 1;
+    if (this.idleHandle !== null) {
+      this.cancelIdle(this.idleHandle);
+      this.idleHandle = null;
+    }
+    if (this.worker) {
+      this.worker.terminate();
+      this.worker = null;
+    }
+    this.blobs.clear();
+    this.validation = null;
+    this.pending.clear();
+  }
+
+  /**
+   * Replaces the cache with files for `params`, built the next time the
+   * browser is idle.
+   */
+  schedule(params, formats = PRECOMPUTE_FORMATS, options = {}) {
+    this.invalidate();
+    const requestId = this.requestId;
+    const wanted = formats.filter(format => PRECOMPUTE_FORMATS.includes(format));
+    if (!wanted.length) {
+      return;
+    }
+    for (const format of wanted) {
+      this.pending.set(format, exportRequestKey(params, format, options));
+    }
+    this.idleHandle = this.requestIdle(() => {
+      this.idleHandle = null;
+      if (requestId !== this.requestId) {
+        return;
+      }
+      this._start(requestId, params, wanted, options, exportRequestKey(params, 'validation', options));
+    }, { timeout: IDLE_TIMEOUT_MS });
+  }
+
+  _start(requestId, params, formats, options, validationKey) {
+    const worker = this.createWorker();
+    this.worker = worker;
+    const finish = () => {
+      if (this.worker === worker) {
+        worker.terminate();
+        this.worker = null;
+      }
+    };
+    worker.onmessage = event => {
+      const data = event.data || {};
+      if (data.requestId !== requestId || requestId !== this.requestId) {
+        return;
+      }
+      if (data.type === 'validation') {
+        this.validation = { key: validationKey, report: data.report };
+        this.onValidation?.(data.report);
+        return;
+      }
+      if (data.type === 'file') {
+        const key = this.pending.get(data.format);
+        if (key) {
+          this.pending.delete(data.format);
+          this.blobs.set(data.format, {
+            key,
+            blob: new Blob([data.bytes], { type: EXPORT_MIME_TYPES[data.format] }),
+          });
+        }
+        return;
+      }
+      // 'done' or 'error': a failed precompute leaves the click path to
+      // generate (and report) the file itself.
+      this.pending.clear();
+      finish();
+    };
+    worker.onerror = () => {
+      this.pending.clear();
+      finish();
+    };
+    worker.postMessage({ type: 'precompute', requestId, params, formats, options, validate: true });
+  }
+
+  /**
+   * Returns the precomputed Blob for this export, or null if it is not ready
+   * or was built for different parameters.
+   */
+  get(params, format, options = {}) {
+    const entry = this.blobs.get(format);
+    if (!entry || entry.key !== exportRequestKey(params, format, options)) {
+      return null;
+    }
+    return entry.blob;
+  }
+
+  /**
+   * Returns the validation report for this export, or null if it is not
+   * ready or was made for different parameters or beam width.
+   */
+  getValidation(params, options = {}) {
+    const entry = this.validation;
+    if (!entry || entry.key !== exportRequestKey(params, 'validation', options)) {
+      return null;
+    }
+    return entry.report;
+  }
+
+  /**
+   * True while a file for this export is still being built.
+   */
+  isPending(params, format, options = {}) {
+    return this.pending.get(format) === exportRequestKey(params, format, options);
+  }
+}
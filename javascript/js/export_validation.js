@@ -0,0 +1,400 @@
+/**
+ * Pre-export validation.
+ *
+ * Checks the paths an export is about to write (the same millimetre paths the
+ * G-code export collects, so every format is judged on identical geometry)
+ * for problems that only show up at the machine:
+ *
+ *   openOutline            – a group outline whose end does not meet its start
+ *   selfIntersection       – an outline that crosses itself
+ *   insetSelfIntersection  – the hatch inset polygon (insetPolygon) crosses itself
+ *   featureWidth           – a piece or hatch rectangle narrower than the beam
+ *   duplicateSegment       – the same segment cut twice
+ *   outOfBounds            – geometry outside the workpiece bounding box
+ *
+ * Self-intersection uses a sweep over the edges sorted by x, so each edge is
+ * only tested against edges whose x-range it overlaps. Duplicates are found
+ * with a spatial hash of segment midpoints. Both stay close to linear in the
+ * number of segments, which keeps a 100k-group design well under the time
+ * the export itself takes.
+ *
+ * Issues carry a location in export millimetres (origin bottom-left, y up);
+ * previewPoint() maps it back to the preview SVG.
+ */
+
+import { insetPolygon } from './doyle_spiral_engine.js';
+import { collectGCodeLayers } from './gcode_export.js';
+
+export const VALIDATION_CHECKS = [
+  'openOutline',
+  'selfIntersection',
+  'insetSelfIntersection',
+  'featureWidth',
+  'duplicateSegment',
+  'outOfBounds',
+];
+
+const DEFAULT_BEAM_WIDTH_MM = 0.1;
+const DEFAULT_TOLERANCE_MM = 0.001;
+const DEFAULT_MAX_ISSUES = 500;
+
+// Edge bounds for polygonSelfIntersection, grown as needed and reused.
+let sweepScratch = {
+  minX: new Float64Array(256),
+  maxX: new Float64Array(256),
+  minY: new Float64Array(256),
+  maxY: new Float64Array(256),
+};
+
+function cross(ax, ay, bx, by, cx, cy) {
+  return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+/**
+ * Crossing point of segments p1-p2 and p3-p4 when they cross properly
+ * (touching end points do not count), otherwise null.
+ */
+function properCrossing(p1, p2, p3, p4, eps) {
+  const d1 = cross(p3.x, p3.y, p4.x, p4.y, p1.x, p1.y);
+  const d2 = cross(p3.x, p3.y, p4.x, p4.y, p2.x, p2.y);
+  const d3 = cross(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y);
+  const d4 = cross(p1.x, p1.y, p2.x, p2.y, p4.x, p4.y);
+  if (!(((d1 > eps && d2 < -eps) || (d1 < -eps && d2 > eps))
+    && ((d3 > eps && d4 < -eps) || (d3 < -eps && d4 > eps)))) {
+    return null;
+  }
+  const t = d1 / (d1 - d2);
+  return { x: p1.x + (p2.x - p1.x) * t, y: p1.y + (p2.y - p1.y) * t };
+}
+
+/**
+ * First crossing between two non-adjacent edges of a closed polygon, found by
+ * sweeping the edges in order of their left end. Returns null when the
+ * polygon is simple.
+ */
+export function polygonSelfIntersection(points, tolerance = DEFAULT_TOLERANCE_MM) {
+  const n = points.length;
+  if (n < 4) {
+    return null;
+  }
+  if (sweepScratch.minX.length < n) {
+    const size = Math.max(n, sweepScratch.minX.length * 2);
+    sweepScratch = {
+      minX: new Float64Array(size),
+      maxX: new Float64Array(size),
+      minY: new Float64Array(size),
+      maxY: new Float64Array(size),
+    };
+  }
+  const { minX, maxX, minY, maxY } = sweepScratch;
+  const order = new Array(n);
+  let extent = 0;
+  for (let i = 0; i < n; i += 1) {
+    const a = points[i];
+    const b = points[i + 1 === n ? 0 : i + 1];
+    minX[i] = a.x < b.x ? a.x : b.x;
+    maxX[i] = a.x < b.x ? b.x : a.x;
+    minY[i] = a.y < b.y ? a.y : b.y;
+    maxY[i] = a.y < b.y ? b.y : a.y;
+    extent = Math.max(extent, Math.abs(a.x), Math.abs(a.y));
+    order[i] = i;
+  }
+  // Cross products scale with length squared; keep the test relative.
+  const eps = tolerance * tolerance * 1e-3 + extent * extent * 1e-14;
+  // Outlines run along arcs, so the edge order is a few monotone runs that
+  // the sort merges in close to linear time.
+  order.sort((i, j) => minX[i] - minX[j]);
+  const active = [];
+  for (let k = 0; k < n; k += 1) {
+    const i = order[k];
+    const left = minX[i];
+    let kept = 0;
+    for (let m = 0; m < active.length; m += 1) {
+      const j = active[m];
+      if (maxX[j] < left) continue;
+      active[kept++] = j;
+      const gap = i > j ? i - j : j - i;
+      if (gap <= 1 || gap === n - 1 || maxY[j] < minY[i] || maxY[i] < minY[j]) {
+        continue;
+      }
+      const hit = properCrossing(points[i], points[(i + 1) % n], points[j], points[(j + 1) % n], eps);
+      if (hit) {
+        return hit;
+      }
+    }
+    active.length = kept;
+    active.push(i);
+  }
+  return null;
+}
+
+/**
+ * Mean width of a closed polygon, 2 * area / perimeter: exact for a strip,
+ * the radius for a disc, so round pieces read on the narrow side.
+ */
+function meanWidth(points) {
+  let area = 0;
+  let perimeter = 0;
+  for (let i = 0, j = points.length - 1; i < points.length; j = i, i += 1) {
+    area += points[j].x * points[i].y - points[i].x * points[j].y;
+    perimeter += Math.hypot(points[i].x - points[j].x, points[i].y - points[j].y);
+  }
+  return perimeter > 0 ? Math.abs(area) / perimeter : 0;
+}
+
+function centroid(points) {
+  let x = 0;
+  let y = 0;
+  for (const p of points) {
+    x += p.x;
+    y += p.y;
+  }
+  return { x: x / points.length, y: y / points.length };
+}
+
+/**
+ * Validates the geometry of one export.
+ *
+ * @param {{engine: Object, scaleFactor: number}} geometry
+ * @param {Object} params - normalised spiral parameters
+ * @param {Object} [options]
+ * @param {number} [options.beamWidth=0.1]    - kerf / beam width in mm
+ * @param {number} [options.tolerance=0.001]  - distance in mm below which points coincide
+ * @param {number} [options.maxIssues=500]    - issues listed with a location (counts stay exact)
+ * @returns {{ok: boolean, counts: Object, issues: Array, truncated: boolean,
+ *   sharedOutlineSegments: number, retracedOutlineSegments: number, segments: number,
+ *   bounds: {width: number, height: number}}}
+ */
+export function validateExportGeometry({ engine, scaleFactor }, params, {
+  beamWidth = DEFAULT_BEAM_WIDTH_MM,
+  tolerance = DEFAULT_TOLERANCE_MM,
+  maxIssues = DEFAULT_MAX_ISSUES,
+} = {}) {
+  const sf = Number.isFinite(scaleFactor) && scaleFactor > 0 ? scaleFactor : 1;
+  const bbW = params.bounding_box_width_mm || 250;
+  const bbH = params.bounding_box_height_mm || 250;
+  const beam = Math.max(0, Number(beamWidth) || 0);
+  const tol = Math.max(1e-9, Number(tolerance) || DEFAULT_TOLERANCE_MM);
+  const offsetMm = Math.max(0, Number(params.fill_pattern_offset ?? 0));
+  const rectangles = params.fill_pattern_type === 'rectangles';
+
+  const counts = Object.fromEntries(VALIDATION_CHECKS.map(check => [check, 0]));
+  const issues = [];
+  const report = (check, group, point, message) => {
+    counts[check] += 1;
+    if (issues.length < maxIssues) {
+      issues.push({ check, group: group ?? null, x: point.x, y: point.y, message });
+    }
+  };
+
+  // Closure is lost once the outline is written as a closed polyline, so it
+  // is read from the group itself.
+  for (const [key, group] of engine.arcGroups.entries()) {
+    if (key.startsWith('outer_')) continue;
+    const outline = group.getClosedOutline();
+    if (outline.length < 3) continue;
+    const first = outline[0];
+    const last = outline[outline.length - 1];
+    const gap = Math.hypot(last.re - first.re, last.im - first.im) * sf;
+    if (gap > tol) {
+      report('openOutline', key, {
+        x: (first.re + last.re) / 2 * sf + bbW / 2,
+        y: -((first.im + last.im) / 2) * sf + bbH / 2,
+      }, `outline gap of ${gap.toFixed(3)} mm`);
+    }
+  }
+
+  const layers = collectGCodeLayers(engine.arcGroups, sf, bbW, bbH, {
+    drawGroupOutline: params.draw_group_outline !== false,
+    redOutline: params.red_outline,
+    addFillPattern: params.add_fill_pattern,
+    fillPatternSpacing: params.fill_pattern_spacing,
+    fillPatternOffset: params.fill_pattern_offset,
+    fillPatternType: params.fill_pattern_type,
+    fillPatternRectWidth: params.fill_pattern_rect_width,
+  });
+
+  // Flat segment list for the duplicate hash: x1, y1, x2, y2 per segment.
+  let capacity = 0;
+  for (const layer of layers) {
+    for (const { points, closed } of layer.paths) {
+      capacity += closed ? points.length : Math.max(0, points.length - 1);
+    }
+  }
+  const coords = new Float64Array(capacity * 4);
+  const owners = new Array(capacity);
+  const kinds = new Array(capacity);
+  let segmentCount = 0;
+
+  const minX = -tol;
+  const minY = -tol;
+  const maxX = bbW + tol;
+  const maxY = bbH + tol;
+
+  for (const layer of layers) {
+    for (const path of layer.paths) {
+      const { points, closed } = path;
+      const group = path.group ?? null;
+      if (points.length < 2) continue;
+
+      const outside = points.find(p => p.x < minX || p.x > maxX || p.y < minY || p.y > maxY);
+      if (outside) {
+        report('outOfBounds', group, outside, `${layer.kind.toLowerCase()} outside the ${bbW} × ${bbH} mm box`);
+      }
+
+      const count = closed ? points.length : points.length - 1;
+      for (let i = 0; i < count; i += 1) {
+        const a = points[i];
+        const b = points[(i + 1) % points.length];
+        // Zero-length segments (collapsed sample points) cut nothing.
+        if (Math.abs(b.x - a.x) <= tol && Math.abs(b.y - a.y) <= tol) continue;
+        const at = segmentCount * 4;
+        coords[at] = a.x;
+        coords[at + 1] = a.y;
+        coords[at + 2] = b.x;
+        coords[at + 3] = b.y;
+        owners[segmentCount] = group;
+        kinds[segmentCount] = layer.kind;
+        segmentCount += 1;
+      }
+
+      if (!closed) continue;
+      if (layer.kind === 'OUTLINE') {
+        const hit = polygonSelfIntersection(points, tol);
+        if (hit) {
+          report('selfIntersection', group, hit, 'outline crosses itself');
+        }
+        const width = meanWidth(points);
+        if (width < beam) {
+          report('featureWidth', group, centroid(points),
+            `piece about ${width.toFixed(3)} mm wide, beam is ${beam} mm`);
+        }
+        if (params.add_fill_pattern && offsetMm > 0) {
+          const inset = insetPolygon(points, offsetMm);
+          const insetHit = inset.length >= 4 ? polygonSelfIntersection(inset, tol) : null;
+          if (insetHit) {
+            report('insetSelfIntersection', group, insetHit, `hatch inset of ${offsetMm} mm crosses itself`);
+          }
+        }
+      } else if (layer.kind === 'HATCH' && rectangles && points.length === 4) {
+        const width = Math.hypot(points[3].x - points[0].x, points[3].y - points[0].y);
+        if (width < beam) {
+          report('featureWidth', group, centroid(points),
+            `hatch rectangle ${width.toFixed(3)} mm wide, beam is ${beam} mm`);
+        }
+      }
+    }
+  }
+
+  // Duplicate segments: hash each midpoint into a cell of `cell` mm (an
+  // open hash over typed arrays) and look for a segment with the same end
+  // points, in either direction, in the cells a match within `tol` can fall
+  // in. Outline edges shared by two neighbouring groups are how the
+  // per-group outlines are built and are only counted.
+  //
+  // Outline edges that match an edge of their own outline are dropped as
+  // well: where two arcs of a group meet at a tangent cusp, the outline runs
+  // into the spike and back out, and near the tip the two sides are closer
+  // than `tol`. That happens in the small centre groups (a few hundredths of
+  // a millimetre across) of every render; it is the shape of the piece, not
+  // a path written twice.
+  const cell = Math.max(tol * 4, 1e-6);
+  let tableSize = 1024;
+  while (tableSize < segmentCount * 2) tableSize *= 2;
+  const mask = tableSize - 1;
+  const heads = new Int32Array(tableSize).fill(-1);
+  const next = new Int32Array(Math.max(1, segmentCount)).fill(-1);
+  const cellX = new Int32Array(Math.max(1, segmentCount));
+  const cellY = new Int32Array(Math.max(1, segmentCount));
+  const slot = (cx, cy) => (Math.imul(cx, 73856093) ^ Math.imul(cy, 19349663)) & mask;
+  const close = (a, b) => Math.abs(coords[a] - coords[b]) <= tol && Math.abs(coords[a + 1] - coords[b + 1]) <= tol;
+  const findIn = (i, cx, cy) => {
+    const a = i * 4;
+    for (let j = heads[slot(cx, cy)]; j >= 0; j = next[j]) {
+      if (cellX[j] !== cx || cellY[j] !== cy) continue;
+      const b = j * 4;
+      if ((close(a, b) && close(a + 2, b + 2)) || (close(a, b + 2) && close(a + 2, b))) {
+        return j;
+      }
+    }
+    return -1;
+  };
+  let sharedOutlineSegments = 0;
+  let retracedOutlineSegments = 0;
+  for (let i = 0; i < segmentCount; i += 1) {
+    const mx = (coords[i * 4] + coords[i * 4 + 2]) / 2;
+    const my = (coords[i * 4 + 1] + coords[i * 4 + 3]) / 2;
+    const fx = mx / cell;
+    const fy = my / cell;
+    const cx = Math.floor(fx);
+    const cy = Math.floor(fy);
+    // A match lies within tol (a quarter cell) of this midpoint, so only the
+    // nearest neighbour cell on each axis needs a look.
+    const nx = fx - cx < 0.5 ? cx - 1 : cx + 1;
+    const ny = fy - cy < 0.5 ? cy - 1 : cy + 1;
+    let match = findIn(i, cx, cy);
+    if (match < 0) match = findIn(i, nx, cy);
+    if (match < 0) match = findIn(i, cx, ny);
+    if (match < 0) match = findIn(i, nx, ny);
+    if (match >= 0) {
+      if (kinds[i] === 'OUTLINE' && kinds[match] === 'OUTLINE') {
+        if (owners[i] !== owners[match]) {
+          sharedOutlineSegments += 1;
+        } else {
+          retracedOutlineSegments += 1;
+        }
+      } else {
+        report('duplicateSegment', owners[i], { x: mx, y: my },
+          `${kinds[i].toLowerCase()} segment also cut by ${kinds[match].toLowerCase()}`);
+      }
+      continue;
+    }
+    cellX[i] = cx;
+    cellY[i] = cy;
+    const h = slot(cx, cy);
+    next[i] = heads[h];
+    heads[h] = i;
+  }
+
+  const total = VALIDATION_CHECKS.reduce((sum, check) => sum + counts[check], 0);
+  return {
+    ok: total === 0,
+    counts,
+    issues,
+    truncated: issues.length < total,
+    sharedOutlineSegments,
+    retracedOutlineSegments,
+    segments: segmentCount,
+    bounds: { width: bbW, height: bbH },
+  };
+}
+
+/**
+ * One-line summary for the status bar, e.g. "3 open outlines, 12 duplicate
+ * segments". Empty when the export is clean.
+ */
+export function validationSummary(result) {
+  if (!result || result.ok) {
+    return '';
+  }
+  const labels = {
+    openOutline: ['open outline', 'open outlines'],
+    selfIntersection: ['self-intersecting outline', 'self-intersecting outlines'],
+    insetSelfIntersection: ['self-intersecting hatch inset', 'self-intersecting hatch insets'],
+    featureWidth: ['feature narrower than the beam', 'features narrower than the beam'],
+    duplicateSegment: ['duplicate segment', 'duplicate segments'],
+    outOfBounds: ['path out of bounds', 'paths out of bounds'],
+  };
+  return VALIDATION_CHECKS
+    .filter(check => result.counts[check] > 0)
+    .map(check => `${result.counts[check]} ${labels[check][result.counts[check] === 1 ? 0 : 1]}`)
+    .join(', ');
+}
+
+/**
+ * Maps an issue location from export millimetres to preview SVG coordinates
+ * (origin at the centre of the bounding box, y down).
+ */
+export function previewPoint(result, issue) {
+  return { x: issue.x - result.bounds.width / 2, y: result.bounds.height / 2 - issue.y };
+}
@@ -0,0 +1,75 @@
+import { renderExportGeometry, buildExportFile } from './export_precompute.js';
+import { validateExportGeometry } from './export_validation.js';
+import { collectGCodeLayers, gcodeLayerOptions, planGCode, estimateJobTime, streamGCode } from './gcode_export.js';
+
+const encoder = new TextEncoder();
+
+// G-code leaves the worker in chunks of about this many characters.
+const GCODE_CHUNK_CHARS = 256 * 1024;
+
+function precompute(data) {
+  const { requestId, params, formats = [], options = {} } = data;
+  const geometry = renderExportGeometry(params);
+  // Validation goes first, so a report is ready whenever a file is.
+  if (data.validate) {
+    const report = validateExportGeometry(geometry, params, options);
+    self.postMessage({ type: 'validation', requestId, report });
+  }
+  // One message per file so the cheaper formats are ready before STEP.
+  for (const format of formats) {
+    const bytes = encoder.encode(buildExportFile(geometry, params, format, options));
+    self.postMessage({ type: 'file', requestId, format, bytes }, [bytes.buffer]);
+  }
+  self.postMessage({ type: 'done', requestId });
+}
+
+// Builds the G-code download here rather than on the page, and streams it
+// back as 'chunk' messages followed by 'done' with the job estimate.
+function gcode(data) {
+  const { requestId, params, settings = {}, options = {}, angleOverrides = null } = data;
+  const geometry = renderExportGeometry(params, { arcGroupAngleOverrides: angleOverrides });
+  if (data.validate) {
+    const report = validateExportGeometry(geometry, params, options);
+    self.postMessage({ type: 'validation', requestId, report });
+  }
+  const { engine, scaleFactor } = geometry;
+  const bbW = params.bounding_box_width_mm || 250;
+  const bbH = params.bounding_box_height_mm || 250;
+  const layers = collectGCodeLayers(engine.arcGroups, scaleFactor ?? 1, bbW, bbH, gcodeLayerOptions(params));
+  const plan = planGCode(layers);
+  let parts = [];
+  let length = 0;
+  const post = () => {
+    if (!parts.length) return;
+    const bytes = encoder.encode(parts.join(''));
+    self.postMessage({ type: 'chunk', requestId, bytes }, [bytes.buffer]);
+    parts = [];
+    length = 0;
+  };
+  for (const text of streamGCode(plan, settings)) {
+    parts.push(text);
+    length += text.length;
+    if (length >= GCODE_CHUNK_CHARS) post();
+  }
+  post();
+  self.postMessage({ type: 'done', requestId, estimate: estimateJobTime(plan, settings) });
+}
+
+const HANDLERS = { precompute, gcode };
+
+self.addEventListener('message', event => {
+  const data = event.data || {};
+  const handle = HANDLERS[data.type];
+  if (!handle) {
+    return;
+  }
+  try {
+    handle(data);
+  } catch (error) {
+    self.postMessage({
+      type: 'error',
+      requestId: data.requestId,
+      message: error?.message || (data.type === 'gcode' ? 'G-code export failed' : 'Export precompute failed'),
+    });
+  }
+});
@@ -0,0 +1,498 @@
+/**
+ * G-code export for driving a laser directly from the engine geometry.
+ *
+ * Produces GRBL-style laser G-code (G21/G90, M4 dynamic power, S for power,
+ * F for feed in mm/min). Hatch lines, group outlines and the highlight rim are
+ * collected into layers, optionally split by ring the same way the SVG layer
+ * export does, and each layer gets its own power/speed/passes setting.
+ *
+ * Within a layer paths are ordered greedily by nearest entry point (open paths
+ * may be reversed, closed paths may start at any vertex) to keep G0 travel
+ * short. Runs of outline vertices lying on one of the group's circles are
+ * emitted as true G2/G3 arcs instead of chains of G1 chords.
+ *
+ * Coordinate transform (matches SVG/DXF/STEP exactly):
+ *   x = re * scaleFactor + W/2
+ *   y = -(im * scaleFactor) + H/2
+ */
+
+import { buildContinuousPathsFromArcs } from './doyle_spiral_engine.js';
+
+export const GCODE_LAYER_DEFAULTS = {
+  HATCH: { power: 40, speed: 3000, passes: 1 },
+  OUTLINE: { power: 80, speed: 1200, passes: 1 },
+  HIGHLIGHT: { power: 100, speed: 800, passes: 1 },
+};
+
+const LAYER_KIND_ORDER = ['HATCH', 'OUTLINE', 'HIGHLIGHT'];
+const ON_CIRCLE_TOLERANCE = 1e-6; // Relative radius tolerance for arc fitting
+const NN_GRID = 64;               // Cells per axis in the nearest-neighbour grid
+
+/**
+ * collectGCodeLayers() options for normalised spiral parameters.
+ */
+export function gcodeLayerOptions(params) {
+  return {
+    drawGroupOutline: params.draw_group_outline,
+    redOutline: params.red_outline,
+    addFillPattern: params.add_fill_pattern,
+    fillPatternSpacing: params.fill_pattern_spacing,
+    fillPatternOffset: params.fill_pattern_offset,
+    fillPatternType: params.fill_pattern_type,
+    fillPatternRectWidth: params.fill_pattern_rect_width,
+    layerCount: params.svg_layers ? params.svg_layer_count : 0,
+  };
+}
+
+/**
+ * Collects exportable paths from the engine, in millimetres, grouped by layer.
+ *
+ * @param {Map<string, ArcGroup>} arcGroups - from engine.arcGroups
+ * @param {number} scaleFactor              - mm per internal unit
+ * @param {number} boundingWidthMm
+ * @param {number} boundingHeightMm
+ * @param {Object} [opts]
+ * @param {boolean} [opts.drawGroupOutline=true]
+ * @param {boolean} [opts.redOutline=false]
+ * @param {boolean} [opts.addFillPattern=false]
+ * @param {number}  [opts.fillPatternSpacing=8]   - hatch spacing in mm
+ * @param {number}  [opts.fillPatternOffset=0]    - hatch inset in mm
+ * @param {string}  [opts.fillPatternType='lines']
+ * @param {number}  [opts.fillPatternRectWidth=2] - rectangle width in mm
+ * @param {number}  [opts.layerCount=0]           - split layers by ring into this many bands (0 = no split)
+ * @returns {Array<{name: string, kind: string, band: number, paths: Array}>}
+ *   Outline and hatch paths carry the key of the ArcGroup they came from in `group`.
+ */
+export function collectGCodeLayers(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts = {}) {
+  const sf = Number.isFinite(scaleFactor) && scaleFactor > 0 ? scaleFactor : 1;
+  const drawGroupOutline = opts.drawGroupOutline !== false;
+  const redOutline = Boolean(opts.redOutline);
+  const addFillPattern = Boolean(opts.addFillPattern);
+  const spacingMm = Math.max(0, Number(opts.fillPatternSpacing ?? 8));
+  const offsetMm = Math.max(0, Number(opts.fillPatternOffset ?? 0));
+  const rectWidthMm = Math.max(0, Number(opts.fillPatternRectWidth ?? 2));
+  const useRectangles = opts.fillPatternType === 'rectangles';
+  // Kernels other than plain hatches emit polylines; consecutive segments
+  // that share an end point are cut as one path.
+  const chainSegments = !useRectangles && opts.fillPatternType && opts.fillPatternType !== 'lines';
+  const layerCount = Math.max(0, Math.floor(Number(opts.layerCount) || 0));
+
+  const toMm = pt => ({
+    x: pt.re * sf + boundingWidthMm / 2,
+    y: -(pt.im * sf) + boundingHeightMm / 2,
+  });
+  const toMmCircle = circle => {
+    const c = toMm(circle.center);
+    return { cx: c.x, cy: c.y, r: circle.radius * sf };
+  };
+
+  const ringIndices = [];
+  for (const group of arcGroups.values()) {
+    if (Number.isFinite(group.ringIndex) && group.ringIndex >= 0) ringIndices.push(group.ringIndex);
+  }
+  const minRing = ringIndices.length ? Math.min(...ringIndices) : 0;
+  const maxRing = ringIndices.length ? Math.max(...ringIndices) : 0;
+  const bandFor = ringIdx => {
+    if (!layerCount || maxRing <= minRing || !Number.isFinite(ringIdx) || ringIdx < 0) return 0;
+    return Math.min(layerCount - 1, Math.floor((ringIdx - minRing) / (maxRing - minRing) * layerCount));
+  };
+
+  const layers = new Map();
+  const addPath = (kind, ringIdx, path) => {
+    const band = bandFor(ringIdx);
+    const name = layerCount ? `${kind}_${band + 1}` : kind;
+    if (!layers.has(name)) layers.set(name, { name, kind, band, paths: [] });
+    layers.get(name).paths.push(path);
+  };
+
+  for (const [key, group] of arcGroups.entries()) {
+    if (key.startsWith('outer_')) continue;
+    const ringIdx = group.ringIndex ?? 0;
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 3) continue;
+
+    if (drawGroupOutline) {
+      const circles = group.arcs.map(arc => toMmCircle(arc.circle));
+      if (group.outerArc) circles.push(toMmCircle(group.outerArc.circle));
+      addPath('OUTLINE', ringIdx, { points: dedupeClosing(outline.map(toMm)), closed: true, circles, group: key });
+    }
+
+    if (addFillPattern && spacingMm > 0) {
+      const angle = Number.isFinite(group.primaryPatternAngle) ? group.primaryPatternAngle : 0;
+      const segments = group.getPatternSegments(spacingMm / sf, angle, offsetMm / sf) || [];
+      let chain = null;
+      for (const [start, end] of segments) {
+        const a = toMm(start);
+        const b = toMm(end);
+        if (chainSegments) {
+          const last = chain && chain.points[chain.points.length - 1];
+          if (last && Math.abs(last.x - a.x) <= 1e-9 && Math.abs(last.y - a.y) <= 1e-9) {
+            chain.points.push(b);
+          } else {
+            chain = { points: [a, b], closed: false, circles: null, group: key };
+            addPath('HATCH', ringIdx, chain);
+          }
+          continue;
+        }
+        if (!useRectangles) {
+          addPath('HATCH', ringIdx, { points: [a, b], closed: false, circles: null, group: key });
+          continue;
+        }
+        const half = rectWidthMm / 2;
+        const length = Math.hypot(b.x - a.x, b.y - a.y);
+        if (half <= 1e-6 || length <= 2 * half) continue;
+        const ox = -(b.y - a.y) / length * half;
+        const oy = (b.x - a.x) / length * half;
+        addPath('HATCH', ringIdx, {
+          points: [
+            { x: a.x + ox, y: a.y + oy },
+            { x: b.x + ox, y: b.y + oy },
+            { x: b.x - ox, y: b.y - oy },
+            { x: a.x - ox, y: a.y - oy },
+          ],
+          closed: true,
+          circles: null,
+          group: key,
+        });
+      }
+    }
+  }
+
+  if (redOutline) {
+    const highlight = [];
+    for (const [key, group] of arcGroups.entries()) {
+      if (key.startsWith('outer_')) highlight.push({ arcs: group.arcs, ringIdx: maxRing });
+    }
+    for (const group of arcGroups.values()) {
+      if (group.ringIndex !== maxRing || !group.name?.startsWith('circle_')) continue;
+      highlight.push({ arcs: group.arcs.filter((_, i) => i === 2 || i === 3), ringIdx: maxRing });
+    }
+    for (const { arcs, ringIdx } of highlight) {
+      const circles = arcs.map(arc => toMmCircle(arc.circle));
+      for (const path of buildContinuousPathsFromArcs(arcs)) {
+        if (!path || path.length < 2) continue;
+        const points = path.map(toMm);
+        const first = points[0];
+        const last = points[points.length - 1];
+        const closed = Math.hypot(first.x - last.x, first.y - last.y) < 1e-4;
+        addPath('HIGHLIGHT', ringIdx, { points: closed ? dedupeClosing(points) : points, closed, circles });
+      }
+    }
+  }
+
+  return Array.from(layers.values()).sort((a, b) =>
+    LAYER_KIND_ORDER.indexOf(a.kind) - LAYER_KIND_ORDER.indexOf(b.kind) || a.band - b.band);
+}
+
+function dedupeClosing(points) {
+  if (points.length > 1) {
+    const first = points[0];
+    const last = points[points.length - 1];
+    if (Math.hypot(first.x - last.x, first.y - last.y) < 1e-9) return points.slice(0, -1);
+  }
+  return points;
+}
+
+/**
+ * Orders paths to minimise rapid travel using a greedy nearest-entry search on
+ * a uniform grid. Open paths may be reversed; closed paths are rotated so they
+ * start at the vertex nearest the current position.
+ *
+ * @param {Array<{points: Array<{x: number, y: number}>, closed: boolean}>} paths
+ * @param {{x: number, y: number}} [start={x: 0, y: 0}]
+ * @returns {Array} new path objects in cutting order
+ */
+export function orderPathsForTravel(paths, start = { x: 0, y: 0 }) {
+  const usable = paths.filter(p => p.points && p.points.length >= 2);
+  if (usable.length <= 1) return usable.slice();
+
+  // Entry candidates: every vertex of closed paths, both ends of open paths.
+  const entries = [];
+  let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity;
+  usable.forEach((path, pathIdx) => {
+    const pts = path.points;
+    const vertexIdx = path.closed ? pts.map((_, i) => i) : [0, pts.length - 1];
+    for (const v of vertexIdx) {
+      const p = pts[v];
+      entries.push({ pathIdx, v, x: p.x, y: p.y });
+      if (p.x < minX) minX = p.x;
+      if (p.y < minY) minY = p.y;
+      if (p.x > maxX) maxX = p.x;
+      if (p.y > maxY) maxY = p.y;
+    }
+  });
+  const cellW = Math.max((maxX - minX) / NN_GRID, 1e-9);
+  const cellH = Math.max((maxY - minY) / NN_GRID, 1e-9);
+  const cellOf = (x, y) => [
+    Math.min(NN_GRID - 1, Math.max(0, Math.floor((x - minX) / cellW))),
+    Math.min(NN_GRID - 1, Math.max(0, Math.floor((y - minY) / cellH))),
+  ];
+  const grid = Array.from({ length: NN_GRID * NN_GRID }, () => []);
+  for (const entry of entries) {
+    const [cx, cy] = cellOf(entry.x, entry.y);
+    grid[cy * NN_GRID + cx].push(entry);
+  }
+
+  const done = new Uint8Array(usable.length);
+  const ordered = [];
+  let pos = start;
+  for (let remaining = usable.length; remaining > 0; remaining--) {
+    const [cx, cy] = cellOf(pos.x, pos.y);
+    let best = null;
+    let bestDist = Infinity;
+    for (let ring = 0; ring < NN_GRID; ring++) {
+      // Once a candidate is found, one further ring guarantees the true nearest.
+      const ringReach = (ring - 1) * Math.min(cellW, cellH);
+      if (best && ringReach > 0 && ringReach * ringReach > bestDist) break;
+      for (let gy = cy - ring; gy <= cy + ring; gy++) {
+        if (gy < 0 || gy >= NN_GRID) continue;
+        for (let gx = cx - ring; gx <= cx + ring; gx++) {
+          if (gx < 0 || gx >= NN_GRID) continue;
+          if (Math.max(Math.abs(gx - cx), Math.abs(gy - cy)) !== ring) continue;
+          const cell = grid[gy * NN_GRID + gx];
+          for (let i = cell.length - 1; i >= 0; i--) {
+            const entry = cell[i];
+            if (done[entry.pathIdx]) {
+              cell.splice(i, 1);
+              continue;
+            }
+            const dx = entry.x - pos.x;
+            const dy = entry.y - pos.y;
+            const dist = dx * dx + dy * dy;
+            if (dist < bestDist) {
+              bestDist = dist;
+              best = entry;
+            }
+          }
+        }
+      }
+    }
+    if (!best) break;
+    done[best.pathIdx] = 1;
+    const path = usable[best.pathIdx];
+    let points;
+    if (path.closed) {
+      points = best.v === 0 ? path.points : path.points.slice(best.v).concat(path.points.slice(0, best.v));
+    } else {
+      points = best.v === 0 ? path.points : path.points.slice().reverse();
+    }
+    ordered.push({ ...path, points });
+    pos = path.closed ? points[0] : points[points.length - 1];
+  }
+  return ordered;
+}
+
+/**
+ * Splits a polyline into line and arc moves. Consecutive vertices lying on one
+ * of the given circles are merged into a single arc move.
+ *
+ * @param {Array<{x: number, y: number}>} points
+ * @param {boolean} closed
+ * @param {Array<{cx: number, cy: number, r: number}>|null} circles
+ * @returns {Array<{type: 'line'|'arc', to: {x: number, y: number}, center?: Object, ccw?: boolean, sweep?: number}>}
+ */
+export function fitArcMoves(points, closed, circles) {
+  const pts = closed ? points.concat([points[0]]) : points;
+  const moves = [];
+  const onCircle = (p, c) => Math.abs(Math.hypot(p.x - c.cx, p.y - c.cy) - c.r) <= ON_CIRCLE_TOLERANCE * Math.max(1, c.r);
+  let i = 0;
+  while (i < pts.length - 1) {
+    const a = pts[i];
+    let circle = null;
+    if (circles && circles.length) {
+      for (const c of circles) {
+        if (onCircle(a, c) && onCircle(pts[i + 1], c)) {
+          circle = c;
+          break;
+        }
+      }
+    }
+    if (!circle) {
+      moves.push({ type: 'line', to: pts[i + 1] });
+      i += 1;
+      continue;
+    }
+    // Extend the run while vertices stay on the circle and keep turning the same way.
+    let sweep = 0;
+    let j = i;
+    while (j < pts.length - 1 && onCircle(pts[j + 1], circle)) {
+      const a0 = Math.atan2(pts[j].y - circle.cy, pts[j].x - circle.cx);
+      let d = Math.atan2(pts[j + 1].y - circle.cy, pts[j + 1].x - circle.cx) - a0;
+      if (d > Math.PI) d -= 2 * Math.PI;
+      if (d < -Math.PI) d += 2 * Math.PI;
+      if (sweep !== 0 && Math.sign(d) !== Math.sign(sweep)) break;
+      if (Math.abs(sweep + d) >= 2 * Math.PI - 1e-6) break;
+      sweep += d;
+      j += 1;
+    }
+    if (Math.abs(sweep) < 1e-9) {
+      moves.push({ type: 'line', to: pts[i + 1] });
+      i += 1;
+      continue;
+    }
+    moves.push({ type: 'arc', to: pts[j], center: { x: circle.cx, y: circle.cy }, ccw: sweep > 0, sweep, radius: circle.r });
+    i = j;
+  }
+  return moves;
+}
+
+function moveLength(from, move) {
+  if (move.type === 'arc') return Math.abs(move.sweep) * move.radius;
+  return Math.hypot(move.to.x - from.x, move.to.y - from.y);
+}
+
+/**
+ * Resolves the power/speed/passes setting for a layer, falling back from the
+ * exact layer name (e.g. "OUTLINE_3") to its kind ("OUTLINE") to the defaults.
+ */
+export function resolveLayerSettings(layer, settings = {}) {
+  const base = GCODE_LAYER_DEFAULTS[layer.kind] || GCODE_LAYER_DEFAULTS.OUTLINE;
+  return { ...base, ...(settings[layer.kind] || {}), ...(settings[layer.name] || {}) };
+}
+
+/**
+ * Orders every layer and precomputes its moves. The plan is consumed by
+ * streamGCode and estimateJobTime.
+ *
+ * @param {Array} layers - from collectGCodeLayers
+ * @returns {Array<{name: string, kind: string, band: number, paths: Array<{start: Object, moves: Array}>}>}
+ */
+export function planGCode(layers) {
+  let pos = { x: 0, y: 0 };
+  return layers.map(layer => {
+    const ordered = orderPathsForTravel(layer.paths, pos);
+    const paths = ordered.map(path => {
+      const moves = fitArcMoves(path.points, path.closed, path.circles);
+      return { start: path.points[0], moves };
+    });
+    if (paths.length) {
+      const last = paths[paths.length - 1];
+      pos = last.moves.length ? last.moves[last.moves.length - 1].to : last.start;
+    }
+    return { name: layer.name, kind: layer.kind, band: layer.band, paths };
+  });
+}
+
+/**
+ * Estimates machine time from move lengths and feed rates (constant velocity,
+ * no acceleration modelling).
+ *
+ * @param {Array} plan - from planGCode
+ * @param {Object} [settings]
+ * @param {Object} [settings.layers]          - per-layer overrides, keyed by kind or layer name
+ * @param {number} [settings.travelSpeed=6000] - G0 rate in mm/min
+ * @returns {{seconds: number, cutLengthMm: number, travelLengthMm: number, pathCount: number}}
+ */
+export function estimateJobTime(plan, settings = {}) {
+  const travelSpeed = Math.max(1, Number(settings.travelSpeed ?? 6000));
+  let minutes = 0;
+  let cut = 0;
+  let travel = 0;
+  let pathCount = 0;
+  let pos = { x: 0, y: 0 };
+  for (const layer of plan) {
+    const { speed, passes } = resolveLayerSettings(layer, settings.layers);
+    const feed = Math.max(1, Number(speed));
+    const repeat = Math.max(1, Math.floor(passes || 1));
+    for (let pass = 0; pass < repeat; pass++) {
+      for (const path of layer.paths) {
+        const hop = Math.hypot(path.start.x - pos.x, path.start.y - pos.y);
+        travel += hop;
+        minutes += hop / travelSpeed;
+        let cursor = path.start;
+        for (const move of path.moves) {
+          const length = moveLength(cursor, move);
+          cut += length;
+          minutes += length / feed;
+          cursor = move.to;
+        }
+        pos = cursor;
+        pathCount += 1;
+      }
+    }
+  }
+  const hop = Math.hypot(pos.x, pos.y);
+  travel += hop;
+  minutes += hop / travelSpeed;
+  return { seconds: minutes * 60, cutLengthMm: cut, travelLengthMm: travel, pathCount };
+}
+
+export function formatDuration(seconds) {
+  const total = Math.max(0, Math.round(seconds));
+  const h = Math.floor(total / 3600);
+  const m = Math.floor((total % 3600) / 60);
+  const s = total % 60;
+  return h > 0 ? `${h}h ${String(m).padStart(2, '0')}m ${String(s).padStart(2, '0')}s` : `${m}m ${String(s).padStart(2, '0')}s`;
+}
+
+/**
+ * Streams G-code for a plan, one chunk per path, so callers can write to a
+ * file stream or build a Blob without assembling one huge string.
+ *
+ * @param {Array} plan - from planGCode
+ * @param {Object} [settings]
+ * @param {Object} [settings.layers]            - per-layer overrides, keyed by kind or layer name
+ * @param {number} [settings.travelSpeed=6000]  - G0 rate in mm/min (used for the estimate)
+ * @param {number} [settings.maxPower=1000]     - S value for 100 % power ($30 on GRBL)
+ * @param {number} [settings.decimals=3]
+ * @yields {string}
+ */
+export function* streamGCode(plan, settings = {}) {
+  const maxPower = Math.max(1, Number(settings.maxPower ?? 1000));
+  const decimals = Math.max(0, Math.min(6, Math.floor(settings.decimals ?? 3)));
+  const fmt = v => v.toFixed(decimals);
+  const estimate = estimateJobTime(plan, settings);
+
+  yield [
+    '; Doyle spiral laser job',
+    `; Estimated time: ${formatDuration(estimate.seconds)}`,
+    `; Cut length: ${estimate.cutLengthMm.toFixed(1)} mm, travel: ${estimate.travelLengthMm.toFixed(1)} mm, paths: ${estimate.pathCount}`,
+    'G21',
+    'G90',
+    'G17',
+    'M5',
+    '',
+  ].join('\n');
+
+  for (const layer of plan) {
+    if (!layer.paths.length) continue;
+    const { power, speed, passes } = resolveLayerSettings(layer, settings.layers);
+    const s = Math.round(Math.max(0, Math.min(100, Number(power))) / 100 * maxPower);
+    const feed = Math.max(1, Math.round(Number(speed)));
+    const repeat = Math.max(1, Math.floor(passes || 1));
+    yield `; Layer ${layer.name}: power ${power}% (S${s}), speed ${feed} mm/min, passes ${repeat}\nM4 S0\n`;
+    for (let pass = 0; pass < repeat; pass++) {
+      for (const path of layer.paths) {
+        const lines = [`G0 X${fmt(path.start.x)} Y${fmt(path.start.y)}`];
+        let cursor = path.start;
+        let first = true;
+        for (const move of path.moves) {
+          const head = first ? ` S${s} F${feed}` : '';
+          if (move.type === 'arc') {
+            const i = move.center.x - cursor.x;
+            const j = move.center.y - cursor.y;
+            lines.push(`${move.ccw ? 'G3' : 'G2'} X${fmt(move.to.x)} Y${fmt(move.to.y)} I${fmt(i)} J${fmt(j)}${head}`);
+          } else {
+            lines.push(`G1 X${fmt(move.to.x)} Y${fmt(move.to.y)}${head}`);
+          }
+          first = false;
+          cursor = move.to;
+        }
+        yield `${lines.join('\n')}\n`;
+      }
+    }
+    yield 'M5\n';
+  }
+  yield 'G0 X0 Y0\nM2\n';
+}
+
+/**
+ * Convenience wrapper returning the whole program as one string plus its estimate.
+ *
+ * @returns {{gcode: string, estimate: Object}}
+ */
+export function generateGCode(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts = {}, settings = {}) {
+  const plan = planGCode(collectGCodeLayers(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts));
+  const chunks = Array.from(streamGCode(plan, settings));
+  return { gcode: chunks.join(''), estimate: estimateJobTime(plan, settings) };
+}
@@ -0,0 +1,187 @@
+/**
+ * Geometry store shared between the page and its workers.
+ *
+ * storeGeometry() moves a toJSON() geometry payload's outlines into one
+ * buffer: a SharedArrayBuffer when the page is cross-origin isolated, a plain
+ * ArrayBuffer otherwise. The handle it returns is small and cloneable (group
+ * metadata plus the buffer), and readGeometry() turns it back into a payload
+ * whose outlines are views of that buffer, so decodeOutline() and every
+ * geometry consumer work unchanged.
+ *
+ * Protocol: the writer fills the buffer, then publishGeometry() marks it
+ * published. From then on nobody writes to it, which is what makes sharing it
+ * between threads safe without locks; readers refuse unpublished buffers.
+ * Each store carries the generation (render token) it was written for, and a
+ * GeometryStore on the page keeps the current generation in a shared control
+ * word. geometryForWorker() posts that word along with the store, and
+ * readGeometry() refuses a store the page has since superseded.
+ *
+ * With shared memory every worker reads the same bytes. Without it,
+ * geometryForWorker() hands each worker its own transferable copy.
+ */
+
+const HEADER_GENERATION = 0;
+const HEADER_STATE = 1;
+// Two Int32 header words, padded so Float64 coordinates stay aligned.
+const HEADER_BYTES = 8;
+
+const STATE_WRITING = 0;
+const STATE_PUBLISHED = 1;
+
+const COORD_ARRAYS = {
+  float64: Float64Array,
+  float32: Float32Array,
+  int32: Int32Array,
+};
+
+/**
+ * True when SharedArrayBuffers can be posted to workers: the page must be
+ * cross-origin isolated (COOP same-origin plus COEP require-corp).
+ */
+export function sharedGeometryAvailable() {
+  return typeof SharedArrayBuffer !== 'undefined' && globalThis.crossOriginIsolated === true;
+}
+
+function coordTypeOf(outline) {
+  if (outline instanceof Float32Array) return 'float32';
+  if (outline instanceof Int32Array) return 'int32';
+  return 'float64';
+}
+
+/**
+ * Writes `geometry` into a new store for `generation`. The store is not
+ * readable until publishGeometry().
+ *
+ * @param {Object} geometry - toJSON() payload, plain or compact
+ * @param {{generation?: number, shared?: boolean}} [options]
+ * @returns {Object} store handle
+ */
+export function storeGeometry(geometry, { generation = 0, shared = sharedGeometryAvailable() } = {}) {
+  const groups = geometry?.arcgroups || [];
+  const coordType = groups.length ? coordTypeOf(groups[0].outline) : 'float64';
+  const Coords = COORD_ARRAYS[coordType];
+  let coordCount = 0;
+  for (const group of groups) {
+    coordCount += ArrayBuffer.isView(group.outline) ? group.outline.length : (group.outline?.length || 0) * 2;
+  }
+  const byteLength = HEADER_BYTES + coordCount * Coords.BYTES_PER_ELEMENT;
+  const buffer = shared ? new SharedArrayBuffer(byteLength) : new ArrayBuffer(byteLength);
+  const coords = new Coords(buffer, HEADER_BYTES, coordCount);
+  const arcgroups = [];
+  let at = 0;
+  for (const group of groups) {
+    const { outline, ...entry } = group;
+    const start = at;
+    if (ArrayBuffer.isView(outline)) {
+      coords.set(outline, at);
+      at += outline.length;
+    } else {
+      for (const [x, y] of outline || []) {
+        coords[at] = x;
+        coords[at + 1] = y;
+        at += 2;
+      }
+    }
+    entry.outline_range = [start, at - start];
+    arcgroups.push(entry);
+  }
+  const header = new Int32Array(buffer, 0, 2);
+  header[HEADER_GENERATION] = generation;
+  header[HEADER_STATE] = STATE_WRITING;
+  return {
+    generation,
+    shared,
+    buffer,
+    coordType,
+    meta: { ...geometry, arcgroups },
+  };
+}
+
+/**
+ * Seals a store: after this its buffer is never written again.
+ */
+export function publishGeometry(store) {
+  Object.freeze(store.meta);
+  Atomics.store(new Int32Array(store.buffer, 0, 2), HEADER_STATE, STATE_PUBLISHED);
+  return store;
+}
+
+/**
+ * The geometry payload of a published store, with outlines as views of the
+ * store's buffer (nothing is copied). Throws for unpublished stores, and for
+ * stores posted with a control word that has moved on to a newer generation.
+ */
+export function readGeometry(store) {
+  const header = new Int32Array(store.buffer, 0, 2);
+  if (Atomics.load(header, HEADER_STATE) !== STATE_PUBLISHED
+    || Atomics.load(header, HEADER_GENERATION) !== store.generation) {
+    throw new Error('Geometry store is not published');
+  }
+  if (store.control && !GeometryStore.isCurrent(store, store.control)) {
+    throw new Error('Geometry store was superseded by a newer render');
+  }
+  const Coords = COORD_ARRAYS[store.coordType];
+  const coords = new Coords(store.buffer, HEADER_BYTES, (store.buffer.byteLength - HEADER_BYTES) / Coords.BYTES_PER_ELEMENT);
+  return {
+    ...store.meta,
+    arcgroups: store.meta.arcgroups.map(({ outline_range: [start, length], ...entry }) => ({
+      ...entry,
+      outline: coords.subarray(start, start + length),
+    })),
+  };
+}
+
+/**
+ * Message parts that post a published store to a worker: shared stores go as
+ * they are, plain ones as a transferable copy so the sender keeps its own.
+ * With `control` (a GeometryStore's control word) the worker's readGeometry()
+ * checks that the store is still current; a plain control word arrives as a
+ * copy, so there the check only reflects the moment of posting.
+ *
+ * @param {Object} store - published store handle
+ * @param {Int32Array|null} [control]
+ * @returns {{store: Object, transfer: ArrayBuffer[]}}
+ */
+export function geometryForWorker(store, control = null) {
+  const posted = control ? { ...store, control } : store;
+  if (store.shared) {
+    return { store: posted, transfer: [] };
+  }
+  const buffer = store.buffer.slice(0);
+  return { store: { ...posted, buffer }, transfer: [buffer] };
+}
+
+/**
+ * The page side: remembers the current store and publishes its generation
+ * to every worker that was given `control`.
+ */
+export class GeometryStore {
+  constructor({ shared = sharedGeometryAvailable() } = {}) {
+    this.shared = shared;
+    const control = shared ? new SharedArrayBuffer(4) : new ArrayBuffer(4);
+    this.control = new Int32Array(control);
+    this.current = null;
+  }
+
+  /** Makes a published store current and returns its geometry payload. */
+  adopt(store) {
+    const geometry = readGeometry(store);
+    this.current = store;
+    Atomics.store(this.control, 0, store.generation);
+    return geometry;
+  }
+
+  /** Drops the current store; stores posted earlier are superseded. */
+  clear() {
+    this.current = null;
+    Atomics.store(this.control, 0, 0);
+  }
+
+  /**
+   * Whether `store` is still the page's current geometry. Workers pass the
+   * `control` array they were given.
+   */
+  static isCurrent(store, control) {
+    return Atomics.load(control, 0) === store.generation;
+  }
+}
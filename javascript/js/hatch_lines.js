@@ -0,0 +1,228 @@
+/**
+ * Hatch lines for the 3D viewer.
+ *
+ * Groups of a ring share one template, and _getPatternSource() keeps every
+ * hatch set as template-local polylines plus the transform that places them.
+ * buildHatchLines() packs those caches as they are, one merged line buffer per
+ * ring template: each vertex is (x, y) in template space with the instance
+ * index in z, and each instance (one group and pattern angle) contributes its
+ * rotation/scale, centre, world line angle and pattern layer to a float
+ * texture. The viewer places the vertices and glints the lines in a shader, so
+ * the whole hatch of a ring is one draw call and no world-space coordinates are
+ * computed anywhere.
+ *
+ * Hatch sets differ per group unless angle snapping, symmetric clones or
+ * angle-free kernels make them coincide, so vertices are written per instance
+ * rather than drawn through instanced attributes.
+ *
+ * The worker (hatch_worker.js) renders the spiral for the viewer's parameters
+ * and answers with these buffers as transferables.
+ */
+
+import { renderSpiral } from './doyle_spiral_engine.js';
+
+// Texels per instance: [a, b, cx, cy] then [angle, layer, 0, 0], where a and b
+// are radius·cos and radius·sin of the template transform.
+export const HATCH_TEXELS_PER_INSTANCE = 2;
+// Width of the instance texture; rows are added as instances need them.
+export const HATCH_TEXTURE_WIDTH = 2048;
+// Pattern layers match the extruded meshes, which show at most three angles.
+const MAX_PATTERN_LAYERS = 3;
+
+function patternAnglesOf(group, engine) {
+  if (Array.isArray(group.patternAngles)) {
+    // An explicitly empty list switches the group's hatch off, as in toSVGFill().
+    return group.patternAngles.slice(0, MAX_PATTERN_LAYERS);
+  }
+  return [(group.ringIndex ?? 0) * (engine.fillPatternAngle || 0)];
+}
+
+// Largest distance of a hatch set's points from the template origin.
+function hatchExtent(segments, extents) {
+  let extent = extents.get(segments);
+  if (extent === undefined) {
+    extent = 0;
+    for (const polyline of segments) {
+      for (const point of polyline) {
+        extent = Math.max(extent, Math.hypot(point.x, point.y));
+      }
+    }
+    extents.set(segments, extent);
+  }
+  return extent;
+}
+
+/**
+ * Packs the hatch of every hatched group into per-template line buffers.
+ *
+ * @param {Object} engine - a rendered arram_boyle engine
+ * @param {{spacing: number, offset: number}} options - engine units
+ * @returns {{templates: Array<{key: string, ringIndex: number, positions: Float32Array,
+ *   instances: Float32Array, instanceCount: number, bounds: number[]}>,
+ *   vertexCount: number, instanceCount: number}}
+ */
+export function buildHatchLines(engine, { spacing, offset = 0 }) {
+  const byTemplate = new Map();
+  const extents = new WeakMap();
+  for (const [name, group] of engine.arcGroups.entries()) {
+    if (name.startsWith('outer_') || !group.templateKey) {
+      continue;
+    }
+    patternAnglesOf(group, engine).forEach((angle, layer) => {
+      const source = group._getPatternSource(spacing, angle, offset);
+      if (!source || !source.segments.length) {
+        return;
+      }
+      if (!byTemplate.has(group.templateKey)) {
+        byTemplate.set(group.templateKey, { ringIndex: group.ringIndex ?? 0, entries: [], vertexCount: 0 });
+      }
+      const entry = byTemplate.get(group.templateKey);
+      let vertices = 0;
+      for (const polyline of source.segments) {
+        vertices += 2 * (polyline.length - 1);
+      }
+      entry.entries.push({ source, angle, layer });
+      entry.vertexCount += vertices;
+    });
+  }
+
+  const templates = [];
+  let vertexCount = 0;
+  let instanceCount = 0;
+  for (const [key, { ringIndex, entries, vertexCount: count }] of byTemplate.entries()) {
+    const positions = new Float32Array(count * 3);
+    const texels = entries.length * HATCH_TEXELS_PER_INSTANCE;
+    const rows = Math.ceil(texels / HATCH_TEXTURE_WIDTH);
+    const instances = new Float32Array(rows * HATCH_TEXTURE_WIDTH * 4);
+    const bounds = [Infinity, Infinity, -Infinity, -Infinity];
+    let at = 0;
+    entries.forEach(({ source, angle, layer }, instance) => {
+      const { segments, transform } = source;
+      for (const polyline of segments) {
+        for (let i = 1; i < polyline.length; i += 1) {
+          positions[at] = polyline[i - 1].x;
+          positions[at + 1] = polyline[i - 1].y;
+          positions[at + 2] = instance;
+          positions[at + 3] = polyline[i].x;
+          positions[at + 4] = polyline[i].y;
+          positions[at + 5] = instance;
+          at += 6;
+        }
+      }
+      const { radius } = transform;
+      const base = instance * HATCH_TEXELS_PER_INSTANCE * 4;
+      instances[base] = radius * transform.cos;
+      instances[base + 1] = radius * transform.sin;
+      instances[base + 2] = transform.center.re;
+      instances[base + 3] = transform.center.im;
+      instances[base + 4] = ((angle % 180) + 180) % 180;
+      instances[base + 5] = layer;
+      const reach = Math.abs(radius) * hatchExtent(segments, extents);
+      bounds[0] = Math.min(bounds[0], transform.center.re - reach);
+      bounds[1] = Math.min(bounds[1], transform.center.im - reach);
+      bounds[2] = Math.max(bounds[2], transform.center.re + reach);
+      bounds[3] = Math.max(bounds[3], transform.center.im + reach);
+    });
+    templates.push({ key, ringIndex, positions, instances, instanceCount: entries.length, bounds });
+    vertexCount += count;
+    instanceCount += entries.length;
+  }
+  return { templates, vertexCount, instanceCount };
+}
+
+/**
+ * Renders `params` and builds its hatch lines, or returns null when the
+ * parameters have no fill pattern.
+ */
+export function renderHatchLines(params) {
+  if (!params || !params.add_fill_pattern) {
+    return null;
+  }
+  const result = renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
+  if (!result || !result.engine || !result.engine.arcGroups) {
+    throw new Error('could not generate geometry');
+  }
+  const scale = result.scaleFactor || 1;
+  return buildHatchLines(result.engine, {
+    spacing: (params.fill_pattern_spacing ?? 8) / scale,
+    offset: (params.fill_pattern_offset ?? 0) / scale,
+  });
+}
+
+export function hatchLineTransferables(lines) {
+  if (!lines) {
+    return [];
+  }
+  return lines.templates.flatMap(template => [template.positions.buffer, template.instances.buffer]);
+}
+
+/**
+ * Builds hatch lines in a worker (hatch_worker.js), or on a timer when no
+ * worker can be created. Every request supersedes the previous one: a reply
+ * that is no longer the latest resolves with null.
+ */
+export class HatchLinesClient {
+  constructor({ createWorker = null } = {}) {
+    this.createWorker = createWorker;
+    this.worker = null;
+    this.latestRequestId = 0;
+    this.pending = new Map();
+  }
+
+  _ensureWorker() {
+    if (this.worker || !this.createWorker) {
+      return this.worker;
+    }
+    const worker = this.createWorker();
+    worker.onmessage = event => {
+      const data = event.data || {};
+      const entry = this.pending.get(data.requestId);
+      if (!entry) {
+        return;
+      }
+      this.pending.delete(data.requestId);
+      if (data.type === 'error') {
+        entry.reject(new Error(data.message));
+      } else {
+        entry.resolve(data.requestId === this.latestRequestId ? data.lines : null);
+      }
+    };
+    worker.onerror = event => {
+      const error = new Error(event?.message || 'Hatch worker failed');
+      for (const entry of this.pending.values()) {
+        entry.reject(error);
+      }
+      this.pending.clear();
+      worker.terminate();
+      if (this.worker === worker) {
+        this.worker = null;
+      }
+    };
+    this.worker = worker;
+    return worker;
+  }
+
+  request(params) {
+    const requestId = ++this.latestRequestId;
+    const worker = this._ensureWorker();
+    if (!worker) {
+      return new Promise((resolve, reject) => {
+        setTimeout(() => {
+          if (requestId !== this.latestRequestId) {
+            resolve(null);
+            return;
+          }
+          try {
+            resolve(renderHatchLines(params));
+          } catch (error) {
+            reject(error);
+          }
+        }, 0);
+      });
+    }
+    return new Promise((resolve, reject) => {
+      this.pending.set(requestId, { resolve, reject });
+      worker.postMessage({ type: 'build', requestId, params });
+    });
+  }
+}
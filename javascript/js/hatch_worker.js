@@ -0,0 +1,19 @@
+import { renderHatchLines, hatchLineTransferables } from './hatch_lines.js';
+
+self.addEventListener('message', event => {
+  const data = event.data || {};
+  if (data.type !== 'build') {
+    return;
+  }
+  const { requestId, params } = data;
+  try {
+    const lines = renderHatchLines(params);
+    self.postMessage({ type: 'lines', requestId, lines }, hatchLineTransferables(lines));
+  } catch (error) {
+    self.postMessage({
+      type: 'error',
+      requestId,
+      message: error?.message || 'Hatch lines failed',
+    });
+  }
+});
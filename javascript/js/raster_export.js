@@ -0,0 +1,276 @@
+/**
+ * Raster engraving export for hatch patterns — pure functions with no DOM dependencies.
+ * Used by raster_worker.js and directly testable by vitest.
+ *
+ * Hatch geometry is scan-converted straight from segment geometry into a 1-bit
+ * image (0 = engrave/black, 1 = white). Rows are produced in bands of a fixed
+ * height so only one band is held in memory at a time, and each band is handed
+ * to a PNG or BMP encoder as soon as it is filled. The encoders pass every
+ * finished file part to an `onPart` callback when one is given, so a caller
+ * can forward the file without ever holding it whole.
+ *
+ * Input coordinates are millimetres in the DXF/G-code frame (origin bottom-left,
+ * Y up); image row 0 is the top edge of the bounding box.
+ */
+
+export const MM_PER_INCH = 25.4;
+const DEFAULT_BAND_ROWS = 256;
+
+/**
+ * Converts hatch paths from collectGCodeLayers into convex pixel-space quads.
+ * Open two-point paths become rectangles of the given stroke width; closed
+ * four-point paths (rectangle pattern) are filled as-is.
+ *
+ * @param {Array<{points: Array<{x: number, y: number}>, closed: boolean}>} paths
+ * @param {Object} opts
+ * @param {number} opts.dpi
+ * @param {number} opts.heightMm         - bounding box height (for the Y flip)
+ * @param {number} opts.strokeWidthMm    - hatch line width
+ * @returns {Array<Float64Array>} quads as [x0,y0,x1,y1,x2,y2,x3,y3] in pixels
+ */
+export function hatchPathsToQuads(paths, { dpi, heightMm, strokeWidthMm }) {
+  const pxPerMm = dpi / MM_PER_INCH;
+  // Never let a line vanish between pixel centres.
+  const half = Math.max(strokeWidthMm * pxPerMm, 1) / 2;
+  const quads = [];
+  for (const path of paths) {
+    const pts = path.points.map(p => ({ x: p.x * pxPerMm, y: (heightMm - p.y) * pxPerMm }));
+    if (path.closed && pts.length === 4) {
+      quads.push(Float64Array.of(pts[0].x, pts[0].y, pts[1].x, pts[1].y, pts[2].x, pts[2].y, pts[3].x, pts[3].y));
+      continue;
+    }
+    for (let i = 0; i + 1 < pts.length; i++) {
+      const a = pts[i];
+      const b = pts[i + 1];
+      const length = Math.hypot(b.x - a.x, b.y - a.y);
+      if (length <= 1e-9) continue;
+      const ox = -(b.y - a.y) / length * half;
+      const oy = (b.x - a.x) / length * half;
+      quads.push(Float64Array.of(a.x + ox, a.y + oy, b.x + ox, b.y + oy, b.x - ox, b.y - oy, a.x - ox, a.y - oy));
+    }
+  }
+  return quads;
+}
+
+/**
+ * Scan-converts convex quads into 1-bit rows, band by band. A pixel is set when
+ * its centre lies inside a quad.
+ *
+ * @param {Array<Float64Array>} quads - from hatchPathsToQuads
+ * @param {number} width  - image width in pixels
+ * @param {number} height - image height in pixels
+ * @param {Object} [opts]
+ * @param {number} [opts.bandRows=256]
+ * @yields {{rows: Uint8Array, rowStart: number, rowCount: number, stride: number}}
+ *   rows is reused between bands; consume it before requesting the next one.
+ */
+export function* rasterizeBands(quads, width, height, { bandRows = DEFAULT_BAND_ROWS } = {}) {
+  const stride = Math.ceil(width / 8);
+  const bandSize = Math.max(1, Math.floor(bandRows));
+  const buffer = new Uint8Array(stride * bandSize);
+
+  const items = quads.map(q => ({
+    q,
+    minY: Math.min(q[1], q[3], q[5], q[7]),
+    maxY: Math.max(q[1], q[3], q[5], q[7]),
+  })).sort((a, b) => a.minY - b.minY);
+
+  let next = 0;
+  let active = [];
+  for (let rowStart = 0; rowStart < height; rowStart += bandSize) {
+    const rowCount = Math.min(bandSize, height - rowStart);
+    const rows = buffer.subarray(0, stride * rowCount);
+    rows.fill(0xff);
+    const bandBottom = rowStart + rowCount;
+    while (next < items.length && items[next].minY < bandBottom) {
+      active.push(items[next]);
+      next += 1;
+    }
+    active = active.filter(item => item.maxY >= rowStart);
+
+    for (const { q, minY, maxY } of active) {
+      const r0 = Math.max(rowStart, Math.ceil(minY - 0.5));
+      const r1 = Math.min(bandBottom - 1, Math.floor(maxY - 0.5));
+      for (let r = r0; r <= r1; r++) {
+        const yc = r + 0.5;
+        let xMin = Infinity;
+        let xMax = -Infinity;
+        for (let e = 0; e < 8; e += 2) {
+          const x1 = q[e];
+          const y1 = q[e + 1];
+          const x2 = q[(e + 2) % 8];
+          const y2 = q[(e + 3) % 8];
+          if ((y1 <= yc && y2 > yc) || (y2 <= yc && y1 > yc)) {
+            const x = x1 + (yc - y1) / (y2 - y1) * (x2 - x1);
+            if (x < xMin) xMin = x;
+            if (x > xMax) xMax = x;
+          }
+        }
+        if (xMin > xMax) continue;
+        const c0 = Math.max(0, Math.ceil(xMin - 0.5));
+        const c1 = Math.min(width - 1, Math.floor(xMax - 0.5));
+        if (c0 > c1) continue;
+        clearBits(rows, (r - rowStart) * stride, c0, c1);
+      }
+    }
+    yield { rows, rowStart, rowCount, stride };
+  }
+}
+
+function clearBits(rows, offset, c0, c1) {
+  let byte0 = c0 >> 3;
+  const byte1 = c1 >> 3;
+  const headMask = 0xff >> (c0 & 7);
+  const tailMask = (0xff << (7 - (c1 & 7))) & 0xff;
+  if (byte0 === byte1) {
+    rows[offset + byte0] &= ~(headMask & tailMask);
+    return;
+  }
+  rows[offset + byte0] &= ~headMask;
+  for (byte0 += 1; byte0 < byte1; byte0++) {
+    rows[offset + byte0] = 0;
+  }
+  rows[offset + byte1] &= ~tailMask;
+}
+
+// ── PNG ──────────────────────────────────────────────────────────────────
+
+const CRC_TABLE = (() => {
+  const table = new Uint32Array(256);
+  for (let n = 0; n < 256; n++) {
+    let c = n;
+    for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+    table[n] = c >>> 0;
+  }
+  return table;
+})();
+
+function crc32(bytes, crc = 0xffffffff) {
+  for (let i = 0; i < bytes.length; i++) crc = CRC_TABLE[(crc ^ bytes[i]) & 0xff] ^ (crc >>> 8);
+  return crc;
+}
+
+export function pngChunk(type, data) {
+  const out = new Uint8Array(12 + data.length);
+  const view = new DataView(out.buffer);
+  view.setUint32(0, data.length);
+  for (let i = 0; i < 4; i++) out[4 + i] = type.charCodeAt(i);
+  out.set(data, 8);
+  view.setUint32(8 + data.length, (crc32(out.subarray(4, 8 + data.length)) ^ 0xffffffff) >>> 0);
+  return out;
+}
+
+/**
+ * Encodes bands from rasterizeBands as a 1-bit greyscale PNG. Rows are fed to a
+ * zlib CompressionStream as they arrive and every compressed piece becomes its
+ * own IDAT chunk, so neither the raw image nor the compressed stream is ever
+ * assembled in one buffer.
+ *
+ * @param {Iterable} bands - from rasterizeBands
+ * @param {number} width
+ * @param {number} height
+ * @param {number} dpi
+ * @param {(part: Uint8Array) => void} [onPart] - receives each part instead of the returned list
+ * @returns {Promise<Array<Uint8Array>>} file parts, suitable for new Blob(parts); empty with onPart
+ */
+export async function encodePNG1Bit(bands, width, height, dpi, onPart = null) {
+  const parts = [];
+  const emit = onPart || (part => parts.push(part));
+  emit(Uint8Array.of(0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a));
+  const ihdr = new Uint8Array(13);
+  const ihdrView = new DataView(ihdr.buffer);
+  ihdrView.setUint32(0, width);
+  ihdrView.setUint32(4, height);
+  ihdr[8] = 1;  // bit depth
+  ihdr[9] = 0;  // greyscale
+  emit(pngChunk('IHDR', ihdr));
+  const phys = new Uint8Array(9);
+  const ppm = Math.round(dpi / MM_PER_INCH * 1000);
+  new DataView(phys.buffer).setUint32(0, ppm);
+  new DataView(phys.buffer).setUint32(4, ppm);
+  phys[8] = 1;  // unit: metre
+  emit(pngChunk('pHYs', phys));
+
+  const stream = new CompressionStream('deflate');
+  const writer = stream.writable.getWriter();
+  const reader = stream.readable.getReader();
+  const drained = (async () => {
+    for (;;) {
+      const { value, done } = await reader.read();
+      if (done) break;
+      if (value && value.length) emit(pngChunk('IDAT', value));
+    }
+  })();
+
+  for (const { rows, rowCount, stride } of bands) {
+    // Each scanline is prefixed with filter type 0 (None).
+    const filtered = new Uint8Array(rowCount * (stride + 1));
+    for (let r = 0; r < rowCount; r++) {
+      filtered.set(rows.subarray(r * stride, (r + 1) * stride), r * (stride + 1) + 1);
+    }
+    await writer.ready;
+    writer.write(filtered);
+  }
+  await writer.close();
+  await drained;
+  emit(pngChunk('IEND', new Uint8Array(0)));
+  return parts;
+}
+
+// ── BMP ──────────────────────────────────────────────────────────────────
+
+/**
+ * Encodes bands from rasterizeBands as an uncompressed 1-bit top-down BMP.
+ *
+ * @param {Iterable} bands - from rasterizeBands
+ * @param {number} width
+ * @param {number} height
+ * @param {number} dpi
+ * @param {(part: Uint8Array) => void} [onPart] - receives each part instead of the returned list
+ * @returns {Array<Uint8Array>} file parts, suitable for new Blob(parts); empty with onPart
+ */
+export function encodeBMP1Bit(bands, width, height, dpi, onPart = null) {
+  const bmpStride = Math.ceil(width / 32) * 4;
+  const headerSize = 14 + 40 + 8;
+  const header = new Uint8Array(headerSize);
+  const view = new DataView(header.buffer);
+  const ppm = Math.round(dpi / MM_PER_INCH * 1000);
+  header[0] = 0x42;
+  header[1] = 0x4d;
+  view.setUint32(2, headerSize + bmpStride * height, true);
+  view.setUint32(10, headerSize, true);
+  view.setUint32(14, 40, true);
+  view.setInt32(18, width, true);
+  view.setInt32(22, -height, true); // negative height: rows stored top-down
+  view.setUint16(26, 1, true);
+  view.setUint16(28, 1, true);
+  view.setUint32(34, bmpStride * height, true);
+  view.setInt32(38, ppm, true);
+  view.setInt32(42, ppm, true);
+  view.setUint32(46, 2, true);
+  // Palette: index 0 black, index 1 white.
+  header.set([0, 0, 0, 0, 0xff, 0xff, 0xff, 0], 54);
+
+  const parts = [];
+  const emit = onPart || (part => parts.push(part));
+  emit(header);
+  for (const { rows, rowCount, stride } of bands) {
+    const out = new Uint8Array(rowCount * bmpStride);
+    for (let r = 0; r < rowCount; r++) {
+      out.set(rows.subarray(r * stride, (r + 1) * stride), r * bmpStride);
+    }
+    emit(out);
+  }
+  return parts;
+}
+
+/**
+ * Image size in pixels for a bounding box at the given DPI.
+ */
+export function rasterSize(widthMm, heightMm, dpi) {
+  const pxPerMm = dpi / MM_PER_INCH;
+  return {
+    width: Math.max(1, Math.ceil(widthMm * pxPerMm)),
+    height: Math.max(1, Math.ceil(heightMm * pxPerMm)),
+  };
+}
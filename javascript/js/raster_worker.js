@@ -0,0 +1,136 @@
+import { Zip, ZipDeflate, ZipPassThrough } from 'https://cdn.jsdelivr.net/npm/fflate@0.8.2/esm/browser.js';
+import { renderSpiral } from './doyle_spiral_engine.js';
+import { collectGCodeLayers } from './gcode_export.js';
+import { hatchPathsToQuads, rasterizeBands, encodePNG1Bit, encodeBMP1Bit, rasterSize } from './raster_export.js';
+
+// The file leaves the worker as 'chunk' messages while it is encoded (zipped
+// here when it has several entries), so neither side ever holds it whole; the
+// page writes the chunks to disk or collects them into a Blob.
+
+let activeRequest = null;
+
+self.addEventListener('message', async event => {
+  const data = event.data || {};
+  if (data.type === 'cancel') {
+    activeRequest = null;
+    return;
+  }
+  if (data.type !== 'raster') {
+    return;
+  }
+  const { requestId, params, options = {}, angleOverrides = null } = data;
+  activeRequest = requestId;
+  const postChunk = bytes => {
+    if (!bytes.length) return;
+    // Only whole buffers are transferred; views into a larger one are copied.
+    const own = bytes.byteOffset === 0 && bytes.byteLength === bytes.buffer.byteLength ? bytes : bytes.slice();
+    self.postMessage({ type: 'chunk', requestId, bytes: own }, [own.buffer]);
+  };
+  try {
+    const dpi = Math.max(1, Number(options.dpi) || 600);
+    const format = options.format === 'bmp' ? 'bmp' : 'png';
+    const result = renderSpiral({ ...params, mode: 'arram_boyle', add_fill_pattern: true }, 'arram_boyle', {
+      arcGroupAngleOverrides: angleOverrides,
+    });
+    const opts = result.params;
+    const widthMm = opts.bounding_box_width_mm;
+    const heightMm = opts.bounding_box_height_mm;
+    const layers = collectGCodeLayers(result.engine.arcGroups, result.scaleFactor, widthMm, heightMm, {
+      drawGroupOutline: false,
+      redOutline: false,
+      addFillPattern: true,
+      fillPatternSpacing: opts.fill_pattern_spacing,
+      fillPatternOffset: opts.fill_pattern_offset,
+      fillPatternType: opts.fill_pattern_type,
+      fillPatternRectWidth: opts.fill_pattern_rect_width,
+      layerCount: opts.svg_layers ? opts.svg_layer_count : 0,
+    }).filter(layer => layer.kind === 'HATCH');
+
+    const { width, height } = rasterSize(widthMm, heightMm, dpi);
+    if (!layers.length) {
+      self.postMessage({ type: 'done', requestId, width, height, dpi, fileCount: 0 });
+      return;
+    }
+
+    // The page picks the file name before the worker starts, so it decides
+    // whether the layers come as one image or as a ZIP.
+    let zipError = null;
+    const zip = options.zip
+      ? new Zip((error, chunk) => {
+        if (error) zipError = error;
+        else postChunk(chunk);
+      })
+      : null;
+    const openFile = (name, compress) => {
+      if (!zip) {
+        return { push: postChunk, close() {} };
+      }
+      // PNG data is already deflated; storing it avoids a second compression pass.
+      const entry = compress ? new ZipDeflate(name, { level: 6 }) : new ZipPassThrough(name);
+      zip.add(entry);
+      return {
+        push: part => entry.push(part),
+        close: () => entry.push(new Uint8Array(0), true),
+      };
+    };
+
+    let fileCount = 0;
+    for (let idx = 0; idx < layers.length; idx += 1) {
+      const layer = layers[idx];
+      const quads = hatchPathsToQuads(layer.paths, { dpi, heightMm, strokeWidthMm: opts.pattern_stroke_width });
+      const bands = (function* reportProgress() {
+        for (const band of rasterizeBands(quads, width, height, { bandRows: options.bandRows })) {
+          if (activeRequest !== requestId) {
+            throw new Error('Raster export cancelled');
+          }
+          self.postMessage({
+            type: 'progress',
+            requestId,
+            layer: layer.name,
+            layerIndex: idx,
+            layerCount: layers.length,
+            fraction: (band.rowStart + band.rowCount) / height,
+          });
+          yield band;
+        }
+      })();
+      const file = openFile(`${layer.name.toLowerCase()}.${format}`, format === 'bmp');
+      if (format === 'bmp') {
+        encodeBMP1Bit(bands, width, height, dpi, file.push);
+      } else {
+        await encodePNG1Bit(bands, width, height, dpi, file.push);
+      }
+      file.close();
+      fileCount += 1;
+    }
+
+    if (zip && options.vectorOutlines) {
+      const outlineResult = renderSpiral({ ...params, mode: 'arram_boyle', add_fill_pattern: false, draw_group_outline: true }, 'arram_boyle');
+      const file = openFile('outlines.svg', true);
+      file.push(new TextEncoder().encode(outlineResult.svgString || ''));
+      file.close();
+      fileCount += 1;
+    }
+    if (zip) {
+      zip.end();
+    }
+    if (zipError) {
+      throw zipError;
+    }
+
+    if (activeRequest !== requestId) {
+      return;
+    }
+    self.postMessage({ type: 'done', requestId, width, height, dpi, fileCount });
+  } catch (error) {
+    if (activeRequest !== requestId) {
+      return;
+    }
+    self.postMessage({
+      type: 'error',
+      requestId,
+      message: error?.message || 'Raster export failed',
+      errorType: error?.name || 'Error',
+    });
+  }
+});
@@ -1,4 +1,5 @@
 import { renderSpiral } from './doyle_spiral_engine.js';
+import { storeGeometry, publishGeometry } from './geometry_store.js';
 
 let activeRequest = null;
 
@@ -7,21 +8,39 @@ self.addEventListener('message', event => {
   if (data.type !== 'render') {
     return;
   }
-  const { requestId, params } = data;
+  const { requestId, params, angleOverrides = null } = data;
   activeRequest = requestId;
   try {
-    const result = renderSpiral(params || {});
+    // Animator renders carry per-cell hatch angles (see animator.js).
+    const result = renderSpiral(params || {}, null, { arcGroupAngleOverrides: angleOverrides });
     if (activeRequest !== requestId) {
       return;
     }
+    // `geometryStore` asks for the outlines in a published geometry store
+    // (geometry_store.js), shared with the page when it is cross-origin
+    // isolated. Otherwise compact geometry packs all outlines into one typed
+    // array; either way the buffer is transferred instead of copied.
+    let geometry = result.geometry || null;
+    let geometryStore = null;
+    let transfer = [];
+    if (data.geometryStore && geometry) {
+      geometryStore = publishGeometry(storeGeometry(geometry, data.geometryStore));
+      geometry = null;
+      transfer = geometryStore.shared ? [] : [geometryStore.buffer];
+    } else {
+      const packed = geometry?.arcgroups?.[0]?.outline;
+      transfer = ArrayBuffer.isView(packed) ? [packed.buffer] : [];
+    }
     self.postMessage({
       type: 'result',
       requestId,
       svgString: result.svgString || '',
-      geometry: result.geometry || null,
+      geometry,
+      geometryStore,
       mode: result.mode || null,
       params: result.params || null,
-    });
+      scaleFactor: result.scaleFactor ?? null,
+    }, transfer);
   } catch (error) {
     let message = 'Render failed';
 
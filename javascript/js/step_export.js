@@ -103,16 +103,37 @@ function buildSolid(pts2d, thickness, emit) {
   return emit(`FACETED_BREP('',#${shell})`);
 }
 
-function buildSTEPFile(polylines2d, thickness, name) {
-  const entityLines = [];
+/**
+ * Writes a STEP file for `polylines2d` (any iterable) to `write`, one entity
+ * per chunk. Nothing is written when no polyline gives a solid; the header
+ * goes out just before the first entity.
+ *
+ * @returns {boolean} whether a file was written
+ */
+function writeSTEPFile(polylines2d, thickness, name, write) {
   let nextId = 1;
-  const emit = s => { const id = nextId++; entityLines.push(`#${id}=${s};`); return id; };
-
-  const solidIds = polylines2d
-    .map(pts => buildSolid(pts, thickness, emit))
-    .filter(id => id !== null);
+  const emit = s => {
+    const id = nextId++;
+    if (id === 1) {
+      write([
+        'ISO-10303-21;', 'HEADER;',
+        `FILE_DESCRIPTION(('${name}'),'2;1');`,
+        `FILE_NAME('${name}.stp','2024-01-01T00:00:00',(''),(''),'','','');`,
+        "FILE_SCHEMA(('AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }'));",
+        'ENDSEC;', 'DATA;',
+      ].join('\n'));
+    }
+    write(`\n#${id}=${s};`);
+    return id;
+  };
+
+  const solidIds = [];
+  for (const pts of polylines2d) {
+    const id = buildSolid(pts, thickness, emit);
+    if (id !== null) solidIds.push(id);
+  }
 
-  if (solidIds.length === 0) return null;
+  if (solidIds.length === 0) return false;
 
   const mm  = emit('( LENGTH_UNIT() NAMED_UNIT(*) SI_UNIT(.MILLI.,.METRE.) )');
   const rad = emit('( NAMED_UNIT(*) PLANE_ANGLE_UNIT() SI_UNIT($,.RADIAN.) )');
@@ -134,15 +155,49 @@ function buildSTEPFile(polylines2d, thickness, name) {
   const absr = emit(`ADVANCED_BREP_SHAPE_REPRESENTATION('',(#${ax},${solidIds.map(s=>'#'+s).join(',')}),#${ctx})`);
   emit(`SHAPE_DEFINITION_REPRESENTATION(#${pds},#${absr})`);
 
-  return [
-    'ISO-10303-21;', 'HEADER;',
-    `FILE_DESCRIPTION(('${name}'),'2;1');`,
-    `FILE_NAME('${name}.stp','2024-01-01T00:00:00',(''),(''),'','','');`,
-    "FILE_SCHEMA(('AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }'));",
-    'ENDSEC;', 'DATA;',
-    ...entityLines,
-    'ENDSEC;', 'END-ISO-10303-21;',
-  ].join('\n');
+  write('\nENDSEC;\nEND-ISO-10303-21;');
+  return true;
+}
+
+function buildSTEPFile(polylines2d, thickness, name) {
+  const chunks = [];
+  return writeSTEPFile(polylines2d, thickness, name, text => chunks.push(text)) ? chunks.join('') : null;
+}
+
+// Outlines of a whole render as mm polylines, produced one group at a time.
+function* spiralPolylines(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts) {
+  if (opts.drawGroupOutline === false) return;
+  for (const [key, group] of arcGroups.entries()) {
+    if (key.startsWith('outer_')) continue;
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 3) continue;
+    yield outline.map(pt => [
+      pt.re * scaleFactor + boundingWidthMm / 2,
+      -(pt.im * scaleFactor) + boundingHeightMm / 2,
+    ]);
+  }
+}
+
+function stepThickness(opts) {
+  return (opts.thickness != null && opts.thickness > 0) ? opts.thickness : 1;
+}
+
+/**
+ * Streaming counterpart of generateSTEP(): writes the file to `write` one
+ * entity at a time. The chunks concatenate to generateSTEP() with the same
+ * arguments, and nothing is written when that would return null.
+ *
+ * @param {Map<string, ArcGroup>} arcGroups
+ * @param {number} scaleFactor        - mm per internal unit
+ * @param {number} boundingWidthMm
+ * @param {number} boundingHeightMm
+ * @param {Object} opts               - as for generateSTEP()
+ * @param {(text: string) => void} write
+ * @returns {boolean} whether a file was written
+ */
+export function writeSTEP(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts, write) {
+  const polylines = spiralPolylines(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts);
+  return writeSTEPFile(polylines, stepThickness(opts), opts.name || 'doyle-spiral', write);
 }
 
 /**
@@ -157,28 +212,8 @@ function buildSTEPFile(polylines2d, thickness, name) {
  * @returns {string|null} STEP file contents, or null if no geometry
  */
 export function generateSTEP(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts = {}) {
-  const drawGroupOutline = opts.drawGroupOutline !== false;
-  const thickness = (opts.thickness != null && opts.thickness > 0) ? opts.thickness : 1;
-  const name = opts.name || 'doyle-spiral';
-
-  function ptToArr(re, im) {
-    return [
-      re * scaleFactor + boundingWidthMm / 2,
-      -(im * scaleFactor) + boundingHeightMm / 2,
-    ];
-  }
-
-  const polylines = [];
-  if (drawGroupOutline) {
-    for (const [key, group] of arcGroups.entries()) {
-      if (key.startsWith('outer_')) continue;
-      const outline = group.getClosedOutline();
-      if (!outline || outline.length < 3) continue;
-      polylines.push(outline.map(pt => ptToArr(pt.re, pt.im)));
-    }
-  }
-
-  return buildSTEPFile(polylines, thickness, name);
+  const polylines = spiralPolylines(arcGroups, scaleFactor, boundingWidthMm, boundingHeightMm, opts);
+  return buildSTEPFile(polylines, stepThickness(opts), opts.name || 'doyle-spiral');
 }
 
 /**
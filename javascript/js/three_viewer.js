@@ -3,8 +3,79 @@
  * The viewer is designed to be reusable.  Call createThreeViewer with DOM
  * references and a geometryFetcher callback that returns Arram-Boyle geometry
  * for given spiral parameters.
+ *
+ * With a `hatchLines` source (a HatchLinesClient from hatch_lines.js) the
+ * fill hatch is drawn over the polygons as one LineSegments per ring template,
+ * placed from template space in the vertex shader. Hatch lines need WebGL2.
+ *
+ * Polygons are extruded at a detail level chosen from their size on screen
+ * (bevelled, flat, or flat with a decimated outline) within a global triangle
+ * budget, and levels are re-chosen once zooming settles. Frames are drawn on
+ * demand: the loop only keeps running while the spiral rotates, a pulse is
+ * fading or the pointer drags, and stops while the canvas or tab is hidden.
  */
 
+import { decodeOutline } from './doyle_spiral_engine.js';
+import { HATCH_TEXELS_PER_INSTANCE, HATCH_TEXTURE_WIDTH } from './hatch_lines.js';
+
+// Angular distance within which groups pulse and hatch lines glint.
+const GLINT_THRESHOLD_DEG = 20;
+// Hatch lines sit just above the extruded faces (depth 0.05 plus bevel 0.01),
+// one pattern layer per 0.02 like the stacked meshes.
+const HATCH_LIFT = 0.061;
+const HATCH_LAYER_STEP = 0.02;
+
+const EXTRUDE_DEPTH = 0.05;
+const BEVEL_SIZE = 0.01;
+const BEVEL_SEGMENTS = 2;
+// Detail levels, from coarsest to finest.
+const DETAIL_SIMPLIFIED = 0;
+const DETAIL_FLAT = 1;
+const DETAIL_BEVELLED = 2;
+// Smallest on-screen size (pixels) that earns a bevel or the full outline.
+const BEVEL_MIN_PIXELS = 24;
+const FULL_OUTLINE_MIN_PIXELS = 6;
+const SIMPLIFIED_OUTLINE_POINTS = 12;
+const TRIANGLE_BUDGET = 400000;
+// Zooming re-chooses detail levels once the wheel has been still this long.
+const DETAIL_SETTLE_MS = 250;
+
+const HATCH_VERTEX_SHADER = `
+precision highp sampler2D;
+
+uniform sampler2D instanceData;
+uniform float rotationDeg;
+uniform float glintThreshold;
+uniform float lift;
+uniform float layerStep;
+varying float vGlint;
+
+void main() {
+  int texel = int(position.z + 0.5) * ${HATCH_TEXELS_PER_INSTANCE};
+  ivec2 at = ivec2(texel % ${HATCH_TEXTURE_WIDTH}, texel / ${HATCH_TEXTURE_WIDTH});
+  vec4 place = texelFetch(instanceData, at, 0);
+  vec4 meta = texelFetch(instanceData, at + ivec2(1, 0), 0);
+  vec2 world = vec2(
+    place.x * position.x - place.y * position.y + place.z,
+    place.y * position.x + place.x * position.y + place.w
+  );
+  float diff = mod(rotationDeg - meta.x, 180.0);
+  diff = min(diff, 180.0 - diff);
+  vGlint = 1.0 - smoothstep(0.0, glintThreshold, diff);
+  gl_Position = projectionMatrix * modelViewMatrix * vec4(world, lift + layerStep * meta.y, 1.0);
+}
+`;
+
+const HATCH_FRAGMENT_SHADER = `
+uniform vec3 color;
+uniform vec3 glintColor;
+varying float vGlint;
+
+void main() {
+  gl_FragColor = vec4(mix(color, glintColor, vGlint), 1.0);
+}
+`;
+
 function clamp(value, min, max) {
   return Math.min(max, Math.max(min, value));
 }
@@ -21,6 +92,69 @@ function angularDifferenceDeg(a, b) {
   return Math.min(diff, 180 - diff);
 }
 
+/**
+ * Keeps at most `maxPoints` of an outline, evenly spaced along its points.
+ */
+function simplifyOutline(outline, maxPoints = SIMPLIFIED_OUTLINE_POINTS) {
+  if (outline.length <= maxPoints) {
+    return outline;
+  }
+  const simplified = [];
+  for (let i = 0; i < maxPoints; i += 1) {
+    simplified.push(outline[Math.floor((i * outline.length) / maxPoints)]);
+  }
+  return simplified;
+}
+
+function detailPointCount(points, level) {
+  return level === DETAIL_SIMPLIFIED ? Math.min(points, SIMPLIFIED_OUTLINE_POINTS) : points;
+}
+
+/**
+ * Triangles ExtrudeGeometry builds for an outline of `points` points: two caps
+ * plus a two-triangle quad per edge for the wall and for each bevel layer.
+ */
+function estimateExtrudeTriangles(points, level) {
+  const n = detailPointCount(points, level);
+  const layers = 1 + (level === DETAIL_BEVELLED ? 2 * BEVEL_SEGMENTS : 0);
+  return 2 * Math.max(0, n - 2) + 2 * n * layers;
+}
+
+/**
+ * Picks a detail level per polygon from its size on screen, then coarsens the
+ * smallest polygons first until the estimated triangles fit the budget.
+ *
+ * @param {Array<{pixels: number, points: number, copies: number}>} items
+ * @param {number} [budget]
+ * @returns {number[]} detail level per item
+ */
+function chooseDetailLevels(items, budget = TRIANGLE_BUDGET) {
+  const levels = items.map(({ pixels }) => {
+    if (pixels >= BEVEL_MIN_PIXELS) {
+      return DETAIL_BEVELLED;
+    }
+    return pixels >= FULL_OUTLINE_MIN_PIXELS ? DETAIL_FLAT : DETAIL_SIMPLIFIED;
+  });
+  const cost = (item, level) => estimateExtrudeTriangles(item.points, level) * (item.copies || 1);
+  let total = items.reduce((sum, item, index) => sum + cost(item, levels[index]), 0);
+  if (total <= budget) {
+    return levels;
+  }
+  const bySize = items.map((_, index) => index).sort((a, b) => items[a].pixels - items[b].pixels);
+  for (const from of [DETAIL_BEVELLED, DETAIL_FLAT]) {
+    for (const index of bySize) {
+      if (total <= budget) {
+        return levels;
+      }
+      if (levels[index] === from) {
+        total += cost(items[index], from - 1) - cost(items[index], from);
+        levels[index] = from - 1;
+      }
+    }
+  }
+  return levels;
+}
+
 function createThreeViewer({
   canvas,
   statusElement,
@@ -28,6 +162,8 @@ function createThreeViewer({
   controls = {},
   geometryFetcher,
   getParams,
+  onGeometryFrame = null,
+  hatchLines = null,
 }) {
   if (!canvas || !geometryFetcher) {
     throw new Error('createThreeViewer requires a canvas and a geometryFetcher.');
@@ -115,13 +251,21 @@ function createThreeViewer({
   }
 
   function clearSpiral() {
+    hatchRequest += 1;
+    for (const polygon of polygons) {
+      polygon.geometries.forEach(geometry => geometry && geometry.dispose());
+    }
+    polygons = [];
     spiralContainer.children.forEach(mesh => {
-      if (mesh.geometry) {
+      if (mesh.geometry && !mesh.userData.polygon) {
         mesh.geometry.dispose();
       }
       if (mesh.material) {
         mesh.material.dispose();
       }
+      if (mesh.userData.instanceTexture) {
+        mesh.userData.instanceTexture.dispose();
+      }
     });
     spiralContainer.clear();
     spiralContainer.position.set(0, 0, 0);
@@ -129,22 +273,31 @@ function createThreeViewer({
     spiralContainer.scale.set(1, 1, 1);
   }
 
-  function createPolygonMesh(outline, ringIndex = 0, lineAngle = 0) {
-    if (!outline || outline.length < 3) {
-      return null;
-    }
-    const shape = new THREE.Shape();
-    shape.moveTo(outline[0][0], outline[0][1]);
-    for (let i = 1; i < outline.length; i += 1) {
-      shape.lineTo(outline[i][0], outline[i][1]);
+  // Extruded geometry of one group at one detail level, shared by the meshes
+  // of its pattern layers and kept until the geometry is cleared.
+  function detailGeometry(polygon, level) {
+    if (!polygon.geometries[level]) {
+      const outline = level === DETAIL_SIMPLIFIED ? simplifyOutline(polygon.outline) : polygon.outline;
+      const shape = new THREE.Shape();
+      shape.moveTo(outline[0][0], outline[0][1]);
+      for (let i = 1; i < outline.length; i += 1) {
+        shape.lineTo(outline[i][0], outline[i][1]);
+      }
+      polygon.geometries[level] = new THREE.ExtrudeGeometry(shape, level === DETAIL_BEVELLED
+        ? {
+          depth: EXTRUDE_DEPTH,
+          bevelEnabled: true,
+          bevelThickness: BEVEL_SIZE,
+          bevelSize: BEVEL_SIZE,
+          bevelSegments: BEVEL_SEGMENTS,
+        }
+        : { depth: EXTRUDE_DEPTH, bevelEnabled: false });
     }
-    const geometry = new THREE.ExtrudeGeometry(shape, {
-      depth: 0.05,
-      bevelEnabled: true,
-      bevelThickness: 0.01,
-      bevelSize: 0.01,
-      bevelSegments: 2,
-    });
+    return polygon.geometries[level];
+  }
+
+  function createPolygonMesh(polygon, ringIndex = 0, lineAngle = 0) {
+    const geometry = detailGeometry(polygon, polygon.level);
     const material = new THREE.MeshStandardMaterial({
       color: getColorForRing(ringIndex),
       metalness: parseFloat(metalnessSlider ? metalnessSlider.value : '0.4') || 0.4,
@@ -156,6 +309,7 @@ function createThreeViewer({
     mesh.receiveShadow = true;
     mesh.userData = {
       ringIndex,
+      polygon,
       lineAngle: normaliseOrientationDeg(lineAngle),
       isPulsing: false,
       wasInRange: false,
@@ -164,31 +318,108 @@ function createThreeViewer({
     return mesh;
   }
 
+  function createHatchLines(template) {
+    const geometry = new THREE.BufferGeometry();
+    geometry.setAttribute('position', new THREE.BufferAttribute(template.positions, 3));
+    // Positions are template-local, so bounds come from the packed instances.
+    const [minX, minY, maxX, maxY] = template.bounds;
+    const top = HATCH_LIFT + HATCH_LAYER_STEP * 2;
+    geometry.boundingBox = new THREE.Box3(
+      new THREE.Vector3(minX, minY, HATCH_LIFT),
+      new THREE.Vector3(maxX, maxY, top),
+    );
+    geometry.boundingSphere = geometry.boundingBox.getBoundingSphere(new THREE.Sphere());
+    const rows = template.instances.length / (HATCH_TEXTURE_WIDTH * 4);
+    const instanceTexture = new THREE.DataTexture(
+      template.instances,
+      HATCH_TEXTURE_WIDTH,
+      rows,
+      THREE.RGBAFormat,
+      THREE.FloatType,
+    );
+    instanceTexture.needsUpdate = true;
+    const material = new THREE.ShaderMaterial({
+      uniforms: {
+        instanceData: { value: instanceTexture },
+        rotationDeg: { value: 0 },
+        glintThreshold: { value: GLINT_THRESHOLD_DEG },
+        lift: { value: HATCH_LIFT },
+        layerStep: { value: HATCH_LAYER_STEP },
+        color: { value: new THREE.Color(0x1a2233) },
+        glintColor: { value: new THREE.Color(0xffd700) },
+      },
+      vertexShader: HATCH_VERTEX_SHADER,
+      fragmentShader: HATCH_FRAGMENT_SHADER,
+    });
+    const lines = new THREE.LineSegments(geometry, material);
+    lines.userData = { ringIndex: template.ringIndex, instanceTexture };
+    return lines;
+  }
+
+  // Adds the hatch for `params` unless other geometry was loaded meanwhile.
+  async function loadHatchLines(params) {
+    if (!hatchLines || !params || !renderer.capabilities.isWebGL2) {
+      return;
+    }
+    const request = hatchRequest;
+    let lines = null;
+    try {
+      lines = await hatchLines.request(params);
+    } catch (error) {
+      console.error(error);
+      return;
+    }
+    if (!lines || request !== hatchRequest) {
+      return;
+    }
+    for (const template of lines.templates) {
+      spiralContainer.add(createHatchLines(template));
+    }
+    requestRender();
+  }
+
   function loadSpiralFromJSON(data) {
     if (!data || !Array.isArray(data.arcgroups)) {
       throw new Error('Invalid geometry payload');
     }
     clearSpiral();
+    geometryFramePending = true;
     if (Number.isFinite(data.fill_pattern_spacing) && data.fill_pattern_spacing > 0) {
       fillPatternSpacing = data.fill_pattern_spacing;
     }
+    // Bounds come from the outlines: the detail levels depend on the scale.
+    const box = new THREE.Box3();
+    const point = new THREE.Vector3();
     data.arcgroups.forEach(group => {
+      const outline = decodeOutline(group);
+      if (!outline || outline.length < 3) {
+        return;
+      }
       const patternAngles = Array.isArray(group.line_patterns) && group.line_patterns.length
         ? group.line_patterns.slice(0, 3)
         : [group.line_angle];
-      patternAngles.forEach((angle, index) => {
-        const mesh = createPolygonMesh(group.outline || [], group.ring_index, angle);
-        if (mesh) {
-          mesh.userData.patternIndex = index;
-          if (index > 0) {
-            mesh.position.z += 0.02 * index;
-          }
-          spiralContainer.add(mesh);
-        }
+      let minX = Infinity;
+      let minY = Infinity;
+      let maxX = -Infinity;
+      let maxY = -Infinity;
+      for (const [x, y] of outline) {
+        minX = Math.min(minX, x);
+        minY = Math.min(minY, y);
+        maxX = Math.max(maxX, x);
+        maxY = Math.max(maxY, y);
+      }
+      box.expandByPoint(point.set(minX, minY, -BEVEL_SIZE));
+      box.expandByPoint(point.set(maxX, maxY, EXTRUDE_DEPTH + BEVEL_SIZE + 0.02 * (patternAngles.length - 1)));
+      polygons.push({
+        outline,
+        extent: Math.max(maxX - minX, maxY - minY),
+        ringIndex: group.ring_index,
+        patternAngles,
+        geometries: [],
+        level: DETAIL_BEVELLED,
       });
     });
-    if (spiralContainer.children.length) {
-      const box = new THREE.Box3().setFromObject(spiralContainer);
+    if (polygons.length) {
       const center = box.getCenter(new THREE.Vector3());
       const size = box.getSize(new THREE.Vector3());
       const maxDimension = Math.max(size.x, size.y, size.z, 1e-6);
@@ -196,7 +427,19 @@ function createThreeViewer({
       spiralContainer.position.set(-center.x * scale, -center.y * scale, -center.z * scale);
       spiralContainer.scale.setScalar(scale);
       resetView();
+      chooseDetail();
     }
+    for (const polygon of polygons) {
+      polygon.patternAngles.forEach((angle, index) => {
+        const mesh = createPolygonMesh(polygon, polygon.ringIndex, angle);
+        mesh.userData.patternIndex = index;
+        if (index > 0) {
+          mesh.position.z += 0.02 * index;
+        }
+        spiralContainer.add(mesh);
+      });
+    }
+    requestRender();
     if (statsContainer) {
       statsContainer.hidden = false;
     }
@@ -214,18 +457,74 @@ function createThreeViewer({
   let pulseSpeed = pulseSpeedSlider ? parseFloat(pulseSpeedSlider.value) : 1.0;
   let animationStart = performance.now();
   let fillPatternSpacing = 9;
+  let geometryFramePending = false; // Report the first frame drawn after new geometry
+  let hatchRequest = 0; // Bumped per geometry load; stale hatch replies are dropped
+  let polygons = []; // One entry per group: outline, extent, detail level and its geometries
+  let frameHandle = null; // Pending animation frame, null while the loop sleeps
+  let detailTimer = null;
+
+  function pixelsPerUnit() {
+    const height = canvas.clientHeight || 600;
+    const viewHeight = 2 * cameraDistance * Math.tan(THREE.MathUtils.degToRad(camera.fov / 2));
+    return (spiralContainer.scale.x * height) / viewHeight;
+  }
 
+  // Re-chooses every polygon's detail level; true when any level changed.
+  function chooseDetail() {
+    const perUnit = pixelsPerUnit();
+    const levels = chooseDetailLevels(polygons.map(polygon => ({
+      pixels: polygon.extent * perUnit,
+      points: polygon.outline.length,
+      copies: polygon.patternAngles.length,
+    })));
+    let changed = false;
+    polygons.forEach((polygon, index) => {
+      if (polygon.level !== levels[index]) {
+        polygon.level = levels[index];
+        changed = true;
+      }
+    });
+    return changed;
+  }
+
+  function applyDetail() {
+    detailTimer = null;
+    if (!chooseDetail()) {
+      return;
+    }
+    for (const mesh of spiralContainer.children) {
+      const { polygon } = mesh.userData;
+      if (polygon) {
+        mesh.geometry = detailGeometry(polygon, polygon.level);
+      }
+    }
+    requestRender();
+  }
+
+  function scheduleDetail() {
+    if (detailTimer) {
+      clearTimeout(detailTimer);
+    }
+    detailTimer = setTimeout(applyDetail, DETAIL_SETTLE_MS);
+  }
+
+  // Returns true while any pulse is still fading.
   function updateMaterialsForRotation(rotationAngleDeg, timeSec) {
     if (!spiralContainer.children.length) {
-      return;
+      return false;
     }
-    const threshold = 20;
+    let pulsing = false;
+    const threshold = GLINT_THRESHOLD_DEG;
     const duration = 1 / Math.max(pulseSpeed, 0.0001);
     const sliderMetalness = metalnessSlider ? parseFloat(metalnessSlider.value) : NaN;
     const baseMetalness = Number.isFinite(sliderMetalness) ? sliderMetalness : 0.4;
     const children = spiralContainer.children;
     for (let idx = 0; idx < children.length; idx += 1) {
       const mesh = children[idx];
+      if (mesh.isLineSegments) {
+        mesh.material.uniforms.rotationDeg.value = rotationAngleDeg;
+        continue;
+      }
       const lineAngle = mesh.userData.lineAngle || 0;
       const diff = angularDifferenceDeg(rotationAngleDeg, lineAngle);
       const isInRange = diff < threshold;
@@ -253,7 +552,9 @@ function createThreeViewer({
         mesh.material.metalness = baseMetalness;
       }
       mesh.userData.wasInRange = isInRange;
+      pulsing = pulsing || mesh.userData.isPulsing;
     }
+    return pulsing;
   }
 
   function updateCamera() {
@@ -276,6 +577,7 @@ function createThreeViewer({
     }
     animationStart = performance.now();
     updateCamera();
+    requestRender();
   }
 
   function setStatus(message, isError = false) {
@@ -304,6 +606,7 @@ function createThreeViewer({
         throw new Error('No geometry returned');
       }
       loadSpiralFromJSON(result.geometry);
+      loadHatchLines(params);
       if (statParameters) {
         const label = result.label || `p=${params.p}, q=${params.q}, t=${Number(params.t).toFixed(2)}`;
         statParameters.textContent = label;
@@ -337,6 +640,7 @@ function createThreeViewer({
     }
     try {
       loadSpiralFromJSON(geometry);
+      loadHatchLines(params);
       if (statParameters) {
         statParameters.textContent = `p=${params.p}, q=${params.q}, t=${Number(params.t).toFixed(2)}`;
       }
@@ -385,6 +689,7 @@ function createThreeViewer({
     rotationSpeed.addEventListener('input', () => {
       autoRotationSpeed = parseFloat(rotationSpeed.value);
       rotationSpeedValue.textContent = autoRotationSpeed.toFixed(2);
+      requestRender();
     });
   }
 
@@ -392,6 +697,7 @@ function createThreeViewer({
     manualRotation.addEventListener('input', () => {
       const value = parseFloat(manualRotation.value);
       manualRotationValue.textContent = value.toFixed(0);
+      requestRender();
     });
   }
 
@@ -399,6 +705,7 @@ function createThreeViewer({
     pulseSpeedSlider.addEventListener('input', () => {
       pulseSpeed = parseFloat(pulseSpeedSlider.value);
       pulseSpeedValue.textContent = pulseSpeed.toFixed(1);
+      requestRender();
     });
   }
 
@@ -407,8 +714,11 @@ function createThreeViewer({
       const value = parseFloat(metalnessSlider.value);
       metalnessValue.textContent = value.toFixed(2);
       spiralContainer.children.forEach(mesh => {
-        mesh.material.metalness = value;
+        if (mesh.isMesh) {
+          mesh.material.metalness = value;
+        }
       });
+      requestRender();
     });
   }
 
@@ -417,8 +727,11 @@ function createThreeViewer({
       const value = parseFloat(roughnessSlider.value);
       roughnessValue.textContent = value.toFixed(2);
       spiralContainer.children.forEach(mesh => {
-        mesh.material.roughness = value;
+        if (mesh.isMesh) {
+          mesh.material.roughness = value;
+        }
       });
+      requestRender();
     });
   }
 
@@ -442,6 +755,7 @@ function createThreeViewer({
     cameraRotation.y = clamp(cameraRotation.y, -Math.PI / 2, Math.PI / 2);
     previousPointer = { x: event.clientX, y: event.clientY };
     updateCamera();
+    requestRender();
   });
 
   canvas.addEventListener('pointerup', event => {
@@ -460,27 +774,65 @@ function createThreeViewer({
     cameraDistance += event.deltaY * 0.01;
     cameraDistance = clamp(cameraDistance, 1, 15);
     updateCamera();
+    requestRender();
+    scheduleDetail();
   }, { passive: false });
 
+  // A resized canvas needs a frame and may change polygon sizes on screen.
+  const onResize = () => {
+    requestRender();
+    scheduleDetail();
+  };
+  if (typeof ResizeObserver !== 'undefined') {
+    new ResizeObserver(onResize).observe(canvas);
+  } else {
+    window.addEventListener('resize', onResize);
+  }
+  document.addEventListener('visibilitychange', () => {
+    if (!document.hidden) {
+      requestRender();
+    }
+  });
+
+  function requestRender() {
+    if (frameHandle === null) {
+      frameHandle = requestAnimationFrame(animate);
+    }
+  }
+
   function animate(time) {
-    requestAnimationFrame(animate);
+    frameHandle = null;
+    // Hidden canvases and tabs draw nothing; resizing or showing them wakes the loop.
+    if (document.hidden || canvas.clientWidth === 0 || canvas.clientHeight === 0) {
+      return;
+    }
     resizeRendererToDisplaySize();
     const timeSec = (time - animationStart) / 1000;
     let rotationDeg = 0;
     const manualValue = manualRotation ? parseFloat(manualRotation.value) : 0;
-    if (autoRotationSpeed > 0 && Math.abs(manualValue) < 1e-6) {
+    const autoRotating = autoRotationSpeed > 0 && Math.abs(manualValue) < 1e-6;
+    if (autoRotating) {
       rotationDeg = (timeSec * autoRotationSpeed * 360) % 360;
     } else {
       rotationDeg = manualValue % 360;
     }
     spiralContainer.rotation.z = THREE.MathUtils.degToRad(rotationDeg);
-    updateMaterialsForRotation(rotationDeg, timeSec);
+    const pulsing = updateMaterialsForRotation(rotationDeg, timeSec);
     updateCamera();
     renderer.render(scene, camera);
+    if (geometryFramePending) {
+      geometryFramePending = false;
+      if (onGeometryFrame) {
+        onGeometryFrame();
+      }
+    }
+    if (autoRotating || pulsing) {
+      requestRender();
+    }
   }
 
   updateCamera();
-  requestAnimationFrame(animate);
+  requestRender();
 
   return {
     useGeometryFromPayload,
@@ -490,4 +842,4 @@ function createThreeViewer({
   };
 }
 
-export { createThreeViewer };
+export { createThreeViewer, chooseDetailLevels, estimateExtrudeTriangles, simplifyOutline };
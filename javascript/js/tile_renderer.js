@@ -0,0 +1,481 @@
+/**
+ * Deep-zoom tile rendering for the 2D preview — pure functions with no DOM/browser dependencies.
+ * Used by tile_worker.js (index and tiles) and app.js (tile layout), and directly testable by vitest.
+ *
+ * The preview is split into square tiles on a quadtree: zoom level z covers the
+ * drawing with 2^z × 2^z tiles, each rendered as a standalone SVG of TILE_SIZE
+ * pixels. Only arc groups whose bounding box touches a tile are emitted, and
+ * their outlines and hatch lines are clipped to the tile. Arcs are
+ * re-tessellated for the tile's pixel size, and hatch lines that would be closer
+ * than MIN_HATCH_PIXELS on screen are thinned out.
+ */
+
+import { fillPatternPolylines } from './doyle_spiral_engine.js';
+
+export const TILE_SIZE = 256;
+export const MAX_TILE_ZOOM = 16;
+
+const INDEX_GRID = 32;          // Cells per axis in the group spatial index
+const MIN_HATCH_PIXELS = 1.5;   // Closest on-screen spacing before hatch lines are thinned
+const MAX_SEGMENT_PIXELS = 2;   // Longest chord used when re-tessellating an arc
+const MAX_REFINE_STEPS = 256;   // Upper bound on chords inserted between two outline points
+const MIN_STROKE_PIXELS = 0.75; // Strokes never drop below this width on screen
+
+/**
+ * Builds a spatial index over the arc groups of a rendered engine.
+ * All coordinates are converted to drawing units (mm), matching the preview SVG.
+ *
+ * @param {Map<string, Object>} arcGroups - engine.arcGroups after an arram_boyle render
+ * @param {number} scaleFactor - drawing units per internal unit
+ * @param {{width: number, height: number}} bounds - drawing size, centred on the origin
+ * @returns {{size: number, minX: number, minY: number, records: Array, cells: Array<Array<number>>}}
+ */
+export function buildTileIndex(arcGroups, scaleFactor, { width, height }) {
+  const sf = Number.isFinite(scaleFactor) && scaleFactor > 0 ? scaleFactor : 1;
+  const size = Math.max(width || 0, height || 0) || 1;
+  const minX = -size / 2;
+  const minY = -size / 2;
+  const records = [];
+
+  for (const [key, group] of arcGroups.entries()) {
+    const circles = [];
+    for (const arc of group.arcs) {
+      if (arc?.circle) circles.push(scaleCircle(arc.circle, sf));
+    }
+    if (group.outerArc?.circle) circles.push(scaleCircle(group.outerArc.circle, sf));
+
+    const isOuter = key.startsWith('outer_');
+    const paths = [];
+    if (isOuter) {
+      for (const arc of group.arcs) {
+        const pts = arc.getPoints().map(p => ({ x: p.re * sf, y: p.im * sf }));
+        if (pts.length >= 2) paths.push(pts);
+      }
+    } else {
+      const outline = group.getClosedOutline();
+      if (outline && outline.length >= 3) {
+        paths.push(outline.map(p => ({ x: p.re * sf, y: p.im * sf })));
+      }
+    }
+    if (!paths.length) continue;
+
+    let bx0 = Infinity, by0 = Infinity, bx1 = -Infinity, by1 = -Infinity;
+    for (const path of paths) {
+      for (const p of path) {
+        if (p.x < bx0) bx0 = p.x;
+        if (p.y < by0) by0 = p.y;
+        if (p.x > bx1) bx1 = p.x;
+        if (p.y > by1) by1 = p.y;
+      }
+    }
+
+    records.push({
+      key,
+      id: group.id,
+      ringIndex: group.ringIndex ?? 0,
+      closed: !isOuter,
+      angle: Number.isFinite(group.primaryPatternAngle) ? group.primaryPatternAngle : 0,
+      bbox: [bx0, by0, bx1, by1],
+      paths,
+      circles,
+      _refined: new Map(),
+    });
+  }
+
+  const cells = Array.from({ length: INDEX_GRID * INDEX_GRID }, () => []);
+  const cellSize = size / INDEX_GRID;
+  records.forEach((record, idx) => {
+    const [c0, r0, c1, r1] = cellRange(record.bbox, minX, minY, cellSize);
+    for (let r = r0; r <= r1; r++) {
+      for (let c = c0; c <= c1; c++) {
+        cells[r * INDEX_GRID + c].push(idx);
+      }
+    }
+  });
+
+  return { size, minX, minY, records, cells };
+}
+
+/**
+ * The part of a tile index the page needs to place tiles and count groups in
+ * view: bounds, grid and record bounding boxes, without paths or circles.
+ * tilesForViewport, tileBounds and groupsInViewport accept it in place of the
+ * full index, so the tile worker can keep the geometry to itself.
+ *
+ * @param {Object} index - result of buildTileIndex
+ * @returns {{size: number, minX: number, minY: number, records: Array<{bbox: Array<number>}>, cells: Array<Array<number>>}}
+ */
+export function tileIndexLayout(index) {
+  return {
+    size: index.size,
+    minX: index.minX,
+    minY: index.minY,
+    records: index.records.map(record => ({ bbox: record.bbox })),
+    cells: index.cells,
+  };
+}
+
+function scaleCircle(circle, sf) {
+  return { cx: circle.center.re * sf, cy: circle.center.im * sf, r: circle.radius * sf };
+}
+
+function cellRange([x0, y0, x1, y1], minX, minY, cellSize) {
+  const clampCell = v => Math.min(INDEX_GRID - 1, Math.max(0, Math.floor(v)));
+  return [
+    clampCell((x0 - minX) / cellSize),
+    clampCell((y0 - minY) / cellSize),
+    clampCell((x1 - minX) / cellSize),
+    clampCell((y1 - minY) / cellSize),
+  ];
+}
+
+/**
+ * Returns the index records whose bounding box intersects the given rectangle.
+ *
+ * @param {Object} index - result of buildTileIndex
+ * @param {[number, number, number, number]} rect - [minX, minY, maxX, maxY] in drawing units
+ * @param {number} [margin=0] - extra padding applied to every record bbox (e.g. stroke width)
+ * @returns {Array<Object>}
+ */
+export function groupsInViewport(index, rect, margin = 0) {
+  if (!index || !index.records.length) return [];
+  const cellSize = index.size / INDEX_GRID;
+  const [c0, r0, c1, r1] = cellRange(
+    [rect[0] - margin, rect[1] - margin, rect[2] + margin, rect[3] + margin],
+    index.minX, index.minY, cellSize,
+  );
+  const seen = new Set();
+  const result = [];
+  for (let r = r0; r <= r1; r++) {
+    for (let c = c0; c <= c1; c++) {
+      for (const idx of index.cells[r * INDEX_GRID + c]) {
+        if (seen.has(idx)) continue;
+        seen.add(idx);
+        const [x0, y0, x1, y1] = index.records[idx].bbox;
+        if (x1 + margin < rect[0] || x0 - margin > rect[2]) continue;
+        if (y1 + margin < rect[1] || y0 - margin > rect[3]) continue;
+        result.push(index.records[idx]);
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * Drawing-unit bounds of tile (z, x, y).
+ *
+ * @returns {[number, number, number, number]} [minX, minY, maxX, maxY]
+ */
+export function tileBounds(index, z, x, y) {
+  const span = index.size / (1 << z);
+  const x0 = index.minX + x * span;
+  const y0 = index.minY + y * span;
+  return [x0, y0, x0 + span, y0 + span];
+}
+
+/**
+ * Picks the tile zoom level whose tiles are rendered at or above the displayed
+ * resolution, and lists the tiles covering a viewport.
+ *
+ * @param {Object} index - result of buildTileIndex
+ * @param {[number, number, number, number]} rect - visible rectangle in drawing units
+ * @param {number} pixelsPerUnit - current on-screen scale
+ * @returns {{z: number, tiles: Array<{z: number, x: number, y: number}>}}
+ */
+export function tilesForViewport(index, rect, pixelsPerUnit) {
+  const wanted = Math.log2(Math.max(1e-9, pixelsPerUnit * index.size / TILE_SIZE));
+  const z = Math.min(MAX_TILE_ZOOM, Math.max(0, Math.ceil(wanted - 1e-9)));
+  const n = 1 << z;
+  const span = index.size / n;
+  const clampTile = v => Math.min(n - 1, Math.max(0, Math.floor(v)));
+  const tx0 = clampTile((rect[0] - index.minX) / span);
+  const ty0 = clampTile((rect[1] - index.minY) / span);
+  const tx1 = clampTile((rect[2] - index.minX) / span);
+  const ty1 = clampTile((rect[3] - index.minY) / span);
+  const tiles = [];
+  for (let y = ty0; y <= ty1; y++) {
+    for (let x = tx0; x <= tx1; x++) {
+      tiles.push({ z, x, y });
+    }
+  }
+  return { z, tiles };
+}
+
+/**
+ * Re-tessellates a polyline whose vertices lie on the given circles so that no
+ * chord exceeds maxSegment. Segments whose endpoints do not share exactly one
+ * circle are kept as-is.
+ *
+ * @param {Array<{x: number, y: number}>} points
+ * @param {Array<{cx: number, cy: number, r: number}>} circles
+ * @param {number} maxSegment - longest chord in drawing units
+ * @param {boolean} [closed=true]
+ * @returns {Array<{x: number, y: number}>}
+ */
+export function refinePolyline(points, circles, maxSegment, closed = true) {
+  if (!points || points.length < 2 || !(maxSegment > 0)) return points ? points.slice() : [];
+  const onCircle = (p, c) => Math.abs(Math.hypot(p.x - c.cx, p.y - c.cy) - c.r) <= 1e-6 * Math.max(1, c.r);
+  const out = [];
+  const count = closed ? points.length : points.length - 1;
+  for (let i = 0; i < count; i++) {
+    const a = points[i];
+    const b = points[(i + 1) % points.length];
+    out.push(a);
+    const chord = Math.hypot(b.x - a.x, b.y - a.y);
+    if (chord <= maxSegment) continue;
+    let shared = null;
+    let sharedCount = 0;
+    for (const c of circles) {
+      if (onCircle(a, c) && onCircle(b, c)) {
+        shared = c;
+        sharedCount++;
+      }
+    }
+    if (sharedCount !== 1) continue;
+    const a0 = Math.atan2(a.y - shared.cy, a.x - shared.cx);
+    let delta = Math.atan2(b.y - shared.cy, b.x - shared.cx) - a0;
+    if (delta > Math.PI) delta -= 2 * Math.PI;
+    if (delta < -Math.PI) delta += 2 * Math.PI;
+    const steps = Math.min(MAX_REFINE_STEPS, Math.ceil(Math.abs(delta) * shared.r / maxSegment));
+    for (let s = 1; s < steps; s++) {
+      const angle = a0 + delta * (s / steps);
+      out.push({ x: shared.cx + shared.r * Math.cos(angle), y: shared.cy + shared.r * Math.sin(angle) });
+    }
+  }
+  if (!closed) out.push(points[points.length - 1]);
+  return out;
+}
+
+function refinedPaths(record, z, pixelSize) {
+  let paths = record._refined.get(z);
+  if (!paths) {
+    const maxSegment = pixelSize * MAX_SEGMENT_PIXELS;
+    paths = record.paths.map(path => refinePolyline(path, record.circles, maxSegment, record.closed));
+    record._refined.set(z, paths);
+  }
+  return paths;
+}
+
+/**
+ * Stride applied to hatch lines so that drawn lines stay at least
+ * MIN_HATCH_PIXELS apart on screen. Because the fill kernels anchor at the
+ * polygon centroid, every stride-th line of the full hatch is kept.
+ *
+ * @param {number} spacing - hatch spacing in drawing units
+ * @param {number} pixelSize - drawing units per screen pixel
+ * @returns {number}
+ */
+export function hatchStride(spacing, pixelSize) {
+  if (!(spacing > 0) || !(pixelSize > 0)) return 1;
+  const spacingPx = spacing / pixelSize;
+  return spacingPx >= MIN_HATCH_PIXELS ? 1 : Math.ceil(MIN_HATCH_PIXELS / spacingPx);
+}
+
+/**
+ * Clips the segment p1–p2 to a rectangle (Liang–Barsky). Endpoints inside the
+ * rectangle are returned as the same objects.
+ *
+ * @param {{x: number, y: number}} p1
+ * @param {{x: number, y: number}} p2
+ * @param {[number, number, number, number]} rect - [minX, minY, maxX, maxY]
+ * @returns {Array<{x: number, y: number}>|null} the clipped [start, end], or null when outside
+ */
+export function clipSegment(p1, p2, rect) {
+  const dx = p2.x - p1.x;
+  const dy = p2.y - p1.y;
+  let t0 = 0;
+  let t1 = 1;
+  for (const [p, q] of [[-dx, p1.x - rect[0]], [dx, rect[2] - p1.x], [-dy, p1.y - rect[1]], [dy, rect[3] - p1.y]]) {
+    if (p === 0) {
+      if (q < 0) return null;
+      continue;
+    }
+    const t = q / p;
+    if (p < 0) {
+      if (t > t1) return null;
+      if (t > t0) t0 = t;
+    } else {
+      if (t < t0) return null;
+      if (t < t1) t1 = t;
+    }
+  }
+  return [
+    t0 > 0 ? { x: p1.x + t0 * dx, y: p1.y + t0 * dy } : p1,
+    t1 < 1 ? { x: p1.x + t1 * dx, y: p1.y + t1 * dy } : p2,
+  ];
+}
+
+/**
+ * The parts of a polyline inside a rectangle. A polyline lying entirely
+ * inside comes back whole (and still closed); otherwise each run of clipped
+ * segments becomes an open polyline.
+ *
+ * @param {Array<{x: number, y: number}>} points
+ * @param {[number, number, number, number]} rect - [minX, minY, maxX, maxY]
+ * @param {boolean} [closed=false]
+ * @returns {Array<{points: Array<{x: number, y: number}>, closed: boolean}>}
+ */
+export function clipPolyline(points, rect, closed = false) {
+  const inside = p => p.x >= rect[0] && p.x <= rect[2] && p.y >= rect[1] && p.y <= rect[3];
+  if (points.every(inside)) return [{ points, closed }];
+  const runs = [];
+  let run = null;
+  const count = closed ? points.length : points.length - 1;
+  for (let i = 0; i < count; i++) {
+    const clipped = clipSegment(points[i], points[(i + 1) % points.length], rect);
+    if (!clipped) {
+      run = null;
+    } else if (run && run[run.length - 1] === clipped[0]) {
+      run.push(clipped[1]);
+    } else {
+      run = [clipped[0], clipped[1]];
+      runs.push(run);
+    }
+  }
+  // A closed outline may leave the rectangle mid-way and re-enter at its start.
+  if (closed && runs.length > 1 && runs[runs.length - 1][runs[runs.length - 1].length - 1] === runs[0][0]) {
+    runs[0] = runs.pop().concat(runs[0].slice(1));
+  }
+  return runs.map(run => ({ points: run, closed: false }));
+}
+
+function formatPath(pts, close) {
+  let d = `M${pts[0].x.toFixed(4)},${pts[0].y.toFixed(4)}`;
+  for (let i = 1; i < pts.length; i++) {
+    d += ` L${pts[i].x.toFixed(4)},${pts[i].y.toFixed(4)}`;
+  }
+  return close ? `${d} Z` : d;
+}
+
+/**
+ * Renders one tile as a standalone SVG string.
+ *
+ * @param {Object} index - result of buildTileIndex
+ * @param {number} z
+ * @param {number} x
+ * @param {number} y
+ * @param {Object} params - normalised spiral params (fill/outline settings are read from here)
+ * @returns {{svg: string, groupCount: number}}
+ */
+export function renderTileSVG(index, z, x, y, params = {}) {
+  const rect = tileBounds(index, z, x, y);
+  const span = rect[2] - rect[0];
+  const pixelSize = span / TILE_SIZE;
+  const minStroke = pixelSize * MIN_STROKE_PIXELS;
+  const outlineWidth = Math.max(minStroke, Number(params.group_outline_width ?? 0.6));
+  const patternWidth = Math.max(minStroke, Number(params.pattern_stroke_width ?? 0.5));
+  const drawOutline = params.draw_group_outline !== false && Number(params.group_outline_width ?? 0.6) > 0;
+  const addPattern = Boolean(params.add_fill_pattern) && Number(params.pattern_stroke_width ?? 0.5) > 0;
+  const spacing = Number(params.fill_pattern_spacing ?? 8);
+  const offset = Number(params.fill_pattern_offset ?? 0);
+  const rectWidth = Number(params.fill_pattern_rect_width ?? 2);
+  const stride = hatchStride(spacing, pixelSize);
+
+  // Everything drawn is clipped to the tile, widened by a stroke so no cut
+  // end or round cap shows inside it.
+  const margin = Math.max(outlineWidth, patternWidth);
+  const clipRect = [rect[0] - margin, rect[1] - margin, rect[2] + margin, rect[3] + margin];
+  const records = groupsInViewport(index, rect, margin);
+  const parts = [];
+  for (const record of records) {
+    const paths = refinedPaths(record, z, pixelSize);
+    if (drawOutline || !record.closed) {
+      for (const path of paths) {
+        if (path.length < 2) continue;
+        for (const piece of clipPolyline(path, clipRect, record.closed)) {
+          parts.push(`<path d="${formatPath(piece.points, piece.closed)}" fill="none" stroke="#000000" stroke-width="${outlineWidth}" stroke-linecap="round" stroke-linejoin="round" />`);
+        }
+      }
+    }
+    if (!addPattern || !record.closed) continue;
+    // The hatch is laid out on the whole outline, so lines continue across
+    // tile seams, and only its clipped parts are emitted.
+    const patternType = params.fill_pattern_type || 'lines';
+    const segments = fillPatternPolylines(patternType, paths[0], spacing * stride, record.angle, offset);
+    if (patternType !== 'lines' && patternType !== 'rectangles') {
+      const d = segments
+        .filter(polyline => polyline.length > 1)
+        .flatMap(polyline => clipPolyline(polyline, clipRect))
+        .map(piece => formatPath(piece.points, false));
+      if (d.length) {
+        parts.push(`<path d="${d.join(' ')}" fill="none" stroke="#000000" stroke-width="${patternWidth}" stroke-linecap="round" stroke-linejoin="round" />`);
+      }
+    } else if (patternType === 'rectangles') {
+      const half = rectWidth / 2;
+      for (const [p1, p2] of segments) {
+        const length = Math.hypot(p2.x - p1.x, p2.y - p1.y);
+        if (!(length > 2 * half) || half <= 1e-6) continue;
+        const ox = -(p2.y - p1.y) / length * half;
+        const oy = (p2.x - p1.x) / length * half;
+        const corners = [
+          { x: p1.x + ox, y: p1.y + oy },
+          { x: p2.x + ox, y: p2.y + oy },
+          { x: p2.x - ox, y: p2.y - oy },
+          { x: p1.x - ox, y: p1.y - oy },
+        ];
+        // Rectangles are kept whole; clipping would draw their cut edges.
+        const xs = corners.map(corner => corner.x);
+        const ys = corners.map(corner => corner.y);
+        if (Math.max(...xs) < clipRect[0] || Math.min(...xs) > clipRect[2]
+          || Math.max(...ys) < clipRect[1] || Math.min(...ys) > clipRect[3]) continue;
+        parts.push(`<path d="${formatPath(corners, true)}" fill="none" stroke="#ff0000" stroke-width="${patternWidth}" />`);
+      }
+    } else {
+      for (const segment of segments) {
+        const clipped = clipSegment(segment[0], segment[1], clipRect);
+        if (!clipped) continue;
+        const [p1, p2] = clipped;
+        parts.push(`<line x1="${p1.x.toFixed(4)}" y1="${p1.y.toFixed(4)}" x2="${p2.x.toFixed(4)}" y2="${p2.y.toFixed(4)}" stroke="#000000" stroke-width="${patternWidth}" stroke-linecap="round" />`);
+      }
+    }
+  }
+
+  const viewBox = `${rect[0]} ${rect[1]} ${span} ${span}`;
+  const svg = `<svg xmlns="http://www.w3.org/2000/svg" viewBox="${viewBox}" width="${TILE_SIZE}" height="${TILE_SIZE}"><g>${parts.join('')}</g></svg>`;
+  return { svg, groupCount: records.length };
+}
+
+/**
+ * Least-recently-used cache for rendered tiles, keyed like a map viewer ("z/x/y").
+ * The optional onEvict callback lets callers release resources such as object URLs.
+ */
+export class TileCache {
+  constructor(capacity = 256, onEvict = null) {
+    this.capacity = Math.max(1, capacity | 0);
+    this.onEvict = onEvict;
+    this._entries = new Map();
+  }
+
+  static key(z, x, y) {
+    return `${z}/${x}/${y}`;
+  }
+
+  get size() {
+    return this._entries.size;
+  }
+
+  get(key) {
+    if (!this._entries.has(key)) return undefined;
+    const value = this._entries.get(key);
+    this._entries.delete(key);
+    this._entries.set(key, value);
+    return value;
+  }
+
+  set(key, value) {
+    if (this._entries.has(key)) this._entries.delete(key);
+    this._entries.set(key, value);
+    while (this._entries.size > this.capacity) {
+      const [oldKey, oldValue] = this._entries.entries().next().value;
+      this._entries.delete(oldKey);
+      if (this.onEvict) this.onEvict(oldValue, oldKey);
+    }
+  }
+
+  clear() {
+    if (this.onEvict) {
+      for (const [key, value] of this._entries) this.onEvict(value, key);
+    }
+    this._entries.clear();
+  }
+}
@@ -0,0 +1,47 @@
+import { renderSpiral } from './doyle_spiral_engine.js';
+import { buildTileIndex, renderTileSVG, tileIndexLayout } from './tile_renderer.js';
+
+// Builds the deep-zoom tile index and renders its tiles off the page. The page
+// keeps only the index layout (tileIndexLayout) to place tiles; the geometry
+// stays here, and each 'tile' request returns one tile's SVG string.
+
+let index = null;
+let indexParams = null;
+let indexRequest = null;
+
+self.addEventListener('message', event => {
+  const data = event.data || {};
+  const { requestId } = data;
+  try {
+    if (data.type === 'index') {
+      // Tiles lay out and clip their own hatch, so the index only needs the
+      // outlines, circles and hatch angles; the pattern-preview render assigns
+      // the same angles without building every group's hatch lines.
+      const res = renderSpiral({ ...data.params, mode: 'arram_boyle', svg_pattern_preview: true }, 'arram_boyle', {
+        arcGroupAngleOverrides: data.angleOverrides ?? null,
+      });
+      index = buildTileIndex(res.engine.arcGroups, res.scaleFactor ?? 1, {
+        width: data.params.bounding_box_width_mm,
+        height: data.params.bounding_box_height_mm,
+      });
+      indexParams = data.params;
+      indexRequest = requestId;
+      self.postMessage({ type: 'index', requestId, layout: tileIndexLayout(index) });
+      return;
+    }
+    if (data.type === 'tile') {
+      // Tiles of an index that has since been replaced are dropped.
+      if (!index || requestId !== indexRequest) {
+        return;
+      }
+      const { svg } = renderTileSVG(index, data.z, data.x, data.y, indexParams);
+      self.postMessage({ type: 'tile', requestId, key: data.key, svg });
+    }
+  } catch (error) {
+    self.postMessage({
+      type: 'error',
+      requestId,
+      message: error?.message || 'Deep zoom failed',
+    });
+  }
+});
@@ -0,0 +1,327 @@
+/**
+ * Headless zoetrope preview — pure functions with no DOM/WebGL dependencies.
+ * Used by zoetrope_worker.js and directly testable by vitest.
+ *
+ * Simulates the rotating disk of three_viewer.js over a full revolution: a
+ * group lights up while the disk rotation is within REFLECTION_THRESHOLD_DEG
+ * of one of its hatch angles. Group outlines are scan-converted once into a
+ * label image; every frame is then a nearest-neighbour rotation of that image
+ * through a per-frame palette lookup, with the lit groups of each frame read
+ * from a precomputed activation table. Output is palette-indexed, so frames
+ * are bit-for-bit deterministic and encode directly as an animated PNG.
+ */
+
+import { decodeOutline } from './doyle_spiral_engine.js';
+import { pngChunk } from './raster_export.js';
+
+export const REFLECTION_THRESHOLD_DEG = 20; // Same window as three_viewer.js
+export const GLOW_LEVELS = 8;
+
+// Colours from three_viewer.js: background, per-ring palette and the emissive glow.
+const BACKGROUND_COLOR = 0x0a0e1a;
+const RING_COLORS = [
+  0xc0c0d0, 0xb0b0c0, 0xa8a8b8, 0x9898a8,
+  0xd0d0e0, 0xb8b8c8, 0xa0a0b0, 0xc8c8d8,
+  0x888898, 0xd8d8e8,
+];
+const GLOW_COLOR = 0xffd700;
+const GLOW_STRENGTH = 0.8;
+
+function orientationDiffDeg(a, b) {
+  const diff = ((((a - b) % 180) + 180) % 180);
+  return Math.min(diff, 180 - diff);
+}
+
+/**
+ * Palette shared by every frame: index 0 is the background, then for each
+ * ring colour GLOW_LEVELS + 1 entries from unlit to fully lit.
+ *
+ * @returns {Uint8Array} RGB triplets
+ */
+export function zoetropePalette() {
+  const levels = GLOW_LEVELS + 1;
+  const palette = new Uint8Array((1 + RING_COLORS.length * levels) * 3);
+  const put = (index, color) => {
+    palette[index * 3] = (color >> 16) & 0xff;
+    palette[index * 3 + 1] = (color >> 8) & 0xff;
+    palette[index * 3 + 2] = color & 0xff;
+  };
+  put(0, BACKGROUND_COLOR);
+  RING_COLORS.forEach((base, ring) => {
+    for (let level = 0; level < levels; level++) {
+      // Emissive light is added on top of the base colour, as in the viewer.
+      const s = GLOW_STRENGTH * level / GLOW_LEVELS;
+      let color = 0;
+      for (const shift of [16, 8, 0]) {
+        const channel = Math.min(255, Math.round(((base >> shift) & 0xff) + ((GLOW_COLOR >> shift) & 0xff) * s));
+        color |= channel << shift;
+      }
+      put(1 + ring * levels + level, color);
+    }
+  });
+  return palette;
+}
+
+function paletteIndex(ringIndex, level) {
+  const ring = Math.abs(ringIndex | 0) % RING_COLORS.length;
+  return 1 + ring * (GLOW_LEVELS + 1) + level;
+}
+
+/**
+ * Scan-converts the groups of a geometry payload (renderSpiral().geometry)
+ * into a label image centred on the spiral centre, in the viewer's
+ * orientation (Y up). Label 0 is background, label i + 1 is groups[i].
+ *
+ * @param {Object} geometry - payload with arcgroups (any outline precision)
+ * @param {Object} [options]
+ * @param {number} [options.size=512] - image width and height in pixels
+ * @returns {{size: number, labels: Uint32Array, groups: Array<{ringIndex: number, angles: number[]}>}}
+ */
+export function buildZoetropeScene(geometry, { size = 512 } = {}) {
+  if (!geometry || !Array.isArray(geometry.arcgroups)) {
+    throw new Error('Invalid geometry payload');
+  }
+  const pixels = Math.max(1, Math.floor(size));
+  const outlines = [];
+  const groups = [];
+  let extent = 0;
+  for (const group of geometry.arcgroups) {
+    const outline = decodeOutline(group);
+    if (!outline || outline.length < 3) continue;
+    for (const [x, y] of outline) {
+      extent = Math.max(extent, Math.abs(x), Math.abs(y));
+    }
+    outlines.push(outline);
+    const angles = Array.isArray(group.line_patterns) && group.line_patterns.length
+      ? group.line_patterns.slice(0, 3)
+      : [group.line_angle];
+    groups.push({ ringIndex: group.ring_index ?? 0, angles: angles.map(a => Number(a) || 0) });
+  }
+  const labels = new Uint32Array(pixels * pixels);
+  // The disk spins about the spiral centre, so fit the largest radius rather
+  // than the bounding box.
+  const pxPerUnit = extent > 0 ? pixels / (2 * extent) : 1;
+  const half = pixels / 2;
+  outlines.forEach((outline, idx) => {
+    fillPolygon(labels, pixels, outline.map(([x, y]) => [half + x * pxPerUnit, half - y * pxPerUnit]), idx + 1);
+  });
+  return { size: pixels, labels, groups };
+}
+
+/**
+ * Even-odd fill of one polygon into the label image; a pixel is set when its
+ * centre lies inside.
+ */
+function fillPolygon(labels, size, points, label) {
+  let minY = Infinity;
+  let maxY = -Infinity;
+  for (const [, y] of points) {
+    if (y < minY) minY = y;
+    if (y > maxY) maxY = y;
+  }
+  const row0 = Math.max(0, Math.ceil(minY - 0.5));
+  const row1 = Math.min(size - 1, Math.floor(maxY - 0.5));
+  const crossings = [];
+  for (let row = row0; row <= row1; row++) {
+    const cy = row + 0.5;
+    crossings.length = 0;
+    for (let i = 0, j = points.length - 1; i < points.length; j = i++) {
+      const [xi, yi] = points[i];
+      const [xj, yj] = points[j];
+      if ((yi > cy) !== (yj > cy)) {
+        crossings.push(xi + (cy - yi) / (yj - yi) * (xj - xi));
+      }
+    }
+    crossings.sort((a, b) => a - b);
+    for (let k = 0; k + 1 < crossings.length; k += 2) {
+      const x0 = Math.max(0, Math.ceil(crossings[k] - 0.5));
+      const x1 = Math.min(size - 1, Math.floor(crossings[k + 1] - 0.5));
+      labels.fill(label, row * size + x0, row * size + x1 + 1);
+    }
+  }
+}
+
+/**
+ * Precomputes which groups reflect in each frame of one revolution, with a
+ * glow level that peaks when the rotation matches a hatch angle. Each group
+ * only visits the frames inside its reflection windows, so the table costs
+ * O(groups × lit frames) instead of O(groups × frames).
+ *
+ * @param {Array<{angles: number[]}>} groups
+ * @param {number} frameCount - frames per revolution (360°)
+ * @param {Object} [options]
+ * @param {number} [options.threshold=REFLECTION_THRESHOLD_DEG]
+ * @returns {{frameCount: number, offsets: Uint32Array, entries: Uint32Array, levels: Uint8Array}}
+ *   frame f lights entries[offsets[f]..offsets[f+1]) at levels[...] (1..GLOW_LEVELS)
+ */
+export function buildActivationTable(groups, frameCount, { threshold = REFLECTION_THRESHOLD_DEG } = {}) {
+  const frames = Math.max(1, Math.floor(frameCount));
+  const step = 360 / frames;
+  const perFrame = Array.from({ length: frames }, () => new Map());
+  groups.forEach((group, idx) => {
+    for (const angle of group.angles) {
+      // Orientation repeats every 180°, so each angle lights twice per revolution.
+      for (const centre of [angle, angle + 180]) {
+        const first = Math.ceil((centre - threshold) / step);
+        const last = Math.floor((centre + threshold) / step);
+        for (let k = first; k <= last; k++) {
+          const frame = ((k % frames) + frames) % frames;
+          const diff = orientationDiffDeg(frame * step, angle);
+          if (!(diff < threshold)) continue;
+          const level = Math.max(1, Math.round(GLOW_LEVELS * Math.cos(diff / threshold * Math.PI / 2)));
+          const lit = perFrame[frame];
+          if ((lit.get(idx) || 0) < level) lit.set(idx, level);
+        }
+      }
+    }
+  });
+  const offsets = new Uint32Array(frames + 1);
+  for (let f = 0; f < frames; f++) offsets[f + 1] = offsets[f] + perFrame[f].size;
+  const entries = new Uint32Array(offsets[frames]);
+  const levels = new Uint8Array(offsets[frames]);
+  perFrame.forEach((lit, f) => {
+    let at = offsets[f];
+    for (const [idx, level] of lit) {
+      entries[at] = idx;
+      levels[at] = level;
+      at++;
+    }
+  });
+  return { frameCount: frames, offsets, entries, levels };
+}
+
+/**
+ * Renders one frame as palette indices (one byte per pixel, rows top-down).
+ *
+ * @param {Object} scene - from buildZoetropeScene
+ * @param {Object} table - from buildActivationTable
+ * @param {number} frame
+ * @param {Object} [options]
+ * @param {boolean} [options.rotate=true] - spin the disk; false keeps it still and only animates the glow
+ * @param {Uint8Array} [options.out] - reused output buffer
+ * @returns {Uint8Array}
+ */
+export function renderZoetropeFrame(scene, table, frame, { rotate = true, out = null } = {}) {
+  const { size, labels, groups } = scene;
+  const f = ((frame % table.frameCount) + table.frameCount) % table.frameCount;
+  const lookup = new Uint8Array(groups.length + 1);
+  groups.forEach((group, idx) => {
+    lookup[idx + 1] = paletteIndex(group.ringIndex, 0);
+  });
+  for (let at = table.offsets[f]; at < table.offsets[f + 1]; at++) {
+    const idx = table.entries[at];
+    lookup[idx + 1] = paletteIndex(groups[idx].ringIndex, table.levels[at]);
+  }
+  const pixels = out && out.length === size * size ? out : new Uint8Array(size * size);
+  if (!rotate) {
+    for (let i = 0; i < labels.length; i++) pixels[i] = lookup[labels[i]];
+    return pixels;
+  }
+  // Counter-clockwise disk rotation in the Y-up frame; sample the label image
+  // at the inverse-rotated pixel centre.
+  const theta = (f * 360 / table.frameCount) * Math.PI / 180;
+  const cos = Math.cos(theta);
+  const sin = Math.sin(theta);
+  const half = size / 2;
+  for (let row = 0; row < size; row++) {
+    const dy = half - (row + 0.5);
+    // Source (sx, sy) in Y-up coordinates relative to the centre, advanced per column.
+    let sx = cos * (0.5 - half) + sin * dy;
+    let sy = -sin * (0.5 - half) + cos * dy;
+    let at = row * size;
+    for (let col = 0; col < size; col++, at++, sx += cos, sy -= sin) {
+      const x = Math.floor(half + sx);
+      const y = Math.floor(half - sy);
+      pixels[at] = x >= 0 && x < size && y >= 0 && y < size ? lookup[labels[y * size + x]] : 0;
+    }
+  }
+  return pixels;
+}
+
+/**
+ * Expands palette indices to RGBA (e.g. for ImageData on an OffscreenCanvas).
+ */
+export function frameToRGBA(pixels, palette = zoetropePalette()) {
+  const rgba = new Uint8ClampedArray(pixels.length * 4);
+  for (let i = 0; i < pixels.length; i++) {
+    const p = pixels[i] * 3;
+    rgba[i * 4] = palette[p];
+    rgba[i * 4 + 1] = palette[p + 1];
+    rgba[i * 4 + 2] = palette[p + 2];
+    rgba[i * 4 + 3] = 255;
+  }
+  return rgba;
+}
+
+async function deflate(bytes) {
+  const stream = new Blob([bytes]).stream().pipeThrough(new CompressionStream('deflate'));
+  return new Uint8Array(await new Response(stream).arrayBuffer());
+}
+
+/**
+ * Encodes palette-indexed frames as a looping animated PNG.
+ *
+ * @param {Iterable<Uint8Array>|AsyncIterable<Uint8Array>} frames - from renderZoetropeFrame (consumed one at a time)
+ * @param {number} size - frame width and height
+ * @param {Object} [options]
+ * @param {number} [options.frameCount] - number of frames (written in the acTL header)
+ * @param {number} [options.fps=30]
+ * @param {Uint8Array} [options.palette]
+ * @returns {Promise<Array<Uint8Array>>} file parts, suitable for new Blob(parts)
+ */
+export async function encodeAPNG(frames, size, { frameCount, fps = 30, palette = zoetropePalette() } = {}) {
+  const parts = [Uint8Array.of(0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a)];
+  const ihdr = new Uint8Array(13);
+  const ihdrView = new DataView(ihdr.buffer);
+  ihdrView.setUint32(0, size);
+  ihdrView.setUint32(4, size);
+  ihdr[8] = 8;  // bit depth
+  ihdr[9] = 3;  // indexed colour
+  parts.push(pngChunk('IHDR', ihdr));
+  const actl = new Uint8Array(8);
+  new DataView(actl.buffer).setUint32(0, frameCount);  // loop count 0: forever
+  parts.push(pngChunk('acTL', actl));
+  parts.push(pngChunk('PLTE', palette));
+
+  const delayDen = Math.max(1, Math.round(fps));
+  let sequence = 0;
+  let index = 0;
+  const filtered = new Uint8Array(size * (size + 1));
+  for await (const pixels of frames) {
+    const fctl = new Uint8Array(26);
+    const view = new DataView(fctl.buffer);
+    view.setUint32(0, sequence++);
+    view.setUint32(4, size);
+    view.setUint32(8, size);
+    view.setUint16(20, 1);
+    view.setUint16(22, delayDen);
+    parts.push(pngChunk('fcTL', fctl));
+    // Each scanline is prefixed with filter type 0 (None).
+    for (let r = 0; r < size; r++) {
+      filtered.set(pixels.subarray(r * size, (r + 1) * size), r * (size + 1) + 1);
+    }
+    const data = await deflate(filtered);
+    if (index === 0) {
+      parts.push(pngChunk('IDAT', data));
+    } else {
+      const fdat = new Uint8Array(4 + data.length);
+      new DataView(fdat.buffer).setUint32(0, sequence++);
+      fdat.set(data, 4);
+      parts.push(pngChunk('fdAT', fdat));
+    }
+    index++;
+  }
+  if (frameCount !== undefined && index !== frameCount) {
+    throw new Error(`APNG expected ${frameCount} frames, got ${index}`);
+  }
+  if (frameCount === undefined) {
+    // acTL precedes the frames, so patch the count once it is known.
+    parts[2] = pngChunk('acTL', (() => {
+      const patched = new Uint8Array(8);
+      new DataView(patched.buffer).setUint32(0, index);
+      return patched;
+    })());
+  }
+  parts.push(pngChunk('IEND', new Uint8Array(0)));
+  return parts;
+}
@@ -0,0 +1,95 @@
+import { renderSpiral } from './doyle_spiral_engine.js';
+import { readGeometry } from './geometry_store.js';
+import {
+  buildZoetropeScene,
+  buildActivationTable,
+  renderZoetropeFrame,
+  encodeAPNG,
+  frameToRGBA,
+  zoetropePalette,
+} from './zoetrope_export.js';
+
+let activeRequest = null;
+
+self.addEventListener('message', async event => {
+  const data = event.data || {};
+  if (data.type === 'cancel') {
+    activeRequest = null;
+    return;
+  }
+  if (data.type !== 'zoetrope') {
+    return;
+  }
+  const { requestId, params, geometry: providedGeometry = null, options = {} } = data;
+  activeRequest = requestId;
+  try {
+    const size = Math.min(2048, Math.max(16, Number(options.size) || 512));
+    const frameCount = Math.min(3600, Math.max(1, Math.floor(Number(options.frames) || 180)));
+    const fps = Math.max(1, Number(options.fps) || 30);
+    const format = options.format === 'webp' ? 'webp' : 'apng';
+    const rotate = options.rotate !== false;
+    const geometry = (data.geometryStore ? readGeometry(data.geometryStore) : providedGeometry)
+      || renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle').geometry;
+    const scene = buildZoetropeScene(geometry, { size });
+    const table = buildActivationTable(scene.groups, frameCount);
+    const palette = zoetropePalette();
+
+    const checkCancelled = () => {
+      if (activeRequest !== requestId) {
+        throw new Error('Zoetrope export cancelled');
+      }
+    };
+    const reportProgress = frame => {
+      self.postMessage({ type: 'progress', requestId, frame, frameCount, fraction: frame / frameCount });
+    };
+
+    const files = [];
+    if (format === 'apng') {
+      const buffer = new Uint8Array(size * size);
+      const frames = (function* renderFrames() {
+        for (let frame = 0; frame < frameCount; frame += 1) {
+          checkCancelled();
+          reportProgress(frame);
+          yield renderZoetropeFrame(scene, table, frame, { rotate, out: buffer });
+        }
+      })();
+      files.push({ name: 'zoetrope.png', parts: await encodeAPNG(frames, size, { frameCount, fps, palette }) });
+    } else {
+      // WebP needs the browser's encoder; frames go out as a numbered sequence.
+      if (typeof OffscreenCanvas === 'undefined') {
+        throw new Error('WebP frames need OffscreenCanvas support');
+      }
+      const canvas = new OffscreenCanvas(size, size);
+      const context = canvas.getContext('2d');
+      const buffer = new Uint8Array(size * size);
+      const digits = String(frameCount - 1).length;
+      for (let frame = 0; frame < frameCount; frame += 1) {
+        checkCancelled();
+        reportProgress(frame);
+        const pixels = renderZoetropeFrame(scene, table, frame, { rotate, out: buffer });
+        context.putImageData(new ImageData(frameToRGBA(pixels, palette), size, size), 0, 0);
+        const blob = await canvas.convertToBlob({ type: 'image/webp', quality: 0.9 });
+        files.push({
+          name: `frame_${String(frame).padStart(digits, '0')}.webp`,
+          parts: [new Uint8Array(await blob.arrayBuffer())],
+        });
+      }
+    }
+
+    if (activeRequest !== requestId) {
+      return;
+    }
+    const transfer = files.flatMap(file => file.parts.map(part => part.buffer));
+    self.postMessage({ type: 'result', requestId, size, frameCount, fps, format, files }, transfer);
+  } catch (error) {
+    if (activeRequest !== requestId) {
+      return;
+    }
+    self.postMessage({
+      type: 'error',
+      requestId,
+      message: error?.message || 'Zoetrope export failed',
+      errorType: error?.name || 'Error',
+    });
+  }
+});
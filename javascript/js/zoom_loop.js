@@ -0,0 +1,340 @@
+/**
+ * Seamless zoom loops over one period of t — pure functions with no DOM/browser dependencies.
+ *
+ * In generateCircles, t only enters through the similarity a^t (scale |a|^t,
+ * rotation arg(a)·t), and multiplying by the generator a maps the packing onto
+ * itself. So the drawing at t + 1 is the drawing at t, with every ring index
+ * shifted by the number of rings per factor |a|. A zoom loop therefore needs a
+ * single render: the group outlines of one band of rings (one factor of |a|)
+ * are taken from it, every other ring is an a^n copy of that band, and frame
+ * τ ∈ [0, 1) is that geometry seen through the fixed camera of the first frame
+ * after the similarity a^-τ.
+ *
+ * Hatch angles follow the default ring rule (ring · fill_pattern_angle) with
+ * the ring index shifted continuously by s·τ, so the last frame flows into the
+ * first. Preset pattern animations are not invariant under the ring shift and
+ * are ignored here.
+ */
+
+import { DoyleSpiralEngine, renderSpiral, normaliseParams, linesInPolygon } from './doyle_spiral_engine.js';
+
+export const DEFAULT_LOOP_FRAMES = 240;
+
+const MAX_LOOP_DISTANCE = 50000; // Engine limit for max_d
+const COVERAGE_MARGIN = 1.05;    // Extra reach beyond the view diagonal for the render
+const RING_MATCH_TOLERANCE = 1e-4;
+const MIN_DRAWN_RADIUS = 0.01;   // Copies smaller than this (drawing units, first frame) are dropped
+
+/**
+ * Scale of the first frame: the fit a normal render at the same parameters uses
+ * (outer circle centres touching the shorter side of the bounding box).
+ */
+function fittedScaleFactor(opts) {
+  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
+    maxDistance: opts.max_d,
+    arcMode: opts.arc_mode,
+    numGaps: opts.num_gaps,
+  });
+  engine.generateOuterCircles();
+  let maxDistance = 0;
+  for (const circle of engine.outerCircles) {
+    maxDistance = Math.max(maxDistance, Math.sqrt(circle.center.re ** 2 + circle.center.im ** 2));
+  }
+  const minDimension = Math.min(opts.bounding_box_width_mm, opts.bounding_box_height_mm);
+  return { scaleFactor: maxDistance > 0 ? (minDimension / 2) / maxDistance : 1, root: engine.root };
+}
+
+/**
+ * Number of ring indices between a circle and its image under a (the rings
+ * whose radii lie in one factor of |a|). Returns 0 if the rings cannot be
+ * matched, which only matters when fill_pattern_angle is non-zero.
+ */
+export function ringShiftPerPeriod(radiusToRing, modA) {
+  const radii = Array.from(radiusToRing.keys()).sort((x, y) => x - y);
+  for (let i = 0; i < radii.length; i++) {
+    const target = radii[i] * modA;
+    if (target > radii[radii.length - 1] * (1 + RING_MATCH_TOLERANCE)) break;
+    for (let j = i + 1; j < radii.length; j++) {
+      if (Math.abs(radii[j] - target) <= RING_MATCH_TOLERANCE * target) {
+        return radiusToRing.get(radii[j]) - radiusToRing.get(radii[i]);
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Renders the geometry for one zoom period.
+ *
+ * @param {Object} params - spiral params (same keys as renderSpiral); t is the loop start
+ * @param {Object} [options]
+ * @param {number} [options.frames=240] - frames per period
+ * @param {'out'|'in'} [options.direction='out'] - 'out' shrinks the drawing towards the centre
+ * @returns {Object} loop description consumed by zoomLoopFrame / renderZoomLoopFrameSVG / zoomLoopTimeline
+ */
+export function buildZoomLoop(params = {}, { frames = DEFAULT_LOOP_FRAMES, direction = 'out' } = {}) {
+  const opts = normaliseParams({ ...params, mode: 'arram_boyle' });
+  const period = Math.max(1, Math.floor(Number(frames) || DEFAULT_LOOP_FRAMES));
+  const width = opts.bounding_box_width_mm;
+  const height = opts.bounding_box_height_mm;
+  const { scaleFactor, root } = fittedScaleFactor(opts);
+  const modA = root.mod_a;
+  const argA = root.arg_a;
+
+  // Frame τ shows world points |w| < reach · |a|^τ. Groups whose base circle
+  // lies in the band reach <= |c| < reach · |a| form one fundamental domain of
+  // w -> a·w; every other visible group is one of their a^n images. The render
+  // reaches one more factor of |a| so the band's neighbours are all present.
+  const reach = Math.hypot(width, height) / 2 / scaleFactor;
+  const wanted = reach * modA * modA * COVERAGE_MARGIN;
+  const maxDistance = Math.min(MAX_LOOP_DISTANCE, Math.max(opts.max_d, wanted));
+  const result = renderSpiral({
+    ...opts,
+    max_d: maxDistance,
+    add_fill_pattern: false,
+    fill_pattern_animation: 'none',
+    svg_layers: false,
+  }, 'arram_boyle');
+  const engine = result.engine;
+  const ringShift = ringShiftPerPeriod(engine._computeRingIndices(), modA);
+
+  const band = [];
+  for (const [key, group] of engine.arcGroups.entries()) {
+    if (key.startsWith('outer_') || !group.baseCircle) continue;
+    const { re, im } = group.baseCircle.center;
+    const distance = Math.sqrt(re * re + im * im);
+    if (distance < reach || distance >= reach * modA) continue;
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 3) continue;
+    band.push({ group, outline });
+  }
+
+  // Copies are only ever scaled down from the band (apart from the n = 1 rim),
+  // so their tessellation stays at least as fine as in a normal render, and
+  // the copy drawn at τ = 1 is exactly the next copy drawn at τ = 0.
+  const records = [];
+  for (let n = 1; ; n--) {
+    const factor = Math.pow(modA, n);
+    const cos = Math.cos(argA * n) * factor;
+    const sin = Math.sin(argA * n) * factor;
+    let emitted = 0;
+    for (const { group, outline } of band) {
+      const points = new Float64Array(outline.length * 2);
+      let cx = 0;
+      let cy = 0;
+      outline.forEach((pt, idx) => {
+        const x = cos * pt.re - sin * pt.im;
+        const y = sin * pt.re + cos * pt.im;
+        points[idx * 2] = x;
+        points[idx * 2 + 1] = y;
+        cx += x;
+        cy += y;
+      });
+      cx /= outline.length;
+      cy /= outline.length;
+      let radius = 0;
+      for (let i = 0; i < points.length; i += 2) {
+        radius = Math.max(radius, Math.hypot(points[i] - cx, points[i + 1] - cy));
+      }
+      if (radius * scaleFactor < MIN_DRAWN_RADIUS) continue;
+      const ringIndex = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
+      records.push({
+        id: group.id,
+        name: group.name,
+        copy: n,
+        ringIndex: ringIndex + n * ringShift,
+        points,
+        center: [cx, cy],
+        radius,
+      });
+      emitted++;
+    }
+    if (!emitted && n <= 0) break;
+  }
+
+  return {
+    params: opts,
+    period,
+    direction: direction === 'in' ? 'in' : 'out',
+    width,
+    height,
+    scaleFactor,
+    modA,
+    argA,
+    ringShift,
+    // A group narrower than its own outline stroke is drawn as a solid dot.
+    minDrawnRadius: Math.max(MIN_DRAWN_RADIUS, opts.draw_group_outline ? opts.group_outline_width / 2 : 0),
+    maxDistance,
+    complete: maxDistance >= wanted,
+    records,
+  };
+}
+
+/**
+ * Loop parameter τ ∈ [0, 1) of a frame. Indices wrap, so frame period + k is frame k.
+ */
+export function zoomLoopPhase(loop, index) {
+  const f = ((Math.round(index) % loop.period) + loop.period) % loop.period;
+  const step = loop.direction === 'in' ? (loop.period - f) % loop.period : f;
+  return step / loop.period;
+}
+
+/**
+ * Camera of one frame: the affine map from world to drawing units
+ * (SVG matrix order [a, b, c, d, e, f]), the ring-index offset applied to hatch
+ * angles, and the groups that touch the drawing.
+ *
+ * @returns {{index: number, tau: number, matrix: number[], ringOffset: number, angleOffset: number, groups: Array<Object>}}
+ */
+export function zoomLoopFrame(loop, index) {
+  return { ...zoomLoopFrameAtPhase(loop, zoomLoopPhase(loop, index)), index };
+}
+
+/**
+ * Same as zoomLoopFrame for an arbitrary loop parameter τ (players that
+ * interpolate between frames, or checks of the seam at τ = 1).
+ */
+export function zoomLoopFrameAtPhase(loop, tau) {
+  const scale = loop.scaleFactor * Math.pow(loop.modA, -tau);
+  const cos = Math.cos(-loop.argA * tau) * scale;
+  const sin = Math.sin(-loop.argA * tau) * scale;
+  const halfW = loop.width / 2;
+  const halfH = loop.height / 2;
+  const groups = [];
+  for (const record of loop.records) {
+    const [x, y] = record.center;
+    const sx = cos * x - sin * y;
+    const sy = sin * x + cos * y;
+    const r = record.radius * scale;
+    if (r < loop.minDrawnRadius) continue;
+    if (sx + r < -halfW || sx - r > halfW || sy + r < -halfH || sy - r > halfH) continue;
+    groups.push(record);
+  }
+  // `|| 0` turns the -0 of the first frame into 0.
+  const ringOffset = -loop.ringShift * tau || 0;
+  return {
+    tau,
+    matrix: [cos, sin, -sin, cos, 0, 0],
+    ringOffset,
+    angleOffset: ringOffset * loop.params.fill_pattern_angle,
+    groups,
+  };
+}
+
+function formatNumber(value, digits) {
+  return Number(value.toFixed(digits)).toString();
+}
+
+// World-space outline path and points of a record, built on first use and
+// shared by every frame (frames only differ by the group transform).
+function recordOutline(record, digits) {
+  if (!record.path) {
+    const pts = [];
+    let d = '';
+    for (let i = 0; i < record.points.length; i += 2) {
+      const x = record.points[i];
+      const y = record.points[i + 1];
+      pts.push({ x, y });
+      d += `${i ? ' L' : 'M'}${formatNumber(x, digits)},${formatNumber(y, digits)}`;
+    }
+    record.outline = pts;
+    record.path = `${d} Z`;
+  }
+  return record;
+}
+
+/**
+ * Renders one frame as a standalone SVG string in drawing units. Geometry is
+ * emitted in world coordinates under the frame transform, so outline paths are
+ * formatted once per loop; only the hatch lines are generated per frame.
+ *
+ * @returns {{svg: string, groupCount: number}}
+ */
+export function renderZoomLoopFrameSVG(loop, index) {
+  const params = loop.params;
+  const frame = zoomLoopFrame(loop, index);
+  const [a, b, c, d] = frame.matrix;
+  const scale = Math.hypot(a, b);
+  const rotation = Math.atan2(b, a) * 180 / Math.PI;
+  // Keep about 1e-4 drawing units of precision at the largest (first-frame) scale.
+  const digits = Math.max(0, Math.ceil(4 + Math.log10(loop.scaleFactor)));
+  const outlineWidth = params.group_outline_width;
+  const patternWidth = params.pattern_stroke_width;
+  const drawOutline = params.draw_group_outline && outlineWidth > 0;
+  const addPattern = params.add_fill_pattern && patternWidth > 0;
+  const spacing = params.fill_pattern_spacing / scale;
+  const offset = params.fill_pattern_offset / scale;
+  const lineDigits = Math.max(0, Math.ceil(4 + Math.log10(scale)));
+  const outlines = [];
+  const lines = [];
+  for (const record of frame.groups) {
+    recordOutline(record, digits);
+    if (drawOutline) {
+      outlines.push(`<path d="${record.path}" />`);
+    }
+    if (!addPattern) continue;
+    const angle = (record.ringIndex + frame.ringOffset) * params.fill_pattern_angle - rotation;
+    for (const [p1, p2] of linesInPolygon(record.outline, spacing, angle, offset)) {
+      lines.push(`<line x1="${formatNumber(p1.x, lineDigits)}" y1="${formatNumber(p1.y, lineDigits)}" x2="${formatNumber(p2.x, lineDigits)}" y2="${formatNumber(p2.y, lineDigits)}" />`);
+    }
+  }
+  const parts = [];
+  if (outlines.length) {
+    parts.push(`<g fill="none" stroke="#000000" stroke-width="${outlineWidth / scale}" stroke-linecap="round" stroke-linejoin="round">${outlines.join('')}</g>`);
+  }
+  if (lines.length) {
+    parts.push(`<g stroke="#000000" stroke-width="${patternWidth / scale}" stroke-linecap="round">${lines.join('')}</g>`);
+  }
+  const viewBox = `${-loop.width / 2} ${-loop.height / 2} ${loop.width} ${loop.height}`;
+  const matrix = [a, b, c, d, 0, 0].map(v => formatNumber(v, 12)).join(' ');
+  const svg = `<svg xmlns="http://www.w3.org/2000/svg" viewBox="${viewBox}" width="${loop.width}mm" height="${loop.height}mm"><g transform="matrix(${matrix})">${parts.join('')}</g></svg>`;
+  return { svg, groupCount: frame.groups.length };
+}
+
+/**
+ * Renders a whole period as SVG strings, one per frame.
+ */
+export function renderZoomLoopSVGs(params = {}, options = {}) {
+  const loop = buildZoomLoop(params, options);
+  const svgs = [];
+  for (let f = 0; f < loop.period; f++) {
+    svgs.push(renderZoomLoopFrameSVG(loop, f).svg);
+  }
+  return svgs;
+}
+
+/**
+ * Compact timeline for players that transform shared geometry themselves:
+ * every group outline once (world coordinates), plus per frame the world →
+ * drawing matrix, the hatch angle offset and the indices of the visible groups.
+ * A group's hatch angle in a frame is ringIndex · fill_pattern_angle + angleOffset.
+ */
+export function zoomLoopTimeline(loop) {
+  const indexOf = new Map(loop.records.map((record, idx) => [record, idx]));
+  const frames = [];
+  for (let f = 0; f < loop.period; f++) {
+    const frame = zoomLoopFrame(loop, f);
+    frames.push({
+      tau: frame.tau,
+      matrix: frame.matrix,
+      angle_offset: frame.angleOffset,
+      groups: frame.groups.map(record => indexOf.get(record)),
+    });
+  }
+  return {
+    width: loop.width,
+    height: loop.height,
+    period: loop.period,
+    direction: loop.direction,
+    ring_shift: loop.ringShift,
+    fill_pattern_angle: loop.params.fill_pattern_angle,
+    fill_pattern_spacing: loop.params.fill_pattern_spacing,
+    groups: loop.records.map(record => ({
+      id: record.id,
+      name: record.name,
+      ring_index: record.ringIndex,
+      outline: Array.from(record.points),
+    })),
+    frames,
+  };
+}
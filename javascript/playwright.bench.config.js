@@ -0,0 +1,12 @@
+import { defineConfig } from '@playwright/test';
+
+export default defineConfig({
+  testDir: './tests/e2e',
+  testMatch: '**/*.bench.js',
+  timeout: 10 * 60 * 1000,
+  workers: 1,
+  use: {
+    baseURL: 'http://localhost:8080',
+    acceptDownloads: true,
+  },
+});
@@ -0,0 +1,213 @@
+/**
+ * Request parameter parsing for the /api/spiral contract.
+ *
+ * Mirrors `_parse_params` in app.py so the Node render service and the Flask
+ * app accept the same payloads and report the same normalised `params`:
+ * missing, null or empty values fall back to the defaults, numbers are
+ * coerced the way Python's int()/float() would, and out-of-range values are
+ * clamped rather than rejected.
+ */
+
+export const DEFAULT_PARAMS = Object.freeze({
+  p: 16,
+  q: 16,
+  t: 0.0,
+  mode: 'arram_boyle',
+  arc_mode: 'closest',
+  num_gaps: 2,
+  size: 800,
+  debug_groups: false,
+  add_fill_pattern: false,
+  fill_pattern_spacing: 5.0,
+  fill_pattern_angle: 0.0,
+  fill_pattern_offset: 0.0,
+  red_outline: false,
+  draw_group_outline: true,
+});
+
+export const ALLOWED_MODES = new Set(['doyle', 'arram_boyle']);
+export const ALLOWED_ARC_MODES = new Set([
+  'closest',
+  'farthest',
+  'alternating',
+  'all',
+  'random',
+  'symmetric',
+  'angular',
+]);
+
+const TRUE_STRINGS = new Set(['1', 'true', 'yes', 'on']);
+// Python int()/float() accept surrounding whitespace and single underscores between digits.
+const INT_PATTERN = /^[+-]?\d+(?:_\d+)*$/;
+const FLOAT_PATTERN = /^[+-]?(?:\d+(?:_\d+)*(?:\.(?:\d+(?:_\d+)*)?)?|\.\d+(?:_\d+)*)(?:[eE][+-]?\d+(?:_\d+)*)?$/;
+const FLOAT_SPECIALS = new Map([
+  ['inf', Infinity], ['+inf', Infinity], ['-inf', -Infinity],
+  ['infinity', Infinity], ['+infinity', Infinity], ['-infinity', -Infinity],
+  ['nan', NaN], ['+nan', NaN], ['-nan', NaN],
+]);
+
+// Python's max(floor, value): NaN compares false, so it falls back to the floor.
+function atLeast(floor, value) {
+  return value > floor ? value : floor;
+}
+
+function getValue(source, key, fallback) {
+  const value = source[key];
+  return value === undefined || value === null || value === '' ? fallback : value;
+}
+
+function toInt(value) {
+  if (typeof value === 'boolean') {
+    return value ? 1 : 0;
+  }
+  if (typeof value === 'number') {
+    return Number.isFinite(value) ? Math.trunc(value) : null;
+  }
+  if (typeof value === 'string') {
+    const text = value.trim();
+    return INT_PATTERN.test(text) ? Number.parseInt(text.replace(/_/g, ''), 10) : null;
+  }
+  return null;
+}
+
+function toFloat(value) {
+  if (typeof value === 'boolean') {
+    return value ? 1 : 0;
+  }
+  if (typeof value === 'number') {
+    return value;
+  }
+  if (typeof value === 'string') {
+    const text = value.trim().toLowerCase();
+    if (FLOAT_SPECIALS.has(text)) {
+      return FLOAT_SPECIALS.get(text);
+    }
+    return FLOAT_PATTERN.test(text) ? Number.parseFloat(text.replace(/_/g, '')) : null;
+  }
+  return null;
+}
+
+export function parseBool(source, key, fallback) {
+  const value = getValue(source, key, fallback);
+  if (typeof value === 'boolean') {
+    return value;
+  }
+  if (typeof value === 'number') {
+    return value !== 0 && !Number.isNaN(value);
+  }
+  if (typeof value === 'string') {
+    return TRUE_STRINGS.has(value.trim().toLowerCase());
+  }
+  return fallback;
+}
+
+/**
+ * Parses a JSON body or query-string object into the full parameter set,
+ * equivalent to `{**DEFAULT_PARAMS, **_parse_params(source)}` in app.py.
+ *
+ * @param {Object|URLSearchParams|null} source
+ * @returns {Object}
+ */
+export function parseParams(source) {
+  let input = source;
+  if (input instanceof URLSearchParams) {
+    input = Object.fromEntries(input);
+  }
+  if (!input || typeof input !== 'object' || Array.isArray(input)) {
+    input = {};
+  }
+
+  const asInt = (name) => {
+    const fallback = DEFAULT_PARAMS[name];
+    const parsed = toInt(getValue(input, name, fallback));
+    return parsed === null ? fallback : parsed;
+  };
+  const asFloat = (name) => {
+    const fallback = DEFAULT_PARAMS[name];
+    const parsed = toFloat(getValue(input, name, fallback));
+    return parsed === null ? fallback : parsed;
+  };
+
+  const params = { ...DEFAULT_PARAMS };
+  params.p = atLeast(2, asInt('p'));
+  params.q = atLeast(2, asInt('q'));
+  params.t = asFloat('t');
+  params.size = atLeast(200, asInt('size'));
+
+  const mode = String(getValue(input, 'mode', DEFAULT_PARAMS.mode));
+  params.mode = ALLOWED_MODES.has(mode) ? mode : DEFAULT_PARAMS.mode;
+
+  const arcMode = String(getValue(input, 'arc_mode', DEFAULT_PARAMS.arc_mode));
+  params.arc_mode = ALLOWED_ARC_MODES.has(arcMode) ? arcMode : DEFAULT_PARAMS.arc_mode;
+
+  params.num_gaps = atLeast(0, asInt('num_gaps'));
+  params.debug_groups = parseBool(input, 'debug_groups', DEFAULT_PARAMS.debug_groups);
+  params.add_fill_pattern = parseBool(input, 'add_fill_pattern', DEFAULT_PARAMS.add_fill_pattern);
+  params.fill_pattern_spacing = atLeast(0.1, asFloat('fill_pattern_spacing'));
+  params.fill_pattern_angle = asFloat('fill_pattern_angle');
+  params.fill_pattern_offset = atLeast(0.0, asFloat('fill_pattern_offset'));
+  params.red_outline = parseBool(input, 'red_outline', DEFAULT_PARAMS.red_outline);
+  params.draw_group_outline = parseBool(input, 'draw_group_outline', DEFAULT_PARAMS.draw_group_outline);
+  return params;
+}
+
+/**
+ * Stable cache key for a parsed parameter set (key order is fixed by
+ * DEFAULT_PARAMS, so equal parameters always serialise identically).
+ */
+export function paramsKey(params) {
+  return JSON.stringify(Object.keys(DEFAULT_PARAMS).map(key => params[key]));
+}
+
+export const EXPORT_FORMATS = new Set(['dxf', 'step', 'svg', 'zip']);
+
+export const DEFAULT_EXPORT_OPTIONS = Object.freeze({
+  format: 'dxf',
+  bounding_box_width_mm: 250,
+  bounding_box_height_mm: 250,
+  step_thickness: 1,
+  name: 'doyle-spiral',
+});
+
+/**
+ * Parses the export-only query arguments of /api/spiral/export. They have no
+ * Flask counterpart, so an unknown format is an error (status 400) rather
+ * than a silent fallback. The bounding box defaults to the browser UI's, and
+ * the name is reduced to characters that are safe in a file name and inside
+ * a STEP string.
+ *
+ * @param {Object|URLSearchParams|null} source
+ * @returns {{format: string, bounding_box_width_mm: number, bounding_box_height_mm: number, step_thickness: number, name: string}}
+ */
+export function parseExportOptions(source) {
+  let input = source;
+  if (input instanceof URLSearchParams) {
+    input = Object.fromEntries(input);
+  }
+  if (!input || typeof input !== 'object' || Array.isArray(input)) {
+    input = {};
+  }
+
+  const format = String(getValue(input, 'format', DEFAULT_EXPORT_OPTIONS.format)).toLowerCase();
+  if (!EXPORT_FORMATS.has(format)) {
+    throw Object.assign(new Error(`Unknown export format "${format}"`), { status: 400 });
+  }
+  const asFloat = (name, fallback) => {
+    const parsed = toFloat(getValue(input, name, fallback));
+    return parsed === null || !Number.isFinite(parsed) ? fallback : parsed;
+  };
+
+  const width = atLeast(1, asFloat('bounding_box_width_mm', DEFAULT_EXPORT_OPTIONS.bounding_box_width_mm));
+  const height = atLeast(1, asFloat('bounding_box_height_mm', width));
+  const name = String(getValue(input, 'name', DEFAULT_EXPORT_OPTIONS.name))
+    .replace(/[^A-Za-z0-9._-]+/g, '-')
+    .replace(/^[.-]+/, '')
+    .slice(0, 64) || DEFAULT_EXPORT_OPTIONS.name;
+  return {
+    format,
+    bounding_box_width_mm: width,
+    bounding_box_height_mm: height,
+    step_thickness: atLeast(0.01, asFloat('step_thickness', DEFAULT_EXPORT_OPTIONS.step_thickness)),
+    name,
+  };
+}
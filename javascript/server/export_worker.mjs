@@ -0,0 +1,246 @@
+import { workerData, parentPort } from 'node:worker_threads';
+import zlib from 'node:zlib';
+import { renderSpiral, renderSpiralStream, canRenderSpiralStream } from '../js/doyle_spiral_engine.js';
+import { renderExportGeometry, writeExportFile } from '../js/export_precompute.js';
+
+// Streams one /api/spiral/export file to the service as 'chunk' messages.
+//
+// `credits[0]` counts chunks posted but not yet written to the socket; the
+// service decrements it from the write callback. The writers here are
+// synchronous, so the worker blocks on the counter instead of buffering, which
+// keeps at most CHUNK_WINDOW chunks of the file in memory however slowly the
+// client reads.
+
+const CHUNK_BYTES = 64 * 1024;
+const CHUNK_WINDOW = 8;
+
+const { params, options, credits: creditsBuffer } = workerData;
+const credits = new Int32Array(creditsBuffer);
+
+function createChannel() {
+  let parts = [];
+  let size = 0;
+  const post = () => {
+    if (!size) {
+      return;
+    }
+    let pending = Atomics.load(credits, 0);
+    while (pending >= CHUNK_WINDOW) {
+      Atomics.wait(credits, 0, pending, 1000);
+      pending = Atomics.load(credits, 0);
+    }
+    // A fresh buffer per message: transferring must never detach Buffer's shared pool.
+    const bytes = new Uint8Array(size);
+    let at = 0;
+    for (const part of parts) {
+      bytes.set(part, at);
+      at += part.length;
+    }
+    Atomics.add(credits, 0, 1);
+    parentPort.postMessage({ type: 'chunk', bytes }, [bytes.buffer]);
+    parts = [];
+    size = 0;
+  };
+  return {
+    write(bytes) {
+      parts.push(bytes);
+      size += bytes.length;
+      if (size >= CHUNK_BYTES) {
+        post();
+      }
+    },
+    flush: post,
+  };
+}
+
+// Collects text into CHUNK_BYTES buffers for `target`.
+function createTextWriter(target) {
+  let parts = [];
+  let length = 0;
+  const flush = () => {
+    if (!parts.length) {
+      return;
+    }
+    target(Buffer.from(parts.join(''), 'utf8'));
+    parts = [];
+    length = 0;
+  };
+  return {
+    write(text) {
+      parts.push(text);
+      length += text.length;
+      if (length >= CHUNK_BYTES) {
+        flush();
+      }
+    },
+    flush,
+  };
+}
+
+const FLAG_DATA_DESCRIPTOR_UTF8 = 0x0808;
+const DOS_DATE_1980_01_01 = 0x0021;
+// A final, empty fixed-Huffman block: ends a deflate stream after a sync flush.
+const DEFLATE_END = Buffer.from([0x03, 0x00]);
+
+/**
+ * Minimal streaming ZIP writer. Each entry is deflated in independent
+ * sync-flushed pieces, so nothing but the current chunk is held, and sizes
+ * and CRCs go in data descriptors after the data. Timestamps are fixed so the
+ * same request always gives the same archive. No ZIP64: entries and the
+ * archive stay below 4 GiB.
+ */
+class ZipWriter {
+  constructor(out) {
+    this.out = out;
+    this.offset = 0;
+    this.entries = [];
+    this.current = null;
+  }
+
+  _emit(bytes) {
+    this.offset += bytes.length;
+    if (this.offset > 0xffffffff) {
+      throw new Error('Export is too large for a ZIP archive');
+    }
+    this.out(bytes);
+  }
+
+  _header(signature, fields, name) {
+    const nameBytes = Buffer.from(name, 'utf8');
+    const header = Buffer.alloc(4 + fields.reduce((sum, [size]) => sum + size, 0));
+    header.writeUInt32LE(signature, 0);
+    let at = 4;
+    for (const [size, value] of fields) {
+      if (size === 2) header.writeUInt16LE(value, at);
+      else header.writeUInt32LE(value >>> 0, at);
+      at += size;
+    }
+    return Buffer.concat([header, nameBytes]);
+  }
+
+  _begin(name) {
+    const nameLength = Buffer.byteLength(name, 'utf8');
+    this.current = { name, offset: this.offset, crc: 0, size: 0, compressedSize: 0 };
+    this._emit(this._header(0x04034b50, [
+      [2, 20], [2, FLAG_DATA_DESCRIPTOR_UTF8], [2, 8], [2, 0], [2, DOS_DATE_1980_01_01],
+      [4, 0], [4, 0], [4, 0], [2, nameLength], [2, 0],
+    ], name));
+  }
+
+  /**
+   * Adds an entry whose contents `fill(write)` produces. The entry is only
+   * started by the first byte, so a fill that writes nothing adds nothing.
+   */
+  entry(name, fill) {
+    const write = bytes => {
+      if (!this.current) {
+        this._begin(name);
+      }
+      const entry = this.current;
+      entry.crc = zlib.crc32(bytes, entry.crc);
+      entry.size += bytes.length;
+      const deflated = zlib.deflateRawSync(bytes, { finishFlush: zlib.constants.Z_SYNC_FLUSH });
+      entry.compressedSize += deflated.length;
+      this._emit(deflated);
+    };
+    fill(write);
+    const entry = this.current;
+    if (!entry) {
+      return false;
+    }
+    entry.compressedSize += DEFLATE_END.length;
+    this._emit(DEFLATE_END);
+    if (entry.size > 0xffffffff) {
+      throw new Error('Export is too large for a ZIP archive');
+    }
+    const descriptor = Buffer.alloc(16);
+    descriptor.writeUInt32LE(0x08074b50, 0);
+    descriptor.writeUInt32LE(entry.crc >>> 0, 4);
+    descriptor.writeUInt32LE(entry.compressedSize, 8);
+    descriptor.writeUInt32LE(entry.size, 12);
+    this._emit(descriptor);
+    this.entries.push(entry);
+    this.current = null;
+    return true;
+  }
+
+  finish() {
+    const start = this.offset;
+    for (const entry of this.entries) {
+      this._emit(this._header(0x02014b50, [
+        [2, 20], [2, 20], [2, FLAG_DATA_DESCRIPTOR_UTF8], [2, 8], [2, 0], [2, DOS_DATE_1980_01_01],
+        [4, entry.crc], [4, entry.compressedSize], [4, entry.size],
+        [2, Buffer.byteLength(entry.name, 'utf8')], [2, 0], [2, 0], [2, 0], [2, 0], [4, 0], [4, entry.offset],
+      ], entry.name));
+    }
+    const size = this.offset - start;
+    this._emit(this._header(0x06054b50, [
+      [2, 0], [2, 0], [2, this.entries.length], [2, this.entries.length], [4, size], [4, start], [2, 0],
+    ], ''));
+  }
+}
+
+function exportOptions() {
+  return { stepThickness: options.step_thickness, name: options.name };
+}
+
+// Writes a whole string in CHUNK_BYTES slices.
+function writeString(text, write) {
+  for (let at = 0; at < text.length; at += CHUNK_BYTES) {
+    write(text.slice(at, at + CHUNK_BYTES));
+  }
+}
+
+function writeSVG(target) {
+  if (params.mode !== 'arram_boyle' || !canRenderSpiralStream(params)) {
+    // Doyle mode and pattern animations that need the whole spiral render in one piece.
+    writeString(renderSpiral(params, params.mode).svgString || '', target.write);
+    return;
+  }
+  // Ring-streamed: only a few rings of the spiral are alive at a time.
+  renderSpiralStream(params, target.write);
+}
+
+function nothingToExport() {
+  return Object.assign(new Error('Nothing to export: no outline gives a solid'), { status: 422 });
+}
+
+function run() {
+  const channel = createChannel();
+  const { format, name } = options;
+  if (format === 'svg') {
+    const text = createTextWriter(channel.write);
+    writeSVG(text);
+    text.flush();
+  } else if (format === 'zip') {
+    const zip = new ZipWriter(channel.write);
+    const addText = (entryName, fill) => zip.entry(entryName, write => {
+      const text = createTextWriter(write);
+      fill(text.write);
+      text.flush();
+    });
+    // The SVG is written like the svg format; DXF and STEP need the whole
+    // arram_boyle engine, which is only built once the SVG entry is written.
+    addText(`${name}.svg`, write => writeSVG({ write }));
+    const geometry = renderExportGeometry(params);
+    addText(`${name}.dxf`, write => writeExportFile(geometry, params, 'dxf', exportOptions(), write));
+    addText(`${name}.step`, write => writeExportFile(geometry, params, 'step', exportOptions(), write));
+    addText(`${name}_params.json`, write => write(JSON.stringify({ ...params, ...options }, null, 2)));
+    zip.finish();
+  } else {
+    const text = createTextWriter(channel.write);
+    const written = writeExportFile(renderExportGeometry(params), params, format, exportOptions(), text.write);
+    if (!written) {
+      throw nothingToExport();
+    }
+    text.flush();
+  }
+  channel.flush();
+}
+
+try {
+  run();
+  parentPort.postMessage({ type: 'done' });
+} catch (error) {
+  parentPort.postMessage({ type: 'error', message: error?.message || String(error), status: error?.status ?? null });
+}
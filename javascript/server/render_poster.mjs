@@ -0,0 +1,98 @@
+/**
+ * Ring-streamed poster export.
+ *
+ * Writes the arram_boyle SVG for one parameter set straight to a file while
+ * holding only a few rings of the spiral in memory, so p and q can go up to
+ * 1024 (the in-memory engine stops at 256). The file is byte-identical to the
+ * svgString renderSpiral() returns for the same parameters.
+ *
+ * Usage: node server/render_poster.mjs --out poster.svg --p 1024 --q 1024 [--name value ...]
+ *
+ * Any engine parameter (see normaliseParams) can be given as --name value;
+ * "true"/"false" become booleans and numeric strings become numbers.
+ */
+
+import fs from 'node:fs';
+import { fileURLToPath } from 'node:url';
+import { renderSpiralStream } from '../js/doyle_spiral_engine.js';
+
+const WRITE_CHUNK_BYTES = 4 * 1024 * 1024;
+
+export function parsePosterArgs(argv) {
+  const params = {};
+  let out = null;
+  for (let idx = 0; idx < argv.length; idx += 1) {
+    const arg = argv[idx];
+    if (!arg.startsWith('--')) {
+      throw new Error(`Unexpected argument "${arg}"`);
+    }
+    const name = arg.slice(2);
+    const value = argv[idx + 1];
+    if (value === undefined || value.startsWith('--')) {
+      throw new Error(`Missing value for --${name}`);
+    }
+    idx += 1;
+    if (name === 'out') {
+      out = value;
+    } else if (value === 'true' || value === 'false') {
+      params[name] = value === 'true';
+    } else if (value.trim() !== '' && Number.isFinite(Number(value))) {
+      params[name] = Number(value);
+    } else {
+      params[name] = value;
+    }
+  }
+  return { params, out };
+}
+
+/**
+ * Streams the poster SVG to `path`, batching small chunks into larger writes.
+ */
+export function writePoster(params, path) {
+  const fd = fs.openSync(path, 'w');
+  let pending = [];
+  let pendingBytes = 0;
+  let written = 0;
+  const drain = () => {
+    if (!pending.length) {
+      return;
+    }
+    const buffer = Buffer.from(pending.join(''), 'utf8');
+    fs.writeSync(fd, buffer);
+    written += buffer.length;
+    pending = [];
+    pendingBytes = 0;
+  };
+  try {
+    const info = renderSpiralStream(params, text => {
+      pending.push(text);
+      pendingBytes += text.length;
+      if (pendingBytes >= WRITE_CHUNK_BYTES) {
+        drain();
+      }
+    });
+    drain();
+    return { ...info, bytes: written };
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+if (process.argv[1] === fileURLToPath(import.meta.url)) {
+  try {
+    const { params, out } = parsePosterArgs(process.argv.slice(2));
+    if (!out) {
+      throw new Error('Missing --out <file.svg>');
+    }
+    const started = Date.now();
+    const info = writePoster({ ...params, mode: 'arram_boyle' }, out);
+    const seconds = ((Date.now() - started) / 1000).toFixed(1);
+    console.log(
+      `Wrote ${out}: ${info.bytes} bytes, ${info.circles} circles in ${info.rings} rings `
+      + `(at most ${info.peakLiveCircles} in memory) in ${seconds}s`,
+    );
+  } catch (error) {
+    console.error(error?.message || error);
+    process.exitCode = 1;
+  }
+}
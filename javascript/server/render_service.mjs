@@ -0,0 +1,523 @@
+/**
+ * Headless render service for the /api/spiral contract.
+ *
+ * Serves the same endpoints as app.py, but renders with the JavaScript engine:
+ *
+ *   POST /api/spiral            JSON body   -> { svg, params, geometry? }
+ *   GET  /api/spiral/geometry   query args  -> { geometry, params }
+ *   GET  /api/spiral/export     query args  -> streamed DXF, STEP, SVG or ZIP file
+ *
+ * Renders run on a worker_threads pool. Identical in-flight requests share one
+ * render, and finished renders are kept in a small LRU cache keyed by the
+ * normalised parameters (a geometry request and an arram_boyle spiral request
+ * with the same parameters share an entry).
+ *
+ * Exports take the spiral parameters plus `format` (dxf, step, svg or zip),
+ * `bounding_box_width_mm`, `bounding_box_height_mm`, `step_thickness` and
+ * `name`. They are not cached: each request gets its own worker, which writes
+ * the file with the browser exporters (same layers and thickness) and hands it
+ * over in chunks that go out with chunked transfer encoding as they are made.
+ *
+ * Usage: node server/render_service.mjs [--port 5001] [--workers N] [--cache 64]
+ */
+
+import http from 'node:http';
+import os from 'node:os';
+import { Worker } from 'node:worker_threads';
+import { fileURLToPath } from 'node:url';
+import { parseParams, parseExportOptions, paramsKey } from './api_params.mjs';
+import { EXPORT_MIME_TYPES } from '../js/export_precompute.js';
+
+const WORKER_URL = new URL('./render_worker.mjs', import.meta.url);
+const EXPORT_WORKER_URL = new URL('./export_worker.mjs', import.meta.url);
+const DEFAULT_PORT = 5001;
+const DEFAULT_CACHE_ENTRIES = 64;
+const DEFAULT_CACHE_BYTES = 256 * 1024 * 1024;
+const MAX_BODY_BYTES = 1024 * 1024;
+
+// ============================================================================
+// Worker pool
+// ============================================================================
+
+export class RenderPool {
+  constructor(size = Math.max(1, (os.availableParallelism?.() ?? os.cpus().length) - 1)) {
+    this.size = Math.max(1, size | 0);
+    this.workers = new Set();
+    this.idle = [];
+    this.queue = [];
+    this.pending = new Map();
+    this.nextId = 1;
+    this.closed = false;
+    for (let i = 0; i < this.size; i += 1) {
+      this._spawn();
+    }
+  }
+
+  _spawn() {
+    const worker = new Worker(WORKER_URL);
+    worker.current = null;
+    this.workers.add(worker);
+    worker.on('message', message => {
+      const task = this.pending.get(message.id);
+      this.pending.delete(message.id);
+      worker.current = null;
+      if (task) {
+        if (message.error) {
+          task.reject(new RenderError(message.error));
+        } else {
+          task.resolve({ svg: message.svg, geometry: message.geometry });
+        }
+      }
+      this._release(worker);
+    });
+    worker.on('error', error => {
+      this._fail(worker, error);
+    });
+    worker.on('exit', code => {
+      if (code !== 0) {
+        this._fail(worker, new Error(`Render worker exited with code ${code}`));
+      }
+    });
+    this._release(worker);
+  }
+
+  _fail(worker, error) {
+    if (worker.dead) {
+      return;
+    }
+    worker.dead = true;
+    this.workers.delete(worker);
+    this.idle = this.idle.filter(entry => entry !== worker);
+    const task = worker.current && this.pending.get(worker.current);
+    if (task) {
+      this.pending.delete(worker.current);
+      task.reject(error);
+    }
+    if (!this.closed) {
+      this._spawn();
+    }
+  }
+
+  _release(worker) {
+    const next = this.queue.shift();
+    if (next) {
+      this._dispatch(worker, next);
+    } else {
+      this.idle.push(worker);
+    }
+  }
+
+  _dispatch(worker, task) {
+    worker.current = task.id;
+    this.pending.set(task.id, task);
+    worker.postMessage({ id: task.id, params: task.params });
+  }
+
+  render(params) {
+    if (this.closed) {
+      return Promise.reject(new Error('Render pool is closed'));
+    }
+    return new Promise((resolve, reject) => {
+      const task = { id: this.nextId++, params, resolve, reject };
+      const worker = this.idle.pop();
+      if (worker) {
+        this._dispatch(worker, task);
+      } else {
+        this.queue.push(task);
+      }
+    });
+  }
+
+  async close() {
+    this.closed = true;
+    for (const task of this.queue.splice(0)) {
+      task.reject(new Error('Render pool is closed'));
+    }
+    for (const task of this.pending.values()) {
+      task.reject(new Error('Render pool is closed'));
+    }
+    this.pending.clear();
+    const workers = [...this.workers];
+    this.workers.clear();
+    this.idle = [];
+    await Promise.all(workers.map(worker => worker.terminate()));
+  }
+}
+
+export class RenderError extends Error {
+  constructor(message) {
+    super(message);
+    this.name = 'RenderError';
+  }
+}
+
+// ============================================================================
+// Cache and coalescing
+// ============================================================================
+
+/**
+ * LRU cache of rendered JSON fragments bounded by entry count and by the total
+ * length of the cached strings.
+ */
+export class RenderCache {
+  constructor(maxEntries = DEFAULT_CACHE_ENTRIES, maxBytes = DEFAULT_CACHE_BYTES) {
+    this.maxEntries = maxEntries;
+    this.maxBytes = maxBytes;
+    this.bytes = 0;
+    this.map = new Map();
+  }
+
+  static sizeOf(entry) {
+    return entry.svg.length + (entry.geometry ? entry.geometry.length : 0);
+  }
+
+  get(key) {
+    const entry = this.map.get(key);
+    if (!entry) return undefined;
+    this.map.delete(key);
+    this.map.set(key, entry);
+    return entry;
+  }
+
+  set(key, entry) {
+    if (this.maxEntries <= 0) return;
+    const size = RenderCache.sizeOf(entry);
+    if (size > this.maxBytes) return;
+    if (this.map.has(key)) {
+      this.bytes -= RenderCache.sizeOf(this.map.get(key));
+      this.map.delete(key);
+    }
+    this.map.set(key, entry);
+    this.bytes += size;
+    while (this.map.size > this.maxEntries || this.bytes > this.maxBytes) {
+      const [oldestKey, oldest] = this.map.entries().next().value;
+      this.map.delete(oldestKey);
+      this.bytes -= RenderCache.sizeOf(oldest);
+    }
+  }
+
+  clear() {
+    this.map.clear();
+    this.bytes = 0;
+  }
+}
+
+/**
+ * Resolves parameter sets to rendered fragments through the cache, then any
+ * identical render already in flight, then the worker pool.
+ */
+export class SpiralRenderer {
+  constructor({ pool, cache }) {
+    this.pool = pool;
+    this.cache = cache;
+    this.inflight = new Map();
+    this.stats = { renders: 0, cacheHits: 0, coalesced: 0, errors: 0 };
+  }
+
+  async render(params) {
+    const key = paramsKey(params);
+    const cached = this.cache.get(key);
+    if (cached) {
+      this.stats.cacheHits += 1;
+      return { ...cached, source: 'cache' };
+    }
+    const running = this.inflight.get(key);
+    if (running) {
+      this.stats.coalesced += 1;
+      return { ...(await running), source: 'coalesced' };
+    }
+    this.stats.renders += 1;
+    const job = this.pool.render(params).then(
+      result => {
+        this.inflight.delete(key);
+        this.cache.set(key, result);
+        return result;
+      },
+      error => {
+        this.inflight.delete(key);
+        this.stats.errors += 1;
+        throw error;
+      },
+    );
+    this.inflight.set(key, job);
+    return { ...(await job), source: 'render' };
+  }
+}
+
+// ============================================================================
+// Streaming exports
+// ============================================================================
+
+const EXPORT_CONTENT_TYPES = {
+  ...EXPORT_MIME_TYPES,
+  svg: 'image/svg+xml',
+  zip: 'application/zip',
+};
+
+/**
+ * Runs export requests, each in its own worker, at most `limit` at a time.
+ * The worker blocks while eight of its chunks are still unwritten (see
+ * export_worker.mjs), so a slow client holds the worker rather than memory.
+ */
+export class ExportStreams {
+  constructor(limit = 1) {
+    this.limit = Math.max(1, limit | 0);
+    this.running = new Set();
+    this.queue = [];
+    this.closed = false;
+  }
+
+  _acquire() {
+    if (this.running.size < this.limit) {
+      return Promise.resolve();
+    }
+    return new Promise((resolve, reject) => this.queue.push({ resolve, reject }));
+  }
+
+  _release(worker) {
+    this.running.delete(worker);
+    const next = this.queue.shift();
+    if (next) {
+      next.resolve();
+    }
+  }
+
+  /**
+   * Streams one export into `res`. Errors before the first chunk become JSON
+   * errors; later ones abort the response, so a truncated file is never
+   * mistaken for a complete one.
+   */
+  async stream(params, options, res) {
+    if (this.closed) {
+      throw new Error('Export service is closed');
+    }
+    await this._acquire();
+    const credits = new Int32Array(new SharedArrayBuffer(4));
+    const worker = new Worker(EXPORT_WORKER_URL, { workerData: { params, options, credits: credits.buffer } });
+    this.running.add(worker);
+
+    await new Promise(resolve => {
+      let finished = false;
+      const finish = () => {
+        if (!finished) {
+          finished = true;
+          this._release(worker);
+          worker.terminate();
+          resolve();
+        }
+      };
+      const fail = (message, status) => {
+        if (!res.headersSent) {
+          sendError(res, status || 500, message);
+        } else {
+          res.destroy(new Error(message));
+        }
+        finish();
+      };
+
+      res.on('close', () => {
+        if (!res.writableFinished) {
+          finish();
+        }
+      });
+      worker.on('message', message => {
+        if (finished) {
+          return;
+        }
+        if (message.type === 'chunk') {
+          if (!res.headersSent) {
+            res.writeHead(200, {
+              'Content-Type': EXPORT_CONTENT_TYPES[options.format],
+              'Content-Disposition': `attachment; filename="${options.name}.${options.format}"`,
+            });
+          }
+          res.write(message.bytes, () => {
+            Atomics.sub(credits, 0, 1);
+            Atomics.notify(credits, 0);
+          });
+        } else if (message.type === 'done') {
+          res.end();
+          finish();
+        } else if (message.type === 'error') {
+          fail(message.message, message.status || 400);
+        }
+      });
+      worker.on('error', error => fail(error?.message || 'Export failed', 500));
+      worker.on('exit', code => {
+        if (!finished) {
+          fail(`Export worker exited with code ${code}`, 500);
+        }
+      });
+    });
+  }
+
+  async close() {
+    this.closed = true;
+    for (const waiter of this.queue.splice(0)) {
+      waiter.reject(new Error('Export service is closed'));
+    }
+    await Promise.all([...this.running].map(worker => worker.terminate()));
+    this.running.clear();
+  }
+}
+
+// ============================================================================
+// HTTP
+// ============================================================================
+
+function sendJson(res, status, body, headers = {}) {
+  res.writeHead(status, {
+    'Content-Type': 'application/json',
+    'Content-Length': Buffer.byteLength(body),
+    ...headers,
+  });
+  res.end(body);
+}
+
+function sendError(res, status, message) {
+  sendJson(res, status, JSON.stringify({ error: message }));
+}
+
+function readJsonBody(req) {
+  return new Promise((resolve, reject) => {
+    const chunks = [];
+    let length = 0;
+    req.on('data', chunk => {
+      length += chunk.length;
+      if (length > MAX_BODY_BYTES) {
+        reject(Object.assign(new Error('Request body too large'), { status: 413 }));
+        req.destroy();
+        return;
+      }
+      chunks.push(chunk);
+    });
+    req.on('end', () => {
+      // Like Flask's get_json(silent=True): unparsable bodies count as empty.
+      try {
+        resolve(JSON.parse(Buffer.concat(chunks).toString('utf8')));
+      } catch {
+        resolve(null);
+      }
+    });
+    req.on('error', reject);
+  });
+}
+
+function renderFailure(res, error) {
+  if (error instanceof RenderError) {
+    sendError(res, 400, error.message);
+  } else {
+    sendError(res, 500, error?.message || 'Render failed');
+  }
+}
+
+/**
+ * Builds the request handler. Response bodies are assembled from the cached
+ * JSON fragments, so a cache hit does no serialisation of the geometry.
+ */
+export function createRequestHandler(renderer, exportStreams = null) {
+  return async (req, res) => {
+    const url = new URL(req.url, 'http://localhost');
+    try {
+      if (url.pathname === '/api/spiral') {
+        if (req.method !== 'POST') {
+          sendError(res, 405, 'Method not allowed');
+          return;
+        }
+        const params = parseParams(await readJsonBody(req));
+        const result = await renderer.render(params);
+        let body = `{"svg":${result.svg},"params":${JSON.stringify(params)}`;
+        if (result.geometry !== null) {
+          body += `,"geometry":${result.geometry}`;
+        }
+        sendJson(res, 200, `${body}}`, { 'X-Render-Source': result.source });
+        return;
+      }
+      if (url.pathname === '/api/spiral/geometry') {
+        if (req.method !== 'GET') {
+          sendError(res, 405, 'Method not allowed');
+          return;
+        }
+        const params = parseParams(url.searchParams);
+        params.mode = 'arram_boyle';
+        const result = await renderer.render(params);
+        sendJson(res, 200, `{"geometry":${result.geometry},"params":${JSON.stringify(params)}}`, {
+          'X-Render-Source': result.source,
+        });
+        return;
+      }
+      if (url.pathname === '/api/spiral/export' && exportStreams) {
+        if (req.method !== 'GET') {
+          sendError(res, 405, 'Method not allowed');
+          return;
+        }
+        const options = parseExportOptions(url.searchParams);
+        const params = {
+          ...parseParams(url.searchParams),
+          bounding_box_width_mm: options.bounding_box_width_mm,
+          bounding_box_height_mm: options.bounding_box_height_mm,
+        };
+        await exportStreams.stream(params, options, res);
+        return;
+      }
+      sendError(res, 404, 'Not found');
+    } catch (error) {
+      if (error?.status) {
+        sendError(res, error.status, error.message);
+      } else {
+        renderFailure(res, error);
+      }
+    }
+  };
+}
+
+/**
+ * Creates (but does not start) the render service.
+ *
+ * @param {Object} [options]
+ * @param {number} [options.workers]      - pool size (default: cores - 1)
+ * @param {number} [options.cacheEntries] - LRU entries (0 disables the cache)
+ * @param {number} [options.cacheBytes]   - LRU size bound in string length
+ * @returns {{server: http.Server, renderer: SpiralRenderer, exportStreams: ExportStreams, close: () => Promise<void>}}
+ */
+export function createRenderService({ workers, cacheEntries = DEFAULT_CACHE_ENTRIES, cacheBytes = DEFAULT_CACHE_BYTES } = {}) {
+  const pool = new RenderPool(workers);
+  const renderer = new SpiralRenderer({ pool, cache: new RenderCache(cacheEntries, cacheBytes) });
+  const exportStreams = new ExportStreams(pool.size);
+  const server = http.createServer(createRequestHandler(renderer, exportStreams));
+  const close = async () => {
+    await exportStreams.close();
+    await new Promise(resolve => server.close(() => resolve()));
+    await pool.close();
+  };
+  return { server, renderer, exportStreams, close };
+}
+
+function parseArgs(argv) {
+  const options = {};
+  for (let i = 0; i < argv.length; i += 1) {
+    const [flag, inline] = argv[i].split('=');
+    const value = inline ?? argv[i + 1];
+    if (inline === undefined && ['--port', '--workers', '--cache'].includes(flag)) {
+      i += 1;
+    }
+    if (flag === '--port') options.port = Number(value);
+    if (flag === '--workers') options.workers = Number(value);
+    if (flag === '--cache') options.cacheEntries = Number(value);
+  }
+  return options;
+}
+
+if (process.argv[1] && fileURLToPath(import.meta.url) === process.argv[1]) {
+  const options = parseArgs(process.argv.slice(2));
+  const port = options.port || Number(process.env.PORT) || DEFAULT_PORT;
+  const { server, renderer, close } = createRenderService(options);
+  server.listen(port, () => {
+    console.log(`Doyle render service listening on http://localhost:${port} (${renderer.pool.size} workers)`);
+  });
+  const shutdown = () => {
+    close().finally(() => process.exit(0));
+  };
+  process.on('SIGINT', shutdown);
+  process.on('SIGTERM', shutdown);
+}
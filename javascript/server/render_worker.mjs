@@ -0,0 +1,17 @@
+import { parentPort } from 'node:worker_threads';
+import { renderSpiral } from '../js/doyle_spiral_engine.js';
+
+// Renders one parameter set per message. Results are returned as JSON text so
+// the service can cache them and splice them into responses without
+// re-serialising the geometry on every hit.
+parentPort.on('message', ({ id, params }) => {
+  try {
+    const result = renderSpiral(params, params.mode);
+    const geometry = result.mode === 'arram_boyle' && result.geometry
+      ? JSON.stringify(result.geometry)
+      : null;
+    parentPort.postMessage({ id, svg: JSON.stringify(result.svgString || ''), geometry });
+  } catch (error) {
+    parentPort.postMessage({ id, error: error?.message || String(error) });
+  }
+});
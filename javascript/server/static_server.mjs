@@ -0,0 +1,114 @@
+/**
+ * Static file server for the browser UI.
+ *
+ * Serves the javascript/ folder like any static server, plus the headers that
+ * make the page cross-origin isolated, so the render worker can share its
+ * geometry store with the other workers as SharedArrayBuffers (see
+ * js/geometry_store.js). The CDN scripts are loaded with CORS, which
+ * require-corp needs. Without these headers the UI still works and falls back
+ * to transferable copies.
+ *
+ * Usage: node server/static_server.mjs [--port 8080]
+ */
+
+import http from 'node:http';
+import { createReadStream } from 'node:fs';
+import { stat } from 'node:fs/promises';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+
+const DEFAULT_PORT = 8080;
+const ROOT = fileURLToPath(new URL('..', import.meta.url));
+
+export const CROSS_ORIGIN_ISOLATION_HEADERS = {
+  'Cross-Origin-Opener-Policy': 'same-origin',
+  'Cross-Origin-Embedder-Policy': 'require-corp',
+};
+
+const CONTENT_TYPES = {
+  '.html': 'text/html; charset=utf-8',
+  '.js': 'text/javascript; charset=utf-8',
+  '.mjs': 'text/javascript; charset=utf-8',
+  '.css': 'text/css; charset=utf-8',
+  '.json': 'application/json',
+  '.svg': 'image/svg+xml',
+  '.png': 'image/png',
+  '.ico': 'image/x-icon',
+};
+
+function sendStatus(res, status, message) {
+  res.writeHead(status, { 'Content-Type': 'text/plain; charset=utf-8', ...CROSS_ORIGIN_ISOLATION_HEADERS });
+  res.end(message);
+}
+
+/**
+ * Builds the request handler for files under `root`. Paths outside it and
+ * dotfiles are not served.
+ */
+export function createStaticHandler(root = ROOT) {
+  const base = path.resolve(root);
+  return async (req, res) => {
+    if (req.method !== 'GET' && req.method !== 'HEAD') {
+      sendStatus(res, 405, 'Method not allowed');
+      return;
+    }
+    let pathname;
+    try {
+      pathname = decodeURIComponent(new URL(req.url, 'http://localhost').pathname);
+    } catch {
+      sendStatus(res, 400, 'Bad request');
+      return;
+    }
+    if (pathname.endsWith('/')) {
+      pathname += 'index.html';
+    }
+    const file = path.resolve(base, `.${pathname}`);
+    if (!file.startsWith(base + path.sep) || pathname.split('/').some(part => part.startsWith('.'))) {
+      sendStatus(res, 404, 'Not found');
+      return;
+    }
+    let info;
+    try {
+      info = await stat(file);
+    } catch {
+      info = null;
+    }
+    if (!info || !info.isFile()) {
+      sendStatus(res, 404, 'Not found');
+      return;
+    }
+    res.writeHead(200, {
+      'Content-Type': CONTENT_TYPES[path.extname(file)] || 'application/octet-stream',
+      'Content-Length': info.size,
+      'Cache-Control': 'no-cache',
+      ...CROSS_ORIGIN_ISOLATION_HEADERS,
+    });
+    if (req.method === 'HEAD') {
+      res.end();
+      return;
+    }
+    createReadStream(file).pipe(res);
+  };
+}
+
+function parseArgs(argv) {
+  const options = {};
+  for (let i = 0; i < argv.length; i += 1) {
+    const [flag, inline] = argv[i].split('=');
+    const value = inline ?? argv[i + 1];
+    if (inline === undefined && flag === '--port') {
+      i += 1;
+    }
+    if (flag === '--port') options.port = Number(value);
+  }
+  return options;
+}
+
+if (process.argv[1] && fileURLToPath(import.meta.url) === process.argv[1]) {
+  const options = parseArgs(process.argv.slice(2));
+  const port = options.port || Number(process.env.PORT) || DEFAULT_PORT;
+  const server = http.createServer(createStaticHandler());
+  server.listen(port, () => {
+    console.log(`Doyle UI on http://localhost:${port} (cross-origin isolated)`);
+  });
+}
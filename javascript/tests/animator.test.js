@@ -0,0 +1,118 @@
+import { describe, it, expect } from 'vitest';
+import {
+  AnimatorClient,
+  animatorLayout,
+  caAngleOverrides,
+  createAnimatorState,
+  loadAnimatorGeometry,
+  manualAngleOverrides,
+  presetFrameAngles,
+  simulateCAIterations,
+} from '../js/animator.js';
+import { renderSpiral, buildPatternAnimationContext } from '../js/doyle_spiral_engine.js';
+
+const PARAMS = { p: 8, q: 8, t: 0, mode: 'arram_boyle', add_fill_pattern: true };
+
+// One rule: a cell lights up when its first neighbour is lit.
+const FRAMES = [{
+  angle1: 30,
+  angle2: null,
+  rules: [{
+    input: { center: false, neighbors: [true, false, false, false, false, false] },
+    output: { center: true, neighbors: [false, false, false, false, false, false] },
+  }],
+}];
+
+function loaded(precision = 'float64') {
+  const result = renderSpiral({ ...PARAMS, geometry_precision: precision }, 'arram_boyle');
+  const state = loadAnimatorGeometry(createAnimatorState(), result.geometry);
+  return { result, state };
+}
+
+function centreCells(state) {
+  const { context } = state;
+  return context.metaList
+    .filter(meta => meta.ringIndex === context.minRing)
+    .map(meta => state.cellOf.get(meta.id));
+}
+
+describe('animator context from geometry', () => {
+  it('links the same neighbours as the engine, also from float32 geometry', () => {
+    const engineResult = renderSpiral(PARAMS, 'arram_boyle');
+    const expected = buildPatternAnimationContext(engineResult.engine.arcGroups);
+    // Ids come from a global counter, so compare neighbours by list position.
+    const linkage = ({ metaList }) => metaList.map(meta => Array.from(meta.neighbors, n => metaList.indexOf(n)));
+    for (const precision of ['float64', 'float32']) {
+      const { state } = loaded(precision);
+      expect(linkage(state.context)).toEqual(linkage(expected));
+    }
+  });
+
+  it('lays out one marker per animated cell and one path per arcgroup', () => {
+    const { result, state } = loaded();
+    const layout = animatorLayout(state, result.scaleFactor);
+    expect(layout.cellCount).toBe(result.geometry.arcgroups.length);
+    expect(layout.cells.cell.length).toBe(state.context.metaList.length);
+    expect(layout.paths.every(d => d === '' || /^M.*Z$/.test(d))).toBe(true);
+    expect(Array.from(layout.cells.extent).every(e => e > 0)).toBe(true);
+  });
+});
+
+describe('animator results', () => {
+  it('renders CA overrides onto the groups they address', () => {
+    const { state } = loaded();
+    const seeds = centreCells(state);
+    const overrides = caAngleOverrides(state, FRAMES, seeds);
+    const rendered = renderSpiral(PARAMS, 'arram_boyle', { arcGroupAngleOverrides: overrides });
+    const groups = Array.from(rendered.engine.arcGroups.entries()).filter(([key]) => !key.startsWith('outer_'));
+    let lit = 0;
+    groups.forEach(([, group], idx) => {
+      if (Array.isArray(overrides[idx])) {
+        expect(group.patternAngles).toEqual(overrides[idx]);
+        if (overrides[idx].length) lit += 1;
+      }
+    });
+    expect(lit).toBeGreaterThanOrEqual(seeds.length);
+  });
+
+  it('switches off every animated cell outside a manual frame', () => {
+    const { result, state } = loaded();
+    const layout = animatorLayout(state, result.scaleFactor);
+    const active = new Set(centreCells(state));
+    const overrides = manualAngleOverrides(layout, active, 60);
+    const rendered = renderSpiral(PARAMS, 'arram_boyle', { arcGroupAngleOverrides: overrides });
+    const groups = Array.from(rendered.engine.arcGroups.values()).filter(g => !g.name.startsWith('outer_'));
+    for (const idx of layout.cells.cell) {
+      expect(groups[idx].patternAngles).toEqual(active.has(idx) ? [60] : []);
+    }
+  });
+
+  it('snapshots start at the seeds and stay within the cell count', () => {
+    const { state } = loaded();
+    const seeds = centreCells(state);
+    const snapshots = simulateCAIterations(state, FRAMES, seeds, 20);
+    expect(snapshots.length).toBeGreaterThan(1);
+    expect(snapshots[0].reduce((sum, on) => sum + on, 0)).toBe(seeds.length);
+    snapshots.forEach(states => expect(states.length).toBe(state.metaOf.length));
+  });
+
+  it('gives preset frames as shared per-cell angle arrays', () => {
+    const { state } = loaded();
+    const frames = presetFrameAngles(state, { animationId: 'radial_bloom', baseAngle: 0 }, 6);
+    expect(frames.length).toBeGreaterThan(0);
+    expect(frames[0].length).toBe(state.metaOf.length);
+    expect(new Set(frames).size).toBeLessThanOrEqual(frames.length);
+  });
+});
+
+describe('AnimatorClient', () => {
+  it('answers requests on the main thread without a worker', async () => {
+    const client = new AnimatorClient();
+    const { layout } = await client.request('load', { geometry: null, params: PARAMS });
+    expect(layout.cells.cell.length).toBeGreaterThan(0);
+    const { overrides } = await client.request('ca', { frames: FRAMES, seeds: [], loopMode: true });
+    expect(overrides.length).toBe(layout.cellCount);
+    const failure = await client.request('bogus', {}).catch(error => error);
+    expect(failure.message).toMatch(/Unknown animator request/);
+  });
+});
@@ -1,5 +1,15 @@
 import { describe, it, expect } from 'vitest';
-import { getBreakdownRings, generateBreakdownSVG, countWorkpieces, getOuterBoundsRequired, centreOutline, getFittingGroups, stitchPaths } from '../js/breakdown.js';
+import {
+  getBreakdownRings,
+  generateBreakdownSVG,
+  countWorkpieces,
+  getOuterBoundsRequired,
+  centreOutline,
+  getFittingGroups,
+  stitchPaths,
+  groupCongruentPieces,
+  buildBreakdownManifest,
+} from '../js/breakdown.js';
 import { generateSingleGroupDXF } from '../js/dxf_export.js';
 import { renderSpiral } from '../js/doyle_spiral_engine.js';
 
@@ -723,3 +733,66 @@ describe('stitchPaths', () => {
     expect(stitchPaths([])).toEqual([]);
   });
 });
+
+describe('groupCongruentPieces', () => {
+  const res = renderSpiral({
+    p: 16, q: 16, t: 0,
+    bounding_box_width_mm: 1000,
+    bounding_box_height_mm: 1000,
+    mode: 'arram_boyle',
+    add_fill_pattern: true,
+  }, 'arram_boyle');
+  const sf = res.scaleFactor;
+  const rings = getBreakdownRings(res.engine.arcGroups, sf, 250, 250);
+  const fitting = new Set(rings.map(r => r.ringIndex));
+  const overflow = Array.from(res.engine.arcGroups.entries())
+    .filter(([key, g]) => key.startsWith('circle_') && g.ringIndex >= 0 && !fitting.has(g.ringIndex))
+    .map(([, g]) => g);
+  const ringCount = new Set(overflow.map(g => g.ringIndex)).size;
+
+  it('collapses every ring of unhatched pieces into one piece', () => {
+    const pieces = groupCongruentPieces(overflow);
+    expect(pieces).toHaveLength(ringCount);
+    expect(pieces.reduce((sum, piece) => sum + piece.members.length, 0)).toBe(overflow.length);
+  });
+
+  it('rotates the representative outline onto each member', () => {
+    const [piece] = groupCongruentPieces(overflow);
+    const reference = centreOutline(piece.representative.getClosedOutline());
+    for (const { group, rotationDeg } of piece.members) {
+      const outline = centreOutline(group.getClosedOutline());
+      const rad = rotationDeg * Math.PI / 180;
+      const x = reference[0].re * Math.cos(rad) - reference[0].im * Math.sin(rad);
+      const y = reference[0].re * Math.sin(rad) + reference[0].im * Math.cos(rad);
+      expect(Math.hypot(x - outline[0].re, y - outline[0].im)).toBeLessThan(1e-6);
+    }
+  });
+
+  it('keeps pieces apart whose hatch differs relative to the piece', () => {
+    const world = groupCongruentPieces(overflow, { patternAnglesOf: () => [0] });
+    expect(world.length).toBeGreaterThan(ringCount);
+    // The same angle relative to each piece's template matches again.
+    const relative = groupCongruentPieces(overflow, {
+      patternAnglesOf: g => {
+        const frameDeg = (g.cloneOf ? g._rotationCache.angle : 0) * 180 / Math.PI
+          + Math.atan2((g.cloneOf || g).templateTransform.sin, (g.cloneOf || g).templateTransform.cos) * 180 / Math.PI;
+        return [frameDeg + 30];
+      },
+    });
+    expect(relative).toHaveLength(ringCount);
+  });
+
+  it('lists every physical piece once in the manifest', () => {
+    const pieces = groupCongruentPieces(overflow);
+    const entries = [
+      { file: 'wp.svg', ringIndex: null, members: null },
+      ...pieces.map((piece, i) => ({ file: `piece_${i}.svg`, ringIndex: piece.ringIndex, members: piece.members })),
+    ];
+    const lines = buildBreakdownManifest(entries, sf).trim().split('\n');
+    expect(lines[0]).toBe('file,ring,quantity,group,rotation_deg,centre_x_mm,centre_y_mm');
+    expect(lines).toHaveLength(2 + overflow.length);
+    expect(lines[1]).toBe('wp.svg,,1,,0.0000,0.0000,0.0000');
+    const quantity = Number(lines[2].split(',')[2]);
+    expect(quantity).toBe(pieces[0].members.length);
+  });
+});
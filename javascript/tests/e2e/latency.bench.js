@@ -0,0 +1,144 @@
+import { test, expect } from '@playwright/test';
+import fs from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+
+// Interactive latency benchmark. Drives the UI over a parameter matrix and
+// collects the `doyle:*` performance.measure spans emitted by app.js.
+//
+//   npm run bench:latency                              # run and compare
+//   UPDATE_LATENCY_BASELINE=1 npm run bench:latency    # record a new baseline
+//
+// The report is written to bench-results/latency.json. When
+// tests/e2e/latency-baseline.json exists, any span whose median is slower than
+// baseline * (1 + LATENCY_TOLERANCE) + LATENCY_SLACK_MS fails the run.
+
+const here = path.dirname(fileURLToPath(import.meta.url));
+const REPORT_PATH = path.resolve(here, '../../bench-results/latency.json');
+const BASELINE_PATH = path.resolve(here, 'latency-baseline.json');
+const REPEATS = Number(process.env.LATENCY_REPEATS || 3);
+const TOLERANCE = Number(process.env.LATENCY_TOLERANCE || 0.25);
+const SLACK_MS = Number(process.env.LATENCY_SLACK_MS || 20);
+
+const MATRIX = [
+  { p: 8, q: 8, fill: false },
+  { p: 16, q: 16, fill: false },
+  { p: 16, q: 16, fill: true },
+  { p: 24, q: 24, fill: true },
+];
+
+const samples = {};
+
+function record(cell, span, duration) {
+  if (!Number.isFinite(duration)) return;
+  const key = `${span}|p=${cell.p},q=${cell.q},fill=${cell.fill}`;
+  (samples[key] ||= []).push(duration);
+}
+
+async function measureCount(page, name) {
+  return page.evaluate(n => performance.getEntriesByName(`doyle:${n}`, 'measure').length, name);
+}
+
+async function waitForMeasure(page, name, previousCount, timeout = 60000) {
+  await page.waitForFunction(
+    ([n, count]) => performance.getEntriesByName(`doyle:${n}`, 'measure').length > count,
+    [name, previousCount],
+    { timeout },
+  );
+  return page.evaluate(n => {
+    const entries = performance.getEntriesByName(`doyle:${n}`, 'measure');
+    return entries[entries.length - 1].duration;
+  }, name);
+}
+
+async function applyCell(page, cell) {
+  await page.locator('#toggleSymmetric').setChecked(cell.p === cell.q);
+  await page.locator('#inputP').fill(String(cell.p));
+  await page.locator('#inputQ').fill(String(cell.q));
+  await page.locator('#togglePattern').setChecked(cell.fill);
+  const before = await measureCount(page, 'render-to-paint');
+  await page.locator('#inputP').dispatchEvent('input');
+  await waitForMeasure(page, 'render-to-paint', before);
+}
+
+function summarise(values) {
+  const sorted = values.slice().sort((a, b) => a - b);
+  const at = q => sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))];
+  return { samples: sorted.length, median: at(0.5), p95: at(0.95), min: sorted[0], max: sorted[sorted.length - 1] };
+}
+
+test.describe.configure({ mode: 'serial' });
+
+for (const cell of MATRIX) {
+  test(`latency p=${cell.p} q=${cell.q} fill=${cell.fill}`, async ({ page }) => {
+    await page.goto('/');
+    await page.waitForSelector('#svgPreview svg', { timeout: 30000 });
+    await applyCell(page, cell);
+
+    for (let run = 0; run < REPEATS; run++) {
+      // Slider change to first paint
+      let before = await measureCount(page, 'input-to-paint');
+      await page.locator('#inputT').fill(((run + 1) * 0.1).toFixed(2));
+      await page.locator('#inputT').dispatchEvent('input');
+      record(cell, 'input-to-paint', await waitForMeasure(page, 'input-to-paint', before));
+
+      // Export click to download
+      before = await measureCount(page, 'export-to-download');
+      const [download] = await Promise.all([
+        page.waitForEvent('download'),
+        page.locator('#exportSvgButton').click(),
+      ]);
+      expect(download.suggestedFilename()).toMatch(/\.svg$/);
+      record(cell, 'export-svg-to-download', await waitForMeasure(page, 'export-to-download', before));
+    }
+
+    // Animator toggle to highlight
+    await page.locator('[data-view="animator"]').click();
+    const marker = page.locator('#animatorSvgPreview .cell-marker').first();
+    await marker.waitFor({ timeout: 60000 });
+    for (let run = 0; run < REPEATS; run++) {
+      const before = await measureCount(page, 'animator-toggle-to-highlight');
+      await marker.click({ force: true });
+      record(cell, 'animator-toggle-to-highlight', await waitForMeasure(page, 'animator-toggle-to-highlight', before));
+    }
+
+    // 3D tab open to first frame (skipped when Three.js cannot load, e.g. offline)
+    await page.locator('[data-view="2d"]').click();
+    const hasThree = await page.evaluate(() => typeof THREE !== 'undefined');
+    if (hasThree) {
+      const before = await measureCount(page, '3d-open-to-frame');
+      await page.locator('[data-view="3d"]').click();
+      record(cell, '3d-open-to-frame', await waitForMeasure(page, '3d-open-to-frame', before));
+    }
+  });
+}
+
+test.afterAll(() => {
+  const spans = {};
+  for (const [key, values] of Object.entries(samples)) {
+    spans[key] = summarise(values);
+  }
+  const report = { generatedAt: new Date().toISOString(), repeats: REPEATS, matrix: MATRIX, spans };
+  fs.mkdirSync(path.dirname(REPORT_PATH), { recursive: true });
+  fs.writeFileSync(REPORT_PATH, `${JSON.stringify(report, null, 2)}\n`);
+
+  if (process.env.UPDATE_LATENCY_BASELINE) {
+    fs.writeFileSync(BASELINE_PATH, `${JSON.stringify(report, null, 2)}\n`);
+    return;
+  }
+  if (!fs.existsSync(BASELINE_PATH)) {
+    console.log(`No latency baseline at ${BASELINE_PATH}; run with UPDATE_LATENCY_BASELINE=1 to record one.`);
+    return;
+  }
+  const baseline = JSON.parse(fs.readFileSync(BASELINE_PATH, 'utf8'));
+  const regressions = [];
+  for (const [key, current] of Object.entries(spans)) {
+    const base = baseline.spans?.[key];
+    if (!base) continue;
+    const limit = base.median * (1 + TOLERANCE) + SLACK_MS;
+    const status = current.median > limit ? 'REGRESSION' : 'ok';
+    console.log(`${status.padEnd(10)} ${key.padEnd(60)} ${current.median.toFixed(1)} ms (baseline ${base.median.toFixed(1)} ms)`);
+    if (current.median > limit) regressions.push(key);
+  }
+  expect(regressions, `latency regressions: ${regressions.join(', ')}`).toEqual([]);
+});
@@ -0,0 +1,22 @@
+import { describe, it, expect } from 'vitest';
+import { readFileSync } from 'node:fs';
+import { buildEngineBundle, checkEngineBundle, ENGINE_FILES } from '../build_engine.mjs';
+
+describe('engine bundle', () => {
+  it('keeps the Flask UI copies identical to javascript/js', () => {
+    const { build, stale } = checkEngineBundle();
+    // Fails when the engine changed without `npm run build:engine`.
+    expect(stale).toEqual([]);
+    expect(build).toMatch(/^[0-9a-f]{12}$/);
+  });
+
+  it('stamps every generated file with the same build id over the unmodified source', () => {
+    const { build, files } = buildEngineBundle();
+    expect([...files.keys()]).toEqual(ENGINE_FILES);
+    for (const [name, text] of files) {
+      const source = readFileSync(new URL(`../js/${name}`, import.meta.url), 'utf8');
+      expect(text.split('\n', 1)[0]).toContain(`engine build ${build}`);
+      expect(text.endsWith(source)).toBe(true);
+    }
+  });
+});
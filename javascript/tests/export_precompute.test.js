@@ -0,0 +1,135 @@
+import { describe, it, expect } from 'vitest';
+import {
+  ExportPrecompute,
+  buildExportFile,
+  exportRequestKey,
+  renderExportGeometry,
+} from '../js/export_precompute.js';
+import { normaliseParams } from '../js/doyle_spiral_engine.js';
+import { generateDXF } from '../js/dxf_export.js';
+import { validateExportGeometry } from '../js/export_validation.js';
+
+const PARAMS = normaliseParams({ p: 8, q: 8, t: 0, add_fill_pattern: true });
+
+// Stands in for export_worker.js: answers on the next tick, like a real worker.
+class FakeWorker {
+  constructor(log) {
+    this.log = log;
+    this.terminated = false;
+    log.push(this);
+  }
+
+  postMessage(message) {
+    this.message = message;
+    setTimeout(() => {
+      if (this.terminated) return;
+      const geometry = renderExportGeometry(message.params);
+      if (message.validate) {
+        const report = validateExportGeometry(geometry, message.params, message.options);
+        this.onmessage({ data: { type: 'validation', requestId: message.requestId, report } });
+      }
+      for (const format of message.formats) {
+        const bytes = new TextEncoder().encode(buildExportFile(geometry, message.params, format, message.options));
+        this.onmessage({ data: { type: 'file', requestId: message.requestId, format, bytes } });
+      }
+      this.onmessage({ data: { type: 'done', requestId: message.requestId } });
+    }, 0);
+  }
+
+  terminate() {
+    this.terminated = true;
+  }
+}
+
+function setup() {
+  const workers = [];
+  const idle = [];
+  const reports = [];
+  const precompute = new ExportPrecompute({
+    createWorker: () => new FakeWorker(workers),
+    requestIdle: cb => idle.push(cb) - 1,
+    cancelIdle: handle => { idle[handle] = null; },
+    onValidation: report => reports.push(report),
+  });
+  const runIdle = () => idle.splice(0).forEach(cb => cb && cb());
+  return { precompute, workers, runIdle, reports };
+}
+
+const tick = () => new Promise(resolve => setTimeout(resolve, 5));
+
+describe('buildExportFile', () => {
+  it('matches the direct DXF export and rejects unknown formats', () => {
+    const geometry = renderExportGeometry(PARAMS);
+    expect(buildExportFile(geometry, PARAMS, 'dxf')).toBe(
+      generateDXF(geometry.engine.arcGroups, geometry.scaleFactor, PARAMS.bounding_box_width_mm, PARAMS.bounding_box_height_mm, {
+        drawGroupOutline: false,
+        redOutline: true,
+      }),
+    );
+    expect(buildExportFile(geometry, PARAMS, 'step', { name: 'disk', stepThickness: 2 })).toContain('disk');
+    expect(() => buildExportFile(geometry, PARAMS, 'obj')).toThrow(/Unknown export format/);
+  });
+
+  it('keys STEP files on their options and ignores them for DXF', () => {
+    const a = exportRequestKey(PARAMS, 'step', { stepThickness: 1, name: 'a' });
+    expect(exportRequestKey(PARAMS, 'step', { stepThickness: 2, name: 'a' })).not.toBe(a);
+    expect(exportRequestKey({ ...PARAMS, p: 9 }, 'step', { stepThickness: 1, name: 'a' })).not.toBe(a);
+    expect(exportRequestKey(PARAMS, 'dxf', { name: 'a' })).toBe(exportRequestKey(PARAMS, 'dxf', { name: 'b' }));
+  });
+});
+
+describe('ExportPrecompute', () => {
+  it('builds the files once idle and serves them only for the same request', async () => {
+    const { precompute, workers, runIdle } = setup();
+    const options = { stepThickness: 1, name: 'disk' };
+    precompute.schedule(PARAMS, ['dxf', 'step'], options);
+    expect(workers).toHaveLength(0);
+    expect(precompute.isPending(PARAMS, 'dxf')).toBe(true);
+    runIdle();
+    await tick();
+
+    const dxf = precompute.get(PARAMS, 'dxf');
+    expect(dxf).not.toBeNull();
+    expect(dxf.type).toBe('application/dxf');
+    expect(await dxf.text()).toBe(buildExportFile(renderExportGeometry(PARAMS), PARAMS, 'dxf'));
+    expect(precompute.get(PARAMS, 'step', options)).not.toBeNull();
+    expect(precompute.get(PARAMS, 'step', { ...options, stepThickness: 3 })).toBeNull();
+    expect(precompute.get({ ...PARAMS, t: 0.5 }, 'dxf')).toBeNull();
+    expect(workers[0].terminated).toBe(true);
+  });
+
+  it('validates the same geometry and keys the report on the beam width', async () => {
+    const { precompute, runIdle, reports } = setup();
+    const options = { stepThickness: 1, name: 'disk', beamWidth: 0.2 };
+    precompute.schedule(PARAMS, ['dxf'], options);
+    runIdle();
+    await tick();
+    expect(reports).toHaveLength(1);
+    expect(precompute.getValidation(PARAMS, { beamWidth: 0.2 })).toBe(reports[0]);
+    // Group names come from a global counter, so compare what was found.
+    const direct = validateExportGeometry(renderExportGeometry(PARAMS), PARAMS, { beamWidth: 0.2 });
+    expect(reports[0].counts).toEqual(direct.counts);
+    expect(reports[0].counts.featureWidth).toBeGreaterThan(0);
+    expect(precompute.getValidation(PARAMS, { beamWidth: 0.1 })).toBeNull();
+    precompute.invalidate();
+    expect(precompute.getValidation(PARAMS, { beamWidth: 0.2 })).toBeNull();
+  });
+
+  it('drops cached files and cancels in-flight work when invalidated', async () => {
+    const { precompute, workers, runIdle } = setup();
+    precompute.schedule(PARAMS);
+    precompute.invalidate();
+    runIdle();
+    expect(workers).toHaveLength(0);
+
+    precompute.schedule(PARAMS);
+    runIdle();
+    precompute.schedule({ ...PARAMS, t: 0.25 });
+    expect(workers[0].terminated).toBe(true);
+    await tick();
+    expect(precompute.get(PARAMS, 'dxf')).toBeNull();
+    runIdle();
+    await tick();
+    expect(precompute.get({ ...PARAMS, t: 0.25 }, 'dxf')).not.toBeNull();
+  });
+});
@@ -0,0 +1,90 @@
+import { describe, it, expect } from 'vitest';
+import {
+  polygonSelfIntersection,
+  previewPoint,
+  validateExportGeometry,
+  validationSummary,
+} from '../js/export_validation.js';
+import { renderExportGeometry } from '../js/export_precompute.js';
+import { normaliseParams } from '../js/doyle_spiral_engine.js';
+
+const PARAMS = normaliseParams({ p: 8, q: 8, t: 0, add_fill_pattern: true });
+
+function groupsOf(geometry) {
+  return Array.from(geometry.engine.arcGroups.entries()).filter(([key]) => !key.startsWith('outer_'));
+}
+
+describe('polygonSelfIntersection', () => {
+  it('finds the crossing of a bow tie and accepts simple polygons', () => {
+    const bowTie = [{ x: 0, y: 0 }, { x: 2, y: 2 }, { x: 2, y: 0 }, { x: 0, y: 2 }];
+    expect(polygonSelfIntersection(bowTie)).toEqual({ x: 1, y: 1 });
+    const ring = Array.from({ length: 64 }, (_, i) => ({ x: Math.cos(i * Math.PI / 32), y: Math.sin(i * Math.PI / 32) * 0.5 }));
+    expect(polygonSelfIntersection(ring)).toBeNull();
+    expect(polygonSelfIntersection([{ x: 0, y: 0 }, { x: 1, y: 0 }, { x: 1, y: 1 }, { x: 0, y: 1 }])).toBeNull();
+  });
+});
+
+describe('validateExportGeometry', () => {
+  it('passes a plain render', () => {
+    const geometry = renderExportGeometry(PARAMS);
+    const report = validateExportGeometry(geometry, PARAMS, { beamWidth: 0 });
+    expect(report.sharedOutlineSegments).toBeGreaterThan(0);
+    // The cusps of the centre groups bring both sides of the spike within
+    // the tolerance; they are counted apart, not reported.
+    expect(report.retracedOutlineSegments).toBe(13);
+    expect(report.counts).toEqual({
+      openOutline: 0,
+      selfIntersection: 0,
+      insetSelfIntersection: 0,
+      featureWidth: 0,
+      duplicateSegment: 0,
+      outOfBounds: 0,
+    });
+    expect(report.ok).toBe(true);
+    const clean = { ...PARAMS, bounding_box_width_mm: 200, bounding_box_height_mm: 200 };
+    const cleanReport = validateExportGeometry({ engine: { arcGroups: new Map() }, scaleFactor: 1 }, clean);
+    expect(cleanReport.ok).toBe(true);
+    expect(validationSummary(cleanReport)).toBe('');
+  });
+
+  it('reports open outlines, out-of-bounds paths and thin hatch rectangles where they are', () => {
+    const params = { ...PARAMS, fill_pattern_type: 'rectangles', fill_pattern_rect_width: 0.05 };
+    const geometry = renderExportGeometry(params);
+    const [key, group] = groupsOf(geometry)[5];
+    group._outlineCache = group.getClosedOutline().slice(0, -3);
+    const small = { ...params, bounding_box_width_mm: params.bounding_box_width_mm / 2 };
+    const report = validateExportGeometry(geometry, small, { beamWidth: 0.1, maxIssues: 10000 });
+
+    const open = report.issues.filter(issue => issue.check === 'openOutline');
+    expect(open).toHaveLength(1);
+    expect(open[0].group).toBe(key);
+    expect(report.counts.outOfBounds).toBeGreaterThan(0);
+    for (const issue of report.issues.filter(i => i.check === 'outOfBounds')) {
+      expect(issue.x < 0 || issue.x > small.bounding_box_width_mm).toBe(true);
+    }
+    expect(report.counts.featureWidth).toBeGreaterThan(0);
+    expect(validationSummary(report)).toMatch(/1 open outline\b/);
+    const point = previewPoint(report, open[0]);
+    expect(Math.abs(point.x)).toBeLessThan(small.bounding_box_width_mm);
+  });
+
+  it('flags highlight arcs cut over outlines and caps the listed issues', () => {
+    const params = { ...PARAMS, red_outline: true };
+    const report = validateExportGeometry(renderExportGeometry(params), params, { beamWidth: 0, maxIssues: 3 });
+    expect(report.counts.duplicateSegment).toBeGreaterThan(3);
+    expect(report.issues).toHaveLength(3);
+    expect(report.truncated).toBe(true);
+    expect(report.issues[0].message).toMatch(/highlight|outline/);
+  });
+
+  it('checks the hatch inset only when there is an offset', () => {
+    const geometry = renderExportGeometry(PARAMS);
+    expect(validateExportGeometry(geometry, PARAMS, { beamWidth: 0 }).counts.insetSelfIntersection).toBe(0);
+    const inset = { ...PARAMS, fill_pattern_offset: 1 };
+    const report = validateExportGeometry(renderExportGeometry(inset), inset, { beamWidth: 0 });
+    expect(report.counts.insetSelfIntersection).toBeGreaterThan(0);
+    for (const issue of report.issues.filter(i => i.check === 'insetSelfIntersection')) {
+      expect(issue.message).toMatch(/inset of 1 mm/);
+    }
+  });
+});
@@ -0,0 +1,128 @@
+import { describe, it, expect } from 'vitest';
+import { collectGCodeLayers, gcodeLayerOptions, orderPathsForTravel, fitArcMoves, planGCode, estimateJobTime, streamGCode, generateGCode, resolveLayerSettings } from '../js/gcode_export.js';
+import { renderSpiral } from '../js/doyle_spiral_engine.js';
+
+function renderEngine(params = {}) {
+  const res = renderSpiral({ p: 8, q: 8, t: 0, mode: 'arram_boyle', ...params }, 'arram_boyle');
+  return { engine: res.engine, scaleFactor: res.scaleFactor, params: res.params };
+}
+
+function travelLength(paths, start = { x: 0, y: 0 }) {
+  let pos = start;
+  let total = 0;
+  for (const path of paths) {
+    total += Math.hypot(path.points[0].x - pos.x, path.points[0].y - pos.y);
+    pos = path.closed ? path.points[0] : path.points[path.points.length - 1];
+  }
+  return total;
+}
+
+describe('orderPathsForTravel', () => {
+  it('reverses open paths so the nearer end is cut first', () => {
+    const paths = [
+      { points: [{ x: 10, y: 0 }, { x: 1, y: 0 }], closed: false },
+      { points: [{ x: 20, y: 0 }, { x: 11, y: 0 }], closed: false },
+    ];
+    const ordered = orderPathsForTravel(paths, { x: 0, y: 0 });
+    expect(ordered[0].points[0]).toEqual({ x: 1, y: 0 });
+    expect(ordered[1].points[0]).toEqual({ x: 11, y: 0 });
+  });
+
+  it('travels less than the input order on shuffled hatch lines', () => {
+    const paths = [];
+    for (let i = 0; i < 200; i++) {
+      const y = (i * 37) % 200;
+      paths.push({ points: [{ x: 0, y }, { x: 50, y }], closed: false });
+    }
+    const ordered = orderPathsForTravel(paths);
+    expect(ordered).toHaveLength(paths.length);
+    expect(travelLength(ordered)).toBeLessThan(travelLength(paths) / 10);
+  });
+});
+
+describe('fitArcMoves', () => {
+  it('merges vertices on a circle into one arc move', () => {
+    const circle = { cx: 0, cy: 0, r: 5 };
+    const pts = [];
+    for (let i = 0; i <= 10; i++) {
+      const a = (i / 10) * (Math.PI / 2);
+      pts.push({ x: 5 * Math.cos(a), y: 5 * Math.sin(a) });
+    }
+    const moves = fitArcMoves(pts, false, [circle]);
+    expect(moves).toHaveLength(1);
+    expect(moves[0].type).toBe('arc');
+    expect(moves[0].ccw).toBe(true);
+    expect(moves[0].sweep).toBeCloseTo(Math.PI / 2, 9);
+  });
+
+  it('falls back to lines without circles', () => {
+    const moves = fitArcMoves([{ x: 0, y: 0 }, { x: 1, y: 0 }, { x: 1, y: 1 }], true, null);
+    expect(moves.map(m => m.type)).toEqual(['line', 'line', 'line']);
+  });
+});
+
+describe('collectGCodeLayers', () => {
+  it('splits outline, hatch and highlight layers by ring band', () => {
+    const { engine, scaleFactor, params } = renderEngine({ add_fill_pattern: true });
+    const layers = collectGCodeLayers(engine.arcGroups, scaleFactor, params.bounding_box_width_mm, params.bounding_box_height_mm, {
+      addFillPattern: true, redOutline: true, fillPatternSpacing: params.fill_pattern_spacing, layerCount: 3,
+    });
+    const kinds = layers.map(l => l.kind);
+    expect(kinds.indexOf('HATCH')).toBeLessThan(kinds.indexOf('OUTLINE'));
+    expect(kinds.lastIndexOf('OUTLINE')).toBeLessThan(kinds.indexOf('HIGHLIGHT'));
+    expect(layers.map(l => l.name)).toContain('OUTLINE_3');
+  });
+});
+
+describe('generateGCode', () => {
+  it('emits arcs for outlines and honours per-layer settings', () => {
+    const { engine, scaleFactor, params } = renderEngine();
+    const { gcode, estimate } = generateGCode(engine.arcGroups, scaleFactor, params.bounding_box_width_mm, params.bounding_box_height_mm, {}, {
+      layers: { OUTLINE: { power: 50, speed: 600 } },
+      maxPower: 1000,
+    });
+    expect(gcode.startsWith('; Doyle spiral laser job')).toBe(true);
+    expect(gcode).toMatch(/\nG[23] X[\d.-]+ Y[\d.-]+ I[\d.-]+ J[\d.-]+/);
+    expect(gcode).toContain('S500 F600');
+    expect(gcode.trim().endsWith('M2')).toBe(true);
+    expect(estimate.seconds).toBeGreaterThan(0);
+    expect(estimate.cutLengthMm).toBeGreaterThan(0);
+  });
+
+  it('streams the same program in chunks and scales time with passes', () => {
+    const { engine, scaleFactor, params } = renderEngine();
+    const layers = collectGCodeLayers(engine.arcGroups, scaleFactor, params.bounding_box_width_mm, params.bounding_box_height_mm);
+    const plan = planGCode(layers);
+    const chunks = Array.from(streamGCode(plan));
+    expect(chunks.length).toBeGreaterThan(plan[0].paths.length);
+    const single = estimateJobTime(plan, { layers: { OUTLINE: { passes: 1 } } });
+    const double = estimateJobTime(plan, { layers: { OUTLINE: { passes: 2 } } });
+    expect(double.cutLengthMm).toBeCloseTo(single.cutLengthMm * 2, 6);
+  });
+
+  it('builds the download in the export worker from the parameters alone', async () => {
+    // export_worker.js registers its handler on `self` when imported.
+    const posted = [];
+    let handler = null;
+    globalThis.self = { addEventListener: (type, fn) => { handler = fn; }, postMessage: message => posted.push(message) };
+    await import('../js/export_worker.js');
+    const { engine, scaleFactor, params: base } = renderEngine({ add_fill_pattern: true });
+    const params = { ...base, svg_layers: true, svg_layer_count: 3 };
+    const settings = { layers: { HATCH: { power: 30 } } };
+    handler({ data: { type: 'gcode', requestId: 4, params, settings, validate: true } });
+    delete globalThis.self;
+
+    const plan = planGCode(collectGCodeLayers(engine.arcGroups, scaleFactor, params.bounding_box_width_mm,
+      params.bounding_box_height_mm, gcodeLayerOptions(params)));
+    expect(posted.map(message => message.type)).toEqual(['validation', ...posted.slice(1, -1).map(() => 'chunk'), 'done']);
+    const text = posted.filter(message => message.type === 'chunk').map(message => new TextDecoder().decode(message.bytes)).join('');
+    expect(text).toBe(Array.from(streamGCode(plan, settings)).join(''));
+    expect(text).toContain('; Layer HATCH_3');
+    expect(posted.at(-1)).toEqual({ type: 'done', requestId: 4, estimate: estimateJobTime(plan, settings) });
+  });
+
+  it('resolves layer settings from name, then kind, then defaults', () => {
+    const layer = { name: 'OUTLINE_2', kind: 'OUTLINE' };
+    expect(resolveLayerSettings(layer, { OUTLINE: { speed: 10 }, OUTLINE_2: { power: 5 } })).toEqual({ power: 5, speed: 10, passes: 1 });
+  });
+});
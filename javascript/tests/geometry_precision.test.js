@@ -0,0 +1,67 @@
+import { describe, it, expect } from 'vitest';
+import { serialize } from 'node:v8';
+import { renderSpiral, normaliseParams, decodeOutline } from '../js/doyle_spiral_engine.js';
+
+const BASE = { p: 12, q: 12, t: 0, mode: 'arram_boyle', add_fill_pattern: true };
+
+function render(precision) {
+  return renderSpiral({ ...BASE, geometry_precision: precision }, 'arram_boyle');
+}
+
+function maxDeviation(reference, compact) {
+  let max = 0;
+  reference.arcgroups.forEach((group, idx) => {
+    const expected = group.outline;
+    const actual = decodeOutline(compact.arcgroups[idx]);
+    expect(actual.length).toBe(expected.length);
+    for (let i = 0; i < expected.length; i += 1) {
+      max = Math.max(max, Math.abs(actual[i][0] - expected[i][0]), Math.abs(actual[i][1] - expected[i][1]));
+    }
+  });
+  return max;
+}
+
+describe('geometry precision modes', () => {
+  it('defaults to float64 pair arrays', () => {
+    const { geometry } = renderSpiral(BASE, 'arram_boyle');
+    expect(Array.isArray(geometry.arcgroups[0].outline[0])).toBe(true);
+    expect(geometry.outline_precision).toBeUndefined();
+    expect(decodeOutline(geometry.arcgroups[0])).toBe(geometry.arcgroups[0].outline);
+    expect(normaliseParams({ geometry_precision: 'float16' }).geometry_precision).toBe('float64');
+  });
+
+  it('packs float32 outlines into one shared buffer with a bounded error', () => {
+    const reference = render('float64');
+    const { geometry, scaleFactor } = render('float32');
+    const buffers = new Set(geometry.arcgroups.map(group => group.outline.buffer));
+    expect(buffers.size).toBe(1);
+    expect(geometry.arcgroups[0].outline).toBeInstanceOf(Float32Array);
+    const deviation = maxDeviation(reference.geometry, geometry);
+    expect(deviation).toBeLessThanOrEqual(geometry.outline_max_error);
+    // Well under a micrometre on the 200 mm default workpiece.
+    expect(geometry.outline_max_error * scaleFactor).toBeLessThan(1e-3);
+  });
+
+  it('encodes fixed-point outlines as Int32 offsets within half a step', () => {
+    const reference = render('float64');
+    const { geometry } = render('fixed');
+    expect(geometry.arcgroups[0].outline).toBeInstanceOf(Int32Array);
+    for (const group of geometry.arcgroups) {
+      expect(group.outline_scale).toBeGreaterThan(0);
+    }
+    const deviation = maxDeviation(reference.geometry, geometry);
+    expect(deviation).toBeLessThanOrEqual(geometry.outline_max_error);
+    const largestStep = Math.max(...geometry.arcgroups.map(group => group.outline_scale));
+    expect(geometry.outline_max_error).toBeLessThanOrEqual(largestStep / 2 + 1e-9);
+  });
+
+  it('at least halves the structured-clone size of the geometry payload', () => {
+    const full = serialize(render('float64').geometry).length;
+    expect(serialize(render('float32').geometry).length).toBeLessThan(full / 2);
+    expect(serialize(render('fixed').geometry).length).toBeLessThan(full / 2);
+  });
+
+  it('leaves the SVG output untouched', () => {
+    expect(render('float32').svgString).toBe(render('float64').svgString);
+  });
+});
@@ -0,0 +1,385 @@
+import { describe, it, expect } from 'vitest';
+import { createHash } from 'node:crypto';
+import {
+  CircleElement,
+  DoyleSpiralEngine,
+  renderSpiral,
+  renderSpiralStream,
+  canRenderSpiralStream,
+  normaliseParams,
+  FILL_PATTERN_TYPES,
+  getGeometryStats,
+  resetGeometryStats,
+} from '../js/doyle_spiral_engine.js';
+
+function circle(re, im, r) {
+  return new CircleElement({ re, im }, r);
+}
+
+function groupsOf(engine) {
+  return Array.from(engine.arcGroups.values ? engine.arcGroups.values() : engine.arcGroups);
+}
+
+describe('CircleElement intersections', () => {
+  it('returns one contact point for tangent circles at any scale', () => {
+    for (const scale of [1e-4, 1, 1e4]) {
+      const a = circle(0, 0, 3 * scale);
+      const b = circle(5 * scale, 0, 2 * scale);
+      const pts = a._getIntersectionPoints(b);
+      expect(pts.length).toBe(1);
+      expect(pts[0].re / scale).toBeCloseTo(3, 9);
+      expect(pts[0].im / scale).toBeCloseTo(0, 6);
+    }
+  });
+
+  it('treats a rounding-level gap between large circles as tangency', () => {
+    const a = circle(0, 0, 1000);
+    const b = circle(1000 + 1 + 1e-10, 0, 1);
+    expect(a._getIntersectionPoints(b).length).toBe(1);
+    const overlapping = circle(1000 + 1 - 1e-10, 0, 1);
+    expect(a._getIntersectionPoints(overlapping).length).toBe(1);
+  });
+
+  it('keeps tiny circles apart that an absolute tolerance would have merged', () => {
+    const a = circle(0, 0, 1e-4);
+    const b = circle(2.5e-4, 0, 1e-4);
+    expect(a._getIntersectionPoints(b)).toEqual([]);
+    const crossing = circle(1.5e-4, 0, 1e-4);
+    expect(a._getIntersectionPoints(crossing).length).toBe(2);
+  });
+
+  it('handles internal tangency and ignores concentric circles', () => {
+    const outer = circle(0, 0, 5);
+    const inner = circle(2, 0, 3);
+    const fromOuter = outer._getIntersectionPoints(inner);
+    const fromInner = inner._getIntersectionPoints(outer);
+    expect(fromOuter.length).toBe(1);
+    expect(fromInner.length).toBe(1);
+    expect(fromOuter[0].re).toBeCloseTo(5, 12);
+    expect(fromInner[0].re).toBeCloseTo(5, 12);
+    expect(outer._getIntersectionPoints(circle(0, 0, 2))).toEqual([]);
+  });
+
+  it('deduplicates intersections relative to the circle radius', () => {
+    const small = circle(0, 0, 1e-3);
+    small.resetIntersections();
+    const other = circle(1, 1, 1);
+    small.addIntersection({ re: 1e-3, im: 0 }, other);
+    small.addIntersection({ re: 1e-3, im: 1e-7 }, other);
+    expect(small.intersections.length).toBe(2);
+    small.addIntersection({ re: 1e-3, im: 1e-7 + 1e-12 }, other);
+    expect(small.intersections.length).toBe(2);
+  });
+});
+
+// Figures of the original engine at p=q=16 with a fill pattern, one per arc
+// mode: the tolerance work must not change which arcs a circle draws. Farthest
+// and random groups have open outlines, chained by nearest endpoint; where
+// several ends meet, the original picked the chain order by rounding noise
+// and changed it between renders, so their area is not compared.
+const BASELINE_DESIGNS = {
+  closest: { vertices: 25884, elements: 26003, moment: 10628022980, area: 14904831 },
+  farthest: { vertices: 25948, elements: 26765, moment: 10493720460 },
+  alternating: { vertices: 22704, elements: 23280, moment: 9546203374, area: 12499447.67 },
+  random: { vertices: 25916, elements: 26585, moment: 10205941020 },
+  symmetric: { vertices: 25884, elements: 26003, moment: 10628022980, area: 14904831 },
+  all: { vertices: 32340, elements: 33217, moment: 13328799440, area: 4146603.142 },
+};
+
+describe('arc selection', () => {
+  for (const [arcMode, expected] of Object.entries(BASELINE_DESIGNS)) {
+    it(`draws the original design in ${arcMode} mode`, () => {
+      const res = renderSpiral({ p: 16, q: 16, mode: 'arram_boyle', arc_mode: arcMode, add_fill_pattern: true }, 'arram_boyle');
+      let vertices = 0;
+      let moment = 0;
+      let area = 0;
+      for (const { outline } of res.geometry.arcgroups) {
+        vertices += outline.length;
+        let twice = 0;
+        for (let i = 0; i < outline.length; i += 1) {
+          const [x1, y1] = outline[i];
+          const [x2, y2] = outline[(i + 1) % outline.length];
+          twice += x1 * y2 - x2 * y1;
+          moment += x1 * x1 + y1 * y1;
+        }
+        area += Math.abs(twice) / 2;
+      }
+      expect(res.geometry.arcgroups).toHaveLength(348);
+      expect(vertices).toBe(expected.vertices);
+      expect((res.svgString.match(/<(path|line)\b/g) || []).length).toBe(expected.elements);
+      expect(Math.abs(moment / expected.moment - 1)).toBeLessThan(1e-8);
+      if (expected.area) {
+        expect(Math.abs(area / expected.area - 1)).toBeLessThan(1e-8);
+      }
+    });
+  }
+});
+
+describe('geometry fallback counters', () => {
+  it('are reset per render and reported on the result', () => {
+    const res = renderSpiral({ p: 8, q: 8, t: 0, mode: 'arram_boyle' }, 'arram_boyle');
+    expect(res.geometryStats.tangencySnaps).toBeGreaterThan(0);
+    expect(res.geometryStats.duplicateIntersections).toBe(0);
+    expect(getGeometryStats()).toEqual(res.geometryStats);
+    resetGeometryStats();
+    expect(Object.values(getGeometryStats()).every(value => value === 0)).toBe(true);
+  });
+
+  it('count outline fallbacks once per emitted group', () => {
+    const closest = renderSpiral({ p: 10, q: 10, mode: 'arram_boyle' }, 'arram_boyle');
+    expect(closest.geometryStats.openOutlines).toBe(0);
+    expect(closest.geometryStats.proximityAttachments).toBe(0);
+
+    // Farthest-arc groups never close, so every emitted group is counted once.
+    const farthest = renderSpiral({ p: 10, q: 10, mode: 'arram_boyle', arc_mode: 'farthest' }, 'arram_boyle');
+    const groups = farthest.geometry.arcgroups;
+    expect(farthest.geometryStats.openOutlines).toBe(groups.length);
+    expect(farthest.geometryStats.proximityAttachments).toBeLessThanOrEqual(groups.length * 5);
+  });
+
+  it('keeps every rim circle at six contacts with a large max_d', () => {
+    const res = renderSpiral({ p: 7, q: 32, t: 0, max_d: 50000, mode: 'arram_boyle' }, 'arram_boyle');
+    const counts = res.engine.circles.map(c => c.intersections.length);
+    expect(Math.max(...counts)).toBe(6);
+    expect(groupsOf(res.engine).length).toBe(res.engine.circles.length);
+  });
+});
+
+describe('hatch angle quantisation', () => {
+  const params = { p: 16, q: 16, t: 0, add_fill_pattern: true, fill_pattern_animation: 'radial_bloom' };
+
+  it('is off by default and leaves the drawing unchanged', () => {
+    const exact = renderSpiral(params);
+    const explicit = renderSpiral({ ...params, fill_pattern_angle_step: 0 });
+    expect(explicit.svgString).toBe(exact.svgString);
+    expect(exact.geometryStats.hatchAngleError).toBe(0);
+    expect(exact.geometryStats.hatchRimDeviationMm).toBe(0);
+  });
+
+  it('serves nearby angles from the template cache across frames', () => {
+    const frame = { ...params, p: 11, q: 19, fill_pattern_animation: 'ring_cycle' };
+    renderSpiral(frame);
+    const exact = renderSpiral({ ...frame, fill_pattern_angle: 0.001 }).geometryStats;
+    expect(exact.hatchReused).toBe(0);
+    renderSpiral({ ...frame, fill_pattern_angle_step: 1 });
+    const snapped = renderSpiral({ ...frame, fill_pattern_angle: 0.001, fill_pattern_angle_step: 1 }).geometryStats;
+    expect(snapped.hatchComputed).toBe(0);
+    expect(snapped.hatchReused).toBe(exact.hatchComputed);
+  });
+
+  it('keeps the angle error within half a step and reports the rim deviation in mm', () => {
+    const snapped = renderSpiral({ ...params, fill_pattern_angle_step: 1 });
+    const stats = snapped.geometryStats;
+    expect(stats.hatchAngleError).toBeGreaterThan(0);
+    expect(stats.hatchAngleError).toBeLessThanOrEqual(0.5 + 1e-9);
+    expect(stats.hatchRimDeviationMm).toBeGreaterThan(0);
+    expect(stats.hatchRimDeviationMm).toBeCloseTo(stats.hatchRimDeviation * snapped.scaleFactor, 12);
+  });
+});
+
+describe('lazy arc points', () => {
+  it('leaves arcs of template groups unsampled until a consumer reads them', () => {
+    const res = renderSpiral({ p: 12, q: 12, t: 0, add_fill_pattern: true });
+    const arcs = groupsOf(res.engine).flatMap(group => group.arcs);
+    expect(res.geometryStats.arcsMaterialized).toBeLessThan(arcs.length / 2);
+    const group = groupsOf(res.engine).find(g => g.template && g.templateTransform && g.arcs.length);
+    const before = getGeometryStats().arcsMaterialized;
+    const points = group.arcs[0].getPoints();
+    expect(getGeometryStats().arcsMaterialized).toBe(before + 1);
+    expect(group.arcs[0].getPoints()).toBe(points);
+    const outline = group.getClosedOutline();
+    const closest = Math.min(...outline.map(p => Math.hypot(p.re - points[0].re, p.im - points[0].im)));
+    expect(closest).toBeLessThan(1e-9 * group.baseCircle.radius + 1e-9);
+  });
+});
+
+describe('streamed hatch output', () => {
+  it('maps template segments on emit and builds world arrays only on request', () => {
+    const res = renderSpiral({ p: 10, q: 10, t: 0, add_fill_pattern: true });
+    const groups = groupsOf(res.engine).filter(g => g.template && g.templateTransform);
+    const clone = groups.find(g => g.cloneOf);
+    expect(clone).toBeDefined();
+    for (const group of [groups[0], clone]) {
+      const spacing = 8 / res.scaleFactor;
+      const streamed = [];
+      const count = group.forEachPatternSegment(spacing, 30, 0, (x1, y1, x2, y2) => streamed.push([x1, y1, x2, y2]));
+      const segments = group.getPatternSegments(spacing, 30, 0);
+      expect(count).toBeGreaterThan(0);
+      expect(segments).toHaveLength(count);
+      expect(group.getPatternSegments(spacing, 30, 0)).not.toBe(segments);
+      segments.forEach(([p1, p2], idx) => {
+        expect([p1.re, p1.im, p2.re, p2.im]).toEqual(streamed[idx]);
+        const angle = (Math.atan2(p2.im - p1.im, p2.re - p1.re) * 180 / Math.PI + 360) % 180;
+        expect(Math.min(Math.abs(angle - 30), 180 - Math.abs(angle - 30))).toBeLessThan(1e-6);
+      });
+    }
+    expect(groups.some(g => '_patternSegmentsCache' in g)).toBe(false);
+  });
+});
+
+describe('pattern preview fills', () => {
+  it('fills outlines from shared <pattern> defs instead of emitting hatch lines', () => {
+    const params = { p: 10, q: 10, t: 0, add_fill_pattern: true, fill_pattern_angle: 15 };
+    const explicit = renderSpiral(params).svgString;
+    const preview = renderSpiral({ ...params, svg_pattern_preview: true }).svgString;
+    const count = (svg, re) => (svg.match(re) || []).length;
+    expect(count(preview, /<line /g)).toBe(count(preview, /<pattern /g));
+    expect(count(preview, /<pattern /g)).toBeGreaterThan(0);
+    expect(count(preview, /<(line|path) /g) * 10).toBeLessThan(count(explicit, /<(line|path) /g));
+    const ids = Array.from(preview.matchAll(/<pattern id="([^"]+)"/g), m => m[1]);
+    expect(new Set(ids).size).toBe(ids.length);
+    for (const [, ref] of preview.matchAll(/fill="url\(#([^)]+)\)"/g)) {
+      expect(ids).toContain(ref);
+    }
+    // Exports do not pass the flag and keep their explicit segments.
+    expect(renderSpiral(params).svgString).toBe(explicit);
+  });
+});
+
+describe('fill kernels', () => {
+  const params = { p: 10, q: 10, t: 0, add_fill_pattern: true, fill_pattern_spacing: 2 };
+  const count = (svg, re) => (svg.match(re) || []).length;
+
+  it('draws the batched kernels as one path per hatched group', () => {
+    for (const type of ['crosshatch', 'concentric', 'spiral', 'stipple']) {
+      const res = renderSpiral({ ...params, fill_pattern_type: type });
+      const paths = count(res.svgString, /<path [^>]*stroke-linejoin="round"/g);
+      const groups = groupsOf(res.engine).filter(g => !g.name.startsWith('outer_'));
+      expect(paths).toBeGreaterThan(0);
+      expect(paths).toBeLessThanOrEqual(groups.length);
+      expect(groups.every(g => g.fillKernel === type)).toBe(true);
+    }
+    expect(normaliseParams({ fill_pattern_type: 'Spiral' }).fill_pattern_type).toBe('spiral');
+    expect(normaliseParams({ fill_pattern_type: 'zigzag' }).fill_pattern_type).toBe('lines');
+    expect(FILL_PATTERN_TYPES).toContain('lines');
+  });
+
+  it('builds each kernel once per template and reuses it for every group', () => {
+    const frame = { ...params, fill_pattern_type: 'concentric' };
+    const first = renderSpiral(frame).geometryStats;
+    expect(first.hatchReused).toBeGreaterThan(first.hatchComputed);
+    // Rings look the same at any angle, so another angle is served from cache.
+    const turned = renderSpiral({ ...frame, fill_pattern_angle: 17 });
+    expect(turned.geometryStats.hatchComputed).toBe(0);
+    const again = renderSpiral(frame);
+    expect(turned.svgString).toBe(again.svgString);
+  });
+
+  it('streams kernel polylines as chained segments inside the group', () => {
+    const res = renderSpiral({ ...params, fill_pattern_type: 'spiral' });
+    const group = groupsOf(res.engine).find(g => g.template && g.templateTransform && g.cloneOf);
+    const { center, radius } = group.baseCircle;
+    const spacing = radius / 4;
+    const segments = [];
+    group.forEachPatternSegment(spacing, 30, 0, (x1, y1, x2, y2) => segments.push([x1, y1, x2, y2]));
+    expect(segments.length).toBeGreaterThan(10);
+    const chained = segments.filter((seg, idx) => idx > 0
+      && seg[0] === segments[idx - 1][2] && seg[1] === segments[idx - 1][3]).length;
+    expect(chained).toBeGreaterThan(segments.length / 2);
+    const outline = group.getClosedOutline();
+    const reach = Math.max(...outline.map(p => Math.hypot(p.re - center.re, p.im - center.im)));
+    for (const [x1, y1] of segments) {
+      expect(Math.hypot(x1 - center.re, y1 - center.im)).toBeLessThan(reach);
+    }
+  });
+});
+
+describe('ring streaming', () => {
+  function streamed(params) {
+    const chunks = [];
+    const info = renderSpiralStream(params, text => chunks.push(text));
+    return { svg: chunks.join(''), chunks, info };
+  }
+
+  it('writes the same SVG as the in-memory render, a few rings at a time', () => {
+    const cases = [
+      { p: 16, q: 16, t: 0 },
+      { p: 16, q: 16, t: 0, add_fill_pattern: true, fill_pattern_spacing: 3, fill_pattern_angle: 12 },
+      { p: 7, q: 32, t: 0.3, add_fill_pattern: true, fill_pattern_type: 'rectangles', fill_pattern_animation: 'ring_cycle' },
+      { p: 9, q: 13, t: 0, red_outline: true, red_outline_min_ring: 150 },
+      { p: 12, q: 12, t: 0, add_fill_pattern: true, svg_layers: true, svg_layer_count: 5, red_outline: true },
+    ];
+    for (const params of cases) {
+      const { svg, chunks, info } = streamed(params);
+      expect(svg).toBe(renderSpiral(params).svgString);
+      expect(chunks.length).toBeGreaterThan(info.rings / 2);
+      expect(info.peakLiveCircles).toBeLessThan(info.circles);
+    }
+  });
+
+  it('matches the in-memory render in every arc mode and with debug groups', () => {
+    const base = { p: 12, q: 12, t: 0, add_fill_pattern: true };
+    const cases = ['farthest', 'alternating', 'symmetric', 'all', 'random']
+      .map(arc_mode => ({ ...base, arc_mode }))
+      .concat([{ p: 12, q: 12, t: 0, debug_groups: true }, { p: 10, q: 14, t: 0, arc_mode: 'random', debug_groups: true }]);
+    for (const params of cases) {
+      expect(streamed(params).svg).toBe(renderSpiral(params).svgString);
+    }
+  });
+
+  it('keeps the elements of the original symmetric design and only reorders them', () => {
+    // SHA-256 of the sorted elements of the pre-streaming engine's p=q=16 output.
+    const original = {
+      outline: '26727ac2b1de6267e395a072ce5da140ec5287a6691b39b0f6de2fb129d57e47',
+      fill: '99c0db6712daa60231a279c0e7ef0f54fdfb31b82ea668b11446dd26c756a083',
+    };
+    for (const [name, add_fill_pattern] of [['outline', false], ['fill', true]]) {
+      const { svgString } = renderSpiral({ p: 16, q: 16, t: 0, arc_mode: 'symmetric', add_fill_pattern }, 'arram_boyle');
+      const elements = svgString.match(/<(path|line|circle|polygon|polyline)\b[^>]*>/g).sort();
+      expect(createHash('sha256').update(elements.join('\n')).digest('hex')).toBe(original[name]);
+    }
+  });
+
+  it('emits groups ring by ring, innermost first, in processing order within a ring', () => {
+    for (const [p, q] of [[9, 13], [12, 12]]) {
+      const engine = new DoyleSpiralEngine(p, q, 0);
+      const { svgString } = engine.render('arram_boyle', { debugGroups: true });
+      const fills = Array.from(svgString.matchAll(/fill="(#[0-9a-f]{6})"/gi), m => m[1]);
+      // p == q groups a ring by angle, otherwise circles keep their generation order.
+      const position = p === q
+        ? circle => Math.atan2(circle.center.im, circle.center.re)
+        : (order => circle => order.get(circle))(new Map(engine.circles.map((c, i) => [c, i])));
+      const expected = groupsOf(engine)
+        .filter(group => group.ringIndex >= 0)
+        .sort((a, b) => a.ringIndex - b.ringIndex || position(a.baseCircle) - position(b.baseCircle));
+      expect(new Set(fills).size).toBe(fills.length);
+      expect(fills).toEqual(expected.map(group => group.debugFill));
+      const distances = expected.map(group => Math.hypot(group.baseCircle.center.re, group.baseCircle.center.im));
+      for (let i = 1; i < expected.length; i += 1) {
+        if (expected[i].ringIndex !== expected[i - 1].ringIndex) {
+          expect(distances[i]).toBeGreaterThan(distances[i - 1]);
+        }
+      }
+    }
+  });
+
+  it('renders the same SVG regardless of what was rendered before', () => {
+    const params = { p: 12, q: 12, t: 0, add_fill_pattern: true, arc_mode: 'random' };
+    const first = renderSpiral(params).svgString;
+    renderSpiral({ p: 9, q: 13, t: 0, add_fill_pattern: true, arc_mode: 'farthest' });
+    expect(renderSpiral(params).svgString).toBe(first);
+  });
+
+  it('keeps the window size flat as the spiral grows', () => {
+    const small = streamed({ p: 16, q: 16, t: 0 }).info;
+    const large = streamed({ p: 32, q: 32, t: 0 }).info;
+    expect(large.circles).toBeGreaterThan(3 * small.circles);
+    expect(large.peakLiveCircles).toBeLessThan(large.circles / 4);
+  });
+
+  it('accepts p and q beyond the in-memory limit only when streaming', () => {
+    expect(() => renderSpiral({ p: 300, q: 300 })).toThrow(/between 2 and 256/);
+    const engine = new DoyleSpiralEngine(300, 300, 0, { streaming: true });
+    expect(() => engine.render('arram_boyle')).toThrow(/renderStream/);
+    expect(() => new DoyleSpiralEngine(1025, 1025, 0, { streaming: true })).toThrow(/between 2 and 1024/);
+  });
+
+  it('rejects fill animations that need the whole spiral', () => {
+    expect(canRenderSpiralStream({ p: 8, q: 8, add_fill_pattern: true, fill_pattern_animation: 'ca_wavefront' })).toBe(false);
+    expect(canRenderSpiralStream({ p: 8, q: 8, fill_pattern_animation: 'ca_wavefront' })).toBe(true);
+    expect(() => streamed({ p: 8, q: 8, add_fill_pattern: true, fill_pattern_animation: 'ca_wavefront' }))
+      .toThrow(/cannot be ring-streamed/);
+    expect(streamed({ p: 8, q: 8, fill_pattern_animation: 'ca_wavefront' }).svg)
+      .toBe(renderSpiral({ p: 8, q: 8, fill_pattern_animation: 'ca_wavefront' }).svgString);
+  });
+});
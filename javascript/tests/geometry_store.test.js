@@ -0,0 +1,106 @@
+import { describe, it, expect } from 'vitest';
+import { Worker } from 'node:worker_threads';
+import {
+  GeometryStore,
+  geometryForWorker,
+  publishGeometry,
+  readGeometry,
+  storeGeometry,
+} from '../js/geometry_store.js';
+import { renderSpiral, decodeOutline } from '../js/doyle_spiral_engine.js';
+import { createAnimatorState, handleAnimatorMessage } from '../js/animator.js';
+
+const PARAMS = { p: 8, q: 8, t: 0, mode: 'arram_boyle' };
+
+function geometryOf(precision) {
+  return renderSpiral({ ...PARAMS, geometry_precision: precision }, 'arram_boyle').geometry;
+}
+
+describe('geometry store', () => {
+  it('reads back every outline as views of one buffer, for each precision', () => {
+    for (const precision of ['float64', 'float32', 'fixed']) {
+      const geometry = geometryOf(precision);
+      const store = publishGeometry(storeGeometry(geometry, { generation: 3, shared: true }));
+      expect(store.buffer).toBeInstanceOf(SharedArrayBuffer);
+      const read = readGeometry(store);
+      expect(read.arcgroups).toHaveLength(geometry.arcgroups.length);
+      read.arcgroups.forEach((group, index) => {
+        expect(group.outline.buffer).toBe(store.buffer);
+        expect(decodeOutline(group)).toEqual(decodeOutline(geometry.arcgroups[index]));
+        expect(group.id).toBe(geometry.arcgroups[index].id);
+      });
+      expect(read.fill_pattern_spacing).toBe(geometry.fill_pattern_spacing);
+    }
+  });
+
+  it('refuses unpublished stores and freezes published ones', () => {
+    const store = storeGeometry(geometryOf('float32'), { generation: 1, shared: false });
+    expect(store.buffer).toBeInstanceOf(ArrayBuffer);
+    expect(() => readGeometry(store)).toThrow(/not published/);
+    publishGeometry(store);
+    expect(Object.isFrozen(store.meta)).toBe(true);
+    expect(readGeometry(store).arcgroups.length).toBeGreaterThan(0);
+  });
+
+  it('shares stores with workers, or hands them a transferable copy', async () => {
+    const page = new GeometryStore({ shared: true });
+    const store = publishGeometry(storeGeometry(geometryOf('float32'), { generation: 7, shared: true }));
+    const geometry = page.adopt(store);
+    expect(GeometryStore.isCurrent(store, page.control)).toBe(true);
+    expect(geometryForWorker(store)).toEqual({ store, transfer: [] });
+
+    // The worker sees the page's geometry and the generation published after it.
+    const worker = new Worker(`
+      const { parentPort, workerData } = require('node:worker_threads');
+      const control = new Int32Array(workerData.control);
+      const coords = new Float32Array(workerData.buffer, 8);
+      parentPort.once('message', () => parentPort.postMessage({ generation: Atomics.load(control, 0), first: coords[0] }));
+    `, { eval: true, workerData: { control: page.control.buffer, buffer: store.buffer } });
+    const next = publishGeometry(storeGeometry(geometryOf('float32'), { generation: 8, shared: true }));
+    page.adopt(next);
+    expect(GeometryStore.isCurrent(store, page.control)).toBe(false);
+    const reply = await new Promise(resolve => {
+      worker.once('message', resolve);
+      worker.postMessage('read');
+    });
+    await worker.terminate();
+    expect(reply).toEqual({ generation: 8, first: geometry.arcgroups[0].outline[0] });
+
+    const plain = publishGeometry(storeGeometry(geometryOf('float32'), { generation: 9, shared: false }));
+    const { store: copy, transfer } = geometryForWorker(plain);
+    expect(transfer).toEqual([copy.buffer]);
+    expect(copy.buffer).not.toBe(plain.buffer);
+    expect(decodeOutline(readGeometry(copy).arcgroups[0])).toEqual(decodeOutline(readGeometry(plain).arcgroups[0]));
+  });
+
+  it('refuses a posted store once the page has moved on', () => {
+    const page = new GeometryStore({ shared: true });
+    const store = publishGeometry(storeGeometry(geometryOf('float32'), { generation: 4, shared: true }));
+    page.adopt(store);
+    const { store: posted } = geometryForWorker(store, page.control);
+    expect(posted.control).toBe(page.control);
+    expect(readGeometry(posted).arcgroups.length).toBeGreaterThan(0);
+
+    page.adopt(publishGeometry(storeGeometry(geometryOf('float32'), { generation: 5, shared: true })));
+    expect(() => readGeometry(posted)).toThrow(/superseded/);
+    expect(readGeometry(store).arcgroups.length).toBeGreaterThan(0);
+
+    const next = geometryForWorker(page.current, page.control).store;
+    page.clear();
+    expect(() => readGeometry(next)).toThrow(/superseded/);
+  });
+
+  it('lets the animator load a posted store only while it is current', () => {
+    const state = createAnimatorState();
+    const page = new GeometryStore({ shared: true });
+    const store = publishGeometry(storeGeometry(geometryOf('float32'), { generation: 2, shared: true }));
+    page.adopt(store);
+    const { store: posted } = geometryForWorker(store, page.control);
+    expect(handleAnimatorMessage(state, { type: 'load', requestId: 1, geometryStore: posted, params: PARAMS }).message.type)
+      .toBe('layout');
+    page.clear();
+    const stale = handleAnimatorMessage(state, { type: 'load', requestId: 2, geometryStore: posted, params: PARAMS }).message;
+    expect(stale.type).toBe('error');
+    expect(stale.message).toMatch(/superseded/);
+  });
+});
@@ -0,0 +1,106 @@
+import { describe, it, expect } from 'vitest';
+import {
+  HATCH_TEXELS_PER_INSTANCE,
+  HATCH_TEXTURE_WIDTH,
+  HatchLinesClient,
+  buildHatchLines,
+  hatchLineTransferables,
+  renderHatchLines,
+} from '../js/hatch_lines.js';
+import { normaliseParams, renderSpiral } from '../js/doyle_spiral_engine.js';
+
+const PARAMS = normaliseParams({ p: 8, q: 8, t: 0, add_fill_pattern: true, fill_pattern_spacing: 2 });
+
+function render(params = PARAMS) {
+  const result = renderSpiral(params, 'arram_boyle');
+  const options = { spacing: params.fill_pattern_spacing / result.scaleFactor, offset: 0 };
+  return { engine: result.engine, options, lines: buildHatchLines(result.engine, options) };
+}
+
+// Places every packed vertex the way the viewer's vertex shader does.
+function worldSegments(template) {
+  const { positions, instances } = template;
+  const segments = [];
+  for (let at = 0; at < positions.length; at += 6) {
+    const base = positions[at + 2] * HATCH_TEXELS_PER_INSTANCE * 4;
+    const [a, b, cx, cy] = instances.subarray(base, base + 4);
+    const place = (x, y) => [a * x - b * y + cx, b * x + a * y + cy];
+    segments.push([...place(positions[at], positions[at + 1]), ...place(positions[at + 3], positions[at + 4])]);
+  }
+  return segments;
+}
+
+describe('buildHatchLines', () => {
+  it('places the template hatch on the same world lines as the engine', () => {
+    const { engine, options, lines } = render();
+    const expected = [];
+    for (const [name, group] of engine.arcGroups.entries()) {
+      if (name.startsWith('outer_')) continue;
+      for (const angle of group.patternAngles.slice(0, 3)) {
+        group.forEachPatternSegment(options.spacing, angle, options.offset, (...segment) => expected.push(segment));
+      }
+    }
+    const actual = lines.templates.flatMap(worldSegments);
+    expect(actual.length).toBe(expected.length);
+    expect(lines.vertexCount).toBe(2 * expected.length);
+
+    const key = segment => segment.map(value => Math.round(value)).join(',');
+    const remaining = new Map();
+    for (const segment of expected) {
+      remaining.set(key(segment), (remaining.get(key(segment)) || 0) + 1);
+    }
+    let matched = 0;
+    for (const segment of actual) {
+      const count = remaining.get(key(segment)) || 0;
+      if (count > 0) {
+        remaining.set(key(segment), count - 1);
+        matched += 1;
+      }
+    }
+    // Float32 vertices may round a coordinate across an integer boundary.
+    expect(matched).toBeGreaterThan(actual.length * 0.99);
+  });
+
+  it('packs one texture-ready instance per group and pattern angle', () => {
+    const { engine, lines } = render();
+    const templateKeys = new Set([...engine.arcGroups.values()].map(group => group.templateKey).filter(Boolean));
+    expect(lines.templates.length).toBeLessThanOrEqual(templateKeys.size);
+    expect(lines.templates.length).toBeGreaterThan(0);
+    for (const template of lines.templates) {
+      expect(template.instances.length % (HATCH_TEXTURE_WIDTH * 4)).toBe(0);
+      expect(template.instances.length / 4).toBeGreaterThanOrEqual(template.instanceCount * HATCH_TEXELS_PER_INSTANCE);
+      const [minX, minY, maxX, maxY] = template.bounds;
+      for (const [x1, y1, x2, y2] of worldSegments(template)) {
+        for (const [x, y] of [[x1, y1], [x2, y2]]) {
+          expect(x).toBeGreaterThan(minX - 1e-3);
+          expect(x).toBeLessThan(maxX + 1e-3);
+          expect(y).toBeGreaterThan(minY - 1e-3);
+          expect(y).toBeLessThan(maxY + 1e-3);
+        }
+      }
+      for (let instance = 0; instance < template.instanceCount; instance += 1) {
+        const angle = template.instances[instance * HATCH_TEXELS_PER_INSTANCE * 4 + 4];
+        expect(angle).toBeGreaterThanOrEqual(0);
+        expect(angle).toBeLessThan(180);
+      }
+    }
+    const buffers = hatchLineTransferables(lines);
+    expect(buffers).toHaveLength(2 * lines.templates.length);
+  });
+
+  it('builds nothing without a fill pattern', () => {
+    expect(renderHatchLines({ ...PARAMS, add_fill_pattern: false })).toBeNull();
+    expect(hatchLineTransferables(null)).toEqual([]);
+  });
+});
+
+describe('HatchLinesClient', () => {
+  it('builds on the main thread without a worker and drops superseded requests', async () => {
+    const client = new HatchLinesClient();
+    const first = client.request({ ...PARAMS, p: 9 });
+    const second = client.request(PARAMS);
+    expect(await first).toBeNull();
+    const lines = await second;
+    expect(lines.vertexCount).toBe(render().lines.vertexCount);
+  });
+});
@@ -0,0 +1,123 @@
+import { describe, it, expect } from 'vitest';
+import { hatchPathsToQuads, rasterizeBands, encodePNG1Bit, encodeBMP1Bit, rasterSize } from '../js/raster_export.js';
+
+function concat(parts) {
+  const total = parts.reduce((sum, p) => sum + p.length, 0);
+  const out = new Uint8Array(total);
+  let offset = 0;
+  for (const p of parts) {
+    out.set(p, offset);
+    offset += p.length;
+  }
+  return out;
+}
+
+function collectRows(bands) {
+  const rows = [];
+  for (const { rows: data, rowCount, stride } of bands) {
+    for (let r = 0; r < rowCount; r++) rows.push(data.slice(r * stride, (r + 1) * stride));
+  }
+  return rows;
+}
+
+function isSet(row, x) {
+  return ((row[x >> 3] >> (7 - (x & 7))) & 1) === 0;
+}
+
+describe('rasterizeBands', () => {
+  it('fills exactly the pixels whose centres lie inside a quad', () => {
+    const quad = Float64Array.of(2, 1, 12, 1, 12, 3, 2, 3);
+    const rows = collectRows(rasterizeBands([quad], 16, 5, { bandRows: 2 }));
+    expect(rows).toHaveLength(5);
+    expect(isSet(rows[0], 5)).toBe(false);
+    for (const r of [1, 2]) {
+      for (let x = 0; x < 16; x++) {
+        expect(isSet(rows[r], x)).toBe(x >= 2 && x <= 11);
+      }
+    }
+    expect(isSet(rows[3], 5)).toBe(false);
+  });
+
+  it('produces identical pixels regardless of band height', () => {
+    const quads = hatchPathsToQuads([
+      { points: [{ x: 1, y: 1 }, { x: 9, y: 7 }], closed: false },
+      { points: [{ x: 0, y: 9 }, { x: 10, y: 2 }], closed: false },
+    ], { dpi: 25.4 * 4, heightMm: 10, strokeWidthMm: 0.5 });
+    const small = collectRows(rasterizeBands(quads, 40, 40, { bandRows: 3 }));
+    const large = collectRows(rasterizeBands(quads, 40, 40, { bandRows: 64 }));
+    expect(small).toEqual(large);
+    expect(small.some(row => row.some(byte => byte !== 0xff))).toBe(true);
+  });
+});
+
+describe('hatchPathsToQuads', () => {
+  it('flips Y so machine-space top maps to image row 0', () => {
+    const [quad] = hatchPathsToQuads([{ points: [{ x: 0, y: 10 }, { x: 10, y: 10 }], closed: false }], {
+      dpi: 25.4, heightMm: 10, strokeWidthMm: 2,
+    });
+    expect(Math.min(quad[1], quad[5])).toBeCloseTo(-1, 9);
+    expect(Math.max(quad[1], quad[5])).toBeCloseTo(1, 9);
+  });
+});
+
+describe('encoders', () => {
+  it('writes a 1-bit PNG whose IDAT inflates back to the raster rows', async () => {
+    const quad = Float64Array.of(0, 0, 20, 0, 20, 4, 0, 4);
+    const parts = await encodePNG1Bit(rasterizeBands([quad], 20, 8, { bandRows: 3 }), 20, 8, 300);
+    const png = concat(parts);
+    expect(Array.from(png.subarray(0, 8))).toEqual([0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a]);
+    const view = new DataView(png.buffer);
+    expect(view.getUint32(16)).toBe(20);
+    expect(view.getUint32(20)).toBe(8);
+    expect(png[24]).toBe(1);
+
+    const idat = [];
+    let offset = 8;
+    while (offset < png.length) {
+      const length = view.getUint32(offset);
+      const type = String.fromCharCode(...png.subarray(offset + 4, offset + 8));
+      if (type === 'IDAT') idat.push(png.subarray(offset + 8, offset + 8 + length));
+      offset += 12 + length;
+    }
+    const inflated = new Uint8Array(await new Response(new Blob(idat).stream().pipeThrough(new DecompressionStream('deflate'))).arrayBuffer());
+    expect(inflated.length).toBe(8 * (3 + 1));
+    expect(Array.from(inflated.subarray(0, 4))).toEqual([0, 0, 0, 0x0f]);
+    expect(Array.from(inflated.subarray(28, 32))).toEqual([0, 0xff, 0xff, 0xff]);
+  });
+
+  it('writes a top-down 1-bit BMP with 4-byte aligned rows', () => {
+    const parts = encodeBMP1Bit(rasterizeBands([], 33, 5), 33, 5, 600);
+    const bmp = concat(parts);
+    const view = new DataView(bmp.buffer);
+    expect(String.fromCharCode(bmp[0], bmp[1])).toBe('BM');
+    expect(view.getUint32(2, true)).toBe(bmp.length);
+    expect(view.getInt32(22, true)).toBe(-5);
+    expect(bmp.length).toBe(62 + 8 * 5);
+  });
+
+  it('hands each part to onPart as it is encoded instead of collecting the file', async () => {
+    const quad = Float64Array.of(0, 0, 20, 0, 20, 4, 0, 4);
+    const bands = () => rasterizeBands([quad], 20, 8, { bandRows: 3 });
+    for (const encode of [encodeBMP1Bit, encodePNG1Bit]) {
+      const streamed = [];
+      const bandsSeen = [];
+      const counted = (function* count() {
+        for (const band of bands()) {
+          bandsSeen.push(streamed.length);
+          yield band;
+        }
+      })();
+      const returned = await encode(counted, 20, 8, 300, part => streamed.push(part));
+      expect(returned).toEqual([]);
+      expect(concat(streamed)).toEqual(concat(await encode(bands(), 20, 8, 300)));
+      if (encode === encodeBMP1Bit) {
+        // Every band is out before the next one is rasterised.
+        expect(bandsSeen).toEqual([1, 2, 3]);
+      }
+    }
+  });
+
+  it('sizes the raster from millimetres and DPI', () => {
+    expect(rasterSize(25.4, 12.7, 1000)).toEqual({ width: 1000, height: 500 });
+  });
+});
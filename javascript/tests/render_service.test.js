@@ -0,0 +1,178 @@
+import { describe, it, expect, beforeAll, afterAll } from 'vitest';
+import { inflateRawSync } from 'node:zlib';
+import { parseParams, parseExportOptions, paramsKey, DEFAULT_PARAMS } from '../server/api_params.mjs';
+import { createRenderService, RenderCache } from '../server/render_service.mjs';
+import { buildExportFile, renderExportGeometry } from '../js/export_precompute.js';
+import { renderSpiral } from '../js/doyle_spiral_engine.js';
+
+describe('parseParams', () => {
+  it('fills defaults for missing, null and empty values', () => {
+    expect(parseParams({})).toEqual(DEFAULT_PARAMS);
+    expect(parseParams(null)).toEqual(DEFAULT_PARAMS);
+    expect(parseParams({ p: null, q: '', t: undefined })).toEqual(DEFAULT_PARAMS);
+  });
+
+  it('coerces numbers like Python int() and float()', () => {
+    const params = parseParams({ p: '12', q: 9.8, t: ' 0.25 ', size: '1_000', num_gaps: '3.5', fill_pattern_angle: '1e1' });
+    expect(params.p).toBe(12);
+    expect(params.q).toBe(9);
+    expect(params.t).toBe(0.25);
+    expect(params.size).toBe(1000);
+    expect(params.num_gaps).toBe(DEFAULT_PARAMS.num_gaps);
+    expect(params.fill_pattern_angle).toBe(10);
+  });
+
+  it('clamps ranges and rejects unknown modes', () => {
+    const params = parseParams({ p: 1, q: -4, size: 10, fill_pattern_spacing: 0, fill_pattern_offset: -2, mode: 'other', arc_mode: 'nope' });
+    expect(params).toMatchObject({ p: 2, q: 2, size: 200, fill_pattern_spacing: 0.1, fill_pattern_offset: 0, mode: 'arram_boyle', arc_mode: 'closest' });
+  });
+
+  it('parses booleans from JSON values and query strings', () => {
+    const fromJson = parseParams({ debug_groups: 1, add_fill_pattern: 'Yes', red_outline: 'off', draw_group_outline: false });
+    expect(fromJson).toMatchObject({ debug_groups: true, add_fill_pattern: true, red_outline: false, draw_group_outline: false });
+    const fromQuery = parseParams(new URLSearchParams('add_fill_pattern=on&draw_group_outline=0&p=7'));
+    expect(fromQuery).toMatchObject({ add_fill_pattern: true, draw_group_outline: false, p: 7 });
+  });
+
+  it('produces the same cache key for equivalent payloads', () => {
+    expect(paramsKey(parseParams({ p: '8', red_outline: 'true' }))).toBe(paramsKey(parseParams({ red_outline: true, p: 8 })));
+    expect(paramsKey(parseParams({ p: 8 }))).not.toBe(paramsKey(parseParams({ p: 9 })));
+  });
+});
+
+describe('parseExportOptions', () => {
+  it('defaults to a 250 mm DXF and rejects unknown formats', () => {
+    expect(parseExportOptions(new URLSearchParams(''))).toEqual({
+      format: 'dxf', bounding_box_width_mm: 250, bounding_box_height_mm: 250, step_thickness: 1, name: 'doyle-spiral',
+    });
+    expect(() => parseExportOptions({ format: 'obj' })).toThrow(/Unknown export format/);
+  });
+
+  it('follows the width for a missing height and keeps names file-safe', () => {
+    const options = parseExportOptions({ format: 'STEP', bounding_box_width_mm: '120', step_thickness: '0', name: "../disk's top" });
+    expect(options).toMatchObject({ format: 'step', bounding_box_width_mm: 120, bounding_box_height_mm: 120, step_thickness: 0.01 });
+    expect(options.name).toMatch(/^[A-Za-z0-9._-]+$/);
+  });
+});
+
+describe('RenderCache', () => {
+  it('evicts least recently used entries by count and size', () => {
+    const cache = new RenderCache(2, 100);
+    cache.set('a', { svg: 'x'.repeat(10), geometry: null });
+    cache.set('b', { svg: 'y'.repeat(10), geometry: null });
+    cache.get('a');
+    cache.set('c', { svg: 'z'.repeat(10), geometry: null });
+    expect(cache.get('b')).toBeUndefined();
+    expect(cache.get('a')).toBeDefined();
+    cache.set('d', { svg: 'w'.repeat(60), geometry: 'g'.repeat(30) });
+    expect(cache.bytes).toBeLessThanOrEqual(100);
+    expect(cache.get('d')).toBeDefined();
+  });
+});
+
+// Inflates the first entry of a ZIP archive.
+function firstZipEntry(zip) {
+  const end = zip.length - 22;
+  const central = zip.readUInt32LE(end + 16);
+  const local = zip.readUInt32LE(central + 42);
+  const dataStart = local + 30 + zip.readUInt16LE(local + 26) + zip.readUInt16LE(local + 28);
+  return inflateRawSync(zip.subarray(dataStart, dataStart + zip.readUInt32LE(central + 20))).toString();
+}
+
+describe('render service', () => {
+  let service;
+  let baseUrl;
+
+  beforeAll(async () => {
+    service = createRenderService({ workers: 1 });
+    await new Promise(resolve => service.server.listen(0, '127.0.0.1', resolve));
+    baseUrl = `http://127.0.0.1:${service.server.address().port}`;
+  });
+
+  afterAll(async () => {
+    await service.close();
+  });
+
+  it('coalesces identical requests and serves repeats from the cache', async () => {
+    const post = () => fetch(`${baseUrl}/api/spiral`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify({ p: 6, q: 6 }),
+    });
+    const [first, second] = await Promise.all([post(), post()]);
+    const sources = [first.headers.get('x-render-source'), second.headers.get('x-render-source')].sort();
+    expect(sources).toEqual(['coalesced', 'render']);
+    const body = await first.json();
+    expect(body.svg.startsWith('<svg')).toBe(true);
+    expect(body.params).toMatchObject({ p: 6, q: 6, mode: 'arram_boyle' });
+    expect(Array.isArray(body.geometry.arcgroups)).toBe(true);
+
+    const geometry = await fetch(`${baseUrl}/api/spiral/geometry?p=6&q=6&mode=doyle`);
+    expect(geometry.headers.get('x-render-source')).toBe('cache');
+    const geometryBody = await geometry.json();
+    expect(geometryBody.params.mode).toBe('arram_boyle');
+    expect(geometryBody.geometry).toEqual(body.geometry);
+    expect(service.renderer.stats).toMatchObject({ renders: 1, coalesced: 1, cacheHits: 1 });
+  });
+
+  it('omits geometry in doyle mode and treats invalid JSON as an empty payload', async () => {
+    const doyle = await (await fetch(`${baseUrl}/api/spiral`, { method: 'POST', body: '{"mode":"doyle","p":5,"q":5}' })).json();
+    expect(doyle.geometry).toBeUndefined();
+    expect(doyle.params.mode).toBe('doyle');
+    const fallback = await (await fetch(`${baseUrl}/api/spiral`, { method: 'POST', body: 'not json' })).json();
+    expect(fallback.params).toEqual(DEFAULT_PARAMS);
+  });
+
+  it('streams the same DXF, STEP and SVG files as the browser exporters', async () => {
+    const query = 'p=6&q=6&red_outline=true&bounding_box_width_mm=180&step_thickness=2&name=disk';
+    const params = { ...parseParams(new URLSearchParams(query)), bounding_box_width_mm: 180, bounding_box_height_mm: 180 };
+    const geometry = renderExportGeometry(params);
+    for (const format of ['dxf', 'step']) {
+      const response = await fetch(`${baseUrl}/api/spiral/export?${query}&format=${format}`);
+      expect(response.headers.get('transfer-encoding')).toBe('chunked');
+      expect(response.headers.get('content-disposition')).toBe(`attachment; filename="disk.${format}"`);
+      expect(await response.text()).toBe(buildExportFile(geometry, params, format, { stepThickness: 2, name: 'disk' }));
+    }
+    const svg = await fetch(`${baseUrl}/api/spiral/export?${query}&format=svg`);
+    expect(svg.headers.get('content-type')).toBe('image/svg+xml');
+    expect(await svg.text()).toBe(renderSpiral(params, 'arram_boyle').svgString);
+
+    // Animations that cannot be ring-streamed render in one piece.
+    const animated = 'p=6&q=6&add_fill_pattern=true&fill_pattern_animation=ca_wavefront';
+    const wholeSvg = await fetch(`${baseUrl}/api/spiral/export?${animated}&format=svg`);
+    expect(wholeSvg.status).toBe(200);
+    const animatedParams = { ...parseParams(new URLSearchParams(animated)), bounding_box_width_mm: 250, bounding_box_height_mm: 250 };
+    expect(await wholeSvg.text()).toBe(renderSpiral(animatedParams, 'arram_boyle').svgString);
+  });
+
+  it('bundles every format in a zip and reports empty or unknown exports as JSON', async () => {
+    const zip = Buffer.from(await (await fetch(`${baseUrl}/api/spiral/export?p=6&q=6&format=zip`)).arrayBuffer());
+    expect(zip.readUInt32LE(0)).toBe(0x04034b50);
+    const end = zip.length - 22;
+    expect(zip.readUInt32LE(end)).toBe(0x06054b50);
+    expect(zip.readUInt16LE(end + 10)).toBe(4);
+    const names = zip.toString('latin1', zip.readUInt32LE(end + 16), end);
+    for (const name of ['doyle-spiral.svg', 'doyle-spiral.dxf', 'doyle-spiral.step', 'doyle-spiral_params.json']) {
+      expect(names).toContain(name);
+    }
+    // The first entry is the ring-streamed SVG.
+    const box = { bounding_box_width_mm: 250, bounding_box_height_mm: 250 };
+    expect(firstZipEntry(zip)).toBe(renderSpiral({ ...parseParams({ p: 6, q: 6 }), ...box }, 'arram_boyle').svgString);
+    // It follows the requested mode, like the svg format.
+    const doyle = Buffer.from(await (await fetch(`${baseUrl}/api/spiral/export?p=6&q=6&mode=doyle&format=zip`)).arrayBuffer());
+    expect(firstZipEntry(doyle)).toBe(renderSpiral({ ...parseParams({ p: 6, q: 6, mode: 'doyle' }), ...box }, 'doyle').svgString);
+
+    const empty = await fetch(`${baseUrl}/api/spiral/export?p=6&q=6&format=step&draw_group_outline=false`);
+    expect(empty.status).toBe(422);
+    expect((await empty.json()).error).toMatch(/Nothing to export/);
+    expect((await fetch(`${baseUrl}/api/spiral/export?format=obj`)).status).toBe(400);
+  });
+
+  it('answers unknown routes and wrong methods with JSON errors', async () => {
+    const missing = await fetch(`${baseUrl}/api/other`);
+    expect(missing.status).toBe(404);
+    expect((await missing.json()).error).toBeTruthy();
+    const wrongMethod = await fetch(`${baseUrl}/api/spiral`);
+    expect(wrongMethod.status).toBe(405);
+  });
+});
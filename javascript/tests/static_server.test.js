@@ -0,0 +1,33 @@
+import { describe, it, expect, beforeAll, afterAll } from 'vitest';
+import http from 'node:http';
+import { createStaticHandler } from '../server/static_server.mjs';
+
+describe('static server', () => {
+  let server;
+  let baseUrl;
+
+  beforeAll(async () => {
+    server = http.createServer(createStaticHandler());
+    await new Promise(resolve => server.listen(0, '127.0.0.1', resolve));
+    baseUrl = `http://127.0.0.1:${server.address().port}`;
+  });
+
+  afterAll(async () => {
+    await new Promise(resolve => server.close(resolve));
+  });
+
+  it('serves the UI cross-origin isolated and nothing outside it', async () => {
+    const index = await fetch(`${baseUrl}/`);
+    expect(index.status).toBe(200);
+    expect(index.headers.get('content-type')).toContain('text/html');
+    expect(index.headers.get('cross-origin-opener-policy')).toBe('same-origin');
+    expect(index.headers.get('cross-origin-embedder-policy')).toBe('require-corp');
+    const script = await fetch(`${baseUrl}/js/geometry_store.js`);
+    expect(script.headers.get('content-type')).toContain('text/javascript');
+    expect(await script.text()).toContain('export function storeGeometry');
+
+    expect((await fetch(`${baseUrl}/js/missing.js`)).status).toBe(404);
+    expect((await fetch(`${baseUrl}/%2e%2e/app.py`)).status).toBe(404);
+    expect((await fetch(`${baseUrl}/node_modules/.package-lock.json`)).status).toBe(404);
+  });
+});
@@ -0,0 +1,40 @@
+import { describe, it, expect } from 'vitest';
+import { chooseDetailLevels, estimateExtrudeTriangles, simplifyOutline } from '../js/three_viewer.js';
+
+const circle = points => Array.from({ length: points }, (_, i) => [
+  Math.cos((2 * Math.PI * i) / points),
+  Math.sin((2 * Math.PI * i) / points),
+]);
+
+describe('viewer detail levels', () => {
+  it('bevels large polygons and simplifies the ones a few pixels wide', () => {
+    const items = [
+      { pixels: 200, points: 120, copies: 1 },
+      { pixels: 10, points: 120, copies: 1 },
+      { pixels: 2, points: 120, copies: 1 },
+    ];
+    expect(chooseDetailLevels(items)).toEqual([2, 1, 0]);
+    expect(estimateExtrudeTriangles(120, 2)).toBeGreaterThan(estimateExtrudeTriangles(120, 1));
+    expect(estimateExtrudeTriangles(120, 1)).toBeGreaterThan(estimateExtrudeTriangles(120, 0));
+    expect(simplifyOutline(circle(120))).toHaveLength(12);
+    expect(simplifyOutline(circle(8))).toHaveLength(8);
+  });
+
+  it('coarsens the smallest polygons first to fit the triangle budget', () => {
+    const items = [
+      { pixels: 300, points: 100, copies: 2 },
+      { pixels: 100, points: 100, copies: 1 },
+      { pixels: 50, points: 100, copies: 1 },
+    ];
+    const cost = levels => items.reduce(
+      (sum, item, index) => sum + estimateExtrudeTriangles(item.points, levels[index]) * item.copies,
+      0,
+    );
+    const budget = cost([2, 2, 1]);
+    const levels = chooseDetailLevels(items, budget);
+    expect(levels).toEqual([2, 2, 1]);
+    expect(cost(levels)).toBeLessThanOrEqual(budget);
+    // Below the coarsest possible total every polygon ends up simplified.
+    expect(chooseDetailLevels(items, 1)).toEqual([0, 0, 0]);
+  });
+});
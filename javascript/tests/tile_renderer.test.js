@@ -0,0 +1,167 @@
+import { describe, it, expect } from 'vitest';
+import { buildTileIndex, tileIndexLayout, groupsInViewport, tilesForViewport, tileBounds, refinePolyline, clipSegment, clipPolyline, hatchStride, renderTileSVG, TileCache, TILE_SIZE } from '../js/tile_renderer.js';
+import { renderSpiral } from '../js/doyle_spiral_engine.js';
+
+function buildIndex(params = {}) {
+  const res = renderSpiral({ p: 8, q: 8, t: 0, mode: 'arram_boyle', ...params }, 'arram_boyle');
+  const index = buildTileIndex(res.engine.arcGroups, res.scaleFactor, {
+    width: res.params.bounding_box_width_mm,
+    height: res.params.bounding_box_height_mm,
+  });
+  return { index, params: res.params };
+}
+
+describe('buildTileIndex / groupsInViewport', () => {
+  it('returns every group for the full drawing and fewer for a corner of it', () => {
+    const { index } = buildIndex();
+    const all = groupsInViewport(index, [index.minX, index.minY, -index.minX, -index.minY]);
+    expect(all.length).toBe(index.records.length);
+    const corner = groupsInViewport(index, [index.minX, index.minY, index.minX + index.size / 8, index.minY + index.size / 8]);
+    expect(corner.length).toBeLessThan(all.length);
+  });
+
+  it('finds the centre groups in a small viewport around the origin', () => {
+    const { index } = buildIndex();
+    const centre = groupsInViewport(index, [-0.5, -0.5, 0.5, 0.5]);
+    expect(centre.length).toBeGreaterThan(0);
+    for (const record of centre) {
+      expect(record.bbox[0]).toBeLessThanOrEqual(0.5);
+      expect(record.bbox[2]).toBeGreaterThanOrEqual(-0.5);
+    }
+  });
+
+  it('answers viewport queries from the layout alone, which holds no paths', () => {
+    const { index } = buildIndex();
+    const layout = tileIndexLayout(index);
+    expect(JSON.stringify(layout)).not.toContain('paths');
+    const rect = [-20, -20, 5, 5];
+    expect(groupsInViewport(layout, rect).map(record => record.bbox))
+      .toEqual(groupsInViewport(index, rect).map(record => record.bbox));
+    expect(tilesForViewport(layout, rect, 40)).toEqual(tilesForViewport(index, rect, 40));
+  });
+});
+
+describe('tilesForViewport', () => {
+  it('uses a single tile at the fitted zoom and deeper tiles when magnified', () => {
+    const { index } = buildIndex();
+    const full = [index.minX, index.minY, -index.minX, -index.minY];
+    const fitted = tilesForViewport(index, full, TILE_SIZE / index.size);
+    expect(fitted.z).toBe(0);
+    expect(fitted.tiles).toHaveLength(1);
+
+    const zoomed = tilesForViewport(index, [-1, -1, 1, 1], 64 * TILE_SIZE / index.size);
+    expect(zoomed.z).toBe(6);
+    for (const tile of zoomed.tiles) {
+      const [x0, y0, x1, y1] = tileBounds(index, tile.z, tile.x, tile.y);
+      expect(x1 - x0).toBeCloseTo(index.size / 64, 9);
+      expect(x0).toBeLessThanOrEqual(1);
+      expect(y1).toBeGreaterThanOrEqual(-1);
+    }
+  });
+});
+
+describe('refinePolyline', () => {
+  it('inserts points on the shared circle when a chord is longer than the limit', () => {
+    const circle = { cx: 0, cy: 0, r: 10 };
+    const pts = [{ x: 10, y: 0 }, { x: 0, y: 10 }];
+    const refined = refinePolyline(pts, [circle], 0.5, false);
+    expect(refined.length).toBeGreaterThan(20);
+    for (const p of refined) {
+      expect(Math.hypot(p.x, p.y)).toBeCloseTo(10, 9);
+    }
+    expect(refined[refined.length - 1]).toEqual(pts[1]);
+  });
+
+  it('leaves chords that do not lie on a single circle untouched', () => {
+    const pts = [{ x: 0, y: 0 }, { x: 5, y: 0 }, { x: 5, y: 5 }];
+    expect(refinePolyline(pts, [{ cx: 100, cy: 100, r: 1 }], 0.1, true)).toEqual(pts);
+  });
+});
+
+describe('clipSegment / clipPolyline', () => {
+  const rect = [0, 0, 10, 10];
+
+  it('cuts segments at the rectangle and drops those outside', () => {
+    expect(clipSegment({ x: -5, y: 5 }, { x: 15, y: 5 }, rect)).toEqual([{ x: 0, y: 5 }, { x: 10, y: 5 }]);
+    const inside = [{ x: 1, y: 1 }, { x: 2, y: 3 }];
+    const clipped = clipSegment(inside[0], inside[1], rect);
+    expect(clipped[0]).toBe(inside[0]);
+    expect(clipped[1]).toBe(inside[1]);
+    expect(clipSegment({ x: -5, y: -1 }, { x: 15, y: -1 }, rect)).toBeNull();
+    expect(clipSegment({ x: 12, y: -5 }, { x: 20, y: 5 }, rect)).toBeNull();
+  });
+
+  it('keeps polylines inside whole and splits the rest into open runs', () => {
+    const square = [{ x: 2, y: 2 }, { x: 8, y: 2 }, { x: 8, y: 8 }, { x: 2, y: 8 }];
+    expect(clipPolyline(square, rect, true)).toEqual([{ points: square, closed: true }]);
+
+    // The part right of x = 0 stays, as one open run.
+    const wide = [{ x: -5, y: 2 }, { x: 5, y: 2 }, { x: 5, y: 8 }, { x: -5, y: 8 }];
+    expect(clipPolyline(wide, rect, true)).toEqual([
+      { points: [{ x: 0, y: 2 }, { x: 5, y: 2 }, { x: 5, y: 8 }, { x: 0, y: 8 }], closed: false },
+    ]);
+    const zigzag = [{ x: 1, y: 1 }, { x: 5, y: 20 }, { x: 9, y: 1 }];
+    const runs = clipPolyline(zigzag, rect);
+    expect(runs).toHaveLength(2);
+    expect(runs.every(run => !run.closed && run.points.length === 2)).toBe(true);
+  });
+});
+
+describe('hatchStride', () => {
+  it('keeps every line when spacing is visible and thins it when not', () => {
+    expect(hatchStride(8, 1)).toBe(1);
+    expect(hatchStride(1, 1)).toBe(2);
+    expect(hatchStride(0.1, 1)).toBe(15);
+  });
+});
+
+describe('renderTileSVG', () => {
+  it('emits only the groups touching the tile', () => {
+    const { index, params } = buildIndex({ add_fill_pattern: true });
+    const top = renderTileSVG(index, 0, 0, 0, params);
+    const deep = renderTileSVG(index, 4, 8, 8, params);
+    expect(top.groupCount).toBe(index.records.length);
+    expect(deep.groupCount).toBeGreaterThan(0);
+    expect(deep.groupCount).toBeLessThan(top.groupCount);
+    expect(deep.svg).toContain(`width="${TILE_SIZE}"`);
+    expect(deep.svg).toContain('<line');
+  });
+
+  it('clips outlines and hatch lines to the tile', () => {
+    const { index, params } = buildIndex({ add_fill_pattern: true, fill_pattern_spacing: 1 });
+    const top = renderTileSVG(index, 0, 0, 0, params);
+    expect(top.svg).toContain(' Z"');
+    const [x0, y0, x1, y1] = tileBounds(index, 6, 35, 30);
+    const deep = renderTileSVG(index, 6, 35, 30, params).svg;
+    const margin = Math.max(params.group_outline_width, params.pattern_stroke_width);
+    expect(deep).toContain('<line');
+    expect(deep).toContain('<path');
+    for (const [, xs, ys] of Array.from(deep.matchAll(/[ML](-?[\d.]+),(-?[\d.]+)/g))) {
+      expect(Number(xs)).toBeGreaterThanOrEqual(x0 - margin - 1e-4);
+      expect(Number(xs)).toBeLessThanOrEqual(x1 + margin + 1e-4);
+      expect(Number(ys)).toBeGreaterThanOrEqual(y0 - margin - 1e-4);
+      expect(Number(ys)).toBeLessThanOrEqual(y1 + margin + 1e-4);
+    }
+    for (const [, axis, value] of Array.from(deep.matchAll(/ ([xy])[12]="(-?[\d.]+)"/g))) {
+      const [lo, hi] = axis === 'x' ? [x0, x1] : [y0, y1];
+      expect(Number(value)).toBeGreaterThanOrEqual(lo - margin - 1e-4);
+      expect(Number(value)).toBeLessThanOrEqual(hi + margin + 1e-4);
+    }
+  });
+});
+
+describe('TileCache', () => {
+  it('evicts the least recently used tile and reports it', () => {
+    const evicted = [];
+    const cache = new TileCache(2, (value, key) => evicted.push(key));
+    cache.set('0/0/0', 'a');
+    cache.set('1/0/0', 'b');
+    cache.get('0/0/0');
+    cache.set('1/1/0', 'c');
+    expect(evicted).toEqual(['1/0/0']);
+    expect(cache.get('0/0/0')).toBe('a');
+    expect(cache.size).toBe(2);
+    cache.clear();
+    expect(evicted).toHaveLength(3);
+  });
+});
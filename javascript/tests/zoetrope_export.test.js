@@ -0,0 +1,119 @@
+import { describe, it, expect } from 'vitest';
+import {
+  buildZoetropeScene,
+  buildActivationTable,
+  renderZoetropeFrame,
+  encodeAPNG,
+  zoetropePalette,
+  REFLECTION_THRESHOLD_DEG,
+} from '../js/zoetrope_export.js';
+import { renderSpiral } from '../js/doyle_spiral_engine.js';
+
+function concat(parts) {
+  const total = parts.reduce((sum, p) => sum + p.length, 0);
+  const out = new Uint8Array(total);
+  let offset = 0;
+  for (const p of parts) {
+    out.set(p, offset);
+    offset += p.length;
+  }
+  return out;
+}
+
+function chunks(bytes) {
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const list = [];
+  for (let at = 8; at < bytes.length;) {
+    const length = view.getUint32(at);
+    const type = String.fromCharCode(...bytes.subarray(at + 4, at + 8));
+    list.push({ type, data: bytes.subarray(at + 8, at + 8 + length) });
+    at += 12 + length;
+  }
+  return list;
+}
+
+const square = (cx, cy, half, ring, angle) => ({
+  outline: [[cx - half, cy - half], [cx + half, cy - half], [cx + half, cy + half], [cx - half, cy + half]],
+  ring_index: ring,
+  line_angle: angle,
+  line_patterns: [angle],
+});
+
+describe('buildActivationTable', () => {
+  it('matches a brute-force check of every frame and group', () => {
+    const groups = [{ angles: [0] }, { angles: [45, 100] }, { angles: [179.5] }, { angles: [300] }];
+    const frames = 72;
+    const table = buildActivationTable(groups, frames);
+    for (let f = 0; f < frames; f++) {
+      const lit = new Set(table.entries.slice(table.offsets[f], table.offsets[f + 1]));
+      groups.forEach((group, idx) => {
+        const expected = group.angles.some(angle => {
+          const diff = (((f * 5 - angle) % 180) + 180) % 180;
+          return Math.min(diff, 180 - diff) < REFLECTION_THRESHOLD_DEG;
+        });
+        expect(lit.has(idx)).toBe(expected);
+      });
+    }
+    expect(Math.max(...table.levels)).toBeLessThanOrEqual(8);
+    expect(Math.min(...table.levels)).toBeGreaterThanOrEqual(1);
+  });
+});
+
+describe('renderZoetropeFrame', () => {
+  const geometry = { arcgroups: [square(-5, 5, 4, 0, 0), square(5, -5, 4, 1, 90)] };
+  const scene = buildZoetropeScene(geometry, { size: 40 });
+  const table = buildActivationTable(scene.groups, 8);
+
+  it('fills groups in the viewer orientation and lights them by rotation', () => {
+    // Y up: the group at (-5, 5) is in the top-left quadrant.
+    expect(scene.labels[8 * 40 + 8]).toBe(1);
+    expect(scene.labels[31 * 40 + 31]).toBe(2);
+    expect(scene.labels[20 * 40 + 20]).toBe(0);
+    const still = renderZoetropeFrame(scene, table, 0, { rotate: false });
+    const lit = still[8 * 40 + 8];
+    const unlit = still[31 * 40 + 31];
+    expect(lit).not.toBe(unlit);
+    const quarter = renderZoetropeFrame(scene, table, 2, { rotate: false });
+    expect(quarter[31 * 40 + 31]).not.toBe(unlit);
+    expect(quarter[8 * 40 + 8]).not.toBe(lit);
+  });
+
+  it('rotates the disk counter-clockwise and is deterministic', () => {
+    const frame = renderZoetropeFrame(scene, table, 2);
+    // After 90° the top-left group moves to the bottom-left.
+    expect(frame[31 * 40 + 8]).not.toBe(0);
+    expect(frame[8 * 40 + 8]).toBe(0);
+    expect(renderZoetropeFrame(scene, table, 2)).toEqual(frame);
+    expect(renderZoetropeFrame(scene, table, 10)).toEqual(frame);
+  });
+
+  it('uses the packed outlines of a real render', () => {
+    const result = renderSpiral({ p: 8, q: 8, fill_pattern_angle: 20, geometry_precision: 'float32' });
+    const real = buildZoetropeScene(result.geometry, { size: 64 });
+    expect(real.groups.length).toBe(result.geometry.arcgroups.length);
+    expect(real.labels.some(label => label > 0)).toBe(true);
+  });
+});
+
+describe('encodeAPNG', () => {
+  it('writes an indexed, looping APNG with sequential frame chunks', async () => {
+    const scene = buildZoetropeScene({ arcgroups: [square(0, 3, 2, 0, 0)] }, { size: 16 });
+    const table = buildActivationTable(scene.groups, 4);
+    const frames = [0, 1, 2, 3].map(f => renderZoetropeFrame(scene, table, f));
+    const bytes = concat(await encodeAPNG(frames, 16, { fps: 12 }));
+    const list = chunks(bytes);
+    expect(list.map(c => c.type)).toEqual([
+      'IHDR', 'acTL', 'PLTE', 'fcTL', 'IDAT', 'fcTL', 'fdAT', 'fcTL', 'fdAT', 'fcTL', 'fdAT', 'IEND',
+    ]);
+    expect(list[0].data[9]).toBe(3);
+    expect(new DataView(list[1].data.buffer, list[1].data.byteOffset).getUint32(0)).toBe(4);
+    expect(list[2].data).toEqual(zoetropePalette());
+    const sequence = list
+      .filter(c => c.type === 'fcTL' || c.type === 'fdAT')
+      .map(c => new DataView(c.data.buffer, c.data.byteOffset).getUint32(0));
+    expect(sequence).toEqual([0, 1, 2, 3, 4, 5, 6]);
+    const fctl = new DataView(list[3].data.buffer, list[3].data.byteOffset);
+    expect(fctl.getUint16(20)).toBe(1);
+    expect(fctl.getUint16(22)).toBe(12);
+  });
+});
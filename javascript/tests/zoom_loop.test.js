@@ -0,0 +1,131 @@
+import { describe, it, expect } from 'vitest';
+import {
+  buildZoomLoop,
+  zoomLoopFrame,
+  zoomLoopFrameAtPhase,
+  zoomLoopPhase,
+  zoomLoopTimeline,
+  renderZoomLoopFrameSVG,
+  ringShiftPerPeriod,
+} from '../js/zoom_loop.js';
+import { linesInPolygon } from '../js/doyle_spiral_engine.js';
+
+const PARAMS = { p: 8, q: 8, t: 0, add_fill_pattern: true, fill_pattern_angle: 15 };
+
+function drawnGroups(loop, frame, inset = 0.8) {
+  const [a, b] = frame.matrix;
+  const limit = Math.min(loop.width, loop.height) / 2 * inset;
+  return frame.groups
+    .map(record => ({
+      record,
+      x: a * record.center[0] - b * record.center[1],
+      y: b * record.center[0] + a * record.center[1],
+      r: record.radius * Math.hypot(a, b),
+      angle: (record.ringIndex + frame.ringOffset) * loop.params.fill_pattern_angle,
+    }))
+    .filter(entry => Math.hypot(entry.x, entry.y) < limit && entry.r > 0);
+}
+
+describe('ringShiftPerPeriod', () => {
+  it('counts the rings between a radius and its image under |a|', () => {
+    const mapping = new Map([[1, 0], [1.5, 1], [2, 2], [3, 3], [4, 4]]);
+    expect(ringShiftPerPeriod(mapping, 2)).toBe(2);
+    expect(ringShiftPerPeriod(mapping, 7)).toBe(0);
+  });
+});
+
+describe('buildZoomLoop', () => {
+  const loop = buildZoomLoop(PARAMS, { frames: 24 });
+
+  it('renders enough rings to cover the view for the whole period', () => {
+    expect(loop.complete).toBe(true);
+    expect(loop.ringShift).toBeGreaterThan(0);
+    expect(loop.maxDistance).toBeGreaterThan(loop.params.max_d);
+    const first = zoomLoopFrame(loop, 0);
+    const last = zoomLoopFrame(loop, loop.period - 1);
+    expect(first.groups.length).toBeGreaterThan(0);
+    expect(last.groups.length).toBeGreaterThan(0);
+  });
+
+  it('closes the loop: the frame at τ = 1 matches frame 0 in position, size and hatch angle', () => {
+    const start = drawnGroups(loop, zoomLoopFrame(loop, 0));
+    const end = drawnGroups(loop, zoomLoopFrameAtPhase(loop, 1), 0.95);
+    expect(start.length).toBeGreaterThan(10);
+    for (const entry of start) {
+      const match = end.find(other => Math.hypot(other.x - entry.x, other.y - entry.y) < 1e-6 * entry.r);
+      expect(match).toBeDefined();
+      expect(Math.abs(match.r - entry.r)).toBeLessThan(1e-6 * entry.r);
+      const delta = ((match.angle - entry.angle) % 180 + 180) % 180;
+      expect(Math.min(delta, 180 - delta)).toBeLessThan(1e-9);
+    }
+  });
+
+  it('wraps frame indices and plays "in" as the reversed "out" loop', () => {
+    expect(zoomLoopPhase(loop, loop.period + 3)).toBe(zoomLoopPhase(loop, 3));
+    expect(zoomLoopPhase(loop, -1)).toBe(zoomLoopPhase(loop, loop.period - 1));
+    const reversed = { ...loop, direction: 'in' };
+    expect(zoomLoopPhase(reversed, 0)).toBe(0);
+    expect(zoomLoopPhase(reversed, 1)).toBe(zoomLoopPhase(loop, loop.period - 1));
+  });
+});
+
+describe('renderZoomLoopFrameSVG', () => {
+  const loop = buildZoomLoop(PARAMS, { frames: 12 });
+
+  it('emits world geometry under the frame transform with hatch in drawing orientation', () => {
+    const frame = zoomLoopFrame(loop, 5);
+    const { svg, groupCount } = renderZoomLoopFrameSVG(loop, 5);
+    expect(svg.startsWith('<svg')).toBe(true);
+    expect(svg).toContain(`viewBox="${-loop.width / 2} ${-loop.height / 2} ${loop.width} ${loop.height}"`);
+    expect(groupCount).toBe(frame.groups.length);
+    expect((svg.match(/<path /g) || []).length).toBe(groupCount);
+
+    // Hatching in world space and mapping it through the frame transform gives
+    // the same lines as hatching the transformed outline.
+    const [a, b] = frame.matrix;
+    const scale = Math.hypot(a, b);
+    const rotation = Math.atan2(b, a) * 180 / Math.PI;
+    const record = frame.groups[0];
+    const world = [];
+    for (let i = 0; i < record.points.length; i += 2) world.push({ x: record.points[i], y: record.points[i + 1] });
+    const drawn = world.map(p => ({ x: a * p.x - b * p.y, y: b * p.x + a * p.y }));
+    const angle = (record.ringIndex + frame.ringOffset) * loop.params.fill_pattern_angle;
+    const direct = linesInPolygon(drawn, loop.params.fill_pattern_spacing, angle, 0);
+    const viaWorld = linesInPolygon(world, loop.params.fill_pattern_spacing / scale, angle - rotation, 0)
+      .map(seg => seg.map(p => ({ x: a * p.x - b * p.y, y: b * p.x + a * p.y })));
+    expect(viaWorld.length).toBe(direct.length);
+    viaWorld.forEach((seg, idx) => {
+      const ends = [seg[0], seg[1]];
+      for (const p of direct[idx]) {
+        expect(Math.min(...ends.map(q => Math.hypot(q.x - p.x, q.y - p.y)))).toBeLessThan(1e-6);
+      }
+    });
+  });
+
+  it('formats each outline once and reuses it in later frames', () => {
+    renderZoomLoopFrameSVG(loop, 0);
+    const record = zoomLoopFrame(loop, 0).groups[0];
+    const path = record.path;
+    renderZoomLoopFrameSVG(loop, 7);
+    expect(record.path).toBe(path);
+  });
+});
+
+describe('zoomLoopTimeline', () => {
+  it('lists shared outlines once and per-frame transforms with visible group indices', () => {
+    const loop = buildZoomLoop(PARAMS, { frames: 6 });
+    const timeline = zoomLoopTimeline(loop);
+    expect(timeline.frames).toHaveLength(6);
+    expect(timeline.groups).toHaveLength(loop.records.length);
+    expect(timeline.ring_shift).toBe(loop.ringShift);
+    for (const frame of timeline.frames) {
+      expect(frame.matrix).toHaveLength(6);
+      for (const idx of frame.groups) {
+        expect(idx).toBeGreaterThanOrEqual(0);
+        expect(idx).toBeLessThan(timeline.groups.length);
+      }
+    }
+    expect(timeline.frames[0].angle_offset).toBe(0);
+    expect(JSON.parse(JSON.stringify(timeline)).groups[0].outline.length % 2).toBe(0);
+  });
+});
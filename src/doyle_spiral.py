@@ -68,6 +68,10 @@ class Shape:
 
 def convert_polygon_to_array(polygon):
     """Convert polygon from complex numbers or list to numpy array."""
+    if isinstance(polygon, np.ndarray):
+        if np.iscomplexobj(polygon):
+            return np.column_stack((polygon.real, polygon.imag))
+        return polygon
     if polygon and isinstance(polygon[0], complex):
         return np.array([(p.real, p.imag) for p in polygon])
     return np.array(polygon)
@@ -193,8 +197,10 @@ class LineFillCache:
         return round(float(value), 9)
 
     @staticmethod
-    def polygon_signature_from_array(array: np.ndarray) -> Tuple[Tuple[float, float], ...]:
-        return tuple((round(float(x), 9), round(float(y), 9)) for x, y in array)
+    def polygon_signature_from_array(array: np.ndarray) -> Tuple[Tuple[int, ...], bytes]:
+        # Adding 0.0 folds -0.0 into 0.0 so equal polygons give equal bytes.
+        rounded = np.round(np.asarray(array, dtype=float), 9) + 0.0
+        return rounded.shape, rounded.tobytes()
 
     def _make_key(self, polygon_signature: Any, offset: float, spacing: float, angle: float) -> Tuple[Any, float, float, float]:
         return (
@@ -549,10 +555,10 @@ class DrawingContext:
                 if points is None:
                     points = element.get_points()
 
-                if not points:
+                if len(points) == 0:
                     svg_element = None
                 else:
-                    scaled_points = [p * self.scale_factor for p in points]
+                    scaled_points = (points * self.scale_factor).tolist()
                     color = kwargs.get("color", "#000000")
                     width = kwargs.get("width", 1.2)
                     path_data = ["M", f"{scaled_points[0].real},{scaled_points[0].imag}"]
@@ -699,14 +705,14 @@ class DrawingContext:
                 stroke_width=0.5
             ))
     
-    def draw_group_outline(self, points: List[complex], fill: Optional[str] = None, 
+    def draw_group_outline(self, points: np.ndarray, fill: Optional[str] = None, 
                           stroke: Optional[str] = None, stroke_width: float = 1.0, 
                           line_pattern_settings = (3, 0), use_clipped_lines: bool = False, 
                           draw_outline: bool = True, line_offset: float = 0):
         """Draw a polygon with optional line pattern fill.
         
         Args:
-            points: Complex numbers representing polygon vertices
+            points: Complex array of polygon vertices
             fill: Fill type ("pattern", "clipped_lines", color, or None)
             stroke: Outline color
             stroke_width: Outline width
@@ -715,10 +721,11 @@ class DrawingContext:
             draw_outline: Whether to draw polygon outline
             line_offset: Inward offset for line clipping
         """
-        if not points:
+        points = np.asarray(points, dtype=complex)
+        if len(points) == 0:
             return
-        
-        coords = [(p.real, p.imag) for p in points]
+
+        coords = [tuple(xy) for xy in np.column_stack((points.real, points.imag)).tolist()]
         
         # Use clipped lines for pattern fills (new method)
         if use_clipped_lines or fill in ("pattern", "clipped_lines"):
@@ -957,7 +964,7 @@ class ArcElement(Shape):
         """
         super().__init__(visible)
         self.circle = circle
-        self._points_cache: Optional[List[complex]] = None
+        self._points_cache: Optional[np.ndarray] = None
         self._start: complex = 0j
         self._end: complex = 0j
         self._steps: int = 0
@@ -1004,11 +1011,11 @@ class ArcElement(Shape):
             self._steps = new_value
             self._invalidate_points_cache()
 
-    def get_cached_points(self) -> Optional[List[complex]]:
+    def get_cached_points(self) -> Optional[np.ndarray]:
         """Return the cached arc sample points if available."""
         return self._points_cache
 
-    def get_points(self) -> List[complex]:
+    def get_points(self) -> np.ndarray:
         """
         Calculates the discrete points defining the arc.
 
@@ -1016,27 +1023,46 @@ class ArcElement(Shape):
         then generates a sequence of points along the arc.
 
         Returns:
-            A list of complex numbers representing the points along the arc.
+            A complex array of the points along the arc.
+        """
+        if self._points_cache is None:
+            ArcElement.tessellate([self])
+        return self._points_cache
+
+    @staticmethod
+    def tessellate(arcs: List['ArcElement']):
+        """
+        Samples many arcs at once and fills their point caches.
+
+        Arcs with the same step count are evaluated as one 2D array, one row
+        per arc, so a whole ring costs a few numpy calls instead of a Python
+        loop per point. Arcs that are already cached are left alone.
+
+        Args:
+            arcs: The ArcElement objects to sample.
         """
-        if self._points_cache is not None:
-            return self._points_cache
+        by_steps: Dict[int, List['ArcElement']] = {}
+        for arc in arcs:
+            if arc._points_cache is None:
+                by_steps.setdefault(arc.steps, []).append(arc)
 
-        c = self.circle.center
-        r = self.circle.radius
-        a1 = np.angle(self.start - c)
-        a2 = np.angle(self.end - c)
+        for steps, batch in by_steps.items():
+            c = np.array([arc.circle.center for arc in batch], dtype=complex)
+            r = np.array([arc.circle.radius for arc in batch], dtype=float)
+            a1 = np.angle(np.array([arc.start for arc in batch], dtype=complex) - c)
+            a2 = np.angle(np.array([arc.end for arc in batch], dtype=complex) - c)
 
-        # Calculate the clockwise angular difference [0, 2pi)
-        delta = (a2 - a1 + 2 * np.pi) % (2 * np.pi)
+            # Calculate the clockwise angular difference [0, 2pi)
+            delta = (a2 - a1 + 2 * np.pi) % (2 * np.pi)
 
-        # Arc is drawn clockwise; use the smaller angular magnitude direction if needed
-        if delta > np.pi:
-            delta -= 2 * np.pi  # Result in [-2pi, 0] or [-pi, pi] if delta was > pi
+            # Arc is drawn clockwise; use the smaller angular magnitude direction if needed
+            delta = np.where(delta > np.pi, delta - 2 * np.pi, delta)
 
-        # Generate points along the arc using linspace for angles
-        angles = np.linspace(a1, a1 + delta, self.steps)
-        self._points_cache = [c + r * np.exp(1j * a) for a in angles]
-        return self._points_cache
+            # One row of angles per arc
+            angles = np.linspace(a1, a1 + delta, steps, axis=1)
+            points = c[:, None] + r[:, None] * np.exp(1j * angles)
+            for arc, row in zip(batch, points):
+                arc._points_cache = row
 
     def to_svg(self, dwg: svgwrite.Drawing, color="#000000", width=1.2):
         """
@@ -1054,7 +1080,7 @@ class ArcElement(Shape):
             return None
         # Get the discrete points for the arc
         pts = self.get_points()
-        if not pts:
+        if len(pts) == 0:
             return None
         # Create a path string from the points
         path_data = ["M", f"{pts[0].real},{pts[0].imag}"] + [f"L{p.real},{p.imag}" for p in pts[1:]]
@@ -1085,8 +1111,8 @@ class ArcGroup:
         self.id = ArcGroup._id_counter
         self.name = name or f"arcgroup_{self.id}"
         self.arcs: List[ArcElement] = []
-        self._arc_points_cache: Dict[ArcElement, List[complex]] = {}
-        self._outline_cache: Optional[List[complex]] = None
+        self._arc_points_cache: Dict[ArcElement, np.ndarray] = {}
+        self._outline_cache: Optional[np.ndarray] = None
         # color for debug visualization
         self.debug_fill: Optional[str] = None
         self.debug_stroke: Optional[str] = None
@@ -1131,19 +1157,18 @@ class ArcGroup:
         """
         return len(self.arcs) == 0
 
-    def get_all_points(self) -> List[complex]:
+    def get_all_points(self) -> np.ndarray:
         """
         Return concatenation of point sequences from all arcs (in their stored order).
 
         Returns:
-            A list of complex numbers representing all points from all arcs in the group.
+            A complex array of all points from all arcs in the group.
         """
-        pts = []
-        for arc in self.arcs:
-            pts.extend(self._ensure_arc_points(arc))
-        return pts
+        if not self.arcs:
+            return np.empty(0, dtype=complex)
+        return np.concatenate([self._ensure_arc_points(arc) for arc in self.arcs])
 
-    def _cache_arc_points(self, arc: ArcElement) -> List[complex]:
+    def _cache_arc_points(self, arc: ArcElement) -> np.ndarray:
         """Ensure that the group's cache stores the sampled points for ``arc``."""
         points = arc.get_cached_points()
         if points is None:
@@ -1151,7 +1176,7 @@ class ArcGroup:
         self._arc_points_cache[arc] = points
         return points
 
-    def _ensure_arc_points(self, arc: ArcElement) -> List[complex]:
+    def _ensure_arc_points(self, arc: ArcElement) -> np.ndarray:
         """Retrieve cached points for ``arc``, populating the cache when necessary."""
         cached_points = self._arc_points_cache.get(arc)
         current_points = arc.get_cached_points()
@@ -1168,7 +1193,7 @@ class ArcGroup:
         """Invalidate the cached outline for the group."""
         self._outline_cache = None
 
-    def get_cached_outline(self) -> Optional[List[complex]]:
+    def get_cached_outline(self) -> Optional[np.ndarray]:
         """Return the cached outline if it has been computed."""
         return self._outline_cache
 
@@ -1187,103 +1212,125 @@ class ArcGroup:
         return abs(a - b) <= tol
 
 
-    def _try_attach_arc(self, ordered_pts, pts, tol):
+    def _try_attach_arc(self, start_existing, end_existing, pts, tol):
         """Try to attach arc points to the ordered outline.
-        
+
+        Only the outline's current endpoints are compared, so the outline
+        itself never has to be materialised while it grows.
+
         Returns:
-            Modified ordered_pts if attachment successful, None otherwise.
+            ``(at_front, piece)`` if attachment successful, None otherwise.
         """
-        start_existing = ordered_pts[0]
-        end_existing = ordered_pts[-1]
-        start_arc = pts[0]
-        end_arc = pts[-1]
-        
+        start_arc = complex(pts[0])
+        end_arc = complex(pts[-1])
+
         # Try appending arc (original direction)
         if self._match_points(end_existing, start_arc, tol):
-            return ordered_pts + pts[1:]
-        
+            return False, pts[1:]
+
         # Try appending arc (reversed)
         if self._match_points(end_existing, end_arc, tol):
-            return ordered_pts + list(reversed(pts))[1:]
-        
+            return False, pts[::-1][1:]
+
         # Try prepending arc (original direction)
         if self._match_points(start_existing, end_arc, tol):
-            return pts[:-1] + ordered_pts
-        
+            return True, pts[:-1]
+
         # Try prepending arc (reversed)
         if self._match_points(start_existing, start_arc, tol):
-            return list(reversed(pts))[:-1] + ordered_pts
-        
+            return True, pts[::-1][:-1]
+
         return None
-    
-    def _attach_by_proximity(self, ordered_pts, pts):
-        """Attach arc to outline by nearest endpoint."""
+
+    def _attach_by_proximity(self, start_existing, end_existing, pts):
+        """Attach arc to outline by nearest endpoint.
+
+        Returns:
+            ``(at_front, piece)`` as for :meth:`_try_attach_arc`.
+        """
+        start_arc = complex(pts[0])
+        end_arc = complex(pts[-1])
         # Calculate distances to front and back of outline
-        d_front = min(abs(pts[0] - ordered_pts[0]), abs(pts[-1] - ordered_pts[0]))
-        d_back = min(abs(pts[0] - ordered_pts[-1]), abs(pts[-1] - ordered_pts[-1]))
-        
+        d_front = min(abs(start_arc - start_existing), abs(end_arc - start_existing))
+        d_back = min(abs(start_arc - end_existing), abs(end_arc - end_existing))
+
         if d_front < d_back:
             # Attach to front
-            if abs(pts[-1] - ordered_pts[0]) <= abs(pts[0] - ordered_pts[0]):
-                return pts[:-1] + ordered_pts
-            else:
-                return list(reversed(pts))[:-1] + ordered_pts
-        else:
-            # Attach to back
-            if abs(pts[0] - ordered_pts[-1]) <= abs(pts[-1] - ordered_pts[-1]):
-                return ordered_pts + pts[1:]
-            else:
-                return ordered_pts + list(reversed(pts))[1:]
-    
-    def get_closed_outline(self, tol: float = 1e-3) -> List[complex]:
+            if abs(end_arc - start_existing) <= abs(start_arc - start_existing):
+                return True, pts[:-1]
+            return True, pts[::-1][:-1]
+        # Attach to back
+        if abs(start_arc - end_existing) <= abs(end_arc - end_existing):
+            return False, pts[1:]
+        return False, pts[::-1][1:]
+
+    def get_closed_outline(self, tol: float = 1e-3) -> np.ndarray:
         """Order arcs into a closed outline.
-        
+
         Attempts to chain arcs by matching endpoints, reversing when needed.
-        Falls back to proximity-based attachment for remaining arcs.
-        
+        Falls back to proximity-based attachment for remaining arcs. The
+        ordering is decided on arc endpoints alone; the arcs' sample arrays
+        are sliced and joined with a single concatenation at the end.
+
         Returns:
-            List of points forming the outline (closed if endpoints match).
+            Complex array of points forming the outline (closed if endpoints match).
         """
         if self._outline_cache is not None:
-            return list(self._outline_cache)
+            return self._outline_cache.copy()
 
         if not self.arcs:
-            return []
+            return np.empty(0, dtype=complex)
 
         # Prepare arc entries sorted by point count (longest first)
-        entries = [(arc, self._ensure_arc_points(arc)) for arc in self.arcs]
-        entries.sort(key=lambda e: -len(e[1]))
+        entries = [self._ensure_arc_points(arc) for arc in self.arcs]
+        entries.sort(key=lambda pts: -len(pts))
 
         # Start with longest arc
-        ordered_pts = entries[0][1].copy()
+        front_pieces = []
+        back_pieces = [entries[0]]
+        start_existing = complex(entries[0][0])
+        end_existing = complex(entries[0][-1])
         used = {0}
-        
+
+        def attach(at_front, piece):
+            nonlocal start_existing, end_existing
+            if at_front:
+                front_pieces.append(piece)
+                if len(piece):
+                    start_existing = complex(piece[0])
+            else:
+                back_pieces.append(piece)
+                if len(piece):
+                    end_existing = complex(piece[-1])
+
         # Greedily attach arcs that match endpoints
         while True:
             attached_any = False
-            for idx, (arc, pts) in enumerate(entries):
+            for idx, pts in enumerate(entries):
                 if idx in used:
                     continue
-                
-                result = self._try_attach_arc(ordered_pts, pts, tol)
+
+                result = self._try_attach_arc(start_existing, end_existing, pts, tol)
                 if result is not None:
-                    ordered_pts = result
+                    attach(*result)
                     used.add(idx)
                     attached_any = True
                     break
-            
+
             if not attached_any:
                 break
-        
+
         # Attach remaining arcs by proximity
         for idx in range(len(entries)):
             if idx not in used:
-                ordered_pts = self._attach_by_proximity(ordered_pts, entries[idx][1])
-        
+                attach(*self._attach_by_proximity(start_existing, end_existing, entries[idx]))
+
+        ordered_pts = np.concatenate(front_pieces[::-1] + back_pieces)
+
         # Close the outline if endpoints match
-        if ordered_pts and abs(ordered_pts[0] - ordered_pts[-1]) <= tol:
+        if len(ordered_pts) and abs(ordered_pts[0] - ordered_pts[-1]) <= tol:
             ordered_pts[-1] = ordered_pts[0]
-        
+
         self._outline_cache = ordered_pts.copy()
         return ordered_pts
 
@@ -1305,10 +1352,10 @@ class ArcGroup:
         """
         # Get the points for the outline
         pts = self.get_closed_outline()
-        if not pts:
+        if len(pts) == 0:
             return
         # scale points using the drawing context's scale factor
-        scaled = [p * context.scale_factor for p in pts]
+        scaled = pts * context.scale_factor
         if debug:
             # Generate a random color if debug colors are not set
             fill = self.debug_fill or "#%06x" % random.randint(0, 0xFFFFFF)
@@ -1487,6 +1534,7 @@ class DoyleSpiral:
     def _create_arc_groups_for_circles(self, radius_to_ring, spiral_center, debug_groups, 
                                        add_fill_pattern, draw_group_outline, context):
         """Create arc groups for visible circles and draw individual arcs."""
+        pending: List[Tuple[ArcGroup, ArcElement]] = []
         for c in self.circles:
             if len(c.intersections) != 6:
                 continue
@@ -1508,21 +1556,24 @@ class DoyleSpiral:
                 group.debug_fill = "#%06x" % rng.randint(0, 0xFFFFFF)
                 group.debug_stroke = "#000000"
             
-            # Create and add arcs to group
+            # Create arcs for the group; they are sampled together below
             for i, j in arcs_to_draw:
                 start = c.intersections[i][0]
                 end = c.intersections[j][0]
-                arc = ArcElement(c, start, end, visible=True)
-                
-                # Draw arc only if not using fill pattern and outline enabled
-                if not add_fill_pattern and draw_group_outline:
-                    context.draw_scaled(arc)
-                
-                group.add_arc(arc)
+                pending.append((group, ArcElement(c, start, end, visible=True)))
+
+        ArcElement.tessellate([arc for _, arc in pending])
+        for group, arc in pending:
+            # Draw arc only if not using fill pattern and outline enabled
+            if not add_fill_pattern and draw_group_outline:
+                context.draw_scaled(arc)
+
+            group.add_arc(arc)
     
     def _draw_outer_closure_arcs(self, spiral_center, debug_groups, red_outline, 
                                  add_fill_pattern, draw_group_outline, context):
         """Draw closure arcs from outer invisible circles."""
+        pending: List[Tuple[CircleElement, ArcElement]] = []
         for c in self.outer_circles:
             if len(c.intersections) < 2:
                 continue
@@ -1540,24 +1591,26 @@ class DoyleSpiral:
             arc_distances.sort()
             for idx in range(1, min(3, len(arc_distances))):
                 _, i, j = arc_distances[idx]
-                arc = ArcElement(c, pts[i], pts[j], visible=True)
-                
-                # Draw if red outline enabled or (no fill and outline enabled)
-                if red_outline or (not add_fill_pattern and draw_group_outline):
-                    color = "#ff0000" if red_outline else "#000000"
-                    context.draw_scaled(arc, color=color, width=1.2)
-                
-                # Add to outer closure group
-                key = f"outer_{c.id}"
-                if key not in self.arc_groups:
-                    self.arc_groups[key] = ArcGroup(name=key)
-                    self.arc_groups[key].ring_index = -1
-                    if debug_groups:
-                        rng = random.Random(c.id + 1000)
-                        self.arc_groups[key].debug_fill = "#%06x" % rng.randint(0, 0xFFFFFF)
-                        self.arc_groups[key].debug_stroke = "#000000"
-                
-                self.arc_groups[key].add_arc(arc)
+                pending.append((c, ArcElement(c, pts[i], pts[j], visible=True)))
+
+        ArcElement.tessellate([arc for _, arc in pending])
+        for c, arc in pending:
+            # Draw if red outline enabled or (no fill and outline enabled)
+            if red_outline or (not add_fill_pattern and draw_group_outline):
+                color = "#ff0000" if red_outline else "#000000"
+                context.draw_scaled(arc, color=color, width=1.2)
+
+            # Add to outer closure group
+            key = f"outer_{c.id}"
+            if key not in self.arc_groups:
+                self.arc_groups[key] = ArcGroup(name=key)
+                self.arc_groups[key].ring_index = -1
+                if debug_groups:
+                    rng = random.Random(c.id + 1000)
+                    self.arc_groups[key].debug_fill = "#%06x" % rng.randint(0, 0xFFFFFF)
+                    self.arc_groups[key].debug_stroke = "#000000"
+
+            self.arc_groups[key].add_arc(arc)
     
     # ---- Rendering ----
 
@@ -1599,6 +1652,7 @@ class DoyleSpiral:
         # complete arc groups - This block appears to add additional arcs based on neighbor circles
         # and specific indices. This might require further review for its geometric purpose.
         max_index = max([group.ring_index for group in self.arc_groups.values()])
+        pending: List[Tuple[ArcGroup, ArcElement]] = []
         for c in self.circles:
             if not f"circle_{c.id}" in self.arc_groups.keys(): continue
             group = self.arc_groups[f"circle_{c.id}"]
@@ -1624,7 +1678,7 @@ class DoyleSpiral:
                         arc_a = ArcElement(neigh_a, start_a, end_a, visible=True)
                         # Add this arc to the current circle's group
 
-                        group.add_arc(arc_a)
+                        pending.append((group, arc_a))
                     else:
                         # Similar logic for neighbors with a different number of arcs
                         arc_i = 0
@@ -1636,8 +1690,12 @@ class DoyleSpiral:
                         start_a = neigh_a.intersections[i][0]
                         end_a = neigh_a.intersections[j][0]
                         arc_a = ArcElement(neigh_a, start_a, end_a, visible=True)
-                        group.add_arc(arc_a)
-        
+                        pending.append((group, arc_a))
+
+        ArcElement.tessellate([arc for _, arc in pending])
+        for group, arc in pending:
+            group.add_arc(arc)
+
         #"""
         # After drawing all arcs, render group outlines (debug fills) if debug is enabled
         if debug_groups:
@@ -1761,7 +1819,7 @@ class DoyleSpiral:
                 if outline is None:
                     outline = computed_outline
 
-            outline_points = [[p.real, p.imag] for p in outline] if outline else []
+            outline_points = np.column_stack((outline.real, outline.imag)).tolist()
 
             ring_index = group.ring_index if group.ring_index is not None else 0
             line_angle = ring_index * self.fill_pattern_angle
@@ -44,6 +44,12 @@ const DEFAULTS = {
 let activeView = '2d';
 let lastRender = null;
 let threeApp = null;
+const svgParser = typeof DOMParser !== 'undefined' ? new DOMParser() : null;
+const renderWorkerURL = typeof Worker !== 'undefined' && svgParser
+  ? new URL('./render_worker.js', import.meta.url)
+  : null;
+let renderWorkerHandle = null;
+let currentRenderToken = 0;
 
 function sanitiseFileName(name) {
   return name.replace(/[\\/:*?"<>|]+/g, '-');
@@ -223,6 +229,56 @@ function updateStats(geometry) {
   }
 }
 
+function terminateRenderWorker() {
+  if (renderWorkerHandle) {
+    renderWorkerHandle.terminate();
+    renderWorkerHandle = null;
+  }
+}
+
+// Renders off the main thread with the shared engine worker; a newer request
+// terminates the older worker so stale renders never reach the preview.
+function renderInWorker(params, token) {
+  terminateRenderWorker();
+  const worker = new Worker(renderWorkerURL, { type: 'module' });
+  renderWorkerHandle = worker;
+  return new Promise((resolve, reject) => {
+    worker.onmessage = event => {
+      const data = event.data || {};
+      if (data.requestId !== token) {
+        return;
+      }
+      if (renderWorkerHandle === worker) {
+        terminateRenderWorker();
+      }
+      if (data.type === 'result') {
+        resolve(data);
+      } else {
+        reject(new Error(data.message || 'Render failed'));
+      }
+    };
+    worker.onerror = event => {
+      if (renderWorkerHandle === worker) {
+        terminateRenderWorker();
+      }
+      reject(new Error(event?.message || 'Render failed'));
+    };
+    worker.postMessage({ type: 'render', requestId: token, params });
+  });
+}
+
+function materializeSvg(result) {
+  if (result.svg) {
+    return result.svg;
+  }
+  const doc = svgParser.parseFromString(result.svgString || '', 'image/svg+xml');
+  const element = doc.documentElement;
+  if (!element || element.nodeName.toLowerCase() !== 'svg') {
+    throw new Error('Renderer returned invalid SVG');
+  }
+  return document.importNode(element, true);
+}
+
 function showSVG(svgElement) {
   svgElement.setAttribute('width', '100%');
   svgElement.setAttribute('height', '100%');
@@ -233,12 +289,16 @@ function showSVG(svgElement) {
 
 async function renderCurrentSpiral(showLoading = true) {
   const params = collectParams();
+  const token = ++currentRenderToken;
   if (showLoading) {
     setStatus('Rendering spiral…', 'loading');
   }
   try {
-    const result = renderSpiral(params);
-    showSVG(result.svg);
+    const result = renderWorkerURL ? await renderInWorker(params, token) : renderSpiral(params);
+    if (token !== currentRenderToken) {
+      return;
+    }
+    showSVG(materializeSvg(result));
 
     const geometry = hasGeometry(result.geometry) ? result.geometry : null;
     lastRender = { params, geometry, mode: params.mode, svgString: result.svgString };
@@ -256,6 +316,9 @@ async function renderCurrentSpiral(showLoading = true) {
       }
     }
   } catch (error) {
+    if (token !== currentRenderToken) {
+      return;
+    }
     console.error(error);
     svgPreview.innerHTML = '<div class="empty-state">Unable to render spiral.</div>';
     svgPreview.classList.add('empty-state');
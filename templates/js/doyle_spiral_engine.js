@@ -1,3 +1,5 @@
+// Generated from javascript/js/doyle_spiral_engine.js by javascript/build_engine.mjs (engine build f9f7e4f547ad).
+// Do not edit; change the source and run `npm run build:engine`.
 /* Doyle Spiral engine implemented in JavaScript.
  *
  * This module ports the computational and rendering logic from the Python
@@ -8,27 +10,107 @@
 
 const SVG_NS = 'http://www.w3.org/2000/svg';
 
+const RING_TEMPLATE_CACHE = new Map();
+
+// Performance and safety constants
+const MAX_ITERATIONS_PER_FAMILY = 10000; // Maximum iterations per spiral family to prevent infinite loops
+const EPSILON = 1e-9; // Small value to prevent division by zero
+const TOLERANCE = 1e-6; // General tolerance for floating point comparisons
+const RELATIVE_TANGENCY_TOLERANCE = 1e-7; // Tangency tolerance as a fraction of the smaller radius
+const RELATIVE_MATCH_TOLERANCE = 1e-6; // Point matching/dedupe tolerance as a fraction of the local radius
+const ROUNDOFF_TOLERANCE = 64 * Number.EPSILON; // Rounding error allowance relative to coordinate magnitude
+
+// Arc rendering constants
+const ARC_SEGMENT_RATIO = 0.12; // Ratio of circle radius to desired segment length
+const MIN_ARC_SEGMENT_LENGTH = 6; // Minimum segment length in pixels
+const MAX_ARC_SEGMENT_LENGTH = 30; // Maximum segment length in pixels
+const MIN_ARC_STEPS = 10; // Minimum number of steps for arc rendering
+const MAX_ARC_STEPS = 44; // Maximum number of steps for arc rendering
+
+// Geometry payload precision. Intersections are always computed in float64;
+// these modes only affect how finished outlines are stored in toJSON().
+const GEOMETRY_PRECISIONS = ['float64', 'float32', 'fixed'];
+const FIXED_POINT_RANGE = 2 ** 30; // Fixed-point steps per group extent (fits Int32 with headroom)
+
+// Circle intersection constants
+const STANDARD_INTERSECTION_COUNT = 6; // Expected intersection count for hexagonal packing
+
+// Which end of a neighbour's arc to share, keyed by neighbour offset (see _extendGroupWithNeighbours)
+const NEIGHBOUR_ARC_PREFERENCE = new Map([
+  [-1, 'start'],
+  [-2, 'end'],
+  [-5, 'end'],
+  [-6, 'start'],
+]);
+
+// Default colors
+const DEFAULT_OUTLINE_COLOR = '#000000'; // Black outline for group boundaries
+
+// Validation constants
+const MIN_P = 2; // Minimum value for p parameter
+const MAX_P = 256; // Maximum value for p parameter (practical limit)
+const MIN_Q = 2; // Minimum value for q parameter
+const MAX_Q = 256; // Maximum value for q parameter (practical limit)
+const MAX_STREAM_P = 1024; // Maximum p for ring-streamed rendering (renderStream)
+const MAX_STREAM_Q = 1024; // Maximum q for ring-streamed rendering (renderStream)
+const MIN_MAX_DISTANCE = 10; // Minimum max_d value
+const MAX_MAX_DISTANCE = 50000; // Maximum max_d value (practical limit)
+
 // ------------------------------------------------------------
 // Complex arithmetic helpers
 // ------------------------------------------------------------
 
+/**
+ * Complex number utilities for geometric computations.
+ * All methods are pure functions that don't modify inputs.
+ * @namespace Complex
+ */
 const Complex = {
+  /**
+   * Creates a new complex number.
+   * @param {number} [re=0] - Real part
+   * @param {number} [im=0] - Imaginary part
+   * @returns {{re: number, im: number}} Complex number
+   */
   create(re = 0, im = 0) {
     return { re, im };
   },
 
+  /**
+   * Creates a copy of a complex number.
+   * @param {{re: number, im: number}} z - Complex number to clone
+   * @returns {{re: number, im: number}} New complex number
+   */
   clone(z) {
     return { re: z.re, im: z.im };
   },
 
+  /**
+   * Adds two complex numbers.
+   * @param {{re: number, im: number}} a - First operand
+   * @param {{re: number, im: number}} b - Second operand
+   * @returns {{re: number, im: number}} Sum a + b
+   */
   add(a, b) {
     return { re: a.re + b.re, im: a.im + b.im };
   },
 
+  /**
+   * Subtracts two complex numbers.
+   * @param {{re: number, im: number}} a - First operand
+   * @param {{re: number, im: number}} b - Second operand
+   * @returns {{re: number, im: number}} Difference a - b
+   */
   sub(a, b) {
     return { re: a.re - b.re, im: a.im - b.im };
   },
 
+  /**
+   * Multiplies two complex numbers.
+   * @param {{re: number, im: number}} a - First operand
+   * @param {{re: number, im: number}} b - Second operand
+   * @returns {{re: number, im: number}} Product a * b
+   */
   mul(a, b) {
     return {
       re: a.re * b.re - a.im * b.im,
@@ -196,6 +278,610 @@ function normaliseVector(vec) {
   return { x: vec.x / length, y: vec.y / length };
 }
 
+function normaliseAngle360(angleDeg) {
+  if (!Number.isFinite(angleDeg)) {
+    return 0;
+  }
+  let value = angleDeg % 360;
+  if (value < 0) {
+    value += 360;
+  }
+  return value;
+}
+
+function normaliseAngleRad(angle) {
+  if (!Number.isFinite(angle)) {
+    return 0;
+  }
+  const twoPi = Math.PI * 2;
+  let value = angle % twoPi;
+  if (value < 0) {
+    value += twoPi;
+  }
+  return value;
+}
+
+function angularDistanceRad(a, b) {
+  const normA = normaliseAngleRad(a);
+  const normB = normaliseAngleRad(b);
+  const diff = Math.abs(normA - normB);
+  const twoPi = Math.PI * 2;
+  return Math.min(diff, twoPi - diff);
+}
+
+function dedupeAngles(values, maxCount = 3) {
+  const seen = new Set();
+  const result = [];
+  for (const value of values) {
+    if (!Number.isFinite(value)) {
+      continue;
+    }
+    const normalized = normaliseAngle360(value);
+    const key = normalized.toFixed(6);
+    if (seen.has(key)) {
+      continue;
+    }
+    seen.add(key);
+    result.push(value);
+    if (result.length >= maxCount) {
+      break;
+    }
+  }
+  return result;
+}
+
+/**
+ * Animation metadata for one group (outline centroid in polar form), or null
+ * for outer closure groups and degenerate outlines.
+ */
+function patternAnimationMeta(group) {
+  if (!group || (group.name && group.name.startsWith('outer_'))) {
+    return null;
+  }
+  const outline = group.getClosedOutline();
+  if (!outline || outline.length < 3) {
+    return null;
+  }
+  const polygon = outline.map(pt => ({ x: pt.re, y: pt.im }));
+  const centroid = polygonCentroid(polygon);
+  if (!Number.isFinite(centroid.x) || !Number.isFinite(centroid.y)) {
+    return null;
+  }
+  const ringIndex = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
+  return {
+    id: group.id,
+    group,
+    ringIndex,
+    centroid,
+    radius: Math.hypot(centroid.x, centroid.y),
+    theta: Math.atan2(centroid.y, centroid.x),
+    neighbors: new Set(),
+  };
+}
+
+/**
+ * Animation metadata for one arcgroups entry of a toJSON() payload (plain or
+ * packed outlines). The entry stands in for the group, so contexts built from
+ * a worker's geometry drive the same generators as the engine's own groups.
+ */
+function patternAnimationMetaFromEntry(entry) {
+  const points = decodeOutline(entry);
+  if (points.length < 3) {
+    return null;
+  }
+  const centroid = polygonCentroid(points.map(([x, y]) => ({ x, y })));
+  if (!Number.isFinite(centroid.x) || !Number.isFinite(centroid.y)) {
+    return null;
+  }
+  const ringIndex = Number.isFinite(entry.ring_index) ? entry.ring_index : 0;
+  return {
+    id: entry.id,
+    group: { id: entry.id, name: entry.name, ringIndex },
+    ringIndex,
+    centroid,
+    radius: Math.hypot(centroid.x, centroid.y),
+    theta: Math.atan2(centroid.y, centroid.x),
+    neighbors: new Set(),
+  };
+}
+
+function buildPatternAnimationContext(arcGroups) {
+  return linkPatternAnimationContext(Array.from(arcGroups.values(), patternAnimationMeta));
+}
+
+/**
+ * Builds the pattern animation context from a toJSON() geometry payload, with
+ * metaList in the order of geometry.arcgroups.
+ */
+function buildPatternAnimationContextFromGeometry(geometry) {
+  return linkPatternAnimationContext((geometry?.arcgroups || []).map(patternAnimationMetaFromEntry));
+}
+
+function linkPatternAnimationContext(metas) {
+  const metaList = [];
+  const ringMap = new Map();
+  let minRing = Infinity;
+  let maxRing = -Infinity;
+
+  for (const meta of metas) {
+    if (!meta) {
+      continue;
+    }
+    const { ringIndex } = meta;
+    metaList.push(meta);
+    if (!ringMap.has(ringIndex)) {
+      ringMap.set(ringIndex, []);
+    }
+    ringMap.get(ringIndex).push(meta);
+    if (ringIndex < minRing) {
+      minRing = ringIndex;
+    }
+    if (ringIndex > maxRing) {
+      maxRing = ringIndex;
+    }
+  }
+
+  if (!metaList.length) {
+    return {
+      metaList: [],
+      ringMap: new Map(),
+      sortedRings: [],
+      minRing: 0,
+      maxRing: 0,
+    };
+  }
+
+  const sortedRings = Array.from(ringMap.keys()).sort((a, b) => a - b);
+  for (const ring of sortedRings) {
+    const metas = ringMap.get(ring);
+    metas.sort((a, b) => a.theta - b.theta);
+    if (metas.length > 1) {
+      for (let idx = 0; idx < metas.length; idx += 1) {
+        const prev = metas[(idx - 1 + metas.length) % metas.length];
+        const next = metas[(idx + 1) % metas.length];
+        metas[idx].neighbors.add(prev);
+        metas[idx].neighbors.add(next);
+      }
+    }
+  }
+
+  for (let idx = 0; idx < sortedRings.length; idx += 1) {
+    const current = ringMap.get(sortedRings[idx]);
+    const prevRing = idx > 0 ? ringMap.get(sortedRings[idx - 1]) : null;
+    const nextRing = idx < sortedRings.length - 1 ? ringMap.get(sortedRings[idx + 1]) : null;
+    if (prevRing) {
+      linkRingNeighbors(current, prevRing, 2);
+    }
+    if (nextRing) {
+      linkRingNeighbors(current, nextRing, 2);
+    }
+  }
+
+  return { metaList, ringMap, sortedRings, minRing, maxRing };
+}
+
+// Angular distances closer than this count as a tie and keep ring order, so
+// centroids decoded from float32 outlines link neighbours in the same order.
+const NEIGHBOUR_TIE_TOLERANCE_RAD = 1e-6;
+
+function linkRingNeighbors(source, target, maxConnections = 2) {
+  if (!source || !target || !source.length || !target.length) {
+    return;
+  }
+  for (const meta of source) {
+    const distance = new Map(target.map(other => [other, angularDistanceRad(meta.theta, other.theta)]));
+    const sorted = target
+      .slice()
+      .sort((a, b) => {
+        const diff = distance.get(a) - distance.get(b);
+        return Math.abs(diff) <= NEIGHBOUR_TIE_TOLERANCE_RAD ? 0 : diff;
+      });
+    const limit = Math.min(maxConnections, sorted.length);
+    for (let idx = 0; idx < limit; idx += 1) {
+      const neighbor = sorted[idx];
+      meta.neighbors.add(neighbor);
+      neighbor.neighbors.add(meta);
+    }
+  }
+}
+
+function computeBreadthFirstSteps(context) {
+  const seeds = context.metaList.filter(meta => meta.ringIndex === context.minRing);
+  const visited = new Set();
+  const steps = new Map();
+  let frontier = seeds.slice();
+  let step = 0;
+  const maxIterations = Math.max(context.metaList.length * 4, 1);
+
+  while (frontier.length && step < maxIterations) {
+    const next = [];
+    for (const meta of frontier) {
+      if (visited.has(meta)) {
+        continue;
+      }
+      visited.add(meta);
+      steps.set(meta.id, step);
+    }
+    for (const meta of frontier) {
+      for (const neighbor of meta.neighbors) {
+        if (!visited.has(neighbor)) {
+          next.push(neighbor);
+        }
+      }
+    }
+    frontier = next;
+    step += 1;
+  }
+
+  if (steps.size < context.metaList.length) {
+    let fallbackStep = step;
+    for (const meta of context.metaList) {
+      if (steps.has(meta.id)) {
+        continue;
+      }
+      steps.set(meta.id, fallbackStep);
+      fallbackStep += 1;
+    }
+    step = fallbackStep;
+  }
+
+  const maxStep = steps.size ? Math.max(...steps.values()) : 0;
+  return { steps, maxStep, seeds };
+}
+
+function patternAnimationRingCycle(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  for (const ring of context.sortedRings) {
+    const metas = context.ringMap.get(ring) || [];
+    metas.forEach((meta, index) => {
+      const angle = ring * baseAngle + index * 8 + phaseShift;
+      assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+    });
+  }
+  return assignments;
+}
+
+function patternAnimationRingPingPong(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  for (const ring of context.sortedRings) {
+    const metas = (context.ringMap.get(ring) || []).slice();
+    const direction = ring % 2 === 0 ? 1 : -1;
+    if (direction < 0) {
+      metas.reverse();
+    }
+    metas.forEach((meta, index) => {
+      const angle = ring * baseAngle + index * 10 + (direction < 0 ? 5 : 0) + phaseShift;
+      assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+    });
+  }
+  return assignments;
+}
+
+function patternAnimationRadialBloom(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  // A ring-streamed render passes the spiral-wide maximum in with a single-ring context.
+  const maxRadius = context.maxRadius
+    ?? (context.metaList.reduce((acc, meta) => Math.max(acc, meta.radius), 0) || 1);
+  context.metaList.forEach(meta => {
+    const radiusRatio = meta.radius / maxRadius;
+    const wobble = Math.sin(normaliseAngleRad(meta.theta) * 3) * 5;
+    const angle = meta.ringIndex * baseAngle + radiusRatio * 90 + wobble + phaseShift;
+    assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+  });
+  return assignments;
+}
+
+function patternAnimationCAWavefront(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  const { steps } = computeBreadthFirstSteps(context);
+  const stepGap = 12;
+  context.metaList.forEach(meta => {
+    const step = steps.get(meta.id) ?? 0;
+    const jitter = (meta.neighbors.size % 3) * 2;
+    const angle = meta.ringIndex * baseAngle + step * stepGap + jitter + phaseShift;
+    assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+  });
+  return assignments;
+}
+
+/**
+ * Spiral vortex: angles follow the polar angle (theta) creating a spinning vortex effect.
+ * Groups at the same angular position light up together, creating radial spokes that rotate.
+ */
+function patternAnimationSpiralVortex(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  context.metaList.forEach(meta => {
+    // Convert theta to degrees and use it directly for angle
+    const thetaDeg = normaliseAngle360(meta.theta * (180 / Math.PI));
+    // Add ring-based offset for depth effect
+    const ringOffset = meta.ringIndex * 3;
+    const angle = thetaDeg + ringOffset + meta.ringIndex * baseAngle + phaseShift;
+    assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+  });
+  return assignments;
+}
+
+/**
+ * Diamond pulse: creates a diamond/checkerboard pattern that pulses outward.
+ * Alternates based on ring index and position within ring.
+ */
+function patternAnimationDiamondPulse(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  for (const ring of context.sortedRings) {
+    const metas = context.ringMap.get(ring) || [];
+    metas.forEach((meta, index) => {
+      // Create checkerboard pattern: alternate based on ring + position parity
+      const parity = (ring + index) % 2;
+      const phase = parity * 45; // 45-degree offset between alternating cells
+      const radialPulse = meta.radius * 15; // Pulse outward based on distance
+      const angle = phase + radialPulse + meta.ringIndex * baseAngle + phaseShift;
+      assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+    });
+  }
+  return assignments;
+}
+
+/**
+ * Fibonacci spiral: angles follow a golden spiral pattern, creating organic flow.
+ * Uses the golden angle (~137.5°) to distribute angles naturally.
+ */
+function patternAnimationFibonacciSpiral(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  const goldenAngle = 137.507764; // Golden angle in degrees
+
+  // Sort by distance from center for consistent ordering
+  const sorted = [...context.metaList].sort((a, b) => a.radius - b.radius);
+
+  sorted.forEach((meta, index) => {
+    // Each successive element rotates by the golden angle
+    const fibAngle = (index * goldenAngle) % 360;
+    // Add subtle ring-based variation
+    const ringVar = Math.sin(meta.ringIndex * 0.5) * 10;
+    const angle = fibAngle + ringVar + meta.ringIndex * baseAngle + phaseShift;
+    assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+  });
+  return assignments;
+}
+
+/**
+ * Spiral arm sweep: hatch angle sweeps outward along each logarithmic spiral arm.
+ * Cells at the same polar angle activate together; the wave propagates radially
+ * outward, and each arm fires at a distinct phase proportional to its angular
+ * position, so the animation reads as distinct arms sweeping one after another.
+ */
+function patternAnimationSpiralArmSweep(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+  const phaseShift = Number.isFinite(opts.phaseOffset) ? opts.phaseOffset * 180 : 0;
+  const armStep = 18;
+  context.metaList.forEach(meta => {
+    const thetaNorm = normaliseAngle360(meta.theta * (180 / Math.PI));
+    const armOffset = thetaNorm * 0.5;
+    const radialProgress = meta.ringIndex * armStep;
+    const angle = armOffset + radialProgress + meta.ringIndex * baseAngle + phaseShift;
+    assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+  });
+  return assignments;
+}
+
+/**
+ * Zigzag sweep: one ring is active per frame step.
+ * On each ring, every 2nd group is lit; the offset shifts by 1 each ring so
+ * even rings light indices 0,2,4… and odd rings light indices 1,3,5…
+ * Outward pass covers the first full ring → outermost ring.
+ * Return pass covers the same rings back inward but with the opposite offset,
+ * lighting the groups that were skipped on the way up.
+ * All groups outside the active ring are OFF.
+ */
+function _zigzagDetectP(sortedByRadius) {
+  if (sortedByRadius.length < 4) return 2;
+  const angDist = (a, b) => { const d = Math.abs(a - b); return Math.min(d, 2 * Math.PI - d); };
+  const testCount = Math.min(10, Math.floor(sortedByRadius.length / 20));
+  const startOffset = Math.floor(sortedByRadius.length * 0.1);
+  let bestP = 2, bestScore = Infinity;
+  for (let p = 2; p <= 20; p++) {
+    if (startOffset + p * testCount >= sortedByRadius.length) break;
+    let total = 0;
+    for (let t = 0; t < testCount; t++) {
+      const i = startOffset + t * 3;
+      total += angDist(sortedByRadius[i].theta, sortedByRadius[i + p].theta);
+    }
+    if (total < bestScore) { bestScore = total; bestP = p; }
+  }
+  return bestP;
+}
+
+function _zigzagBuildBands(context) {
+  const metas = context.metaList.filter(m => m.ringIndex >= 0);
+  if (!metas.length) return { bands: [], p: 2 };
+  const sorted = metas.slice().sort((a, b) => a.radius - b.radius);
+  const p = _zigzagDetectP(sorted);
+  const bands = [];
+  for (let i = 0; i < sorted.length; i += p) {
+    const band = sorted.slice(i, i + p);
+    // Sort within band by angle for consistent every-2nd selection
+    band.sort((a, b) => a.theta - b.theta);
+    bands.push(band);
+  }
+  // Outermost bands first so the animation starts at the visible (large-radius) end
+  bands.reverse();
+  return { bands, p };
+}
+
+function patternAnimationZigzagSnake(context, opts = {}) {
+  const assignments = new Map();
+  const baseAngle = Number.isFinite(opts.baseAngle) ? opts.baseAngle : 0;
+
+  const { bands, p } = _zigzagBuildBands(context);
+  if (!bands.length) return assignments;
+
+  // Window width: show p consecutive bands at once so the snake is visually prominent.
+  // Within each band, activate every 2nd group (alternating offset per band).
+  const window = Math.max(1, p);
+  const totalSteps = bands.length;
+  const activeStep = Math.min(Math.floor(opts.phaseOffset * totalSteps), totalSteps - 1);
+
+  // Forward pass outward, return pass inward — ping-pong over band positions.
+  // activeStep maps to a "lead band" index; show window bands behind the lead.
+  const isReturn = opts.phaseOffset >= 0.5;
+  const leadIdx = isReturn ? totalSteps - 1 - Math.floor((opts.phaseOffset - 0.5) * 2 * totalSteps) : activeStep;
+  const clampedLead = Math.max(0, Math.min(totalSteps - 1, leadIdx));
+
+  const activeIds = new Set();
+  for (let w = 0; w < window; w++) {
+    const bandIdx = clampedLead - w;
+    if (bandIdx < 0) break;
+    const band = bands[bandIdx];
+    const offset = bandIdx % 2;
+    for (let i = 0; i < band.length; i++) {
+      if (i % 2 === offset) activeIds.add(band[i].id);
+    }
+  }
+
+  const angle = baseAngle + clampedLead * 3;
+  context.metaList.forEach(meta => {
+    if (activeIds.has(meta.id)) {
+      assignments.set(meta.id, { primaryAngle: angle, angles: [angle] });
+    } else {
+      assignments.set(meta.id, { primaryAngle: 0, angles: [] });
+    }
+  });
+
+  return assignments;
+}
+
+function zigzagSnakeStepCount(context) {
+  const { bands } = _zigzagBuildBands(context);
+  return bands.length > 0 ? bands.length : 1;
+}
+
+// `ringLocal` presets only look at one ring at a time (plus context.maxRadius),
+// so a ring-streamed render can evaluate them without the whole spiral.
+const PATTERN_ANIMATION_DEFINITIONS = {
+  radial_bloom: { label: 'Radial bloom', generator: patternAnimationRadialBloom, ringLocal: true },
+  ring_cycle: { label: 'Ring cycle chase', generator: patternAnimationRingCycle, ringLocal: true },
+  ring_pingpong: { label: 'Alternating ring sweep', generator: patternAnimationRingPingPong, ringLocal: true },
+  ca_wavefront: { label: 'Cellular wavefront', generator: patternAnimationCAWavefront },
+  spiral_vortex: { label: 'Spiral vortex', generator: patternAnimationSpiralVortex, ringLocal: true },
+  diamond_pulse: { label: 'Diamond pulse', generator: patternAnimationDiamondPulse, ringLocal: true },
+  fibonacci_spiral: { label: 'Fibonacci spiral', generator: patternAnimationFibonacciSpiral },
+  spiral_arm_sweep: { label: 'Spiral arm sweep', generator: patternAnimationSpiralArmSweep, ringLocal: true },
+  zigzag_snake: { label: 'Zigzag snake', generator: patternAnimationZigzagSnake, stepCount: zigzagSnakeStepCount },
+};
+
+const DEFAULT_PATTERN_ANIMATION = 'radial_bloom';
+
+function normalisePatternAnimationId(value) {
+  if (typeof value !== 'string') {
+    return DEFAULT_PATTERN_ANIMATION;
+  }
+  const key = value.toLowerCase();
+  return PATTERN_ANIMATION_DEFINITIONS[key] ? key : DEFAULT_PATTERN_ANIMATION;
+}
+
+function applyPatternAnimationToGroups(arcGroups, { animationId, baseAngle, loopMode = false, phaseOffset = 0 } = {}) {
+  if (!arcGroups || typeof arcGroups.values !== 'function') {
+    return new Map();
+  }
+  const context = buildPatternAnimationContext(arcGroups);
+  return resolvePatternAssignments(context, { animationId, baseAngle, loopMode, phaseOffset });
+}
+
+function resolvePatternAssignments(context, { animationId, baseAngle, loopMode = false, phaseOffset = 0 } = {}) {
+  const resolvedId = normalisePatternAnimationId(animationId);
+  const baseAngleValue = Number.isFinite(baseAngle) ? baseAngle : 0;
+  const generator = PATTERN_ANIMATION_DEFINITIONS[resolvedId]?.generator
+    || PATTERN_ANIMATION_DEFINITIONS[DEFAULT_PATTERN_ANIMATION].generator;
+
+  const rawFwd = generator(context, { baseAngle: baseAngleValue, phaseOffset }) || new Map();
+
+  const assignments = new Map();
+  for (const meta of context.metaList) {
+    const fallback = (meta.ringIndex ?? 0) * baseAngleValue;
+    const entryFwd = rawFwd.get(meta.id) || { primaryAngle: fallback, angles: [fallback] };
+    const primary = Number.isFinite(entryFwd.primaryAngle) ? entryFwd.primaryAngle : fallback;
+    let angleList;
+    if (loopMode) {
+      const norm = ((primary % 180) + 180) % 180;
+      const fwdAngle = norm / 2;
+      const bwdAngle = (180 - norm) / 2 + 90;
+      angleList = Math.abs(fwdAngle - bwdAngle) > 5 ? [fwdAngle, bwdAngle] : [fwdAngle];
+    } else {
+      // Preserve empty arrays (cell OFF) — do not substitute a fallback angle.
+      angleList = Array.isArray(entryFwd.angles)
+        ? (entryFwd.angles.length ? entryFwd.angles.slice() : [])
+        : [primary];
+    }
+    assignments.set(meta.id, {
+      primaryAngle: primary,
+      angles: angleList,
+    });
+  }
+  return assignments;
+}
+
+/**
+ * Generates a sequence of per-group angle assignment maps for animating a preset
+ * through a full forward + reverse (ping-pong) loop. `source` is an arcGroups
+ * map or an already built pattern animation context.
+ * Returns Array<Map<id, {primaryAngle, angles}>> with 2*numFrames-2 entries.
+ */
+function generatePresetAnimationFrames(source, { animationId, baseAngle } = {}, numFrames = 20) {
+  let context;
+  if (Array.isArray(source?.metaList)) {
+    context = source;
+  } else if (source && typeof source.values === 'function') {
+    context = buildPatternAnimationContext(source);
+  } else {
+    return [];
+  }
+  const resolvedId = normalisePatternAnimationId(animationId);
+  const baseAngleValue = Number.isFinite(baseAngle) ? baseAngle : 0;
+  const def = PATTERN_ANIMATION_DEFINITIONS[resolvedId]
+    || PATTERN_ANIMATION_DEFINITIONS[DEFAULT_PATTERN_ANIMATION];
+  const generator = def.generator;
+
+  // Discrete-step animations declare their natural step count; use it instead of
+  // the spacing-derived numFrames so line spacing doesn't affect animation speed.
+  const naturalSteps = typeof def.stepCount === 'function' ? def.stepCount(context) : null;
+  const fwdFrames = naturalSteps != null ? naturalSteps : numFrames;
+
+  const frames = [];
+  // Forward pass: phaseOffset 0 → 1 (exclusive of 1 to avoid duplicate at wrap-around)
+  for (let i = 0; i < fwdFrames; i++) {
+    const phaseOffset = i / fwdFrames;
+    const raw = generator(context, { baseAngle: baseAngleValue, phaseOffset }) || new Map();
+    const frame = new Map();
+    for (const meta of context.metaList) {
+      const fallback = (meta.ringIndex ?? 0) * baseAngleValue;
+      const entry = raw.get(meta.id) || { primaryAngle: fallback, angles: [fallback] };
+      const primary = Number.isFinite(entry.primaryAngle) ? entry.primaryAngle : fallback;
+      // Preserve empty arrays (cell OFF) — do not substitute a fallback angle.
+      frame.set(meta.id, { primaryAngle: primary, angles: Array.isArray(entry.angles) ? entry.angles.slice(0, 1) : [primary] });
+    }
+    frames.push(frame);
+  }
+  // Reverse pass: skip first and last to avoid duplicates at loop points
+  for (let i = fwdFrames - 2; i >= 1; i--) {
+    frames.push(frames[i]);
+  }
+  return frames;
+}
+
 function inwardNormal(direction, orientationSign) {
   if (orientationSign >= 0) {
     return { x: -direction.y, y: direction.x };
@@ -319,6 +1005,33 @@ function insetPolygon(points, offset) {
   return cleaned;
 }
 
+function estimateArcSteps(circle, start, end) {
+  if (!circle || circle.radius <= 0 || !start || !end) {
+    return 12;
+  }
+  const center = circle.center || Complex.ZERO;
+  const startAngle = Complex.angle(Complex.sub(start, center));
+  const endAngle = Complex.angle(Complex.sub(end, center));
+  let delta = (endAngle - startAngle) % (2 * Math.PI);
+  if (delta < 0) {
+    delta += 2 * Math.PI;
+  }
+  if (delta > Math.PI) {
+    delta = 2 * Math.PI - delta;
+  }
+  const arcLength = Math.abs(delta) * circle.radius;
+  if (!Number.isFinite(arcLength) || arcLength <= 0) {
+    return 12;
+  }
+  const desiredSegmentLength = clamp(
+    circle.radius * ARC_SEGMENT_RATIO,
+    MIN_ARC_SEGMENT_LENGTH,
+    MAX_ARC_SEGMENT_LENGTH
+  );
+  const rawSteps = Math.ceil(arcLength / desiredSegmentLength);
+  return clamp(rawSteps, MIN_ARC_STEPS, MAX_ARC_STEPS);
+}
+
 function lineSegmentIntersection(p1, p2, p3, p4) {
   const x1 = p1.x;
   const y1 = p1.y;
@@ -390,6 +1103,7 @@ function linesInPolygon(polygonPoints, spacing, angleDeg, offset = 0) {
   if (!polygonPoints || polygonPoints.length < 3) {
     return [];
   }
+
   const spacingAbs = Math.abs(spacing);
   if (spacingAbs < 1e-9) {
     return [];
@@ -400,103 +1114,108 @@ function linesInPolygon(polygonPoints, spacing, angleDeg, offset = 0) {
     return [];
   }
 
-  const orientation = polygonSignedArea(working) >= 0 ? 1 : -1;
-
   const angle = degToRad(angleDeg);
-  const lineDir = { x: Math.cos(angle), y: Math.sin(angle) };
-  const perpDir = { x: -lineDir.y, y: lineDir.x };
+  const cosAngle = Math.cos(angle);
+  const sinAngle = Math.sin(angle);
+
+  const rotatePoint = point => ({
+    x: point.x * cosAngle + point.y * sinAngle,
+    y: -point.x * sinAngle + point.y * cosAngle,
+  });
+
+  const unrotatePoint = point => ({
+    x: point.x * cosAngle - point.y * sinAngle,
+    y: point.x * sinAngle + point.y * cosAngle,
+  });
+
+  const rotated = working.map(rotatePoint);
+  const centroid = polygonCentroid(working);
+  const centroidRot = rotatePoint(centroid);
 
-  let minX = Infinity;
   let minY = Infinity;
-  let maxX = -Infinity;
   let maxY = -Infinity;
-  for (const p of working) {
-    minX = Math.min(minX, p.x);
-    minY = Math.min(minY, p.y);
-    maxX = Math.max(maxX, p.x);
-    maxY = Math.max(maxY, p.y);
+  for (const pt of rotated) {
+    if (pt.y < minY) {
+      minY = pt.y;
+    }
+    if (pt.y > maxY) {
+      maxY = pt.y;
+    }
   }
 
-  const bboxDiag = Math.hypot(maxX - minX, maxY - minY);
-  if (!Number.isFinite(bboxDiag) || bboxDiag <= 0) {
+  if (!Number.isFinite(minY) || !Number.isFinite(maxY) || maxY - minY < 1e-9) {
+    return [];
+  }
+
+  const edges = [];
+  const count = rotated.length;
+  for (let i = 0; i < count; i += 1) {
+    const a = rotated[i];
+    const b = rotated[(i + 1) % count];
+    const dy = b.y - a.y;
+    if (Math.abs(dy) < 1e-9) {
+      continue;
+    }
+    const minEdgeY = Math.min(a.y, b.y);
+    const maxEdgeY = Math.max(a.y, b.y);
+    edges.push({
+      x1: a.x,
+      y1: a.y,
+      dx: b.x - a.x,
+      dy,
+      invDy: 1 / dy,
+      minY: minEdgeY,
+      maxY: maxEdgeY,
+    });
+  }
+
+  if (!edges.length) {
     return [];
   }
-  const centroid = polygonCentroid(working);
-  const span = { x: lineDir.x * bboxDiag * 2, y: lineDir.y * bboxDiag * 2 };
-  const startBase = { x: centroid.x - span.x, y: centroid.y - span.y };
-  const endBase = { x: centroid.x + span.x, y: centroid.y + span.y };
 
   const effectiveSpacing = Math.max(spacingAbs, 1e-6);
-  const numLines = Math.floor(bboxDiag / effectiveSpacing) + 3;
+  const startIndex = Math.floor((minY - centroidRot.y) / effectiveSpacing) - 1;
+  const endIndex = Math.ceil((maxY - centroidRot.y) / effectiveSpacing) + 1;
+
   const segments = [];
-  for (let i = -numLines; i <= numLines; i += 1) {
-    const offsetX = perpDir.x * effectiveSpacing * i;
-    const offsetY = perpDir.y * effectiveSpacing * i;
-    const start = { x: startBase.x + offsetX, y: startBase.y + offsetY };
-    const end = { x: endBase.x + offsetX, y: endBase.y + offsetY };
-    const intersections = findLinePolygonIntersections(
-      start,
-      end,
-      working,
-      lineDir,
-      orientation,
-    );
-    if (intersections.length < 2) {
+  for (let idx = startIndex; idx <= endIndex; idx += 1) {
+    const yLine = centroidRot.y + idx * effectiveSpacing;
+    if (yLine < minY - effectiveSpacing || yLine > maxY + effectiveSpacing) {
       continue;
     }
 
-    const merged = [];
-    const GROUP_TOL = 1e-8;
-    for (const entry of intersections) {
-      const last = merged[merged.length - 1];
-      if (
-        last &&
-        Math.abs(entry.t - last.t) <= GROUP_TOL &&
-        entry.classification === last.classification
-      ) {
-        last.point.x = (last.point.x * last.count + entry.point.x) / (last.count + 1);
-        last.point.y = (last.point.y * last.count + entry.point.y) / (last.count + 1);
-        last.t = (last.t * last.count + entry.t) / (last.count + 1);
-        last.count += 1;
-      } else {
-        merged.push({
-          t: entry.t,
-          point: { x: entry.point.x, y: entry.point.y },
-          classification: entry.classification,
-          count: 1,
-        });
+    const intersections = [];
+    for (const edge of edges) {
+      if (yLine < edge.minY || yLine >= edge.maxY) {
+        continue;
       }
+      const t = (yLine - edge.y1) * edge.invDy;
+      const x = edge.x1 + edge.dx * t;
+      intersections.push(x);
     }
 
-    if (merged.length < 2) {
+    if (intersections.length < 2) {
       continue;
     }
 
-    let activeStart = polygonContains(start, working)
-      ? { x: start.x, y: start.y }
-      : null;
+    intersections.sort((a, b) => a - b);
 
-    for (const entry of merged) {
-      const { point, classification } = entry;
-      if (classification > 0) {
-        if (!activeStart) {
-          activeStart = { x: point.x, y: point.y };
-        }
-      } else if (classification < 0) {
-        if (!activeStart) {
-          activeStart = { x: point.x, y: point.y };
-        }
-        if (
-          activeStart &&
-          Math.hypot(activeStart.x - point.x, activeStart.y - point.y) >= 1e-6
-        ) {
-          segments.push([
-            { x: activeStart.x, y: activeStart.y },
-            { x: point.x, y: point.y },
-          ]);
-        }
-        activeStart = null;
+    for (let i = 0; i + 1 < intersections.length; i += 2) {
+      const xStart = intersections[i];
+      const xEnd = intersections[i + 1];
+      if (!Number.isFinite(xStart) || !Number.isFinite(xEnd)) {
+        continue;
+      }
+      if (Math.abs(xStart - xEnd) < 1e-6) {
+        continue;
       }
+
+      const startPoint = unrotatePoint({ x: xStart, y: yLine });
+      const endPoint = unrotatePoint({ x: xEnd, y: yLine });
+      segments.push([
+        { x: startPoint.x, y: startPoint.y },
+        { x: endPoint.x, y: endPoint.y },
+      ]);
     }
   }
 
@@ -504,69 +1223,374 @@ function linesInPolygon(polygonPoints, spacing, angleDeg, offset = 0) {
 }
 
 // ------------------------------------------------------------
-// Geometry primitives
+// Fill kernels
 // ------------------------------------------------------------
 
-let CIRCLE_ID = 0;
-
-class CircleElement {
-  constructor(center, radius, visible = true) {
-    this.center = complexFrom(center);
-    this.radius = radius;
-    this.visible = visible;
-    this.id = ++CIRCLE_ID;
-    this.intersections = [];
-    this.neighbours = new Set();
+// Distance from `centre` to the nearest polygon edge.
+function polygonInradius(polygon, centre) {
+  let best = Infinity;
+  for (let i = 0; i < polygon.length; i += 1) {
+    const a = polygon[i];
+    const b = polygon[(i + 1) % polygon.length];
+    const dx = b.x - a.x;
+    const dy = b.y - a.y;
+    const lenSq = dx * dx + dy * dy;
+    const t = lenSq > 0 ? clamp(((centre.x - a.x) * dx + (centre.y - a.y) * dy) / lenSq, 0, 1) : 0;
+    best = Math.min(best, Math.hypot(a.x + dx * t - centre.x, a.y + dy * t - centre.y));
   }
+  return best;
+}
 
-  _getIntersectionPoints(other, tol = 1e-6) {
-    const d = Complex.abs(Complex.sub(this.center, other.center));
-    const r1 = this.radius;
-    const r2 = other.radius;
-    if (d > r1 + r2 + tol || d < Math.abs(r1 - r2) - tol || d < tol) {
-      return [];
-    }
-    const a = (r1 * r1 - r2 * r2 + d * d) / (2 * d);
-    const hSq = r1 * r1 - a * a;
-    if (hSq < -tol) {
-      return [];
-    }
-    const h = Math.sqrt(Math.max(hSq, 0));
-    const mid = Complex.add(
-      this.center,
-      Complex.mulScalar(Complex.sub(other.center, this.center), a / d),
-    );
-    const perpUnit = Complex.mulScalar(Complex.sub(other.center, this.center), 1 / d);
-    const perp = { re: -perpUnit.im, im: perpUnit.re };
-    const p1 = Complex.add(mid, Complex.mulScalar(perp, h));
-    if (h < tol) {
-      return [p1];
+// Splits a sampled curve into the runs that lie inside `polygon`.
+function clipPolylineToPolygon(points, polygon) {
+  const runs = [];
+  let run = [];
+  for (const point of points) {
+    if (polygonContains(point, polygon)) {
+      run.push(point);
+    } else if (run.length) {
+      if (run.length > 1) runs.push(run);
+      run = [];
     }
-    const p2 = Complex.sub(mid, Complex.mulScalar(perp, h));
-    return [p1, p2];
   }
+  if (run.length > 1) runs.push(run);
+  return runs;
+}
 
-  computeIntersections(circles, startReference = Complex.ZERO, tol = 1e-3) {
-    this.intersections = [];
-    this.neighbours.clear();
-    const seen = new Set();
+function concentricRings(polygon, spacing, _angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  const inradius = polygonInradius(working, centre);
+  if (!(inradius > 1e-9)) {
+    return [];
+  }
+  // Rings are scaled copies about the centroid, `spacing` apart where the
+  // outline is closest to it; the outline itself is left to the stroke.
+  const rings = [];
+  for (let k = 1; k * spacing < inradius; k += 1) {
+    const scale = 1 - (k * spacing) / inradius;
+    const ring = working.map(point => ({
+      x: centre.x + (point.x - centre.x) * scale,
+      y: centre.y + (point.y - centre.y) * scale,
+    }));
+    ring.push(ring[0]);
+    rings.push(ring);
+  }
+  return rings;
+}
 
-    for (const other of circles) {
-      if (other === this) {
-        continue;
-      }
-      const pts = this._getIntersectionPoints(other, tol);
-      for (const pt of pts) {
-        const key = `${pt.re.toFixed(6)}_${pt.im.toFixed(6)}`;
-        if (!seen.has(key)) {
-          this.intersections.push([pt, other]);
-          seen.add(key);
-          this.neighbours.add(other);
-        }
+function spiralFill(polygon, spacing, angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  let reach = 0;
+  for (const point of working) {
+    reach = Math.max(reach, Math.hypot(point.x - centre.x, point.y - centre.y));
+  }
+  // Archimedean spiral, `spacing` between turns, started at the hatch angle
+  // and sampled at chords of about a quarter spacing.
+  const phase = degToRad(angleDeg);
+  const points = [{ x: centre.x, y: centre.y }];
+  const growth = spacing / (2 * Math.PI);
+  for (let theta = 0; growth * theta <= reach;) {
+    const radius = growth * theta;
+    theta += Math.min(0.5, (spacing / 4) / Math.max(radius, spacing));
+    const r = growth * theta;
+    points.push({ x: centre.x + r * Math.cos(theta + phase), y: centre.y + r * Math.sin(theta + phase) });
+  }
+  return clipPolylineToPolygon(points, working);
+}
+
+function stippleDashes(polygon, spacing, angleDeg, offset) {
+  const working = insetPolygon(polygon, offset);
+  if (working.length < 3) {
+    return [];
+  }
+  const centre = polygonCentroid(working);
+  const cos = Math.cos(degToRad(angleDeg));
+  const sin = Math.sin(degToRad(angleDeg));
+  let reach = 0;
+  for (const point of working) {
+    reach = Math.max(reach, Math.hypot(point.x - centre.x, point.y - centre.y));
+  }
+  // Hexagonal grid of short dashes along the hatch angle; a dash cuts as a
+  // dot with any real tool, and keeps the exporters on plain segments.
+  const rowStep = spacing * Math.sqrt(3) / 2;
+  const half = spacing * 0.1;
+  const rows = Math.ceil(reach / rowStep);
+  const cols = Math.ceil(reach / spacing) + 1;
+  const dashes = [];
+  for (let j = -rows; j <= rows; j += 1) {
+    const v = j * rowStep;
+    const shift = (j & 1) ? spacing / 2 : 0;
+    for (let i = -cols; i <= cols; i += 1) {
+      const u = i * spacing + shift;
+      const x = centre.x + u * cos - v * sin;
+      const y = centre.y + u * sin + v * cos;
+      const start = { x: x - half * cos, y: y - half * sin };
+      const end = { x: x + half * cos, y: y + half * sin };
+      if (polygonContains(start, working) && polygonContains(end, working)) {
+        dashes.push([start, end]);
       }
     }
+  }
+  return dashes;
+}
+
+/**
+ * Fill kernels by pattern type. `build(polygon, spacing, angleDeg, offset)`
+ * returns polylines (arrays of {x, y}; plain hatch lines are two-point
+ * polylines) in the polygon's own space, so ArcGroup builds each kernel once
+ * per ring template and maps the result to every group of the ring.
+ *
+ * - `usesAngle`: false when the fill looks the same at every angle, so one
+ *   template entry serves all of them.
+ * - `svg`: how drawGroupOutline() writes it: 'lines' (one <line> each),
+ *   'rectangles' (an outlined bar around each line) or 'path' (one batched
+ *   <path> per group and angle).
+ * - `previewAngles(angle)`: angles of the <pattern> fills that stand in for
+ *   the kernel in preview renders, or null to draw it explicitly.
+ */
+const FILL_KERNELS = {
+  lines: {
+    usesAngle: true,
+    svg: 'lines',
+    build: linesInPolygon,
+    previewAngles: angle => [angle],
+  },
+  rectangles: {
+    usesAngle: true,
+    svg: 'rectangles',
+    build: linesInPolygon,
+    previewAngles: null,
+  },
+  crosshatch: {
+    usesAngle: true,
+    svg: 'path',
+    build: (polygon, spacing, angleDeg, offset) => [
+      ...linesInPolygon(polygon, spacing, angleDeg, offset),
+      ...linesInPolygon(polygon, spacing, angleDeg + 90, offset),
+    ],
+    previewAngles: angle => [angle, angle + 90],
+  },
+  concentric: {
+    usesAngle: false,
+    svg: 'path',
+    build: concentricRings,
+    previewAngles: null,
+  },
+  spiral: {
+    usesAngle: true,
+    svg: 'path',
+    build: spiralFill,
+    previewAngles: null,
+  },
+  stipple: {
+    usesAngle: true,
+    svg: 'path',
+    build: stippleDashes,
+    previewAngles: null,
+  },
+};
+
+const FILL_PATTERN_TYPES = Object.keys(FILL_KERNELS);
+
+function fillKernel(patternType) {
+  return FILL_KERNELS[patternType] || FILL_KERNELS.lines;
+}
+
+/**
+ * Fill polylines for a polygon given directly in drawing space (groups
+ * without a ring template, tile renders).
+ */
+function fillPatternPolylines(patternType, polygon, spacing, angleDeg, offset = 0) {
+  return fillKernel(patternType).build(polygon, spacing, angleDeg, offset);
+}
+
+// ------------------------------------------------------------
+// Geometry primitives
+// ------------------------------------------------------------
+
+// Counters for geometric fallback paths. Reset by renderSpiral for every render
+// and exposed through getGeometryStats() so slow-path regressions are visible.
+// The outline counters describe the emitted groups, counted once each by
+// renderSpiral, not every outline pass (masters and rebuilds are not counted).
+const GEOMETRY_STATS = {
+  tangencySnaps: 0, // pairs within tolerance of tangency, emitted as a single contact point
+  duplicateIntersections: 0, // intersections dropped because an equal point was already recorded
+  proximityAttachments: 0, // arcs of emitted groups joined by getClosedOutline's nearest-endpoint fallback
+  openOutlines: 0, // emitted groups whose outline end did not meet its start
+  hatchComputed: 0, // hatch sets generated with linesInPolygon for a ring template
+  hatchReused: 0, // hatch sets served from a ring template's cache
+  hatchAngleError: 0, // largest hatch angle change from quantisation, in degrees
+  hatchRimDeviation: 0, // largest hatch line end displacement from quantisation, in geometry units
+  hatchRimDeviationMm: 0, // hatchRimDeviation in drawing units (mm), filled in by renderSpiral
+  arcsMaterialized: 0, // arcs whose point arrays were built (the rest stayed descriptors)
+};
+
+function resetGeometryStats() {
+  for (const key of Object.keys(GEOMETRY_STATS)) {
+    GEOMETRY_STATS[key] = 0;
+  }
+}
+
+function getGeometryStats() {
+  return { ...GEOMETRY_STATS };
+}
+
+function countOutlineJoins(arcGroups) {
+  for (const [key, group] of arcGroups.entries()) {
+    if (key.startsWith('outer_')) {
+      continue;
+    }
+    group.getClosedOutline();
+    const joins = group.outlineJoins;
+    if (!joins) {
+      continue;
+    }
+    GEOMETRY_STATS.proximityAttachments += joins.proximityAttachments;
+    if (joins.open) {
+      GEOMETRY_STATS.openOutlines += 1;
+    }
+  }
+}
+
+/**
+ * Tolerance used to classify the relative position of two circles. It scales
+ * with the smaller radius so tiny centre circles are not swallowed by an
+ * absolute epsilon, and never drops below the rounding error of the inputs.
+ *
+ * The intersection code relies on such tolerances, not on exact or adaptive
+ * predicates. Packed circles touch only up to rounding, so an exact sign of
+ * the gap would call every contact either a crossing or a miss.
+ */
+function tangencyTolerance(x1, y1, r1, x2, y2, r2) {
+  const magnitude = Math.abs(x1) + Math.abs(y1) + Math.abs(x2) + Math.abs(y2) + r1 + r2;
+  return Math.max(RELATIVE_TANGENCY_TOLERANCE * Math.min(r1, r2), ROUNDOFF_TOLERANCE * magnitude);
+}
+
+/**
+ * Intersection points of two circles.
+ *
+ * Tangency is decided on the signed gap between the circles rather than on the
+ * chord half-length, and for crossing pairs a and h are evaluated in factored
+ * form to avoid the cancellation in r1² - r2² and r1² - a² when the radii
+ * differ by orders of magnitude. Tangent pairs yield exactly one point.
+ */
+function circleIntersection(x1, y1, r1, x2, y2, r2) {
+  const dx = x2 - x1;
+  const dy = y2 - y1;
+  const d = Math.sqrt(dx * dx + dy * dy);
+  const eps = tangencyTolerance(x1, y1, r1, x2, y2, r2);
+  if (d <= eps) {
+    return [];
+  }
+  const outerGap = d - (r1 + r2);
+  const innerGap = Math.abs(r1 - r2) - d;
+  if (outerGap > eps || innerGap > eps) {
+    return [];
+  }
+  if (outerGap >= -eps || innerGap >= -eps) {
+    GEOMETRY_STATS.tangencySnaps += 1;
+    return [tangentContact(x1, y1, r1, r2, dx, dy)];
+  }
+  const ux = dx / d;
+  const uy = dy / d;
+  const a = ((r1 - r2) * (r1 + r2) + d * d) / (2 * d);
+  const h = Math.sqrt(Math.max((r1 - a) * (r1 + a), 0));
+  const midX = x1 + ux * a;
+  const midY = y1 + uy * a;
+  return [
+    { re: midX - uy * h, im: midY + ux * h },
+    { re: midX + uy * h, im: midY - ux * h },
+  ];
+}
+
+/**
+ * Contact point of a tangent pair, evaluated exactly as the original
+ * intersection formula did: the foot of the chord plus the roundoff-sized
+ * half-chord to the left of the centre line (at most sqrt(2·r·gap) off it).
+ *
+ * That offset is noise, but it is what picks the start contact of a circle:
+ * its two contacts nearest the spiral centre are often at the same distance,
+ * and finalizeIntersections() takes the nearer one. Putting the contact on
+ * the centre line turns that into a roundoff tie and rotates the arc selection
+ * of a third of the circles in every non-closest arc mode, so the classic
+ * placement is kept and the designs stay the same as before.
+ */
+function tangentContact(x1, y1, r1, r2, dx, dy) {
+  const dSq = dx * dx + dy * dy;
+  const d = Math.sqrt(dSq);
+  const a = (r1 * r1 - r2 * r2 + dSq) / (2 * d);
+  const h = Math.sqrt(Math.max(r1 * r1 - a * a, 0));
+  const ratio = a / d;
+  const ux = dx / d;
+  const uy = dy / d;
+  return { re: x1 + dx * ratio - uy * h, im: y1 + dy * ratio + ux * h };
+}
+
+let CIRCLE_ID = 0;
+
+class CircleElement {
+  // `id` is unique across engines; `seed` is the circle's place in its own
+  // spiral and drives everything that should look the same on every render
+  // (random arc selection, debug colours).
+  constructor(center, radius, visible = true, id = null, seed = null) {
+    this.center = complexFrom(center);
+    this.radius = radius;
+    this.visible = visible;
+    this.id = id ?? ++CIRCLE_ID;
+    this.seed = seed ?? this.id;
+    this.intersections = [];
+    this.neighbours = new Set();
+    this._collectingIntersections = false;
+    this._orderedNeighbours = null;
+  }
 
+  _getIntersectionPoints(other) {
+    return circleIntersection(
+      this.center.re,
+      this.center.im,
+      this.radius,
+      other.center.re,
+      other.center.im,
+      other.radius,
+    );
+  }
+
+  resetIntersections() {
+    this.intersections = [];
+    this.neighbours.clear();
+    this._collectingIntersections = true;
+    this._orderedNeighbours = null;
+  }
+
+  addIntersection(point, other) {
+    if (!point || !other || !this._collectingIntersections) {
+      return;
+    }
+    // Intersections per circle are few, so compare distances directly instead of
+    // rounding to a fixed decimal grid (which both splits near-equal points
+    // straddling a grid line and merges distinct points on tiny circles).
+    const tol = RELATIVE_MATCH_TOLERANCE * this.radius;
+    for (const [existing] of this.intersections) {
+      if (Math.abs(existing.re - point.re) <= tol && Math.abs(existing.im - point.im) <= tol) {
+        GEOMETRY_STATS.duplicateIntersections += 1;
+        return;
+      }
+    }
+    this.intersections.push([point, other]);
+    this.neighbours.add(other);
+  }
+
+  finalizeIntersections(startReference = Complex.ZERO) {
     if (!this.intersections.length) {
+      this._collectingIntersections = false;
       return;
     }
 
@@ -594,6 +1618,24 @@ class CircleElement {
       const angB = Complex.angle(Complex.sub(b[0], c));
       return clockwiseOffset(angA) - clockwiseOffset(angB);
     });
+
+    this._collectingIntersections = false;
+  }
+
+  computeIntersections(circles, startReference = Complex.ZERO) {
+    this.resetIntersections();
+
+    for (const other of circles) {
+      if (other === this) {
+        continue;
+      }
+      const pts = this._getIntersectionPoints(other);
+      for (const pt of pts) {
+        this.addIntersection(pt, other);
+      }
+    }
+
+    this.finalizeIntersections(startReference);
   }
 
   getNeighbourCircles(k = null, spiralCenter = Complex.ZERO, clockwise = true, tieByDistance = true) {
@@ -601,6 +1643,17 @@ class CircleElement {
     if (!neighbours.length) {
       return [];
     }
+    const scRe = (spiralCenter && spiralCenter.re) || 0;
+    const scIm = (spiralCenter && spiralCenter.im) || 0;
+    const cacheable =
+      k === null &&
+      clockwise === true &&
+      tieByDistance === true &&
+      Math.abs(scRe) < 1e-9 &&
+      Math.abs(scIm) < 1e-9;
+    if (cacheable && this._orderedNeighbours) {
+      return this._orderedNeighbours;
+    }
     if (k !== null && neighbours.length > k) {
       neighbours.sort((a, b) => {
         const da = Complex.abs(Complex.sub(a.center, this.center));
@@ -631,22 +1684,66 @@ class CircleElement {
     if (clockwise) {
       neighbours.reverse();
     }
+    if (cacheable) {
+      this._orderedNeighbours = neighbours;
+    }
     return neighbours;
   }
 }
 
 class ArcElement {
-  constructor(circle, start, end, steps = 40, visible = true) {
+  static _shapeCache = new Map();
+
+  // Keyed on the exact sweep: a rounded key would hand an arc whichever
+  // nearby sweep was sampled first, so its points would depend on the order
+  // arcs (and earlier renders) were built in.
+  static _getShape(steps, delta) {
+    const key = `${steps}|${delta}`;
+    if (ArcElement._shapeCache.has(key)) {
+      return ArcElement._shapeCache.get(key);
+    }
+    const count = Math.max(1, steps | 0);
+    const coords = new Float64Array(count * 2);
+    if (count === 1) {
+      coords[0] = 1;
+      coords[1] = 0;
+    } else {
+      for (let i = 0; i < count; i += 1) {
+        const t = i / (count - 1);
+        const angle = delta * t;
+        coords[i * 2] = Math.cos(angle);
+        coords[i * 2 + 1] = Math.sin(angle);
+      }
+    }
+    ArcElement._shapeCache.set(key, coords);
+    return coords;
+  }
+
+  // Arcs are descriptors: the step count and the sampled points are computed
+  // on first use. Most groups take their outline and hatch from the ring
+  // template, so the points of their arcs are never read.
+  constructor(circle, start, end, steps = null, visible = true) {
     this.circle = circle;
     this.start = complexFrom(start);
     this.end = complexFrom(end);
-    this.steps = Math.max(1, steps | 0);
+    this._steps = steps === null ? null : Math.max(1, steps | 0);
     this.visible = visible;
     this._pointsCache = null;
+    this._pointsSource = null; // template transform the cached points were built from
+    this.owner = null; // ArcGroup that lists this arc; set by ArcGroup.addArc
+    this.ownerIndex = -1;
+  }
+
+  get steps() {
+    if (this._steps === null) {
+      this._steps = estimateArcSteps(this.circle, this.start, this.end);
+    }
+    return this._steps;
   }
 
   _invalidate() {
     this._pointsCache = null;
+    this._pointsSource = null;
   }
 
   setStart(value) {
@@ -667,16 +1764,42 @@ class ArcElement {
 
   setSteps(value) {
     const newValue = Math.max(1, value | 0);
-    if (this.steps !== newValue) {
-      this.steps = newValue;
+    if (this._steps !== newValue) {
+      this._steps = newValue;
       this._invalidate();
     }
   }
 
   getPoints() {
-    if (this._pointsCache) {
+    // Points follow the owner's ring template when it has one, so assigning a
+    // template to a group needs no per-arc work; the cache is rebuilt when the
+    // transform it came from changes.
+    const owner = this.owner;
+    const transform = owner?.template ? owner.templateTransform : null;
+    const bases = transform ? owner.template.normalizedArcs?.[this.ownerIndex] : null;
+    const source = bases ? transform : null;
+    if (this._pointsCache && this._pointsSource === source) {
       return this._pointsCache;
     }
+    GEOMETRY_STATS.arcsMaterialized += 1;
+    this._pointsSource = source;
+    if (bases) {
+      const { cos, sin, radius, center } = transform;
+      const total = bases.length / 2;
+      const points = new Array(total);
+      for (let idx = 0; idx < bases.length; idx += 2) {
+        const x = bases[idx];
+        const y = bases[idx + 1];
+        const rx = x * cos - y * sin;
+        const ry = x * sin + y * cos;
+        points[idx / 2] = {
+          re: center.re + rx * radius,
+          im: center.im + ry * radius,
+        };
+      }
+      this._pointsCache = points;
+      return points;
+    }
     const c = this.circle.center;
     const r = this.circle.radius;
     const a1 = Complex.angle(Complex.sub(this.start, c));
@@ -685,22 +1808,83 @@ class ArcElement {
     if (delta > Math.PI) {
       delta -= 2 * Math.PI;
     }
-    const points = [];
-    if (this.steps === 1) {
-      points.push(Complex.add(c, Complex.mulScalar(Complex.expi(a1), r)));
-    } else {
-      for (let i = 0; i < this.steps; i += 1) {
-        const t = i / (this.steps - 1);
-        const angle = a1 + delta * t;
-        const point = Complex.add(c, Complex.mulScalar(Complex.expi(angle), r));
-        points.push(point);
-      }
+    const templatePoints = ArcElement._getShape(this.steps, delta);
+    const cosA = Math.cos(a1);
+    const sinA = Math.sin(a1);
+    const points = new Array(templatePoints.length / 2);
+    for (let idx = 0; idx < templatePoints.length; idx += 2) {
+      const baseX = templatePoints[idx];
+      const baseY = templatePoints[idx + 1];
+      const rotX = baseX * cosA - baseY * sinA;
+      const rotY = baseX * sinA + baseY * cosA;
+      points[idx / 2] = {
+        re: c.re + rotX * r,
+        im: c.im + rotY * r,
+      };
     }
     this._pointsCache = points;
     return points;
   }
 }
 
+/**
+ * Largest distance from a ring template's outline to the point hatch lines are
+ * anchored at, in template units. Rotating a hatch set by a small angle moves
+ * line ends by at most this times the sine of the angle.
+ */
+function templateRimRadius(template) {
+  if (template.rimRadius === undefined) {
+    const outline = template.normalizedOutline || [];
+    const points = [];
+    for (let idx = 0; idx + 1 < outline.length; idx += 2) {
+      points.push({ x: outline[idx], y: outline[idx + 1] });
+    }
+    const centre = polygonCentroid(points);
+    let radius = 0;
+    for (const point of points) {
+      radius = Math.max(radius, Math.hypot(point.x - centre.x, point.y - centre.y));
+    }
+    template.rimRadius = radius;
+  }
+  return template.rimRadius;
+}
+
+/**
+ * Map a pattern source (normalised template polylines plus a group
+ * transform) to world space one segment at a time, calling
+ * `visit(x1, y1, x2, y2)`. Consecutive segments of a polyline share their
+ * end points exactly. Degenerate and non-finite segments are skipped.
+ * Returns the number visited.
+ */
+function forEachSourceSegment(source, visit) {
+  const { segments } = source;
+  const { cos, sin, radius, center } = source.transform;
+  let count = 0;
+  for (let idx = 0; idx < segments.length; idx += 1) {
+    const polyline = segments[idx];
+    let x1 = 0;
+    let y1 = 0;
+    for (let k = 0; k < polyline.length; k += 1) {
+      const px = polyline[k].x * radius;
+      const py = polyline[k].y * radius;
+      const x2 = center.re + px * cos - py * sin;
+      const y2 = center.im + px * sin + py * cos;
+      if (k > 0) {
+        const dx = x2 - x1;
+        const dy = y2 - y1;
+        if (!Number.isFinite(dx) || !Number.isFinite(dy) || dx * dx + dy * dy <= 1e-12) {
+          continue;
+        }
+        visit(x1, y1, x2, y2);
+        count += 1;
+      }
+      x1 = x2;
+      y1 = y2;
+    }
+  }
+  return count;
+}
+
 class ArcGroup {
   static _idCounter = 0;
 
@@ -712,10 +1896,23 @@ class ArcGroup {
     this.debugFill = null;
     this.debugStroke = null;
     this.ringIndex = null;
+    this.baseCircle = null;
     this._outlineCache = null;
+    this.outlineJoins = null; // How the cached outline was joined: { proximityAttachments, open }
+    this.template = null;
+    this.templateTransform = null;
+    this.patternAngles = [];
+    this.primaryPatternAngle = 0;
+    this.cloneOf = null; // Reference to master group for symmetric optimization
+    this._rotationCache = null; // Cache for rotation parameters (cos, sin, angle)
+    this.outerArc = null; // Arc from the invisible outer circle that closes the outer edge
+    this.patternAngleStep = 0; // Quantisation step for hatch angles relative to the template (0 = exact)
+    this.fillKernel = 'lines'; // Fill pattern type (a FILL_KERNELS key) exporters read hatches with
   }
 
   addArc(arc) {
+    arc.owner = this;
+    arc.ownerIndex = this.arcs.length;
     this.arcs.push(arc);
     this._outlineCache = null;
   }
@@ -730,6 +1927,14 @@ class ArcGroup {
     return this.arcs.length === 0;
   }
 
+  setTemplate(template, transform, preserveCache = false) {
+    this.template = template || null;
+    this.templateTransform = transform || null;
+    if (!preserveCache) {
+      this._outlineCache = null;
+    }
+  }
+
   _matchPoints(a, b, tol = 1e-6) {
     return Complex.abs(Complex.sub(a, b)) <= tol;
   }
@@ -793,13 +1998,84 @@ class ArcGroup {
     return ordered.concat(reversed.slice(1));
   }
 
-  getClosedOutline(tol = 1e-3) {
+  /**
+   * Returns the group outline as a closed list of points. Arc endpoints are
+   * joined when they agree to within `tol`, which defaults to a small fraction
+   * of the group's circle radius so matching behaves the same for the tiny
+   * centre circles and the large rim circles.
+   */
+  getClosedOutline(tol = null) {
     if (this._outlineCache) {
       return this._outlineCache.slice();
     }
+
+    // Symmetric optimization: if this is a clone, compute rotated version of master outline
+    if (this.cloneOf && this.baseCircle && this.cloneOf.baseCircle) {
+      const masterOutline = this.cloneOf.getClosedOutline(tol);
+      if (masterOutline && masterOutline.length > 0) {
+        // Cache rotation parameters to avoid recomputation
+        if (!this._rotationCache) {
+          const masterCenter = this.cloneOf.baseCircle.center;
+          const myCenter = this.baseCircle.center;
+          const masterAngle = Math.atan2(masterCenter.im, masterCenter.re);
+          const myAngle = Math.atan2(myCenter.im, myCenter.re);
+          const rotationAngle = myAngle - masterAngle;
+          this._rotationCache = {
+            angle: rotationAngle,
+            cos: Math.cos(rotationAngle),
+            sin: Math.sin(rotationAngle)
+          };
+        }
+
+        const { cos: cosTheta, sin: sinTheta } = this._rotationCache;
+
+        // Apply rotation to each point
+        const rotatedOutline = [];
+        for (const pt of masterOutline) {
+          rotatedOutline.push({
+            re: pt.re * cosTheta - pt.im * sinTheta,
+            im: pt.re * sinTheta + pt.im * cosTheta
+          });
+        }
+
+        this._outlineCache = rotatedOutline.slice();
+        this.outlineJoins = this.cloneOf.outlineJoins;
+        return rotatedOutline.slice();
+      }
+    }
+
+    const templateArcCount = this.template?.arcPointCounts?.length
+      ?? this.template?.normalizedArcs?.length
+      ?? null;
+    const useTemplate =
+      this.template
+      && this.templateTransform
+      && this.template.normalizedOutline
+      && templateArcCount !== null
+      && templateArcCount === this.arcs.length;
+
+    if (useTemplate) {
+      const { normalizedOutline } = this.template;
+      const { cos, sin, radius, center } = this.templateTransform;
+      const points = [];
+      for (let idx = 0; idx < normalizedOutline.length; idx += 2) {
+        const x = normalizedOutline[idx];
+        const y = normalizedOutline[idx + 1];
+        const rx = x * cos - y * sin;
+        const ry = x * sin + y * cos;
+        points.push({ re: center.re + rx * radius, im: center.im + ry * radius });
+      }
+      this._outlineCache = points.slice();
+      this.outlineJoins = this.template.outlineJoins || null;
+      return points.slice();
+    }
     if (!this.arcs.length) {
       return [];
     }
+    if (tol === null) {
+      const radius = this.baseCircle?.radius || this.arcs[0].circle?.radius || 1;
+      tol = RELATIVE_MATCH_TOLERANCE * radius;
+    }
     const entries = this.arcs.map(arc => ({ arc, points: arc.getPoints().slice() }));
     entries.sort((a, b) => b.points.length - a.points.length);
 
@@ -825,21 +2101,201 @@ class ArcGroup {
       }
     }
 
+    let proximityAttachments = 0;
     for (let idx = 0; idx < entries.length; idx += 1) {
       if (used.has(idx)) {
         continue;
       }
+      proximityAttachments += 1;
       ordered = this._attachByProximity(ordered, entries[idx].points);
     }
 
-    if (ordered.length && this._matchPoints(ordered[0], ordered[ordered.length - 1], tol)) {
+    const closed = ordered.length > 0 && this._matchPoints(ordered[0], ordered[ordered.length - 1], tol);
+    if (closed) {
       ordered[ordered.length - 1] = ordered[0];
     }
 
+    this.outlineJoins = { proximityAttachments, open: ordered.length > 0 && !closed };
     this._outlineCache = ordered.slice();
     return ordered.slice();
   }
 
+  /**
+   * Fill polylines of one kernel and angle as normalised template polylines
+   * plus the transform that places them in world space. Only the template
+   * keeps the polylines; callers map them through the transform as they emit
+   * them. Returns null when the group has no usable template.
+   */
+  _getPatternSource(spacing, angleDeg, offset, patternType = this.fillKernel) {
+    // Symmetric optimization: a clone reuses its master's hatch, rotated about
+    // the spiral centre. The clone rotation adds `_rotationCache.angle` to the
+    // master's lines, so ask the master for `angleDeg - deltaDeg` and fold the
+    // rotation into the transform.
+    if (this.cloneOf && this._rotationCache) {
+      const deltaDeg = this._rotationCache.angle * (180 / Math.PI);
+      const master = this.cloneOf._getPatternSource(spacing, angleDeg - deltaDeg, offset, patternType);
+      if (master && master.segments.length > 0) {
+        const { cos, sin } = this._rotationCache;
+        const { transform } = master;
+        return {
+          segments: master.segments,
+          transform: {
+            cos: transform.cos * cos - transform.sin * sin,
+            sin: transform.sin * cos + transform.cos * sin,
+            radius: transform.radius,
+            center: {
+              re: transform.center.re * cos - transform.center.im * sin,
+              im: transform.center.re * sin + transform.center.im * cos,
+            },
+          },
+        };
+      }
+    }
+
+    const template = this.template;
+    const transform = this.templateTransform;
+    if (!template || !transform) {
+      return null;
+    }
+    const normalized = template.normalizedOutline;
+    if (!normalized || !normalized.length) {
+      return null;
+    }
+    const baseRadius =
+      template.baseRadius ||
+      transform.radius ||
+      this.baseCircle?.radius ||
+      this.arcs[0]?.circle?.radius ||
+      null;
+    if (!baseRadius || Math.abs(baseRadius) < 1e-9) {
+      return null;
+    }
+    if (!template.patternCache) {
+      template.patternCache = new Map();
+    }
+    const rotationDeg =
+      Math.atan2(transform.sin ?? 0, transform.cos ?? 1) * (180 / Math.PI);
+
+    const kernel = fillKernel(patternType);
+    const a = angleDeg - rotationDeg;
+    let normalizedAngleDeg = kernel.usesAngle ? ((a % 180) + 180) % 180 : 0;
+    const angleStep = this.patternAngleStep;
+    if (angleStep > 0 && kernel.usesAngle) {
+      // Snap the angle relative to the template so congruent groups with
+      // nearly equal hatch angles share one hatch set.
+      const snapped = (Math.round(normalizedAngleDeg / angleStep) * angleStep) % 180;
+      const errorDeg = Math.abs(snapped - normalizedAngleDeg) % 180;
+      const error = Math.min(errorDeg, 180 - errorDeg);
+      if (error > GEOMETRY_STATS.hatchAngleError) {
+        GEOMETRY_STATS.hatchAngleError = error;
+      }
+      const rim = templateRimRadius(template) * (transform.radius || baseRadius);
+      const deviation = rim * Math.sin(degToRad(error));
+      if (deviation > GEOMETRY_STATS.hatchRimDeviation) {
+        GEOMETRY_STATS.hatchRimDeviation = deviation;
+      }
+      normalizedAngleDeg = snapped;
+    }
+
+    const key = `${patternType}|${spacing.toFixed(6)}|${normalizedAngleDeg.toFixed(6)}|${offset.toFixed(6)}`;
+    let normalizedSegments = template.patternCache.get(key) || null;
+    if (normalizedSegments) {
+      GEOMETRY_STATS.hatchReused += 1;
+    } else {
+      GEOMETRY_STATS.hatchComputed += 1;
+      const transformRadius = transform.radius || baseRadius;
+      const spacingNorm = spacing / baseRadius;
+      const offsetClamped = Math.max(0, offset);
+
+      if (
+        !Number.isFinite(transformRadius)
+        || transformRadius <= 1e-9
+        || !Number.isFinite(spacingNorm)
+        || Math.abs(spacingNorm) < 1e-9
+      ) {
+        normalizedSegments = [];
+      } else {
+        const insetRadius = transformRadius - offsetClamped;
+        if (insetRadius <= 1e-9) {
+          normalizedSegments = [];
+        } else {
+          const scale = insetRadius / transformRadius;
+          const polygon = [];
+          for (let idx = 0; idx < normalized.length; idx += 2) {
+            polygon.push({ x: normalized[idx] * scale, y: normalized[idx + 1] * scale });
+          }
+          normalizedSegments = kernel.build(polygon, spacingNorm, normalizedAngleDeg, 0);
+        }
+      }
+
+      if (normalizedSegments && normalizedSegments.length) {
+        const filtered = [];
+        for (const segment of normalizedSegments) {
+          if (!segment || segment.length < 2) {
+            continue;
+          }
+          const start = segment[0];
+          const end = segment[segment.length - 1];
+          if (!start || !end) {
+            continue;
+          }
+          const dx = end.x - start.x;
+          const dy = end.y - start.y;
+          if (!Number.isFinite(dx) || !Number.isFinite(dy)) {
+            continue;
+          }
+          // Closed polylines (rings) end where they start
+          if (segment.length === 2 && dx * dx + dy * dy <= 1e-12) {
+            continue;
+          }
+          filtered.push(segment);
+        }
+        normalizedSegments = filtered;
+      }
+      template.patternCache.set(key, normalizedSegments);
+    }
+    return { segments: normalizedSegments || [], transform };
+  }
+
+  /**
+   * The outline shrunk towards the group's circle centre the way template
+   * hatches are inset by `offset` (world units). Used by preview fills.
+   */
+  _insetOutline(outline, offset) {
+    const circle = this.baseCircle || this.arcs[0]?.circle || null;
+    if (!(offset > 0) || !circle || !(circle.radius > 1e-9)) {
+      return outline;
+    }
+    const scale = (circle.radius - offset) / circle.radius;
+    if (scale <= 1e-9) {
+      return [];
+    }
+    const { re: cx, im: cy } = circle.center;
+    return outline.map(point => ({ re: cx + (point.re - cx) * scale, im: cy + (point.im - cy) * scale }));
+  }
+
+  /**
+   * Stream world-space hatch lines to `visit(x1, y1, x2, y2)` without
+   * building per-group arrays. Returns the number of lines visited, or -1
+   * when the group has no template.
+   */
+  forEachPatternSegment(spacing, angleDeg, offset, visit) {
+    const source = this._getPatternSource(spacing, angleDeg, offset);
+    return source ? forEachSourceSegment(source, visit) : -1;
+  }
+
+  /**
+   * World-space hatch lines as `[{re, im}, {re, im}]` pairs, built on demand
+   * for exporters that need whole arrays. Nothing is cached on the group.
+   */
+  getPatternSegments(spacing, angleDeg, offset) {
+    const segments = [];
+    const count = this.forEachPatternSegment(spacing, angleDeg, offset, (x1, y1, x2, y2) => {
+      segments.push([{ re: x1, im: y1 }, { re: x2, im: y2 }]);
+    });
+    return count < 0 ? null : segments;
+  }
+
   toSVGFill(context, {
     debug = false,
     fillOpacity = 0.25,
@@ -847,6 +2303,12 @@ class ArcGroup {
     lineSettings = [3, 0],
     drawOutline = true,
     lineOffset = 0,
+    patternType = 'lines',
+    rectWidth = 2,
+    patternSpacingOverride = null,
+    patternOffsetOverride = null,
+    outlineStrokeWidth = 0.6,
+    patternStrokeWidth = 0.5,
   } = {}) {
     const outline = this.getClosedOutline();
     if (!outline.length) {
@@ -854,52 +2316,220 @@ class ArcGroup {
     }
     if (debug) {
       const fill = this.debugFill || colorFromSeed(this.id);
-      const stroke = this.debugStroke || '#000000';
+      const stroke = this.debugStroke || DEFAULT_OUTLINE_COLOR;
       context.drawGroupOutline(outline, {
         fill,
         stroke,
-        strokeWidth: 0.8,
+        strokeWidth: outlineStrokeWidth,
         fillOpacity,
       });
       return;
     }
     if (patternFill) {
-      const stroke = this.debugStroke || '#000000';
-      context.drawGroupOutline(outline, {
-        fill: 'pattern',
-        stroke,
-        strokeWidth: 0.8,
-        linePatternSettings: lineSettings,
-        drawOutline,
-        lineOffset,
-      });
+      const stroke = this.debugStroke || DEFAULT_OUTLINE_COLOR;
+      const [lineSpacingRaw, lineAngleDeg] = lineSettings;
+      const scaleFactor = context?.scaleFactor ?? 0;
+      const invScale = scaleFactor > 1e-9 ? 1 / scaleFactor : 0;
+      const spacingForSegments = Number.isFinite(patternSpacingOverride)
+        ? patternSpacingOverride
+        : invScale > 0
+          ? lineSpacingRaw * invScale
+          : lineSpacingRaw;
+      const offsetForSegmentsBase = Number.isFinite(patternOffsetOverride)
+        ? patternOffsetOverride
+        : invScale > 0
+          ? lineOffset * invScale
+          : lineOffset;
+      let offsetForSegments = offsetForSegmentsBase;
+      if (patternType === 'rectangles') {
+        const rectWidthValue = Number.isFinite(rectWidth) ? Math.abs(rectWidth) : 0;
+        if (rectWidthValue > 0) {
+          offsetForSegments += rectWidthValue / 2;
+        }
+      }
+
+      // Support multiple angles from patternAngles array (up to 4)
+      // If patternAngles is explicitly empty, skip pattern rendering (cell is OFF)
+      const hasExplicitAngles = Array.isArray(this.patternAngles);
+      const anglesToRender = hasExplicitAngles && this.patternAngles.length > 0
+        ? this.patternAngles.slice(0, 4)
+        : hasExplicitAngles && this.patternAngles.length === 0
+          ? [] // Explicitly OFF - no pattern
+          : [lineAngleDeg]; // Default behavior
+
+      // Draw outline once first if needed
+      if (drawOutline) {
+        context.drawGroupOutline(outline, {
+          fill: null,
+          stroke,
+          strokeWidth: outlineStrokeWidth,
+        });
+      }
+
+      // Preview renders leave line clipping to the browser: one <pattern>
+      // per spacing/angle fills the (inset) outline, no segments are computed.
+      const previewAngles = fillKernel(patternType).previewAngles;
+      if (context.patternPreview && previewAngles) {
+        const fillOutline = this._insetOutline(outline, offsetForSegments);
+        for (const angleValue of anglesToRender) {
+          for (const previewAngle of previewAngles(angleValue)) {
+            context.drawPreviewPatternFill(fillOutline, {
+              spacing: spacingForSegments,
+              angle: previewAngle,
+              color: stroke,
+              strokeWidth: patternStrokeWidth,
+            });
+          }
+        }
+        return;
+      }
+
+      // Draw pattern lines for each angle (skip if cell is OFF)
+      for (const angleValue of anglesToRender) {
+        const source = this._getPatternSource(spacingForSegments, angleValue, offsetForSegments, patternType);
+        context.drawGroupOutline(outline, {
+          fill: 'pattern',
+          stroke: null,
+          strokeWidth: 0,
+          linePatternSettings: [lineSpacingRaw, angleValue],
+          drawOutline: false, // Already drawn above
+          lineOffset,
+          patternSource: source,
+          patternType,
+          rectWidth,
+          patternStrokeWidth,
+        });
+      }
       return;
     }
     if (drawOutline) {
       context.drawGroupOutline(outline, {
         fill: null,
-        stroke: '#000000',
-        strokeWidth: 0.6,
+        stroke: DEFAULT_OUTLINE_COLOR,
+        strokeWidth: outlineStrokeWidth,
       });
     }
   }
 }
 
+function buildContinuousPathsFromArcs(arcs, tol = 1e-6) {
+  if (!arcs || !arcs.length) {
+    return [];
+  }
+  const distance = (a, b) => {
+    if (!a || !b) {
+      return Number.POSITIVE_INFINITY;
+    }
+    const dx = (a.re ?? 0) - (b.re ?? 0);
+    const dy = (a.im ?? 0) - (b.im ?? 0);
+    return Math.hypot(dx, dy);
+  };
+  const dedupePoints = points => {
+    if (!points || !points.length) {
+      return [];
+    }
+    const filtered = [];
+    for (const point of points) {
+      if (!point) {
+        continue;
+      }
+      if (!filtered.length || distance(filtered[filtered.length - 1], point) > tol) {
+        filtered.push(point);
+      }
+    }
+    if (
+      filtered.length >= 2
+      && distance(filtered[0], filtered[filtered.length - 1]) <= tol
+    ) {
+      filtered[filtered.length - 1] = filtered[0];
+    }
+    return filtered;
+  };
+  const entries = arcs
+    .map(arc => (arc && typeof arc.getPoints === 'function' ? arc.getPoints().slice() : []))
+    .map(points => points.filter(Boolean));
+  const used = new Array(entries.length).fill(false);
+  const sequences = [];
+
+  for (let idx = 0; idx < entries.length; idx += 1) {
+    if (used[idx] || entries[idx].length < 2) {
+      continue;
+    }
+    used[idx] = true;
+    let sequence = entries[idx].slice();
+    let extended = true;
+    while (extended) {
+      extended = false;
+      for (let j = 0; j < entries.length; j += 1) {
+        if (used[j] || entries[j].length < 2) {
+          continue;
+        }
+        const candidate = entries[j];
+        const seqStart = sequence[0];
+        const seqEnd = sequence[sequence.length - 1];
+        const candStart = candidate[0];
+        const candEnd = candidate[candidate.length - 1];
+        if (distance(seqEnd, candStart) <= tol) {
+          sequence = sequence.concat(candidate.slice(1));
+          used[j] = true;
+          extended = true;
+          break;
+        }
+        if (distance(seqEnd, candEnd) <= tol) {
+          const reversed = candidate.slice().reverse();
+          sequence = sequence.concat(reversed.slice(1));
+          used[j] = true;
+          extended = true;
+          break;
+        }
+        if (distance(seqStart, candEnd) <= tol) {
+          sequence = candidate.slice(0, -1).concat(sequence);
+          used[j] = true;
+          extended = true;
+          break;
+        }
+        if (distance(seqStart, candStart) <= tol) {
+          const reversed = candidate.slice().reverse();
+          sequence = reversed.slice(0, -1).concat(sequence);
+          used[j] = true;
+          extended = true;
+          break;
+        }
+      }
+    }
+    const filtered = dedupePoints(sequence);
+    if (filtered.length >= 2) {
+      sequences.push(filtered);
+    }
+  }
+
+  return sequences;
+}
+
 // ------------------------------------------------------------
 // Drawing context
 // ------------------------------------------------------------
 
 class DrawingContext {
-  constructor(size = 800) {
-    this.size = size;
+  constructor(width = 800, height = null, units = '') {
+    const resolvedWidth = Number.isFinite(width) ? width : 800;
+    const resolvedHeight = Number.isFinite(height) ? height : resolvedWidth;
+    this.width = resolvedWidth;
+    this.height = resolvedHeight;
+    this.units = typeof units === 'string' ? units : '';
     this.scaleFactor = 1;
+    this.patternPreview = false; // Fill hatches with <pattern> defs instead of line segments
+    this._previewPatternIds = new Set();
     this.hasDOM = typeof document !== 'undefined' && !!document.createElementNS;
+    this._layers = null;        // Array of <g> elements when layering is enabled (DOM mode)
+    this._virtualLayers = null; // Array of string arrays when layering is enabled (virtual mode)
+    this._activeLayerIdx = -1;  // -1 means no active layer (use mainGroup / _virtualMain)
     if (this.hasDOM) {
       this.svg = document.createElementNS(SVG_NS, 'svg');
       this.svg.setAttribute('xmlns', SVG_NS);
-      this.svg.setAttribute('viewBox', `${-size / 2} ${-size / 2} ${size} ${size}`);
-      this.svg.setAttribute('width', size);
-      this.svg.setAttribute('height', size);
+      this.svg.setAttribute('viewBox', this._viewBox());
+      this.svg.setAttribute('width', this._formatLength(this.width));
+      this.svg.setAttribute('height', this._formatLength(this.height));
       this.defs = document.createElementNS(SVG_NS, 'defs');
       this.mainGroup = document.createElementNS(SVG_NS, 'g');
       this.svg.appendChild(this.defs);
@@ -908,9 +2538,53 @@ class DrawingContext {
       this.svg = null;
       this.defs = null;
       this.mainGroup = null;
+      this._virtualDefs = [];
+      this._virtualMain = [];
+    }
+  }
+
+  enableLayers(count) {
+    const n = Math.max(1, Math.floor(count));
+    if (this.hasDOM) {
+      this.svg.setAttribute('xmlns:inkscape', 'http://www.inkscape.org/namespaces/inkscape');
+      this._layers = [];
+      for (let i = 0; i < n; i++) {
+        const g = document.createElementNS(SVG_NS, 'g');
+        g.setAttribute('id', `layer_${i + 1}`);
+        g.setAttribute('inkscape:label', `Layer ${i + 1}`);
+        g.setAttribute('inkscape:groupmode', 'layer');
+        this._appendTarget.appendChild(g);
+        this._layers.push(g);
+      }
+    } else {
+      this._virtualLayers = Array.from({ length: n }, () => []);
+    }
+  }
+
+  setActiveLayer(idx) {
+    this._activeLayerIdx = idx;
+  }
+
+  get _appendTarget() {
+    if (this._layers && this._activeLayerIdx >= 0 && this._activeLayerIdx < this._layers.length) {
+      return this._layers[this._activeLayerIdx];
+    }
+    return this.mainGroup;
+  }
+
+  get _virtualAppendTarget() {
+    if (this._virtualLayers && this._activeLayerIdx >= 0 && this._activeLayerIdx < this._virtualLayers.length) {
+      return this._virtualLayers[this._activeLayerIdx];
     }
+    return this._virtualMain;
   }
 
+  /**
+   * Calculates and sets the scale factor to normalize spiral elements to fit within the canvas.
+   * The scale factor ensures the spiral maximally uses the available bounding box space.
+   *
+   * @param {Array} elements - Array of circle elements to normalize
+   */
   setNormalizationScale(elements) {
     if (!elements || !elements.length) {
       this.scaleFactor = 1;
@@ -930,38 +2604,107 @@ class DrawingContext {
       this.scaleFactor = 1;
       return;
     }
-    this.scaleFactor = (this.size / 2.1) / maxExtent;
-  }
-
-  _scaled(point) {
-    return {
-      x: point.re * this.scaleFactor,
-      y: point.im * this.scaleFactor,
-    };
+    const minDimension = Math.min(Math.abs(this.width), Math.abs(this.height));
+    if (!Number.isFinite(minDimension) || minDimension <= 0) {
+      this.scaleFactor = 1;
+      return;
+    }
+    // Use full bounding box (divide by 2.0 instead of 2.1) to maximize space usage
+    this.scaleFactor = (minDimension / 2.0) / maxExtent;
   }
 
-  drawScaledCircle(circle, { color = '#4CB39B', opacity = 0.8 } = {}) {
-    if (!this.hasDOM) {
+  /**
+   * Sets the scale factor using outer circle centers to define the bounding box.
+   * The outer circles form a ring around the visible pattern, and their centers
+   * define a bounding circle whose diameter determines the scale.
+   *
+   * @param {Array} outerCircles - Array of outer circle elements
+   */
+  setNormalizationScaleFromOuterCircles(outerCircles) {
+    if (!outerCircles || !outerCircles.length) {
+      this.scaleFactor = 1;
       return;
     }
-    if (!circle.visible) {
-      return;
+
+    // Find maximum distance from origin to any outer circle center
+    // This effectively finds the radius of the bounding circle
+    let maxDistance = 0;
+    for (const circle of outerCircles) {
+      const center = circle.center;
+      const dist = Math.sqrt(center.re * center.re + center.im * center.im);
+      maxDistance = Math.max(maxDistance, dist);
+    }
+
+    if (maxDistance === 0) {
+      this.scaleFactor = 1;
+      return;
+    }
+
+    const minDimension = Math.min(Math.abs(this.width), Math.abs(this.height));
+    if (!Number.isFinite(minDimension) || minDimension <= 0) {
+      this.scaleFactor = 1;
+      return;
+    }
+
+    // The bounding diameter is 2 * maxDistance, so radius is maxDistance
+    this.scaleFactor = (minDimension / 2.0) / maxDistance;
+  }
+
+  _scaled(point) {
+    return {
+      x: point.re * this.scaleFactor,
+      y: point.im * this.scaleFactor,
+    };
+  }
+
+  _formatLength(value) {
+    if (!Number.isFinite(value)) {
+      return '0';
+    }
+    return this.units ? `${value}${this.units}` : String(value);
+  }
+
+  _viewBox() {
+    return `${-this.width / 2} ${-this.height / 2} ${this.width} ${this.height}`;
+  }
+
+  _pushVirtual(tag, attributes, target = this._virtualAppendTarget) {
+    if (!target) {
+      return;
+    }
+    const attrString = Object.entries(attributes)
+      .filter(([, value]) => value !== null && value !== undefined)
+      .map(([key, value]) => `${key}="${String(value)}"`)
+      .join(' ');
+    target.push(`<${tag}${attrString ? ` ${attrString}` : ''} />`);
+  }
+
+  drawScaledCircle(circle, { color = '#4CB39B', opacity = 0.8 } = {}) {
+    if (!circle.visible) {
+      return;
     }
     const center = this._scaled(circle.center);
     const radius = circle.radius * this.scaleFactor;
+    if (!this.hasDOM) {
+      this._pushVirtual('circle', {
+        cx: center.x.toFixed(4),
+        cy: center.y.toFixed(4),
+        r: radius.toFixed(4),
+        fill: color,
+        'fill-opacity': opacity.toString(),
+      });
+      return;
+    }
     const element = document.createElementNS(SVG_NS, 'circle');
     element.setAttribute('cx', center.x.toFixed(4));
     element.setAttribute('cy', center.y.toFixed(4));
     element.setAttribute('r', radius.toFixed(4));
     element.setAttribute('fill', color);
     element.setAttribute('fill-opacity', opacity.toString());
-    this.mainGroup.appendChild(element);
+    this._appendTarget.appendChild(element);
   }
 
-  drawScaledArc(arc, { color = '#000000', width = 1.2 } = {}) {
-    if (!this.hasDOM) {
-      return;
-    }
+  drawScaledArc(arc, { color = DEFAULT_OUTLINE_COLOR, width = 1.2 } = {}) {
     if (!arc.visible) {
       return;
     }
@@ -969,20 +2712,31 @@ class DrawingContext {
     if (!points.length) {
       return;
     }
-    const path = document.createElementNS(SVG_NS, 'path');
     const commands = [];
     points.forEach((pt, idx) => {
       const scaled = this._scaled(pt);
       const prefix = idx === 0 ? 'M' : 'L';
       commands.push(`${prefix}${scaled.x.toFixed(4)},${scaled.y.toFixed(4)}`);
     });
+    if (!this.hasDOM) {
+      this._pushVirtual('path', {
+        d: commands.join(' '),
+        fill: 'none',
+        stroke: color,
+        'stroke-width': width.toString(),
+        'stroke-linecap': 'round',
+        'stroke-linejoin': 'round',
+      });
+      return;
+    }
+    const path = document.createElementNS(SVG_NS, 'path');
     path.setAttribute('d', commands.join(' '));
     path.setAttribute('fill', 'none');
     path.setAttribute('stroke', color);
     path.setAttribute('stroke-width', width.toString());
     path.setAttribute('stroke-linecap', 'round');
     path.setAttribute('stroke-linejoin', 'round');
-    this.mainGroup.appendChild(path);
+    this._appendTarget.appendChild(path);
   }
 
   drawScaled(shape, options = {}) {
@@ -993,77 +2747,437 @@ class DrawingContext {
     }
   }
 
+  drawPolyline(points, {
+    color = DEFAULT_OUTLINE_COLOR,
+    width = 1.2,
+    close = false,
+  } = {}) {
+    if (!points || points.length < 2) {
+      return;
+    }
+    const scaled = [];
+    const distance = (a, b) => {
+      if (!a || !b) {
+        return Number.POSITIVE_INFINITY;
+      }
+      const dx = a.x - b.x;
+      const dy = a.y - b.y;
+      return Math.hypot(dx, dy);
+    };
+    for (const point of points) {
+      if (!point) {
+        continue;
+      }
+      const scaledPoint = this._scaled(point);
+      if (!scaled.length || distance(scaled[scaled.length - 1], scaledPoint) > 1e-6) {
+        scaled.push(scaledPoint);
+      }
+    }
+    if (scaled.length < 2) {
+      return;
+    }
+    let shouldClose = Boolean(close);
+    const first = scaled[0];
+    const last = scaled[scaled.length - 1];
+    if (distance(first, last) <= 1e-6) {
+      scaled.pop();
+      shouldClose = true;
+    }
+    const commands = scaled.map((pt, idx) => {
+      const prefix = idx === 0 ? 'M' : 'L';
+      return `${prefix}${pt.x.toFixed(4)},${pt.y.toFixed(4)}`;
+    });
+    if (shouldClose) {
+      commands.push('Z');
+    }
+    const attributes = {
+      d: commands.join(' '),
+      fill: 'none',
+      stroke: color,
+      'stroke-width': width.toString(),
+      'stroke-linecap': 'round',
+      'stroke-linejoin': 'round',
+    };
+    if (!this.hasDOM) {
+      this._pushVirtual('path', attributes);
+      return;
+    }
+    const path = document.createElementNS(SVG_NS, 'path');
+    for (const [key, value] of Object.entries(attributes)) {
+      path.setAttribute(key, value);
+    }
+    this._appendTarget.appendChild(path);
+  }
+
+  /**
+   * Fills an outline with parallel lines through a shared <pattern> in
+   * <defs>, so the browser clips the hatch instead of the engine. Spacing is
+   * in world units, angle in degrees as for linesInPolygon(). The line phase
+   * follows the document origin rather than each group's template, so this
+   * is for previews only.
+   */
+  drawPreviewPatternFill(points, { spacing, angle, color = DEFAULT_OUTLINE_COLOR, strokeWidth = 0.5 }) {
+    const tile = spacing * this.scaleFactor;
+    const width = Number.isFinite(strokeWidth) ? Math.max(0, strokeWidth) : 0;
+    if (!points || points.length < 3 || !(tile > 1e-6) || width <= 0) {
+      return;
+    }
+    const colour = color || DEFAULT_OUTLINE_COLOR;
+    const angleText = (((angle % 180) + 180) % 180).toFixed(2);
+    const tileText = tile.toFixed(4);
+    // Ids are derived from the pattern itself, so SVGs inlined side by side
+    // can only collide on identical patterns.
+    const id = `hatch_${tileText}_${angleText}_${width}_${String(colour).replace(/[^0-9A-Za-z]/g, '')}`;
+    if (!this._previewPatternIds.has(id)) {
+      this._previewPatternIds.add(id);
+      const half = (tile / 2).toFixed(4);
+      const patternAttrs = {
+        id,
+        patternUnits: 'userSpaceOnUse',
+        width: tileText,
+        height: tileText,
+        patternTransform: `rotate(${angleText})`,
+      };
+      const lineAttrs = {
+        x1: '0', y1: half, x2: tileText, y2: half,
+        stroke: colour, 'stroke-width': String(width), 'stroke-linecap': 'butt',
+      };
+      if (!this.hasDOM) {
+        const attrText = attrs => Object.entries(attrs).map(([key, value]) => `${key}="${value}"`).join(' ');
+        this._virtualDefs.push(`<pattern ${attrText(patternAttrs)}><line ${attrText(lineAttrs)} /></pattern>`);
+      } else {
+        const pattern = document.createElementNS(SVG_NS, 'pattern');
+        for (const [key, value] of Object.entries(patternAttrs)) pattern.setAttribute(key, value);
+        const line = document.createElementNS(SVG_NS, 'line');
+        for (const [key, value] of Object.entries(lineAttrs)) line.setAttribute(key, value);
+        pattern.appendChild(line);
+        this.defs.appendChild(pattern);
+      }
+    }
+    const sf = this.scaleFactor;
+    let d = `M${(points[0].re * sf).toFixed(4)},${(points[0].im * sf).toFixed(4)}`;
+    for (let i = 1; i < points.length; i++) {
+      d += ` L${(points[i].re * sf).toFixed(4)},${(points[i].im * sf).toFixed(4)}`;
+    }
+    d += ' Z';
+    const attributes = { d, fill: `url(#${id})`, stroke: 'none' };
+    if (!this.hasDOM) {
+      this._pushVirtual('path', attributes);
+      return;
+    }
+    const path = document.createElementNS(SVG_NS, 'path');
+    for (const [key, value] of Object.entries(attributes)) path.setAttribute(key, value);
+    this._appendTarget.appendChild(path);
+  }
+
   drawGroupOutline(points, {
     fill = null,
-    stroke = '#000000',
+    stroke = DEFAULT_OUTLINE_COLOR,
     strokeWidth = 1.0,
     fillOpacity = 1.0,
     linePatternSettings = [3, 0],
     drawOutline = true,
     lineOffset = 0,
+    patternSource = null,
+    patternType = 'lines',
+    rectWidth = 2,
+    patternStrokeWidth = 0.5,
   } = {}) {
     if (!points || !points.length) {
       return;
     }
-    if (!this.hasDOM) {
-      return;
+    // Pre-allocate array and reuse scaleFactor to reduce allocations
+    const len = points.length;
+    const scaled = new Array(len);
+    const sf = this.scaleFactor;
+    for (let i = 0; i < len; i++) {
+      const pt = points[i];
+      scaled[i] = { x: pt.re * sf, y: pt.im * sf };
     }
-    const scaled = points.map(pt => this._scaled(pt));
+    const outlineStrokeWidth = Number.isFinite(strokeWidth) ? strokeWidth : 0;
+    const outlineStrokeWidthStr = outlineStrokeWidth.toString();
+    const patternStroke = Number.isFinite(patternStrokeWidth)
+      ? Math.max(0, patternStrokeWidth)
+      : 0;
+    const patternStrokeStr = patternStroke.toString();
+
+    const buildPathData = (pts, closePath = true) => {
+      if (!pts.length) {
+        return '';
+      }
+      // Optimize by building string directly instead of creating intermediate arrays
+      let path = `M${pts[0].x.toFixed(4)},${pts[0].y.toFixed(4)}`;
+      for (let i = 1; i < pts.length; i++) {
+        path += ` L${pts[i].x.toFixed(4)},${pts[i].y.toFixed(4)}`;
+      }
+      if (closePath && pts.length > 1) {
+        path += ' Z';
+      }
+      return path;
+    };
 
-    if (fill === 'pattern') {
-      const segments = linesInPolygon(
-        scaled,
-        linePatternSettings[0],
-        linePatternSettings[1],
-        lineOffset,
-      );
-      if (drawOutline) {
-        const polygon = document.createElementNS(SVG_NS, 'polygon');
-        polygon.setAttribute('points', scaled.map(p => `${p.x.toFixed(4)},${p.y.toFixed(4)}`).join(' '));
-        polygon.setAttribute('fill', 'none');
-        polygon.setAttribute('stroke', stroke || 'none');
-        polygon.setAttribute('stroke-width', strokeWidth.toString());
-        polygon.setAttribute('stroke-linejoin', 'round');
-        this.mainGroup.appendChild(polygon);
-      }
-      const lineColor = stroke || '#000000';
-      for (const [p1, p2] of segments) {
+    const createOutlineSegments = (pts, closeLoop = true) => {
+      if (!pts || pts.length < 2) {
+        return [];
+      }
+      const segments = [];
+      for (let i = 0; i < pts.length - 1; i += 1) {
+        const start = pts[i];
+        const end = pts[i + 1];
+        if (!start || !end) {
+          continue;
+        }
+        if (Math.hypot(end.x - start.x, end.y - start.y) <= 1e-9) {
+          continue;
+        }
+        segments.push([start, end]);
+      }
+      if (closeLoop && pts.length > 2) {
+        const first = pts[0];
+        const last = pts[pts.length - 1];
+        if (
+          first &&
+          last &&
+          Math.hypot(first.x - last.x, first.y - last.y) > 1e-9
+        ) {
+          segments.push([last, first]);
+        }
+      }
+      return segments;
+    };
+
+    const emitOutlineSegments = (segments, color) => {
+      if (!segments || !segments.length) {
+        return;
+      }
+      const strokeColor = color || 'none';
+      if (this.patternPreview) {
+        // One path per outline keeps the preview DOM small.
+        this.drawPolyline(points, { color: strokeColor, width: outlineStrokeWidth, close: true });
+        return;
+      }
+      if (!this.hasDOM) {
+        for (const [start, end] of segments) {
+          this._pushVirtual('line', {
+            x1: start.x.toFixed(4),
+            y1: start.y.toFixed(4),
+            x2: end.x.toFixed(4),
+            y2: end.y.toFixed(4),
+            stroke: strokeColor,
+            'stroke-width': outlineStrokeWidthStr,
+            'stroke-linecap': 'round',
+          });
+        }
+        return;
+      }
+      for (const [start, end] of segments) {
         const line = document.createElementNS(SVG_NS, 'line');
-        line.setAttribute('x1', p1.x.toFixed(4));
-        line.setAttribute('y1', p1.y.toFixed(4));
-        line.setAttribute('x2', p2.x.toFixed(4));
-        line.setAttribute('y2', p2.y.toFixed(4));
-        line.setAttribute('stroke', lineColor);
-        line.setAttribute('stroke-width', '0.5');
+        line.setAttribute('x1', start.x.toFixed(4));
+        line.setAttribute('y1', start.y.toFixed(4));
+        line.setAttribute('x2', end.x.toFixed(4));
+        line.setAttribute('y2', end.y.toFixed(4));
+        line.setAttribute('stroke', strokeColor);
+        line.setAttribute('stroke-width', outlineStrokeWidthStr);
         line.setAttribute('stroke-linecap', 'round');
-        this.mainGroup.appendChild(line);
+        this._appendTarget.appendChild(line);
+      }
+    };
+
+    const shouldDrawOutlineSegments =
+      drawOutline && stroke && outlineStrokeWidth > 0;
+    const outlineSegments = shouldDrawOutlineSegments
+      ? createOutlineSegments(scaled)
+      : null;
+
+    if (fill === 'pattern') {
+      // Visit each hatch line in drawing coordinates. Template hatches are
+      // mapped from their normalised segments as they are emitted, so no
+      // world-space copy is kept for the group.
+      let forEachLine;
+      if (patternSource !== null && patternSource !== undefined) {
+        forEachLine = visit => forEachSourceSegment(patternSource, (x1, y1, x2, y2) => {
+          visit(x1 * sf, y1 * sf, x2 * sf, y2 * sf);
+        });
+      } else {
+        const polylines = fillPatternPolylines(
+          patternType,
+          scaled,
+          linePatternSettings[0],
+          linePatternSettings[1],
+          lineOffset,
+        );
+        forEachLine = visit => {
+          for (const polyline of polylines) {
+            for (let k = 1; k < polyline.length; k += 1) {
+              visit(polyline[k - 1].x, polyline[k - 1].y, polyline[k].x, polyline[k].y);
+            }
+          }
+        };
+      }
+      if (outlineSegments) {
+        emitOutlineSegments(outlineSegments, stroke);
+      }
+      const lineColor = stroke || DEFAULT_OUTLINE_COLOR;
+      const patternStyle = fillKernel(patternType).svg;
+      if (patternStyle === 'path') {
+        // One batched path per group and angle; segments that continue a
+        // polyline extend the current subpath instead of starting a new one.
+        if (patternStroke > 0) {
+          const parts = [];
+          let lastX = NaN;
+          let lastY = NaN;
+          forEachLine((x1, y1, x2, y2) => {
+            const sx = x1.toFixed(4);
+            const sy = y1.toFixed(4);
+            if (sx !== lastX || sy !== lastY) {
+              parts.push(`M${sx},${sy}`);
+            }
+            lastX = x2.toFixed(4);
+            lastY = y2.toFixed(4);
+            parts.push(`L${lastX},${lastY}`);
+          });
+          if (parts.length) {
+            const hatchAttributes = {
+              d: parts.join(' '),
+              fill: 'none',
+              stroke: lineColor,
+              'stroke-width': patternStrokeStr,
+              'stroke-linecap': 'round',
+              'stroke-linejoin': 'round',
+            };
+            if (!this.hasDOM) {
+              this._pushVirtual('path', hatchAttributes);
+            } else {
+              const path = document.createElementNS(SVG_NS, 'path');
+              for (const [key, value] of Object.entries(hatchAttributes)) {
+                path.setAttribute(key, value);
+              }
+              this._appendTarget.appendChild(path);
+            }
+          }
+        }
+      } else if (patternStyle === 'rectangles') {
+        const widthValue = Number.isFinite(rectWidth) ? Math.abs(rectWidth) : 0;
+        const scale = this.scaleFactor > 0 ? this.scaleFactor : 1;
+        const scaledWidth = widthValue * scale;
+        if (scaledWidth > 1e-6 && patternStroke > 0) {
+          const halfWidth = scaledWidth / 2;
+          forEachLine((x1, y1, x2, y2) => {
+            const dx = x2 - x1;
+            const dy = y2 - y1;
+            const length = Math.hypot(dx, dy);
+            if (!Number.isFinite(length) || length <= 1e-6) {
+              return;
+            }
+            if (length <= 2 * halfWidth) {
+              return;
+            }
+            const invLength = 1 / length;
+            const offsetX = -dy * invLength * halfWidth;
+            const offsetY = dx * invLength * halfWidth;
+            const rectPoints = [
+              { x: x1 + offsetX, y: y1 + offsetY },
+              { x: x2 + offsetX, y: y2 + offsetY },
+              { x: x2 - offsetX, y: y2 - offsetY },
+              { x: x1 - offsetX, y: y1 - offsetY },
+            ];
+            const rectPathData = buildPathData(rectPoints);
+            const rectAttributes = {
+              d: rectPathData,
+              fill: 'none',
+              stroke: '#ff0000',
+              'stroke-width': patternStrokeStr,
+            };
+            if (!this.hasDOM) {
+              this._pushVirtual('path', rectAttributes);
+            } else {
+              const path = document.createElementNS(SVG_NS, 'path');
+              for (const [key, value] of Object.entries(rectAttributes)) {
+                path.setAttribute(key, value);
+              }
+              this._appendTarget.appendChild(path);
+            }
+          });
+        }
+      } else if (patternStroke > 0) {
+        forEachLine((x1, y1, x2, y2) => {
+          if (!this.hasDOM) {
+            this._pushVirtual('line', {
+              x1: x1.toFixed(4),
+              y1: y1.toFixed(4),
+              x2: x2.toFixed(4),
+              y2: y2.toFixed(4),
+              stroke: lineColor,
+              'stroke-width': patternStrokeStr,
+              'stroke-linecap': 'round',
+            });
+          } else {
+            const line = document.createElementNS(SVG_NS, 'line');
+            line.setAttribute('x1', x1.toFixed(4));
+            line.setAttribute('y1', y1.toFixed(4));
+            line.setAttribute('x2', x2.toFixed(4));
+            line.setAttribute('y2', y2.toFixed(4));
+            line.setAttribute('stroke', lineColor);
+            line.setAttribute('stroke-width', patternStrokeStr);
+            line.setAttribute('stroke-linecap', 'round');
+            this._appendTarget.appendChild(line);
+          }
+        });
       }
       return;
     }
 
-    const polygon = document.createElementNS(SVG_NS, 'polygon');
-    polygon.setAttribute('points', scaled.map(p => `${p.x.toFixed(4)},${p.y.toFixed(4)}`).join(' '));
     if (fill) {
-      polygon.setAttribute('fill', fill);
-      polygon.setAttribute('fill-opacity', fillOpacity.toString());
-    } else {
-      polygon.setAttribute('fill', 'none');
+      const pathData = buildPathData(scaled);
+      if (!this.hasDOM) {
+        const attrs = {
+          d: pathData,
+          fill,
+          'fill-opacity': fillOpacity.toString(),
+          stroke: 'none',
+        };
+        this._pushVirtual('path', attrs);
+      } else {
+        const path = document.createElementNS(SVG_NS, 'path');
+        path.setAttribute('d', pathData);
+        path.setAttribute('fill', fill);
+        path.setAttribute('fill-opacity', fillOpacity.toString());
+        path.setAttribute('stroke', 'none');
+        this._appendTarget.appendChild(path);
+      }
     }
-    if (stroke) {
-      polygon.setAttribute('stroke', stroke);
-      polygon.setAttribute('stroke-width', strokeWidth.toString());
-      polygon.setAttribute('stroke-linejoin', 'round');
-    } else {
-      polygon.setAttribute('stroke', 'none');
+
+    if (outlineSegments) {
+      emitOutlineSegments(outlineSegments, stroke);
     }
-    this.mainGroup.appendChild(polygon);
   }
 
   toString() {
-    if (!this.hasDOM || !this.svg) {
-      return '';
+    if (this.hasDOM && this.svg) {
+      return new XMLSerializer().serializeToString(this.svg);
+    }
+    const defsContent = this._virtualDefs && this._virtualDefs.length
+      ? `<defs>${this._virtualDefs.join('')}</defs>`
+      : '';
+    let mainContent;
+    if (this._virtualLayers) {
+      const layerGroups = this._virtualLayers.map((items, i) =>
+        `<g id="layer_${i + 1}" inkscape:label="Layer ${i + 1}" inkscape:groupmode="layer">${items.join('')}</g>`
+      ).join('');
+      mainContent = `<g>${layerGroups}</g>`;
+    } else if (this._virtualMain && this._virtualMain.length) {
+      mainContent = `<g>${this._virtualMain.join('')}</g>`;
+    } else {
+      mainContent = '<g></g>';
     }
-    return new XMLSerializer().serializeToString(this.svg);
+    return `${this._svgOpenTag(Boolean(this._virtualLayers))}${defsContent}${mainContent}</svg>`;
+  }
+
+  _svgOpenTag(layered) {
+    const widthAttr = this._formatLength(this.width);
+    const heightAttr = this._formatLength(this.height);
+    const inkscapeNs = layered ? ' xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape"' : '';
+    return `<svg xmlns="${SVG_NS}"${inkscapeNs} viewBox="${this._viewBox()}" width="${widthAttr}" height="${heightAttr}">`;
   }
 
   toElement() {
@@ -1074,6 +3188,67 @@ class DrawingContext {
   }
 }
 
+/**
+ * SVG layer of a ring when layering is on: rings are split evenly between
+ * minIndex and maxIndex. Returns -1 (the main group) when layering is off or
+ * there is no ring span.
+ */
+function ringLayerIndex(ringIdx, { enabled, count, minIndex, maxIndex }) {
+  if (!enabled || maxIndex === null || maxIndex <= minIndex) return -1;
+  const span = maxIndex - minIndex;
+  return Math.min(count - 1, Math.floor((ringIdx - minIndex) / span * count));
+}
+
+/**
+ * DrawingContext that hands finished markup to a `write(text)` callback
+ * instead of keeping the document in memory. Drawing calls collect into the
+ * main group as usual; flush() writes and forgets them. Layer groups are
+ * opened and closed by the caller, so setActiveLayer() has no effect here.
+ * The bytes written between open() and close() match the virtual-mode
+ * toString() of a DrawingContext that received the same calls.
+ */
+class StreamingDrawingContext extends DrawingContext {
+  constructor(write, width = 800, height = null, units = '') {
+    super(width, height, units);
+    // Always serialise to strings, even where a DOM is available
+    this.hasDOM = false;
+    this.svg = null;
+    this.defs = null;
+    this.mainGroup = null;
+    this._virtualDefs = [];
+    this._virtualMain = [];
+    this._write = write;
+  }
+
+  open(layered = false) {
+    this._write(`${this._svgOpenTag(layered)}<g>`);
+  }
+
+  openLayer(idx) {
+    this.write(`<g id="layer_${idx + 1}" inkscape:label="Layer ${idx + 1}" inkscape:groupmode="layer">`);
+  }
+
+  closeLayer() {
+    this.write('</g>');
+  }
+
+  write(text) {
+    this.flush();
+    this._write(text);
+  }
+
+  flush() {
+    if (this._virtualMain.length) {
+      this._write(this._virtualMain.join(''));
+      this._virtualMain = [];
+    }
+  }
+
+  close() {
+    this.write('</g></svg>');
+  }
+}
+
 // ------------------------------------------------------------
 // Doyle mathematics and arc selection
 // ------------------------------------------------------------
@@ -1213,7 +3388,7 @@ class ArcSelector {
 
     if (mode === 'random') {
       const indices = Array.from({ length: n }, (_, i) => i);
-      const rng = seededRandom(circle.id * 97 + 13);
+      const rng = seededRandom(circle.seed * 97 + 13);
       for (let i = indices.length - 1; i > 0; i -= 1) {
         const j = Math.floor(rng() * (i + 1));
         [indices[i], indices[j]] = [indices[j], indices[i]];
@@ -1291,12 +3466,310 @@ class ArcSelector {
 // Doyle spiral engine
 // ------------------------------------------------------------
 
+/**
+ * DoyleSpiralEngine generates and renders Doyle spirals based on Apollonian circle packings.
+ *
+ * @class DoyleSpiralEngine
+ * @param {number} p - First parameter for Doyle spiral generation (controls spiral structure)
+ * @param {number} q - Second parameter for Doyle spiral generation (controls spiral structure)
+ * @param {number} t - Time/evolution parameter for animating the spiral
+ * @param {Object} options - Additional configuration options
+ * @param {number} options.maxDistance - Maximum distance for circle generation (affects spiral extent)
+ * @param {string} options.arcMode - Arc selection mode: 'closest', 'furthest', or 'average'
+ * @param {number} options.numGaps - Number of gaps in the spiral pattern
+ */
+// ------------------------------------------------------------
+// Ring streaming
+// ------------------------------------------------------------
+
+/**
+ * Sliding window over the rings of a spiral for renderStream().
+ *
+ * Circle positions live in flat typed arrays; CircleElements exist only for
+ * the rings near the one being processed. Touching circles differ in radius
+ * by at most `reach` (the largest of |a|, |b|, |a/b| and their inverses), so
+ * ring k needs complete intersections for radii within [min/reach, max*reach]
+ * of the ring, and those need circles within reach² to exist. Circles below
+ * that window are released as the sweep moves outward.
+ *
+ * Every circle collects its intersections in the same partner order as
+ * computeAllIntersections() (centre x, then generation order), so groups,
+ * outlines and hatching come out bit-identical to an in-memory render.
+ */
+class RingStreamWindow {
+  constructor(engine, { x, y, r, idBase }) {
+    this.engine = engine;
+    this.count = r.length;
+    this.idBase = idBase;
+    this.outer = engine.outerCircles;
+    const total = this.count + this.outer.length;
+    this.total = total;
+
+    // Positions of every circle followed by the outer circles, in the order
+    // computeAllIntersections() sees them.
+    this.cx = new Float64Array(total);
+    this.cy = new Float64Array(total);
+    this.radius = new Float64Array(total);
+    this.cx.set(x);
+    this.cy.set(y);
+    this.radius.set(r);
+    this.outer.forEach((circle, idx) => {
+      this.cx[this.count + idx] = circle.center.re;
+      this.cy[this.count + idx] = circle.center.im;
+      this.radius[this.count + idx] = circle.radius;
+    });
+
+    // Rings in ascending radius; circles of a ring in generation order.
+    const radiusToRing = engine._computeRingIndices(r);
+    const ringCount = radiusToRing.size;
+    const ringOf = new Int32Array(this.count);
+    const ringStart = new Int32Array(ringCount + 1);
+    const ringMin = new Float64Array(ringCount).fill(Infinity);
+    const ringMax = new Float64Array(ringCount);
+    for (let idx = 0; idx < this.count; idx += 1) {
+      const ring = radiusToRing.get(Number(r[idx].toFixed(6)));
+      ringOf[idx] = ring;
+      ringStart[ring + 1] += 1;
+      ringMin[ring] = Math.min(ringMin[ring], r[idx]);
+      ringMax[ring] = Math.max(ringMax[ring], r[idx]);
+    }
+    for (let ring = 0; ring < ringCount; ring += 1) {
+      ringStart[ring + 1] += ringStart[ring];
+    }
+    const fill = ringStart.slice(0, ringCount);
+    const ringOrder = new Int32Array(this.count);
+    for (let idx = 0; idx < this.count; idx += 1) {
+      ringOrder[fill[ringOf[idx]]++] = idx;
+    }
+    this.ringCount = ringCount;
+    this.ringStart = ringStart;
+    this.ringOrder = ringOrder;
+    this.ringMin = ringMin;
+    this.ringMax = ringMax;
+
+    const byRadius = new Int32Array(total);
+    for (let idx = 0; idx < total; idx += 1) {
+      byRadius[idx] = idx;
+    }
+    byRadius.sort((i, j) => this.radius[i] - this.radius[j]);
+    this.byRadius = byRadius;
+
+    const { a, b, r: radiusRatio } = engine.root;
+    const modA = Complex.abs(a);
+    const modB = Complex.abs(b);
+    const reach = Math.max(modA, 1 / modA, modB, 1 / modB, modA / modB, modB / modA);
+    this.reach = reach * (1 + 1e-6);
+
+    // |centre| = radius / radiusRatio for every circle, so touching circles lie
+    // within a fixed angle of each other: bucket by polar angle.
+    const spread = radiusRatio * (1 + this.reach) * (1 + 1e-6) + 1e-6;
+    let buckets = spread >= 1 ? 1 : Math.floor((2 * Math.PI) / Math.asin(spread));
+    if (buckets < 3) {
+      buckets = 1;
+    }
+    this.bucketCount = buckets;
+    this.bucketOf = new Int32Array(total);
+    for (let idx = 0; idx < total; idx += 1) {
+      const angle = Math.atan2(this.cy[idx], this.cx[idx]);
+      this.bucketOf[idx] = Math.min(buckets - 1, Math.floor(((angle + Math.PI) / (2 * Math.PI)) * buckets));
+    }
+    this.peakLiveCircles = 0;
+  }
+
+  /**
+   * Visits rings fromRing..toRing in order. Each ring's groups are created,
+   * closed by their outer arcs, extended and given templates (skipped when
+   * `light`), passed to visit(groups, ringIndex) and then dropped.
+   */
+  sweep(fromRing, toRing, visit, {
+    symmetric = false,
+    light = false,
+    debugGroups = false,
+    inlineOutline = false,
+    context = null,
+    outlineStrokeWidth = 0,
+  } = {}) {
+    const engine = this.engine;
+    const spiralCenter = Complex.ZERO;
+    this.live = new Array(this.total).fill(null);
+    this.indexOf = new Map();
+    this.buckets = Array.from({ length: this.bucketCount }, () => new Set());
+    this.ownerArcs = new Map();
+    this.closures = new Array(this.outer.length).fill(null);
+    this.liveCount = 0;
+    let low = 0;
+    let materialized = 0;
+    let finalized = 0;
+
+    for (let ring = Math.max(0, fromRing); ring <= Math.min(toRing, this.ringCount - 1); ring += 1) {
+      const innerNeed = this.ringMin[ring] / this.reach;
+      const outerNeed = this.ringMax[ring] * this.reach;
+      while (low < this.total && this.radius[this.byRadius[low]] < innerNeed / this.reach) {
+        this._release(this.byRadius[low]);
+        low += 1;
+      }
+      while (materialized < this.total && this.radius[this.byRadius[materialized]] <= outerNeed * this.reach) {
+        const idx = this.byRadius[materialized];
+        if (this.radius[idx] >= innerNeed / this.reach) {
+          this._materialize(idx);
+        }
+        materialized += 1;
+      }
+      while (finalized < this.total && this.radius[this.byRadius[finalized]] <= outerNeed) {
+        const idx = this.byRadius[finalized];
+        if (this.radius[idx] >= innerNeed) {
+          this._finalize(idx);
+        }
+        finalized += 1;
+      }
+
+      const circles = [];
+      for (let pos = this.ringStart[ring]; pos < this.ringStart[ring + 1]; pos += 1) {
+        const circle = this.live[this.ringOrder[pos]];
+        if (circle && circle.intersections.length === STANDARD_INTERSECTION_COUNT) {
+          circles.push(circle);
+        }
+      }
+      if (symmetric) {
+        engine._sortCirclesByAngle(circles);
+      }
+      engine.arcGroups = new Map();
+      const groups = engine._createRingGroups(ring, circles, {
+        spiralCenter,
+        debugGroups,
+        addFillPattern: false,
+        drawGroupOutline: inlineOutline,
+        context,
+        outlineStrokeWidth,
+        symmetric,
+      });
+      for (const group of groups) {
+        const owner = this.ownerArcs.get(this.indexOf.get(group.baseCircle));
+        if (owner) {
+          group.outerArc = owner.arc;
+        }
+      }
+      if (!light) {
+        for (const group of groups) {
+          engine._extendGroupWithNeighbours(group, group.baseCircle, spiralCenter);
+        }
+        engine._finalizeRingTemplates(groups, { cacheTemplates: false });
+      }
+      visit(groups, ring);
+    }
+    engine.arcGroups = new Map();
+    engine._ringTemplates = new Map();
+    this.live = null;
+    this.indexOf = null;
+    this.buckets = null;
+  }
+
+  _materialize(idx) {
+    const circle = idx < this.count
+      ? new CircleElement({ re: this.cx[idx], im: this.cy[idx] }, this.radius[idx], true, this.idBase + idx + 1, idx + 1)
+      : this.outer[idx - this.count];
+    this.live[idx] = circle;
+    this.indexOf.set(circle, idx);
+    this.buckets[this.bucketOf[idx]].add(idx);
+    this.liveCount += 1;
+    this.peakLiveCircles = Math.max(this.peakLiveCircles, this.liveCount);
+  }
+
+  _release(idx) {
+    const circle = this.live[idx];
+    if (!circle) {
+      return;
+    }
+    this.live[idx] = null;
+    this.indexOf.delete(circle);
+    this.buckets[this.bucketOf[idx]].delete(idx);
+    this.liveCount -= 1;
+    // Live circles may still point at this one; drop its own partner links so
+    // the released rings are not kept reachable through it.
+    circle.intersections = [];
+    circle.neighbours.clear();
+    circle._orderedNeighbours = null;
+  }
+
+  // Same tie-break as the stable x sort in computeAllIntersections().
+  _compare(i, j) {
+    return (this.cx[i] - this.cx[j]) || (i - j);
+  }
+
+  _finalize(idx) {
+    const circle = this.live[idx];
+    if (!circle) {
+      return;
+    }
+    const { cx, cy, radius } = this;
+    const home = this.bucketOf[idx];
+    const bucketIds = this.bucketCount === 1
+      ? [0]
+      : [(home + this.bucketCount - 1) % this.bucketCount, home, (home + 1) % this.bucketCount];
+    const partners = [];
+    for (const bucket of bucketIds) {
+      for (const other of this.buckets[bucket]) {
+        if (other === idx) {
+          continue;
+        }
+        const points = this._compare(idx, other) < 0
+          ? circleIntersection(cx[idx], cy[idx], radius[idx], cx[other], cy[other], radius[other])
+          : circleIntersection(cx[other], cy[other], radius[other], cx[idx], cy[idx], radius[idx]);
+        if (points.length) {
+          partners.push({ other, points });
+        }
+      }
+    }
+    partners.sort((u, v) => this._compare(u.other, v.other));
+    circle.resetIntersections();
+    for (const { other, points } of partners) {
+      for (const point of points) {
+        circle.addIntersection(point, this.live[other]);
+      }
+    }
+    circle.finalizeIntersections(Complex.ZERO);
+
+    if (idx >= this.count) {
+      const outerIdx = idx - this.count;
+      const closure = this.engine._outerClosure(circle, Complex.ZERO);
+      this.closures[outerIdx] = closure;
+      if (closure && closure.ownerCircle) {
+        const ownerIdx = this.indexOf.get(closure.ownerCircle);
+        const current = this.ownerArcs.get(ownerIdx);
+        // Later outer circles win, as in _drawOuterClosureArcs.
+        if (!current || current.outerIdx < outerIdx) {
+          this.ownerArcs.set(ownerIdx, { outerIdx, arc: closure.ownerArc });
+        }
+      }
+    }
+  }
+}
+
 class DoyleSpiralEngine {
   constructor(p = 7, q = 32, t = 0, {
     maxDistance = 2000,
     arcMode = 'closest',
     numGaps = 2,
+    streaming = false, // Allow the larger p/q range that only renderStream() can handle
   } = {}) {
+    // Validate parameters
+    const maxP = streaming ? MAX_STREAM_P : MAX_P;
+    const maxQ = streaming ? MAX_STREAM_Q : MAX_Q;
+    if (!Number.isFinite(p) || p < MIN_P || p > maxP) {
+      throw new Error(`Parameter p must be between ${MIN_P} and ${maxP}, got ${p}`);
+    }
+    if (!Number.isFinite(q) || q < MIN_Q || q > maxQ) {
+      throw new Error(`Parameter q must be between ${MIN_Q} and ${maxQ}, got ${q}`);
+    }
+    if (!Number.isFinite(t)) {
+      throw new Error(`Parameter t must be a finite number, got ${t}`);
+    }
+    if (!Number.isFinite(maxDistance) || maxDistance < MIN_MAX_DISTANCE || maxDistance > MAX_MAX_DISTANCE) {
+      throw new Error(
+        `Parameter maxDistance must be between ${MIN_MAX_DISTANCE} and ${MAX_MAX_DISTANCE}, got ${maxDistance}`
+      );
+    }
+
     this.p = p;
     this.q = q;
     this.t = t;
@@ -1309,44 +3782,95 @@ class DoyleSpiralEngine {
     this._generated = false;
     this.arcGroups = new Map();
     this.fillPatternAngle = 0;
+    this.fillPatternAnimationId = DEFAULT_PATTERN_ANIMATION;
+    this._ringTemplates = new Map();
   }
 
+  /**
+   * Generates all circles in the Doyle spiral based on the current parameters.
+   * Creates both forward and backward spirals for each family.
+   *
+   * @throws {Error} If iteration limit is exceeded (prevents infinite loops)
+   */
   generateCircles() {
+    const circles = [];
+    this._forEachCirclePosition((center, radius) => {
+      circles.push(new CircleElement(center, radius, true, null, circles.length + 1));
+    });
+    this.circles = circles;
+    this._generated = true;
+  }
+
+  /**
+   * Walks every circle position of the spiral in generation order (family by
+   * family, forward then backward) without allocating circle elements.
+   *
+   * @param {Function} visit - Called as visit(center, radius)
+   * @throws {Error} If iteration limit is exceeded (prevents infinite loops)
+   */
+  _forEachCirclePosition(visit) {
     const { r, a, b, mod_a: modA, arg_a: argA } = this.root;
     const scale = Math.pow(modA, this.t);
     const alpha = argA * this.t;
-    const minD = 1 / Math.max(scale, 1e-9);
+    const minD = 1 / Math.max(scale, EPSILON);
     const unit = Complex.expi(alpha);
 
-    const circles = [];
     let start = Complex.clone(a);
     const absA = Complex.abs(a);
 
     for (let family = 0; family < this.q; family += 1) {
       let qv = Complex.clone(start);
       let modQ = Complex.abs(qv);
-      while (modQ * scale < this.maxDistance) {
+      let iterations = 0;
+
+      // Forward spiral
+      while (modQ * scale < this.maxDistance && iterations < MAX_ITERATIONS_PER_FAMILY) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        circles.push(new CircleElement(scaled, r * scale * modQ));
+        visit(scaled, r * scale * modQ);
         qv = Complex.mul(qv, a);
         modQ *= absA;
+        iterations++;
+      }
+
+      if (iterations >= MAX_ITERATIONS_PER_FAMILY) {
+        throw new Error(
+          `Circle generation exceeded iteration limit (${MAX_ITERATIONS_PER_FAMILY} per family). ` +
+          `Try reducing p (${this.p}), q (${this.q}), or max_d (${this.maxDistance}).`
+        );
       }
+
+      // Backward spiral
       qv = Complex.div(start, a);
       modQ = Complex.abs(qv);
-      while (modQ > minD) {
+      iterations = 0;
+
+      while (modQ > minD && iterations < MAX_ITERATIONS_PER_FAMILY) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        circles.push(new CircleElement(scaled, r * scale * modQ));
+        visit(scaled, r * scale * modQ);
         qv = Complex.div(qv, a);
         modQ /= absA;
+        iterations++;
+      }
+
+      if (iterations >= MAX_ITERATIONS_PER_FAMILY) {
+        throw new Error(
+          `Circle generation exceeded iteration limit (${MAX_ITERATIONS_PER_FAMILY} per family). ` +
+          `Try reducing p (${this.p}), q (${this.q}), or increasing max_d (${this.maxDistance}).`
+        );
       }
+
       start = Complex.mul(start, b);
     }
-
-    this.circles = circles;
-    this._generated = true;
   }
 
-  generateOuterCircles() {
+  /**
+   * Generates outer boundary circles for the spiral.
+   * These circles help define the outer edge of the pattern.
+   *
+   * @param {number} [seedBase] - Seeds continue after this many spiral circles
+   * @throws {Error} If iteration limit is exceeded
+   */
+  generateOuterCircles(seedBase = this.circles.length) {
     const { r, a, b, mod_a: modA, arg_a: argA } = this.root;
     const scale = Math.pow(modA, this.t);
     const unit = Complex.expi(argA * this.t);
@@ -1356,13 +3880,25 @@ class DoyleSpiralEngine {
 
     for (let family = 0; family < this.q; family += 1) {
       let qv = Complex.clone(start);
-      while (Complex.abs(qv) * scale < this.maxDistance) {
+      let iterations = 0;
+
+      // Find outer circle boundary
+      while (Complex.abs(qv) * scale < this.maxDistance && iterations < MAX_ITERATIONS_PER_FAMILY) {
         qv = Complex.mul(qv, a);
+        iterations++;
+      }
+
+      if (iterations >= MAX_ITERATIONS_PER_FAMILY) {
+        throw new Error(
+          `Outer circle generation exceeded iteration limit (${MAX_ITERATIONS_PER_FAMILY} per family). ` +
+          `Try reducing p (${this.p}), q (${this.q}), or max_d (${this.maxDistance}).`
+        );
       }
+
       const modQ = Complex.abs(qv);
       if (modQ * scale < this.maxDistance * absA * 2) {
         const scaled = Complex.mulScalar(Complex.mul(qv, unit), scale);
-        outer.push(new CircleElement(scaled, r * scale * modQ, false));
+        outer.push(new CircleElement(scaled, r * scale * modQ, false, null, seedBase + outer.length + 1));
       }
       start = Complex.mul(start, b);
     }
@@ -1370,26 +3906,79 @@ class DoyleSpiralEngine {
     this.outerCircles = outer;
   }
 
+  /**
+   * Computes intersection points between all circles in the spiral.
+   * Uses spatial indexing for efficient intersection detection.
+   */
   computeAllIntersections() {
     const all = this.circles.concat(this.outerCircles);
     if (!all.length) {
       return;
     }
-    const tol = 1e-3;
-    for (let i = 0; i < all.length; i += 1) {
-      const circle = all[i];
-      const candidates = [];
-      for (let j = 0; j < all.length; j += 1) {
-        if (i === j) {
+
+    for (const circle of all) {
+      circle.resetIntersections();
+    }
+
+    const sorted = all
+      .slice()
+      .sort((a, b) => a.center.re - b.center.re);
+    const total = sorted.length;
+    const xs = new Float64Array(total);
+    const ys = new Float64Array(total);
+    const radii = new Float64Array(total);
+    const suffixMaxRadius = new Float64Array(total);
+
+    let maxMagnitude = 0;
+    for (let idx = 0; idx < total; idx += 1) {
+      const entry = sorted[idx];
+      xs[idx] = entry.center.re;
+      ys[idx] = entry.center.im;
+      radii[idx] = entry.radius;
+      maxMagnitude = Math.max(maxMagnitude, Math.abs(xs[idx]) + Math.abs(ys[idx]) + radii[idx]);
+    }
+    let runningMax = 0;
+    for (let idx = total - 1; idx >= 0; idx -= 1) {
+      if (radii[idx] > runningMax) {
+        runningMax = radii[idx];
+      }
+      suffixMaxRadius[idx] = runningMax;
+    }
+
+    for (let i = 0; i < total; i += 1) {
+      const circle = sorted[i];
+      const x1 = xs[i];
+      const y1 = ys[i];
+      const r1 = radii[i];
+      // Conservative pruning slack: at least as large as any pairwise tangency
+      // tolerance involving this circle (see tangencyTolerance).
+      const slack = RELATIVE_TANGENCY_TOLERANCE * r1 + ROUNDOFF_TOLERANCE * 2 * maxMagnitude;
+      const maxReachBase = r1 + slack;
+
+      for (let j = i + 1; j < total; j += 1) {
+        const dx = xs[j] - x1;
+        if (dx > maxReachBase + suffixMaxRadius[j]) {
+          break;
+        }
+        const r2 = radii[j];
+        const dy = ys[j] - y1;
+        // Quick rejection: use reach squared to avoid sqrt
+        const reach = r1 + r2 + slack;
+        if (dx * dx + dy * dy > reach * reach) {
           continue;
         }
-        const other = all[j];
-        const dist = Complex.abs(Complex.sub(circle.center, other.center));
-        if (dist <= circle.radius + other.radius + tol) {
-          candidates.push(other);
+
+        const other = sorted[j];
+        const points = circleIntersection(x1, y1, r1, xs[j], ys[j], r2);
+        for (const point of points) {
+          circle.addIntersection(point, other);
+          other.addIntersection(point, circle);
         }
       }
-      circle.computeIntersections(candidates, Complex.ZERO, tol);
+    }
+
+    for (const circle of all) {
+      circle.finalizeIntersections(Complex.ZERO);
     }
   }
 
@@ -1407,76 +3996,371 @@ class DoyleSpiralEngine {
     this.arcGroups.get(key).addArc(arc);
   }
 
-  _computeRingIndices() {
-    const radii = this.circles.map(c => Number(c.radius.toFixed(6)));
+  _computeRingIndices(circleRadii = this.circles.map(c => c.radius)) {
+    const radii = Array.from(circleRadii, radius => Number(radius.toFixed(6)));
     const unique = Array.from(new Set(radii)).sort((a, b) => a - b);
     const mapping = new Map();
     unique.forEach((radius, idx) => mapping.set(radius, idx));
     return mapping;
   }
 
-  _createArcGroupsForCircles(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context) {
-    for (const circle of this.circles) {
-      if (circle.intersections.length !== 6) {
-        continue;
+  _ringTemplateKey(ringIndex, arcsToDraw) {
+    const signature = (arcsToDraw || [])
+      .map(pair => (Array.isArray(pair) ? `${pair[0]}-${pair[1]}` : String(pair)))
+      .join('|');
+    return `${ringIndex}|${this.arcMode}|${this.numGaps}|${signature}`;
+  }
+
+  _normalisePointsForTemplate(points, center, radius) {
+    if (!points || !points.length || !center || !radius) {
+      return null;
+    }
+    const invRadius = 1 / radius;
+    const out = new Float64Array(points.length * 2);
+    for (let idx = 0; idx < points.length; idx += 1) {
+      const diff = Complex.sub(points[idx], center);
+      out[idx * 2] = diff.re * invRadius;
+      out[idx * 2 + 1] = diff.im * invRadius;
+    }
+    return out;
+  }
+
+  _buildRingTemplate(circle, group, arcs, arcsToDraw) {
+    if (!circle || !group || !arcs || !arcs.length) {
+      return null;
+    }
+    const center = circle.center;
+    const radius = circle.radius || 1;
+    const normalizedArcs = [];
+    const arcPointCounts = [];
+    for (const arc of arcs) {
+      const pts = arc.getPoints();
+      const normalised = this._normalisePointsForTemplate(pts, center, radius);
+      normalizedArcs.push(normalised);
+      arcPointCounts.push((pts && pts.length) || 0);
+    }
+    const outlinePoints = group.getClosedOutline();
+    const normalizedOutline = this._normalisePointsForTemplate(outlinePoints, center, radius);
+    const outlineJoins = group.outlineJoins;
+    let referenceVector = { re: 1, im: 0 };
+    if (normalizedArcs.length && normalizedArcs[0] && normalizedArcs[0].length >= 2) {
+      const x = normalizedArcs[0][0];
+      const y = normalizedArcs[0][1];
+      const len = Math.hypot(x, y);
+      if (len > 1e-9) {
+        referenceVector = { re: x / len, im: y / len };
       }
+    }
+    return {
+      normalizedArcs,
+      normalizedOutline,
+      outlineJoins,
+      referenceVector,
+      referenceArcIndex: 0,
+      arcPointCounts,
+      signature: (arcsToDraw || []).map(([i, j]) => `${i}-${j}`).join('|'),
+      baseRadius: radius,
+      patternCache: new Map(),
+    };
+  }
+
+  _computeTemplateTransform(template, circle, arcsToDraw) {
+    if (!template || !circle || !arcsToDraw || !arcsToDraw.length) {
+      return null;
+    }
+    const refIdx = Math.min(template.referenceArcIndex || 0, arcsToDraw.length - 1);
+    const [startIdx] = arcsToDraw[refIdx];
+    const entry = circle.intersections[startIdx];
+    if (!entry || !entry[0]) {
+      return null;
+    }
+    const startPoint = entry[0];
+    const center = circle.center;
+    const vec = Complex.sub(startPoint, center);
+    const len = Math.hypot(vec.re, vec.im);
+    if (len < 1e-9) {
+      return { cos: 1, sin: 0, radius: circle.radius, center };
+    }
+    const normActual = { re: vec.re / len, im: vec.im / len };
+    const base = template.referenceVector || { re: 1, im: 0 };
+    const dot = clamp(base.re * normActual.re + base.im * normActual.im, -1, 1);
+    const cross = base.re * normActual.im - base.im * normActual.re;
+    const norm = Math.hypot(dot, cross);
+    const cos = norm > 1e-12 ? dot / norm : 1;
+    const sin = norm > 1e-12 ? cross / norm : 0;
+    return {
+      cos,
+      sin,
+      radius: circle.radius,
+      center,
+    };
+  }
+
+  /**
+   * Creates arc groups for every circle, one ring at a time from the innermost
+   * ring outwards and in generation order within a ring. Ring order is what a
+   * ring-streamed render (renderStream) can reproduce without the full spiral.
+   */
+  _createArcGroupsForCircles(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0) {
+    const ringCircles = this._groupCirclesByRing(radiusToRing);
+    const rings = Array.from(ringCircles.keys()).sort((a, b) => a - b);
+    for (const ringIndex of rings) {
+      this._createRingGroups(ringIndex, ringCircles.get(ringIndex), {
+        spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth,
+      });
+    }
+  }
+
+  /**
+   * Creates the arc groups of one ring.
+   * @private
+   * @param {number} ringIndex - Ring index shared by the circles
+   * @param {Array} circles - Circles of the ring with six intersections, in processing order
+   * @param {Object} options - Drawing options; `symmetric` links clones to the ring's first group
+   * @returns {Array} The created groups, in creation order
+   */
+  _createRingGroups(ringIndex, circles, {
+    spiralCenter,
+    debugGroups,
+    addFillPattern,
+    drawGroupOutline,
+    context,
+    outlineStrokeWidth = 0,
+    symmetric = false,
+  }) {
+    const groups = [];
+    // Track the master group for this ring (used for outline sharing)
+    let masterGroup = null;
+    for (let i = 0; i < circles.length; i++) {
+      const circle = circles[i];
+
+      // Each circle selects its own arcs based on position
+      // (Critical: arc selection depends on angle relative to spiral center)
       const arcsToDraw = ArcSelector.selectArcsForGaps(circle, spiralCenter, this.numGaps, this.arcMode);
-      if (!arcsToDraw.length) {
-        continue;
-      }
+      if (!arcsToDraw.length) continue;
+
       const key = `circle_${circle.id}`;
       const group = this.createGroupForCircle(circle, key);
-      const ring = radiusToRing.get(Number(circle.radius.toFixed(6)));
-      group.ringIndex = ring !== undefined ? ring : null;
+      group.ringIndex = ringIndex;
+      group.baseCircle = circle;
       if (debugGroups) {
-        group.debugFill = colorFromSeed(circle.id);
-        group.debugStroke = '#000000';
-      }
-      for (const [i, j] of arcsToDraw) {
-        const start = circle.intersections[i][0];
-        const end = circle.intersections[j][0];
-        const arc = new ArcElement(circle, start, end, 40, true);
-        if (!addFillPattern && drawGroupOutline) {
-          context.drawScaled(arc);
-        }
-        group.addArc(arc);
+        group.debugFill = colorFromSeed(circle.seed);
+        group.debugStroke = DEFAULT_OUTLINE_COLOR;
+      }
+      this._createArcsForGroup(circle, group, arcsToDraw, addFillPattern, drawGroupOutline, context, outlineStrokeWidth);
+
+      group.templateKey = this._ringTemplateKey(ringIndex, arcsToDraw);
+      group.originalArcsToDraw = arcsToDraw;
+      groups.push(group);
+
+      if (!symmetric) continue;
+      // Set up master/clone relationship for outline computation optimization
+      if (i === 0) {
+        // First circle in ring is the master
+        masterGroup = group;
+        // Pre-warm cache: compute outline immediately to avoid cascading misses
+        masterGroup.getClosedOutline();
+      } else if (masterGroup && arcsToDraw.length === masterGroup.originalArcsToDraw.length) {
+        // Subsequent circles with matching arc count are clones
+        // They will rotate the master's outline instead of computing from scratch
+        group.cloneOf = masterGroup;
       }
     }
+    return groups;
   }
 
-  _drawOuterClosureArcs(spiralCenter, debugGroups, redOutline, addFillPattern, drawGroupOutline, context) {
+  /**
+   * Groups circles by their ring index based on radius.
+   * @private
+   * @param {Map<number, number>} radiusToRing - Map from quantized radius to ring index
+   * @returns {Map<number, Array>} Map from ring index to array of circles
+   */
+  _groupCirclesByRing(radiusToRing) {
+    const ringCircles = new Map();
+    for (const circle of this.circles) {
+      // Only process circles with standard hexagonal packing
+      if (circle.intersections.length !== STANDARD_INTERSECTION_COUNT) {
+        continue;
+      }
+      const ring = radiusToRing.get(Number(circle.radius.toFixed(6)));
+      if (ring === undefined) continue;
+
+      if (!ringCircles.has(ring)) {
+        ringCircles.set(ring, []);
+      }
+      ringCircles.get(ring).push(circle);
+    }
+    return ringCircles;
+  }
+
+  /**
+   * Sorts circles by their angular position around the origin.
+   * @private
+   * @param {Array} circles - Array of circles to sort
+   */
+  _sortCirclesByAngle(circles) {
+    circles.sort((a, b) => {
+      const angleA = Math.atan2(a.center.im, a.center.re);
+      const angleB = Math.atan2(b.center.im, b.center.re);
+      return angleA - angleB;
+    });
+  }
+
+  /**
+   * Creates arcs for a circle and adds them to its group.
+   * @private
+   * @param {Object} circle - Circle to create arcs for
+   * @param {Object} group - ArcGroup to add arcs to
+   * @param {Array} arcsToDraw - Array of [start, end] index pairs
+   * @param {boolean} addFillPattern - Whether pattern fill is enabled
+   * @param {boolean} drawGroupOutline - Whether to draw outline
+   * @param {Object} context - Drawing context
+   * @param {number} outlineStrokeWidth - Stroke width for outlines
+   */
+  _createArcsForGroup(circle, group, arcsToDraw, addFillPattern, drawGroupOutline, context, outlineStrokeWidth) {
+    for (const [idx, jdx] of arcsToDraw) {
+      const start = circle.intersections[idx][0];
+      const end = circle.intersections[jdx][0];
+      const arc = new ArcElement(circle, start, end);
+
+      // Draw outline if needed (but not in pattern fill mode)
+      if (!addFillPattern && drawGroupOutline) {
+        context.drawScaledArc(arc, { color: DEFAULT_OUTLINE_COLOR, width: outlineStrokeWidth });
+      }
+
+      group.addArc(arc);
+    }
+  }
+
+  /**
+   * Creates arc groups using rotational symmetry optimization (when p == q).
+   * Exploits rotational symmetry: each ring has identical shapes at different angles.
+   * Master groups compute outlines once; clone groups rotate the master outline.
+   *
+   * @private
+   * @param {Map<number, number>} radiusToRing - Map from quantized radius to ring index
+   * @param {Object} spiralCenter - Center point of spiral (usually origin)
+   * @param {boolean} debugGroups - Whether to enable debug rendering
+   * @param {boolean} addFillPattern - Whether pattern fill is enabled
+   * @param {boolean} drawGroupOutline - Whether to draw outlines
+   * @param {Object} context - Drawing context for SVG generation
+   * @param {number} [outlineStrokeWidth=0] - Stroke width for outlines
+   */
+  _createArcGroupsSymmetric(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0) {
+    const ringCircles = this._groupCirclesByRing(radiusToRing);
+    const rings = Array.from(ringCircles.keys()).sort((a, b) => a - b);
+
+    // Process each ring independently, innermost first
+    for (const ringIndex of rings) {
+      const circles = ringCircles.get(ringIndex);
+      if (!circles.length) continue;
+
+      // Sort by angle for consistent processing
+      this._sortCirclesByAngle(circles);
+      this._createRingGroups(ringIndex, circles, {
+        spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context, outlineStrokeWidth,
+        symmetric: true,
+      });
+    }
+  }
+
+  _drawOuterClosureArcs(
+    spiralCenter,
+    debugGroups,
+    redOutline,
+    addFillPattern,
+    drawGroupOutline,
+    context,
+    outlineStrokeWidth = 0,
+    highlightStrokeWidth = 0,
+  ) {
     for (const circle of this.outerCircles) {
-      if (circle.intersections.length < 2) {
+      const closure = this._outerClosure(circle, spiralCenter);
+      if (!closure) {
         continue;
       }
-      const pts = circle.intersections.map(entry => entry[0]);
-      const distances = [];
-      for (let i = 0; i < pts.length; i += 1) {
-        const j = (i + 1) % pts.length;
-        const midpoint = Complex.mulScalar(Complex.add(pts[i], pts[j]), 0.5);
-        const dist = Complex.abs(Complex.sub(midpoint, spiralCenter));
-        distances.push({ dist, i, j });
-      }
-      distances.sort((a, b) => a.dist - b.dist);
-      for (let idx = 1; idx < Math.min(3, distances.length); idx += 1) {
-        const { i, j } = distances[idx];
-        const arc = new ArcElement(circle, pts[i], pts[j], 40, true);
-        if (redOutline || (!addFillPattern && drawGroupOutline)) {
-          const color = redOutline ? '#ff0000' : '#000000';
-          context.drawScaled(arc, { color, width: 1.2 });
+      // The innermost arc is the outer boundary of the adjacent visible circle
+      // group. Store it on that group so the outline can include it.
+      if (closure.ownerCircle) {
+        const ownerGroup = this.arcGroups.get(`circle_${closure.ownerCircle.id}`);
+        if (ownerGroup) {
+          ownerGroup.outerArc = closure.ownerArc;
         }
+      }
+      for (const arc of closure.arcs) {
         const key = `outer_${circle.id}`;
         if (!this.arcGroups.has(key)) {
           const group = new ArcGroup(key);
           group.ringIndex = -1;
           if (debugGroups) {
-            group.debugFill = colorFromSeed(circle.id + 1000);
-            group.debugStroke = '#000000';
+            group.debugFill = colorFromSeed(circle.seed + 1000);
+            group.debugStroke = DEFAULT_OUTLINE_COLOR;
           }
           this.arcGroups.set(key, group);
         }
         this.arcGroups.get(key).addArc(arc);
       }
+      this._drawOuterClosure(closure.arcs, {
+        redOutline, addFillPattern, drawGroupOutline, context, outlineStrokeWidth, highlightStrokeWidth,
+      });
+    }
+  }
+
+  /**
+   * Closure arcs of one outer (invisible) circle, ordered by distance of the
+   * arc midpoints to the spiral centre. The innermost arc closes the visible
+   * group it borders (`ownerCircle`, null when the endpoints disagree); the
+   * next two arcs form the outer rim.
+   * @private
+   */
+  _outerClosure(circle, spiralCenter) {
+    if (circle.intersections.length < 2) {
+      return null;
+    }
+    const pts = circle.intersections.map(entry => entry[0]);
+    const distances = [];
+    for (let i = 0; i < pts.length; i += 1) {
+      const j = (i + 1) % pts.length;
+      const midpoint = Complex.mulScalar(Complex.add(pts[i], pts[j]), 0.5);
+      const dist = Complex.abs(Complex.sub(midpoint, spiralCenter));
+      distances.push({ dist, i, j });
+    }
+    distances.sort((a, b) => a.dist - b.dist);
+
+    const { i: innerI, j: innerJ } = distances[0];
+    // Find the visible circle that shares both intersection endpoints of this arc.
+    const neighborAtI = circle.intersections[innerI][1];
+    const neighborAtJ = circle.intersections[innerJ][1];
+    const ownerCircle = neighborAtI === neighborAtJ && neighborAtI.visible ? neighborAtI : null;
+    const arcs = [];
+    for (let idx = 1; idx < Math.min(3, distances.length); idx += 1) {
+      const { i, j } = distances[idx];
+      arcs.push(new ArcElement(circle, pts[i], pts[j]));
+    }
+    return {
+      ownerCircle,
+      ownerArc: ownerCircle ? new ArcElement(circle, pts[innerI], pts[innerJ]) : null,
+      arcs,
+    };
+  }
+
+  _drawOuterClosure(arcs, {
+    redOutline, addFillPattern, drawGroupOutline, context, outlineStrokeWidth = 0, highlightStrokeWidth = 0,
+  }) {
+    if (!arcs.length || !(redOutline || (!addFillPattern && drawGroupOutline))) {
+      return;
+    }
+    const paths = buildContinuousPathsFromArcs(arcs);
+    const shouldDrawBaseOutline = !addFillPattern && drawGroupOutline && outlineStrokeWidth > 0;
+    if (shouldDrawBaseOutline) {
+      for (const path of paths) {
+        context.drawPolyline(path, { color: DEFAULT_OUTLINE_COLOR, width: outlineStrokeWidth });
+      }
+    }
+    if (redOutline && highlightStrokeWidth > 0) {
+      for (const path of paths) {
+        context.drawPolyline(path, { color: '#ff0000', width: highlightStrokeWidth });
+      }
     }
   }
 
@@ -1485,55 +4369,127 @@ class DoyleSpiralEngine {
     if (!groups.length) {
       return;
     }
-    const preferenceMap = new Map([
-      ['-1', 'start'],
-      ['-2', 'end'],
-      ['-5', 'end'],
-      ['-6', 'start'],
-    ]);
     for (const circle of this.circles) {
-      const key = `circle_${circle.id}`;
-      const group = this.arcGroups.get(key);
-      if (!group) {
+      const group = this.arcGroups.get(`circle_${circle.id}`);
+      if (group) {
+        this._extendGroupWithNeighbours(group, circle, spiralCenter);
+      }
+    }
+  }
+
+  /**
+   * Adds one arc from each of four neighbouring circles to a group so its
+   * outline closes around the gaps. Reads only the intersections of the
+   * circle and its direct neighbours.
+   * @private
+   */
+  _extendGroupWithNeighbours(group, circle, spiralCenter) {
+    const neighbours = circle.getNeighbourCircles();
+    if (neighbours.length !== 6) {
+      return;
+    }
+    for (const k of [-1, -2, -5, -6]) {
+      const idx = ((k % neighbours.length) + neighbours.length) % neighbours.length;
+      const neighbour = neighbours[idx];
+      const arcs = ArcSelector.selectArcsForGaps(neighbour, spiralCenter, 0, 'all');
+      if (!arcs.length) {
+        continue;
+      }
+      const preference = NEIGHBOUR_ARC_PREFERENCE.get(k) || 'start';
+      let sharedIndex = -1;
+      for (let intersectionIdx = 0; intersectionIdx < neighbour.intersections.length; intersectionIdx += 1) {
+        if (neighbour.intersections[intersectionIdx][1] === circle) {
+          sharedIndex = intersectionIdx;
+          break;
+        }
+      }
+      if (sharedIndex === -1) {
+        continue;
+      }
+      let arcIndex = -1;
+      if (preference === 'end') {
+        arcIndex = arcs.findIndex(([, endIdx]) => endIdx === sharedIndex);
+      }
+      if (arcIndex === -1) {
+        arcIndex = arcs.findIndex(([startIdx]) => startIdx === sharedIndex);
+      }
+      if (arcIndex === -1) {
+        arcIndex = 0;
+      }
+      const [i, j] = arcs[arcIndex];
+      const start = neighbour.intersections[i][0];
+      const end = neighbour.intersections[j][0];
+      const arc = new ArcElement(neighbour, start, end);
+      group.addArc(arc);
+    }
+  }
+
+  /**
+   * Builds (or fetches) the shared template of each ring shape and points the
+   * groups at it. Defaults to every circle group of the engine; a ring-streamed
+   * render passes one ring's groups and `cacheTemplates: false` so templates are
+   * released with the ring instead of accumulating in RING_TEMPLATE_CACHE.
+   */
+  _finalizeRingTemplates(ringGroups = null, { cacheTemplates = true } = {}) {
+    const candidates = ringGroups
+      || Array.from(this.arcGroups.values()).filter(group => group.name.startsWith('circle_'));
+    if (!candidates.length) {
+      return;
+    }
+    this._ringTemplates = new Map();
+    const grouped = new Map();
+    for (const group of candidates) {
+      const templateKey = group.templateKey;
+      if (!templateKey) {
+        continue;
+      }
+      if (!grouped.has(templateKey)) {
+        grouped.set(templateKey, []);
+      }
+      grouped.get(templateKey).push(group);
+    }
+
+    for (const [templateKey, groups] of grouped.entries()) {
+      if (!groups.length) {
         continue;
       }
-      const neighbours = circle.getNeighbourCircles();
-      if (neighbours.length !== 6) {
+      const representative = groups.find(g => g.arcs.length) || groups[0];
+      if (!representative || !representative.arcs.length) {
         continue;
       }
-      for (const k of [-1, -2, -5, -6]) {
-        const idx = ((k % neighbours.length) + neighbours.length) % neighbours.length;
-        const neighbour = neighbours[idx];
-        const arcs = ArcSelector.selectArcsForGaps(neighbour, spiralCenter, 0, 'all');
-        if (!arcs.length) {
+      const baseCircle = representative.baseCircle || representative.arcs[0]?.circle || null;
+      if (!baseCircle) {
+        continue;
+      }
+      const arcsToDraw = representative.originalArcsToDraw || [];
+      const cacheKey = `${this.p}|${this.q}|${this.t}|${this.arcMode}|${this.numGaps}|${templateKey}`;
+      let template = RING_TEMPLATE_CACHE.get(cacheKey) || null;
+      if (!template) {
+        template = this._buildRingTemplate(
+          baseCircle,
+          representative,
+          representative.arcs,
+          arcsToDraw,
+        );
+        if (!template) {
           continue;
         }
-        const preference = preferenceMap.get(k.toString()) || 'start';
-        let sharedIndex = -1;
-        for (let intersectionIdx = 0; intersectionIdx < neighbour.intersections.length; intersectionIdx += 1) {
-          if (neighbour.intersections[intersectionIdx][1] === circle) {
-            sharedIndex = intersectionIdx;
-            break;
-          }
+        if (cacheTemplates) {
+          RING_TEMPLATE_CACHE.set(cacheKey, template);
         }
-        if (sharedIndex === -1) {
+      }
+      this._ringTemplates.set(templateKey, template);
+      for (const group of groups) {
+        const circle = group.baseCircle || group.arcs[0]?.circle || null;
+        if (!circle) {
           continue;
         }
-        let arcIndex = -1;
-        if (preference === 'end') {
-          arcIndex = arcs.findIndex(([, endIdx]) => endIdx === sharedIndex);
-        }
-        if (arcIndex === -1) {
-          arcIndex = arcs.findIndex(([startIdx]) => startIdx === sharedIndex);
-        }
-        if (arcIndex === -1) {
-          arcIndex = 0;
+        const groupArcs = group.originalArcsToDraw || arcsToDraw;
+        const transform = this._computeTemplateTransform(template, circle, groupArcs);
+        if (!transform) {
+          continue;
         }
-        const [i, j] = arcs[arcIndex];
-        const start = neighbour.intersections[i][0];
-        const end = neighbour.intersections[j][0];
-        const arc = new ArcElement(neighbour, start, end, 40, true);
-        group.addArc(arc);
+        group.setTemplate(template, transform, false);
       }
     }
   }
@@ -1543,68 +4499,292 @@ class DoyleSpiralEngine {
     addFillPattern = false,
     fillPatternSpacing = 5.0,
     fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0, // Opt-in hatch angle quantisation in degrees (0 = exact angles)
+    fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
+    fillPatternLoop = false,
+    arcGroupAngleOverrides = null, // Map<group name, angles[]> or angles[] by toJSON() order — overrides preset animation per group
     redOutline = false,
+    redOutlineMinRing = null,
     drawGroupOutline = true,
     fillPatternOffset = 0.0,
+    fillPatternType = 'lines',
+    fillPatternRectWidth = 2.0,
+    highlightRimWidth = 1.2,
+    groupOutlineWidth = 0.6,
+    patternStrokeWidth = 0.5,
+    useSymmetric = true,
+    svgLayers = false,
+    svgLayerCount = 30,
   } = {}) {
     this.generateOuterCircles();
     this.computeAllIntersections();
-    context.setNormalizationScale(this.circles.concat(this.outerCircles));
+    // Use outer circle centers to define the bounding box - this ensures
+    // the petal tips align with the viewport boundary
+    context.setNormalizationScaleFromOuterCircles(this.outerCircles);
     this.fillPatternAngle = fillPatternAngle;
+    this.fillPatternAnimationId = normalisePatternAnimationId(fillPatternAnimation);
+    this.fillPatternSpacing = fillPatternSpacing;
     this.arcGroups.clear();
+    this._ringTemplates = new Map();
+
+    const style = this._arramBoyleStyle(context, {
+      fillPatternSpacing,
+      fillPatternAngle,
+      fillPatternOffset,
+      fillPatternType,
+      fillPatternRectWidth,
+      drawGroupOutline,
+      highlightRimWidth,
+      groupOutlineWidth,
+      patternStrokeWidth,
+    });
+    const { outlineStrokeWidth, highlightStrokeWidth } = style;
 
     const spiralCenter = Complex.ZERO;
     const radiusToRing = this._computeRingIndices();
 
-    this._createArcGroupsForCircles(radiusToRing, spiralCenter, debugGroups, addFillPattern, drawGroupOutline, context);
-    this._drawOuterClosureArcs(spiralCenter, debugGroups, redOutline, addFillPattern, drawGroupOutline, context);
+    // Use symmetric optimization when p == q
+    const canUseSymmetric = useSymmetric && this.p === this.q;
+    // When layering is enabled, suppress inline outline drawing during group creation;
+    // outlines will be drawn in a post-creation pass with correct layer assignment.
+    const inlineDrawOutline = svgLayers ? false : drawGroupOutline;
+
+    if (canUseSymmetric) {
+      this._createArcGroupsSymmetric(
+        radiusToRing,
+        spiralCenter,
+        debugGroups,
+        addFillPattern,
+        inlineDrawOutline,
+        context,
+        outlineStrokeWidth,
+      );
+    } else {
+      this._createArcGroupsForCircles(
+        radiusToRing,
+        spiralCenter,
+        debugGroups,
+        addFillPattern,
+        inlineDrawOutline,
+        context,
+        outlineStrokeWidth,
+      );
+    }
+    this._drawOuterClosureArcs(
+      spiralCenter,
+      debugGroups,
+      redOutline,
+      addFillPattern,
+      drawGroupOutline,
+      context,
+      outlineStrokeWidth,
+      highlightStrokeWidth,
+    );
     this._extendGroupsWithNeighbours(spiralCenter);
+    this._finalizeRingTemplates();
+
+    const patternAssignments = applyPatternAnimationToGroups(this.arcGroups, {
+      animationId: this.fillPatternAnimationId,
+      baseAngle: fillPatternAngle,
+      loopMode: fillPatternLoop,
+    });
+    this._assignPatternAngles(this.arcGroups.values(), patternAssignments, fillPatternAngle, fillPatternAngleStep, fillPatternType);
+
+    // Apply CA / external angle overrides after preset animation (overrides win).
+    // A Map is keyed by group.name, which only matches groups of this engine.
+    // An array is indexed like toJSON().arcgroups (outer closures skipped),
+    // which also matches any other render of the same parameters.
+    if (arcGroupAngleOverrides instanceof Map) {
+      for (const group of this.arcGroups.values()) {
+        const key = group.name;
+        if (arcGroupAngleOverrides.has(key)) {
+          const overrideAngles = arcGroupAngleOverrides.get(key);
+          group.patternAngles = overrideAngles;
+          group.primaryPatternAngle = overrideAngles.length > 0 ? overrideAngles[0] : null;
+        }
+      }
+    } else if (Array.isArray(arcGroupAngleOverrides)) {
+      let ordinal = 0;
+      for (const [key, group] of this.arcGroups.entries()) {
+        if (key.startsWith('outer_')) {
+          continue;
+        }
+        const overrideAngles = arcGroupAngleOverrides[ordinal];
+        ordinal += 1;
+        if (Array.isArray(overrideAngles)) {
+          group.patternAngles = overrideAngles;
+          group.primaryPatternAngle = overrideAngles.length > 0 ? overrideAngles[0] : null;
+        }
+      }
+    }
 
     const ringIndices = Array.from(this.arcGroups.values())
       .filter(group => group.ringIndex !== null && group.ringIndex !== undefined)
       .map(group => group.ringIndex);
     const maxIndex = ringIndices.length ? Math.max(...ringIndices) : null;
+    const minIndex = ringIndices.length ? Math.min(...ringIndices) : 0;
+
+    const layout = { enabled: svgLayers, count: Math.max(1, Math.floor(svgLayerCount)), minIndex, maxIndex };
+    if (svgLayers) {
+      context.enableLayers(layout.count);
+    }
 
     if (debugGroups) {
       for (const [key, group] of this.arcGroups.entries()) {
         if (key.startsWith('outer_')) {
           continue;
         }
-        group.toSVGFill(context, { debug: true, fillOpacity: 0.25 });
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawDebugFill(group, context, style);
       }
     }
 
     if (addFillPattern) {
       for (const [key, group] of this.arcGroups.entries()) {
-        if (key.startsWith('outer_')) {
-          continue;
-        }
-        const ringIdx = group.ringIndex ?? 0;
-        const angle = ringIdx * fillPatternAngle;
-        group.toSVGFill(context, {
-          debug: false,
-          patternFill: true,
-          lineSettings: [fillPatternSpacing, angle],
-          drawOutline: drawGroupOutline,
-          lineOffset: fillPatternOffset,
-        });
+        if (key.startsWith('outer_')) continue;
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawPatternFill(group, context, style);
+      }
+    }
+
+    if (svgLayers && !addFillPattern && !debugGroups && drawGroupOutline) {
+      for (const [key, group] of this.arcGroups.entries()) {
+        if (key.startsWith('outer_')) continue;
+        context.setActiveLayer(ringLayerIndex(group.ringIndex ?? 0, layout));
+        this._drawLayerOutline(group, context, style);
       }
     }
 
     if (redOutline && maxIndex !== null) {
+      context.setActiveLayer(ringLayerIndex(maxIndex, layout));
       for (const [key, group] of this.arcGroups.entries()) {
         if (!key.startsWith('circle_')) {
           continue;
         }
-        for (let i = 0; i < group.arcs.length; i += 1) {
-          if ((i === 3 || i === 2) && group.ringIndex === maxIndex) {
-            context.drawScaled(group.arcs[i], { color: '#ff0000', width: 1.2 });
-          }
+        if (group.ringIndex !== maxIndex) {
+          continue;
         }
+        this._drawRimHighlight(group, context, style);
+      }
+    }
+
+    // Beyond-box rings: draw full closed outline in red for each arc group
+    if (redOutline && Number.isFinite(redOutlineMinRing) && redOutlineMinRing >= 0) {
+      for (const [key, group] of this.arcGroups.entries()) {
+        if (!key.startsWith('circle_')) continue;
+        if (!Number.isFinite(group.ringIndex) || group.ringIndex < redOutlineMinRing) continue;
+        context.setActiveLayer(ringLayerIndex(group.ringIndex, layout));
+        this._drawBeyondBoxOutline(group, context, style);
       }
     }
   }
 
+  /**
+   * Resolves stroke widths and converts hatch spacing, offset and rectangle
+   * width from output units into geometry units for the current scale.
+   * @private
+   */
+  _arramBoyleStyle(context, {
+    fillPatternSpacing,
+    fillPatternAngle,
+    fillPatternOffset,
+    fillPatternType,
+    fillPatternRectWidth,
+    drawGroupOutline,
+    highlightRimWidth,
+    groupOutlineWidth,
+    patternStrokeWidth,
+  }) {
+    const scaleFactor = context.scaleFactor;
+    const invScale = scaleFactor > 1e-9 ? 1 / scaleFactor : 0;
+    const spacingInternal = Math.max(0, fillPatternSpacing);
+    const offsetInternal = Math.max(0, fillPatternOffset);
+    const rectWidthInternal = Math.max(0, fillPatternRectWidth);
+    return {
+      highlightStrokeWidth: Number.isFinite(highlightRimWidth) ? Math.max(0, highlightRimWidth) : 0,
+      outlineStrokeWidth: Number.isFinite(groupOutlineWidth) ? Math.max(0, groupOutlineWidth) : 0,
+      patternStroke: Number.isFinite(patternStrokeWidth) ? Math.max(0, patternStrokeWidth) : 0,
+      fillPatternAngle,
+      fillPatternType,
+      drawGroupOutline,
+      spacingInternal,
+      offsetInternal,
+      spacingForGroups: invScale > 0 ? spacingInternal * invScale : 0,
+      offsetForGroups: invScale > 0 ? offsetInternal * invScale : 0,
+      rectWidthForGroups: invScale > 0 ? rectWidthInternal * invScale : 0,
+    };
+  }
+
+  /**
+   * Stores each group's hatch angles: the preset assignment when there is one,
+   * otherwise ringIndex * fillPatternAngle.
+   * @private
+   */
+  _assignPatternAngles(groups, patternAssignments, fillPatternAngle, fillPatternAngleStep, fillPatternType = 'lines') {
+    const angleStep = Number.isFinite(fillPatternAngleStep) ? Math.max(0, fillPatternAngleStep) : 0;
+    for (const group of groups) {
+      const ringIdx = Number.isFinite(group.ringIndex) ? group.ringIndex : 0;
+      const defaultAngle = ringIdx * fillPatternAngle;
+      group.patternAngleStep = angleStep;
+      group.fillKernel = FILL_KERNELS[fillPatternType] ? fillPatternType : 'lines';
+      const assignment = patternAssignments.get(group.id) || null;
+      if (assignment) {
+        group.primaryPatternAngle = assignment.primaryAngle;
+        group.patternAngles = assignment.angles.slice();
+      } else {
+        group.primaryPatternAngle = defaultAngle;
+        group.patternAngles = [defaultAngle];
+      }
+    }
+  }
+
+  _drawDebugFill(group, context, style) {
+    group.toSVGFill(context, {
+      debug: true,
+      fillOpacity: 0.25,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    });
+  }
+
+  _drawPatternFill(group, context, style) {
+    const ringIdx = group.ringIndex ?? 0;
+    const angle = Number.isFinite(group.primaryPatternAngle)
+      ? group.primaryPatternAngle : ringIdx * style.fillPatternAngle;
+    group.toSVGFill(context, {
+      debug: false, patternFill: true, lineSettings: [style.spacingInternal, angle],
+      drawOutline: style.drawGroupOutline, lineOffset: style.offsetInternal,
+      patternType: style.fillPatternType, rectWidth: style.rectWidthForGroups,
+      patternSpacingOverride: style.spacingForGroups, patternOffsetOverride: style.offsetForGroups,
+      outlineStrokeWidth: style.outlineStrokeWidth, patternStrokeWidth: style.patternStroke,
+    });
+  }
+
+  _drawLayerOutline(group, context, style) {
+    group.toSVGFill(context, {
+      debug: false, patternFill: false, drawOutline: true,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    });
+  }
+
+  _drawRimHighlight(group, context, style) {
+    const highlightArcs = [];
+    for (let i = 0; i < group.arcs.length; i += 1) {
+      if (i === 3 || i === 2) {
+        highlightArcs.push(group.arcs[i]);
+      }
+    }
+    const paths = buildContinuousPathsFromArcs(highlightArcs);
+    for (const path of paths) {
+      context.drawPolyline(path, { color: '#ff0000', width: style.highlightStrokeWidth });
+    }
+  }
+
+  _drawBeyondBoxOutline(group, context, style) {
+    const outline = group.getClosedOutline();
+    if (!outline || outline.length < 2) return;
+    context.drawPolyline(outline, { color: '#ff0000', width: style.highlightStrokeWidth });
+  }
+
   _renderDoyle(context) {
     context.setNormalizationScale(this.circles);
     for (const circle of this.circles) {
@@ -1618,19 +4798,49 @@ class DoyleSpiralEngine {
     addFillPattern = false,
     fillPatternSpacing = 5.0,
     fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0,
+    fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
+    fillPatternLoop = false,
+    arcGroupAngleOverrides = null,
     redOutline = false,
+    redOutlineMinRing = null,
     drawGroupOutline = true,
     fillPatternOffset = 0.0,
+    fillPatternType = 'lines',
+    fillPatternRectWidth = 2.0,
+    highlightRimWidth = 1.2,
+    groupOutlineWidth = 0.6,
+    patternStrokeWidth = 0.5,
+    boundingBoxWidth = null,
+    boundingBoxHeight = null,
+    lengthUnits = '',
+    useSymmetric = true,
+    svgLayers = false,
+    svgLayerCount = 30,
+    geometryPrecision = 'float64',
+    svgPatternPreview = false,
   } = {}) {
+    if (this.p > MAX_P || this.q > MAX_Q) {
+      throw new Error(`p and q above ${MAX_P} can only be rendered with renderStream()`);
+    }
+    this.geometryPrecision = geometryPrecision;
     if (!this._generated) {
       this.generateCircles();
     }
-    const context = new DrawingContext(size);
+    const fallbackSize = Number.isFinite(size) && size > 0 ? size : 800;
+    const resolvedWidth = Number.isFinite(boundingBoxWidth) && boundingBoxWidth > 0
+      ? boundingBoxWidth
+      : fallbackSize;
+    const resolvedHeight = Number.isFinite(boundingBoxHeight) && boundingBoxHeight > 0
+      ? boundingBoxHeight
+      : fallbackSize;
+    const context = new DrawingContext(resolvedWidth, resolvedHeight, lengthUnits);
+    context.patternPreview = Boolean(svgPatternPreview);
     this.arcGroups.clear();
 
     if (mode === 'doyle') {
       this._renderDoyle(context);
-      return { svg: context.toElement(), svgString: context.toString(), geometry: null };
+      return { svg: context.toElement(), svgString: context.toString(), geometry: null, scaleFactor: context.scaleFactor };
     }
     if (mode === 'arram_boyle') {
       this._renderArramBoyle(context, {
@@ -1638,22 +4848,290 @@ class DoyleSpiralEngine {
         addFillPattern,
         fillPatternSpacing,
         fillPatternAngle,
+        fillPatternAngleStep,
+        fillPatternAnimation,
+        fillPatternLoop,
+        arcGroupAngleOverrides,
         redOutline,
+        redOutlineMinRing,
         drawGroupOutline,
         fillPatternOffset,
+        fillPatternType,
+        fillPatternRectWidth,
+        highlightRimWidth,
+        groupOutlineWidth,
+        patternStrokeWidth,
+        useSymmetric,
+        svgLayers,
+        svgLayerCount,
       });
       return {
         svg: context.toElement(),
         svgString: context.toString(),
         geometry: this.toJSON(),
+        scaleFactor: context.scaleFactor,
       };
     }
     throw new Error(`Unknown render mode "${mode}"`);
   }
 
-  toJSON() {
+  /**
+   * Renders the arram_boyle SVG ring by ring and hands it to `write(text)` in
+   * pieces, keeping only a few rings of circles and groups alive at a time.
+   * The concatenated output equals render('arram_boyle', options).svgString.
+   *
+   * Each SVG pass (outlines, fill, highlights, every layer) is a separate sweep
+   * over the rings, rebuilding the geometry it needs, so time grows with the
+   * number of passes while memory stays bounded. Pattern animations that need
+   * the whole spiral at once (see `ringLocal` in PATTERN_ANIMATION_DEFINITIONS)
+   * are rejected when pattern fill is on. No geometry payload is produced.
+   *
+   * @param {Function} write - Receives consecutive chunks of SVG text
+   * @param {Object} options - Same options as render()
+   * @returns {Object} { scaleFactor, circles, rings, peakLiveCircles }
+   */
+  renderStream(write, {
+    size = 800,
+    debugGroups = false,
+    addFillPattern = false,
+    fillPatternSpacing = 5.0,
+    fillPatternAngle = 0.0,
+    fillPatternAngleStep = 0,
+    fillPatternAnimation = DEFAULT_PATTERN_ANIMATION,
+    fillPatternLoop = false,
+    redOutline = false,
+    redOutlineMinRing = null,
+    drawGroupOutline = true,
+    fillPatternOffset = 0.0,
+    fillPatternType = 'lines',
+    fillPatternRectWidth = 2.0,
+    highlightRimWidth = 1.2,
+    groupOutlineWidth = 0.6,
+    patternStrokeWidth = 0.5,
+    boundingBoxWidth = null,
+    boundingBoxHeight = null,
+    lengthUnits = '',
+    useSymmetric = true,
+    svgLayers = false,
+    svgLayerCount = 30,
+  } = {}) {
+    const animationId = normalisePatternAnimationId(fillPatternAnimation);
+    if (addFillPattern && !PATTERN_ANIMATION_DEFINITIONS[animationId].ringLocal) {
+      throw new Error(`Pattern animation "${animationId}" needs the whole spiral and cannot be ring-streamed`);
+    }
+    const fallbackSize = Number.isFinite(size) && size > 0 ? size : 800;
+    const resolvedWidth = Number.isFinite(boundingBoxWidth) && boundingBoxWidth > 0
+      ? boundingBoxWidth
+      : fallbackSize;
+    const resolvedHeight = Number.isFinite(boundingBoxHeight) && boundingBoxHeight > 0
+      ? boundingBoxHeight
+      : fallbackSize;
+    const context = new StreamingDrawingContext(write, resolvedWidth, resolvedHeight, lengthUnits);
+
+    // Circle positions only; ids are reserved so they match generateCircles().
+    const x = [];
+    const y = [];
+    const r = [];
+    this._forEachCirclePosition((center, radius) => {
+      x.push(center.re);
+      y.push(center.im);
+      r.push(radius);
+    });
+    const idBase = CIRCLE_ID;
+    CIRCLE_ID += r.length;
+    this.generateOuterCircles(r.length);
+    context.setNormalizationScaleFromOuterCircles(this.outerCircles);
+    this.fillPatternAngle = fillPatternAngle;
+    this.fillPatternAnimationId = animationId;
+    this.fillPatternSpacing = fillPatternSpacing;
+
+    const ringWindow = new RingStreamWindow(this, {
+      x: Float64Array.from(x),
+      y: Float64Array.from(y),
+      r: Float64Array.from(r),
+      idBase,
+    });
+    x.length = 0;
+    y.length = 0;
+    r.length = 0;
+    const lastRing = ringWindow.ringCount - 1;
+    const style = this._arramBoyleStyle(context, {
+      fillPatternSpacing,
+      fillPatternAngle,
+      fillPatternOffset,
+      fillPatternType,
+      fillPatternRectWidth,
+      drawGroupOutline,
+      highlightRimWidth,
+      groupOutlineWidth,
+      patternStrokeWidth,
+    });
+    const sweepOptions = {
+      symmetric: useSymmetric && this.p === this.q,
+      debugGroups,
+      context,
+      outlineStrokeWidth: style.outlineStrokeWidth,
+    };
+
+    // Survey pass: ring span of the groups (layers, rim highlight) and the
+    // largest centroid radius (radial bloom), which the in-memory render reads
+    // off the complete group list.
+    let minIndex = Infinity;
+    let maxIndex = -Infinity;
+    let maxRadius = 0;
+    let surveyed = false;
+    if (svgLayers || redOutline || addFillPattern) {
+      ringWindow.sweep(0, lastRing, groups => {
+        for (const group of groups) {
+          minIndex = Math.min(minIndex, group.ringIndex);
+          maxIndex = Math.max(maxIndex, group.ringIndex);
+          const meta = addFillPattern ? patternAnimationMeta(group) : null;
+          if (meta) {
+            maxRadius = Math.max(maxRadius, meta.radius);
+          }
+        }
+      }, { ...sweepOptions, light: !addFillPattern });
+      surveyed = true;
+      if (ringWindow.closures.some(closure => closure && closure.arcs.length)) {
+        minIndex = Math.min(minIndex, -1);
+        maxIndex = Math.max(maxIndex, -1);
+      }
+    }
+    const hasGroups = maxIndex > -Infinity;
+    const layout = {
+      enabled: svgLayers,
+      count: Math.max(1, Math.floor(svgLayerCount)),
+      minIndex: hasGroups ? minIndex : 0,
+      maxIndex: hasGroups ? maxIndex : null,
+    };
+
+    const flush = () => context.flush();
+    const ringsOf = pass => (groups, ring) => {
+      for (const group of groups) {
+        pass(group, ring);
+      }
+      context.flush();
+    };
+    const debugPass = ringsOf(group => this._drawDebugFill(group, context, style));
+    const fillPass = (groups, ring) => {
+      const metas = groups.map(patternAnimationMeta).filter(Boolean);
+      const sorted = metas.slice().sort((a, b) => a.theta - b.theta);
+      const ringContext = {
+        metaList: metas,
+        ringMap: new Map(metas.length ? [[ring, sorted]] : []),
+        sortedRings: metas.length ? [ring] : [],
+        minRing: ring,
+        maxRing: ring,
+        maxRadius: maxRadius || 1,
+      };
+      const assignments = resolvePatternAssignments(ringContext, {
+        animationId,
+        baseAngle: fillPatternAngle,
+        loopMode: fillPatternLoop,
+      });
+      this._assignPatternAngles(groups, assignments, fillPatternAngle, fillPatternAngleStep, fillPatternType);
+      ringsOf(group => this._drawPatternFill(group, context, style))(groups, ring);
+    };
+    const outlinePass = ringsOf(group => this._drawLayerOutline(group, context, style));
+    const rimPass = ringsOf(group => {
+      if (group.ringIndex === layout.maxIndex) {
+        this._drawRimHighlight(group, context, style);
+      }
+    });
+    const beyondPass = ringsOf(group => this._drawBeyondBoxOutline(group, context, style));
+    const beyondFrom = redOutline && Number.isFinite(redOutlineMinRing) && redOutlineMinRing >= 0
+      ? Math.ceil(redOutlineMinRing)
+      : null;
+
+    // The passes of _renderArramBoyle for the rings fromRing..toRing.
+    const emitRings = (fromRing, toRing) => {
+      if (fromRing > toRing) {
+        return;
+      }
+      if (debugGroups) {
+        ringWindow.sweep(fromRing, toRing, debugPass, sweepOptions);
+      }
+      if (addFillPattern) {
+        ringWindow.sweep(fromRing, toRing, fillPass, sweepOptions);
+      }
+      if (svgLayers && !addFillPattern && !debugGroups && drawGroupOutline) {
+        ringWindow.sweep(fromRing, toRing, outlinePass, sweepOptions);
+      }
+      if (redOutline && layout.maxIndex !== null && layout.maxIndex >= fromRing && layout.maxIndex <= toRing) {
+        ringWindow.sweep(layout.maxIndex, layout.maxIndex, rimPass, sweepOptions);
+      }
+      if (beyondFrom !== null) {
+        ringWindow.sweep(Math.max(fromRing, beyondFrom), toRing, beyondPass, sweepOptions);
+      }
+    };
+
+    context.open(svgLayers);
+    if (svgLayers) {
+      // Outlines and closure arcs drawn outside a layer are dropped by the
+      // in-memory render; each layer holds a contiguous run of rings.
+      for (let layer = 0; layer < layout.count; layer += 1) {
+        context.openLayer(layer);
+        let fromRing = Infinity;
+        let toRing = -Infinity;
+        for (let ring = 0; ring <= lastRing; ring += 1) {
+          if (ringLayerIndex(ring, layout) === layer) {
+            fromRing = Math.min(fromRing, ring);
+            toRing = Math.max(toRing, ring);
+          }
+        }
+        emitRings(fromRing, toRing);
+        context.closeLayer();
+      }
+    } else {
+      const inlineOutline = !addFillPattern && drawGroupOutline;
+      if (inlineOutline) {
+        ringWindow.sweep(0, lastRing, flush, { ...sweepOptions, light: true, inlineOutline: true });
+        surveyed = true;
+      }
+      if (redOutline || inlineOutline) {
+        if (!surveyed) {
+          ringWindow.sweep(lastRing, lastRing, () => {}, { ...sweepOptions, light: true });
+        }
+        for (const closure of ringWindow.closures) {
+          if (closure) {
+            this._drawOuterClosure(closure.arcs, {
+              redOutline,
+              addFillPattern,
+              drawGroupOutline,
+              context,
+              outlineStrokeWidth: style.outlineStrokeWidth,
+              highlightStrokeWidth: style.highlightStrokeWidth,
+            });
+          }
+        }
+        context.flush();
+      }
+      emitRings(0, lastRing);
+    }
+    context.close();
+    return {
+      scaleFactor: context.scaleFactor,
+      circles: ringWindow.count,
+      rings: ringWindow.ringCount,
+      peakLiveCircles: ringWindow.peakLiveCircles,
+    };
+  }
+
+  /**
+   * Serialisable geometry for the 3D viewer and API consumers.
+   *
+   * With precision 'float64' each outline is an array of [x, y] pairs. The
+   * compact modes pack every outline into one shared typed array (so a worker
+   * can transfer it as a single buffer) and store each point relative to its
+   * group's circle centre, given as `outline_origin`:
+   *   'float32' - Float32Array of interleaved offsets
+   *   'fixed'   - Int32Array of interleaved offsets in units of `outline_scale`
+   * `outline_max_error` reports the largest coordinate error introduced by the
+   * encoding, in geometry units. Use decodeOutline() to read either form.
+   */
+  toJSON(precision = this.geometryPrecision || 'float64') {
     if (!this.arcGroups.size) {
-      throw new Error('Arc groups are not available. Render in arram_boyle mode first.');
+      return null;
     }
     const exportData = {
       spiral_params: {
@@ -1665,33 +5143,163 @@ class DoyleSpiralEngine {
         num_gaps: this.numGaps,
       },
       arcgroups: [],
+      pattern_animation: this.fillPatternAnimationId || DEFAULT_PATTERN_ANIMATION,
+      fill_pattern_spacing: this.fillPatternSpacing ?? 9,
     };
+    const compact = precision === 'float32' || precision === 'fixed';
+    const outlines = [];
+    let totalCoords = 0;
     for (const [key, group] of this.arcGroups.entries()) {
       if (key.startsWith('outer_')) {
         continue;
       }
       const outline = group.getClosedOutline();
-      const outlinePoints = outline.map(pt => [pt.re, pt.im]);
+      outlines.push(outline);
+      totalCoords += outline.length * 2;
       const ringIdx = group.ringIndex ?? 0;
-      const lineAngle = ringIdx * this.fillPatternAngle;
-      exportData.arcgroups.push({
+      const fallbackAngle = ringIdx * this.fillPatternAngle;
+      const patternAngles = Array.isArray(group.patternAngles) && group.patternAngles.length
+        ? group.patternAngles.slice(0, 3)
+        : [fallbackAngle];
+      const primaryAngle = Number.isFinite(group.primaryPatternAngle)
+        ? group.primaryPatternAngle
+        : patternAngles[0];
+      const entry = {
         id: group.id,
         name: group.name,
         ring_index: group.ringIndex,
-        line_angle: lineAngle,
-        outline: outlinePoints,
+        line_angle: normaliseAngle360(primaryAngle),
+        line_patterns: patternAngles.map(angle => normaliseAngle360(angle)),
+        outline: compact ? null : outline.map(pt => [pt.re, pt.im]),
         arc_count: group.arcs.length,
-      });
+      };
+      if (compact) {
+        const origin = group.baseCircle?.center || group.arcs[0]?.circle?.center || Complex.ZERO;
+        entry.outline_origin = [origin.re, origin.im];
+      }
+      exportData.arcgroups.push(entry);
+    }
+    if (compact) {
+      exportData.outline_precision = precision;
+      exportData.outline_max_error = packOutlines(exportData.arcgroups, outlines, totalCoords, precision);
     }
     return exportData;
   }
 }
 
+/**
+ * Fills the `outline` (and for fixed-point, `outline_scale`) of each group
+ * entry with views into one shared typed array. Returns the largest absolute
+ * coordinate error of the encoding.
+ */
+function packOutlines(entries, outlines, totalCoords, precision) {
+  const packed = precision === 'fixed' ? new Int32Array(totalCoords) : new Float32Array(totalCoords);
+  let maxError = 0;
+  let offset = 0;
+  for (let idx = 0; idx < entries.length; idx += 1) {
+    const entry = entries[idx];
+    const outline = outlines[idx];
+    const [ox, oy] = entry.outline_origin;
+    const view = packed.subarray(offset, offset + outline.length * 2);
+    let scale = 1;
+    if (precision === 'fixed') {
+      let extent = 0;
+      for (const pt of outline) {
+        extent = Math.max(extent, Math.abs(pt.re - ox), Math.abs(pt.im - oy));
+      }
+      scale = extent > 0 ? extent / FIXED_POINT_RANGE : 1;
+      entry.outline_scale = scale;
+    }
+    for (let i = 0; i < outline.length; i += 1) {
+      const dx = outline[i].re - ox;
+      const dy = outline[i].im - oy;
+      view[i * 2] = precision === 'fixed' ? Math.round(dx / scale) : dx;
+      view[i * 2 + 1] = precision === 'fixed' ? Math.round(dy / scale) : dy;
+      maxError = Math.max(
+        maxError,
+        Math.abs(ox + view[i * 2] * scale - outline[i].re),
+        Math.abs(oy + view[i * 2 + 1] * scale - outline[i].im),
+      );
+    }
+    entry.outline = view;
+    offset += outline.length * 2;
+  }
+  return maxError;
+}
+
+/**
+ * Returns a geometry group's outline as [x, y] pairs regardless of the
+ * precision it was encoded with.
+ *
+ * @param {Object} group - entry of geometry.arcgroups
+ * @returns {Array<[number, number]>}
+ */
+function decodeOutline(group) {
+  const outline = group?.outline;
+  if (!outline) {
+    return [];
+  }
+  if (!ArrayBuffer.isView(outline)) {
+    return outline;
+  }
+  const [ox, oy] = group.outline_origin || [0, 0];
+  const scale = group.outline_scale ?? 1;
+  const points = new Array(outline.length >> 1);
+  for (let i = 0; i < points.length; i += 1) {
+    points[i] = [ox + outline[i * 2] * scale, oy + outline[i * 2 + 1] * scale];
+  }
+  return points;
+}
+
 // ------------------------------------------------------------
 // High level helpers
 // ------------------------------------------------------------
 
+/**
+ * Normalizes and validates spiral parameters.
+ * Converts user input into a consistent format with validated ranges.
+ *
+ * @param {Object} [params={}] - Raw parameters from user input
+ * @param {number} [params.p] - First spiral parameter (families)
+ * @param {number} [params.q] - Second spiral parameter (circles per family)
+ * @param {number} [params.t] - Rotation parameter (-1 to 1)
+ * @param {string} [params.mode] - Rendering mode ('arram_boyle' or 'classic')
+ * @param {string} [params.arc_mode] - Arc selection mode
+ * @param {number} [params.num_gaps] - Number of gaps in each circle
+ * @param {number} [params.size] - Canvas size in pixels
+ * @param {boolean} [params.add_fill_pattern] - Whether to add pattern fills
+ * @param {boolean} [params.draw_group_outline] - Whether to draw group outlines
+ * @param {boolean} [params.use_symmetric] - Enable symmetric optimization for p==q
+ * @param {number} [params.fill_pattern_angle_step] - Snap hatch angles relative to each ring template to this step in degrees (0 = off)
+ * @param {string} [params.geometry_precision] - Outline encoding in the geometry payload ('float64', 'float32' or 'fixed')
+ * @param {boolean} [params.svg_pattern_preview] - Fill hatches with SVG <pattern>s instead of line segments (preview only)
+ * @returns {Object} Normalized parameters with all defaults applied
+ */
 function normaliseParams(params = {}) {
+  const patternTypeRaw = typeof params.fill_pattern_type === 'string'
+    ? params.fill_pattern_type.toLowerCase()
+    : 'lines';
+  const fillPatternType = FILL_PATTERN_TYPES.includes(patternTypeRaw) ? patternTypeRaw : 'lines';
+  const spacingRaw = Number(params.fill_pattern_spacing ?? 8);
+  const offsetRaw = Number(params.fill_pattern_offset ?? 0);
+  const rectWidthValue = Number(params.fill_pattern_rect_width ?? 2);
+  const boundingWidthRaw = Number(params.bounding_box_width_mm ?? 200);
+  const boundingHeightRaw = Number(params.bounding_box_height_mm ?? boundingWidthRaw);
+  const highlightWidthRaw = Number(params.highlight_rim_width ?? 1.2);
+  const outlineWidthRaw = Number(params.group_outline_width ?? 0.6);
+  const patternStrokeRaw = Number(params.pattern_stroke_width ?? 0.5);
+  const fillPatternSpacing = Number.isFinite(spacingRaw) ? Math.max(0.001, spacingRaw) : 8;
+  const fillPatternOffset = Number.isFinite(offsetRaw) ? Math.max(0, offsetRaw) : 0;
+  const rectWidthMm = Math.max(0, Number.isFinite(rectWidthValue) ? rectWidthValue : 2);
+  const boundingWidthMm = Number.isFinite(boundingWidthRaw) && boundingWidthRaw > 0.0001
+    ? boundingWidthRaw
+    : 200;
+  const boundingHeightMm = Number.isFinite(boundingHeightRaw) && boundingHeightRaw > 0.0001
+    ? boundingHeightRaw
+    : boundingWidthMm;
+  const highlightRimWidth = Number.isFinite(highlightWidthRaw) ? Math.max(0, highlightWidthRaw) : 1.2;
+  const groupOutlineWidth = Number.isFinite(outlineWidthRaw) ? Math.max(0, outlineWidthRaw) : 0.6;
+  const patternStrokeWidth = Number.isFinite(patternStrokeRaw) ? Math.max(0, patternStrokeRaw) : 0.5;
   return {
     p: Number(params.p ?? 16),
     q: Number(params.q ?? 16),
@@ -1702,33 +5310,96 @@ function normaliseParams(params = {}) {
     size: Number(params.size ?? 800),
     debug_groups: Boolean(params.debug_groups ?? false),
     add_fill_pattern: Boolean(params.add_fill_pattern ?? false),
-    fill_pattern_spacing: Number(params.fill_pattern_spacing ?? 5),
+    fill_pattern_spacing: fillPatternSpacing,
     fill_pattern_angle: Number(params.fill_pattern_angle ?? 0),
-    fill_pattern_offset: Number(params.fill_pattern_offset ?? 0),
+    fill_pattern_angle_step: Number.isFinite(Number(params.fill_pattern_angle_step)) ? Math.max(0, Number(params.fill_pattern_angle_step)) : 0,
+    fill_pattern_offset: fillPatternOffset,
+    fill_pattern_type: fillPatternType,
+    fill_pattern_rect_width: rectWidthMm,
+    fill_pattern_animation: normalisePatternAnimationId(params.fill_pattern_animation),
+    fill_pattern_loop: Boolean(params.fill_pattern_loop ?? false),
+    highlight_rim_width: highlightRimWidth,
+    group_outline_width: groupOutlineWidth,
+    pattern_stroke_width: patternStrokeWidth,
     red_outline: Boolean(params.red_outline ?? false),
+    red_outline_min_ring: (params.red_outline_min_ring != null && Number.isFinite(Number(params.red_outline_min_ring))) ? Number(params.red_outline_min_ring) : null,
     draw_group_outline: params.draw_group_outline !== undefined ? Boolean(params.draw_group_outline) : true,
     max_d: Number(params.max_d ?? 2000),
+    bounding_box_width_mm: boundingWidthMm,
+    bounding_box_height_mm: boundingHeightMm,
+    use_symmetric: params.use_symmetric !== undefined ? Boolean(params.use_symmetric) : true,
+    svg_layers: Boolean(params.svg_layers ?? false),
+    svg_layer_count: Number.isFinite(Number(params.svg_layer_count)) ? Math.max(1, Math.floor(Number(params.svg_layer_count))) : 30,
+    geometry_precision: GEOMETRY_PRECISIONS.includes(params.geometry_precision) ? params.geometry_precision : 'float64',
+    svg_pattern_preview: Boolean(params.svg_pattern_preview ?? false),
   };
 }
 
-function renderSpiral(params = {}, overrideMode = null) {
-  const opts = normaliseParams(params);
-  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
-    maxDistance: opts.max_d,
-    arcMode: opts.arc_mode,
-    numGaps: opts.num_gaps,
-  });
-  const mode = overrideMode || opts.mode;
-  const result = engine.render(mode, {
+/**
+ * Maps normalised (snake_case) parameters onto render() options.
+ */
+function renderOptionsFromParams(opts) {
+  return {
     size: opts.size,
     debugGroups: opts.debug_groups,
     addFillPattern: opts.add_fill_pattern,
     fillPatternSpacing: opts.fill_pattern_spacing,
     fillPatternAngle: opts.fill_pattern_angle,
+    fillPatternAngleStep: opts.fill_pattern_angle_step,
     redOutline: opts.red_outline,
+    redOutlineMinRing: opts.red_outline_min_ring,
     drawGroupOutline: opts.draw_group_outline,
     fillPatternOffset: opts.fill_pattern_offset,
+    fillPatternType: opts.fill_pattern_type,
+    fillPatternRectWidth: opts.fill_pattern_rect_width,
+    fillPatternAnimation: opts.fill_pattern_animation,
+    fillPatternLoop: opts.fill_pattern_loop,
+    highlightRimWidth: opts.highlight_rim_width,
+    groupOutlineWidth: opts.group_outline_width,
+    patternStrokeWidth: opts.pattern_stroke_width,
+    boundingBoxWidth: opts.bounding_box_width_mm,
+    boundingBoxHeight: opts.bounding_box_height_mm,
+    lengthUnits: 'mm',
+    useSymmetric: opts.use_symmetric,
+    svgLayers: opts.svg_layers ?? false,
+    svgLayerCount: opts.svg_layer_count ?? 30,
+    geometryPrecision: opts.geometry_precision,
+    svgPatternPreview: opts.svg_pattern_preview,
+  };
+}
+
+/**
+ * High-level function to render a Doyle spiral with the specified parameters.
+ * This is the main entry point for generating spiral SVGs.
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @param {number} params.p - First spiral parameter (default: 16)
+ * @param {number} params.q - Second spiral parameter (default: 16)
+ * @param {number} params.t - Time/evolution parameter (default: 0)
+ * @param {number} params.max_d - Maximum distance for circle generation (default: 2000)
+ * @param {string} params.mode - Rendering mode: 'arram_boyle' or 'classic'
+ * @param {number} params.size - Canvas size in pixels (default: 800)
+ * @param {number} params.bounding_box_width_mm - Bounding box width in mm (default: 200)
+ * @param {number} params.bounding_box_height_mm - Bounding box height in mm (default: 200)
+ * @param {string|null} overrideMode - Optional mode override
+ * @param {Object} [options]
+ * @param {Map|Array|null} [options.arcGroupAngleOverrides] - Per-group hatch angles (see render())
+ * @returns {Object} Result object containing engine, svg, geometry, and metadata
+ * @throws {Error} If parameters are invalid or generation exceeds limits
+ */
+function renderSpiral(params = {}, overrideMode = null, { arcGroupAngleOverrides = null } = {}) {
+  const opts = normaliseParams(params);
+  resetGeometryStats();
+  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
+    maxDistance: opts.max_d,
+    arcMode: opts.arc_mode,
+    numGaps: opts.num_gaps,
   });
+  const mode = overrideMode || opts.mode;
+  const result = engine.render(mode, { ...renderOptionsFromParams(opts), arcGroupAngleOverrides });
+  countOutlineJoins(engine.arcGroups);
+  GEOMETRY_STATS.hatchRimDeviationMm = GEOMETRY_STATS.hatchRimDeviation * (result.scaleFactor || 1);
+  const geometryStats = getGeometryStats();
   return {
     engine,
     mode,
@@ -1736,9 +5407,50 @@ function renderSpiral(params = {}, overrideMode = null) {
     svgString: result.svgString,
     geometry: result.geometry,
     params: opts,
+    scaleFactor: result.scaleFactor || 1,
+    geometryStats,
   };
 }
 
+/**
+ * Ring-streamed counterpart of renderSpiral() for large posters: writes the
+ * arram_boyle SVG to `write` in chunks while holding only a few rings in
+ * memory, and accepts p and q up to MAX_STREAM_P / MAX_STREAM_Q. The chunks
+ * concatenate to renderSpiral(params).svgString. See renderStream() for what
+ * cannot be streamed.
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @param {Function} write - Receives consecutive chunks of SVG text
+ * @returns {Object} { scaleFactor, circles, rings, peakLiveCircles, params }
+ */
+function renderSpiralStream(params = {}, write) {
+  const opts = normaliseParams(params);
+  resetGeometryStats();
+  const engine = new DoyleSpiralEngine(opts.p, opts.q, opts.t, {
+    maxDistance: opts.max_d,
+    arcMode: opts.arc_mode,
+    numGaps: opts.num_gaps,
+    streaming: true,
+  });
+  const result = engine.renderStream(write, renderOptionsFromParams(opts));
+  return { ...result, params: opts };
+}
+
+/**
+ * Whether renderSpiralStream() accepts `params`: fill patterns stream only
+ * with ring-local animations (see renderStream()).
+ *
+ * @param {Object} params - Rendering parameters (will be normalized)
+ * @returns {boolean}
+ */
+function canRenderSpiralStream(params = {}) {
+  const opts = normaliseParams(params);
+  if (!opts.add_fill_pattern) {
+    return true;
+  }
+  return Boolean(PATTERN_ANIMATION_DEFINITIONS[opts.fill_pattern_animation].ringLocal);
+}
+
 function computeGeometry(params = {}) {
   return renderSpiral({ ...params, mode: 'arram_boyle' }, 'arram_boyle');
 }
@@ -1750,6 +5462,19 @@ export {
   CircleElement,
   DoyleSpiralEngine,
   renderSpiral,
+  renderSpiralStream,
+  canRenderSpiralStream,
   computeGeometry,
   normaliseParams,
+  buildPatternAnimationContext,
+  buildPatternAnimationContextFromGeometry,
+  buildContinuousPathsFromArcs,
+  generatePresetAnimationFrames,
+  linesInPolygon,
+  insetPolygon,
+  fillPatternPolylines,
+  FILL_PATTERN_TYPES,
+  getGeometryStats,
+  resetGeometryStats,
+  decodeOutline,
 };
@@ -0,0 +1,71 @@
+// Generated from javascript/js/render_worker.js by javascript/build_engine.mjs (engine build f9f7e4f547ad).
+// Do not edit; change the source and run `npm run build:engine`.
+import { renderSpiral } from './doyle_spiral_engine.js';
+import { storeGeometry, publishGeometry } from './geometry_store.js';
+
+let activeRequest = null;
+
+self.addEventListener('message', event => {
+  const data = event.data || {};
+  if (data.type !== 'render') {
+    return;
+  }
+  const { requestId, params, angleOverrides = null } = data;
+  activeRequest = requestId;
+  try {
+    // Animator renders carry per-cell hatch angles (see animator.js).
+    const result = renderSpiral(params || {}, null, { arcGroupAngleOverrides: angleOverrides });
+    if (activeRequest !== requestId) {
+      return;
+    }
+    // `geometryStore` asks for the outlines in a published geometry store
+    // (geometry_store.js), shared with the page when it is cross-origin
+    // isolated. Otherwise compact geometry packs all outlines into one typed
+    // array; either way the buffer is transferred instead of copied.
+    let geometry = result.geometry || null;
+    let geometryStore = null;
+    let transfer = [];
+    if (data.geometryStore && geometry) {
+      geometryStore = publishGeometry(storeGeometry(geometry, data.geometryStore));
+      geometry = null;
+      transfer = geometryStore.shared ? [] : [geometryStore.buffer];
+    } else {
+      const packed = geometry?.arcgroups?.[0]?.outline;
+      transfer = ArrayBuffer.isView(packed) ? [packed.buffer] : [];
+    }
+    self.postMessage({
+      type: 'result',
+      requestId,
+      svgString: result.svgString || '',
+      geometry,
+      geometryStore,
+      mode: result.mode || null,
+      params: result.params || null,
+      scaleFactor: result.scaleFactor ?? null,
+    }, transfer);
+  } catch (error) {
+    let message = 'Render failed';
+
+    if (error && typeof error.message === 'string') {
+      message = error.message;
+
+      // Enhance error messages with context
+      if (error.message.includes('iteration limit')) {
+        // Already has good context from generateCircles/generateOuterCircles
+        message = error.message;
+      } else if (error.message.includes('memory') || error.name === 'RangeError') {
+        message = `Out of memory. Try reducing parameters: p=${params?.p || '?'}, q=${params?.q || '?'}, max_d=${params?.max_d || '?'}`;
+      } else {
+        // Add parameter context to generic errors
+        message = `${error.message} [p=${params?.p || '?'}, q=${params?.q || '?'}, t=${params?.t || '?'}, max_d=${params?.max_d || '?'}]`;
+      }
+    }
+
+    self.postMessage({
+      type: 'error',
+      requestId,
+      message,
+      errorType: error?.name || 'Error',
+    });
+  }
+});
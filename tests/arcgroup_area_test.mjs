@@ -1,4 +1,4 @@
-import { DoyleSpiralEngine } from '../templates/js/doyle_spiral_engine.js';
+import { DoyleSpiralEngine } from '../javascript/js/doyle_spiral_engine.js';
 
 function polygonArea(points) {
   if (!points || points.length < 3) {